@@ -1868,19 +1868,12 @@ void _File::store_var(const Variant &p_var) {
 
 	ERR_FAIL_COND(!f);
 	int len;
-	Error err = encode_variant(p_var, NULL, len);
+	Vector<uint8_t> buff;
+	Error err = encode_variant(p_var, buff, len);
 	ERR_FAIL_COND(err != OK);
 
-	PoolVector<uint8_t> buff;
-	buff.resize(len);
-	PoolVector<uint8_t>::Write w = buff.write();
-
-	err = encode_variant(p_var, &w[0], len);
-	ERR_FAIL_COND(err != OK);
-	w = PoolVector<uint8_t>::Write();
-
 	store_32(len);
-	store_buffer(buff);
+	f->store_buffer(buff.ptr(), len);
 }
 
 Variant _File::get_var() const {
@@ -2181,15 +2174,10 @@ _Marshalls *_Marshalls::get_singleton() {
 String _Marshalls::variant_to_base64(const Variant &p_var) {
 
 	int len;
-	Error err = encode_variant(p_var, NULL, len);
-	ERR_FAIL_COND_V(err != OK, "");
-
-	PoolVector<uint8_t> buff;
-	buff.resize(len);
-	PoolVector<uint8_t>::Write w = buff.write();
-
-	err = encode_variant(p_var, &w[0], len);
+	Vector<uint8_t> buff;
+	Error err = encode_variant(p_var, buff, len);
 	ERR_FAIL_COND_V(err != OK, "");
+	const uint8_t *w = buff.ptr();
 
 	int b64len = len / 3 * 4 + 4 + 1;
 	PoolVector<uint8_t> b64buff;
@@ -2899,13 +2887,19 @@ Variant JSONParseResult::get_result() const {
 
 void _JSON::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("print", "value", "indent", "sort_keys"), &_JSON::print, DEFVAL(String()), DEFVAL(false));
+	ClassDB::bind_method(D_METHOD("print_utf8", "value", "indent", "sort_keys"), &_JSON::print_utf8, DEFVAL(String()), DEFVAL(false));
 	ClassDB::bind_method(D_METHOD("parse", "json"), &_JSON::parse);
+	ClassDB::bind_method(D_METHOD("parse_utf8", "json"), &_JSON::parse_utf8);
 }
 
 String _JSON::print(const Variant &p_value, const String &p_indent, bool p_sort_keys) {
 	return JSON::print(p_value, p_indent, p_sort_keys);
 }
 
+PoolVector<uint8_t> _JSON::print_utf8(const Variant &p_value, const String &p_indent, bool p_sort_keys) {
+	return JSON::print_utf8(p_value, p_indent, p_sort_keys);
+}
+
 Ref<JSONParseResult> _JSON::parse(const String &p_json) {
 	Ref<JSONParseResult> result;
 	result.instance();
@@ -2915,6 +2909,16 @@ Ref<JSONParseResult> _JSON::parse(const String &p_json) {
 	return result;
 }
 
+Ref<JSONParseResult> _JSON::parse_utf8(const PoolVector<uint8_t> &p_json) {
+	Ref<JSONParseResult> result;
+	result.instance();
+
+	PoolVector<uint8_t>::Read r = p_json.read();
+	result->error = JSON::parse_utf8(r.ptr(), p_json.size(), result->result, result->error_string, result->error_line);
+
+	return result;
+}
+
 _JSON *_JSON::singleton = NULL;
 
 _JSON::_JSON() {
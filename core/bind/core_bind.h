@@ -757,7 +757,9 @@ public:
 	static _JSON *get_singleton() { return singleton; }
 
 	String print(const Variant &p_value, const String &p_indent = "", bool p_sort_keys = false);
+	PoolVector<uint8_t> print_utf8(const Variant &p_value, const String &p_indent = "", bool p_sort_keys = false);
 	Ref<JSONParseResult> parse(const String &p_json);
+	Ref<JSONParseResult> parse_utf8(const PoolVector<uint8_t> &p_json);
 
 	_JSON();
 };
@@ -258,6 +258,7 @@ ClassDB::ClassInfo::ClassInfo() {
 	api = API_NONE;
 	creation_func = NULL;
 	inherits_ptr = NULL;
+	flat_table = NULL;
 	disabled = false;
 	exposed = false;
 }
@@ -540,6 +541,7 @@ void ClassDB::_add_class2(const StringName &p_class, const StringName &p_inherit
 
 	classes[name] = ClassInfo();
 	ClassInfo &ti = classes[name];
+	atomic_increment(&bind_generation);
 	ti.name = name;
 	ti.inherits = p_inherits;
 	ti.api = current_api;
@@ -633,6 +635,32 @@ MethodBind *ClassDB::get_method(StringName p_class, StringName p_name) {
 
 	ClassInfo *type = classes.getptr(p_class);
 
+	const ClassInfo::FlatTable *flat = type ? _get_flat_table(type) : NULL;
+	if (flat) {
+		MethodBind *const *method = flat->method_map.getptr(p_name);
+		return method ? *method : NULL;
+	}
+
+	while (type) {
+
+		MethodBind **method = type->method_map.getptr(p_name);
+		if (method && *method)
+			return *method;
+		type = type->inherits_ptr;
+	}
+	return NULL;
+}
+
+MethodBind *ClassDB::get_object_method(const Object *p_object, const StringName &p_name) {
+
+	const ClassInfo::FlatTable *flat;
+	ClassInfo *type = _get_object_class(p_object, &flat);
+
+	if (flat) {
+		MethodBind *const *method = flat->method_map.getptr(p_name);
+		return method ? *method : NULL;
+	}
+
 	while (type) {
 
 		MethodBind **method = type->method_map.getptr(p_name);
@@ -659,6 +687,7 @@ void ClassDB::bind_integer_constant(const StringName &p_class, const StringName
 	}
 
 	type->constant_map[p_name] = p_constant;
+	atomic_increment(&bind_generation);
 
 	String enum_name = p_enum;
 	if (enum_name != String()) {
@@ -963,6 +992,7 @@ void ClassDB::add_property(StringName p_class, const PropertyInfo &p_pinfo, cons
 	psg.type = p_pinfo.type;
 
 	type->property_setget[p_pinfo.name] = psg;
+	atomic_increment(&bind_generation);
 }
 
 void ClassDB::get_property_list(StringName p_class, List<PropertyInfo> *p_list, bool p_no_inheritance, const Object *p_validator) {
@@ -989,80 +1019,113 @@ void ClassDB::get_property_list(StringName p_class, List<PropertyInfo> *p_list,
 		check = check->inherits_ptr;
 	}
 }
-bool ClassDB::set_property(Object *p_object, const StringName &p_property, const Variant &p_value, bool *r_valid) {
+bool ClassDB::_set_property(Object *p_object, const PropertySetGet *p_setget, const Variant &p_value, bool *r_valid) {
 
-	ClassInfo *type = classes.getptr(p_object->get_class_name());
-	ClassInfo *check = type;
-	while (check) {
-		const PropertySetGet *psg = check->property_setget.getptr(p_property);
-		if (psg) {
+	if (!p_setget->setter) {
+		if (r_valid)
+			*r_valid = false;
+		return true; //return true but do nothing
+	}
 
-			if (!psg->setter) {
-				if (r_valid)
-					*r_valid = false;
-				return true; //return true but do nothing
-			}
+	Variant::CallError ce;
 
-			Variant::CallError ce;
+	if (p_setget->index >= 0) {
+		Variant index = p_setget->index;
+		const Variant *arg[2] = { &index, &p_value };
+		//p_object->call(p_setget->setter,arg,2,ce);
+		if (p_setget->_setptr) {
+			p_setget->_setptr->call(p_object, arg, 2, ce);
+		} else {
+			p_object->call(p_setget->setter, arg, 2, ce);
+		}
 
-			if (psg->index >= 0) {
-				Variant index = psg->index;
-				const Variant *arg[2] = { &index, &p_value };
-				//p_object->call(psg->setter,arg,2,ce);
-				if (psg->_setptr) {
-					psg->_setptr->call(p_object, arg, 2, ce);
-				} else {
-					p_object->call(psg->setter, arg, 2, ce);
-				}
+	} else {
+		const Variant *arg[1] = { &p_value };
+		if (p_setget->_setptr) {
+			p_setget->_setptr->call(p_object, arg, 1, ce);
+		} else {
+			p_object->call(p_setget->setter, arg, 1, ce);
+		}
+	}
 
-			} else {
-				const Variant *arg[1] = { &p_value };
-				if (psg->_setptr) {
-					psg->_setptr->call(p_object, arg, 1, ce);
-				} else {
-					p_object->call(psg->setter, arg, 1, ce);
-				}
-			}
+	if (r_valid)
+		*r_valid = ce.error == Variant::CallError::CALL_OK;
 
-			if (r_valid)
-				*r_valid = ce.error == Variant::CallError::CALL_OK;
+	return true;
+}
 
-			return true;
-		}
+bool ClassDB::_get_property(Object *p_object, const PropertySetGet *p_setget, Variant &r_value) {
 
-		check = check->inherits_ptr;
-	}
+	if (!p_setget->getter)
+		return true; //return true but do nothing
 
-	return false;
+	if (p_setget->index >= 0) {
+		Variant index = p_setget->index;
+		const Variant *arg[1] = { &index };
+		Variant::CallError ce;
+		r_value = p_object->call(p_setget->getter, arg, 1, ce);
+
+	} else {
+
+		Variant::CallError ce;
+		if (p_setget->_getptr) {
+
+			r_value = p_setget->_getptr->call(p_object, NULL, 0, ce);
+		} else {
+			r_value = p_object->call(p_setget->getter, NULL, 0, ce);
+		}
+	}
+	return true;
 }
-bool ClassDB::get_property(Object *p_object, const StringName &p_property, Variant &r_value) {
 
-	ClassInfo *type = classes.getptr(p_object->get_class_name());
+bool ClassDB::set_property(Object *p_object, const StringName &p_property, const Variant &p_value, bool *r_valid) {
+
+	const ClassInfo::FlatTable *flat;
+	ClassInfo *type = _get_object_class(p_object, &flat);
+
+	if (flat) {
+		const ClassInfo::FlatProperty *fp = flat->property_map.getptr(p_property);
+		if (fp && fp->setget) {
+			return _set_property(p_object, fp->setget, p_value, r_valid);
+		}
+		return false;
+	}
+
 	ClassInfo *check = type;
 	while (check) {
 		const PropertySetGet *psg = check->property_setget.getptr(p_property);
 		if (psg) {
-			if (!psg->getter)
-				return true; //return true but do nothing
+			return _set_property(p_object, psg, p_value, r_valid);
+		}
 
-			if (psg->index >= 0) {
-				Variant index = psg->index;
-				const Variant *arg[1] = { &index };
-				Variant::CallError ce;
-				r_value = p_object->call(psg->getter, arg, 1, ce);
+		check = check->inherits_ptr;
+	}
 
-			} else {
+	return false;
+}
+bool ClassDB::get_property(Object *p_object, const StringName &p_property, Variant &r_value) {
 
-				Variant::CallError ce;
-				if (psg->_getptr) {
+	const ClassInfo::FlatTable *flat;
+	ClassInfo *type = _get_object_class(p_object, &flat);
 
-					r_value = psg->_getptr->call(p_object, NULL, 0, ce);
-				} else {
-					r_value = p_object->call(psg->getter, NULL, 0, ce);
-				}
-			}
+	if (flat) {
+		const ClassInfo::FlatProperty *fp = flat->property_map.getptr(p_property);
+		if (!fp) {
+			return false;
+		}
+		if (fp->constant) {
+			r_value = *fp->constant;
 			return true;
 		}
+		return _get_property(p_object, fp->setget, r_value);
+	}
+
+	ClassInfo *check = type;
+	while (check) {
+		const PropertySetGet *psg = check->property_setget.getptr(p_property);
+		if (psg) {
+			return _get_property(p_object, psg, r_value);
+		}
 
 		const int *c = check->constant_map.getptr(p_property);
 		if (c) {
@@ -1080,6 +1143,16 @@ bool ClassDB::get_property(Object *p_object, const StringName &p_property, Varia
 int ClassDB::get_property_index(const StringName &p_class, const StringName &p_property, bool *r_is_valid) {
 
 	ClassInfo *type = classes.getptr(p_class);
+
+	const ClassInfo::FlatTable *flat = type ? _get_flat_table(type) : NULL;
+	if (flat) {
+		const ClassInfo::FlatProperty *fp = flat->property_map.getptr(p_property);
+		bool valid = fp && fp->setget;
+		if (r_is_valid)
+			*r_is_valid = valid;
+		return valid ? fp->setget->index : -1;
+	}
+
 	ClassInfo *check = type;
 	while (check) {
 		const PropertySetGet *psg = check->property_setget.getptr(p_property);
@@ -1102,6 +1175,16 @@ int ClassDB::get_property_index(const StringName &p_class, const StringName &p_p
 Variant::Type ClassDB::get_property_type(const StringName &p_class, const StringName &p_property, bool *r_is_valid) {
 
 	ClassInfo *type = classes.getptr(p_class);
+
+	const ClassInfo::FlatTable *flat = type ? _get_flat_table(type) : NULL;
+	if (flat) {
+		const ClassInfo::FlatProperty *fp = flat->property_map.getptr(p_property);
+		bool valid = fp && fp->setget;
+		if (r_is_valid)
+			*r_is_valid = valid;
+		return valid ? fp->setget->type : Variant::NIL;
+	}
+
 	ClassInfo *check = type;
 	while (check) {
 		const PropertySetGet *psg = check->property_setget.getptr(p_property);
@@ -1184,6 +1267,12 @@ void ClassDB::set_method_flags(StringName p_class, StringName p_method, int p_fl
 bool ClassDB::has_method(StringName p_class, StringName p_method, bool p_no_inheritance) {
 
 	ClassInfo *type = classes.getptr(p_class);
+
+	const ClassInfo::FlatTable *flat = (!p_no_inheritance && type) ? _get_flat_table(type) : NULL;
+	if (flat) {
+		return flat->method_map.has(p_method);
+	}
+
 	ClassInfo *check = type;
 	while (check) {
 		if (check->method_map.has(p_method))
@@ -1246,6 +1335,7 @@ MethodBind *ClassDB::bind_methodfi(uint32_t p_flags, MethodBind *p_bind, const c
 #endif
 
 	type->method_map[mdname] = p_bind;
+	atomic_increment(&bind_generation);
 
 	Vector<Variant> defvals;
 
@@ -1367,11 +1457,106 @@ void ClassDB::get_extensions_for_type(const StringName &p_class, List<String> *p
 	}
 }
 
+const ClassDB::ClassInfo::FlatTable *ClassDB::_get_flat_table(const ClassInfo *p_class) {
+
+	//stale once anything was bound to any class after it was built
+	const ClassInfo::FlatTable *flat = p_class->flat_table;
+	return (flat && flat->generation == bind_generation) ? flat : NULL;
+}
+
+const ClassDB::ClassInfo::FlatTable *ClassDB::_flatten_class(ClassInfo *p_class) {
+
+	// not under the class lock, objects may be called into while it is held
+	flat_lock->lock();
+
+	const ClassInfo::FlatTable *current = _get_flat_table(p_class);
+	if (current) {
+		//built by another thread meanwhile
+		flat_lock->unlock();
+		return current;
+	}
+
+	ClassInfo::FlatTable *flat = memnew(ClassInfo::FlatTable);
+	flat->generation = bind_generation;
+
+	Vector<ClassInfo *> hierarchy;
+	for (ClassInfo *check = p_class; check; check = check->inherits_ptr) {
+		hierarchy.push_back(check);
+	}
+
+	//from the base class down, so derived classes replace what they inherit
+	for (int i = hierarchy.size() - 1; i >= 0; i--) {
+
+		ClassInfo *check = hierarchy[i];
+		const StringName *K = NULL;
+
+		while ((K = check->method_map.next(K))) {
+
+			MethodBind *method = check->method_map[*K];
+			if (method)
+				flat->method_map[*K] = method;
+		}
+
+		while ((K = check->constant_map.next(K))) {
+
+			flat->property_map[*K].constant = check->constant_map.getptr(*K);
+		}
+
+		while ((K = check->property_setget.next(K))) {
+
+			ClassInfo::FlatProperty &fp = flat->property_map[*K];
+			fp.setget = check->property_setget.getptr(*K);
+			fp.constant = NULL;
+		}
+	}
+
+	//readers may still hold the old table, so it is only retired
+	ClassInfo::FlatTable *old = (ClassInfo::FlatTable *)atomic_exchange_ptr((void *volatile *)&p_class->flat_table, flat);
+	if (old)
+		retired_flat_tables.push_back(old);
+
+	flat_lock->unlock();
+
+	return flat;
+}
+
+ClassDB::ClassInfo *ClassDB::_get_object_class(const Object *p_object, const ClassInfo::FlatTable **r_flat) {
+
+	*r_flat = NULL;
+
+	if (!p_object->_class_ptr) {
+		//still being constructed or destroyed, the class name changes on each level
+		ClassInfo *type = classes.getptr(p_object->get_class_name());
+		if (type)
+			*r_flat = _get_flat_table(type);
+		return type;
+	}
+
+	ClassInfo *type = (ClassInfo *)p_object->_class_info;
+	if (!type) {
+		type = classes.getptr(*p_object->_class_ptr);
+		if (!type)
+			return NULL;
+		p_object->_class_info = type;
+	}
+
+	*r_flat = _get_flat_table(type);
+	if (!*r_flat) {
+		*r_flat = _flatten_class(type);
+	}
+
+	return type;
+}
+
 RWLock *ClassDB::lock = NULL;
+Mutex *ClassDB::flat_lock = NULL;
+volatile uint32_t ClassDB::bind_generation = 1;
+List<ClassDB::ClassInfo::FlatTable *> ClassDB::retired_flat_tables;
 
 void ClassDB::init() {
 
 	lock = RWLock::create();
+	flat_lock = Mutex::create();
 }
 
 void ClassDB::cleanup() {
@@ -1389,12 +1574,23 @@ void ClassDB::cleanup() {
 
 			memdelete(ti.method_map[*m]);
 		}
+
+		if (ti.flat_table) {
+			memdelete(ti.flat_table);
+			ti.flat_table = NULL;
+		}
 	}
 	classes.clear();
+
+	while (retired_flat_tables.size()) {
+		memdelete(retired_flat_tables.front()->get());
+		retired_flat_tables.pop_front();
+	}
 	resource_base_extensions.clear();
 	compat_classes.clear();
 
 	memdelete(lock);
+	memdelete(flat_lock);
 }
 
 //
@@ -33,6 +33,7 @@
 
 #include "core/method_bind.h"
 #include "core/object.h"
+#include "core/os/mutex.h"
 #include "core/print_string.h"
 
 /**
@@ -132,6 +133,26 @@ public:
 #endif
 		HashMap<StringName, PropertySetGet> property_setget;
 
+		// methods, properties and constants of this class and all its parents,
+		// resolved so an object lookup is a single probe
+		struct FlatProperty {
+			const PropertySetGet *setget;
+			const int *constant; //only set when it shadows setget, as get_property() checks constants per level
+			FlatProperty() {
+				setget = NULL;
+				constant = NULL;
+			}
+		};
+
+		// built off to the side and published with a single pointer swap, never modified afterwards
+		struct FlatTable {
+			HashMap<StringName, MethodBind *> method_map;
+			HashMap<StringName, FlatProperty> property_map;
+			uint32_t generation; //bind_generation it was built at
+		};
+
+		FlatTable *volatile flat_table;
+
 		StringName inherits;
 		StringName name;
 		bool disabled;
@@ -147,6 +168,9 @@ public:
 	}
 
 	static RWLock *lock;
+	static Mutex *flat_lock;
+	static volatile uint32_t bind_generation; //bumped when any class gets a method, property or constant, making every flat table stale
+	static List<ClassInfo::FlatTable *> retired_flat_tables; //replaced tables may still be read, freed on cleanup
 	static HashMap<StringName, ClassInfo> classes;
 	static HashMap<StringName, StringName> resource_base_extensions;
 	static HashMap<StringName, StringName> compat_classes;
@@ -161,6 +185,12 @@ public:
 
 	static void _add_class2(const StringName &p_class, const StringName &p_inherits);
 
+	static const ClassInfo::FlatTable *_get_flat_table(const ClassInfo *p_class);
+	static const ClassInfo::FlatTable *_flatten_class(ClassInfo *p_class);
+	static ClassInfo *_get_object_class(const Object *p_object, const ClassInfo::FlatTable **r_flat);
+	static bool _set_property(Object *p_object, const PropertySetGet *p_setget, const Variant &p_value, bool *r_valid);
+	static bool _get_property(Object *p_object, const PropertySetGet *p_setget, Variant &r_value);
+
 public:
 	// DO NOT USE THIS!!!!!! NEEDS TO BE PUBLIC BUT DO NOT USE NO MATTER WHAT!!!
 	template <class T>
@@ -340,6 +370,7 @@ public:
 
 	static void get_method_list(StringName p_class, List<MethodInfo> *p_methods, bool p_no_inheritance = false, bool p_exclude_from_properties = false);
 	static MethodBind *get_method(StringName p_class, StringName p_name);
+	static MethodBind *get_object_method(const Object *p_object, const StringName &p_name);
 
 	static void add_virtual_method(const StringName &p_class, const MethodInfo &p_method, bool p_virtual = true);
 	static void get_virtual_methods(const StringName &p_class, List<MethodInfo> *p_methods, bool p_no_inheritance = false);
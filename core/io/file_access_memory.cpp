@@ -166,6 +166,14 @@ int FileAccessMemory::get_buffer(uint8_t *p_dst, int p_length) const {
 	return read;
 }
 
+const uint8_t *FileAccessMemory::map_range(size_t p_offset, size_t p_length) const {
+
+	ERR_FAIL_COND_V(!data, NULL);
+	ERR_FAIL_COND_V(p_offset > (size_t)length || p_length > (size_t)length - p_offset, NULL);
+
+	return &data[p_offset];
+}
+
 Error FileAccessMemory::get_error() const {
 
 	return pos >= length ? ERR_FILE_EOF : OK;
@@ -60,6 +60,7 @@ public:
 	virtual uint8_t get_8() const; ///< get a byte
 
 	virtual int get_buffer(uint8_t *p_dst, int p_length) const; ///< get an array of bytes
+	virtual const uint8_t *map_range(size_t p_offset, size_t p_length) const;
 
 	virtual Error get_error() const; ///< get last error
 
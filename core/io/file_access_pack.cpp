@@ -30,11 +30,15 @@
 
 #include "file_access_pack.h"
 
+#include "core/io/marshalls.h"
+#include "core/os/copymem.h"
+#include "core/os/threaded_array_processor.h"
 #include "core/version.h"
 
 #include <stdio.h>
 
-#define PACK_VERSION 1
+// Files with at least this many compressed blocks are decompressed on several threads.
+#define PACK_PARALLEL_DECOMPRESSION_MIN_BLOCKS 16
 
 Error PackedData::add_pack(const String &p_path) {
 
@@ -49,7 +53,7 @@ Error PackedData::add_pack(const String &p_path) {
 	return ERR_FILE_UNRECOGNIZED;
 };
 
-void PackedData::add_path(const String &pkg_path, const String &path, uint64_t ofs, uint64_t size, const uint8_t *p_md5, PackSource *p_src) {
+void PackedData::add_path(const String &pkg_path, const String &path, uint64_t ofs, uint64_t size, const uint8_t *p_md5, PackSource *p_src, uint64_t p_stored_size, int p_compression) {
 
 	PathMD5 pmd5(path.md5_buffer());
 	//printf("adding path %ls, %lli, %lli\n", path.c_str(), pmd5.a, pmd5.b);
@@ -60,6 +64,8 @@ void PackedData::add_path(const String &pkg_path, const String &path, uint64_t o
 	pf.pack = pkg_path;
 	pf.offset = ofs;
 	pf.size = size;
+	pf.stored_size = p_compression >= 0 ? p_stored_size : size;
+	pf.compression = p_compression;
 	for (int i = 0; i < 16; i++)
 		pf.md5[i] = p_md5[i];
 	pf.src = p_src;
@@ -139,16 +145,19 @@ bool PackedSourcePCK::try_open_pack(const String &p_path) {
 	if (!f)
 		return false;
 
+	//packs are only ever replaced as a whole, so they are safe to map
+	f->map_contents();
+
 	//printf("try open %ls!\n", p_path.c_str());
 
 	uint32_t magic = f->get_32();
 
-	if (magic != 0x43504447) {
+	if (magic != PACK_HEADER_MAGIC) {
 		//maybe at he end.... self contained exe
 		f->seek_end();
 		f->seek(f->get_position() - 4);
 		magic = f->get_32();
-		if (magic != 0x43504447) {
+		if (magic != PACK_HEADER_MAGIC) {
 
 			memdelete(f);
 			return false;
@@ -159,7 +168,7 @@ bool PackedSourcePCK::try_open_pack(const String &p_path) {
 		f->seek(f->get_position() - ds - 8);
 
 		magic = f->get_32();
-		if (magic != 0x43504447) {
+		if (magic != PACK_HEADER_MAGIC) {
 
 			memdelete(f);
 			return false;
@@ -171,10 +180,16 @@ bool PackedSourcePCK::try_open_pack(const String &p_path) {
 	uint32_t ver_minor = f->get_32();
 	uint32_t ver_rev = f->get_32();
 
-	ERR_EXPLAIN("Pack version unsupported: " + itos(version));
-	ERR_FAIL_COND_V(version != PACK_VERSION, false);
-	ERR_EXPLAIN("Pack created with a newer version of the engine: " + itos(ver_major) + "." + itos(ver_minor) + "." + itos(ver_rev));
-	ERR_FAIL_COND_V(ver_major > VERSION_MAJOR || (ver_major == VERSION_MAJOR && ver_minor > VERSION_MINOR), false);
+	if (version < 1 || version > PACK_FORMAT_VERSION) {
+		memdelete(f);
+		ERR_EXPLAIN("Pack version unsupported: " + itos(version));
+		ERR_FAIL_V(false);
+	}
+	if (ver_major > VERSION_MAJOR || (ver_major == VERSION_MAJOR && ver_minor > VERSION_MINOR)) {
+		memdelete(f);
+		ERR_EXPLAIN("Pack created with a newer version of the engine: " + itos(ver_major) + "." + itos(ver_minor) + "." + itos(ver_rev));
+		ERR_FAIL_V(false);
+	}
 
 	for (int i = 0; i < 16; i++) {
 		//reserved
@@ -183,32 +198,229 @@ bool PackedSourcePCK::try_open_pack(const String &p_path) {
 
 	int file_count = f->get_32();
 
-	for (int i = 0; i < file_count; i++) {
+	if (version == 1) {
 
-		uint32_t sl = f->get_32();
-		CharString cs;
-		cs.resize(sl + 1);
-		f->get_buffer((uint8_t *)cs.ptr(), sl);
-		cs[sl] = 0;
+		for (int i = 0; i < file_count; i++) {
 
-		String path;
-		path.parse_utf8(cs.ptr());
+			uint32_t sl = f->get_32();
+			CharString cs;
+			cs.resize(sl + 1);
+			f->get_buffer((uint8_t *)cs.ptr(), sl);
+			cs[sl] = 0;
 
-		uint64_t ofs = f->get_64();
-		uint64_t size = f->get_64();
-		uint8_t md5[16];
-		f->get_buffer(md5, 16);
-		PackedData::get_singleton()->add_path(p_path, path, ofs, size, md5, this);
-	};
+			String path;
+			path.parse_utf8(cs.ptr());
+
+			uint64_t ofs = f->get_64();
+			uint64_t size = f->get_64();
+			uint8_t md5[16];
+			f->get_buffer(md5, 16);
+			PackedData::get_singleton()->add_path(p_path, path, ofs, size, md5, this);
+		};
+
+	} else {
+
+		// The whole index is fetched at once (straight from the mapping when possible)
+		// and decoded from memory, instead of issuing several small reads per file.
+		uint32_t strings_size = f->get_32();
+		uint64_t index_size = uint64_t(file_count) * PACK_INDEX_ENTRY_SIZE + strings_size;
+		size_t index_pos = f->get_position();
+
+		const uint8_t *index = f->map_range(index_pos, index_size);
+		Vector<uint8_t> index_buf;
+		if (!index) {
+			index_buf.resize(index_size);
+			if (f->get_buffer(index_buf.ptrw(), index_size) != (int)index_size) {
+				memdelete(f);
+				ERR_EXPLAIN("Pack index is truncated: " + p_path);
+				ERR_FAIL_V(false);
+			}
+			index = index_buf.ptr();
+		}
+
+		const uint8_t *strings = index + uint64_t(file_count) * PACK_INDEX_ENTRY_SIZE;
+
+		for (int i = 0; i < file_count; i++) {
+
+			const uint8_t *entry = index + i * PACK_INDEX_ENTRY_SIZE;
+			uint64_t ofs = decode_uint64(&entry[0]);
+			uint64_t size = decode_uint64(&entry[8]);
+			uint64_t stored_size = decode_uint64(&entry[16]);
+			const uint8_t *md5 = &entry[24];
+			uint32_t path_ofs = decode_uint32(&entry[40]);
+			uint32_t path_len = decode_uint32(&entry[44]);
+			uint32_t flags = decode_uint32(&entry[48]);
+			uint32_t compression = decode_uint32(&entry[52]);
+
+			if (path_ofs > strings_size || path_len > strings_size - path_ofs) {
+				memdelete(f);
+				ERR_EXPLAIN("Pack index is corrupt: " + p_path);
+				ERR_FAIL_V(false);
+			}
+
+			String path;
+			path.parse_utf8((const char *)&strings[path_ofs], path_len);
+
+			int mode = (flags & PACK_FILE_COMPRESSED) ? int(compression) : -1;
+			PackedData::get_singleton()->add_path(p_path, path, ofs, size, md5, this, stored_size, mode);
+		}
+	}
+
+	if (f->map_range(0, f->get_len())) {
+		if (mapped_packs.has(p_path)) {
+			memdelete(mapped_packs[p_path]);
+		}
+		mapped_packs[p_path] = f;
+	} else {
+		memdelete(f);
+	}
 
 	return true;
 };
 
 FileAccess *PackedSourcePCK::get_file(const String &p_path, PackedData::PackedFile *p_file) {
 
+	const uint8_t *pack_data = NULL;
+	Map<String, FileAccess *>::Element *E = mapped_packs.find(p_file->pack);
+	if (E) {
+		pack_data = E->get()->map_range(p_file->offset, p_file->stored_size);
+	}
+
+	if (p_file->compression >= 0) {
+
+		Vector<uint8_t> stored;
+		if (!pack_data) {
+			FileAccess *f = FileAccess::open(p_file->pack, FileAccess::READ);
+			if (!f) {
+				ERR_EXPLAIN("Can't open pack-referenced file: " + String(p_file->pack));
+				ERR_FAIL_V(NULL);
+			}
+			stored.resize(p_file->stored_size);
+			f->seek(p_file->offset);
+			int read = f->get_buffer(stored.ptrw(), stored.size());
+			memdelete(f);
+			ERR_FAIL_COND_V(read != stored.size(), NULL);
+			pack_data = stored.ptr();
+		}
+
+		Vector<uint8_t> data;
+		data.resize(p_file->size);
+		Error err = decompress_file_data(pack_data, p_file->stored_size, data.ptrw(), data.size(), (Compression::Mode)p_file->compression);
+		if (err != OK) {
+			ERR_EXPLAIN("Can't decompress packed file: " + p_path);
+			ERR_FAIL_V(NULL);
+		}
+
+		return memnew(FileAccessPack(p_path, *p_file, data));
+	}
+
+	if (pack_data) {
+		return memnew(FileAccessPack(p_path, *p_file, pack_data));
+	}
+
 	return memnew(FileAccessPack(p_path, *p_file));
 };
 
+// Compressed files are split in blocks of PACK_COMPRESSION_BLOCK_SIZE bytes which are
+// compressed independently, so they can be decompressed in parallel. Layout:
+// block size (32 bits), block count (32 bits), compressed size of each block (32 bits each), blocks.
+
+Vector<uint8_t> PackedSourcePCK::compress_file_data(const uint8_t *p_data, int p_size, Compression::Mode p_mode) {
+
+	uint32_t block_count = (p_size + PACK_COMPRESSION_BLOCK_SIZE - 1) / PACK_COMPRESSION_BLOCK_SIZE;
+	uint32_t header_size = 8 + block_count * 4;
+
+	Vector<uint8_t> ret;
+	ret.resize(header_size + block_count * Compression::get_max_compressed_buffer_size(PACK_COMPRESSION_BLOCK_SIZE, p_mode));
+
+	uint8_t *w = ret.ptrw();
+	encode_uint32(PACK_COMPRESSION_BLOCK_SIZE, &w[0]);
+	encode_uint32(block_count, &w[4]);
+
+	uint32_t ofs = header_size;
+	for (uint32_t i = 0; i < block_count; i++) {
+
+		int block_len = MIN(PACK_COMPRESSION_BLOCK_SIZE, p_size - int(i * PACK_COMPRESSION_BLOCK_SIZE));
+		int csize = Compression::compress(&w[ofs], &p_data[i * PACK_COMPRESSION_BLOCK_SIZE], block_len, p_mode);
+		ERR_FAIL_COND_V(csize < 0, Vector<uint8_t>());
+		encode_uint32(csize, &w[8 + i * 4]);
+		ofs += csize;
+	}
+
+	ret.resize(ofs);
+	return ret;
+}
+
+struct _PackBlockDecompressor {
+
+	const uint8_t *src;
+	uint8_t *dst;
+	Vector<uint64_t> block_offsets;
+	const uint8_t *block_sizes;
+	uint32_t block_size;
+	int size;
+	Compression::Mode mode;
+	uint32_t failed;
+
+	void decompress_block(uint32_t p_index, void *p_userdata) {
+
+		int block_len = MIN(int(block_size), size - int(p_index * block_size));
+		int csize = decode_uint32(&block_sizes[p_index * 4]);
+		int ret = Compression::decompress(&dst[p_index * block_size], block_len, &src[block_offsets[p_index]], csize, mode);
+		if (ret != block_len) {
+			failed = 1;
+		}
+	}
+};
+
+Error PackedSourcePCK::decompress_file_data(const uint8_t *p_src, uint64_t p_src_size, uint8_t *p_dst, int p_size, Compression::Mode p_mode) {
+
+	ERR_FAIL_COND_V(p_src_size < 8, ERR_FILE_CORRUPT);
+
+	_PackBlockDecompressor dec;
+	dec.src = p_src;
+	dec.dst = p_dst;
+	dec.block_size = decode_uint32(&p_src[0]);
+	dec.size = p_size;
+	dec.mode = p_mode;
+	dec.failed = 0;
+
+	uint32_t block_count = decode_uint32(&p_src[4]);
+	ERR_FAIL_COND_V(dec.block_size == 0, ERR_FILE_CORRUPT);
+	ERR_FAIL_COND_V(uint64_t(block_count) * dec.block_size < uint64_t(p_size), ERR_FILE_CORRUPT);
+	ERR_FAIL_COND_V(block_count > 0 && uint64_t(block_count - 1) * dec.block_size >= uint64_t(p_size), ERR_FILE_CORRUPT);
+
+	uint64_t ofs = 8 + uint64_t(block_count) * 4;
+	ERR_FAIL_COND_V(ofs > p_src_size, ERR_FILE_CORRUPT);
+	dec.block_sizes = &p_src[8];
+
+	dec.block_offsets.resize(block_count);
+	for (uint32_t i = 0; i < block_count; i++) {
+		dec.block_offsets.write[i] = ofs;
+		ofs += decode_uint32(&dec.block_sizes[i * 4]);
+	}
+	ERR_FAIL_COND_V(ofs > p_src_size, ERR_FILE_CORRUPT);
+
+	if (block_count >= PACK_PARALLEL_DECOMPRESSION_MIN_BLOCKS) {
+		thread_process_array(block_count, &dec, &_PackBlockDecompressor::decompress_block, (void *)NULL);
+	} else {
+		for (uint32_t i = 0; i < block_count; i++) {
+			dec.decompress_block(i, NULL);
+		}
+	}
+
+	ERR_FAIL_COND_V(dec.failed, ERR_FILE_CORRUPT);
+
+	return OK;
+}
+
+PackedSourcePCK::~PackedSourcePCK() {
+
+	for (Map<String, FileAccess *>::Element *E = mapped_packs.front(); E; E = E->next()) {
+		memdelete(E->get());
+	}
+}
+
 //////////////////////////////////////////////////////////////////
 
 Error FileAccessPack::_open(const String &p_path, int p_mode_flags) {
@@ -219,11 +431,19 @@ Error FileAccessPack::_open(const String &p_path, int p_mode_flags) {
 
 void FileAccessPack::close() {
 
+	if (data) {
+		data = NULL;
+		return;
+	}
+
 	f->close();
 }
 
 bool FileAccessPack::is_open() const {
 
+	if (!f)
+		return data != NULL;
+
 	return f->is_open();
 }
 
@@ -235,7 +455,8 @@ void FileAccessPack::seek(size_t p_position) {
 		eof = false;
 	}
 
-	f->seek(pf.offset + p_position);
+	if (f)
+		f->seek(pf.offset + p_position);
 	pos = p_position;
 }
 void FileAccessPack::seek_end(int64_t p_position) {
@@ -263,6 +484,9 @@ uint8_t FileAccessPack::get_8() const {
 		return 0;
 	}
 
+	if (data)
+		return data[pos++];
+
 	pos++;
 	return f->get_8();
 }
@@ -278,18 +502,36 @@ int FileAccessPack::get_buffer(uint8_t *p_dst, int p_length) const {
 		to_read = int64_t(pf.size) - int64_t(pos);
 	}
 
+	size_t from = pos;
 	pos += p_length;
 
 	if (to_read <= 0)
 		return 0;
-	f->get_buffer(p_dst, to_read);
+
+	if (data) {
+		copymem(p_dst, data + from, to_read);
+	} else {
+		f->get_buffer(p_dst, to_read);
+	}
 
 	return to_read;
 }
 
+const uint8_t *FileAccessPack::map_range(size_t p_offset, size_t p_length) const {
+
+	if (p_offset > pf.size || p_length > pf.size - p_offset)
+		return NULL;
+
+	if (data)
+		return data + p_offset;
+
+	return f->map_range(pf.offset + p_offset, p_length);
+}
+
 void FileAccessPack::set_endian_swap(bool p_swap) {
 	FileAccess::set_endian_swap(p_swap);
-	f->set_endian_swap(p_swap);
+	if (f)
+		f->set_endian_swap(p_swap);
 }
 
 Error FileAccessPack::get_error() const {
@@ -319,16 +561,31 @@ bool FileAccessPack::file_exists(const String &p_name) {
 	return false;
 }
 
-FileAccessPack::FileAccessPack(const String &p_path, const PackedData::PackedFile &p_file) :
+FileAccessPack::FileAccessPack(const String &p_path, const PackedData::PackedFile &p_file, const uint8_t *p_pack_data) :
 		pf(p_file),
-		f(FileAccess::open(pf.pack, FileAccess::READ)) {
+		f(NULL),
+		data(p_pack_data) {
+	pos = 0;
+	eof = false;
+
+	if (data)
+		return;
+
+	f = FileAccess::open(pf.pack, FileAccess::READ);
 	if (!f) {
 		ERR_EXPLAIN("Can't open pack-referenced file: " + String(pf.pack));
 		ERR_FAIL_COND(!f);
 	}
 	f->seek(pf.offset);
+}
+
+FileAccessPack::FileAccessPack(const String &p_path, const PackedData::PackedFile &p_file, const Vector<uint8_t> &p_decompressed) :
+		pf(p_file),
+		f(NULL),
+		decompressed(p_decompressed) {
 	pos = 0;
 	eof = false;
+	data = decompressed.ptr();
 }
 
 FileAccessPack::~FileAccessPack() {
@@ -31,12 +31,27 @@
 #ifndef FILE_ACCESS_PACK_H
 #define FILE_ACCESS_PACK_H
 
+#include "core/io/compression.h"
 #include "core/list.h"
 #include "core/map.h"
 #include "core/os/dir_access.h"
 #include "core/os/file_access.h"
 #include "core/print_string.h"
 
+// Godot's packed file magic header ("GDPC" in ASCII).
+#define PACK_HEADER_MAGIC 0x43504447
+// The current packed file format version number.
+// Version 2 stores the index as fixed-size records followed by a path table, and may compress files.
+#define PACK_FORMAT_VERSION 2
+// Size in bytes of a version 2 index record.
+#define PACK_INDEX_ENTRY_SIZE 56
+// Uncompressed size of the independently compressed blocks of a file.
+#define PACK_COMPRESSION_BLOCK_SIZE 65536
+
+enum PackFileFlags {
+	PACK_FILE_COMPRESSED = 1 << 0,
+};
+
 class PackSource;
 
 class PackedData {
@@ -50,6 +65,8 @@ public:
 		String pack;
 		uint64_t offset; //if offset is ZERO, the file was ERASED
 		uint64_t size;
+		uint64_t stored_size; // bytes used in the pack, differs from size when compressed
+		int compression; // Compression::Mode, -1 if stored as is
 		uint8_t md5[16];
 		PackSource *src;
 	};
@@ -102,7 +119,7 @@ private:
 
 public:
 	void add_pack_source(PackSource *p_source);
-	void add_path(const String &pkg_path, const String &path, uint64_t ofs, uint64_t size, const uint8_t *p_md5, PackSource *p_src); // for PackSource
+	void add_path(const String &pkg_path, const String &path, uint64_t ofs, uint64_t size, const uint8_t *p_md5, PackSource *p_src, uint64_t p_stored_size = 0, int p_compression = -1); // for PackSource
 
 	void set_disabled(bool p_disabled) { disabled = p_disabled; }
 	_FORCE_INLINE_ bool is_disabled() const { return disabled; }
@@ -127,9 +144,18 @@ public:
 
 class PackedSourcePCK : public PackSource {
 
+	// Packs whose contents could be mapped into memory are kept open for the
+	// lifetime of the source, files inside them are then read straight from the mapping.
+	Map<String, FileAccess *> mapped_packs;
+
 public:
 	virtual bool try_open_pack(const String &p_path);
 	virtual FileAccess *get_file(const String &p_path, PackedData::PackedFile *p_file);
+
+	static Vector<uint8_t> compress_file_data(const uint8_t *p_data, int p_size, Compression::Mode p_mode = Compression::MODE_ZSTD);
+	static Error decompress_file_data(const uint8_t *p_src, uint64_t p_src_size, uint8_t *p_dst, int p_size, Compression::Mode p_mode);
+
+	~PackedSourcePCK();
 };
 
 class FileAccessPack : public FileAccess {
@@ -140,6 +166,8 @@ class FileAccessPack : public FileAccess {
 	mutable bool eof;
 
 	FileAccess *f;
+	const uint8_t *data; // start of the file inside a mapped pack or decompressed buffer, used instead of f when set
+	Vector<uint8_t> decompressed;
 	virtual Error _open(const String &p_path, int p_mode_flags);
 	virtual uint64_t _get_modified_time(const String &p_file) { return 0; }
 
@@ -157,6 +185,7 @@ public:
 	virtual uint8_t get_8() const;
 
 	virtual int get_buffer(uint8_t *p_dst, int p_length) const;
+	virtual const uint8_t *map_range(size_t p_offset, size_t p_length) const;
 
 	virtual void set_endian_swap(bool p_swap);
 
@@ -169,7 +198,8 @@ public:
 
 	virtual bool file_exists(const String &p_name);
 
-	FileAccessPack(const String &p_path, const PackedData::PackedFile &p_file);
+	FileAccessPack(const String &p_path, const PackedData::PackedFile &p_file, const uint8_t *p_pack_data = NULL);
+	FileAccessPack(const String &p_path, const PackedData::PackedFile &p_file, const Vector<uint8_t> &p_decompressed);
 	~FileAccessPack();
 };
 
@@ -112,7 +112,7 @@ Error HTTPClient::request_raw(Method p_method, const String &p_url, const Vector
 
 	ERR_FAIL_INDEX_V(p_method, METHOD_MAX, ERR_INVALID_PARAMETER);
 	ERR_FAIL_COND_V(!p_url.begins_with("/"), ERR_INVALID_PARAMETER);
-	ERR_FAIL_COND_V(status != STATUS_CONNECTED, ERR_INVALID_PARAMETER);
+	ERR_FAIL_COND_V(!_can_request(), ERR_INVALID_PARAMETER);
 	ERR_FAIL_COND_V(connection.is_null(), ERR_INVALID_DATA);
 
 	String request = String(_methods[p_method]) + " " + p_url + " HTTP/1.1\r\n";
@@ -170,7 +170,7 @@ Error HTTPClient::request_raw(Method p_method, const String &p_url, const Vector
 		return err;
 	}
 
-	status = STATUS_REQUESTING;
+	_request_sent(p_method);
 
 	return OK;
 }
@@ -179,7 +179,7 @@ Error HTTPClient::request(Method p_method, const String &p_url, const Vector<Str
 
 	ERR_FAIL_INDEX_V(p_method, METHOD_MAX, ERR_INVALID_PARAMETER);
 	ERR_FAIL_COND_V(!p_url.begins_with("/"), ERR_INVALID_PARAMETER);
-	ERR_FAIL_COND_V(status != STATUS_CONNECTED, ERR_INVALID_PARAMETER);
+	ERR_FAIL_COND_V(!_can_request(), ERR_INVALID_PARAMETER);
 	ERR_FAIL_COND_V(connection.is_null(), ERR_INVALID_DATA);
 
 	String request = String(_methods[p_method]) + " " + p_url + " HTTP/1.1\r\n";
@@ -225,7 +225,7 @@ Error HTTPClient::request(Method p_method, const String &p_url, const Vector<Str
 		return err;
 	}
 
-	status = STATUS_REQUESTING;
+	_request_sent(p_method);
 
 	return OK;
 }
@@ -278,11 +278,42 @@ void HTTPClient::close() {
 	body_size = -1;
 	body_left = 0;
 	chunk_left = 0;
+	chunk_trailer = false;
+	chunk_last = false;
+	chunk.clear();
 	read_until_eof = false;
+	keep_alive = false;
+	requests_pending.clear();
+	recv_buffer_pos = 0;
+	recv_buffer_len = 0;
+	recv_error = OK;
 	response_num = 0;
 	handshaking = false;
 }
 
+bool HTTPClient::_can_request() const {
+
+	if (status == STATUS_CONNECTED)
+		return true;
+
+	// Pipelined requests queue up behind the response being read; their
+	// responses come back in order on the same stream.
+	return pipelining && (status == STATUS_REQUESTING || status == STATUS_BODY);
+}
+
+void HTTPClient::_request_sent(Method p_method) {
+
+	requests_pending.push_back(p_method);
+	if (status == STATUS_CONNECTED)
+		status = STATUS_REQUESTING;
+}
+
+void HTTPClient::_response_done() {
+
+	// With pipelining, the next response may already be on its way
+	status = requests_pending.size() > 0 ? STATUS_REQUESTING : STATUS_CONNECTED;
+}
+
 Error HTTPClient::poll() {
 
 	switch (status) {
@@ -408,6 +439,9 @@ Error HTTPClient::poll() {
 					chunked = false;
 					body_left = 0;
 					chunk_left = 0;
+					chunk_trailer = false;
+					chunk_last = false;
+					chunk.clear();
 					read_until_eof = false;
 					response_str.clear();
 					response_headers.clear();
@@ -417,7 +451,9 @@ Error HTTPClient::poll() {
 					// it's safe to assume it only if the explicit header is found, allowing
 					// to handle body-up-to-EOF responses on naive servers; that's what Curl
 					// and browsers do
-					bool keep_alive = false;
+					keep_alive = false;
+					bool connection_close = false;
+					bool http_1_1 = false;
 
 					for (int i = 0; i < responses.size(); i++) {
 
@@ -436,19 +472,34 @@ Error HTTPClient::poll() {
 							}
 						} else if (s.begins_with("connection: keep-alive")) {
 							keep_alive = true;
+						} else if (s.begins_with("connection: close")) {
+							connection_close = true;
 						}
 
 						if (i == 0 && responses[i].begins_with("HTTP")) {
 
 							String num = responses[i].get_slicec(' ', 1);
 							response_num = num.to_int();
+							http_1_1 = responses[i].begins_with("HTTP/1.1");
 						} else {
 
 							response_headers.push_back(header);
 						}
 					}
 
-					if (body_size != -1 || chunked) {
+					Method request_method = METHOD_GET;
+					if (requests_pending.size() > 0) {
+						request_method = requests_pending.front()->get();
+						requests_pending.pop_front();
+					}
+
+					// These never carry a body, whatever the headers say
+					bool no_body = request_method == METHOD_HEAD || response_num == RESPONSE_NO_CONTENT || response_num == RESPONSE_NOT_MODIFIED;
+
+					if (no_body) {
+
+						_response_done();
+					} else if (body_size != -1 || chunked) {
 
 						status = STATUS_BODY;
 					} else if (!keep_alive) {
@@ -457,8 +508,12 @@ Error HTTPClient::poll() {
 						status = STATUS_BODY;
 					} else {
 
-						status = STATUS_CONNECTED;
+						_response_done();
 					}
+
+					// From here on, whether the server will take more requests on this
+					// connection once the body is read (HTTP 1.1 defaults to yes)
+					keep_alive = !read_until_eof && !connection_close && (keep_alive || http_1_1);
 					return OK;
 				}
 			}
@@ -491,138 +546,151 @@ PoolByteArray HTTPClient::read_response_body_chunk() {
 
 	ERR_FAIL_COND_V(status != STATUS_BODY, PoolByteArray());
 
+	int to_read = (chunked || read_until_eof) ? read_chunk_size : MIN(body_left, read_chunk_size);
+
+	PoolByteArray ret;
+	if (to_read == 0) {
+		// Empty body, only the state needs updating
+		int received = 0;
+		read_response_body(NULL, 0, received);
+		return ret;
+	}
+
+	ret.resize(to_read);
+	int received = 0;
+	{
+		PoolByteArray::Write w = ret.write();
+		read_response_body(w.ptr(), to_read, received);
+	}
+	ret.resize(received);
+
+	return ret;
+}
+
+Error HTTPClient::read_response_body(uint8_t *p_buffer, int p_max_bytes, int &r_received) {
+
+	r_received = 0;
+	ERR_FAIL_COND_V(status != STATUS_BODY, ERR_UNCONFIGURED);
+	ERR_FAIL_COND_V(p_max_bytes < 0 || (p_max_bytes > 0 && !p_buffer), ERR_INVALID_PARAMETER);
+
 	Error err = OK;
 
 	if (chunked) {
 
 		while (true) {
 
-			if (chunk_left == 0) {
-				// Reading length
-				uint8_t b;
-				int rec = 0;
-				err = _get_http_data(&b, 1, rec);
+			if (chunk_left > 0) {
+				if (r_received == p_max_bytes)
+					break;
 
-				if (rec == 0)
+				// Chunk data goes straight to the caller
+				int rec = 0;
+				err = _get_http_data(p_buffer + r_received, MIN(chunk_left, p_max_bytes - r_received), rec);
+				r_received += rec;
+				chunk_left -= rec;
+				if (err != OK || rec == 0)
 					break;
+				continue;
+			}
 
-				chunk.push_back(b);
+			// Between chunks, lines are read one byte at a time: the \r\n ending
+			// the previous chunk, the next hex length, and after the last chunk
+			// the trailer up to an empty line.
+			uint8_t b;
+			int rec = 0;
+			err = _get_http_data(&b, 1, rec);
+			if (err != OK || rec == 0)
+				break;
 
-				if (chunk.size() > 32) {
-					ERR_PRINT("HTTP Invalid chunk hex len");
-					status = STATUS_CONNECTION_ERROR;
-					return PoolByteArray();
-				}
+			chunk.push_back(b);
 
-				if (chunk.size() > 2 && chunk[chunk.size() - 2] == '\r' && chunk[chunk.size() - 1] == '\n') {
-
-					int len = 0;
-					for (int i = 0; i < chunk.size() - 2; i++) {
-						char c = chunk[i];
-						int v = 0;
-						if (c >= '0' && c <= '9')
-							v = c - '0';
-						else if (c >= 'a' && c <= 'f')
-							v = c - 'a' + 10;
-						else if (c >= 'A' && c <= 'F')
-							v = c - 'A' + 10;
-						else {
-							ERR_PRINT("HTTP Chunk len not in hex!!");
-							status = STATUS_CONNECTION_ERROR;
-							return PoolByteArray();
-						}
-						len <<= 4;
-						len |= v;
-						if (len > (1 << 24)) {
-							ERR_PRINT("HTTP Chunk too big!! >16mb");
-							status = STATUS_CONNECTION_ERROR;
-							return PoolByteArray();
-						}
-					}
+			if (chunk.size() > (chunk_last ? 4096 : 32)) {
+				ERR_PRINT("HTTP Invalid chunk hex len");
+				status = STATUS_CONNECTION_ERROR;
+				return ERR_INVALID_DATA;
+			}
 
-					if (len == 0) {
-						// End reached!
-						status = STATUS_CONNECTED;
-						chunk.clear();
-						return PoolByteArray();
-					}
+			int cs = chunk.size();
+			if (cs < 2 || chunk[cs - 2] != '\r' || chunk[cs - 1] != '\n')
+				continue;
+
+			int line_len = cs - 2;
+
+			if (chunk_trailer) {
 
-					chunk_left = len + 2;
-					chunk.resize(chunk_left);
+				if (line_len != 0) {
+					ERR_PRINT("HTTP Invalid chunk terminator (not \\r\\n)");
+					status = STATUS_CONNECTION_ERROR;
+					return ERR_INVALID_DATA;
 				}
-			} else {
+				chunk_trailer = false;
 
-				int rec = 0;
-				err = _get_http_data(&chunk.write[chunk.size() - chunk_left], chunk_left, rec);
-				if (rec == 0) {
-					break;
+			} else if (chunk_last) {
+
+				if (line_len == 0) {
+					// End reached!
+					chunk.clear();
+					chunk_last = false;
+					_response_done();
+					return OK;
 				}
-				chunk_left -= rec;
+				// Trailer headers are skipped
 
-				if (chunk_left == 0) {
+			} else {
 
-					if (chunk[chunk.size() - 2] != '\r' || chunk[chunk.size() - 1] != '\n') {
-						ERR_PRINT("HTTP Invalid chunk terminator (not \\r\\n)");
+				int len = 0;
+				for (int i = 0; i < line_len && chunk[i] != ';'; i++) {
+					char c = chunk[i];
+					int v = 0;
+					if (c >= '0' && c <= '9')
+						v = c - '0';
+					else if (c >= 'a' && c <= 'f')
+						v = c - 'a' + 10;
+					else if (c >= 'A' && c <= 'F')
+						v = c - 'A' + 10;
+					else {
+						ERR_PRINT("HTTP Chunk len not in hex!!");
 						status = STATUS_CONNECTION_ERROR;
-						return PoolByteArray();
+						return ERR_INVALID_DATA;
 					}
-
-					PoolByteArray ret;
-					ret.resize(chunk.size() - 2);
-					{
-						PoolByteArray::Write w = ret.write();
-						copymem(w.ptr(), chunk.ptr(), chunk.size() - 2);
+					len <<= 4;
+					len |= v;
+					if (len > (1 << 24)) {
+						ERR_PRINT("HTTP Chunk too big!! >16mb");
+						status = STATUS_CONNECTION_ERROR;
+						return ERR_INVALID_DATA;
 					}
-					chunk.clear();
-
-					return ret;
 				}
 
-				break;
+				if (len == 0) {
+					chunk_last = true;
+				} else {
+					chunk_left = len;
+					chunk_trailer = true;
+				}
 			}
+
+			chunk.clear();
 		}
 
 	} else {
 
-		int to_read = !read_until_eof ? MIN(body_left, read_chunk_size) : read_chunk_size;
-		PoolByteArray ret;
-		ret.resize(to_read);
-		int _offset = 0;
-		while (read_until_eof || to_read > 0) {
-			int rec = 0;
-			{
-				PoolByteArray::Write w = ret.write();
-				err = _get_http_data(w.ptr() + _offset, to_read, rec);
-			}
-			if (rec < 0) {
-				if (to_read > 0) // Ended up reading less
-					ret.resize(_offset);
-				break;
-			} else {
-				_offset += rec;
-				if (!read_until_eof) {
-					body_left -= rec;
-					to_read -= rec;
-				} else {
-					if (rec < to_read) {
-						ret.resize(_offset);
-						err = ERR_FILE_EOF;
-						break;
-					}
-					ret.resize(_offset + to_read);
-				}
-			}
+		int to_read = read_until_eof ? p_max_bytes : MIN(body_left, p_max_bytes);
+		if (to_read > 0) {
+			err = _get_http_data(p_buffer, to_read, r_received);
 		}
-		if (!read_until_eof) {
-			if (body_left == 0) {
-				status = STATUS_CONNECTED;
-			}
-			return ret;
-		} else {
+
+		if (read_until_eof) {
 			if (err == ERR_FILE_EOF) {
-				err = OK; // EOF is expected here
+				// EOF is expected here, it's how the body ends
 				close();
-				return ret;
+				return OK;
+			}
+		} else {
+			body_left -= r_received;
+			if (body_left == 0) {
+				_response_done();
+				return OK;
 			}
 		}
 	}
@@ -638,12 +706,24 @@ PoolByteArray HTTPClient::read_response_body_chunk() {
 
 			status = STATUS_CONNECTION_ERROR;
 		}
-	} else if (body_left == 0 && !chunked) {
-
-		status = STATUS_CONNECTED;
 	}
 
-	return PoolByteArray();
+	return err;
+}
+
+bool HTTPClient::is_response_keep_alive() const {
+
+	return keep_alive;
+}
+
+void HTTPClient::set_pipelining_enabled(bool p_enable) {
+
+	pipelining = p_enable;
+}
+
+bool HTTPClient::is_pipelining_enabled() const {
+
+	return pipelining;
 }
 
 HTTPClient::Status HTTPClient::get_status() const {
@@ -661,7 +741,7 @@ bool HTTPClient::is_blocking_mode_enabled() const {
 	return blocking;
 }
 
-Error HTTPClient::_get_http_data(uint8_t *p_buffer, int p_bytes, int &r_received) {
+Error HTTPClient::_read_connection(uint8_t *p_buffer, int p_bytes, int &r_received) {
 
 	if (blocking) {
 
@@ -689,6 +769,64 @@ Error HTTPClient::_get_http_data(uint8_t *p_buffer, int p_bytes, int &r_received
 	}
 }
 
+Error HTTPClient::_get_http_data(uint8_t *p_buffer, int p_bytes, int &r_received) {
+
+	r_received = 0;
+
+	// Whatever an earlier small read fetched ahead comes first
+	if (recv_buffer_pos < recv_buffer_len) {
+		int n = MIN(p_bytes, recv_buffer_len - recv_buffer_pos);
+		copymem(p_buffer, recv_buffer.ptr() + recv_buffer_pos, n);
+		recv_buffer_pos += n;
+		r_received = n;
+		if (r_received == p_bytes || !blocking)
+			return OK;
+	}
+
+	if (recv_error != OK) {
+		// Held back until the bytes that came before it were handed out
+		Error err = recv_error;
+		recv_error = OK;
+		return err;
+	}
+
+	int left = p_bytes - r_received;
+	int read = 0;
+
+	if (left >= RECV_BUFFER_SIZE) {
+		// Large reads (body data) go straight to the caller
+		Error err = _read_connection(p_buffer + r_received, left, read);
+		r_received += read;
+		return err;
+	}
+
+	// Small reads (response headers, chunk lengths) go through the buffer,
+	// so they don't cost a system call per byte
+	if (recv_buffer.size() == 0) {
+		recv_buffer.resize(RECV_BUFFER_SIZE);
+	}
+	recv_buffer_pos = 0;
+	recv_buffer_len = 0;
+
+	Error err = OK;
+	do {
+		err = connection->get_partial_data(recv_buffer.ptrw() + recv_buffer_len, RECV_BUFFER_SIZE - recv_buffer_len, read);
+		recv_buffer_len += read;
+	} while (blocking && err == OK && recv_buffer_len < left);
+
+	int n = MIN(left, recv_buffer_len);
+	copymem(p_buffer + r_received, recv_buffer.ptr(), n);
+	recv_buffer_pos = n;
+	r_received += n;
+
+	if (err != OK && recv_buffer_pos < recv_buffer_len) {
+		recv_error = err;
+		return OK;
+	}
+
+	return err;
+}
+
 void HTTPClient::set_read_chunk_size(int p_size) {
 	ERR_FAIL_COND(p_size < 256 || p_size > (1 << 24));
 	read_chunk_size = p_size;
@@ -704,7 +842,15 @@ HTTPClient::HTTPClient() {
 	chunked = false;
 	body_left = 0;
 	read_until_eof = false;
+	keep_alive = false;
 	chunk_left = 0;
+	chunk_trailer = false;
+	chunk_last = false;
+	pipelining = false;
+	requests_pending.clear();
+	recv_buffer_pos = 0;
+	recv_buffer_len = 0;
+	recv_error = OK;
 	response_num = 0;
 	ssl = false;
 	blocking = false;
@@ -795,8 +941,12 @@ void HTTPClient::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("get_response_headers_as_dictionary"), &HTTPClient::_get_response_headers_as_dictionary);
 	ClassDB::bind_method(D_METHOD("get_response_body_length"), &HTTPClient::get_response_body_length);
 	ClassDB::bind_method(D_METHOD("read_response_body_chunk"), &HTTPClient::read_response_body_chunk);
+	ClassDB::bind_method(D_METHOD("is_response_keep_alive"), &HTTPClient::is_response_keep_alive);
 	ClassDB::bind_method(D_METHOD("set_read_chunk_size", "bytes"), &HTTPClient::set_read_chunk_size);
 
+	ClassDB::bind_method(D_METHOD("set_pipelining_enabled", "enabled"), &HTTPClient::set_pipelining_enabled);
+	ClassDB::bind_method(D_METHOD("is_pipelining_enabled"), &HTTPClient::is_pipelining_enabled);
+
 	ClassDB::bind_method(D_METHOD("set_blocking_mode", "enabled"), &HTTPClient::set_blocking_mode);
 	ClassDB::bind_method(D_METHOD("is_blocking_mode_enabled"), &HTTPClient::is_blocking_mode_enabled);
 
@@ -806,6 +956,7 @@ void HTTPClient::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("query_string_from_dict", "fields"), &HTTPClient::query_string_from_dict);
 
 	ADD_PROPERTY(PropertyInfo(Variant::BOOL, "blocking_mode_enabled"), "set_blocking_mode", "is_blocking_mode_enabled");
+	ADD_PROPERTY(PropertyInfo(Variant::BOOL, "pipelining_enabled"), "set_pipelining_enabled", "is_pipelining_enabled");
 	ADD_PROPERTY(PropertyInfo(Variant::OBJECT, "connection", PROPERTY_HINT_RESOURCE_TYPE, "StreamPeer", 0), "set_connection", "get_connection");
 
 	BIND_ENUM_CONSTANT(METHOD_GET);
@@ -40,6 +40,8 @@ class HTTPClient : public Reference {
 
 	GDCLASS(HTTPClient, Reference);
 
+	friend class NetworkPollGroup;
+
 public:
 	enum ResponseCode {
 
@@ -149,6 +151,7 @@ public:
 private:
 	static const char *_methods[METHOD_MAX];
 	static const int HOST_MIN_LEN = 4;
+	static const int RECV_BUFFER_SIZE = 4096;
 
 	enum Port {
 
@@ -172,9 +175,20 @@ private:
 	bool chunked;
 	Vector<uint8_t> chunk;
 	int chunk_left;
+	bool chunk_trailer;
+	bool chunk_last;
 	int body_size;
 	int body_left;
 	bool read_until_eof;
+	bool keep_alive;
+
+	bool pipelining;
+	List<Method> requests_pending; // method of each request sent whose response hasn't started yet
+
+	Vector<uint8_t> recv_buffer;
+	int recv_buffer_pos;
+	int recv_buffer_len;
+	Error recv_error;
 
 	Ref<StreamPeerTCP> tcp_connection;
 	Ref<StreamPeer> connection;
@@ -183,7 +197,11 @@ private:
 	Vector<String> response_headers;
 	int read_chunk_size;
 
+	Error _read_connection(uint8_t *p_buffer, int p_bytes, int &r_received);
 	Error _get_http_data(uint8_t *p_buffer, int p_bytes, int &r_received);
+	bool _can_request() const;
+	void _request_sent(Method p_method);
+	void _response_done();
 
 #else
 #include "platform/javascript/http_client.h.inc"
@@ -214,6 +232,11 @@ public:
 	int get_response_body_length() const;
 
 	PoolByteArray read_response_body_chunk(); // Can't get body as partial text because of most encodings UTF8, gzip, etc.
+	Error read_response_body(uint8_t *p_buffer, int p_max_bytes, int &r_received); // Same, but straight into the caller's memory
+	bool is_response_keep_alive() const;
+
+	void set_pipelining_enabled(bool p_enable); // Allows sending requests before the previous responses were read
+	bool is_pipelining_enabled() const;
 
 	void set_blocking_mode(bool p_enable); // Useful mostly if running in a thread
 	bool is_blocking_mode_enabled() const;
@@ -0,0 +1,848 @@
+/*************************************************************************/
+/*  http_session.cpp                                                     */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2018 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2018 Godot Engine contributors (cf. AUTHORS.md)    */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+
+#include "http_session.h"
+
+#include "core/os/os.h"
+
+static bool _is_idempotent(HTTPClient::Method p_method) {
+
+	return p_method != HTTPClient::METHOD_POST && p_method != HTTPClient::METHOD_PATCH && p_method != HTTPClient::METHOD_CONNECT;
+}
+
+int HTTPSession::_add_request(const String &p_url, HTTPClient::Method p_method, const Vector<String> &p_headers, const PoolVector<uint8_t> &p_body) {
+
+	ERR_FAIL_INDEX_V(p_method, HTTPClient::METHOD_MAX, -1);
+
+	String url = p_url;
+	bool ssl = false;
+	int port = 80;
+
+	String url_lower = url.to_lower();
+	if (url_lower.begins_with("http://")) {
+		url = url.substr(7, url.length() - 7);
+	} else if (url_lower.begins_with("https://")) {
+		url = url.substr(8, url.length() - 8);
+		ssl = true;
+		port = 443;
+	} else {
+		ERR_EXPLAIN("Malformed URL");
+		ERR_FAIL_V(-1);
+	}
+
+	String path = "/";
+	int slash_pos = url.find("/");
+	if (slash_pos != -1) {
+		path = url.substr(slash_pos, url.length());
+		url = url.substr(0, slash_pos);
+	}
+
+	int colon_pos = url.find(":");
+	if (colon_pos != -1) {
+		port = url.substr(colon_pos + 1, url.length()).to_int();
+		url = url.substr(0, colon_pos);
+		ERR_FAIL_COND_V(port < 1 || port > 65535, -1);
+	}
+
+	if (url.length() < 1) {
+		ERR_EXPLAIN("URL too short");
+		ERR_FAIL_V(-1);
+	}
+
+	String key = (ssl ? "https://" : "http://") + url.to_lower() + ":" + itos(port);
+
+	Host *host;
+	Map<String, Host *>::Element *E = hosts.find(key);
+	if (E) {
+		host = E->get();
+	} else {
+		host = memnew(Host);
+		host->key = key;
+		host->name = url;
+		host->port = port;
+		host->ssl = ssl;
+		hosts[key] = host;
+	}
+
+	Request *r = memnew(Request);
+	r->id = ++last_id;
+	r->host = host;
+	r->method = p_method;
+	r->path = path;
+	r->headers = p_headers;
+	r->body = p_body;
+	r->file = NULL;
+	r->body_func = NULL;
+	r->done_func = NULL;
+	r->userdata = NULL;
+	r->result = RESULT_SUCCESS;
+	r->response_code = 0;
+	r->received = 0;
+	r->retries = 0;
+
+	host->queue.push_back(r);
+	requests[r->id] = r;
+
+	return r->id;
+}
+
+void HTTPSession::_finish(Request *p_request, Result p_result) {
+
+	if (p_request->file) {
+		memdelete(p_request->file);
+		p_request->file = NULL;
+	}
+
+	if (p_result != RESULT_SUCCESS) {
+		p_request->response_body.resize(0);
+	}
+
+	p_request->result = p_result;
+	requests.erase(p_request->id);
+	done.push_back(p_request);
+}
+
+void HTTPSession::_requeue(Request *p_request) {
+
+	if (p_request->file) {
+		// Opened again, and so truncated, when the new response arrives
+		memdelete(p_request->file);
+		p_request->file = NULL;
+	}
+
+	p_request->response_code = 0;
+	p_request->response_headers.resize(0);
+	p_request->response_body.resize(0);
+	p_request->received = 0;
+
+	p_request->host->queue.push_front(p_request);
+}
+
+void HTTPSession::_emit_done() {
+
+	// Callbacks may add or cancel requests, so the list is consumed as it goes
+	while (done.size()) {
+
+		Request *r = done.front()->get();
+		done.pop_front();
+
+		if (r->done_func) {
+			r->done_func(r->userdata, r->id, r->result, r->response_code);
+		}
+		emit_signal("request_completed", r->id, r->result, r->response_code, r->response_headers, r->response_body);
+
+		memdelete(r);
+	}
+}
+
+void HTTPSession::_dispatch(Host *p_host) {
+
+	// Idle and pipelining connections are used first, new ones are only
+	// opened while the queue is longer than what the open ones can take.
+	int capacity = 0;
+	int open = 0;
+	for (int i = 0; i < p_host->connections.size(); i++) {
+
+		Connection *c = p_host->connections[i];
+		if (c->closed)
+			continue;
+
+		int depth = (c->client->is_pipelining_enabled() && c->served > 0) ? pipeline_depth : 1;
+		capacity += MAX(depth - c->in_flight.size(), 0);
+		open++;
+	}
+
+	while (p_host->queue.size() > capacity && open < max_connections_per_host) {
+
+		_open_connection(p_host);
+		capacity++;
+		open++;
+	}
+}
+
+void HTTPSession::_open_connection(Host *p_host) {
+
+	Connection *c = memnew(Connection);
+	c->host = p_host;
+	c->client.instance();
+	c->reading_body = false;
+	c->closed = false;
+	c->served = 0;
+	c->idle_since = 0;
+	c->poll_type = NetworkPollGroup::POLL_TYPE_IN_OUT;
+	p_host->connections.push_back(c);
+
+#ifndef JAVASCRIPT_ENABLED
+	c->client->set_pipelining_enabled(pipeline_depth > 1);
+	poll_group->add(c->client.ptr(), c->poll_type);
+#endif
+
+	// Failures show up in the client status, handled by _process()
+	c->client->connect_to_host(p_host->name, p_host->port, p_host->ssl, verify_host);
+}
+
+void HTTPSession::_close_connection(Connection *p_conn, Result p_result, bool p_server_closed) {
+
+	if (p_conn->closed)
+		return;
+
+	p_conn->closed = true;
+	p_conn->client->close();
+
+	Host *host = p_conn->host;
+
+	// Requests sent on this connection and not answered go back to the front
+	// of the queue, in order. They are sent again without counting as a retry
+	// if the server announced the close, otherwise only if sending them twice
+	// is harmless and, for the first one, if the connection had worked before
+	// (servers drop idle keep-alive connections without notice).
+	for (List<Request *>::Element *E = p_conn->in_flight.back(); E; E = E->prev()) {
+
+		Request *r = E->get();
+		bool delivered = r->body_func && r->received > 0; // Can't take back what a function got
+		bool first = E == p_conn->in_flight.front();
+		bool retry = !delivered && (p_server_closed || (_is_idempotent(r->method) && r->retries < max_retries && (p_conn->served > 0 || !first)));
+
+		if (retry) {
+			if (!p_server_closed)
+				r->retries++;
+			_requeue(r);
+		} else {
+			_finish(r, p_result);
+		}
+	}
+
+	p_conn->in_flight.clear();
+	p_conn->reading_body = false;
+
+	if (p_result == RESULT_CANT_CONNECT || p_result == RESULT_CANT_RESOLVE || p_result == RESULT_SSL_HANDSHAKE_ERROR) {
+
+		// The host can't be reached, unless another connection got through
+		for (int i = 0; i < host->connections.size(); i++) {
+			if (!host->connections[i]->closed)
+				return;
+		}
+
+		while (host->queue.size()) {
+			Request *r = host->queue.front()->get();
+			host->queue.pop_front();
+			_finish(r, p_result);
+		}
+	}
+}
+
+void HTTPSession::_set_poll_type(Connection *p_conn, NetworkPollGroup::PollType p_type) {
+
+#ifndef JAVASCRIPT_ENABLED
+	if (p_conn->poll_type == p_type)
+		return;
+
+	poll_group->remove(p_conn->client.ptr());
+	poll_group->add(p_conn->client.ptr(), p_type);
+	p_conn->poll_type = p_type;
+#endif
+}
+
+HTTPSession::Result HTTPSession::_begin_body(Request *p_request, int p_length) {
+
+	if (body_size_limit >= 0 && p_length > body_size_limit)
+		return RESULT_BODY_SIZE_LIMIT_EXCEEDED;
+
+	if (p_request->download_file != String()) {
+
+		p_request->file = FileAccess::open(p_request->download_file, FileAccess::WRITE);
+		if (!p_request->file)
+			return RESULT_DOWNLOAD_FILE_CANT_OPEN;
+
+	} else if (!p_request->body_func && p_length > 0) {
+
+		// Known size, so the body is read into place in one go
+		p_request->response_body.resize(p_length);
+	}
+
+	return RESULT_SUCCESS;
+}
+
+HTTPSession::Result HTTPSession::_read_body(Connection *p_conn, Request *p_request, Error &r_error) {
+
+	HTTPClient *client = p_conn->client.ptr();
+	r_error = OK;
+
+	while (client->get_status() == HTTPClient::STATUS_BODY) {
+
+		int received = 0;
+
+		if (p_request->file || p_request->body_func) {
+
+			r_error = client->read_response_body(read_buffer.ptrw(), read_buffer.size(), received);
+
+			if (received > 0) {
+				if (p_request->file) {
+					p_request->file->store_buffer(read_buffer.ptr(), received);
+					if (p_request->file->get_error() != OK)
+						return RESULT_DOWNLOAD_FILE_WRITE_ERROR;
+				} else if (p_request->body_func(p_request->userdata, p_request->id, read_buffer.ptr(), received) != OK) {
+					return RESULT_BODY_FUNC_ERROR;
+				}
+			}
+
+		} else {
+
+			if (p_request->received == p_request->response_body.size()) {
+				// Size not known up front (or an empty body), grow as needed
+				p_request->response_body.resize(MAX(p_request->response_body.size() * 2, (int)READ_BUFFER_SIZE));
+			}
+
+			PoolByteArray::Write w = p_request->response_body.write();
+			r_error = client->read_response_body(w.ptr() + p_request->received, p_request->response_body.size() - p_request->received, received);
+		}
+
+		p_request->received += received;
+
+		if (body_size_limit >= 0 && p_request->received > body_size_limit)
+			return RESULT_BODY_SIZE_LIMIT_EXCEEDED;
+
+		if (r_error != OK || received == 0)
+			break;
+	}
+
+	return RESULT_SUCCESS;
+}
+
+bool HTTPSession::_process(Connection *p_conn, uint64_t p_now) {
+
+	HTTPClient *client = p_conn->client.ptr();
+	Host *host = p_conn->host;
+	bool progress = false;
+
+	while (!p_conn->closed) {
+
+		HTTPClient::Status status = client->get_status();
+
+		switch (status) {
+
+			case HTTPClient::STATUS_RESOLVING:
+			case HTTPClient::STATUS_CONNECTING: {
+
+				client->poll();
+				if (client->get_status() == status)
+					return progress; // Must wait
+
+				progress = true;
+				continue;
+			} break;
+			case HTTPClient::STATUS_CANT_RESOLVE: {
+
+				_close_connection(p_conn, RESULT_CANT_RESOLVE, false);
+				return true;
+			} break;
+			case HTTPClient::STATUS_CANT_CONNECT: {
+
+				_close_connection(p_conn, RESULT_CANT_CONNECT, false);
+				return true;
+			} break;
+			case HTTPClient::STATUS_SSL_HANDSHAKE_ERROR: {
+
+				_close_connection(p_conn, RESULT_SSL_HANDSHAKE_ERROR, false);
+				return true;
+			} break;
+			case HTTPClient::STATUS_DISCONNECTED:
+			case HTTPClient::STATUS_CONNECTION_ERROR: {
+
+				// Disconnected before ever getting to send anything means connecting failed
+				bool never_used = p_conn->served == 0 && p_conn->in_flight.empty();
+				_close_connection(p_conn, never_used ? RESULT_CANT_CONNECT : RESULT_CONNECTION_ERROR, false);
+				return true;
+			} break;
+			default: {
+			}
+		}
+
+		// Keep the pipeline full, once the server has shown it keeps connections alive
+		int depth = (client->is_pipelining_enabled() && p_conn->served > 0) ? pipeline_depth : 1;
+		while (p_conn->in_flight.size() < depth && host->queue.size()) {
+
+			Request *r = host->queue.front()->get();
+			if (client->request_raw(r->method, r->path, r->headers, r->body) != OK)
+				break; // Connection went down, the request stays queued
+
+			host->queue.pop_front();
+			p_conn->in_flight.push_back(r);
+			p_conn->idle_since = 0;
+			progress = true;
+		}
+
+		status = client->get_status();
+		if (status == HTTPClient::STATUS_CONNECTION_ERROR || status == HTTPClient::STATUS_DISCONNECTED)
+			continue;
+
+		if (p_conn->in_flight.empty()) {
+
+			// Idle, kept for the next request to this host for a while
+			if (p_conn->idle_since == 0) {
+				p_conn->idle_since = p_now;
+			} else if (p_now - p_conn->idle_since > (uint64_t)keep_alive_timeout) {
+				_close_connection(p_conn, RESULT_SUCCESS, true);
+			}
+			return progress;
+		}
+
+		Request *r = p_conn->in_flight.front()->get();
+
+		if (!p_conn->reading_body) {
+
+			if (status == HTTPClient::STATUS_REQUESTING) {
+
+				client->poll();
+				status = client->get_status();
+				if (status == HTTPClient::STATUS_REQUESTING && !client->has_response())
+					return progress; // Waiting for the response
+
+				if (status != HTTPClient::STATUS_REQUESTING && status != HTTPClient::STATUS_BODY && status != HTTPClient::STATUS_CONNECTED)
+					continue; // Failed, handled above
+			}
+
+			progress = true;
+			r->response_code = client->get_response_code();
+
+			List<String> headers;
+			if (client->get_response_headers(&headers) == OK) {
+				for (List<String>::Element *E = headers.front(); E; E = E->next()) {
+					r->response_headers.push_back(E->get());
+				}
+			}
+
+			if (status == HTTPClient::STATUS_BODY) {
+
+				Result res = _begin_body(r, client->get_response_body_length());
+				if (res != RESULT_SUCCESS) {
+					p_conn->in_flight.pop_front();
+					_finish(r, res);
+					_close_connection(p_conn, res, true); // The body is still on the way
+					return true;
+				}
+				p_conn->reading_body = true;
+
+			} else {
+
+				p_conn->in_flight.pop_front();
+				p_conn->served++;
+				_finish(r, RESULT_SUCCESS);
+
+				if (!client->is_response_keep_alive()) {
+					_close_connection(p_conn, RESULT_CONNECTION_ERROR, true);
+					return true;
+				}
+				continue;
+			}
+		}
+
+		int received = r->received;
+		Error err;
+		Result res = _read_body(p_conn, r, err);
+		if (res != RESULT_SUCCESS) {
+			p_conn->in_flight.pop_front();
+			_finish(r, res);
+			_close_connection(p_conn, res, true);
+			return true;
+		}
+
+		if (r->received != received)
+			progress = true;
+
+		status = client->get_status();
+		if (status == HTTPClient::STATUS_BODY)
+			return progress; // Waiting for more of the body
+		if (err != OK)
+			continue; // Connection dropped, handled above
+
+		// Body complete
+		p_conn->reading_body = false;
+		p_conn->in_flight.pop_front();
+		p_conn->served++;
+		if (!r->file && !r->body_func) {
+			r->response_body.resize(r->received);
+		}
+
+		bool keep_alive = status != HTTPClient::STATUS_DISCONNECTED && client->is_response_keep_alive();
+		_finish(r, RESULT_SUCCESS);
+		progress = true;
+
+		if (!keep_alive) {
+			_close_connection(p_conn, RESULT_CONNECTION_ERROR, true);
+			return true;
+		}
+	}
+
+	return progress;
+}
+
+bool HTTPSession::_process_hosts(bool &r_resolving) {
+
+	uint64_t now = OS::get_singleton()->get_ticks_msec();
+	bool progress = false;
+	r_resolving = false;
+
+	for (Map<String, Host *>::Element *E = hosts.front(); E;) {
+
+		Host *host = E->get();
+		Map<String, Host *>::Element *N = E->next();
+
+		_dispatch(host);
+
+		for (int i = 0; i < host->connections.size(); i++) {
+			if (_process(host->connections[i], now))
+				progress = true;
+		}
+
+		for (int i = host->connections.size() - 1; i >= 0; i--) {
+
+			Connection *c = host->connections[i];
+			if (!c->closed)
+				continue;
+
+#ifndef JAVASCRIPT_ENABLED
+			poll_group->remove(c->client.ptr());
+#endif
+			host->connections.remove(i);
+			memdelete(c);
+		}
+
+		if (host->queue.empty() && host->connections.empty()) {
+			hosts.erase(E);
+			memdelete(host);
+			E = N;
+			continue;
+		}
+
+		// Requests put back by dropped connections get new ones right away
+		_dispatch(host);
+
+		for (int i = 0; i < host->connections.size(); i++) {
+
+			// Connecting needs to know when the socket becomes writable, the rest when there is something to read
+			Connection *c = host->connections[i];
+			HTTPClient::Status status = c->client->get_status();
+			r_resolving = r_resolving || status == HTTPClient::STATUS_RESOLVING;
+			_set_poll_type(c, status == HTTPClient::STATUS_CONNECTING ? NetworkPollGroup::POLL_TYPE_IN_OUT : NetworkPollGroup::POLL_TYPE_IN);
+		}
+
+		E = N;
+	}
+
+	return progress;
+}
+
+int HTTPSession::request(const String &p_url, const Vector<String> &p_headers, HTTPClient::Method p_method, const PoolVector<uint8_t> &p_body) {
+
+	return _add_request(p_url, p_method, p_headers, p_body);
+}
+
+int HTTPSession::request_to_file(const String &p_url, const String &p_path, const Vector<String> &p_headers) {
+
+	ERR_FAIL_COND_V(p_path == String(), -1);
+
+	int id = _add_request(p_url, HTTPClient::METHOD_GET, p_headers, PoolVector<uint8_t>());
+	if (id != -1) {
+		requests[id]->download_file = p_path;
+	}
+	return id;
+}
+
+int HTTPSession::request_to_func(const String &p_url, BodyFunc p_body_func, DoneFunc p_done_func, void *p_userdata, const Vector<String> &p_headers) {
+
+	ERR_FAIL_NULL_V(p_body_func, -1);
+
+	int id = _add_request(p_url, HTTPClient::METHOD_GET, p_headers, PoolVector<uint8_t>());
+	if (id != -1) {
+		Request *r = requests[id];
+		r->body_func = p_body_func;
+		r->done_func = p_done_func;
+		r->userdata = p_userdata;
+	}
+	return id;
+}
+
+void HTTPSession::cancel_request(int p_request) {
+
+	Map<int, Request *>::Element *E = requests.find(p_request);
+	ERR_FAIL_COND(!E);
+
+	Request *r = E->get();
+	Host *host = r->host;
+
+	List<Request *>::Element *Q = host->queue.find(r);
+	if (Q) {
+		host->queue.erase(Q);
+		_finish(r, RESULT_CANCELLED);
+		return;
+	}
+
+	for (int i = 0; i < host->connections.size(); i++) {
+
+		Connection *c = host->connections[i];
+		Q = c->in_flight.find(r);
+		if (!Q)
+			continue;
+
+		// The response is already on its way, so the connection can't be used any more
+		c->in_flight.erase(Q);
+		_finish(r, RESULT_CANCELLED);
+		_close_connection(c, RESULT_CANCELLED, true);
+		return;
+	}
+}
+
+void HTTPSession::close() {
+
+	for (Map<String, Host *>::Element *E = hosts.front(); E; E = E->next()) {
+
+		Host *host = E->get();
+
+		for (int i = 0; i < host->connections.size(); i++) {
+
+			Connection *c = host->connections[i];
+			for (List<Request *>::Element *F = c->in_flight.front(); F; F = F->next()) {
+				_finish(F->get(), RESULT_CANCELLED);
+			}
+			c->in_flight.clear();
+			c->client->close();
+#ifndef JAVASCRIPT_ENABLED
+			poll_group->remove(c->client.ptr());
+#endif
+			memdelete(c);
+		}
+
+		while (host->queue.size()) {
+			Request *r = host->queue.front()->get();
+			host->queue.pop_front();
+			_finish(r, RESULT_CANCELLED);
+		}
+
+		memdelete(host);
+	}
+
+	hosts.clear();
+}
+
+Error HTTPSession::poll(int p_timeout_msec) {
+
+	bool resolving = false;
+	bool progress = _process_hosts(resolving);
+
+#ifndef JAVASCRIPT_ENABLED
+	if (!progress && p_timeout_msec != 0 && requests.size() && done.empty()) {
+
+		if (resolving) {
+			// Name resolution happens in another thread, with no socket to wait on
+			OS::get_singleton()->delay_usec(1000);
+		} else {
+
+			Array ready = poll_group->poll(p_timeout_msec);
+
+			// Idle connections only become readable when the server closes them
+			for (int i = 0; i < ready.size(); i++) {
+
+				HTTPClient *client = Object::cast_to<HTTPClient>(ready[i]);
+				for (Map<String, Host *>::Element *E = hosts.front(); E && client; E = E->next()) {
+					for (int j = 0; j < E->get()->connections.size(); j++) {
+						Connection *c = E->get()->connections[j];
+						if (c->client.ptr() == client && c->in_flight.empty()) {
+							_close_connection(c, RESULT_SUCCESS, true);
+						}
+					}
+				}
+			}
+		}
+
+		_process_hosts(resolving);
+	}
+#endif
+
+	_emit_done();
+
+	return OK;
+}
+
+int HTTPSession::get_pending_request_count() const {
+
+	return requests.size();
+}
+
+int HTTPSession::get_connection_count() const {
+
+	int count = 0;
+	for (const Map<String, Host *>::Element *E = hosts.front(); E; E = E->next()) {
+		for (int i = 0; i < E->get()->connections.size(); i++) {
+			if (!E->get()->connections[i]->closed)
+				count++;
+		}
+	}
+	return count;
+}
+
+void HTTPSession::set_max_connections_per_host(int p_max) {
+
+	ERR_FAIL_COND(p_max < 1);
+	max_connections_per_host = p_max;
+}
+
+int HTTPSession::get_max_connections_per_host() const {
+
+	return max_connections_per_host;
+}
+
+void HTTPSession::set_pipeline_depth(int p_depth) {
+
+	ERR_FAIL_COND(p_depth < 1);
+#ifdef JAVASCRIPT_ENABLED
+	ERR_EXPLAIN("HTTP pipelining is not supported for the HTML5 platform");
+	ERR_FAIL_COND(p_depth > 1);
+#endif
+	pipeline_depth = p_depth;
+}
+
+int HTTPSession::get_pipeline_depth() const {
+
+	return pipeline_depth;
+}
+
+void HTTPSession::set_keep_alive_timeout(int p_msec) {
+
+	ERR_FAIL_COND(p_msec < 0);
+	keep_alive_timeout = p_msec;
+}
+
+int HTTPSession::get_keep_alive_timeout() const {
+
+	return keep_alive_timeout;
+}
+
+void HTTPSession::set_max_retries(int p_max) {
+
+	ERR_FAIL_COND(p_max < 0);
+	max_retries = p_max;
+}
+
+int HTTPSession::get_max_retries() const {
+
+	return max_retries;
+}
+
+void HTTPSession::set_body_size_limit(int p_bytes) {
+
+	body_size_limit = p_bytes;
+}
+
+int HTTPSession::get_body_size_limit() const {
+
+	return body_size_limit;
+}
+
+void HTTPSession::set_verify_host(bool p_enable) {
+
+	verify_host = p_enable;
+}
+
+bool HTTPSession::is_verifying_host() const {
+
+	return verify_host;
+}
+
+void HTTPSession::_bind_methods() {
+
+	ClassDB::bind_method(D_METHOD("request", "url", "headers", "method", "body"), &HTTPSession::request, DEFVAL(PoolStringArray()), DEFVAL(HTTPClient::METHOD_GET), DEFVAL(PoolByteArray()));
+	ClassDB::bind_method(D_METHOD("request_to_file", "url", "path", "headers"), &HTTPSession::request_to_file, DEFVAL(PoolStringArray()));
+	ClassDB::bind_method(D_METHOD("cancel_request", "request"), &HTTPSession::cancel_request);
+	ClassDB::bind_method(D_METHOD("close"), &HTTPSession::close);
+	ClassDB::bind_method(D_METHOD("poll", "timeout_msec"), &HTTPSession::poll, DEFVAL(0));
+
+	ClassDB::bind_method(D_METHOD("get_pending_request_count"), &HTTPSession::get_pending_request_count);
+	ClassDB::bind_method(D_METHOD("get_connection_count"), &HTTPSession::get_connection_count);
+
+	ClassDB::bind_method(D_METHOD("set_max_connections_per_host", "max"), &HTTPSession::set_max_connections_per_host);
+	ClassDB::bind_method(D_METHOD("get_max_connections_per_host"), &HTTPSession::get_max_connections_per_host);
+	ClassDB::bind_method(D_METHOD("set_pipeline_depth", "depth"), &HTTPSession::set_pipeline_depth);
+	ClassDB::bind_method(D_METHOD("get_pipeline_depth"), &HTTPSession::get_pipeline_depth);
+	ClassDB::bind_method(D_METHOD("set_keep_alive_timeout", "msec"), &HTTPSession::set_keep_alive_timeout);
+	ClassDB::bind_method(D_METHOD("get_keep_alive_timeout"), &HTTPSession::get_keep_alive_timeout);
+	ClassDB::bind_method(D_METHOD("set_max_retries", "max"), &HTTPSession::set_max_retries);
+	ClassDB::bind_method(D_METHOD("get_max_retries"), &HTTPSession::get_max_retries);
+	ClassDB::bind_method(D_METHOD("set_body_size_limit", "bytes"), &HTTPSession::set_body_size_limit);
+	ClassDB::bind_method(D_METHOD("get_body_size_limit"), &HTTPSession::get_body_size_limit);
+	ClassDB::bind_method(D_METHOD("set_verify_host", "enable"), &HTTPSession::set_verify_host);
+	ClassDB::bind_method(D_METHOD("is_verifying_host"), &HTTPSession::is_verifying_host);
+
+	ADD_PROPERTY(PropertyInfo(Variant::INT, "max_connections_per_host", PROPERTY_HINT_RANGE, "1,64"), "set_max_connections_per_host", "get_max_connections_per_host");
+	ADD_PROPERTY(PropertyInfo(Variant::INT, "pipeline_depth", PROPERTY_HINT_RANGE, "1,32"), "set_pipeline_depth", "get_pipeline_depth");
+	ADD_PROPERTY(PropertyInfo(Variant::INT, "keep_alive_timeout"), "set_keep_alive_timeout", "get_keep_alive_timeout");
+	ADD_PROPERTY(PropertyInfo(Variant::INT, "max_retries", PROPERTY_HINT_RANGE, "0,8"), "set_max_retries", "get_max_retries");
+	ADD_PROPERTY(PropertyInfo(Variant::INT, "body_size_limit", PROPERTY_HINT_RANGE, "-1,2000000000"), "set_body_size_limit", "get_body_size_limit");
+	ADD_PROPERTY(PropertyInfo(Variant::BOOL, "verify_host"), "set_verify_host", "is_verifying_host");
+
+	ADD_SIGNAL(MethodInfo("request_completed", PropertyInfo(Variant::INT, "request"), PropertyInfo(Variant::INT, "result"), PropertyInfo(Variant::INT, "response_code"), PropertyInfo(Variant::POOL_STRING_ARRAY, "headers"), PropertyInfo(Variant::POOL_BYTE_ARRAY, "body")));
+
+	BIND_ENUM_CONSTANT(RESULT_SUCCESS);
+	BIND_ENUM_CONSTANT(RESULT_CANT_CONNECT);
+	BIND_ENUM_CONSTANT(RESULT_CANT_RESOLVE);
+	BIND_ENUM_CONSTANT(RESULT_CONNECTION_ERROR);
+	BIND_ENUM_CONSTANT(RESULT_SSL_HANDSHAKE_ERROR);
+	BIND_ENUM_CONSTANT(RESULT_BODY_SIZE_LIMIT_EXCEEDED);
+	BIND_ENUM_CONSTANT(RESULT_DOWNLOAD_FILE_CANT_OPEN);
+	BIND_ENUM_CONSTANT(RESULT_DOWNLOAD_FILE_WRITE_ERROR);
+	BIND_ENUM_CONSTANT(RESULT_BODY_FUNC_ERROR);
+	BIND_ENUM_CONSTANT(RESULT_CANCELLED);
+}
+
+HTTPSession::HTTPSession() {
+
+	last_id = 0;
+	max_connections_per_host = 4;
+	pipeline_depth = 1;
+	keep_alive_timeout = 15000;
+	max_retries = 1;
+	body_size_limit = -1;
+	verify_host = true;
+
+	read_buffer.resize(READ_BUFFER_SIZE);
+	poll_group.instance();
+}
+
+HTTPSession::~HTTPSession() {
+
+	close();
+
+	// Nobody left to tell
+	while (done.size()) {
+		memdelete(done.front()->get());
+		done.pop_front();
+	}
+}
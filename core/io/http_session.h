@@ -0,0 +1,184 @@
+/*************************************************************************/
+/*  http_session.h                                                       */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2018 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2018 Godot Engine contributors (cf. AUTHORS.md)    */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+
+#ifndef HTTP_SESSION_H
+#define HTTP_SESSION_H
+
+#include "core/io/http_client.h"
+#include "core/io/network_poll_group.h"
+#include "core/map.h"
+#include "core/os/file_access.h"
+#include "core/reference.h"
+
+class HTTPSession : public Reference {
+
+	GDCLASS(HTTPSession, Reference);
+
+public:
+	enum Result {
+		RESULT_SUCCESS,
+		RESULT_CANT_CONNECT,
+		RESULT_CANT_RESOLVE,
+		RESULT_CONNECTION_ERROR,
+		RESULT_SSL_HANDSHAKE_ERROR,
+		RESULT_BODY_SIZE_LIMIT_EXCEEDED,
+		RESULT_DOWNLOAD_FILE_CANT_OPEN,
+		RESULT_DOWNLOAD_FILE_WRITE_ERROR,
+		RESULT_BODY_FUNC_ERROR,
+		RESULT_CANCELLED
+	};
+
+	// Gets the body as it comes off the connection, returning anything but OK aborts the request
+	typedef Error (*BodyFunc)(void *p_userdata, int p_request, const uint8_t *p_data, int p_bytes);
+	typedef void (*DoneFunc)(void *p_userdata, int p_request, Result p_result, int p_response_code);
+
+private:
+	enum {
+		READ_BUFFER_SIZE = 65536
+	};
+
+	struct Host;
+
+	struct Request {
+
+		int id;
+		Host *host;
+		HTTPClient::Method method;
+		String path;
+		Vector<String> headers;
+		PoolVector<uint8_t> body;
+
+		String download_file;
+		FileAccess *file;
+		BodyFunc body_func;
+		DoneFunc done_func;
+		void *userdata;
+
+		Result result;
+		int response_code;
+		PoolStringArray response_headers;
+		PoolByteArray response_body;
+		int received;
+		int retries;
+	};
+
+	struct Connection {
+
+		Host *host;
+		Ref<HTTPClient> client;
+		List<Request *> in_flight; // Sent, answered in this order
+		bool reading_body;
+		bool closed;
+		int served;
+		uint64_t idle_since;
+		NetworkPollGroup::PollType poll_type;
+	};
+
+	struct Host {
+
+		String key;
+		String name;
+		int port;
+		bool ssl;
+		List<Request *> queue;
+		Vector<Connection *> connections;
+	};
+
+	Map<String, Host *> hosts;
+	Map<int, Request *> requests;
+	List<Request *> done; // Reported by the next poll()
+	int last_id;
+
+	int max_connections_per_host;
+	int pipeline_depth;
+	int keep_alive_timeout;
+	int max_retries;
+	int body_size_limit;
+	bool verify_host;
+
+	Vector<uint8_t> read_buffer; // Bodies going to files pass through here
+	Ref<NetworkPollGroup> poll_group;
+
+	int _add_request(const String &p_url, HTTPClient::Method p_method, const Vector<String> &p_headers, const PoolVector<uint8_t> &p_body);
+	void _finish(Request *p_request, Result p_result);
+	void _requeue(Request *p_request);
+	void _emit_done();
+
+	void _dispatch(Host *p_host);
+	void _open_connection(Host *p_host);
+	void _close_connection(Connection *p_conn, Result p_result, bool p_server_closed);
+	void _set_poll_type(Connection *p_conn, NetworkPollGroup::PollType p_type);
+
+	Result _begin_body(Request *p_request, int p_length);
+	Result _read_body(Connection *p_conn, Request *p_request, Error &r_error);
+	bool _process(Connection *p_conn, uint64_t p_now);
+	bool _process_hosts(bool &r_resolving);
+
+protected:
+	static void _bind_methods();
+
+public:
+	int request(const String &p_url, const Vector<String> &p_headers = Vector<String>(), HTTPClient::Method p_method = HTTPClient::METHOD_GET, const PoolVector<uint8_t> &p_body = PoolVector<uint8_t>());
+	int request_to_file(const String &p_url, const String &p_path, const Vector<String> &p_headers = Vector<String>());
+	int request_to_func(const String &p_url, BodyFunc p_body_func, DoneFunc p_done_func, void *p_userdata, const Vector<String> &p_headers = Vector<String>());
+	void cancel_request(int p_request);
+	void close();
+
+	Error poll(int p_timeout_msec = 0);
+
+	int get_pending_request_count() const;
+	int get_connection_count() const;
+
+	void set_max_connections_per_host(int p_max);
+	int get_max_connections_per_host() const;
+
+	void set_pipeline_depth(int p_depth);
+	int get_pipeline_depth() const;
+
+	void set_keep_alive_timeout(int p_msec);
+	int get_keep_alive_timeout() const;
+
+	void set_max_retries(int p_max);
+	int get_max_retries() const;
+
+	void set_body_size_limit(int p_bytes);
+	int get_body_size_limit() const;
+
+	void set_verify_host(bool p_enable);
+	bool is_verifying_host() const;
+
+	HTTPSession();
+	~HTTPSession();
+};
+
+VARIANT_ENUM_CAST(HTTPSession::Result);
+
+#endif // HTTP_SESSION_H
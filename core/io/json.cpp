@@ -30,448 +30,899 @@
 
 #include "json.h"
 
+#include "core/os/copymem.h"
+#include "core/os/file_access.h"
 #include "core/print_string.h"
 
-const char *JSON::tk_name[TK_MAX] = {
-	"'{'",
-	"'}'",
-	"'['",
-	"']'",
-	"identifier",
-	"string",
-	"number",
-	"':'",
-	"','",
-	"EOF",
+enum {
+	JSON_READ_CHUNK_SIZE = 65536,
+	JSON_WRITE_CHUNK_SIZE = 16384,
+	JSON_MAX_NUMBER_LENGTH = 64
 };
 
-static String _make_indent(const String &p_indent, int p_size) {
+static const char *_json_char_name(int p_char) {
 
-	String indent_text = "";
-	if (!p_indent.empty()) {
-		for (int i = 0; i < p_size; i++)
-			indent_text += p_indent;
+	switch (p_char) {
+		case '{': return "'{'";
+		case '}': return "'}'";
+		case '[': return "'['";
+		case ']': return "']'";
+		case ':': return "':'";
+		case ',': return "','";
+		case 0: return "EOF";
 	}
-	return indent_text;
+	return "character";
 }
 
-String JSON::_print_var(const Variant &p_var, const String &p_indent, int p_cur_indent, bool p_sort_keys) {
+// Recursive descent parser working on UTF-8 bytes, either a buffer in
+// memory or a file read in chunks. A zero byte ends the document, like
+// the end of the data does.
+class JSONParser {
 
-	String colon = ":";
-	String end_statement = "";
+	const uint8_t *data;
+	int pos;
+	int len;
 
-	if (!p_indent.empty()) {
-		colon += " ";
-		end_statement += "\n";
+	FileAccess *file;
+	Vector<uint8_t> chunk;
+
+	// strings that can't be decoded in place (escaped or split between chunks) are gathered here
+	Vector<uint8_t> scratch;
+	int scratch_len;
+
+	JSONHandler *handler;
+
+	bool _refill() {
+
+		if (!file)
+			return false;
+
+		if (chunk.empty())
+			chunk.resize(JSON_READ_CHUNK_SIZE);
+
+		int read = file->get_buffer(chunk.ptrw(), chunk.size());
+		if (read <= 0)
+			return false;
+
+		data = chunk.ptr();
+		pos = 0;
+		len = read;
+		return true;
 	}
 
-	switch (p_var.get_type()) {
+	_FORCE_INLINE_ int _peek() {
 
-		case Variant::NIL: return "null";
-		case Variant::BOOL: return p_var.operator bool() ? "true" : "false";
-		case Variant::INT: return itos(p_var);
-		case Variant::REAL: return rtos(p_var);
-		case Variant::POOL_INT_ARRAY:
-		case Variant::POOL_REAL_ARRAY:
-		case Variant::POOL_STRING_ARRAY:
-		case Variant::ARRAY: {
+		if (pos == len && !_refill())
+			return 0;
+		return data[pos];
+	}
 
-			String s = "[";
-			s += end_statement;
-			Array a = p_var;
-			for (int i = 0; i < a.size(); i++) {
-				if (i > 0) {
-					s += ",";
-					s += end_statement;
-				}
-				s += _make_indent(p_indent, p_cur_indent + 1) + _print_var(a[i], p_indent, p_cur_indent + 1, p_sort_keys);
-			}
-			s += end_statement + _make_indent(p_indent, p_cur_indent) + "]";
-			return s;
-		};
-		case Variant::DICTIONARY: {
+	_FORCE_INLINE_ int _get() {
 
-			String s = "{";
-			s += end_statement;
-			Dictionary d = p_var;
-			List<Variant> keys;
-			d.get_key_list(&keys);
+		int c = _peek();
+		if (c)
+			pos++;
+		return c;
+	}
 
-			if (p_sort_keys)
-				keys.sort();
+	int _skip_space() {
 
-			for (List<Variant>::Element *E = keys.front(); E; E = E->next()) {
+		int c = _peek();
+		while (c != 0 && c <= 32) {
+			if (c == '\n')
+				line++;
+			pos++;
+			c = _peek();
+		}
+		return c;
+	}
 
-				if (E != keys.front()) {
-					s += ",";
-					s += end_statement;
-				}
-				s += _make_indent(p_indent, p_cur_indent + 1) + _print_var(String(E->get()), p_indent, p_cur_indent + 1, p_sort_keys);
-				s += colon;
-				s += _print_var(d[E->get()], p_indent, p_cur_indent + 1, p_sort_keys);
-			}
+	void _append(const uint8_t *p_bytes, int p_count) {
 
-			s += end_statement + _make_indent(p_indent, p_cur_indent) + "}";
-			return s;
-		};
-		default: return "\"" + String(p_var).json_escape() + "\"";
+		if (p_count == 0)
+			return;
+		if (scratch_len + p_count > scratch.size()) {
+			scratch.resize(MAX(scratch_len + p_count, scratch.size() * 2));
+		}
+		copymem(&scratch.ptrw()[scratch_len], p_bytes, p_count);
+		scratch_len += p_count;
 	}
-}
 
-String JSON::print(const Variant &p_var, const String &p_indent, bool p_sort_keys) {
+	void _append_utf8(uint32_t p_char) {
+
+		uint8_t bytes[4];
+		int count;
+		if (p_char <= 0x7f) {
+			bytes[0] = p_char;
+			count = 1;
+		} else if (p_char <= 0x7ff) {
+			bytes[0] = 0xc0 | ((p_char >> 6) & 0x1f);
+			bytes[1] = 0x80 | (p_char & 0x3f);
+			count = 2;
+		} else {
+			bytes[0] = 0xe0 | ((p_char >> 12) & 0x0f);
+			bytes[1] = 0x80 | ((p_char >> 6) & 0x3f);
+			bytes[2] = 0x80 | (p_char & 0x3f);
+			count = 3;
+		}
+		_append(bytes, count);
+	}
 
-	return _print_var(p_var, p_indent, 0, p_sort_keys);
-}
+	Error _parse_string(String &r_str);
+	Error _parse_number(double &r_number);
+	Error _parse_value(int p_char);
+	Error _parse_array();
+	Error _parse_object();
 
-Error JSON::_get_token(const CharType *p_str, int &index, int p_len, Token &r_token, int &line, String &r_err_str) {
+public:
+	int line;
+	String err_str;
 
-	while (p_len > 0) {
-		switch (p_str[index]) {
+	Error parse();
 
-			case '\n': {
+	JSONParser(const uint8_t *p_data, int p_len, FileAccess *p_file, JSONHandler *p_handler) {
 
-				line++;
-				index++;
-				break;
-			};
-			case 0: {
-				r_token.type = TK_EOF;
-				return OK;
-			} break;
-			case '{': {
-
-				r_token.type = TK_CURLY_BRACKET_OPEN;
-				index++;
-				return OK;
-			};
-			case '}': {
-
-				r_token.type = TK_CURLY_BRACKET_CLOSE;
-				index++;
-				return OK;
-			};
-			case '[': {
-
-				r_token.type = TK_BRACKET_OPEN;
-				index++;
-				return OK;
-			};
-			case ']': {
-
-				r_token.type = TK_BRACKET_CLOSE;
-				index++;
-				return OK;
-			};
-			case ':': {
-
-				r_token.type = TK_COLON;
-				index++;
-				return OK;
-			};
-			case ',': {
-
-				r_token.type = TK_COMMA;
-				index++;
-				return OK;
-			};
-			case '"': {
-
-				index++;
-				String str;
-				while (true) {
-					if (p_str[index] == 0) {
-						r_err_str = "Unterminated String";
-						return ERR_PARSE_ERROR;
-					} else if (p_str[index] == '"') {
-						index++;
-						break;
-					} else if (p_str[index] == '\\') {
-						//escaped characters...
-						index++;
-						CharType next = p_str[index];
-						if (next == 0) {
-							r_err_str = "Unterminated String";
+		data = p_data;
+		pos = 0;
+		len = p_data ? p_len : 0;
+		file = p_file;
+		scratch_len = 0;
+		handler = p_handler;
+		line = 0;
+	}
+};
+
+Error JSONParser::_parse_string(String &r_str) {
+
+	// the opening quote was consumed already
+
+	scratch_len = 0;
+	bool copied = false;
+	bool split = false; // r_str already holds the part before an escaped NUL
+	int start = pos;
+
+	while (true) {
+
+		if (pos == len) {
+			// the string continues in the next chunk
+			_append(&data[start], pos - start);
+			copied = true;
+			if (!_refill()) {
+				err_str = "Unterminated String";
+				return ERR_PARSE_ERROR;
+			}
+			start = pos;
+		}
+
+		uint8_t c = data[pos];
+
+		if (c == '"') {
+			break;
+		} else if (c == 0) {
+			err_str = "Unterminated String";
+			return ERR_PARSE_ERROR;
+		} else if (c == '\\') {
+			//escaped characters...
+			_append(&data[start], pos - start);
+			copied = true;
+			pos++;
+
+			int next = _get();
+			if (next == 0) {
+				err_str = "Unterminated String";
+				return ERR_PARSE_ERROR;
+			}
+
+			switch (next) {
+
+				case 'b': _append_utf8(8); break;
+				case 't': _append_utf8(9); break;
+				case 'n': _append_utf8(10); break;
+				case 'f': _append_utf8(12); break;
+				case 'r': _append_utf8(13); break;
+				case 'u': {
+					//hexnumbarh - oct is deprecated
+
+					uint32_t res = 0;
+					for (int j = 0; j < 4; j++) {
+						int h = _get();
+						if (h == 0) {
+							err_str = "Unterminated String";
 							return ERR_PARSE_ERROR;
 						}
-						CharType res = 0;
-
-						switch (next) {
-
-							case 'b': res = 8; break;
-							case 't': res = 9; break;
-							case 'n': res = 10; break;
-							case 'f': res = 12; break;
-							case 'r': res = 13; break;
-							case 'u': {
-								//hexnumbarh - oct is deprecated
-
-								for (int j = 0; j < 4; j++) {
-									CharType c = p_str[index + j + 1];
-									if (c == 0) {
-										r_err_str = "Unterminated String";
-										return ERR_PARSE_ERROR;
-									}
-									if (!((c >= '0' && c <= '9') || (c >= 'a' && c <= 'f') || (c >= 'A' && c <= 'F'))) {
-
-										r_err_str = "Malformed hex constant in string";
-										return ERR_PARSE_ERROR;
-									}
-									CharType v;
-									if (c >= '0' && c <= '9') {
-										v = c - '0';
-									} else if (c >= 'a' && c <= 'f') {
-										v = c - 'a';
-										v += 10;
-									} else if (c >= 'A' && c <= 'F') {
-										v = c - 'A';
-										v += 10;
-									} else {
-										ERR_PRINT("BUG");
-										v = 0;
-									}
-
-									res <<= 4;
-									res |= v;
-								}
-								index += 4; //will add at the end anyway
-
-							} break;
-							//case '\"': res='\"'; break;
-							//case '\\': res='\\'; break;
-							//case '/': res='/'; break;
-							default: {
-								res = next;
-								//r_err_str="Invalid escape sequence";
-								//return ERR_PARSE_ERROR;
-							} break;
+
+						uint32_t v;
+						if (h >= '0' && h <= '9') {
+							v = h - '0';
+						} else if (h >= 'a' && h <= 'f') {
+							v = h - 'a' + 10;
+						} else if (h >= 'A' && h <= 'F') {
+							v = h - 'A' + 10;
+						} else {
+							err_str = "Malformed hex constant in string";
+							return ERR_PARSE_ERROR;
 						}
 
-						str += res;
+						res = (res << 4) | v;
+					}
 
+					if (res == 0) {
+						// parse_utf8 stops at a NUL byte, so decode what came before and add it as a character
+						String part;
+						if (part.parse_utf8((const char *)scratch.ptr(), scratch_len)) {
+							err_str = "Invalid UTF-8 in string";
+							return ERR_PARSE_ERROR;
+						}
+						if (!split) {
+							r_str = String();
+							split = true;
+						}
+						r_str += part;
+						r_str += CharType(0);
+						scratch_len = 0;
 					} else {
-						if (p_str[index] == '\n')
-							line++;
-						str += p_str[index];
+						_append_utf8(res);
 					}
-					index++;
-				}
 
-				r_token.type = TK_STRING;
-				r_token.value = str;
-				return OK;
+				} break;
+				default: {
+					// quotes, slashes and anything else stand for themselves
+					uint8_t b = next;
+					_append(&b, 1);
+				} break;
+			}
 
-			} break;
-			default: {
+			start = pos;
+			continue;
+		} else if (c == '\n') {
+			line++;
+		}
 
-				if (p_str[index] <= 32) {
-					index++;
-					break;
-				}
+		pos++;
+	}
 
-				if (p_str[index] == '-' || (p_str[index] >= '0' && p_str[index] <= '9')) {
-					//a number
-					const CharType *rptr;
-					double number = String::to_double(&p_str[index], &rptr);
-					index += (rptr - &p_str[index]);
-					r_token.type = TK_NUMBER;
-					r_token.value = number;
-					return OK;
+	bool invalid;
+	if (split) {
+		_append(&data[start], pos - start);
+		String part;
+		invalid = part.parse_utf8((const char *)scratch.ptr(), scratch_len);
+		r_str += part;
+	} else if (copied) {
+		_append(&data[start], pos - start);
+		invalid = r_str.parse_utf8((const char *)scratch.ptr(), scratch_len);
+	} else {
+		invalid = r_str.parse_utf8((const char *)&data[start], pos - start);
+	}
 
-				} else if ((p_str[index] >= 'A' && p_str[index] <= 'Z') || (p_str[index] >= 'a' && p_str[index] <= 'z')) {
+	pos++; //closing quote
 
-					String id;
+	if (invalid) {
+		err_str = "Invalid UTF-8 in string";
+		return ERR_PARSE_ERROR;
+	}
 
-					while ((p_str[index] >= 'A' && p_str[index] <= 'Z') || (p_str[index] >= 'a' && p_str[index] <= 'z')) {
+	return OK;
+}
 
-						id += p_str[index];
-						index++;
-					}
+Error JSONParser::_parse_number(double &r_number) {
 
-					r_token.type = TK_IDENTIFIER;
-					r_token.value = id;
-					return OK;
-				} else {
-					r_err_str = "Unexpected character.";
-					return ERR_PARSE_ERROR;
-				}
-			}
+	char buffer[JSON_MAX_NUMBER_LENGTH + 1];
+	int count = 0;
+
+#define PUSH_CHAR(m_c)                           \
+	if (count < JSON_MAX_NUMBER_LENGTH)          \
+		buffer[count++] = m_c;                   \
+	pos++;                                       \
+	c = _peek();
+
+	bool negative = false;
+	bool integer = true;
+	uint64_t value = 0;
+	int digits = 0;
+
+	int c = _peek();
+	if (c == '-') {
+		negative = true;
+		PUSH_CHAR(c);
+	}
+
+	while (c >= '0' && c <= '9') {
+		value = value * 10 + (c - '0');
+		digits++;
+		PUSH_CHAR(c);
+	}
+
+	if (c == '.') {
+		integer = false;
+		PUSH_CHAR(c);
+		while (c >= '0' && c <= '9') {
+			PUSH_CHAR(c);
 		}
 	}
 
-	return ERR_PARSE_ERROR;
+	if (c == 'e' || c == 'E') {
+		integer = false;
+		PUSH_CHAR(c);
+		if (c == '+' || c == '-') {
+			PUSH_CHAR(c);
+		}
+		while (c >= '0' && c <= '9') {
+			PUSH_CHAR(c);
+		}
+	}
+
+#undef PUSH_CHAR
+
+	if (integer && digits <= 15) {
+		// exact as a double, no need to go through strtod
+		r_number = negative ? -double(value) : double(value);
+	} else {
+		buffer[count] = 0;
+		r_number = String::to_double(buffer);
+	}
+
+	return OK;
 }
 
-Error JSON::_parse_value(Variant &value, Token &token, const CharType *p_str, int &index, int p_len, int &line, String &r_err_str) {
+Error JSONParser::_parse_value(int p_char) {
 
-	if (token.type == TK_CURLY_BRACKET_OPEN) {
+	switch (p_char) {
 
-		Dictionary d;
-		Error err = _parse_object(d, p_str, index, p_len, line, r_err_str);
-		if (err)
-			return err;
-		value = d;
-		return OK;
-	} else if (token.type == TK_BRACKET_OPEN) {
+		case '{': {
+			pos++;
+			return _parse_object();
+		}
+		case '[': {
+			pos++;
+			return _parse_array();
+		}
+		case '"': {
+			pos++;
+			String str;
+			Error err = _parse_string(str);
+			if (err)
+				return err;
+			return handler->value(str);
+		}
+		case '}':
+		case ']':
+		case ':':
+		case ',':
+		case 0: {
+			err_str = "Expected value, got " + String(_json_char_name(p_char)) + ".";
+			return ERR_PARSE_ERROR;
+		}
+	}
+
+	if (p_char == '-' || (p_char >= '0' && p_char <= '9')) {
 
-		Array a;
-		Error err = _parse_array(a, p_str, index, p_len, line, r_err_str);
+		double number;
+		Error err = _parse_number(number);
 		if (err)
 			return err;
-		value = a;
-		return OK;
+		return handler->value(number);
 
-	} else if (token.type == TK_IDENTIFIER) {
-
-		String id = token.value;
-		if (id == "true")
-			value = true;
-		else if (id == "false")
-			value = false;
-		else if (id == "null")
-			value = Variant();
-		else {
-			r_err_str = "Expected 'true','false' or 'null', got '" + id + "'.";
-			return ERR_PARSE_ERROR;
-		}
-		return OK;
+	} else if ((p_char >= 'A' && p_char <= 'Z') || (p_char >= 'a' && p_char <= 'z')) {
 
-	} else if (token.type == TK_NUMBER) {
+		char id[32];
+		int count = 0;
 
-		value = token.value;
-		return OK;
-	} else if (token.type == TK_STRING) {
+		int c = p_char;
+		while ((c >= 'A' && c <= 'Z') || (c >= 'a' && c <= 'z')) {
+			if (count < 31)
+				id[count++] = c;
+			pos++;
+			c = _peek();
+		}
+		id[count] = 0;
 
-		value = token.value;
-		return OK;
-	} else {
-		r_err_str = "Expected value, got " + String(tk_name[token.type]) + ".";
+		if (strcmp(id, "true") == 0)
+			return handler->value(true);
+		if (strcmp(id, "false") == 0)
+			return handler->value(false);
+		if (strcmp(id, "null") == 0)
+			return handler->value(Variant());
+
+		err_str = "Expected 'true','false' or 'null', got '" + String(id) + "'.";
 		return ERR_PARSE_ERROR;
 	}
 
+	err_str = "Unexpected character.";
 	return ERR_PARSE_ERROR;
 }
 
-Error JSON::_parse_array(Array &array, const CharType *p_str, int &index, int p_len, int &line, String &r_err_str) {
+Error JSONParser::_parse_array() {
+
+	Error err = handler->begin_array();
+	if (err)
+		return err;
 
-	Token token;
 	bool need_comma = false;
 
-	while (index < p_len) {
+	while (true) {
+
+		int c = _skip_space();
+
+		if (c == ']') {
+			pos++;
+			return handler->end_array();
+		}
 
-		Error err = _get_token(p_str, index, p_len, token, line, r_err_str);
-		if (err != OK)
+		if (need_comma) {
+
+			if (c != ',') {
+				err_str = "Expected ','";
+				return ERR_PARSE_ERROR;
+			}
+			pos++;
+			need_comma = false;
+			continue;
+		}
+
+		err = _parse_value(c);
+		if (err)
 			return err;
 
-		if (token.type == TK_BRACKET_CLOSE) {
+		need_comma = true;
+	}
+
+	return ERR_PARSE_ERROR;
+}
+
+Error JSONParser::_parse_object() {
+
+	Error err = handler->begin_object();
+	if (err)
+		return err;
+
+	bool need_comma = false;
+	String key;
+
+	while (true) {
 
-			return OK;
+		int c = _skip_space();
+
+		if (c == '}') {
+			pos++;
+			return handler->end_object();
 		}
 
 		if (need_comma) {
 
-			if (token.type != TK_COMMA) {
-
-				r_err_str = "Expected ','";
+			if (c != ',') {
+				err_str = "Expected '}' or ','";
 				return ERR_PARSE_ERROR;
-			} else {
-				need_comma = false;
-				continue;
 			}
+			pos++;
+			need_comma = false;
+			continue;
 		}
 
-		Variant v;
-		err = _parse_value(v, token, p_str, index, p_len, line, r_err_str);
+		if (c != '"') {
+			err_str = "Expected key";
+			return ERR_PARSE_ERROR;
+		}
+		pos++;
+
+		err = _parse_string(key);
+		if (err)
+			return err;
+		err = handler->key(key);
+		if (err)
+			return err;
+
+		if (_skip_space() != ':') {
+			err_str = "Expected ':'";
+			return ERR_PARSE_ERROR;
+		}
+		pos++;
+
+		err = _parse_value(_skip_space());
 		if (err)
 			return err;
 
-		array.push_back(v);
 		need_comma = true;
 	}
 
 	return ERR_PARSE_ERROR;
 }
 
-Error JSON::_parse_object(Dictionary &object, const CharType *p_str, int &index, int p_len, int &line, String &r_err_str) {
+Error JSONParser::parse() {
 
-	bool at_key = true;
-	String key;
-	Token token;
-	bool need_comma = false;
+	if (_peek() == 0xEF) {
+		// skip the byte order mark
+		pos++;
+		if (_get() != 0xBB || _get() != 0xBF) {
+			err_str = "Unexpected character.";
+			return ERR_PARSE_ERROR;
+		}
+	}
 
-	while (index < p_len) {
+	return _parse_value(_skip_space());
+}
 
-		if (at_key) {
+// Builds the Variant returned by the parse functions.
+class JSONVariantBuilder : public JSONHandler {
 
-			Error err = _get_token(p_str, index, p_len, token, line, r_err_str);
-			if (err != OK)
-				return err;
+	// open arrays and dictionaries, along with the key being filled in each
+	Vector<Variant> stack;
+	Vector<String> keys;
+
+	void _add(const Variant &p_value) {
+
+		if (stack.empty()) {
+			result = p_value;
+			return;
+		}
 
-			if (token.type == TK_CURLY_BRACKET_CLOSE) {
+		const Variant &top = stack[stack.size() - 1];
+		if (top.get_type() == Variant::ARRAY) {
+			Array array = top;
+			array.push_back(p_value);
+		} else {
+			Dictionary object = top;
+			object[keys[keys.size() - 1]] = p_value;
+		}
+	}
 
-				return OK;
+	void _pop() {
+
+		stack.resize(stack.size() - 1);
+		keys.resize(keys.size() - 1);
+	}
+
+public:
+	Variant result;
+
+	virtual Error begin_object() {
+
+		Dictionary object;
+		_add(object);
+		stack.push_back(object);
+		keys.push_back(String());
+		return OK;
+	}
+
+	virtual Error key(const String &p_key) {
+
+		keys.write[keys.size() - 1] = p_key;
+		return OK;
+	}
+
+	virtual Error end_object() {
+
+		_pop();
+		return OK;
+	}
+
+	virtual Error begin_array() {
+
+		Array array;
+		_add(array);
+		stack.push_back(array);
+		keys.push_back(String());
+		return OK;
+	}
+
+	virtual Error end_array() {
+
+		_pop();
+		return OK;
+	}
+
+	virtual Error value(const Variant &p_value) {
+
+		_add(p_value);
+		return OK;
+	}
+};
+
+// Writes UTF-8 text through a small buffer, into a file or a growing byte array.
+class JSONWriter {
+
+	uint8_t chunk[JSON_WRITE_CHUNK_SIZE];
+	int used;
+
+	FileAccess *file;
+	PoolVector<uint8_t> *buffer;
+	int buffer_used;
+
+	CharString indent;
+	bool pretty;
+	bool sort_keys;
+
+	void _flush() {
+
+		if (used == 0)
+			return;
+
+		if (file) {
+			file->store_buffer(chunk, used);
+		} else {
+			if (buffer_used + used > buffer->size()) {
+				// grow geometrically, the final size is trimmed in finish()
+				buffer->resize(MAX(buffer_used + used, buffer->size() * 2));
 			}
+			PoolVector<uint8_t>::Write w = buffer->write();
+			copymem(&w[buffer_used], chunk, used);
+			buffer_used += used;
+		}
+		used = 0;
+	}
 
-			if (need_comma) {
+	_FORCE_INLINE_ void _put(uint8_t p_byte) {
+
+		if (used == JSON_WRITE_CHUNK_SIZE)
+			_flush();
+		chunk[used++] = p_byte;
+	}
 
-				if (token.type != TK_COMMA) {
+	void _put(const char *p_str, int p_len) {
 
-					r_err_str = "Expected '}' or ','";
-					return ERR_PARSE_ERROR;
-				} else {
-					need_comma = false;
-					continue;
+		if (used + p_len > JSON_WRITE_CHUNK_SIZE) {
+			_flush();
+			if (p_len > JSON_WRITE_CHUNK_SIZE) {
+				for (int i = 0; i < p_len; i++) {
+					_put(uint8_t(p_str[i]));
 				}
+				return;
 			}
+		}
+		copymem(&chunk[used], p_str, p_len);
+		used += p_len;
+	}
 
-			if (token.type != TK_STRING) {
+	void _put_ascii(const String &p_str) {
 
-				r_err_str = "Expected key";
-				return ERR_PARSE_ERROR;
-			}
+		const CharType *s = p_str.c_str();
+		for (int i = 0; i < p_str.length(); i++) {
+			_put(uint8_t(s[i]));
+		}
+	}
 
-			key = token.value;
-			err = _get_token(p_str, index, p_len, token, line, r_err_str);
-			if (err != OK)
-				return err;
-			if (token.type != TK_COLON) {
+	void _put_indent(int p_level) {
 
-				r_err_str = "Expected ':'";
-				return ERR_PARSE_ERROR;
+		if (!pretty)
+			return;
+		for (int i = 0; i < p_level; i++) {
+			_put(indent.get_data(), indent.length());
+		}
+	}
+
+	void _put_end_statement() {
+
+		if (pretty)
+			_put('\n');
+	}
+
+	void _put_string(const String &p_str) {
+
+		_put('"');
+
+		const CharType *s = p_str.c_str();
+		const int l = p_str.length();
+
+		for (int i = 0; i < l; i++) {
+
+			uint32_t c = s[i];
+
+			// same escapes as String::json_escape()
+			switch (c) {
+				case '\\': _put("\\\\", 2); continue;
+				case '\b': _put("\\b", 2); continue;
+				case '\f': _put("\\f", 2); continue;
+				case '\n': _put("\\n", 2); continue;
+				case '\r': _put("\\r", 2); continue;
+				case '\t': _put("\\t", 2); continue;
+				case '\v': _put("\\v", 2); continue;
+				case '"': _put("\\\"", 2); continue;
 			}
-			at_key = false;
-		} else {
 
-			Error err = _get_token(p_str, index, p_len, token, line, r_err_str);
-			if (err != OK)
-				return err;
+			if (c < 0x20) {
+				// other control characters, NUL included, would end the document when it is read back as UTF-8
+				static const char hex[] = "0123456789abcdef";
+				char escape[6] = { '\\', 'u', '0', '0', hex[c >> 4], hex[c & 0xf] };
+				_put(escape, 6);
+			} else if (c <= 0x7f) {
+				_put(c);
+			} else if (c <= 0x7ff) {
+				_put(0xc0 | ((c >> 6) & 0x1f));
+				_put(0x80 | (c & 0x3f));
+			} else if (c <= 0xffff) {
+				_put(0xe0 | ((c >> 12) & 0x0f));
+				_put(0x80 | ((c >> 6) & 0x3f));
+				_put(0x80 | (c & 0x3f));
+			} else if (c <= 0x001fffff) {
+				_put(0xf0 | ((c >> 18) & 0x07));
+				_put(0x80 | ((c >> 12) & 0x3f));
+				_put(0x80 | ((c >> 6) & 0x3f));
+				_put(0x80 | (c & 0x3f));
+			} else if (c <= 0x03ffffff) {
+				_put(0xf8 | ((c >> 24) & 0x03));
+				_put(0x80 | ((c >> 18) & 0x3f));
+				_put(0x80 | ((c >> 12) & 0x3f));
+				_put(0x80 | ((c >> 6) & 0x3f));
+				_put(0x80 | (c & 0x3f));
+			} else if (c <= 0x7fffffff) {
+				_put(0xfc | ((c >> 30) & 0x01));
+				_put(0x80 | ((c >> 24) & 0x3f));
+				_put(0x80 | ((c >> 18) & 0x3f));
+				_put(0x80 | ((c >> 12) & 0x3f));
+				_put(0x80 | ((c >> 6) & 0x3f));
+				_put(0x80 | (c & 0x3f));
+			}
+		}
 
-			Variant v;
-			err = _parse_value(v, token, p_str, index, p_len, line, r_err_str);
-			if (err)
-				return err;
-			object[key] = v;
-			need_comma = true;
-			at_key = true;
+		_put('"');
+	}
+
+public:
+	void write(const Variant &p_var, int p_cur_indent) {
+
+		switch (p_var.get_type()) {
+
+			case Variant::NIL: _put("null", 4); break;
+			case Variant::BOOL: {
+				if (p_var.operator bool())
+					_put("true", 4);
+				else
+					_put("false", 5);
+			} break;
+			case Variant::INT: _put_ascii(itos(p_var)); break;
+			case Variant::REAL: _put_ascii(rtos(p_var)); break;
+			case Variant::POOL_INT_ARRAY:
+			case Variant::POOL_REAL_ARRAY:
+			case Variant::POOL_STRING_ARRAY:
+			case Variant::ARRAY: {
+
+				_put('[');
+				_put_end_statement();
+				Array a = p_var;
+				for (int i = 0; i < a.size(); i++) {
+					if (i > 0) {
+						_put(',');
+						_put_end_statement();
+					}
+					_put_indent(p_cur_indent + 1);
+					write(a[i], p_cur_indent + 1);
+				}
+				_put_end_statement();
+				_put_indent(p_cur_indent);
+				_put(']');
+			} break;
+			case Variant::DICTIONARY: {
+
+				_put('{');
+				_put_end_statement();
+				Dictionary d = p_var;
+				List<Variant> keys;
+				d.get_key_list(&keys);
+
+				if (sort_keys)
+					keys.sort();
+
+				for (List<Variant>::Element *E = keys.front(); E; E = E->next()) {
+
+					if (E != keys.front()) {
+						_put(',');
+						_put_end_statement();
+					}
+					_put_indent(p_cur_indent + 1);
+					_put_string(String(E->get()));
+					_put(':');
+					if (pretty)
+						_put(' ');
+					write(d[E->get()], p_cur_indent + 1);
+				}
+
+				_put_end_statement();
+				_put_indent(p_cur_indent);
+				_put('}');
+			} break;
+			default: _put_string(String(p_var));
 		}
 	}
 
-	return ERR_PARSE_ERROR;
+	void finish() {
+
+		_flush();
+		if (buffer)
+			buffer->resize(buffer_used);
+	}
+
+	JSONWriter(FileAccess *p_file, PoolVector<uint8_t> *r_buffer, const String &p_indent, bool p_sort_keys) {
+
+		used = 0;
+		file = p_file;
+		buffer = r_buffer;
+		buffer_used = 0;
+		indent = p_indent.utf8();
+		pretty = !p_indent.empty();
+		sort_keys = p_sort_keys;
+	}
+};
+
+void JSON::_print(const Variant &p_var, FileAccess *p_file, PoolVector<uint8_t> *r_buffer, const String &p_indent, bool p_sort_keys) {
+
+	JSONWriter *writer = memnew(JSONWriter(p_file, r_buffer, p_indent, p_sort_keys));
+	writer->write(p_var, 0);
+	writer->finish();
+	memdelete(writer);
 }
 
-Error JSON::parse(const String &p_json, Variant &r_ret, String &r_err_str, int &r_err_line) {
+String JSON::print(const Variant &p_var, const String &p_indent, bool p_sort_keys) {
 
-	const CharType *str = p_json.ptr();
-	int idx = 0;
-	int len = p_json.length();
-	Token token;
-	r_err_line = 0;
-	String aux_key;
+	PoolVector<uint8_t> utf8 = print_utf8(p_var, p_indent, p_sort_keys);
 
-	Error err = _get_token(str, idx, len, token, r_err_line, r_err_str);
-	if (err)
-		return err;
+	String ret;
+	PoolVector<uint8_t>::Read r = utf8.read();
+	ret.parse_utf8((const char *)r.ptr(), utf8.size());
+	return ret;
+}
+
+PoolVector<uint8_t> JSON::print_utf8(const Variant &p_var, const String &p_indent, bool p_sort_keys) {
+
+	PoolVector<uint8_t> ret;
+	_print(p_var, NULL, &ret, p_indent, p_sort_keys);
+	return ret;
+}
+
+Error JSON::print_to_file(const Variant &p_var, FileAccess *p_file, const String &p_indent, bool p_sort_keys) {
+
+	ERR_FAIL_COND_V(!p_file, ERR_INVALID_PARAMETER);
+
+	_print(p_var, p_file, NULL, p_indent, p_sort_keys);
+	return p_file->get_error();
+}
+
+Error JSON::_parse(const uint8_t *p_utf8, int p_len, FileAccess *p_file, JSONHandler *p_handler, String &r_err_str, int &r_err_line) {
+
+	JSONParser parser(p_utf8, p_len, p_file, p_handler);
+	Error err = parser.parse();
+
+	r_err_line = parser.line;
+	if (err != OK && parser.err_str != String()) {
+		r_err_str = parser.err_str;
+	}
+	return err;
+}
 
-	err = _parse_value(r_ret, token, str, idx, len, r_err_line, r_err_str);
+Error JSON::_parse_variant(const uint8_t *p_utf8, int p_len, FileAccess *p_file, Variant &r_ret, String &r_err_str, int &r_err_line) {
 
+	JSONVariantBuilder builder;
+	Error err = _parse(p_utf8, p_len, p_file, &builder, r_err_str, r_err_line);
+	if (err == OK) {
+		r_ret = builder.result;
+	}
 	return err;
 }
+
+Error JSON::parse(const String &p_json, Variant &r_ret, String &r_err_str, int &r_err_line) {
+
+	CharString utf8 = p_json.utf8();
+	return _parse_variant((const uint8_t *)utf8.get_data(), utf8.length(), NULL, r_ret, r_err_str, r_err_line);
+}
+
+Error JSON::parse_utf8(const uint8_t *p_utf8, int p_len, Variant &r_ret, String &r_err_str, int &r_err_line) {
+
+	return _parse_variant(p_utf8, p_len, NULL, r_ret, r_err_str, r_err_line);
+}
+
+Error JSON::parse_file(FileAccess *p_file, Variant &r_ret, String &r_err_str, int &r_err_line) {
+
+	ERR_FAIL_COND_V(!p_file, ERR_INVALID_PARAMETER);
+	return _parse_variant(NULL, 0, p_file, r_ret, r_err_str, r_err_line);
+}
+
+Error JSON::parse_utf8(const uint8_t *p_utf8, int p_len, JSONHandler *p_handler, String &r_err_str, int &r_err_line) {
+
+	ERR_FAIL_COND_V(!p_handler, ERR_INVALID_PARAMETER);
+	return _parse(p_utf8, p_len, NULL, p_handler, r_err_str, r_err_line);
+}
+
+Error JSON::parse_file(FileAccess *p_file, JSONHandler *p_handler, String &r_err_str, int &r_err_line) {
+
+	ERR_FAIL_COND_V(!p_file, ERR_INVALID_PARAMETER);
+	ERR_FAIL_COND_V(!p_handler, ERR_INVALID_PARAMETER);
+	return _parse(NULL, 0, p_file, p_handler, r_err_str, r_err_line);
+}
@@ -33,48 +33,45 @@
 
 #include "core/variant.h"
 
-class JSON {
-
-	enum TokenType {
-		TK_CURLY_BRACKET_OPEN,
-		TK_CURLY_BRACKET_CLOSE,
-		TK_BRACKET_OPEN,
-		TK_BRACKET_CLOSE,
-		TK_IDENTIFIER,
-		TK_STRING,
-		TK_NUMBER,
-		TK_COLON,
-		TK_COMMA,
-		TK_EOF,
-		TK_MAX
-	};
+class FileAccess;
 
-	enum Expecting {
-
-		EXPECT_OBJECT,
-		EXPECT_OBJECT_KEY,
-		EXPECT_COLON,
-		EXPECT_OBJECT_VALUE,
-	};
+// Receives a document piece by piece while it is parsed, so it never has
+// to be held in memory as a whole. Returning anything but OK stops parsing
+// and is returned by the parse function.
+class JSONHandler {
+public:
+	virtual Error begin_object() = 0;
+	virtual Error key(const String &p_key) = 0;
+	virtual Error end_object() = 0;
 
-	struct Token {
+	virtual Error begin_array() = 0;
+	virtual Error end_array() = 0;
 
-		TokenType type;
-		Variant value;
-	};
+	// Strings, numbers (always REAL), booleans and null.
+	virtual Error value(const Variant &p_value) = 0;
 
-	static const char *tk_name[TK_MAX];
+	virtual ~JSONHandler() {}
+};
 
-	static String _print_var(const Variant &p_var, const String &p_indent, int p_cur_indent, bool p_sort_keys);
+class JSON {
 
-	static Error _get_token(const CharType *p_str, int &index, int p_len, Token &r_token, int &line, String &r_err_str);
-	static Error _parse_value(Variant &value, Token &token, const CharType *p_str, int &index, int p_len, int &line, String &r_err_str);
-	static Error _parse_array(Array &array, const CharType *p_str, int &index, int p_len, int &line, String &r_err_str);
-	static Error _parse_object(Dictionary &object, const CharType *p_str, int &index, int p_len, int &line, String &r_err_str);
+	static void _print(const Variant &p_var, FileAccess *p_file, PoolVector<uint8_t> *r_buffer, const String &p_indent, bool p_sort_keys);
+	static Error _parse(const uint8_t *p_utf8, int p_len, FileAccess *p_file, JSONHandler *p_handler, String &r_err_str, int &r_err_line);
+	static Error _parse_variant(const uint8_t *p_utf8, int p_len, FileAccess *p_file, Variant &r_ret, String &r_err_str, int &r_err_line);
 
 public:
 	static String print(const Variant &p_var, const String &p_indent = "", bool p_sort_keys = true);
+	// Same text as print(), UTF-8 encoded, written without building intermediate strings.
+	static PoolVector<uint8_t> print_utf8(const Variant &p_var, const String &p_indent = "", bool p_sort_keys = true);
+	static Error print_to_file(const Variant &p_var, FileAccess *p_file, const String &p_indent = "", bool p_sort_keys = true);
+
 	static Error parse(const String &p_json, Variant &r_ret, String &r_err_str, int &r_err_line);
+	static Error parse_utf8(const uint8_t *p_utf8, int p_len, Variant &r_ret, String &r_err_str, int &r_err_line);
+	// Reads from the current position of the file up to its end.
+	static Error parse_file(FileAccess *p_file, Variant &r_ret, String &r_err_str, int &r_err_line);
+
+	static Error parse_utf8(const uint8_t *p_utf8, int p_len, JSONHandler *p_handler, String &r_err_str, int &r_err_line);
+	static Error parse_file(FileAccess *p_file, JSONHandler *p_handler, String &r_err_str, int &r_err_line);
 };
 
 #endif // JSON_H
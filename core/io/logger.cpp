@@ -33,6 +33,7 @@
 #include "core/os/dir_access.h"
 #include "core/os/os.h"
 #include "core/print_string.h"
+#include "core/safe_refcount.h"
 
 // va_copy was defined in the C99, but not in C++ standards before C++11.
 // When you compile C++ without --std=c++<XX> option, compilers still define
@@ -45,6 +46,27 @@
 #endif
 #endif
 
+Logger::Level Logger::category_levels[Logger::CATEGORY_MAX] = { Logger::LEVEL_INFO, Logger::LEVEL_INFO, Logger::LEVEL_INFO };
+
+void Logger::set_category_level(Category p_category, Level p_level) {
+	ERR_FAIL_INDEX(p_category, CATEGORY_MAX);
+	category_levels[p_category] = p_level;
+}
+
+Logger::Level Logger::get_category_level(Category p_category) {
+	ERR_FAIL_INDEX_V(p_category, CATEGORY_MAX, LEVEL_NONE);
+	return category_levels[p_category];
+}
+
+bool Logger::is_error_enabled(ErrorType p_type) {
+	switch (p_type) {
+		case ERR_WARNING: return is_level_enabled(CATEGORY_ENGINE, LEVEL_WARNING);
+		case ERR_SCRIPT: return is_level_enabled(CATEGORY_SCRIPT, LEVEL_ERROR);
+		case ERR_SHADER: return is_level_enabled(CATEGORY_SHADER, LEVEL_ERROR);
+		default: return is_level_enabled(CATEGORY_ENGINE, LEVEL_ERROR);
+	}
+}
+
 bool Logger::should_log(bool p_err) {
 	return (!p_err || _print_error_enabled) && (p_err || _print_line_enabled);
 }
@@ -215,6 +237,12 @@ void RotatedFileLogger::logv(const char *p_format, va_list p_list, bool p_err) {
 	}
 }
 
+void RotatedFileLogger::flush() {
+	if (file) {
+		file->flush();
+	}
+}
+
 RotatedFileLogger::~RotatedFileLogger() {
 	close_file();
 }
@@ -234,6 +262,11 @@ void StdLogger::logv(const char *p_format, va_list p_list, bool p_err) {
 	}
 }
 
+void StdLogger::flush() {
+	fflush(stdout);
+	fflush(stderr);
+}
+
 StdLogger::~StdLogger() {}
 
 CompositeLogger::CompositeLogger(Vector<Logger *> p_loggers) {
@@ -263,12 +296,336 @@ void CompositeLogger::log_error(const char *p_function, const char *p_file, int
 	}
 }
 
+void CompositeLogger::flush() {
+	for (int i = 0; i < loggers.size(); ++i) {
+		loggers[i]->flush();
+	}
+}
+
 void CompositeLogger::add_logger(Logger *p_logger) {
 	loggers.push_back(p_logger);
 }
 
+Vector<Logger *> CompositeLogger::release_loggers() {
+	Vector<Logger *> released = loggers;
+	loggers.clear();
+	return released;
+}
+
 CompositeLogger::~CompositeLogger() {
 	for (int i = 0; i < loggers.size(); ++i) {
 		memdelete(loggers[i]);
 	}
 }
+
+AsyncLogger::Slot *AsyncLogger::_begin_write() {
+
+	// Checking for room before taking a ticket is racy, but at worst a producer has to wait
+	// below for the writer to free its slot; it never overwrites a message that wasn't written.
+	if (write_pos - read_pos > slot_mask) {
+		atomic_increment(&dropped);
+		return NULL;
+	}
+
+	uint32_t ticket = atomic_increment(&write_pos) - 1;
+	Slot *slot = &slots[ticket & slot_mask];
+	while (slot->sequence != ticket) {
+		OS::get_singleton()->delay_usec(100);
+	}
+
+	slot->long_text = NULL;
+	return slot;
+}
+
+void AsyncLogger::_end_write(Slot *p_slot, bool p_urgent) {
+
+	uint32_t ticket = atomic_increment(&p_slot->sequence) - 1;
+
+	if (p_urgent || ticket - read_pos > slot_mask / 2) {
+		urgent = true;
+	}
+
+	// Only the first message after the writer went idle needs to wake it up.
+	if (atomic_increment(&pending) == 1) {
+		semaphore->post();
+	}
+}
+
+void AsyncLogger::logv(const char *p_format, va_list p_list, bool p_err) {
+	if (!should_log(p_err)) {
+		return;
+	}
+
+	if (!thread) {
+		for (int i = 0; i < loggers.size(); ++i) {
+			va_list list_copy;
+			va_copy(list_copy, p_list);
+			loggers[i]->logv(p_format, list_copy, p_err);
+			va_end(list_copy);
+		}
+		return;
+	}
+
+	Slot *slot = _begin_write();
+	if (!slot) {
+		return;
+	}
+
+	va_list list_copy;
+	va_copy(list_copy, p_list);
+	int len = vsnprintf(slot->text, SLOT_TEXT_SIZE, p_format, p_list);
+	if (len >= SLOT_TEXT_SIZE) {
+		slot->long_text = (char *)Memory::alloc_static(len + 1);
+		vsnprintf(slot->long_text, len + 1, p_format, list_copy);
+	}
+	va_end(list_copy);
+
+	slot->kind = p_err ? SLOT_PRINT_ERROR : SLOT_PRINT;
+	slot->length = MAX(len, 0);
+	_end_write(slot, false);
+}
+
+void AsyncLogger::log_error(const char *p_function, const char *p_file, int p_line, const char *p_code, const char *p_rationale, ErrorType p_type) {
+	if (!should_log(true)) {
+		return;
+	}
+
+	if (!thread) {
+		for (int i = 0; i < loggers.size(); ++i) {
+			loggers[i]->log_error(p_function, p_file, p_line, p_code, p_rationale, p_type);
+		}
+		return;
+	}
+
+	// The wrapped loggers format errors themselves, so keep the parts and let them do it on the writer thread.
+	const char *parts[4] = { p_function, p_file, p_code, p_rationale ? p_rationale : "" };
+	int part_lengths[4];
+	int total = 0;
+	for (int i = 0; i < 4; i++) {
+		part_lengths[i] = strlen(parts[i]) + 1;
+		total += part_lengths[i];
+	}
+
+	Slot *slot = _begin_write();
+	if (!slot) {
+		return;
+	}
+
+	char *dst = slot->text;
+	if (total > SLOT_TEXT_SIZE) {
+		slot->long_text = (char *)Memory::alloc_static(total);
+		dst = slot->long_text;
+	}
+	for (int i = 0; i < 4; i++) {
+		memcpy(dst, parts[i], part_lengths[i]);
+		dst += part_lengths[i];
+	}
+
+	slot->kind = SLOT_ERROR;
+	slot->error_type = p_type;
+	slot->line = p_line;
+	slot->length = total;
+	_end_write(slot, true);
+}
+
+void AsyncLogger::_write_batch() {
+
+	if (batch_len == 0) {
+		return;
+	}
+
+	batch[batch_len] = 0;
+	for (int i = 0; i < loggers.size(); ++i) {
+		if (batch_err) {
+			loggers[i]->logf_error("%s", batch);
+		} else {
+			loggers[i]->logf("%s", batch);
+		}
+	}
+	batch_len = 0;
+}
+
+void AsyncLogger::_drain() {
+
+	drain_mutex->lock();
+
+	uint32_t pos = read_pos;
+	while (true) {
+
+		Slot &slot = slots[pos & slot_mask];
+		// full barrier, so the text is read only after the producer published it
+		if (atomic_add(&slot.sequence, 0) != pos + 1) {
+			break;
+		}
+
+		const char *text = slot.long_text ? slot.long_text : slot.text;
+
+		if (slot.kind == SLOT_ERROR) {
+			_write_batch();
+
+			const char *function = text;
+			const char *file = function + strlen(function) + 1;
+			const char *code = file + strlen(file) + 1;
+			const char *rationale = code + strlen(code) + 1;
+			for (int i = 0; i < loggers.size(); ++i) {
+				loggers[i]->log_error(function, file, slot.line, code, rationale, slot.error_type);
+			}
+		} else {
+			bool err = slot.kind == SLOT_PRINT_ERROR;
+			if (batch_len > 0 && (err != batch_err || batch_len + slot.length >= BATCH_SIZE)) {
+				_write_batch();
+			}
+			batch_err = err;
+
+			if (slot.length >= BATCH_SIZE) {
+				for (int i = 0; i < loggers.size(); ++i) {
+					if (err) {
+						loggers[i]->logf_error("%s", text);
+					} else {
+						loggers[i]->logf("%s", text);
+					}
+				}
+			} else {
+				memcpy(batch + batch_len, text, slot.length);
+				batch_len += slot.length;
+			}
+		}
+
+		if (slot.long_text) {
+			Memory::free_static(slot.long_text);
+			slot.long_text = NULL;
+		}
+
+		// hand the slot over to the producer that gets the ticket one lap ahead
+		atomic_add(&slot.sequence, slot_mask);
+		pos++;
+		atomic_increment(&read_pos);
+	}
+
+	_write_batch();
+
+	uint32_t lost = dropped;
+	if (lost) {
+		atomic_sub(&dropped, lost);
+		for (int i = 0; i < loggers.size(); ++i) {
+			loggers[i]->logf_error("%u log messages were dropped, the log queue was full.\n", lost);
+		}
+	}
+
+	for (int i = 0; i < loggers.size(); ++i) {
+		loggers[i]->flush();
+	}
+
+	drain_mutex->unlock();
+}
+
+void AsyncLogger::_thread_func(void *p_self) {
+
+	AsyncLogger *self = (AsyncLogger *)p_self;
+
+	while (true) {
+
+		self->semaphore->wait();
+
+		// stop() writes whatever is left once the thread is gone
+		if (self->exit_thread)
+			break;
+
+		uint32_t count;
+		do {
+			// let messages pile up for a while so they are written in a single batch
+			if (!self->exit_thread) {
+				uint64_t flush_time = OS::get_singleton()->get_ticks_usec() + self->flush_interval_usec;
+				while (!self->urgent && !self->exit_thread && OS::get_singleton()->get_ticks_usec() < flush_time) {
+					OS::get_singleton()->delay_usec(1000);
+				}
+			}
+
+			self->urgent = false;
+			count = self->pending;
+			self->_drain();
+		} while (atomic_sub(&self->pending, count) != 0);
+	}
+}
+
+void AsyncLogger::flush() {
+
+	if (!thread) {
+		for (int i = 0; i < loggers.size(); ++i) {
+			loggers[i]->flush();
+		}
+		return;
+	}
+
+	// This is also called from crash handlers, possibly on the writer thread itself, so never block for good.
+	for (int i = 0; i < 100; i++) {
+		if (drain_mutex->try_lock() == OK) {
+			drain_mutex->unlock();
+			_drain();
+			return;
+		}
+		OS::get_singleton()->delay_usec(1000);
+	}
+}
+
+AsyncLogger::AsyncLogger(const Vector<Logger *> &p_loggers, int p_queue_size, int p_flush_interval_msec) {
+
+	loggers = p_loggers;
+
+	uint32_t slot_count = next_power_of_2(MAX(p_queue_size, 16));
+	slot_mask = slot_count - 1;
+	slots = memnew_arr(Slot, slot_count);
+	for (uint32_t i = 0; i < slot_count; i++) {
+		// a slot is free for ticket N when its sequence is N, and holds a message once it is N + 1
+		slots[i].sequence = i;
+		slots[i].long_text = NULL;
+	}
+	write_pos = 0;
+	read_pos = 0;
+	pending = 0;
+	dropped = 0;
+	urgent = false;
+
+	batch = memnew_arr(char, BATCH_SIZE + 1);
+	batch_len = 0;
+	batch_err = false;
+
+	flush_interval_usec = MAX(p_flush_interval_msec, 0) * 1000;
+	exit_thread = false;
+	semaphore = Semaphore::create();
+	drain_mutex = Mutex::create();
+	thread = semaphore && drain_mutex ? Thread::create(_thread_func, this) : NULL;
+}
+
+void AsyncLogger::stop() {
+
+	if (!thread) {
+		return;
+	}
+
+	exit_thread = true;
+	semaphore->post();
+	Thread::wait_to_finish(thread);
+	memdelete(thread);
+	thread = NULL;
+
+	_drain();
+}
+
+AsyncLogger::~AsyncLogger() {
+
+	stop();
+
+	if (semaphore) {
+		memdelete(semaphore);
+	}
+	if (drain_mutex) {
+		memdelete(drain_mutex);
+	}
+	memdelete_arr(batch);
+	memdelete_arr(slots);
+
+	for (int i = 0; i < loggers.size(); ++i) {
+		memdelete(loggers[i]);
+	}
+}
@@ -32,6 +32,9 @@
 #define LOGGER_H
 
 #include "core/os/file_access.h"
+#include "core/os/mutex.h"
+#include "core/os/semaphore.h"
+#include "core/os/thread.h"
 #include "core/ustring.h"
 #include "core/vector.h"
 
@@ -49,8 +52,32 @@ public:
 		ERR_SHADER
 	};
 
+	enum Category {
+		CATEGORY_ENGINE,
+		CATEGORY_SCRIPT,
+		CATEGORY_SHADER,
+		CATEGORY_MAX
+	};
+
+	enum Level {
+		LEVEL_NONE,
+		LEVEL_ERROR,
+		LEVEL_WARNING,
+		LEVEL_INFO
+	};
+
+private:
+	static Level category_levels[CATEGORY_MAX];
+
+public:
+	static void set_category_level(Category p_category, Level p_level);
+	static Level get_category_level(Category p_category);
+	_FORCE_INLINE_ static bool is_level_enabled(Category p_category, Level p_level) { return p_level <= category_levels[p_category]; }
+	static bool is_error_enabled(ErrorType p_type);
+
 	virtual void logv(const char *p_format, va_list p_list, bool p_err) = 0;
 	virtual void log_error(const char *p_function, const char *p_file, int p_line, const char *p_code, const char *p_rationale, ErrorType p_type = ERR_ERROR);
+	virtual void flush() {}
 
 	void logf(const char *p_format, ...);
 	void logf_error(const char *p_format, ...);
@@ -65,6 +92,7 @@ class StdLogger : public Logger {
 
 public:
 	virtual void logv(const char *p_format, va_list p_list, bool p_err);
+	virtual void flush();
 	virtual ~StdLogger();
 };
 
@@ -89,6 +117,7 @@ public:
 	RotatedFileLogger(const String &p_base_path, int p_max_files = 10);
 
 	virtual void logv(const char *p_format, va_list p_list, bool p_err);
+	virtual void flush();
 
 	virtual ~RotatedFileLogger();
 };
@@ -101,10 +130,78 @@ public:
 
 	virtual void logv(const char *p_format, va_list p_list, bool p_err);
 	virtual void log_error(const char *p_function, const char *p_file, int p_line, const char *p_code, const char *p_rationale, ErrorType p_type = ERR_ERROR);
+	virtual void flush();
 
 	void add_logger(Logger *p_logger);
+	Vector<Logger *> release_loggers();
 
 	virtual ~CompositeLogger();
 };
 
+/**
+ * Hands messages over to a background thread, which writes them to the wrapped loggers in batches,
+ * so the threads producing them never wait on the terminal or the disk. Messages are formatted
+ * straight into a ring of fixed size slots without taking any lock; when the ring is full they
+ * are dropped, and the number of dropped messages is reported with the next batch.
+ */
+class AsyncLogger : public Logger {
+
+	enum {
+		SLOT_TEXT_SIZE = 232,
+		BATCH_SIZE = 16384
+	};
+
+	enum SlotKind {
+		SLOT_PRINT,
+		SLOT_PRINT_ERROR,
+		SLOT_ERROR
+	};
+
+	struct Slot {
+		volatile uint32_t sequence;
+		SlotKind kind;
+		ErrorType error_type;
+		int line;
+		int length;
+		char *long_text;
+		char text[SLOT_TEXT_SIZE];
+	};
+
+	Vector<Logger *> loggers;
+
+	Slot *slots;
+	uint32_t slot_mask;
+	volatile uint32_t write_pos;
+	volatile uint32_t read_pos;
+	volatile uint32_t pending;
+	volatile uint32_t dropped;
+	volatile bool urgent;
+
+	char *batch;
+	int batch_len;
+	bool batch_err;
+
+	uint64_t flush_interval_usec;
+	volatile bool exit_thread;
+	Thread *thread;
+	Semaphore *semaphore;
+	Mutex *drain_mutex;
+
+	Slot *_begin_write();
+	void _end_write(Slot *p_slot, bool p_urgent);
+
+	void _write_batch();
+	void _drain();
+	static void _thread_func(void *p_self);
+
+public:
+	virtual void logv(const char *p_format, va_list p_list, bool p_err);
+	virtual void log_error(const char *p_function, const char *p_file, int p_line, const char *p_code, const char *p_rationale, ErrorType p_type = ERR_ERROR);
+	virtual void flush();
+	void stop(); ///< writes what is queued and stops the writer thread, later messages are written right away
+
+	AsyncLogger(const Vector<Logger *> &p_loggers, int p_queue_size = 2048, int p_flush_interval_msec = 200);
+	virtual ~AsyncLogger();
+};
+
 #endif
@@ -82,9 +82,7 @@ static Error _decode_string(const uint8_t *&buf, int &len, int *r_len, String &r
 	ERR_FAIL_ADD_OF(strlen, pad, ERR_FILE_EOF);
 	ERR_FAIL_COND_V(strlen < 0 || strlen + pad > len, ERR_FILE_EOF);
 
-	String str;
-	ERR_FAIL_COND_V(str.parse_utf8((const char *)buf, strlen), ERR_INVALID_DATA);
-	r_string = str;
+	ERR_FAIL_COND_V(r_string.parse_utf8((const char *)buf, strlen), ERR_INVALID_DATA);
 
 	// Add padding
 	strlen += pad;
@@ -481,7 +479,7 @@ Error decode_variant(Variant &r_variant, const uint8_t *p_buffer, int p_len, int
 
 			for (int i = 0; i < count; i++) {
 
-				Variant key, value;
+				Variant key;
 
 				int used;
 				Error err = decode_variant(key, buf, len, &used, p_allow_objects);
@@ -493,7 +491,7 @@ Error decode_variant(Variant &r_variant, const uint8_t *p_buffer, int p_len, int
 					(*r_len) += used;
 				}
 
-				err = decode_variant(value, buf, len, &used, p_allow_objects);
+				err = decode_variant(d[key], buf, len, &used, p_allow_objects);
 				ERR_FAIL_COND_V(err, err);
 
 				buf += used;
@@ -501,8 +499,6 @@ Error decode_variant(Variant &r_variant, const uint8_t *p_buffer, int p_len, int
 				if (r_len) {
 					(*r_len) += used;
 				}
-
-				d[key] = value;
 			}
 
 			r_variant = d;
@@ -522,17 +518,19 @@ Error decode_variant(Variant &r_variant, const uint8_t *p_buffer, int p_len, int
 				(*r_len) += 4;
 			}
 
+			// every element takes at least 4 bytes, so this also bounds the resize below
+			ERR_FAIL_COND_V(count > len / 4, ERR_INVALID_DATA);
+
 			Array varr;
+			varr.resize(count);
 
 			for (int i = 0; i < count; i++) {
 
 				int used = 0;
-				Variant v;
-				Error err = decode_variant(v, buf, len, &used, p_allow_objects);
+				Error err = decode_variant(varr[i], buf, len, &used, p_allow_objects);
 				ERR_FAIL_COND_V(err, err);
 				buf += used;
 				len -= used;
-				varr.push_back(v);
 				if (r_len) {
 					(*r_len) += used;
 				}
@@ -556,11 +554,7 @@ Error decode_variant(Variant &r_variant, const uint8_t *p_buffer, int p_len, int
 			if (count) {
 				data.resize(count);
 				PoolVector<uint8_t>::Write w = data.write();
-				for (int32_t i = 0; i < count; i++) {
-
-					w[i] = buf[i];
-				}
-
+				copymem(w.ptr(), buf, count);
 				w = PoolVector<uint8_t>::Write();
 			}
 
@@ -585,13 +579,16 @@ Error decode_variant(Variant &r_variant, const uint8_t *p_buffer, int p_len, int
 			PoolVector<int> data;
 
 			if (count) {
-				//const int*rbuf=(const int*)buf;
 				data.resize(count);
 				PoolVector<int>::Write w = data.write();
+#ifdef BIG_ENDIAN_ENABLED
 				for (int32_t i = 0; i < count; i++) {
 
 					w[i] = decode_uint32(&buf[i * 4]);
 				}
+#else
+				copymem(w.ptr(), buf, count * 4);
+#endif
 
 				w = PoolVector<int>::Write();
 			}
@@ -613,13 +610,16 @@ Error decode_variant(Variant &r_variant, const uint8_t *p_buffer, int p_len, int
 			PoolVector<float> data;
 
 			if (count) {
-				//const float*rbuf=(const float*)buf;
 				data.resize(count);
 				PoolVector<float>::Write w = data.write();
+#ifdef BIG_ENDIAN_ENABLED
 				for (int32_t i = 0; i < count; i++) {
 
 					w[i] = decode_float(&buf[i * 4]);
 				}
+#else
+				copymem(w.ptr(), buf, count * 4);
+#endif
 
 				w = PoolVector<float>::Write();
 			}
@@ -641,16 +641,20 @@ Error decode_variant(Variant &r_variant, const uint8_t *p_buffer, int p_len, int
 
 			if (r_len)
 				(*r_len) += 4;
-			//printf("string count: %i\n",count);
 
-			for (int32_t i = 0; i < count; i++) {
+			// every string takes at least 4 bytes, so this also bounds the resize below
+			ERR_FAIL_COND_V(count < 0 || count > len / 4, ERR_INVALID_DATA);
 
-				String str;
-				Error err = _decode_string(buf, len, r_len, str);
-				if (err)
-					return err;
+			if (count) {
+				strings.resize(count);
+				PoolVector<String>::Write w = strings.write();
+
+				for (int32_t i = 0; i < count; i++) {
 
-				strings.push_back(str);
+					Error err = _decode_string(buf, len, r_len, w[i]);
+					if (err)
+						return err;
+				}
 			}
 
 			r_variant = strings;
@@ -675,11 +679,15 @@ Error decode_variant(Variant &r_variant, const uint8_t *p_buffer, int p_len, int
 				varray.resize(count);
 				PoolVector<Vector2>::Write w = varray.write();
 
+#if defined(BIG_ENDIAN_ENABLED) || defined(REAL_T_IS_DOUBLE)
 				for (int32_t i = 0; i < count; i++) {
 
 					w[i].x = decode_float(buf + i * 4 * 2 + 4 * 0);
 					w[i].y = decode_float(buf + i * 4 * 2 + 4 * 1);
 				}
+#else
+				copymem(w.ptr(), buf, count * 4 * 2);
+#endif
 
 				int adv = 4 * 2 * count;
 
@@ -712,12 +720,16 @@ Error decode_variant(Variant &r_variant, const uint8_t *p_buffer, int p_len, int
 				varray.resize(count);
 				PoolVector<Vector3>::Write w = varray.write();
 
+#if defined(BIG_ENDIAN_ENABLED) || defined(REAL_T_IS_DOUBLE)
 				for (int32_t i = 0; i < count; i++) {
 
 					w[i].x = decode_float(buf + i * 4 * 3 + 4 * 0);
 					w[i].y = decode_float(buf + i * 4 * 3 + 4 * 1);
 					w[i].z = decode_float(buf + i * 4 * 3 + 4 * 2);
 				}
+#else
+				copymem(w.ptr(), buf, count * 4 * 3);
+#endif
 
 				int adv = 4 * 3 * count;
 
@@ -750,6 +762,7 @@ Error decode_variant(Variant &r_variant, const uint8_t *p_buffer, int p_len, int
 				carray.resize(count);
 				PoolVector<Color>::Write w = carray.write();
 
+#ifdef BIG_ENDIAN_ENABLED
 				for (int32_t i = 0; i < count; i++) {
 
 					w[i].r = decode_float(buf + i * 4 * 4 + 4 * 0);
@@ -757,6 +770,9 @@ Error decode_variant(Variant &r_variant, const uint8_t *p_buffer, int p_len, int
 					w[i].b = decode_float(buf + i * 4 * 4 + 4 * 2);
 					w[i].a = decode_float(buf + i * 4 * 4 + 4 * 3);
 				}
+#else
+				copymem(w.ptr(), buf, count * 4 * 4);
+#endif
 
 				int adv = 4 * 4 * count;
 
@@ -775,31 +791,115 @@ Error decode_variant(Variant &r_variant, const uint8_t *p_buffer, int p_len, int
 	return OK;
 }
 
-static void _encode_string(const String &p_string, uint8_t *&buf, int &r_len) {
+// Writers for _encode_variant(). Both expose the same calls, so the encoder is
+// written once and either only measures, or writes in a single pass into a
+// caller buffer or a Vector that grows as needed.
+
+class _VariantSizeWriter {
+public:
+	int len;
+
+	_FORCE_INLINE_ void put_u32(uint32_t) { len += 4; }
+	_FORCE_INLINE_ void put_u64(uint64_t) { len += 8; }
+	_FORCE_INLINE_ void put_float(float) { len += 4; }
+	_FORCE_INLINE_ void put_double(double) { len += 8; }
+	_FORCE_INLINE_ void put_data(const void *, int p_bytes) { len += p_bytes; }
+	_FORCE_INLINE_ void put_u32_array(const uint32_t *, int p_count) { len += p_count * 4; }
+	_FORCE_INLINE_ void put_float_array(const float *, int p_count) { len += p_count * 4; }
+	_FORCE_INLINE_ void put_string(const String &p_string, bool p_null_terminated) {
+		len += 4 + p_string.utf8_length() + (p_null_terminated ? 1 : 0);
+		pad();
+	}
+	_FORCE_INLINE_ void pad() { len = (len + 3) & ~3; }
+
+	_VariantSizeWriter() { len = 0; }
+};
+
+class _VariantBufferWriter {
+
+	uint8_t *buf;
+	Vector<uint8_t> *vector;
+	int offset;
 
-	CharString utf8 = p_string.utf8();
+	void _grow(int p_bytes) {
 
-	if (buf) {
-		encode_uint32(utf8.length(), buf);
-		buf += 4;
-		copymem(buf, utf8.get_data(), utf8.length());
-		buf += utf8.length();
+		int size = MAX(vector->size() * 2, 64);
+		while (size < offset + len + p_bytes)
+			size *= 2;
+		vector->resize(size);
+		buf = vector->ptrw() + offset;
 	}
 
-	r_len += 4 + utf8.length();
-	while (r_len % 4) {
-		r_len++; //pad
-		if (buf) {
-			*(buf++) = 0;
-		}
+	_FORCE_INLINE_ uint8_t *_reserve(int p_bytes) {
+
+		if (vector && offset + len + p_bytes > vector->size())
+			_grow(p_bytes);
+		uint8_t *ptr = buf + len;
+		len += p_bytes;
+		return ptr;
 	}
-}
 
-Error encode_variant(const Variant &p_variant, uint8_t *r_buffer, int &r_len, bool p_object_as_id) {
+public:
+	int len;
 
-	uint8_t *buf = r_buffer;
+	_FORCE_INLINE_ void put_u32(uint32_t p_value) { encode_uint32(p_value, _reserve(4)); }
+	_FORCE_INLINE_ void put_u64(uint64_t p_value) { encode_uint64(p_value, _reserve(8)); }
+	_FORCE_INLINE_ void put_float(float p_value) { encode_float(p_value, _reserve(4)); }
+	_FORCE_INLINE_ void put_double(double p_value) { encode_double(p_value, _reserve(8)); }
+	_FORCE_INLINE_ void put_data(const void *p_data, int p_bytes) {
+		if (p_bytes)
+			copymem(_reserve(p_bytes), p_data, p_bytes);
+	}
+	_FORCE_INLINE_ void put_u32_array(const uint32_t *p_data, int p_count) {
+#ifdef BIG_ENDIAN_ENABLED
+		for (int i = 0; i < p_count; i++)
+			put_u32(p_data[i]);
+#else
+		put_data(p_data, p_count * 4);
+#endif
+	}
+	_FORCE_INLINE_ void put_float_array(const float *p_data, int p_count) {
+#ifdef BIG_ENDIAN_ENABLED
+		for (int i = 0; i < p_count; i++)
+			put_float(p_data[i]);
+#else
+		put_data(p_data, p_count * 4);
+#endif
+	}
+	void put_string(const String &p_string, bool p_null_terminated) {
+
+		// measure first so the bytes go straight into place, no CharString
+		int utf8_len = p_string.utf8_length();
+		put_u32(utf8_len + (p_null_terminated ? 1 : 0));
+		p_string.write_utf8((char *)_reserve(utf8_len));
+		if (p_null_terminated)
+			*_reserve(1) = 0;
+		pad();
+	}
+	_FORCE_INLINE_ void pad() {
+		while (len % 4)
+			*_reserve(1) = 0;
+	}
 
-	r_len = 0;
+	_VariantBufferWriter(uint8_t *p_buffer) {
+		buf = p_buffer;
+		vector = NULL;
+		offset = 0;
+		len = 0;
+	}
+
+	_VariantBufferWriter(Vector<uint8_t> *p_vector, int p_offset) {
+		vector = p_vector;
+		offset = p_offset;
+		len = 0;
+		if (vector->size() < offset)
+			vector->resize(offset);
+		buf = vector->size() ? vector->ptrw() + offset : NULL;
+	}
+};
+
+template <class W>
+static Error _encode_variant(const Variant &p_variant, W &w, bool p_object_as_id) {
 
 	uint32_t flags = 0;
 
@@ -826,11 +926,7 @@ Error encode_variant(const Variant &p_variant, uint8_t *r_buffer, int &r_len, bo
 		} break;
 	}
 
-	if (buf) {
-		encode_uint32(p_variant.get_type() | flags, buf);
-		buf += 4;
-	}
-	r_len += 4;
+	w.put_u32(p_variant.get_type() | flags);
 
 	switch (p_variant.get_type()) {
 
@@ -840,243 +936,147 @@ Error encode_variant(const Variant &p_variant, uint8_t *r_buffer, int &r_len, bo
 		} break;
 		case Variant::BOOL: {
 
-			if (buf) {
-				encode_uint32(p_variant.operator bool(), buf);
-			}
-
-			r_len += 4;
+			w.put_u32(p_variant.operator bool());
 
 		} break;
 		case Variant::INT: {
 
 			int64_t val = p_variant;
-			if (val > 0x7FFFFFFF || val < -0x80000000) {
+			if (flags & ENCODE_FLAG_64) {
 				//64 bits
-				if (buf) {
-					encode_uint64(val, buf);
-				}
-
-				r_len += 8;
+				w.put_u64(val);
 			} else {
-				if (buf) {
-					encode_uint32(int32_t(val), buf);
-				}
-
-				r_len += 4;
+				w.put_u32(int32_t(val));
 			}
 		} break;
 		case Variant::REAL: {
 
-			double d = p_variant;
-			float f = d;
-			if (double(f) != d) {
-				if (buf) {
-					encode_double(p_variant.operator double(), buf);
-				}
-
-				r_len += 8;
-
+			if (flags & ENCODE_FLAG_64) {
+				w.put_double(p_variant.operator double());
 			} else {
-
-				if (buf) {
-					encode_float(p_variant.operator float(), buf);
-				}
-
-				r_len += 4;
+				w.put_float(p_variant.operator float());
 			}
 
 		} break;
 		case Variant::NODE_PATH: {
 
 			NodePath np = p_variant;
-			if (buf) {
-				encode_uint32(uint32_t(np.get_name_count()) | 0x80000000, buf); //for compatibility with the old format
-				encode_uint32(np.get_subname_count(), buf + 4);
-				uint32_t flags = 0;
-				if (np.is_absolute())
-					flags |= 1;
+			w.put_u32(uint32_t(np.get_name_count()) | 0x80000000); //for compatibility with the old format
+			w.put_u32(np.get_subname_count());
+			w.put_u32(np.is_absolute() ? 1 : 0);
 
-				encode_uint32(flags, buf + 8);
-
-				buf += 12;
+			for (int i = 0; i < np.get_name_count(); i++) {
+				w.put_string(np.get_name(i), false);
 			}
-
-			r_len += 12;
-
-			int total = np.get_name_count() + np.get_subname_count();
-
-			for (int i = 0; i < total; i++) {
-
-				String str;
-
-				if (i < np.get_name_count())
-					str = np.get_name(i);
-				else
-					str = np.get_subname(i - np.get_name_count());
-
-				CharString utf8 = str.utf8();
-
-				int pad = 0;
-
-				if (utf8.length() % 4)
-					pad = 4 - utf8.length() % 4;
-
-				if (buf) {
-					encode_uint32(utf8.length(), buf);
-					buf += 4;
-					copymem(buf, utf8.get_data(), utf8.length());
-					buf += pad + utf8.length();
-				}
-
-				r_len += 4 + utf8.length() + pad;
+			for (int i = 0; i < np.get_subname_count(); i++) {
+				w.put_string(np.get_subname(i), false);
 			}
 
 		} break;
 		case Variant::STRING: {
 
-			_encode_string(p_variant, buf, r_len);
+			String str = p_variant;
+			w.put_string(str, false);
 
 		} break;
 
 		// math types
 		case Variant::VECTOR2: {
 
-			if (buf) {
-				Vector2 v2 = p_variant;
-				encode_float(v2.x, &buf[0]);
-				encode_float(v2.y, &buf[4]);
-			}
-
-			r_len += 2 * 4;
+			Vector2 v2 = p_variant;
+			w.put_float(v2.x);
+			w.put_float(v2.y);
 
 		} break; // 5
 		case Variant::RECT2: {
 
-			if (buf) {
-				Rect2 r2 = p_variant;
-				encode_float(r2.position.x, &buf[0]);
-				encode_float(r2.position.y, &buf[4]);
-				encode_float(r2.size.x, &buf[8]);
-				encode_float(r2.size.y, &buf[12]);
-			}
-			r_len += 4 * 4;
+			Rect2 r2 = p_variant;
+			w.put_float(r2.position.x);
+			w.put_float(r2.position.y);
+			w.put_float(r2.size.x);
+			w.put_float(r2.size.y);
 
 		} break;
 		case Variant::VECTOR3: {
 
-			if (buf) {
-				Vector3 v3 = p_variant;
-				encode_float(v3.x, &buf[0]);
-				encode_float(v3.y, &buf[4]);
-				encode_float(v3.z, &buf[8]);
-			}
-
-			r_len += 3 * 4;
+			Vector3 v3 = p_variant;
+			w.put_float(v3.x);
+			w.put_float(v3.y);
+			w.put_float(v3.z);
 
 		} break;
 		case Variant::TRANSFORM2D: {
 
-			if (buf) {
-				Transform2D val = p_variant;
-				for (int i = 0; i < 3; i++) {
-					for (int j = 0; j < 2; j++) {
-
-						copymem(&buf[(i * 2 + j) * 4], &val.elements[i][j], sizeof(float));
-					}
+			Transform2D val = p_variant;
+			for (int i = 0; i < 3; i++) {
+				for (int j = 0; j < 2; j++) {
+					w.put_float(val.elements[i][j]);
 				}
 			}
 
-			r_len += 6 * 4;
-
 		} break;
 		case Variant::PLANE: {
 
-			if (buf) {
-				Plane p = p_variant;
-				encode_float(p.normal.x, &buf[0]);
-				encode_float(p.normal.y, &buf[4]);
-				encode_float(p.normal.z, &buf[8]);
-				encode_float(p.d, &buf[12]);
-			}
-
-			r_len += 4 * 4;
+			Plane p = p_variant;
+			w.put_float(p.normal.x);
+			w.put_float(p.normal.y);
+			w.put_float(p.normal.z);
+			w.put_float(p.d);
 
 		} break;
 		case Variant::QUAT: {
 
-			if (buf) {
-				Quat q = p_variant;
-				encode_float(q.x, &buf[0]);
-				encode_float(q.y, &buf[4]);
-				encode_float(q.z, &buf[8]);
-				encode_float(q.w, &buf[12]);
-			}
-
-			r_len += 4 * 4;
+			Quat q = p_variant;
+			w.put_float(q.x);
+			w.put_float(q.y);
+			w.put_float(q.z);
+			w.put_float(q.w);
 
 		} break;
 		case Variant::AABB: {
 
-			if (buf) {
-				AABB aabb = p_variant;
-				encode_float(aabb.position.x, &buf[0]);
-				encode_float(aabb.position.y, &buf[4]);
-				encode_float(aabb.position.z, &buf[8]);
-				encode_float(aabb.size.x, &buf[12]);
-				encode_float(aabb.size.y, &buf[16]);
-				encode_float(aabb.size.z, &buf[20]);
-			}
-
-			r_len += 6 * 4;
+			AABB aabb = p_variant;
+			w.put_float(aabb.position.x);
+			w.put_float(aabb.position.y);
+			w.put_float(aabb.position.z);
+			w.put_float(aabb.size.x);
+			w.put_float(aabb.size.y);
+			w.put_float(aabb.size.z);
 
 		} break;
 		case Variant::BASIS: {
 
-			if (buf) {
-				Basis val = p_variant;
-				for (int i = 0; i < 3; i++) {
-					for (int j = 0; j < 3; j++) {
-
-						copymem(&buf[(i * 3 + j) * 4], &val.elements[i][j], sizeof(float));
-					}
+			Basis val = p_variant;
+			for (int i = 0; i < 3; i++) {
+				for (int j = 0; j < 3; j++) {
+					w.put_float(val.elements[i][j]);
 				}
 			}
 
-			r_len += 9 * 4;
-
 		} break;
 		case Variant::TRANSFORM: {
 
-			if (buf) {
-				Transform val = p_variant;
-				for (int i = 0; i < 3; i++) {
-					for (int j = 0; j < 3; j++) {
-
-						copymem(&buf[(i * 3 + j) * 4], &val.basis.elements[i][j], sizeof(float));
-					}
+			Transform val = p_variant;
+			for (int i = 0; i < 3; i++) {
+				for (int j = 0; j < 3; j++) {
+					w.put_float(val.basis.elements[i][j]);
 				}
-
-				encode_float(val.origin.x, &buf[36]);
-				encode_float(val.origin.y, &buf[40]);
-				encode_float(val.origin.z, &buf[44]);
 			}
 
-			r_len += 12 * 4;
+			w.put_float(val.origin.x);
+			w.put_float(val.origin.y);
+			w.put_float(val.origin.z);
 
 		} break;
 
 		// misc types
 		case Variant::COLOR: {
 
-			if (buf) {
-				Color c = p_variant;
-				encode_float(c.r, &buf[0]);
-				encode_float(c.g, &buf[4]);
-				encode_float(c.b, &buf[8]);
-				encode_float(c.a, &buf[12]);
-			}
-
-			r_len += 4 * 4;
+			Color c = p_variant;
+			w.put_float(c.r);
+			w.put_float(c.g);
+			w.put_float(c.b);
+			w.put_float(c.a);
 
 		} break;
 		/*case Variant::RESOURCE: {
@@ -1091,30 +1091,21 @@ Error encode_variant(const Variant &p_variant, uint8_t *r_buffer, int &r_len, bo
 
 			if (p_object_as_id) {
 
-				if (buf) {
-
-					Object *obj = p_variant;
-					ObjectID id = 0;
-					if (obj && ObjectDB::instance_validate(obj)) {
-						id = obj->get_instance_id();
-					}
-
-					encode_uint64(id, buf);
+				Object *obj = p_variant;
+				ObjectID id = 0;
+				if (obj && ObjectDB::instance_validate(obj)) {
+					id = obj->get_instance_id();
 				}
 
-				r_len += 8;
+				w.put_u64(id);
 
 			} else {
 				Object *obj = p_variant;
 				if (!obj) {
-					if (buf) {
-						encode_uint32(0, buf);
-						buf += 4;
-					}
-					r_len += 4;
+					w.put_u32(0);
 
 				} else {
-					_encode_string(obj->get_class(), buf, r_len);
+					w.put_string(obj->get_class(), false);
 
 					List<PropertyInfo> props;
 					obj->get_property_list(&props);
@@ -1127,28 +1118,18 @@ Error encode_variant(const Variant &p_variant, uint8_t *r_buffer, int &r_len, bo
 						pc++;
 					}
 
-					if (buf) {
-						encode_uint32(pc, buf);
-						buf += 4;
-					}
-
-					r_len += 4;
+					w.put_u32(pc);
 
 					for (List<PropertyInfo>::Element *E = props.front(); E; E = E->next()) {
 
 						if (!(E->get().usage & PROPERTY_USAGE_STORAGE))
 							continue;
 
-						_encode_string(E->get().name, buf, r_len);
+						w.put_string(E->get().name, false);
 
-						int len;
-						Error err = encode_variant(obj->get(E->get().name), buf, len, p_object_as_id);
+						Error err = _encode_variant(obj->get(E->get().name), w, p_object_as_id);
 						if (err)
 							return err;
-						ERR_FAIL_COND_V(len % 4, ERR_BUG);
-						r_len += len;
-						if (buf)
-							buf += len;
 					}
 				}
 			}
@@ -1158,43 +1139,19 @@ Error encode_variant(const Variant &p_variant, uint8_t *r_buffer, int &r_len, bo
 
 			Dictionary d = p_variant;
 
-			if (buf) {
-				encode_uint32(uint32_t(d.size()), buf);
-				buf += 4;
-			}
-			r_len += 4;
+			w.put_u32(uint32_t(d.size()));
 
 			List<Variant> keys;
 			d.get_key_list(&keys);
 
 			for (List<Variant>::Element *E = keys.front(); E; E = E->next()) {
 
-				/*
-				CharString utf8 = E->->utf8();
-
-				if (buf) {
-					encode_uint32(utf8.length()+1,buf);
-					buf+=4;
-					copymem(buf,utf8.get_data(),utf8.length()+1);
-				}
-
-				r_len+=4+utf8.length()+1;
-				while (r_len%4)
-					r_len++; //pad
-				*/
-				int len;
-				encode_variant(E->get(), buf, len, p_object_as_id);
-				ERR_FAIL_COND_V(len % 4, ERR_BUG);
-				r_len += len;
-				if (buf)
-					buf += len;
+				Error err = _encode_variant(E->get(), w, p_object_as_id);
+				ERR_FAIL_COND_V(err, err);
 				Variant *v = d.getptr(E->get());
 				ERR_FAIL_COND_V(!v, ERR_BUG);
-				encode_variant(*v, buf, len, p_object_as_id);
-				ERR_FAIL_COND_V(len % 4, ERR_BUG);
-				r_len += len;
-				if (buf)
-					buf += len;
+				err = _encode_variant(*v, w, p_object_as_id);
+				ERR_FAIL_COND_V(err, err);
 			}
 
 		} break;
@@ -1202,75 +1159,50 @@ Error encode_variant(const Variant &p_variant, uint8_t *r_buffer, int &r_len, bo
 
 			Array v = p_variant;
 
-			if (buf) {
-				encode_uint32(uint32_t(v.size()), buf);
-				buf += 4;
-			}
-
-			r_len += 4;
+			w.put_u32(uint32_t(v.size()));
 
 			for (int i = 0; i < v.size(); i++) {
 
-				int len;
-				encode_variant(v.get(i), buf, len, p_object_as_id);
-				ERR_FAIL_COND_V(len % 4, ERR_BUG);
-				r_len += len;
-				if (buf)
-					buf += len;
+				Error err = _encode_variant(v[i], w, p_object_as_id);
+				ERR_FAIL_COND_V(err, err);
 			}
 
 		} break;
-		// arrays
+		// arrays, the element data goes out in bulk wherever memory layout allows it
 		case Variant::POOL_BYTE_ARRAY: {
 
 			PoolVector<uint8_t> data = p_variant;
 			int datalen = data.size();
-			int datasize = sizeof(uint8_t);
 
-			if (buf) {
-				encode_uint32(datalen, buf);
-				buf += 4;
-				PoolVector<uint8_t>::Read r = data.read();
-				copymem(buf, &r[0], datalen * datasize);
-			}
-
-			r_len += 4 + datalen * datasize;
-			while (r_len % 4)
-				r_len++;
+			w.put_u32(datalen);
+			PoolVector<uint8_t>::Read r = data.read();
+			w.put_data(r.ptr(), datalen);
+			w.pad();
 
 		} break;
 		case Variant::POOL_INT_ARRAY: {
 
 			PoolVector<int> data = p_variant;
 			int datalen = data.size();
-			int datasize = sizeof(int32_t);
-
-			if (buf) {
-				encode_uint32(datalen, buf);
-				buf += 4;
-				PoolVector<int>::Read r = data.read();
-				for (int i = 0; i < datalen; i++)
-					encode_uint32(r[i], &buf[i * datasize]);
-			}
 
-			r_len += 4 + datalen * datasize;
+			w.put_u32(datalen);
+			PoolVector<int>::Read r = data.read();
+			w.put_u32_array((const uint32_t *)r.ptr(), datalen);
 
 		} break;
 		case Variant::POOL_REAL_ARRAY: {
 
 			PoolVector<real_t> data = p_variant;
 			int datalen = data.size();
-			int datasize = sizeof(real_t);
-
-			if (buf) {
-				encode_uint32(datalen, buf);
-				buf += 4;
-				PoolVector<real_t>::Read r = data.read();
-				for (int i = 0; i < datalen; i++)
-					encode_float(r[i], &buf[i * datasize]);
-			}
 
-			r_len += 4 + datalen * datasize;
+			w.put_u32(datalen);
+			PoolVector<real_t>::Read r = data.read();
+#ifdef REAL_T_IS_DOUBLE
+			for (int i = 0; i < datalen; i++)
+				w.put_float(r[i]);
+#else
+			w.put_float_array(r.ptr(), datalen);
+#endif
 
 		} break;
 		case Variant::POOL_STRING_ARRAY: {
@@ -1278,30 +1210,11 @@ Error encode_variant(const Variant &p_variant, uint8_t *r_buffer, int &r_len, bo
 			PoolVector<String> data = p_variant;
 			int len = data.size();
 
-			if (buf) {
-				encode_uint32(len, buf);
-				buf += 4;
-			}
-
-			r_len += 4;
+			w.put_u32(len);
 
+			PoolVector<String>::Read r = data.read();
 			for (int i = 0; i < len; i++) {
-
-				CharString utf8 = data.get(i).utf8();
-
-				if (buf) {
-					encode_uint32(utf8.length() + 1, buf);
-					buf += 4;
-					copymem(buf, utf8.get_data(), utf8.length() + 1);
-					buf += utf8.length() + 1;
-				}
-
-				r_len += 4 + utf8.length() + 1;
-				while (r_len % 4) {
-					r_len++; //pad
-					if (buf)
-						*(buf++) = 0;
-				}
+				w.put_string(r[i], true);
 			}
 
 		} break;
@@ -1310,26 +1223,16 @@ Error encode_variant(const Variant &p_variant, uint8_t *r_buffer, int &r_len, bo
 			PoolVector<Vector2> data = p_variant;
 			int len = data.size();
 
-			if (buf) {
-				encode_uint32(len, buf);
-				buf += 4;
-			}
-
-			r_len += 4;
-
-			if (buf) {
-
-				for (int i = 0; i < len; i++) {
-
-					Vector2 v = data.get(i);
-
-					encode_float(v.x, &buf[0]);
-					encode_float(v.y, &buf[4]);
-					buf += 4 * 2;
-				}
+			w.put_u32(len);
+			PoolVector<Vector2>::Read r = data.read();
+#ifdef REAL_T_IS_DOUBLE
+			for (int i = 0; i < len; i++) {
+				w.put_float(r[i].x);
+				w.put_float(r[i].y);
 			}
-
-			r_len += 4 * 2 * len;
+#else
+			w.put_float_array((const float *)r.ptr(), len * 2);
+#endif
 
 		} break;
 		case Variant::POOL_VECTOR3_ARRAY: {
@@ -1337,27 +1240,17 @@ Error encode_variant(const Variant &p_variant, uint8_t *r_buffer, int &r_len, bo
 			PoolVector<Vector3> data = p_variant;
 			int len = data.size();
 
-			if (buf) {
-				encode_uint32(len, buf);
-				buf += 4;
-			}
-
-			r_len += 4;
-
-			if (buf) {
-
-				for (int i = 0; i < len; i++) {
-
-					Vector3 v = data.get(i);
-
-					encode_float(v.x, &buf[0]);
-					encode_float(v.y, &buf[4]);
-					encode_float(v.z, &buf[8]);
-					buf += 4 * 3;
-				}
+			w.put_u32(len);
+			PoolVector<Vector3>::Read r = data.read();
+#ifdef REAL_T_IS_DOUBLE
+			for (int i = 0; i < len; i++) {
+				w.put_float(r[i].x);
+				w.put_float(r[i].y);
+				w.put_float(r[i].z);
 			}
-
-			r_len += 4 * 3 * len;
+#else
+			w.put_float_array((const float *)r.ptr(), len * 3);
+#endif
 
 		} break;
 		case Variant::POOL_COLOR_ARRAY: {
@@ -1365,32 +1258,38 @@ Error encode_variant(const Variant &p_variant, uint8_t *r_buffer, int &r_len, bo
 			PoolVector<Color> data = p_variant;
 			int len = data.size();
 
-			if (buf) {
-				encode_uint32(len, buf);
-				buf += 4;
-			}
+			w.put_u32(len);
+			PoolVector<Color>::Read r = data.read();
+			w.put_float_array((const float *)r.ptr(), len * 4);
 
-			r_len += 4;
+		} break;
+		default: { ERR_FAIL_V(ERR_BUG); }
+	}
 
-			if (buf) {
+	return OK;
+}
 
-				for (int i = 0; i < len; i++) {
+Error encode_variant(const Variant &p_variant, uint8_t *r_buffer, int &r_len, bool p_object_as_id) {
 
-					Color c = data.get(i);
+	if (!r_buffer) {
+		_VariantSizeWriter w;
+		Error err = _encode_variant(p_variant, w, p_object_as_id);
+		r_len = w.len;
+		return err;
+	}
 
-					encode_float(c.r, &buf[0]);
-					encode_float(c.g, &buf[4]);
-					encode_float(c.b, &buf[8]);
-					encode_float(c.a, &buf[12]);
-					buf += 4 * 4;
-				}
-			}
+	_VariantBufferWriter w(r_buffer);
+	Error err = _encode_variant(p_variant, w, p_object_as_id);
+	r_len = w.len;
+	return err;
+}
 
-			r_len += 4 * 4 * len;
+Error encode_variant(const Variant &p_variant, Vector<uint8_t> &r_buffer, int &r_len, int p_offset, bool p_object_as_id) {
 
-		} break;
-		default: { ERR_FAIL_V(ERR_BUG); }
-	}
+	ERR_FAIL_COND_V(p_offset < 0, ERR_INVALID_PARAMETER);
 
-	return OK;
+	_VariantBufferWriter w(&r_buffer, p_offset);
+	Error err = _encode_variant(p_variant, w, p_object_as_id);
+	r_len = w.len;
+	return err;
 }
@@ -201,5 +201,8 @@ public:
 
 Error decode_variant(Variant &r_variant, const uint8_t *p_buffer, int p_len, int *r_len = NULL, bool p_allow_objects = true);
 Error encode_variant(const Variant &p_variant, uint8_t *r_buffer, int &r_len, bool p_object_as_id = false);
+// Single pass: encodes at p_offset, growing r_buffer when it is too small (it is never shrunk, so it can be
+// reused as scratch space). r_len is the encoded size.
+Error encode_variant(const Variant &p_variant, Vector<uint8_t> &r_buffer, int &r_len, int p_offset = 0, bool p_object_as_id = false);
 
 #endif
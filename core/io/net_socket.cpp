@@ -40,3 +40,14 @@ NetSocket *NetSocket::create() {
 	ERR_PRINT("Unable to create network socket, platform not supported");
 	return NULL;
 }
+
+NetSocketPollGroup *(*NetSocketPollGroup::_create)() = NULL;
+
+NetSocketPollGroup *NetSocketPollGroup::create() {
+
+	if (_create)
+		return _create();
+
+	ERR_PRINT("Unable to create socket poll group, platform not supported");
+	return NULL;
+}
@@ -54,6 +54,18 @@ public:
 		TYPE_UDP,
 	};
 
+	// A datagram for the batch calls. Data that doesn't fit in buffer continues in overflow
+	// (which may be NULL) when receiving; sending only uses buffer and size.
+	struct Datagram {
+		uint8_t *buffer;
+		int buffer_size;
+		uint8_t *overflow;
+		int overflow_size;
+		int size;
+		IP_Address ip;
+		uint16_t port;
+	};
+
 	virtual Error open(Type p_type, IP::Type &ip_type) = 0;
 	virtual void close() = 0;
 	virtual Error bind(IP_Address p_addr, uint16_t p_port) = 0;
@@ -64,6 +76,8 @@ public:
 	virtual Error recvfrom(uint8_t *p_buffer, int p_len, int &r_read, IP_Address &r_ip, uint16_t &r_port) = 0;
 	virtual Error send(const uint8_t *p_buffer, int p_len, int &r_sent) = 0;
 	virtual Error sendto(const uint8_t *p_buffer, int p_len, int &r_sent, IP_Address p_ip, uint16_t p_port) = 0;
+	virtual Error recvfrom_batch(Datagram *p_datagrams, int p_count, int &r_received) = 0;
+	virtual Error sendto_batch(const Datagram *p_datagrams, int p_count, int &r_sent) = 0;
 	virtual Ref<NetSocket> accept(IP_Address &r_ip, uint16_t &r_port) = 0;
 
 	virtual bool is_open() const = 0;
@@ -76,4 +90,32 @@ public:
 	virtual void set_reuse_address_enabled(bool p_enabled) = 0;
 };
 
+/**
+ * A set of sockets whose readiness is queried with a single call, instead of polling every socket.
+ * Sockets stay registered across close() and open(), and leave the group when they are destroyed.
+ */
+class NetSocketPollGroup : public Reference {
+
+protected:
+	static NetSocketPollGroup *(*_create)();
+
+public:
+	static NetSocketPollGroup *create();
+
+	struct Event {
+		uint64_t userdata;
+		bool readable;
+		bool writable;
+		bool hangup;
+	};
+
+	virtual Error add(const Ref<NetSocket> &p_socket, NetSocket::PollType p_type, uint64_t p_userdata) = 0;
+	virtual void remove(const Ref<NetSocket> &p_socket) = 0;
+	virtual bool has(const Ref<NetSocket> &p_socket) const = 0;
+	virtual int get_socket_count() const = 0;
+
+	// Waits up to p_timeout msec (-1 blocks) and returns the amount of events written, or -1 on error.
+	virtual int wait(int p_timeout, Event *r_events, int p_max_events) = 0;
+};
+
 #endif // NET_SOCKET_H
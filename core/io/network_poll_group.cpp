@@ -0,0 +1,132 @@
+/*************************************************************************/
+/*  network_poll_group.cpp                                               */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2018 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2018 Godot Engine contributors (cf. AUTHORS.md)    */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#include "network_poll_group.h"
+
+#include "core/io/http_client.h"
+#include "core/io/packet_peer_udp.h"
+#include "core/io/stream_peer_tcp.h"
+#include "core/io/tcp_server.h"
+
+Ref<NetSocket> NetworkPollGroup::_get_socket(Object *p_peer) const {
+
+	if (TCP_Server *server = Object::cast_to<TCP_Server>(p_peer))
+		return server->_sock;
+	if (StreamPeerTCP *tcp = Object::cast_to<StreamPeerTCP>(p_peer))
+		return tcp->_sock;
+	if (PacketPeerUDP *udp = Object::cast_to<PacketPeerUDP>(p_peer))
+		return udp->_sock;
+#ifndef JAVASCRIPT_ENABLED
+	if (HTTPClient *http = Object::cast_to<HTTPClient>(p_peer))
+		return http->tcp_connection.is_valid() ? http->tcp_connection->_sock : Ref<NetSocket>();
+#endif
+
+	ERR_EXPLAIN("Only TCP_Server, StreamPeerTCP, PacketPeerUDP and HTTPClient can be polled");
+	ERR_FAIL_V(Ref<NetSocket>());
+}
+
+Error NetworkPollGroup::add(Object *p_peer, PollType p_type) {
+
+	ERR_FAIL_COND_V(group.is_null(), ERR_UNAVAILABLE);
+	ERR_FAIL_NULL_V(p_peer, ERR_INVALID_PARAMETER);
+
+	Ref<NetSocket> socket = _get_socket(p_peer);
+	ERR_FAIL_COND_V(socket.is_null(), ERR_INVALID_PARAMETER);
+
+	return group->add(socket, NetSocket::PollType(p_type), p_peer->get_instance_id());
+}
+
+void NetworkPollGroup::remove(Object *p_peer) {
+
+	ERR_FAIL_COND(group.is_null());
+	ERR_FAIL_NULL(p_peer);
+
+	Ref<NetSocket> socket = _get_socket(p_peer);
+	ERR_FAIL_COND(socket.is_null() || !group->has(socket));
+
+	group->remove(socket);
+}
+
+bool NetworkPollGroup::has(Object *p_peer) const {
+
+	if (group.is_null() || !p_peer)
+		return false;
+
+	Ref<NetSocket> socket = _get_socket(p_peer);
+	return socket.is_valid() && group->has(socket);
+}
+
+int NetworkPollGroup::get_peer_count() const {
+
+	return group.is_valid() ? group->get_socket_count() : 0;
+}
+
+Array NetworkPollGroup::poll(int p_timeout_msec) {
+
+	Array ready;
+	ERR_FAIL_COND_V(group.is_null(), ready);
+
+	// room for every socket, so a single call reports all of them
+	int max_events = MAX(group->get_socket_count(), 1);
+	if (events.size() < max_events) {
+		events.resize(max_events);
+	}
+
+	int count = group->wait(p_timeout_msec, events.ptrw(), max_events);
+	ERR_FAIL_COND_V(count < 0, ready);
+
+	for (int i = 0; i < count; i++) {
+		// peers leave the group as soon as their socket is freed, so this only fails if something else kept the socket
+		Object *peer = ObjectDB::get_instance(events[i].userdata);
+		if (peer) {
+			ready.push_back(peer);
+		}
+	}
+
+	return ready;
+}
+
+void NetworkPollGroup::_bind_methods() {
+
+	ClassDB::bind_method(D_METHOD("add", "peer", "type"), &NetworkPollGroup::add, DEFVAL(POLL_TYPE_IN));
+	ClassDB::bind_method(D_METHOD("remove", "peer"), &NetworkPollGroup::remove);
+	ClassDB::bind_method(D_METHOD("has", "peer"), &NetworkPollGroup::has);
+	ClassDB::bind_method(D_METHOD("get_peer_count"), &NetworkPollGroup::get_peer_count);
+	ClassDB::bind_method(D_METHOD("poll", "timeout_msec"), &NetworkPollGroup::poll, DEFVAL(0));
+
+	BIND_ENUM_CONSTANT(POLL_TYPE_IN);
+	BIND_ENUM_CONSTANT(POLL_TYPE_OUT);
+	BIND_ENUM_CONSTANT(POLL_TYPE_IN_OUT);
+}
+
+NetworkPollGroup::NetworkPollGroup() {
+
+	group = Ref<NetSocketPollGroup>(NetSocketPollGroup::create());
+}
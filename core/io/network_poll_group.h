@@ -0,0 +1,70 @@
+/*************************************************************************/
+/*  network_poll_group.h                                                 */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2018 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2018 Godot Engine contributors (cf. AUTHORS.md)    */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef NETWORK_POLL_GROUP_H
+#define NETWORK_POLL_GROUP_H
+
+#include "core/io/net_socket.h"
+#include "core/reference.h"
+
+class NetworkPollGroup : public Reference {
+
+	GDCLASS(NetworkPollGroup, Reference);
+
+public:
+	enum PollType {
+		POLL_TYPE_IN = NetSocket::POLL_TYPE_IN,
+		POLL_TYPE_OUT = NetSocket::POLL_TYPE_OUT,
+		POLL_TYPE_IN_OUT = NetSocket::POLL_TYPE_IN_OUT
+	};
+
+private:
+	Ref<NetSocketPollGroup> group;
+	Vector<NetSocketPollGroup::Event> events;
+
+	Ref<NetSocket> _get_socket(Object *p_peer) const;
+
+protected:
+	static void _bind_methods();
+
+public:
+	Error add(Object *p_peer, PollType p_type = POLL_TYPE_IN);
+	void remove(Object *p_peer);
+	bool has(Object *p_peer) const;
+	int get_peer_count() const;
+
+	Array poll(int p_timeout_msec = 0);
+
+	NetworkPollGroup();
+};
+
+VARIANT_ENUM_CAST(NetworkPollGroup::PollType);
+
+#endif // NETWORK_POLL_GROUP_H
@@ -52,6 +52,8 @@ class PacketPeer : public Reference {
 
 	bool allow_object_decoding;
 
+	Vector<uint8_t> encode_buffer; // put_var() scratch, kept between calls
+
 public:
 	virtual int get_available_packet_count() const = 0;
 	virtual Error get_packet(const uint8_t **r_buffer, int &r_buffer_size) = 0; ///< buffer is GONE after next get_packet
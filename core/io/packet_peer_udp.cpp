@@ -59,49 +59,168 @@ Error PacketPeerUDP::_set_dest_address(const String &p_address, int p_port) {
 
 int PacketPeerUDP::get_available_packet_count() const {
 
-	// TODO we should deprecate this, and expose poll instead!
-	Error err = const_cast<PacketPeerUDP *>(this)->_poll();
-	if (err != OK)
-		return -1;
+	// Only go to the socket once everything queued was read, so a loop taking packets one by one
+	// makes one call per batch instead of one per packet.
+	int available = queue_count - (packet_in_use ? 1 : 0);
+	if (available == 0) {
+		// TODO we should deprecate this, and expose poll instead!
+		Error err = const_cast<PacketPeerUDP *>(this)->_poll();
+		if (err != OK)
+			return -1;
+		available = queue_count - (packet_in_use ? 1 : 0);
+	}
+
+	return available;
+}
+
+void PacketPeerUDP::_release_packet() {
 
-	return queue_count;
+	if (!packet_in_use)
+		return;
+
+	PacketSlot &slot = slots.write[slot_read];
+	if (slot.large) {
+		memfree(slot.large);
+		slot.large = NULL;
+	}
+	slot_read = (slot_read + 1) & slot_mask;
+	queue_count--;
+	packet_in_use = false;
 }
 
 Error PacketPeerUDP::get_packet(const uint8_t **r_buffer, int &r_buffer_size) {
 
-	Error err = _poll();
+	_release_packet();
+
+	if (queue_count == 0) {
+		Error err = _poll();
+		if (err != OK)
+			return err;
+		if (queue_count == 0)
+			return ERR_UNAVAILABLE;
+	}
+
+	const PacketSlot &slot = slots[slot_read];
+	packet_ip = slot.ip;
+	packet_port = slot.port;
+	*r_buffer = slot.large ? slot.large : slot_data.ptr() + slot_read * PACKET_SLOT_SIZE;
+	r_buffer_size = slot.size;
+	packet_in_use = true;
+	return OK;
+}
+
+Array PacketPeerUDP::_get_packets(int p_max) {
+
+	Array packets;
+
+	int count = get_available_packet_count();
+	if (p_max > 0)
+		count = MIN(count, p_max);
+
+	for (int i = 0; i < count; i++) {
+
+		const uint8_t *buffer;
+		int size;
+		if (get_packet(&buffer, size) != OK)
+			break;
+
+		PoolVector<uint8_t> data;
+		data.resize(size);
+		if (size > 0)
+			copymem(data.write().ptr(), buffer, size);
+
+		Dictionary packet;
+		packet["data"] = data;
+		packet["ip"] = String(packet_ip);
+		packet["port"] = packet_port;
+		packets.push_back(packet);
+	}
+
+	return packets;
+}
+
+Error PacketPeerUDP::_open_for_sending() {
+
+	if (_sock->is_open())
+		return OK;
+
+	IP::Type ip_type = peer_addr.is_ipv4() ? IP::TYPE_IPV4 : IP::TYPE_IPV6;
+	Error err = _sock->open(NetSocket::TYPE_UDP, ip_type);
+	ERR_FAIL_COND_V(err != OK, err);
+	_sock->set_blocking_enabled(false);
+	return OK;
+}
+
+Error PacketPeerUDP::put_packets(const uint8_t *const *p_buffers, const int *p_sizes, int p_count, int &r_sent) {
+
+	r_sent = 0;
+	ERR_FAIL_COND_V(!_sock.is_valid(), ERR_UNAVAILABLE);
+	ERR_FAIL_COND_V(!peer_addr.is_valid(), ERR_UNCONFIGURED);
+
+	Error err = _open_for_sending();
 	if (err != OK)
 		return err;
-	if (queue_count == 0)
-		return ERR_UNAVAILABLE;
-
-	uint32_t size = 0;
-	uint8_t ipv6[16];
-	rb.read(ipv6, 16, true);
-	packet_ip.set_ipv6(ipv6);
-	rb.read((uint8_t *)&packet_port, 4, true);
-	rb.read((uint8_t *)&size, 4, true);
-	rb.read(packet_buffer, size, true);
-	--queue_count;
-	*r_buffer = packet_buffer;
-	r_buffer_size = size;
+
+	NetSocket::Datagram datagrams[SEND_BATCH];
+
+	while (r_sent < p_count) {
+
+		int count = MIN(p_count - r_sent, (int)SEND_BATCH);
+		for (int i = 0; i < count; i++) {
+			datagrams[i].buffer = const_cast<uint8_t *>(p_buffers[r_sent + i]);
+			datagrams[i].size = p_sizes[r_sent + i];
+			datagrams[i].ip = peer_addr;
+			datagrams[i].port = peer_port;
+		}
+
+		int sent = 0;
+		err = _sock->sendto_batch(datagrams, count, sent);
+		if (err != OK) {
+			if (err != ERR_BUSY)
+				return FAILED;
+			else if (!blocking)
+				return ERR_BUSY;
+			// Keep trying to send the remaining packets
+			continue;
+		}
+		r_sent += sent;
+	}
+
 	return OK;
 }
 
+Error PacketPeerUDP::_put_packets(const Array &p_packets) {
+
+	int count = p_packets.size();
+	Vector<PoolVector<uint8_t>::Read> reads;
+	Vector<const uint8_t *> buffers;
+	Vector<int> sizes;
+	reads.resize(count);
+	buffers.resize(count);
+	sizes.resize(count);
+
+	for (int i = 0; i < count; i++) {
+		ERR_FAIL_COND_V(p_packets[i].get_type() != Variant::POOL_BYTE_ARRAY, ERR_INVALID_PARAMETER);
+		PoolVector<uint8_t> data = p_packets[i];
+		reads.write[i] = data.read();
+		buffers.write[i] = reads[i].ptr();
+		sizes.write[i] = data.size();
+	}
+
+	int sent;
+	return put_packets(buffers.ptr(), sizes.ptr(), count, sent);
+}
+
 Error PacketPeerUDP::put_packet(const uint8_t *p_buffer, int p_buffer_size) {
 
 	ERR_FAIL_COND_V(!_sock.is_valid(), ERR_UNAVAILABLE);
 	ERR_FAIL_COND_V(!peer_addr.is_valid(), ERR_UNCONFIGURED);
 
-	Error err;
-	int sent = -1;
+	Error err = _open_for_sending();
+	if (err != OK)
+		return err;
 
-	if (!_sock->is_open()) {
-		IP::Type ip_type = peer_addr.is_ipv4() ? IP::TYPE_IPV4 : IP::TYPE_IPV6;
-		err = _sock->open(NetSocket::TYPE_UDP, ip_type);
-		ERR_FAIL_COND_V(err != OK, err);
-		_sock->set_blocking_enabled(false);
-	}
+	int sent = -1;
 
 	do {
 		err = _sock->sendto(p_buffer, p_buffer_size, sent, peer_addr, peer_port);
@@ -150,16 +269,45 @@ Error PacketPeerUDP::listen(int p_port, const IP_Address &p_bind_address, int p_
 		_sock->close();
 		return err;
 	}
-	rb.resize(nearest_shift(p_recv_buffer_size));
+	_resize_slots(p_recv_buffer_size);
 	return OK;
 }
 
+void PacketPeerUDP::_resize_slots(int p_recv_buffer_size) {
+
+	packet_in_use = false;
+	for (int i = 0; i < queue_count; i++) {
+		PacketSlot &slot = slots.write[(slot_read + i) & slot_mask];
+		if (slot.large)
+			memfree(slot.large);
+	}
+	slot_read = 0;
+	queue_count = 0;
+
+	if (p_recv_buffer_size <= 0) {
+		slots.clear();
+		slot_data.clear();
+		slot_mask = 0;
+		return;
+	}
+
+	// The buffer size used to be counted in bytes of a ring buffer; assuming typical packets of a
+	// few hundred bytes, this keeps about as many packets around.
+	int count = next_power_of_2(MAX(p_recv_buffer_size / 256, (int)RECV_BATCH));
+	slots.resize(count);
+	slot_data.resize(count * PACKET_SLOT_SIZE);
+	slot_mask = count - 1;
+}
+
 void PacketPeerUDP::close() {
 
 	if (_sock.is_valid())
 		_sock->close();
-	rb.resize(16);
-	queue_count = 0;
+	_resize_slots(0);
+	if (overflow) {
+		memfree(overflow);
+		overflow = NULL;
+	}
 }
 
 Error PacketPeerUDP::wait() {
@@ -176,35 +324,60 @@ Error PacketPeerUDP::_poll() {
 		return FAILED;
 	}
 
-	Error err;
-	int read;
-	IP_Address ip;
-	uint16_t port;
+	if (slots.empty()) {
+		_resize_slots(PACKET_BUFFER_SIZE);
+	}
+
+	const int overflow_size = PACKET_BUFFER_SIZE - PACKET_SLOT_SIZE;
+	if (!overflow) {
+		// Only the part of a packet that doesn't fit its slot lands here, so most of this memory
+		// is never touched.
+		overflow = (uint8_t *)memalloc(RECV_BATCH * overflow_size);
+	}
+
+	NetSocket::Datagram datagrams[RECV_BATCH];
+	uint8_t *data = slot_data.ptrw();
+	int slot_count = slots.size();
 
-	while (true) {
-		err = _sock->recvfrom(recv_buffer, sizeof(recv_buffer), read, ip, port);
+	while (queue_count < slot_count) {
 
+		int count = MIN(slot_count - queue_count, (int)RECV_BATCH);
+		int first = slot_read + queue_count;
+		for (int i = 0; i < count; i++) {
+			datagrams[i].buffer = data + ((first + i) & slot_mask) * PACKET_SLOT_SIZE;
+			datagrams[i].buffer_size = PACKET_SLOT_SIZE;
+			datagrams[i].overflow = overflow + i * overflow_size;
+			datagrams[i].overflow_size = overflow_size;
+		}
+
+		int received = 0;
+		Error err = _sock->recvfrom_batch(datagrams, count, received);
 		if (err != OK) {
 			if (err == ERR_BUSY)
 				break;
 			return FAILED;
 		}
 
-		if (rb.space_left() < read + 24) {
-#ifdef TOOLS_ENABLED
-			WARN_PRINTS("Buffer full, dropping packets!");
-#endif
-			continue;
+		for (int i = 0; i < received; i++) {
+			PacketSlot &slot = slots.write[(first + i) & slot_mask];
+			slot.ip = datagrams[i].ip;
+			slot.port = datagrams[i].port;
+			slot.size = datagrams[i].size;
+			slot.large = NULL;
+			if (slot.size > PACKET_SLOT_SIZE) {
+				slot.large = (uint8_t *)memalloc(slot.size);
+				copymem(slot.large, datagrams[i].buffer, PACKET_SLOT_SIZE);
+				copymem(slot.large + PACKET_SLOT_SIZE, datagrams[i].overflow, slot.size - PACKET_SLOT_SIZE);
+			}
 		}
+		queue_count += received;
 
-		uint32_t port32 = port;
-		rb.write(ip.get_ipv6(), 16);
-		rb.write((uint8_t *)&port32, 4);
-		rb.write((uint8_t *)&read, 4);
-		rb.write(recv_buffer, read);
-		++queue_count;
+		if (received < count)
+			break; // nothing more waiting
 	}
 
+	// When every slot is taken, further packets wait in the socket's own buffer, and the system
+	// drops them once that fills up.
 	return OK;
 }
 bool PacketPeerUDP::is_listening() const {
@@ -237,6 +410,8 @@ void PacketPeerUDP::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("get_packet_ip"), &PacketPeerUDP::_get_packet_ip);
 	ClassDB::bind_method(D_METHOD("get_packet_port"), &PacketPeerUDP::get_packet_port);
 	ClassDB::bind_method(D_METHOD("set_dest_address", "host", "port"), &PacketPeerUDP::_set_dest_address);
+	ClassDB::bind_method(D_METHOD("get_packets", "max_packets"), &PacketPeerUDP::_get_packets, DEFVAL(0));
+	ClassDB::bind_method(D_METHOD("put_packets", "packets"), &PacketPeerUDP::_put_packets);
 }
 
 PacketPeerUDP::PacketPeerUDP() {
@@ -244,9 +419,12 @@ PacketPeerUDP::PacketPeerUDP() {
 	_sock = Ref<NetSocket>(NetSocket::create());
 	blocking = true;
 	packet_port = 0;
-	queue_count = 0;
 	peer_port = 0;
-	rb.resize(16);
+	slot_mask = 0;
+	slot_read = 0;
+	queue_count = 0;
+	packet_in_use = false;
+	overflow = NULL;
 }
 
 PacketPeerUDP::~PacketPeerUDP() {
@@ -38,17 +38,36 @@
 class PacketPeerUDP : public PacketPeer {
 	GDCLASS(PacketPeerUDP, PacketPeer);
 
+	friend class NetworkPollGroup;
+
 protected:
 	enum {
-		PACKET_BUFFER_SIZE = 65536
+		PACKET_BUFFER_SIZE = 65536,
+		// fits a full Ethernet frame, larger packets are kept in their own allocation
+		PACKET_SLOT_SIZE = 1536,
+		RECV_BATCH = 16,
+		SEND_BATCH = 64
+	};
+
+	struct PacketSlot {
+		IP_Address ip;
+		uint16_t port;
+		int size;
+		uint8_t *large;
 	};
 
-	RingBuffer<uint8_t> rb;
-	uint8_t recv_buffer[PACKET_BUFFER_SIZE];
-	uint8_t packet_buffer[PACKET_BUFFER_SIZE];
+	// Packets are received straight into a ring of fixed size slots, and get_packet() hands out
+	// a pointer into its slot, which stays reserved until the next call.
+	Vector<PacketSlot> slots;
+	Vector<uint8_t> slot_data;
+	int slot_mask;
+	int slot_read;
+	int queue_count;
+	bool packet_in_use;
+	uint8_t *overflow;
+
 	IP_Address packet_ip;
 	int packet_port;
-	int queue_count;
 
 	IP_Address peer_addr;
 	int peer_port;
@@ -61,6 +80,12 @@ protected:
 
 	Error _set_dest_address(const String &p_address, int p_port);
 	Error _poll();
+	Error _open_for_sending();
+	void _resize_slots(int p_recv_buffer_size);
+	void _release_packet();
+
+	Array _get_packets(int p_max);
+	Error _put_packets(const Array &p_packets);
 
 public:
 	void set_blocking_mode(bool p_enable);
@@ -75,6 +100,7 @@ public:
 
 	Error put_packet(const uint8_t *p_buffer, int p_buffer_size);
 	Error get_packet(const uint8_t **r_buffer, int &r_buffer_size);
+	Error put_packets(const uint8_t *const *p_buffers, const int *p_sizes, int p_count, int &r_sent);
 	int get_available_packet_count() const;
 	int get_max_packet_size() const;
 
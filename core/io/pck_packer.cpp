@@ -30,6 +30,8 @@
 
 #include "pck_packer.h"
 
+#include "core/io/file_access_pack.h"
+#include "core/io/marshalls.h"
 #include "core/os/file_access.h"
 #include "core/version.h"
 
@@ -56,7 +58,7 @@ static void _pad(FileAccess *p_file, int p_bytes) {
 void PCKPacker::_bind_methods() {
 
 	ClassDB::bind_method(D_METHOD("pck_start", "pck_name", "alignment"), &PCKPacker::pck_start);
-	ClassDB::bind_method(D_METHOD("add_file", "pck_path", "source_path"), &PCKPacker::add_file);
+	ClassDB::bind_method(D_METHOD("add_file", "pck_path", "source_path", "compress"), &PCKPacker::add_file, DEFVAL(false));
 	ClassDB::bind_method(D_METHOD("flush", "verbose"), &PCKPacker::flush);
 };
 
@@ -70,8 +72,8 @@ Error PCKPacker::pck_start(const String &p_file, int p_alignment) {
 
 	alignment = p_alignment;
 
-	file->store_32(0x43504447); // MAGIC
-	file->store_32(1); // # version
+	file->store_32(PACK_HEADER_MAGIC); // MAGIC
+	file->store_32(PACK_FORMAT_VERSION); // # version
 	file->store_32(VERSION_MAJOR); // # major
 	file->store_32(VERSION_MINOR); // # minor
 	file->store_32(0); // # revision
@@ -86,7 +88,7 @@ Error PCKPacker::pck_start(const String &p_file, int p_alignment) {
 	return OK;
 };
 
-Error PCKPacker::add_file(const String &p_file, const String &p_src) {
+Error PCKPacker::add_file(const String &p_file, const String &p_src, bool p_compress) {
 
 	FileAccess *f = FileAccess::open(p_src, FileAccess::READ);
 	if (!f) {
@@ -97,7 +99,7 @@ Error PCKPacker::add_file(const String &p_file, const String &p_src) {
 	pf.path = p_file;
 	pf.src_path = p_src;
 	pf.size = f->get_len();
-	pf.offset_offset = 0;
+	pf.compress = p_compress;
 
 	files.push_back(pf);
 
@@ -114,22 +116,25 @@ Error PCKPacker::flush(bool p_verbose) {
 		return ERR_INVALID_PARAMETER;
 	};
 
-	// write the index
+	// write the index, records are filled in once the file offsets are known
+
+	Vector<CharString> paths;
+	uint32_t strings_size = 0;
+	for (int i = 0; i < files.size(); i++) {
+
+		paths.push_back(files[i].path.utf8());
+		strings_size += paths[i].length();
+	};
 
 	file->store_32(files.size());
+	file->store_32(strings_size);
 
-	for (int i = 0; i < files.size(); i++) {
+	uint64_t index_ofs = file->get_position();
+	_pad(file, files.size() * PACK_INDEX_ENTRY_SIZE);
 
-		file->store_pascal_string(files[i].path);
-		files.write[i].offset_offset = file->get_position();
-		file->store_64(0); // offset
-		file->store_64(files[i].size); // size
+	for (int i = 0; i < paths.size(); i++) {
 
-		// # empty md5
-		file->store_32(0);
-		file->store_32(0);
-		file->store_32(0);
-		file->store_32(0);
+		file->store_buffer((const uint8_t *)paths[i].get_data(), paths[i].length());
 	};
 
 	uint64_t ofs = file->get_position();
@@ -140,24 +145,60 @@ Error PCKPacker::flush(bool p_verbose) {
 	const uint32_t buf_max = 65536;
 	uint8_t *buf = memnew_arr(uint8_t, buf_max);
 
+	Vector<uint8_t> index;
+	index.resize(files.size() * PACK_INDEX_ENTRY_SIZE);
+	zeromem(index.ptrw(), index.size());
+
+	uint32_t path_ofs = 0;
 	int count = 0;
 	for (int i = 0; i < files.size(); i++) {
 
 		FileAccess *src = FileAccess::open(files[i].src_path, FileAccess::READ);
-		uint64_t to_write = files[i].size;
-		while (to_write > 0) {
+		uint64_t stored_size = files[i].size;
+		uint32_t flags = 0;
+
+		Vector<uint8_t> compressed;
+		if (files[i].compress && files[i].size > 0 && files[i].size <= 0x7FFFFFFF) {
+
+			Vector<uint8_t> data;
+			data.resize(files[i].size);
+			src->get_buffer(data.ptrw(), data.size());
+			compressed = PackedSourcePCK::compress_file_data(data.ptr(), data.size(), Compression::MODE_ZSTD);
+			if (compressed.size() > 0 && uint64_t(compressed.size()) < files[i].size) {
+				stored_size = compressed.size();
+				flags |= PACK_FILE_COMPRESSED;
+			} else {
+				src->seek(0); // not worth it, store as is
+			}
+		};
 
-			int read = src->get_buffer(buf, MIN(to_write, buf_max));
-			file->store_buffer(buf, read);
-			to_write -= read;
+		if (flags & PACK_FILE_COMPRESSED) {
+
+			file->store_buffer(compressed.ptr(), compressed.size());
+		} else {
+
+			uint64_t to_write = files[i].size;
+			while (to_write > 0) {
+
+				int read = src->get_buffer(buf, MIN(to_write, buf_max));
+				file->store_buffer(buf, read);
+				to_write -= read;
+			};
 		};
 
-		uint64_t pos = file->get_position();
-		file->seek(files[i].offset_offset); // go back to store the file's offset
-		file->store_64(ofs);
-		file->seek(pos);
+		uint8_t *entry = &index.write[i * PACK_INDEX_ENTRY_SIZE];
+		encode_uint64(ofs, &entry[0]);
+		encode_uint64(files[i].size, &entry[8]);
+		encode_uint64(stored_size, &entry[16]);
+		// md5 at 24 is left empty
+		encode_uint32(path_ofs, &entry[40]);
+		encode_uint32(paths[i].length(), &entry[44]);
+		encode_uint32(flags, &entry[48]);
+		encode_uint32(Compression::MODE_ZSTD, &entry[52]);
+		path_ofs += paths[i].length();
 
-		ofs = _align(ofs + files[i].size, alignment);
+		uint64_t pos = file->get_position();
+		ofs = _align(ofs + stored_size, alignment);
 		_pad(file, ofs - pos);
 
 		src->close();
@@ -174,8 +215,11 @@ Error PCKPacker::flush(bool p_verbose) {
 	if (p_verbose)
 		printf("\n");
 
+	file->seek(index_ofs); // go back to store the index
+	file->store_buffer(index.ptr(), index.size());
+
 	file->close();
-	memdelete(buf);
+	memdelete_arr(buf);
 
 	return OK;
 };
@@ -48,14 +48,14 @@ class PCKPacker : public Reference {
 
 		String path;
 		String src_path;
-		int size;
-		uint64_t offset_offset;
+		uint64_t size;
+		bool compress;
 	};
 	Vector<File> files;
 
 public:
 	Error pck_start(const String &p_file, int p_alignment);
-	Error add_file(const String &p_file, const String &p_src);
+	Error add_file(const String &p_file, const String &p_src, bool p_compress = false);
 	Error flush(bool p_verbose = false);
 
 	PCKPacker();
@@ -106,15 +106,9 @@ StringName ResourceInteractiveLoaderBinary::_get_string() {
 	uint32_t id = f->get_32();
 	if (id & 0x80000000) {
 		uint32_t len = id & 0x7FFFFFFF;
-		if (len > str_buf.size()) {
-			str_buf.resize(len);
-		}
 		if (len == 0)
 			return StringName();
-		f->get_buffer((uint8_t *)&str_buf[0], len);
-		String s;
-		s.parse_utf8(&str_buf[0]);
-		return s;
+		return _read_utf8(len);
 	}
 
 	return string_map[id];
@@ -804,13 +798,28 @@ static String get_ustring(FileAccess *f) {
 String ResourceInteractiveLoaderBinary::get_unicode_string() {
 
 	int len = f->get_32();
-	if (len > str_buf.size()) {
-		str_buf.resize(len);
-	}
 	if (len == 0)
 		return String();
-	f->get_buffer((uint8_t *)&str_buf[0], len);
+	return _read_utf8(len);
+}
+
+String ResourceInteractiveLoaderBinary::_read_utf8(uint32_t p_len) {
+
 	String s;
+
+	// Decode straight from the file mapping when there is one, skipping the copy to str_buf.
+	size_t pos = f->get_position();
+	const uint8_t *mapped = f->map_range(pos, p_len);
+	if (mapped) {
+		f->seek(pos + p_len);
+		s.parse_utf8((const char *)mapped, p_len);
+		return s;
+	}
+
+	if (p_len > (uint32_t)str_buf.size()) {
+		str_buf.resize(p_len);
+	}
+	f->get_buffer((uint8_t *)&str_buf[0], p_len);
 	s.parse_utf8(&str_buf[0]);
 	return s;
 }
@@ -71,6 +71,7 @@ class ResourceInteractiveLoaderBinary : public ResourceInteractiveLoader {
 	Vector<IntResource> internal_resources;
 
 	String get_unicode_string();
+	String _read_utf8(uint32_t p_len);
 	void _advance_padding(uint32_t p_len);
 
 	Map<String, String> remaps;
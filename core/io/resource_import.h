@@ -44,6 +44,7 @@ class ResourceFormatImporter : public ResourceFormatLoader {
 	};
 
 	Error _get_path_and_type(const String &p_path, PathAndType &r_path_and_type, bool *r_valid = NULL) const;
+	Ref<ResourceImporter> _get_importer_for_path(const String &p_path) const;
 
 	static ResourceFormatImporter *singleton;
 
@@ -62,6 +63,7 @@ public:
 
 	virtual bool can_be_imported(const String &p_path) const;
 	virtual int get_import_order(const String &p_path) const;
+	bool can_import_threaded(const String &p_path) const;
 
 	String get_internal_resource_path(const String &p_path) const;
 	void get_internal_resource_path_list(const String &p_path, List<String> *r_paths);
@@ -87,6 +89,10 @@ public:
 	virtual String get_resource_type() const = 0;
 	virtual float get_priority() const { return 1.0; }
 	virtual int get_import_order() const { return 0; }
+	virtual bool can_import_threaded() const { return false; } ///< true if import() may run on several threads at once
+	virtual int get_format_version() const { return 0; } ///< bump when the output of import() changes for the same input
+	virtual String get_import_settings_string() const { return String(); } ///< project settings affecting the import output
+	virtual bool can_cache_import() const { return false; } ///< true if the output depends only on the source file, the options and the import settings string
 
 	struct ImportOption {
 		PropertyInfo option;
@@ -217,13 +217,13 @@ void StreamPeer::put_utf8_string(const String &p_string) {
 }
 void StreamPeer::put_var(const Variant &p_variant) {
 
+	// encode after room for the length prefix, then send both at once
 	int len = 0;
 	Vector<uint8_t> buf;
-	encode_variant(p_variant, NULL, len);
-	buf.resize(len);
-	put_32(len);
-	encode_variant(p_variant, buf.ptrw(), len);
-	put_data(buf.ptr(), buf.size());
+	Error err = encode_variant(p_variant, buf, len, 4);
+	ERR_FAIL_COND(err != OK);
+	encode_uint32(big_endian ? BSWAP32(len) : len, buf.ptrw());
+	put_data(buf.ptr(), len + 4);
 }
 
 uint8_t StreamPeer::get_u8() {
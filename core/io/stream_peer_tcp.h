@@ -41,6 +41,8 @@ class StreamPeerTCP : public StreamPeer {
 	GDCLASS(StreamPeerTCP, StreamPeer);
 	OBJ_CATEGORY("Networking");
 
+	friend class NetworkPollGroup;
+
 public:
 	enum Status {
 
@@ -40,6 +40,8 @@ class TCP_Server : public Reference {
 
 	GDCLASS(TCP_Server, Reference);
 
+	friend class NetworkPollGroup;
+
 protected:
 	enum {
 		MAX_PENDING_CONNECTIONS = 8
@@ -1838,6 +1838,8 @@ bool Expression::_compile_expression() {
 		root = NULL;
 	}
 
+	_clear_program();
+
 	error_str = String();
 	error_set = false;
 	str_ofs = 0;
@@ -2084,6 +2086,475 @@ bool Expression::_execute(const Array &p_inputs, Object *p_instance, Expression:
 	return false;
 }
 
+bool Expression::_is_func_pure(BuiltinFunc p_func) {
+
+	switch (p_func) {
+		case MATH_RANDOMIZE:
+		case MATH_RAND:
+		case MATH_RANDF:
+		case MATH_RANDOM:
+		case MATH_SEED:
+		case MATH_RANDSEED:
+		case OBJ_WEAKREF:
+		case FUNC_FUNCREF:
+		case TEXT_PRINT:
+		case TEXT_PRINTERR:
+		case TEXT_PRINTRAW:
+			return false;
+		default: {
+		}
+	}
+
+	return true;
+}
+
+static _FORCE_INLINE_ bool _is_value_foldable(const Variant &p_value) {
+
+	// reference types would be shared between executions
+	return p_value.get_type() != Variant::OBJECT && p_value.get_type() != Variant::ARRAY && p_value.get_type() != Variant::DICTIONARY;
+}
+
+int Expression::_add_constant(const Variant &p_value) {
+
+	constants.push_back(p_value);
+	return ((constants.size() - 1) << ADDR_BITS) | ADDR_TYPE_CONSTANT;
+}
+
+int Expression::_add_name(const StringName &p_name) {
+
+	int idx = names.find(p_name);
+	if (idx == -1) {
+		idx = names.size();
+		names.push_back(p_name);
+	}
+	return idx;
+}
+
+bool Expression::_are_constants(const Vector<int> &p_addresses) {
+
+	for (int i = 0; i < p_addresses.size(); i++) {
+		if ((p_addresses[i] & ADDR_MASK) != ADDR_TYPE_CONSTANT)
+			return false;
+	}
+	return true;
+}
+
+int Expression::_compile_node(ENode *p_node, int &r_stack_top) {
+
+	switch (p_node->type) {
+		case ENode::TYPE_INPUT: {
+
+			const InputNode *in = static_cast<const InputNode *>(p_node);
+			return (in->index << ADDR_BITS) | ADDR_TYPE_INPUT;
+		} break;
+		case ENode::TYPE_CONSTANT: {
+
+			const ConstantNode *c = static_cast<const ConstantNode *>(p_node);
+			return _add_constant(c->value);
+		} break;
+		case ENode::TYPE_SELF: {
+
+			uses_self = true;
+			return ADDR_TYPE_SELF;
+		} break;
+		default: {
+		}
+	}
+
+	// everything else writes to a register of its own, operands use the ones above it
+
+	int dst = r_stack_top++;
+	if (r_stack_top > stack_size)
+		stack_size = r_stack_top;
+
+	Vector<int> args;
+	Variant folded;
+	bool fold = false;
+
+	switch (p_node->type) {
+		case ENode::TYPE_OPERATOR: {
+
+			const OperatorNode *op = static_cast<const OperatorNode *>(p_node);
+
+			int a = _compile_node(op->nodes[0], r_stack_top);
+			int b = op->nodes[1] ? _compile_node(op->nodes[1], r_stack_top) : ADDR_TYPE_CONSTANT; // constant 0 is null
+			args.push_back(a);
+			args.push_back(b);
+
+			if (_are_constants(args)) {
+				bool valid = true;
+				Variant::evaluate(op->op, constants[a >> ADDR_BITS], constants[b >> ADDR_BITS], folded, valid);
+				fold = valid && _is_value_foldable(folded);
+			}
+
+			if (!fold) {
+				code.push_back(OPCODE_OPERATOR);
+				code.push_back(op->op);
+				code.push_back(a);
+				code.push_back(b);
+			}
+		} break;
+		case ENode::TYPE_INDEX: {
+
+			const IndexNode *index = static_cast<const IndexNode *>(p_node);
+
+			args.push_back(_compile_node(index->base, r_stack_top));
+			args.push_back(_compile_node(index->index, r_stack_top));
+
+			if (_are_constants(args)) {
+				bool valid = false;
+				folded = constants[args[0] >> ADDR_BITS].get(constants[args[1] >> ADDR_BITS], &valid);
+				fold = valid && _is_value_foldable(folded);
+			}
+
+			if (!fold) {
+				code.push_back(OPCODE_INDEX);
+				code.push_back(args[0]);
+				code.push_back(args[1]);
+			}
+		} break;
+		case ENode::TYPE_NAMED_INDEX: {
+
+			const NamedIndexNode *index = static_cast<const NamedIndexNode *>(p_node);
+
+			args.push_back(_compile_node(index->base, r_stack_top));
+
+			if (_are_constants(args)) {
+				bool valid = false;
+				folded = constants[args[0] >> ADDR_BITS].get_named(index->name, &valid);
+				fold = valid && _is_value_foldable(folded);
+			}
+
+			if (!fold) {
+				code.push_back(OPCODE_NAMED_INDEX);
+				code.push_back(args[0]);
+				code.push_back(_add_name(index->name));
+			}
+		} break;
+		case ENode::TYPE_ARRAY: {
+
+			const ArrayNode *array = static_cast<const ArrayNode *>(p_node);
+
+			for (int i = 0; i < array->array.size(); i++) {
+				args.push_back(_compile_node(array->array[i], r_stack_top));
+			}
+
+			code.push_back(OPCODE_ARRAY);
+			code.push_back(args.size());
+			for (int i = 0; i < args.size(); i++) {
+				code.push_back(args[i]);
+			}
+		} break;
+		case ENode::TYPE_DICTIONARY: {
+
+			const DictionaryNode *dictionary = static_cast<const DictionaryNode *>(p_node);
+
+			for (int i = 0; i < dictionary->dict.size(); i++) {
+				args.push_back(_compile_node(dictionary->dict[i], r_stack_top));
+			}
+
+			code.push_back(OPCODE_DICTIONARY);
+			code.push_back(args.size());
+			for (int i = 0; i < args.size(); i++) {
+				code.push_back(args[i]);
+			}
+		} break;
+		case ENode::TYPE_CONSTRUCTOR: {
+
+			const ConstructorNode *constructor = static_cast<const ConstructorNode *>(p_node);
+
+			for (int i = 0; i < constructor->arguments.size(); i++) {
+				args.push_back(_compile_node(constructor->arguments[i], r_stack_top));
+			}
+
+			if (_are_constants(args)) {
+				Vector<const Variant *> argp;
+				for (int i = 0; i < args.size(); i++) {
+					argp.push_back(&constants[args[i] >> ADDR_BITS]);
+				}
+
+				Variant::CallError ce;
+				folded = Variant::construct(constructor->data_type, (const Variant **)argp.ptr(), argp.size(), ce);
+				fold = ce.error == Variant::CallError::CALL_OK && _is_value_foldable(folded);
+			}
+
+			if (!fold) {
+				code.push_back(OPCODE_CONSTRUCT);
+				code.push_back(constructor->data_type);
+				code.push_back(args.size());
+				for (int i = 0; i < args.size(); i++) {
+					code.push_back(args[i]);
+				}
+			}
+		} break;
+		case ENode::TYPE_BUILTIN_FUNC: {
+
+			const BuiltinFuncNode *bifunc = static_cast<const BuiltinFuncNode *>(p_node);
+
+			for (int i = 0; i < bifunc->arguments.size(); i++) {
+				args.push_back(_compile_node(bifunc->arguments[i], r_stack_top));
+			}
+
+			if (_is_func_pure(bifunc->func) && _are_constants(args)) {
+				Vector<const Variant *> argp;
+				for (int i = 0; i < args.size(); i++) {
+					argp.push_back(&constants[args[i] >> ADDR_BITS]);
+				}
+
+				Variant::CallError ce;
+				String error_txt;
+				exec_func(bifunc->func, (const Variant **)argp.ptr(), &folded, ce, error_txt);
+				fold = ce.error == Variant::CallError::CALL_OK && _is_value_foldable(folded);
+			}
+
+			if (!fold) {
+				code.push_back(OPCODE_BUILTIN_FUNC);
+				code.push_back(bifunc->func);
+				code.push_back(args.size());
+				for (int i = 0; i < args.size(); i++) {
+					code.push_back(args[i]);
+				}
+			}
+		} break;
+		case ENode::TYPE_CALL: {
+
+			const CallNode *call = static_cast<const CallNode *>(p_node);
+
+			int base = _compile_node(call->base, r_stack_top);
+			for (int i = 0; i < call->arguments.size(); i++) {
+				args.push_back(_compile_node(call->arguments[i], r_stack_top));
+			}
+
+			// methods may have side effects, so calls are never folded
+			code.push_back(OPCODE_CALL);
+			code.push_back(base);
+			code.push_back(_add_name(call->method));
+			code.push_back(args.size());
+			for (int i = 0; i < args.size(); i++) {
+				code.push_back(args[i]);
+			}
+		} break;
+		default: {
+		}
+	}
+
+	if (args.size() > max_call_args)
+		max_call_args = args.size();
+
+	r_stack_top = dst + 1;
+
+	if (fold) {
+		r_stack_top = dst;
+		return _add_constant(folded);
+	}
+
+	code.push_back(dst);
+	return (dst << ADDR_BITS) | ADDR_TYPE_STACK;
+}
+
+void Expression::_clear_program() {
+
+	code.clear();
+	constants.clear();
+	names.clear();
+	stack_size = 0;
+	max_call_args = 0;
+	uses_self = false;
+}
+
+void Expression::_compile() {
+
+	_clear_program();
+
+	constants.push_back(Variant()); // operand of unary operators
+
+	int stack_top = 0;
+	int result = _compile_node(root, stack_top);
+	code.push_back(OPCODE_END);
+	code.push_back(result);
+}
+
+const Variant *Expression::_get_operand(int p_address, const Array &p_inputs, const Variant &p_self, const Variant *p_stack) const {
+
+	int index = p_address >> ADDR_BITS;
+
+	switch (p_address & ADDR_MASK) {
+		case ADDR_TYPE_STACK: return &p_stack[index];
+		case ADDR_TYPE_CONSTANT: return &constants[index];
+		case ADDR_TYPE_INPUT: {
+			if (index >= p_inputs.size())
+				return NULL;
+			return &p_inputs[index];
+		}
+	}
+
+	return &p_self;
+}
+
+#define GET_OPERAND(m_var, m_address)                                                                      \
+	const Variant *m_var = _get_operand(m_address, p_inputs, p_self, p_stack);                             \
+	if (unlikely(!m_var)) {                                                                                \
+		r_error_str = vformat(RTR("Invalid input %i (not passed) in expression"), m_address >> ADDR_BITS); \
+		return true;                                                                                       \
+	}
+
+#define GET_ARGUMENTS(m_argc, m_from)     \
+	for (int i = 0; i < m_argc; i++) {    \
+		GET_OPERAND(arg, ip[m_from + i]); \
+		p_argp[i] = arg;                  \
+	}
+
+bool Expression::_run(const Array &p_inputs, const Variant &p_self, Variant *p_stack, const Variant **p_argp, Variant &r_ret, String &r_error_str) const {
+
+	const int *ip = code.ptr();
+
+	while (true) {
+
+		switch (ip[0]) {
+			case OPCODE_OPERATOR: {
+
+				Variant::Operator op = Variant::Operator(ip[1]);
+				GET_OPERAND(a, ip[2]);
+				GET_OPERAND(b, ip[3]);
+
+				bool valid = true;
+				Variant::evaluate(op, *a, *b, p_stack[ip[4]], valid);
+				if (!valid) {
+					r_error_str = vformat(RTR("Invalid operands to operator %s, %s and %s."), Variant::get_operator_name(op), Variant::get_type_name(a->get_type()), Variant::get_type_name(b->get_type()));
+					return true;
+				}
+
+				ip += 5;
+			} break;
+			case OPCODE_INDEX: {
+
+				GET_OPERAND(base, ip[1]);
+				GET_OPERAND(idx, ip[2]);
+
+				bool valid;
+				p_stack[ip[3]] = base->get(*idx, &valid);
+				if (!valid) {
+					r_error_str = vformat(RTR("Invalid index of type %s for base type %s"), Variant::get_type_name(idx->get_type()), Variant::get_type_name(base->get_type()));
+					return true;
+				}
+
+				ip += 4;
+			} break;
+			case OPCODE_NAMED_INDEX: {
+
+				GET_OPERAND(base, ip[1]);
+				const StringName &name = names[ip[2]];
+
+				bool valid;
+				p_stack[ip[3]] = base->get_named(name, &valid);
+				if (!valid) {
+					r_error_str = vformat(RTR("Invalid named index '%s' for base type %s"), String(name), Variant::get_type_name(base->get_type()));
+					return true;
+				}
+
+				ip += 4;
+			} break;
+			case OPCODE_ARRAY: {
+
+				int argc = ip[1];
+
+				Array arr;
+				arr.resize(argc);
+				for (int i = 0; i < argc; i++) {
+					GET_OPERAND(value, ip[2 + i]);
+					arr[i] = *value;
+				}
+
+				p_stack[ip[2 + argc]] = arr;
+				ip += 3 + argc;
+			} break;
+			case OPCODE_DICTIONARY: {
+
+				int argc = ip[1];
+
+				Dictionary d;
+				for (int i = 0; i < argc; i += 2) {
+					GET_OPERAND(key, ip[2 + i]);
+					GET_OPERAND(value, ip[3 + i]);
+					d[*key] = *value;
+				}
+
+				p_stack[ip[2 + argc]] = d;
+				ip += 3 + argc;
+			} break;
+			case OPCODE_CONSTRUCT: {
+
+				Variant::Type type = Variant::Type(ip[1]);
+				int argc = ip[2];
+				GET_ARGUMENTS(argc, 3);
+
+				Variant::CallError ce;
+				p_stack[ip[3 + argc]] = Variant::construct(type, p_argp, argc, ce);
+				if (ce.error != Variant::CallError::CALL_OK) {
+					r_error_str = vformat(RTR("Invalid arguments to construct '%s'"), Variant::get_type_name(type));
+					return true;
+				}
+
+				ip += 4 + argc;
+			} break;
+			case OPCODE_BUILTIN_FUNC: {
+
+				BuiltinFunc func = BuiltinFunc(ip[1]);
+				int argc = ip[2];
+				GET_ARGUMENTS(argc, 3);
+
+				Variant::CallError ce;
+				exec_func(func, p_argp, &p_stack[ip[3 + argc]], ce, r_error_str);
+				if (ce.error != Variant::CallError::CALL_OK) {
+					r_error_str = "Builtin Call Failed. " + r_error_str;
+					return true;
+				}
+
+				ip += 4 + argc;
+			} break;
+			case OPCODE_CALL: {
+
+				const StringName &method = names[ip[2]];
+				int argc = ip[3];
+				GET_ARGUMENTS(argc, 4);
+
+				Variant::CallError ce;
+				int base_address = ip[1];
+				if ((base_address & ADDR_MASK) == ADDR_TYPE_STACK) {
+					// temporaries belong to this call, no need to copy them
+					p_stack[ip[4 + argc]] = p_stack[base_address >> ADDR_BITS].call(method, p_argp, argc, ce);
+				} else {
+					GET_OPERAND(base_ptr, base_address);
+					Variant base = *base_ptr;
+					p_stack[ip[4 + argc]] = base.call(method, p_argp, argc, ce);
+				}
+
+				if (ce.error != Variant::CallError::CALL_OK) {
+					r_error_str = vformat(RTR("On call to '%s':"), String(method));
+					return true;
+				}
+
+				ip += 5 + argc;
+			} break;
+			case OPCODE_END: {
+
+				GET_OPERAND(result, ip[1]);
+				r_ret = *result;
+				return false;
+			} break;
+			default: {
+				r_error_str = "Invalid opcode in compiled expression (bug)";
+				return true;
+			}
+		}
+	}
+
+	return false;
+}
+
+#undef GET_ARGUMENTS
+#undef GET_OPERAND
+
 Error Expression::parse(const String &p_expression, const Vector<String> &p_input_names) {
 
 	if (nodes) {
@@ -2092,6 +2563,8 @@ Error Expression::parse(const String &p_expression, const Vector<String> &p_inpu
 		root = NULL;
 	}
 
+	_clear_program();
+
 	error_str = String();
 	error_set = false;
 	str_ofs = 0;
@@ -2109,11 +2582,116 @@ Error Expression::parse(const String &p_expression, const Vector<String> &p_inpu
 		return ERR_INVALID_PARAMETER;
 	}
 
+	_compile();
+
 	return OK;
 }
 
 Variant Expression::execute(Array p_inputs, Object *p_base, bool p_show_error) {
 
+	ERR_FAIL_COND_V(code.empty(), Variant());
+
+	execution_error = false;
+	Variant output;
+	String error_txt;
+	bool err = true;
+
+	if (uses_self && !p_base) {
+		error_txt = RTR("self can't be used because instance is null (not passed)");
+	} else {
+		Variant self;
+		if (uses_self)
+			self = p_base;
+
+		Variant *stack = (Variant *)alloca(sizeof(Variant) * MAX(stack_size, 1));
+		for (int i = 0; i < stack_size; i++) {
+			memnew_placement(&stack[i], Variant);
+		}
+		const Variant **argp = (const Variant **)alloca(sizeof(Variant *) * MAX(max_call_args, 1));
+
+		err = _run(p_inputs, self, stack, argp, output, error_txt);
+
+		for (int i = 0; i < stack_size; i++) {
+			stack[i].~Variant();
+		}
+	}
+
+	if (err) {
+		execution_error = true;
+		error_str = error_txt;
+		if (p_show_error) {
+			ERR_EXPLAIN(error_str);
+			ERR_FAIL_V(Variant());
+		}
+	}
+
+	return output;
+}
+
+Array Expression::execute_batch(Array p_inputs_list, Object *p_base, bool p_show_error) {
+
+	ERR_FAIL_COND_V(code.empty(), Array());
+
+	execution_error = false;
+	Array outputs;
+	String error_txt;
+	bool err = false;
+
+	if (uses_self && !p_base) {
+		error_txt = RTR("self can't be used because instance is null (not passed)");
+		err = true;
+	} else {
+		Variant self;
+		if (uses_self)
+			self = p_base;
+
+		// registers are set up once and reused for every set of inputs
+		Variant *stack = (Variant *)alloca(sizeof(Variant) * MAX(stack_size, 1));
+		for (int i = 0; i < stack_size; i++) {
+			memnew_placement(&stack[i], Variant);
+		}
+		const Variant **argp = (const Variant **)alloca(sizeof(Variant *) * MAX(max_call_args, 1));
+
+		outputs.resize(p_inputs_list.size());
+		for (int i = 0; i < p_inputs_list.size(); i++) {
+
+			const Variant &inputs = p_inputs_list[i];
+			if (inputs.get_type() != Variant::ARRAY) {
+				error_txt = vformat(RTR("Inputs at index %d are not an Array"), i);
+				err = true;
+				break;
+			}
+
+			Variant output;
+			if (_run(inputs, self, stack, argp, output, error_txt)) {
+				err = true;
+				break;
+			}
+			outputs[i] = output;
+		}
+
+		for (int i = 0; i < stack_size; i++) {
+			stack[i].~Variant();
+		}
+	}
+
+	if (err) {
+		execution_error = true;
+		error_str = error_txt;
+		if (p_show_error) {
+			ERR_EXPLAIN(error_str);
+			ERR_FAIL_V(Array());
+		}
+		return Array();
+	}
+
+	return outputs;
+}
+
+Variant Expression::execute_tree(Array p_inputs, Object *p_base, bool p_show_error) {
+
+	ERR_FAIL_COND_V(!root, Variant());
+
 	execution_error = false;
 	Variant output;
 	String error_txt;
@@ -2142,6 +2720,7 @@ void Expression::_bind_methods() {
 
 	ClassDB::bind_method(D_METHOD("parse", "expression", "input_names"), &Expression::parse, DEFVAL(Vector<String>()));
 	ClassDB::bind_method(D_METHOD("execute", "inputs", "base_instance", "show_error"), &Expression::execute, DEFVAL(Array()), DEFVAL(Variant()), DEFVAL(true));
+	ClassDB::bind_method(D_METHOD("execute_batch", "inputs_list", "base_instance", "show_error"), &Expression::execute_batch, DEFVAL(Variant()), DEFVAL(true));
 	ClassDB::bind_method(D_METHOD("has_execute_failed"), &Expression::has_execute_failed);
 	ClassDB::bind_method(D_METHOD("get_error_text"), &Expression::get_error_text);
 }
@@ -2153,6 +2732,9 @@ Expression::Expression() {
 	nodes = NULL;
 	sequenced = false;
 	execution_error = false;
+	stack_size = 0;
+	max_call_args = 0;
+	uses_self = false;
 }
 
 Expression::~Expression() {
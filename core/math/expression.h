@@ -339,12 +339,57 @@ private:
 	bool execution_error;
 	bool _execute(const Array &p_inputs, Object *p_instance, Expression::ENode *p_node, Variant &r_ret, String &r_error_str);
 
+	// The parsed tree is compiled into a flat, register based program.
+	// Every operand is an address whose low bits tell where the value lives.
+
+	enum Opcode {
+		OPCODE_OPERATOR, // op, operator, a, b, dst
+		OPCODE_INDEX, // op, base, index, dst
+		OPCODE_NAMED_INDEX, // op, base, name, dst
+		OPCODE_ARRAY, // op, argc, args..., dst
+		OPCODE_DICTIONARY, // op, argc, args..., dst
+		OPCODE_CONSTRUCT, // op, type, argc, args..., dst
+		OPCODE_BUILTIN_FUNC, // op, func, argc, args..., dst
+		OPCODE_CALL, // op, base, name, argc, args..., dst
+		OPCODE_END // op, result
+	};
+
+	enum Address {
+		ADDR_BITS = 2,
+		ADDR_MASK = (1 << ADDR_BITS) - 1,
+		ADDR_TYPE_STACK = 0,
+		ADDR_TYPE_CONSTANT = 1,
+		ADDR_TYPE_INPUT = 2,
+		ADDR_TYPE_SELF = 3
+	};
+
+	Vector<int> code;
+	Vector<Variant> constants;
+	Vector<StringName> names;
+	int stack_size;
+	int max_call_args;
+	bool uses_self;
+
+	static bool _is_func_pure(BuiltinFunc p_func);
+
+	int _add_constant(const Variant &p_value);
+	int _add_name(const StringName &p_name);
+	static bool _are_constants(const Vector<int> &p_addresses);
+	int _compile_node(ENode *p_node, int &r_stack_top);
+	void _compile();
+	void _clear_program();
+
+	_FORCE_INLINE_ const Variant *_get_operand(int p_address, const Array &p_inputs, const Variant &p_self, const Variant *p_stack) const;
+	bool _run(const Array &p_inputs, const Variant &p_self, Variant *p_stack, const Variant **p_argp, Variant &r_ret, String &r_error_str) const;
+
 protected:
 	static void _bind_methods();
 
 public:
 	Error parse(const String &p_expression, const Vector<String> &p_input_names = Vector<String>());
 	Variant execute(Array p_inputs, Object *p_base = NULL, bool p_show_error = true);
+	Array execute_batch(Array p_inputs_list, Object *p_base = NULL, bool p_show_error = true);
+	Variant execute_tree(Array p_inputs, Object *p_base = NULL, bool p_show_error = true); // walks the parsed tree instead of the program, kept as a reference
 	bool has_execute_failed() const;
 	String get_error_text() const;
 
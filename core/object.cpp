@@ -386,6 +386,7 @@ bool Object::_predelete() {
 	notification(NOTIFICATION_PREDELETE, true);
 	if (_predelete_ok) {
 		_class_ptr = NULL; //must restore so destructors can access class ptr correctly
+		_class_info = NULL;
 	}
 	return _predelete_ok;
 }
@@ -795,7 +796,7 @@ void Object::call_multilevel(const StringName &p_method, const Variant **p_args,
 		//_test_call_error(p_method,error);
 	}
 
-	MethodBind *method = ClassDB::get_method(get_class_name(), p_method);
+	MethodBind *method = ClassDB::get_object_method(this, p_method);
 
 	if (method) {
 
@@ -806,7 +807,7 @@ void Object::call_multilevel(const StringName &p_method, const Variant **p_args,
 
 void Object::call_multilevel_reversed(const StringName &p_method, const Variant **p_args, int p_argcount) {
 
-	MethodBind *method = ClassDB::get_method(get_class_name(), p_method);
+	MethodBind *method = ClassDB::get_object_method(this, p_method);
 
 	Variant::CallError error;
 	OBJ_DEBUG_LOCK
@@ -835,7 +836,7 @@ bool Object::has_method(const StringName &p_method) const {
 		return true;
 	}
 
-	MethodBind *method = ClassDB::get_method(get_class_name(), p_method);
+	MethodBind *method = ClassDB::get_object_method(this, p_method);
 
 	if (method) {
 		return true;
@@ -961,7 +962,7 @@ Variant Object::call(const StringName &p_method, const Variant **p_args, int p_a
 		}
 	}
 
-	MethodBind *method = ClassDB::get_method(get_class_name(), p_method);
+	MethodBind *method = ClassDB::get_object_method(this, p_method);
 
 	if (method) {
 
@@ -1929,6 +1930,7 @@ void *Object::get_script_instance_binding(int p_script_language_index) {
 Object::Object() {
 
 	_class_ptr = NULL;
+	_class_info = NULL;
 	_block_signals = false;
 	_predelete_ok = 0;
 	_instance_ID = 0;
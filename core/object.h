@@ -478,6 +478,7 @@ private:
 	Dictionary metadata;
 	mutable StringName _class_name;
 	mutable const StringName *_class_ptr;
+	mutable void *_class_info; //ClassDB::ClassInfo, cached on first lookup once the class is final
 
 	void _add_user_signal(const String &p_name, const Array &p_args = Array());
 	bool _has_user_signal(const StringName &p_name) const;
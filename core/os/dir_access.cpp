@@ -309,11 +309,16 @@ Error DirAccess::copy(String p_from, String p_to, int p_chmod_flags) {
 		return err;
 	}
 
+	const int copy_buffer_limit = 65536;
+
 	fsrc->seek_end(0);
 	int size = fsrc->get_position();
 	fsrc->seek(0);
 	err = OK;
-	while (size--) {
+
+	Vector<uint8_t> buffer;
+	buffer.resize(MIN(size, copy_buffer_limit));
+	while (size > 0) {
 
 		if (fsrc->get_error() != OK) {
 			err = fsrc->get_error();
@@ -324,7 +329,14 @@ Error DirAccess::copy(String p_from, String p_to, int p_chmod_flags) {
 			break;
 		}
 
-		fdst->store_8(fsrc->get_8());
+		int bytes_read = fsrc->get_buffer(buffer.ptrw(), MIN(size, buffer.size()));
+		if (bytes_read <= 0) {
+			err = FAILED;
+			break;
+		}
+		fdst->store_buffer(buffer.ptr(), bytes_read);
+
+		size -= bytes_read;
 	}
 
 	if (err == OK && p_chmod_flags != -1) {
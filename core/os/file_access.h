@@ -110,6 +110,8 @@ public:
 	virtual real_t get_real() const;
 
 	virtual int get_buffer(uint8_t *p_dst, int p_length) const; ///< get an array of bytes
+	virtual const uint8_t *map_range(size_t p_offset, size_t p_length) const { return NULL; } ///< read-only view of file contents, valid while the file is open; NULL if the range can't be mapped
+	virtual Error map_contents() { return ERR_UNAVAILABLE; } ///< opt-in, serve reads of a file opened for READ from a memory mapping; only for files nothing rewrites while open (packs), truncating a mapped file crashes readers
 	virtual String get_line() const;
 	virtual String get_token() const;
 	virtual Vector<String> get_csv_line(String delim = ",") const;
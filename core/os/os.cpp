@@ -68,6 +68,7 @@ void OS::debug_break(){
 
 void OS::_set_logger(CompositeLogger *p_logger) {
 	if (_logger) {
+		_async_logger = NULL;
 		memdelete(_logger);
 	}
 	_logger = p_logger;
@@ -83,13 +84,37 @@ void OS::add_logger(Logger *p_logger) {
 	}
 }
 
+void OS::set_async_logging(int p_queue_size, int p_flush_interval_msec) {
+
+	ERR_FAIL_COND(!_logger);
+
+	// everything logged so far goes through the background thread from now on
+	Vector<Logger *> loggers = _logger->release_loggers();
+	_async_logger = memnew(AsyncLogger(loggers, p_queue_size, p_flush_interval_msec));
+	_logger->add_logger(_async_logger);
+}
+
+void OS::stop_async_logging() {
+
+	// the writer thread uses the OS, so it has to be stopped before the platform OS is destroyed
+	if (_async_logger) {
+		_async_logger->stop();
+	}
+}
+
 void OS::print_error(const char *p_function, const char *p_file, int p_line, const char *p_code, const char *p_rationale, Logger::ErrorType p_type) {
 
+	if (!Logger::is_error_enabled(p_type))
+		return;
+
 	_logger->log_error(p_function, p_file, p_line, p_code, p_rationale, p_type);
 }
 
 void OS::print(const char *p_format, ...) {
 
+	if (!Logger::is_level_enabled(Logger::CATEGORY_ENGINE, Logger::LEVEL_INFO))
+		return;
+
 	va_list argp;
 	va_start(argp, p_format);
 
@@ -99,6 +124,10 @@ void OS::print(const char *p_format, ...) {
 };
 
 void OS::printerr(const char *p_format, ...) {
+
+	if (!Logger::is_level_enabled(Logger::CATEGORY_ENGINE, Logger::LEVEL_ERROR))
+		return;
+
 	va_list argp;
 	va_start(argp, p_format);
 
@@ -107,6 +136,12 @@ void OS::printerr(const char *p_format, ...) {
 	va_end(argp);
 };
 
+void OS::flush_log() {
+
+	if (_logger)
+		_logger->flush();
+}
+
 void OS::set_keep_screen_on(bool p_enabled) {
 	_keep_screen_on = p_enabled;
 }
@@ -725,6 +760,7 @@ OS::OS() {
 	_stack_bottom = (void *)(&stack_bottom);
 
 	_logger = NULL;
+	_async_logger = NULL;
 
 	Vector<Logger *> loggers;
 	loggers.push_back(memnew(StdLogger));
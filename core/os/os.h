@@ -74,6 +74,7 @@ class OS {
 	void *_stack_bottom;
 
 	CompositeLogger *_logger;
+	AsyncLogger *_async_logger;
 
 	bool restart_on_exit;
 	List<String> restart_commandline;
@@ -131,6 +132,8 @@ protected:
 
 	// functions used by main to initialize/deinitialize the OS
 	void add_logger(Logger *p_logger);
+	void set_async_logging(int p_queue_size, int p_flush_interval_msec);
+	void stop_async_logging();
 
 	virtual void initialize_core() = 0;
 	virtual Error initialize(const VideoMode &p_desired, int p_video_driver, int p_audio_driver) = 0;
@@ -154,6 +157,7 @@ public:
 	void print_error(const char *p_function, const char *p_file, int p_line, const char *p_code, const char *p_rationale, Logger::ErrorType p_type = Logger::ERR_ERROR);
 	void print(const char *p_format, ...);
 	void printerr(const char *p_format, ...);
+	void flush_log();
 
 	virtual void alert(const String &p_alert, const String &p_title = "ALERT!") = 0;
 	virtual String get_stdin_string(bool p_block = true) = 0;
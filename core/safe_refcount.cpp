@@ -166,4 +166,8 @@ uint64_t atomic_add(volatile uint64_t *pw, volatile uint64_t val) {
 uint64_t atomic_exchange_if_greater(volatile uint64_t *pw, volatile uint64_t val) {
 	return _atomic_exchange_if_greater_impl(pw, val);
 }
+
+void *atomic_exchange_ptr(void *volatile *pw, void *val) {
+	return InterlockedExchangePointer((PVOID volatile *)pw, val);
+}
 #endif
@@ -93,6 +93,14 @@ static _ALWAYS_INLINE_ T atomic_exchange_if_greater(volatile T *pw, volatile V v
 	return *pw;
 }
 
+static _ALWAYS_INLINE_ void *atomic_exchange_ptr(void *volatile *pw, void *val) {
+
+	void *old = *pw;
+	*pw = val;
+
+	return old;
+}
+
 #elif defined(__GNUC__)
 
 /* Implementation for GCC & Clang */
@@ -148,6 +156,16 @@ static _ALWAYS_INLINE_ T atomic_exchange_if_greater(volatile T *pw, volatile V v
 	}
 }
 
+// full barrier, what was written before the exchange is visible to whoever reads the new pointer
+static _ALWAYS_INLINE_ void *atomic_exchange_ptr(void *volatile *pw, void *val) {
+
+	while (true) {
+		void *tmp = *pw;
+		if (__sync_val_compare_and_swap(pw, tmp, val) == tmp)
+			return tmp;
+	}
+}
+
 #elif defined(_MSC_VER)
 // For MSVC use a separate compilation unit to prevent windows.h from polluting
 // the global namespace.
@@ -165,6 +183,8 @@ uint64_t atomic_sub(volatile uint64_t *pw, volatile uint64_t val);
 uint64_t atomic_add(volatile uint64_t *pw, volatile uint64_t val);
 uint64_t atomic_exchange_if_greater(volatile uint64_t *pw, volatile uint64_t val);
 
+void *atomic_exchange_ptr(void *volatile *pw, void *val);
+
 #else
 //no threads supported?
 #error Must provide atomic functions for this platform or compiler!
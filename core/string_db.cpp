@@ -39,57 +39,114 @@ StaticCString StaticCString::create(const char *p_ptr) {
 	return scs;
 }
 
-StringName::_Data *StringName::_table[STRING_TABLE_LEN];
+StringName::_Shard StringName::_shards[STRING_TABLE_SHARDS];
 
 StringName _scs_create(const char *p_chr) {
 
-	return (p_chr[0] ? StringName(StaticCString::create(p_chr)) : StringName());
+	// names created from literals live as long as the program, so they are pinned and never freed
+	return (p_chr[0] ? StringName(StaticCString::create(p_chr), true) : StringName());
 }
 
 bool StringName::configured = false;
-Mutex *StringName::lock = NULL;
 
 void StringName::setup() {
 
-	lock = Mutex::create();
-
 	ERR_FAIL_COND(configured);
-	for (int i = 0; i < STRING_TABLE_LEN; i++) {
-
-		_table[i] = NULL;
+	for (int i = 0; i < STRING_TABLE_SHARDS; i++) {
+
+		_Shard &shard = _shards[i];
+		shard.lock = Mutex::create();
+		shard.mask = (1 << STRING_TABLE_MIN_BITS) - 1;
+		shard.count = 0;
+		shard.table = memnew_arr(_Data *, shard.mask + 1);
+		for (uint32_t j = 0; j <= shard.mask; j++) {
+			shard.table[j] = NULL;
+		}
 	}
 	configured = true;
 }
 
 void StringName::cleanup() {
 
-	lock->lock();
-
 	int lost_strings = 0;
-	for (int i = 0; i < STRING_TABLE_LEN; i++) {
+	for (int i = 0; i < STRING_TABLE_SHARDS; i++) {
 
-		while (_table[i]) {
+		_Shard &shard = _shards[i];
+		shard.lock->lock();
 
-			_Data *d = _table[i];
-			lost_strings++;
-			if (OS::get_singleton()->is_stdout_verbose()) {
-				if (d->cname) {
-					print_line("Orphan StringName: " + String(d->cname));
-				} else {
-					print_line("Orphan StringName: " + String(d->name));
+		for (uint32_t j = 0; j <= shard.mask; j++) {
+
+			while (shard.table[j]) {
+
+				_Data *d = shard.table[j];
+				if (!d->is_static || d->refcount.get() > 1) {
+					lost_strings++;
+					if (OS::get_singleton()->is_stdout_verbose()) {
+						if (d->cname) {
+							print_line("Orphan StringName: " + String(d->cname));
+						} else {
+							print_line("Orphan StringName: " + String(d->name));
+						}
+					}
 				}
-			}
 
-			_table[i] = _table[i]->next;
-			memdelete(d);
+				shard.table[j] = shard.table[j]->next;
+				memdelete(d);
+			}
 		}
+
+		memdelete_arr(shard.table);
+		shard.table = NULL;
+		shard.count = 0;
+		shard.lock->unlock();
+
+		memdelete(shard.lock);
+		shard.lock = NULL;
 	}
 	if (lost_strings) {
 		print_verbose("StringName: " + itos(lost_strings) + " unclaimed string names at exit.");
 	}
-	lock->unlock();
+}
+
+void StringName::_insert(_Shard &p_shard, _Data *p_data) {
+
+	// keep chains short, rehashing only this shard while its lock is held
+	if (p_shard.count > p_shard.mask) {
+
+		uint32_t new_mask = (p_shard.mask << 1) | 1;
+		_Data **new_table = memnew_arr(_Data *, new_mask + 1);
+		for (uint32_t i = 0; i <= new_mask; i++) {
+			new_table[i] = NULL;
+		}
+
+		for (uint32_t i = 0; i <= p_shard.mask; i++) {
+
+			while (p_shard.table[i]) {
+
+				_Data *d = p_shard.table[i];
+				p_shard.table[i] = d->next;
+
+				uint32_t idx = d->hash & new_mask;
+				d->prev = NULL;
+				d->next = new_table[idx];
+				if (new_table[idx])
+					new_table[idx]->prev = d;
+				new_table[idx] = d;
+			}
+		}
+
+		memdelete_arr(p_shard.table);
+		p_shard.table = new_table;
+		p_shard.mask = new_mask;
+	}
 
-	memdelete(lock);
+	uint32_t idx = p_data->hash & p_shard.mask;
+	p_data->next = p_shard.table[idx];
+	p_data->prev = NULL;
+	if (p_shard.table[idx])
+		p_shard.table[idx]->prev = p_data;
+	p_shard.table[idx] = p_data;
+	p_shard.count++;
 }
 
 void StringName::unref() {
@@ -98,22 +155,25 @@ void StringName::unref() {
 
 	if (_data && _data->refcount.unref()) {
 
-		lock->lock();
+		_Shard &shard = _get_shard(_data->hash);
+		shard.lock->lock();
 
 		if (_data->prev) {
 			_data->prev->next = _data->next;
 		} else {
-			if (_table[_data->idx] != _data) {
+			uint32_t idx = _data->hash & shard.mask;
+			if (shard.table[idx] != _data) {
 				ERR_PRINT("BUG!");
 			}
-			_table[_data->idx] = _data->next;
+			shard.table[idx] = _data->next;
 		}
 
 		if (_data->next) {
 			_data->next->prev = _data->prev;
 		}
+		shard.count--;
 		memdelete(_data);
-		lock->unlock();
+		shard.lock->unlock();
 	}
 
 	_data = NULL;
@@ -184,13 +244,12 @@ StringName::StringName(const char *p_name) {
 	if (!p_name || p_name[0] == 0)
 		return; //empty, ignore
 
-	lock->lock();
-
 	uint32_t hash = String::hash(p_name);
 
-	uint32_t idx = hash & STRING_TABLE_MASK;
+	_Shard &shard = _get_shard(hash);
+	shard.lock->lock();
 
-	_data = _table[idx];
+	_data = shard.table[hash & shard.mask];
 
 	while (_data) {
 
@@ -203,7 +262,7 @@ StringName::StringName(const char *p_name) {
 	if (_data) {
 		if (_data->refcount.ref()) {
 			// exists
-			lock->unlock();
+			shard.lock->unlock();
 			return;
 		} else {
 		}
@@ -213,18 +272,13 @@ StringName::StringName(const char *p_name) {
 	_data->name = p_name;
 	_data->refcount.init();
 	_data->hash = hash;
-	_data->idx = idx;
 	_data->cname = NULL;
-	_data->next = _table[idx];
-	_data->prev = NULL;
-	if (_table[idx])
-		_table[idx]->prev = _data;
-	_table[idx] = _data;
+	_insert(shard, _data);
 
-	lock->unlock();
+	shard.lock->unlock();
 }
 
-StringName::StringName(const StaticCString &p_static_string) {
+StringName::StringName(const StaticCString &p_static_string, bool p_static) {
 
 	_data = NULL;
 
@@ -232,18 +286,17 @@ StringName::StringName(const StaticCString &p_static_string) {
 
 	ERR_FAIL_COND(!p_static_string.ptr || !p_static_string.ptr[0]);
 
-	lock->lock();
-
 	uint32_t hash = String::hash(p_static_string.ptr);
 
-	uint32_t idx = hash & STRING_TABLE_MASK;
+	_Shard &shard = _get_shard(hash);
+	shard.lock->lock();
 
-	_data = _table[idx];
+	_data = shard.table[hash & shard.mask];
 
 	while (_data) {
 
-		// compare hash first
-		if (_data->hash == hash && _data->get_name() == p_static_string.ptr)
+		// compare hash first, the same literal is usually found by its pointer
+		if (_data->hash == hash && (_data->cname == p_static_string.ptr || _data->get_name() == p_static_string.ptr))
 			break;
 		_data = _data->next;
 	}
@@ -251,7 +304,11 @@ StringName::StringName(const StaticCString &p_static_string) {
 	if (_data) {
 		if (_data->refcount.ref()) {
 			// exists
-			lock->unlock();
+			if (p_static && !_data->is_static) {
+				_data->is_static = true;
+				_data->refcount.ref();
+			}
+			shard.lock->unlock();
 			return;
 		} else {
 		}
@@ -261,15 +318,15 @@ StringName::StringName(const StaticCString &p_static_string) {
 
 	_data->refcount.init();
 	_data->hash = hash;
-	_data->idx = idx;
 	_data->cname = p_static_string.ptr;
-	_data->next = _table[idx];
-	_data->prev = NULL;
-	if (_table[idx])
-		_table[idx]->prev = _data;
-	_table[idx] = _data;
+	if (p_static) {
+		// the extra reference keeps the name alive, so dropping copies of it never takes the lock
+		_data->is_static = true;
+		_data->refcount.ref();
+	}
+	_insert(shard, _data);
 
-	lock->unlock();
+	shard.lock->unlock();
 }
 
 StringName::StringName(const String &p_name) {
@@ -281,13 +338,12 @@ StringName::StringName(const String &p_name) {
 	if (p_name == String())
 		return;
 
-	lock->lock();
-
 	uint32_t hash = p_name.hash();
 
-	uint32_t idx = hash & STRING_TABLE_MASK;
+	_Shard &shard = _get_shard(hash);
+	shard.lock->lock();
 
-	_data = _table[idx];
+	_data = shard.table[hash & shard.mask];
 
 	while (_data) {
 
@@ -299,7 +355,7 @@ StringName::StringName(const String &p_name) {
 	if (_data) {
 		if (_data->refcount.ref()) {
 			// exists
-			lock->unlock();
+			shard.lock->unlock();
 			return;
 		} else {
 		}
@@ -309,15 +365,10 @@ StringName::StringName(const String &p_name) {
 	_data->name = p_name;
 	_data->refcount.init();
 	_data->hash = hash;
-	_data->idx = idx;
 	_data->cname = NULL;
-	_data->next = _table[idx];
-	_data->prev = NULL;
-	if (_table[idx])
-		_table[idx]->prev = _data;
-	_table[idx] = _data;
+	_insert(shard, _data);
 
-	lock->unlock();
+	shard.lock->unlock();
 }
 
 StringName StringName::search(const char *p_name) {
@@ -328,13 +379,12 @@ StringName StringName::search(const char *p_name) {
 	if (!p_name[0])
 		return StringName();
 
-	lock->lock();
-
 	uint32_t hash = String::hash(p_name);
 
-	uint32_t idx = hash & STRING_TABLE_MASK;
+	_Shard &shard = _get_shard(hash);
+	shard.lock->lock();
 
-	_Data *_data = _table[idx];
+	_Data *_data = shard.table[hash & shard.mask];
 
 	while (_data) {
 
@@ -345,12 +395,12 @@ StringName StringName::search(const char *p_name) {
 	}
 
 	if (_data && _data->refcount.ref()) {
-		lock->unlock();
+		shard.lock->unlock();
 
 		return StringName(_data);
 	}
 
-	lock->unlock();
+	shard.lock->unlock();
 	return StringName(); //does not exist
 }
 
@@ -362,13 +412,12 @@ StringName StringName::search(const CharType *p_name) {
 	if (!p_name[0])
 		return StringName();
 
-	lock->lock();
-
 	uint32_t hash = String::hash(p_name);
 
-	uint32_t idx = hash & STRING_TABLE_MASK;
+	_Shard &shard = _get_shard(hash);
+	shard.lock->lock();
 
-	_Data *_data = _table[idx];
+	_Data *_data = shard.table[hash & shard.mask];
 
 	while (_data) {
 
@@ -379,24 +428,23 @@ StringName StringName::search(const CharType *p_name) {
 	}
 
 	if (_data && _data->refcount.ref()) {
-		lock->unlock();
+		shard.lock->unlock();
 		return StringName(_data);
 	}
 
-	lock->unlock();
+	shard.lock->unlock();
 	return StringName(); //does not exist
 }
 StringName StringName::search(const String &p_name) {
 
 	ERR_FAIL_COND_V(p_name == "", StringName());
 
-	lock->lock();
-
 	uint32_t hash = p_name.hash();
 
-	uint32_t idx = hash & STRING_TABLE_MASK;
+	_Shard &shard = _get_shard(hash);
+	shard.lock->lock();
 
-	_Data *_data = _table[idx];
+	_Data *_data = shard.table[hash & shard.mask];
 
 	while (_data) {
 
@@ -407,11 +455,11 @@ StringName StringName::search(const String &p_name) {
 	}
 
 	if (_data && _data->refcount.ref()) {
-		lock->unlock();
+		shard.lock->unlock();
 		return StringName(_data);
 	}
 
-	lock->unlock();
+	shard.lock->unlock();
 	return StringName(); //does not exist
 }
 
@@ -48,9 +48,10 @@ class StringName {
 
 	enum {
 
-		STRING_TABLE_BITS = 12,
-		STRING_TABLE_LEN = 1 << STRING_TABLE_BITS,
-		STRING_TABLE_MASK = STRING_TABLE_LEN - 1
+		// names are spread over shards, each with its own lock and its own table that grows as needed
+		STRING_TABLE_SHARD_BITS = 6,
+		STRING_TABLE_SHARDS = 1 << STRING_TABLE_SHARD_BITS,
+		STRING_TABLE_MIN_BITS = 6
 	};
 
 	struct _Data {
@@ -59,19 +60,32 @@ class StringName {
 		String name;
 
 		String get_name() const { return cname ? String(cname) : name; }
-		int idx;
+		bool is_static;
 		uint32_t hash;
 		_Data *prev;
 		_Data *next;
 		_Data() {
 			cname = NULL;
 			next = prev = NULL;
-			idx = 0;
+			is_static = false;
 			hash = 0;
 		}
 	};
 
-	static _Data *_table[STRING_TABLE_LEN];
+	struct _Shard {
+		Mutex *lock;
+		_Data **table;
+		uint32_t mask;
+		uint32_t count;
+	};
+
+	static _Shard _shards[STRING_TABLE_SHARDS];
+
+	_FORCE_INLINE_ static _Shard &_get_shard(uint32_t p_hash) {
+		// buckets use the low bits of the hash, so shards take the high bits of a scrambled one
+		return _shards[(p_hash * 2654435761U) >> (32 - STRING_TABLE_SHARD_BITS)];
+	}
+	static void _insert(_Shard &p_shard, _Data *p_data);
 
 	_Data *_data;
 
@@ -85,7 +99,6 @@ class StringName {
 	friend void register_core_types();
 	friend void unregister_core_types();
 
-	static Mutex *lock;
 	static void setup();
 	static void cleanup();
 	static bool configured;
@@ -162,7 +175,7 @@ public:
 	StringName(const char *p_name);
 	StringName(const StringName &p_name);
 	StringName(const String &p_name);
-	StringName(const StaticCString &p_static_string);
+	StringName(const StaticCString &p_static_string, bool p_static = false);
 	StringName();
 	~StringName();
 };
@@ -0,0 +1,283 @@
+/*************************************************************************/
+/*  string_kernels.cpp                                                   */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2018 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2018 Godot Engine contributors (cf. AUTHORS.md)    */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#include "string_kernels.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define STRING_KERNELS_SSE
+#include <emmintrin.h>
+#endif
+
+#ifdef STRING_KERNELS_SSE
+
+// Number of characters in a 16 byte register.
+#define CHARS_PER_REG int(16 / sizeof(CharType))
+
+static _FORCE_INLINE_ __m128i _set1_char(uint32_t p_value) {
+
+	return sizeof(CharType) == 2 ? _mm_set1_epi16(short(p_value)) : _mm_set1_epi32(int(p_value));
+}
+
+static _FORCE_INLINE_ __m128i _cmpeq_char(__m128i a, __m128i b) {
+
+	return sizeof(CharType) == 2 ? _mm_cmpeq_epi16(a, b) : _mm_cmpeq_epi32(a, b);
+}
+
+static _FORCE_INLINE_ __m128i _cmpgt_char(__m128i a, __m128i b) {
+
+	return sizeof(CharType) == 2 ? _mm_cmpgt_epi16(a, b) : _mm_cmpgt_epi32(a, b);
+}
+
+// All bits set on characters that are not ASCII.
+static _FORCE_INLINE_ __m128i _non_ascii(__m128i v) {
+
+	__m128i high = _mm_and_si128(v, _set1_char(~0x7FU));
+	return _mm_xor_si128(_cmpeq_char(high, _mm_setzero_si128()), _mm_set1_epi32(-1));
+}
+
+// All bits set on characters in [p_from, p_to].
+static _FORCE_INLINE_ __m128i _in_range(__m128i v, uint32_t p_from, uint32_t p_to) {
+
+	return _mm_and_si128(_cmpgt_char(v, _set1_char(p_from - 1)), _cmpgt_char(_set1_char(p_to + 1), v));
+}
+
+#endif
+
+int StringKernels::ascii_length(const char *p_str, int p_len) {
+
+	int i = 0;
+
+#ifdef STRING_KERNELS_SSE
+	const __m128i zero = _mm_setzero_si128();
+	for (; i + 16 <= p_len; i += 16) {
+		__m128i v = _mm_loadu_si128((const __m128i *)&p_str[i]);
+		if (_mm_movemask_epi8(_mm_or_si128(v, _mm_cmpeq_epi8(v, zero))))
+			break; //the loop below finds where
+	}
+#endif
+
+	for (; i < p_len; i++) {
+		uint8_t c = p_str[i];
+		if (c == 0 || (c & 0x80))
+			break;
+	}
+
+	return i;
+}
+
+int StringKernels::ascii_length(const CharType *p_str, int p_len) {
+
+	int i = 0;
+
+#ifdef STRING_KERNELS_SSE
+	for (; i + CHARS_PER_REG <= p_len; i += CHARS_PER_REG) {
+		__m128i v = _mm_loadu_si128((const __m128i *)&p_str[i]);
+		if (_mm_movemask_epi8(_non_ascii(v)))
+			break;
+	}
+#endif
+
+	for (; i < p_len; i++) {
+		if (uint32_t(p_str[i]) > 0x7F)
+			break;
+	}
+
+	return i;
+}
+
+void StringKernels::widen_ascii(CharType *p_dst, const char *p_src, int p_len) {
+
+	int i = 0;
+
+#ifdef STRING_KERNELS_SSE
+	const __m128i zero = _mm_setzero_si128();
+	for (; i + 16 <= p_len; i += 16) {
+		__m128i v = _mm_loadu_si128((const __m128i *)&p_src[i]);
+		__m128i lo = _mm_unpacklo_epi8(v, zero);
+		__m128i hi = _mm_unpackhi_epi8(v, zero);
+		__m128i *dst = (__m128i *)&p_dst[i];
+		if (sizeof(CharType) == 2) {
+			_mm_storeu_si128(dst, lo);
+			_mm_storeu_si128(dst + 1, hi);
+		} else {
+			_mm_storeu_si128(dst, _mm_unpacklo_epi16(lo, zero));
+			_mm_storeu_si128(dst + 1, _mm_unpackhi_epi16(lo, zero));
+			_mm_storeu_si128(dst + 2, _mm_unpacklo_epi16(hi, zero));
+			_mm_storeu_si128(dst + 3, _mm_unpackhi_epi16(hi, zero));
+		}
+	}
+#endif
+
+	for (; i < p_len; i++) {
+		p_dst[i] = uint8_t(p_src[i]);
+	}
+}
+
+void StringKernels::narrow_ascii(char *p_dst, const CharType *p_src, int p_len) {
+
+	int i = 0;
+
+#ifdef STRING_KERNELS_SSE
+	for (; i + 16 <= p_len; i += 16) {
+		const __m128i *src = (const __m128i *)&p_src[i];
+		__m128i lo, hi;
+		if (sizeof(CharType) == 2) {
+			lo = _mm_loadu_si128(src);
+			hi = _mm_loadu_si128(src + 1);
+		} else {
+			// values are ASCII, so the signed saturation never kicks in
+			lo = _mm_packs_epi32(_mm_loadu_si128(src), _mm_loadu_si128(src + 1));
+			hi = _mm_packs_epi32(_mm_loadu_si128(src + 2), _mm_loadu_si128(src + 3));
+		}
+		_mm_storeu_si128((__m128i *)&p_dst[i], _mm_packus_epi16(lo, hi));
+	}
+#endif
+
+	for (; i < p_len; i++) {
+		p_dst[i] = char(p_src[i]);
+	}
+}
+
+int StringKernels::find_char(const CharType *p_str, int p_from, int p_len, CharType p_char) {
+
+	int i = p_from;
+
+#ifdef STRING_KERNELS_SSE
+	const __m128i needle = _set1_char(uint32_t(p_char));
+	for (; i + CHARS_PER_REG <= p_len; i += CHARS_PER_REG) {
+		__m128i v = _mm_loadu_si128((const __m128i *)&p_str[i]);
+		if (_mm_movemask_epi8(_cmpeq_char(v, needle)))
+			break;
+	}
+#endif
+
+	for (; i < p_len; i++) {
+		if (p_str[i] == p_char)
+			return i;
+	}
+
+	return -1;
+}
+
+int StringKernels::find_case_change(const CharType *p_str, int p_len, bool p_upper) {
+
+	const uint32_t from = p_upper ? 'a' : 'A';
+	const uint32_t to = p_upper ? 'z' : 'Z';
+
+	int i = 0;
+
+#ifdef STRING_KERNELS_SSE
+	for (; i + CHARS_PER_REG <= p_len; i += CHARS_PER_REG) {
+		__m128i v = _mm_loadu_si128((const __m128i *)&p_str[i]);
+		if (_mm_movemask_epi8(_mm_or_si128(_non_ascii(v), _in_range(v, from, to))))
+			break;
+	}
+#endif
+
+	for (; i < p_len; i++) {
+		uint32_t c = p_str[i];
+		if (c > 0x7F || (c >= from && c <= to))
+			break;
+	}
+
+	return i;
+}
+
+static _FORCE_INLINE_ int _ascii_change_case(CharType *p_str, int p_len, uint32_t p_from, uint32_t p_to, int p_delta) {
+
+	int i = 0;
+
+#ifdef STRING_KERNELS_SSE
+	for (; i + CHARS_PER_REG <= p_len; i += CHARS_PER_REG) {
+		__m128i *ptr = (__m128i *)&p_str[i];
+		__m128i v = _mm_loadu_si128(ptr);
+		if (_mm_movemask_epi8(_non_ascii(v)))
+			break;
+		// letters get p_delta added, everything else is left as is
+		__m128i delta = _mm_and_si128(_in_range(v, p_from, p_to), _set1_char(uint32_t(p_delta)));
+		v = sizeof(CharType) == 2 ? _mm_add_epi16(v, delta) : _mm_add_epi32(v, delta);
+		_mm_storeu_si128(ptr, v);
+	}
+#endif
+
+	for (; i < p_len; i++) {
+		uint32_t c = p_str[i];
+		if (c > 0x7F)
+			break;
+		if (c >= p_from && c <= p_to)
+			p_str[i] = c + p_delta;
+	}
+
+	return i;
+}
+
+int StringKernels::ascii_to_upper(CharType *p_str, int p_len) {
+
+	return _ascii_change_case(p_str, p_len, 'a', 'z', 'A' - 'a');
+}
+
+int StringKernels::ascii_to_lower(CharType *p_str, int p_len) {
+
+	return _ascii_change_case(p_str, p_len, 'A', 'Z', 'a' - 'A');
+}
+
+// Four steps of hash * 33 + c folded into one, so the multiplications
+// of the characters don't depend on each other.
+#define DJB2_STEP4(m_str)                                                              \
+	p_hash = p_hash * 1185921 + uint32_t(m_str[i]) * 35937 + uint32_t(m_str[i + 1]) * 1089 + \
+			 uint32_t(m_str[i + 2]) * 33 + uint32_t(m_str[i + 3])
+
+uint32_t StringKernels::hash_djb2(const CharType *p_str, int p_len, uint32_t p_hash) {
+
+	int i = 0;
+	for (; i + 4 <= p_len; i += 4) {
+		DJB2_STEP4(p_str);
+	}
+	for (; i < p_len; i++) {
+		p_hash = ((p_hash << 5) + p_hash) + p_str[i];
+	}
+
+	return p_hash;
+}
+
+uint32_t StringKernels::hash_djb2(const char *p_str, int p_len, uint32_t p_hash) {
+
+	int i = 0;
+	for (; i + 4 <= p_len; i += 4) {
+		DJB2_STEP4(p_str);
+	}
+	for (; i < p_len; i++) {
+		p_hash = ((p_hash << 5) + p_hash) + p_str[i];
+	}
+
+	return p_hash;
+}
+
+#undef DJB2_STEP4
@@ -0,0 +1,66 @@
+/*************************************************************************/
+/*  string_kernels.h                                                     */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2018 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2018 Godot Engine contributors (cf. AUTHORS.md)    */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef STRING_KERNELS_H
+#define STRING_KERNELS_H
+
+#include "core/typedefs.h"
+#include "core/ustring.h"
+
+// Inner loops of String that are worth vectorizing. They handle runs of
+// ASCII text with SSE2 when available and fall back to plain loops
+// otherwise, so they work for both 16 and 32 bit CharType. Results are
+// identical to the scalar versions.
+
+class StringKernels {
+public:
+	// Length of the leading run of bytes that are ASCII and not zero.
+	static int ascii_length(const char *p_str, int p_len);
+	// Length of the leading run of ASCII characters.
+	static int ascii_length(const CharType *p_str, int p_len);
+
+	static void widen_ascii(CharType *p_dst, const char *p_src, int p_len);
+	static void narrow_ascii(char *p_dst, const CharType *p_src, int p_len);
+
+	// Returns the first index from p_from holding p_char, or -1.
+	static int find_char(const CharType *p_str, int p_from, int p_len, CharType p_char);
+
+	// Returns the index of the first character that to_upper (or to_lower) may change: a letter of the other case or any non ASCII character.
+	static int find_case_change(const CharType *p_str, int p_len, bool p_upper);
+	// Converts the leading ASCII run in place and returns its length.
+	static int ascii_to_upper(CharType *p_str, int p_len);
+	static int ascii_to_lower(CharType *p_str, int p_len);
+
+	// djb2, four characters per step.
+	static uint32_t hash_djb2(const CharType *p_str, int p_len, uint32_t p_hash = 5381);
+	static uint32_t hash_djb2(const char *p_str, int p_len, uint32_t p_hash = 5381);
+};
+
+#endif // STRING_KERNELS_H
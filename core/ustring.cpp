@@ -34,6 +34,7 @@
 #include "core/math/math_funcs.h"
 #include "core/os/memory.h"
 #include "core/print_string.h"
+#include "core/string_kernels.h"
 #include "core/translation.h"
 #include "core/ucaps.h"
 #include "core/variant.h"
@@ -41,6 +42,7 @@
 #include "thirdparty/misc/md5.h"
 #include "thirdparty/misc/sha256.h"
 
+#include <string.h>
 #include <wchar.h>
 
 #ifndef NO_USE_STDLIB
@@ -932,13 +934,21 @@ CharType String::char_lowercase(CharType p_char) {
 String String::to_upper() const {
 
 	String upper = *this;
+	const int len = length();
+
+	// nothing is written until something changes, to avoid copy on write
+	int i = StringKernels::find_case_change(c_str(), len, true);
+	if (i == len)
+		return upper;
 
-	for (int i = 0; i < upper.size(); i++) {
+	CharType *dst = upper.ptrw();
+	while (i < len) {
 
-		const CharType s = upper[i];
-		const CharType t = _find_upper(s);
-		if (s != t) // avoid copy on write
-			upper[i] = t;
+		i += StringKernels::ascii_to_upper(&dst[i], len - i);
+		if (i < len) {
+			dst[i] = _find_upper(dst[i]);
+			i++;
+		}
 	}
 
 	return upper;
@@ -947,13 +957,21 @@ String String::to_upper() const {
 String String::to_lower() const {
 
 	String lower = *this;
+	const int len = length();
+
+	// nothing is written until something changes, to avoid copy on write
+	int i = StringKernels::find_case_change(c_str(), len, false);
+	if (i == len)
+		return lower;
 
-	for (int i = 0; i < lower.size(); i++) {
+	CharType *dst = lower.ptrw();
+	while (i < len) {
 
-		const CharType s = lower[i];
-		const CharType t = _find_lower(s);
-		if (s != t) // avoid copy on write
-			lower[i] = t;
+		i += StringKernels::ascii_to_lower(&dst[i], len - i);
+		if (i < len) {
+			dst[i] = _find_lower(dst[i]);
+			i++;
+		}
 	}
 
 	return lower;
@@ -1361,6 +1379,9 @@ bool String::parse_utf8(const char *p_utf8, int p_len) {
 		}
 	}
 
+	if (p_len < 0)
+		p_len = strlen(p_utf8);
+
 	{
 		const char *ptrtmp = p_utf8;
 		const char *ptrtmp_limit = &p_utf8[p_len];
@@ -1372,9 +1393,14 @@ bool String::parse_utf8(const char *p_utf8, int p_len) {
 				uint8_t c = *ptrtmp;
 
 				/* Determine the number of characters in sequence */
-				if ((c & 0x80) == 0)
-					skip = 0;
-				else if ((c & 0xE0) == 0xC0)
+				if ((c & 0x80) == 0) {
+					// count the whole run of ASCII at once
+					int run = StringKernels::ascii_length(ptrtmp, ptrtmp_limit - ptrtmp);
+					str_size += run;
+					cstr_size += run;
+					ptrtmp += run;
+					continue;
+				} else if ((c & 0xE0) == 0xC0)
 					skip = 1;
 				else if ((c & 0xF0) == 0xE0)
 					skip = 2;
@@ -1425,10 +1451,18 @@ bool String::parse_utf8(const char *p_utf8, int p_len) {
 
 		int len = 0;
 
-		/* Determine the number of characters in sequence */
-		if ((*p_utf8 & 0x80) == 0)
-			len = 1;
-		else if ((*p_utf8 & 0xE0) == 0xC0)
+		if ((*p_utf8 & 0x80) == 0) {
+			// copy the whole run of ASCII at once, it was already validated above
+			int run = StringKernels::ascii_length(p_utf8, cstr_size);
+			StringKernels::widen_ascii(dst, p_utf8, run);
+			dst += run;
+			cstr_size -= run;
+			p_utf8 += run;
+			continue;
+		}
+
+		/* Determine the number of characters in sequence, ASCII never gets here */
+		if ((*p_utf8 & 0xE0) == 0xC0)
 			len = 2;
 		else if ((*p_utf8 & 0xF0) == 0xE0)
 			len = 3;
@@ -1457,26 +1491,19 @@ bool String::parse_utf8(const char *p_utf8, int p_len) {
 
 		/* Convert the first character */
 
-		uint32_t unichar = 0;
-
-		if (len == 1)
-			unichar = *p_utf8;
-		else {
-
-			unichar = (0xFF >> (len + 1)) & *p_utf8;
+		uint32_t unichar = (0xFF >> (len + 1)) & *p_utf8;
 
-			for (int i = 1; i < len; i++) {
+		for (int i = 1; i < len; i++) {
 
-				if ((p_utf8[i] & 0xC0) != 0x80) {
-					_UNICERROR("invalid utf8");
-					return true; //invalid utf8
-				}
-				if (unichar == 0 && i == 2 && ((p_utf8[i] & 0x7F) >> (7 - len)) == 0) {
-					_UNICERROR("invalid utf8 overlong");
-					return true; //no overlong
-				}
-				unichar = (unichar << 6) | (p_utf8[i] & 0x3F);
+			if ((p_utf8[i] & 0xC0) != 0x80) {
+				_UNICERROR("invalid utf8");
+				return true; //invalid utf8
+			}
+			if (unichar == 0 && i == 2 && ((p_utf8[i] & 0x7F) >> (7 - len)) == 0) {
+				_UNICERROR("invalid utf8 overlong");
+				return true; //no overlong
 			}
+			unichar = (unichar << 6) | (p_utf8[i] & 0x3F);
 		}
 
 		//printf("char %i, len %i\n",unichar,len);
@@ -1492,15 +1519,17 @@ bool String::parse_utf8(const char *p_utf8, int p_len) {
 	return false;
 }
 
-CharString String::utf8() const {
+int String::utf8_length() const {
 
 	int l = length();
 	if (!l)
-		return CharString();
+		return 0;
 
 	const CharType *d = &operator[](0);
-	int fl = 0;
-	for (int i = 0; i < l; i++) {
+	// most strings start with (or are only) ASCII, which maps one to one
+	const int ascii = StringKernels::ascii_length(d, l);
+	int fl = ascii;
+	for (int i = ascii; i < l; i++) {
 
 		uint32_t c = d[i];
 		if (c <= 0x7f) // 7 bits.
@@ -1519,17 +1548,25 @@ CharString String::utf8() const {
 		}
 	}
 
-	CharString utf8s;
-	if (fl == 0) {
-		return utf8s;
-	}
+	return fl;
+}
 
-	utf8s.resize(fl + 1);
-	uint8_t *cdst = (uint8_t *)utf8s.get_data();
+int String::write_utf8(char *r_utf8) const {
+
+	int l = length();
+	if (!l)
+		return 0;
+
+	const CharType *d = &operator[](0);
+	uint8_t *cdst = (uint8_t *)r_utf8;
 
 #define APPEND_CHAR(m_c) *(cdst++) = m_c
 
-	for (int i = 0; i < l; i++) {
+	const int ascii = StringKernels::ascii_length(d, l);
+	StringKernels::narrow_ascii((char *)cdst, d, ascii);
+	cdst += ascii;
+
+	for (int i = ascii; i < l; i++) {
 
 		uint32_t c = d[i];
 
@@ -1568,7 +1605,23 @@ CharString String::utf8() const {
 		}
 	}
 #undef APPEND_CHAR
-	*cdst = 0; //trailing zero
+
+	return (int)(cdst - (uint8_t *)r_utf8);
+}
+
+CharString String::utf8() const {
+
+	int fl = utf8_length();
+
+	CharString utf8s;
+	if (fl == 0) {
+		return utf8s;
+	}
+
+	utf8s.resize(fl + 1);
+	char *cdst = utf8s.ptrw();
+	write_utf8(cdst);
+	cdst[fl] = 0; //trailing zero
 
 	return utf8s;
 }
@@ -2119,20 +2172,12 @@ uint32_t String::hash(const char *p_cstr) {
 
 uint32_t String::hash(const char *p_cstr, int p_len) {
 
-	uint32_t hashv = 5381;
-	for (int i = 0; i < p_len; i++)
-		hashv = ((hashv << 5) + hashv) + p_cstr[i]; /* hash * 33 + c */
-
-	return hashv;
+	return StringKernels::hash_djb2(p_cstr, p_len);
 }
 
 uint32_t String::hash(const CharType *p_cstr, int p_len) {
 
-	uint32_t hashv = 5381;
-	for (int i = 0; i < p_len; i++)
-		hashv = ((hashv << 5) + hashv) + p_cstr[i]; /* hash * 33 + c */
-
-	return hashv;
+	return StringKernels::hash_djb2(p_cstr, p_len);
 }
 
 uint32_t String::hash(const CharType *p_cstr) {
@@ -2150,14 +2195,7 @@ uint32_t String::hash() const {
 
 	/* simple djb2 hashing */
 
-	const CharType *chr = c_str();
-	uint32_t hashv = 5381;
-	uint32_t c;
-
-	while ((c = *chr++))
-		hashv = ((hashv << 5) + hashv) + c; /* hash * 33 + c */
-
-	return hashv;
+	return StringKernels::hash_djb2(c_str(), length());
 }
 
 uint64_t String::hash64() const {
@@ -2294,21 +2332,19 @@ int String::find(const String &p_str, int p_from) const {
 
 	const CharType *src = c_str();
 	const CharType *str = p_str.c_str();
+	const int last = len - src_len;
 
-	for (int i = p_from; i <= (len - src_len); i++) {
-
-		bool found = true;
-		for (int j = 0; j < src_len; j++) {
-
-			int read_pos = i + j;
+	for (int i = p_from; i <= last; i++) {
 
-			if (read_pos >= len) {
+		// jump to the next place where the first character matches
+		i = StringKernels::find_char(src, i, last + 1, str[0]);
+		if (i < 0)
+			return -1;
 
-				ERR_PRINT("read_pos>=len");
-				return -1;
-			};
+		bool found = true;
+		for (int j = 1; j < src_len; j++) {
 
-			if (src[read_pos] != str[j]) {
+			if (src[i + j] != str[j]) {
 				found = false;
 				break;
 			}
@@ -2341,29 +2377,23 @@ int String::find(const char *p_str, int p_from) const {
 
 		const char needle = p_str[0];
 
-		for (int i = p_from; i < len; i++) {
+		return StringKernels::find_char(src, p_from, len, needle);
 
-			if (src[i] == needle) {
-				return i;
-			}
-		}
+	} else if (src_len > 1) {
 
-	} else {
+		const int last = len - src_len;
 
-		for (int i = p_from; i <= (len - src_len); i++) {
+		for (int i = p_from; i <= last; i++) {
 
-			bool found = true;
-			for (int j = 0; j < src_len; j++) {
-
-				int read_pos = i + j;
-
-				if (read_pos >= len) {
+			// jump to the next place where the first character matches
+			i = StringKernels::find_char(src, i, last + 1, p_str[0]);
+			if (i < 0)
+				return -1;
 
-					ERR_PRINT("read_pos>=len");
-					return -1;
-				};
+			bool found = true;
+			for (int j = 1; j < src_len; j++) {
 
-				if (src[read_pos] != p_str[j]) {
+				if (src[i + j] != p_str[j]) {
 					found = false;
 					break;
 				}
@@ -2372,6 +2402,10 @@ int String::find(const char *p_str, int p_from) const {
 			if (found)
 				return i;
 		}
+
+	} else if (p_from <= len) {
+
+		return p_from; //empty string is found right away
 	}
 
 	return -1;
@@ -239,6 +239,8 @@ public:
 
 	CharString ascii(bool p_allow_extended = false) const;
 	CharString utf8() const;
+	int utf8_length() const; // bytes utf8() produces, without the trailing zero
+	int write_utf8(char *r_utf8) const; // writes utf8_length() bytes, no trailing zero
 	bool parse_utf8(const char *p_utf8, int p_len = -1); //return true on error
 	static String utf8(const char *p_utf8, int p_len = -1);
 
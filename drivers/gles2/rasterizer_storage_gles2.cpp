@@ -3005,6 +3005,21 @@ Transform2D RasterizerStorageGLES2::skeleton_bone_get_transform_2d(RID p_skeleto
 	return ret;
 }
 
+void RasterizerStorageGLES2::skeleton_set_as_bulk_array(RID p_skeleton, const PoolVector<float> &p_array) {
+	Skeleton *skeleton = skeleton_owner.getornull(p_skeleton);
+	ERR_FAIL_COND(!skeleton);
+
+	// same layout as bone_data, 12 floats per bone in 3D and 8 in 2D
+	ERR_FAIL_COND(p_array.size() != skeleton->bone_data.size());
+
+	PoolVector<float>::Read r = p_array.read();
+	copymem(skeleton->bone_data.ptrw(), r.ptr(), p_array.size() * sizeof(float));
+
+	if (!skeleton->update_list.in_list()) {
+		skeleton_update_list.add(&skeleton->update_list);
+	}
+}
+
 void RasterizerStorageGLES2::skeleton_set_base_transform_2d(RID p_skeleton, const Transform2D &p_base_transform) {
 }
 
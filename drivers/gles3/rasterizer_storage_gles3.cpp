@@ -4866,6 +4866,41 @@ Transform2D RasterizerStorageGLES3::skeleton_bone_get_transform_2d(RID p_skeleto
 	return ret;
 }
 
+void RasterizerStorageGLES3::skeleton_set_as_bulk_array(RID p_skeleton, const PoolVector<float> &p_array) {
+
+	Skeleton *skeleton = skeleton_owner.getornull(p_skeleton);
+
+	ERR_FAIL_COND(!skeleton);
+
+	// bones are packed one after another, 12 floats in 3D and 8 in 2D,
+	// the texture keeps each row of 256 bones together
+	int rows = skeleton->use_2d ? 2 : 3;
+	ERR_FAIL_COND(p_array.size() != skeleton->size * rows * 4);
+
+	PoolVector<float>::Read r = p_array.read();
+	const float *src = r.ptr();
+	float *texture = skeleton->skel_texture.ptrw();
+
+	for (int i = 0; i < skeleton->size; i++) {
+
+		int base_ofs = ((i / 256) * 256) * rows * 4 + (i % 256) * 4;
+
+		for (int j = 0; j < rows; j++) {
+
+			texture[base_ofs + 0] = src[0];
+			texture[base_ofs + 1] = src[1];
+			texture[base_ofs + 2] = src[2];
+			texture[base_ofs + 3] = src[3];
+			base_ofs += 256 * 4;
+			src += 4;
+		}
+	}
+
+	if (!skeleton->update_list.in_list()) {
+		skeleton_update_list.add(&skeleton->update_list);
+	}
+}
+
 void RasterizerStorageGLES3::skeleton_set_base_transform_2d(RID p_skeleton, const Transform2D &p_base_transform) {
 
 	Skeleton *skeleton = skeleton_owner.getornull(p_skeleton);
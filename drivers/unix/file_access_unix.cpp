@@ -39,6 +39,7 @@
 #include <sys/types.h>
 
 #if defined(UNIX_ENABLED)
+#include <sys/mman.h>
 #include <unistd.h>
 #endif
 
@@ -64,8 +65,42 @@ void FileAccessUnix::check_errors() const {
 	}
 }
 
+void FileAccessUnix::_map_file() {
+
+#if defined(UNIX_ENABLED)
+	int fd = fileno(f);
+	struct stat st;
+	if (fstat(fd, &st) != 0 || !S_ISREG(st.st_mode) || st.st_size <= 0)
+		return;
+
+	if ((uint64_t)st.st_size > (uint64_t)(size_t)-1)
+		return; // Doesn't fit in the address space, keep using stdio.
+
+	void *m = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+	if (m == MAP_FAILED)
+		return;
+
+	mapped = (uint8_t *)m;
+	mapped_len = st.st_size;
+	mapped_pos = 0;
+#endif
+}
+
+void FileAccessUnix::_unmap_file() {
+
+#if defined(UNIX_ENABLED)
+	if (mapped) {
+		munmap(mapped, mapped_len);
+	}
+#endif
+	mapped = NULL;
+	mapped_len = 0;
+	mapped_pos = 0;
+}
+
 Error FileAccessUnix::_open(const String &p_path, int p_mode_flags) {
 
+	_unmap_file();
 	if (f)
 		fclose(f);
 	f = NULL;
@@ -126,6 +161,7 @@ void FileAccessUnix::close() {
 	if (!f)
 		return;
 
+	_unmap_file();
 	fclose(f);
 	f = NULL;
 
@@ -165,6 +201,11 @@ void FileAccessUnix::seek(size_t p_position) {
 	ERR_FAIL_COND(!f);
 
 	last_error = OK;
+	if (mapped) {
+		mapped_pos = p_position;
+		return;
+	}
+
 	if (fseek(f, p_position, SEEK_SET))
 		check_errors();
 }
@@ -173,6 +214,13 @@ void FileAccessUnix::seek_end(int64_t p_position) {
 
 	ERR_FAIL_COND(!f);
 
+	if (mapped) {
+		ERR_FAIL_COND(p_position < 0 && size_t(-p_position) > mapped_len);
+		last_error = OK;
+		mapped_pos = mapped_len + p_position;
+		return;
+	}
+
 	if (fseek(f, p_position, SEEK_END))
 		check_errors();
 }
@@ -181,6 +229,9 @@ size_t FileAccessUnix::get_position() const {
 
 	ERR_FAIL_COND_V(!f, 0);
 
+	if (mapped)
+		return mapped_pos;
+
 	long pos = ftell(f);
 	if (pos < 0) {
 		check_errors();
@@ -193,6 +244,9 @@ size_t FileAccessUnix::get_len() const {
 
 	ERR_FAIL_COND_V(!f, 0);
 
+	if (mapped)
+		return mapped_len;
+
 	long pos = ftell(f);
 	ERR_FAIL_COND_V(pos < 0, 0);
 	ERR_FAIL_COND_V(fseek(f, 0, SEEK_END), 0);
@@ -211,6 +265,15 @@ bool FileAccessUnix::eof_reached() const {
 uint8_t FileAccessUnix::get_8() const {
 
 	ERR_FAIL_COND_V(!f, 0);
+
+	if (mapped) {
+		if (mapped_pos >= mapped_len) {
+			last_error = ERR_FILE_EOF;
+			return 0;
+		}
+		return mapped[mapped_pos++];
+	}
+
 	uint8_t b;
 	if (fread(&b, 1, 1, f) == 0) {
 		check_errors();
@@ -222,11 +285,54 @@ uint8_t FileAccessUnix::get_8() const {
 int FileAccessUnix::get_buffer(uint8_t *p_dst, int p_length) const {
 
 	ERR_FAIL_COND_V(!f, -1);
+
+	if (mapped) {
+		size_t left = mapped_pos < mapped_len ? mapped_len - mapped_pos : 0;
+		int read = p_length;
+		if ((size_t)p_length > left) {
+			read = left;
+			last_error = ERR_FILE_EOF;
+		}
+		copymem(p_dst, mapped + mapped_pos, read);
+		mapped_pos += read;
+		return read;
+	}
+
 	int read = fread(p_dst, 1, p_length, f);
 	check_errors();
 	return read;
 };
 
+const uint8_t *FileAccessUnix::map_range(size_t p_offset, size_t p_length) const {
+
+	if (!mapped || p_offset > mapped_len || p_length > mapped_len - p_offset)
+		return NULL;
+
+	return mapped + p_offset;
+}
+
+Error FileAccessUnix::map_contents() {
+
+	ERR_FAIL_COND_V(!f, ERR_UNCONFIGURED);
+
+	if (mapped)
+		return OK;
+	if (flags != READ)
+		return ERR_UNAVAILABLE;
+
+	long pos = ftell(f);
+	if (pos < 0)
+		return ERR_UNAVAILABLE;
+
+	_map_file();
+	if (!mapped)
+		return ERR_UNAVAILABLE;
+
+	//carry on from where the buffered reads left off
+	mapped_pos = pos;
+	return OK;
+}
+
 Error FileAccessUnix::get_error() const {
 
 	return last_error;
@@ -313,6 +419,9 @@ FileAccessUnix::FileAccessUnix() {
 
 	f = NULL;
 	flags = 0;
+	mapped = NULL;
+	mapped_len = 0;
+	mapped_pos = 0;
 	last_error = OK;
 }
 
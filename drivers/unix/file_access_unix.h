@@ -48,6 +48,16 @@ class FileAccessUnix : public FileAccess {
 
 	FILE *f;
 	int flags;
+
+	// Files opened for reading can be mapped into memory on request (see map_contents()),
+	// reads are then served from the mapping instead of going through stdio.
+	uint8_t *mapped;
+	size_t mapped_len;
+	mutable size_t mapped_pos;
+
+	void _map_file();
+	void _unmap_file();
+
 	void check_errors() const;
 	mutable Error last_error;
 	String save_path;
@@ -75,6 +85,8 @@ public:
 
 	virtual uint8_t get_8() const; ///< get a byte
 	virtual int get_buffer(uint8_t *p_dst, int p_length) const;
+	virtual const uint8_t *map_range(size_t p_offset, size_t p_length) const;
+	virtual Error map_contents();
 
 	virtual Error get_error() const; ///< get last error
 
@@ -30,6 +30,8 @@
 
 #include "net_socket_posix.h"
 
+#include "core/os/os.h"
+
 #if defined(UNIX_ENABLED)
 
 #include <errno.h>
@@ -157,6 +159,7 @@ void NetSocketPosix::make_default() {
 	}
 #endif
 	_create = _create_func;
+	NetSocketPollGroupPosix::make_default();
 }
 
 void NetSocketPosix::cleanup() {
@@ -172,10 +175,16 @@ NetSocketPosix::NetSocketPosix() {
 	_sock = SOCK_EMPTY;
 	_ip_type = IP::TYPE_NONE;
 	_is_stream = false;
+	_poll_group = NULL;
+	_poll_index = -1;
+	_poll_type = POLL_TYPE_IN;
+	_poll_userdata = 0;
 }
 
 NetSocketPosix::~NetSocketPosix() {
 	close();
+	if (_poll_group)
+		_poll_group->_remove_socket(this);
 }
 
 NetSocketPosix::NetError NetSocketPosix::_get_socket_error() {
@@ -260,15 +269,23 @@ Error NetSocketPosix::open(Type p_sock_type, IP::Type &ip_type) {
 	}
 
 	_is_stream = p_sock_type == TYPE_TCP;
+
+	if (_poll_group)
+		_poll_group->_socket_changed(this, SOCK_EMPTY);
+
 	return OK;
 }
 
 void NetSocketPosix::close() {
 
-	if (_sock != SOCK_EMPTY)
-		SOCK_CLOSE(_sock);
-
+	SOCKET_TYPE old_sock = _sock;
 	_sock = SOCK_EMPTY;
+	if (_poll_group && old_sock != SOCK_EMPTY)
+		_poll_group->_socket_changed(this, old_sock);
+
+	if (old_sock != SOCK_EMPTY)
+		SOCK_CLOSE(old_sock);
+
 	_ip_type = IP::TYPE_NONE;
 	_is_stream = false;
 }
@@ -348,7 +365,7 @@ Error NetSocketPosix::poll(PollType p_type, int timeout) const {
 			pfd.events = POLLOUT;
 			break;
 		case POLL_TYPE_IN_OUT:
-			pfd.events = POLLOUT || POLLIN;
+			pfd.events = POLLOUT | POLLIN;
 	}
 
 	int ret = SOCK_POLL(&pfd, 1, timeout);
@@ -447,6 +464,181 @@ Error NetSocketPosix::sendto(const uint8_t *p_buffer, int p_len, int &r_sent, IP
 	return OK;
 }
 
+#ifndef MMSG_ENABLED
+static int _recv_datagram(SOCKET_TYPE p_sock, NetSocket::Datagram &r_datagram, struct sockaddr_storage *r_from) {
+
+	int buffers = r_datagram.overflow ? 2 : 1;
+#if defined(WINDOWS_ENABLED)
+	WSABUF bufs[2];
+	bufs[0].buf = (char *)r_datagram.buffer;
+	bufs[0].len = r_datagram.buffer_size;
+	bufs[1].buf = (char *)r_datagram.overflow;
+	bufs[1].len = r_datagram.overflow_size;
+
+	DWORD received = 0;
+	DWORD flags = 0;
+	int from_len = sizeof(struct sockaddr_storage);
+	if (WSARecvFrom(p_sock, bufs, buffers, &received, &flags, (struct sockaddr *)r_from, &from_len, NULL, NULL) == SOCKET_ERROR)
+		return -1;
+	return received;
+#else
+	struct iovec iov[2];
+	iov[0].iov_base = r_datagram.buffer;
+	iov[0].iov_len = r_datagram.buffer_size;
+	iov[1].iov_base = r_datagram.overflow;
+	iov[1].iov_len = r_datagram.overflow_size;
+
+	struct msghdr msg;
+	memset(&msg, 0, sizeof(msg));
+	msg.msg_name = r_from;
+	msg.msg_namelen = sizeof(struct sockaddr_storage);
+	msg.msg_iov = iov;
+	msg.msg_iovlen = buffers;
+	return ::recvmsg(p_sock, &msg, 0);
+#endif
+}
+#endif
+
+Error NetSocketPosix::recvfrom_batch(Datagram *p_datagrams, int p_count, int &r_received) {
+	ERR_FAIL_COND_V(!is_open(), ERR_UNCONFIGURED);
+
+	r_received = 0;
+
+#ifdef MMSG_ENABLED
+	enum {
+		MAX_BATCH = 32
+	};
+
+	struct mmsghdr msgs[MAX_BATCH];
+	struct iovec iovs[MAX_BATCH][2];
+	struct sockaddr_storage from[MAX_BATCH];
+
+	while (r_received < p_count) {
+
+		int count = MIN(p_count - r_received, (int)MAX_BATCH);
+		Datagram *datagrams = p_datagrams + r_received;
+
+		for (int i = 0; i < count; i++) {
+			iovs[i][0].iov_base = datagrams[i].buffer;
+			iovs[i][0].iov_len = datagrams[i].buffer_size;
+			iovs[i][1].iov_base = datagrams[i].overflow;
+			iovs[i][1].iov_len = datagrams[i].overflow_size;
+
+			memset(&msgs[i], 0, sizeof(struct mmsghdr));
+			msgs[i].msg_hdr.msg_name = &from[i];
+			msgs[i].msg_hdr.msg_namelen = sizeof(struct sockaddr_storage);
+			msgs[i].msg_hdr.msg_iov = iovs[i];
+			msgs[i].msg_hdr.msg_iovlen = datagrams[i].overflow ? 2 : 1;
+		}
+
+		// MSG_WAITFORONE: only the first datagram may block, in case the socket is blocking
+		int ret = recvmmsg(_sock, msgs, count, MSG_WAITFORONE, NULL);
+		if (ret < 0) {
+			if (r_received > 0)
+				break;
+			if (_get_socket_error() == ERR_NET_WOULD_BLOCK)
+				return ERR_BUSY;
+			return FAILED;
+		}
+
+		for (int i = 0; i < ret; i++) {
+			datagrams[i].size = MIN((int)msgs[i].msg_len, datagrams[i].buffer_size + (datagrams[i].overflow ? datagrams[i].overflow_size : 0));
+			_set_ip_port(datagrams[i].ip, datagrams[i].port, &from[i]);
+		}
+		r_received += ret;
+
+		if (ret < count)
+			break; // nothing more waiting
+	}
+#else
+	while (r_received < p_count) {
+
+		Datagram &datagram = p_datagrams[r_received];
+		struct sockaddr_storage from;
+		memset(&from, 0, sizeof(struct sockaddr_storage));
+
+		int ret = _recv_datagram(_sock, datagram, &from);
+		if (ret < 0) {
+			if (r_received > 0)
+				break;
+			if (_get_socket_error() == ERR_NET_WOULD_BLOCK)
+				return ERR_BUSY;
+			return FAILED;
+		}
+
+		datagram.size = ret;
+		_set_ip_port(datagram.ip, datagram.port, &from);
+		r_received++;
+	}
+#endif
+
+	return OK;
+}
+
+Error NetSocketPosix::sendto_batch(const Datagram *p_datagrams, int p_count, int &r_sent) {
+	ERR_FAIL_COND_V(!is_open(), ERR_UNCONFIGURED);
+
+	r_sent = 0;
+
+#ifdef MMSG_ENABLED
+	enum {
+		MAX_BATCH = 32
+	};
+
+	struct mmsghdr msgs[MAX_BATCH];
+	struct iovec iovs[MAX_BATCH];
+	struct sockaddr_storage to[MAX_BATCH];
+
+	while (r_sent < p_count) {
+
+		int count = MIN(p_count - r_sent, (int)MAX_BATCH);
+		const Datagram *datagrams = p_datagrams + r_sent;
+
+		for (int i = 0; i < count; i++) {
+			iovs[i].iov_base = datagrams[i].buffer;
+			iovs[i].iov_len = datagrams[i].size;
+
+			memset(&msgs[i], 0, sizeof(struct mmsghdr));
+			msgs[i].msg_hdr.msg_name = &to[i];
+			msgs[i].msg_hdr.msg_namelen = _set_addr_storage(&to[i], datagrams[i].ip, datagrams[i].port, _ip_type);
+			msgs[i].msg_hdr.msg_iov = &iovs[i];
+			msgs[i].msg_hdr.msg_iovlen = 1;
+		}
+
+		int ret = sendmmsg(_sock, msgs, count, 0);
+		if (ret < 0) {
+			if (r_sent > 0)
+				break;
+			if (_get_socket_error() == ERR_NET_WOULD_BLOCK)
+				return ERR_BUSY;
+			return FAILED;
+		}
+		r_sent += ret;
+
+		if (ret < count)
+			break; // send buffer full
+	}
+#else
+	while (r_sent < p_count) {
+
+		const Datagram &datagram = p_datagrams[r_sent];
+		struct sockaddr_storage addr;
+		size_t addr_size = _set_addr_storage(&addr, datagram.ip, datagram.port, _ip_type);
+		int ret = ::sendto(_sock, SOCK_CBUF(datagram.buffer), datagram.size, 0, (struct sockaddr *)&addr, addr_size);
+		if (ret < 0) {
+			if (r_sent > 0)
+				break;
+			if (_get_socket_error() == ERR_NET_WOULD_BLOCK)
+				return ERR_BUSY;
+			return FAILED;
+		}
+		r_sent++;
+	}
+#endif
+
+	return OK;
+}
+
 void NetSocketPosix::set_broadcasting_enabled(bool p_enabled) {
 	ERR_FAIL_COND(!is_open());
 	// IPv6 has no broadcast support.
@@ -550,3 +742,199 @@ Ref<NetSocket> NetSocketPosix::accept(IP_Address &r_ip, uint16_t &r_port) {
 	ns->set_blocking_enabled(false);
 	return Ref<NetSocket>(ns);
 }
+
+NetSocketPollGroup *NetSocketPollGroupPosix::_create_func() {
+	return memnew(NetSocketPollGroupPosix);
+}
+
+void NetSocketPollGroupPosix::make_default() {
+	_create = _create_func;
+}
+
+static short _get_poll_events(NetSocket::PollType p_type) {
+
+	switch (p_type) {
+		case NetSocket::POLL_TYPE_OUT: return POLLOUT;
+		case NetSocket::POLL_TYPE_IN_OUT: return POLLIN | POLLOUT;
+		default: return POLLIN;
+	}
+}
+
+void NetSocketPollGroupPosix::_socket_changed(NetSocketPosix *p_socket, SOCKET_TYPE p_old_sock) {
+
+#ifdef EPOLL_ENABLED
+	if (epoll_fd != -1) {
+
+		if (p_old_sock != SOCK_EMPTY) {
+			struct epoll_event ev; // ignored, but kernels before 2.6.9 require it
+			epoll_ctl(epoll_fd, EPOLL_CTL_DEL, p_old_sock, &ev);
+		}
+
+		if (p_socket->_sock != SOCK_EMPTY) {
+			struct epoll_event ev;
+			ev.events = (p_socket->_poll_type == NetSocket::POLL_TYPE_IN ? 0 : EPOLLOUT) | (p_socket->_poll_type == NetSocket::POLL_TYPE_OUT ? 0 : EPOLLIN);
+			ev.data.ptr = p_socket;
+			if (epoll_ctl(epoll_fd, EPOLL_CTL_ADD, p_socket->_sock, &ev) != 0) {
+				ERR_PRINT("Unable to add socket to epoll set");
+			}
+		}
+		return;
+	}
+#endif
+
+	pollfds.write[p_socket->_poll_index].fd = p_socket->_sock;
+	pollfds.write[p_socket->_poll_index].revents = 0;
+}
+
+void NetSocketPollGroupPosix::_remove_socket(NetSocketPosix *p_socket) {
+
+	if (p_socket->_sock != SOCK_EMPTY) {
+		SOCKET_TYPE sock = p_socket->_sock;
+		p_socket->_sock = SOCK_EMPTY;
+		_socket_changed(p_socket, sock);
+		p_socket->_sock = sock;
+	}
+
+	// swap with the last one, so removing stays O(1)
+	int index = p_socket->_poll_index;
+	int last = sockets.size() - 1;
+	if (index != last) {
+		sockets.write[index] = sockets[last];
+		sockets[index]->_poll_index = index;
+		pollfds.write[index] = pollfds[last];
+	}
+	sockets.resize(last);
+	pollfds.resize(last);
+
+	p_socket->_poll_group = NULL;
+	p_socket->_poll_index = -1;
+}
+
+Error NetSocketPollGroupPosix::add(const Ref<NetSocket> &p_socket, NetSocket::PollType p_type, uint64_t p_userdata) {
+
+	ERR_FAIL_COND_V(p_socket.is_null(), ERR_INVALID_PARAMETER);
+	// the only kind of socket there is when this group is the default one
+	NetSocketPosix *socket = static_cast<NetSocketPosix *>(const_cast<NetSocket *>(p_socket.ptr()));
+	ERR_FAIL_COND_V(socket->_poll_group != NULL, ERR_ALREADY_IN_USE);
+
+	socket->_poll_group = this;
+	socket->_poll_index = sockets.size();
+	socket->_poll_type = p_type;
+	socket->_poll_userdata = p_userdata;
+	sockets.push_back(socket);
+
+	struct pollfd pfd;
+	pfd.fd = SOCK_EMPTY;
+	pfd.events = _get_poll_events(p_type);
+	pfd.revents = 0;
+	pollfds.push_back(pfd);
+
+	if (socket->_sock != SOCK_EMPTY) {
+		_socket_changed(socket, SOCK_EMPTY);
+	}
+
+	return OK;
+}
+
+void NetSocketPollGroupPosix::remove(const Ref<NetSocket> &p_socket) {
+
+	ERR_FAIL_COND(p_socket.is_null());
+	NetSocketPosix *socket = static_cast<NetSocketPosix *>(const_cast<NetSocket *>(p_socket.ptr()));
+	ERR_FAIL_COND(socket->_poll_group != this);
+
+	_remove_socket(socket);
+}
+
+bool NetSocketPollGroupPosix::has(const Ref<NetSocket> &p_socket) const {
+
+	return p_socket.is_valid() && static_cast<const NetSocketPosix *>(p_socket.ptr())->_poll_group == this;
+}
+
+int NetSocketPollGroupPosix::get_socket_count() const {
+
+	return sockets.size();
+}
+
+int NetSocketPollGroupPosix::wait(int p_timeout, Event *r_events, int p_max_events) {
+
+	ERR_FAIL_COND_V(p_max_events <= 0, -1);
+
+#ifdef EPOLL_ENABLED
+	if (epoll_fd != -1) {
+
+		if (epoll_events.size() < p_max_events) {
+			epoll_events.resize(p_max_events);
+		}
+
+		int ret = epoll_wait(epoll_fd, epoll_events.ptrw(), p_max_events, p_timeout);
+		if (ret < 0) {
+			return errno == EINTR ? 0 : -1;
+		}
+
+		for (int i = 0; i < ret; i++) {
+			const struct epoll_event &ev = epoll_events[i];
+			NetSocketPosix *socket = (NetSocketPosix *)ev.data.ptr;
+			r_events[i].userdata = socket->_poll_userdata;
+			r_events[i].readable = ev.events & EPOLLIN;
+			r_events[i].writable = ev.events & EPOLLOUT;
+			r_events[i].hangup = ev.events & (EPOLLHUP | EPOLLERR);
+		}
+		return ret;
+	}
+#endif
+
+	int count = pollfds.size();
+	if (count == 0) {
+		if (p_timeout != 0) {
+			OS::get_singleton()->delay_usec(p_timeout > 0 ? p_timeout * 1000 : 1000);
+		}
+		return 0;
+	}
+
+	int ret = SOCK_POLL(pollfds.ptrw(), count, p_timeout);
+	if (ret < 0) {
+		return -1;
+	}
+
+	// level triggered like epoll, so start each scan where the last one stopped, or sockets
+	// at the end could starve when more than p_max_events are ready
+	int found = 0;
+	for (int i = 0; i < count && found < ret && found < p_max_events; i++) {
+		int index = (poll_offset + i) % count;
+		short revents = pollfds[index].revents;
+		if (!revents) {
+			continue;
+		}
+		r_events[found].userdata = sockets[index]->_poll_userdata;
+		r_events[found].readable = revents & POLLIN;
+		r_events[found].writable = revents & POLLOUT;
+		r_events[found].hangup = revents & (POLLHUP | POLLERR);
+		found++;
+		poll_offset = index + 1;
+	}
+	return found;
+}
+
+NetSocketPollGroupPosix::NetSocketPollGroupPosix() {
+
+	poll_offset = 0;
+#ifdef EPOLL_ENABLED
+	epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+	if (epoll_fd == -1) {
+		WARN_PRINT("Unable to create epoll instance, falling back to poll()");
+	}
+#endif
+}
+
+NetSocketPollGroupPosix::~NetSocketPollGroupPosix() {
+
+	while (sockets.size()) {
+		_remove_socket(sockets[sockets.size() - 1]);
+	}
+
+#ifdef EPOLL_ENABLED
+	if (epoll_fd != -1) {
+		SOCK_CLOSE(epoll_fd);
+	}
+#endif
+}
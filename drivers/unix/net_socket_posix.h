@@ -39,17 +39,35 @@
 #define SOCKET_TYPE SOCKET
 
 #else
+#include <poll.h>
 #define SOCKET_TYPE int
 
+#if defined(__linux__) && !defined(JAVASCRIPT_ENABLED)
+#include <sys/epoll.h>
+#define EPOLL_ENABLED
+#if !defined(ANDROID_ENABLED) || __ANDROID_API__ >= 21
+#define MMSG_ENABLED
+#endif
+#endif
+
 #endif
 
+class NetSocketPollGroupPosix;
+
 class NetSocketPosix : public NetSocket {
 
+	friend class NetSocketPollGroupPosix;
+
 private:
 	SOCKET_TYPE _sock;
 	IP::Type _ip_type;
 	bool _is_stream;
 
+	NetSocketPollGroupPosix *_poll_group;
+	int _poll_index;
+	PollType _poll_type;
+	uint64_t _poll_userdata;
+
 	enum NetError {
 		ERR_NET_WOULD_BLOCK,
 		ERR_NET_IS_CONNECTED,
@@ -79,6 +97,8 @@ public:
 	virtual Error recvfrom(uint8_t *p_buffer, int p_len, int &r_read, IP_Address &r_ip, uint16_t &r_port);
 	virtual Error send(const uint8_t *p_buffer, int p_len, int &r_sent);
 	virtual Error sendto(const uint8_t *p_buffer, int p_len, int &r_sent, IP_Address p_ip, uint16_t p_port);
+	virtual Error recvfrom_batch(Datagram *p_datagrams, int p_count, int &r_received);
+	virtual Error sendto_batch(const Datagram *p_datagrams, int p_count, int &r_sent);
 	virtual Ref<NetSocket> accept(IP_Address &r_ip, uint16_t &r_port);
 
 	virtual bool is_open() const;
@@ -95,4 +115,37 @@ public:
 	~NetSocketPosix();
 };
 
+class NetSocketPollGroupPosix : public NetSocketPollGroup {
+
+	friend class NetSocketPosix;
+
+	Vector<NetSocketPosix *> sockets;
+	// used when epoll is not available, kept in the same order as sockets
+	Vector<struct pollfd> pollfds;
+	int poll_offset;
+
+#ifdef EPOLL_ENABLED
+	int epoll_fd;
+	Vector<struct epoll_event> epoll_events;
+#endif
+
+	void _socket_changed(NetSocketPosix *p_socket, SOCKET_TYPE p_old_sock);
+	void _remove_socket(NetSocketPosix *p_socket);
+
+	static NetSocketPollGroup *_create_func();
+
+public:
+	static void make_default();
+
+	virtual Error add(const Ref<NetSocket> &p_socket, NetSocket::PollType p_type, uint64_t p_userdata);
+	virtual void remove(const Ref<NetSocket> &p_socket);
+	virtual bool has(const Ref<NetSocket> &p_socket) const;
+	virtual int get_socket_count() const;
+
+	virtual int wait(int p_timeout, Event *r_events, int p_max_events);
+
+	NetSocketPollGroupPosix();
+	~NetSocketPollGroupPosix();
+};
+
 #endif
@@ -31,6 +31,7 @@
 #include "editor_export.h"
 
 #include "core/io/config_file.h"
+#include "core/io/file_access_pack.h"
 #include "core/io/resource_loader.h"
 #include "core/io/resource_saver.h"
 #include "core/io/zip_io.h"
@@ -281,9 +282,23 @@ Error EditorExportPlatform::_save_pack_file(void *p_userdata, const String &p_pa
 	sd.path_utf8 = p_path.utf8();
 	sd.ofs = pd->f->get_position();
 	sd.size = p_data.size();
+	sd.stored_size = sd.size;
+	sd.compressed = false;
 
-	pd->f->store_buffer(p_data.ptr(), p_data.size());
-	int pad = _get_pad(PCK_PADDING, sd.size);
+	Vector<uint8_t> compressed;
+	if (pd->compress && p_data.size() > 0) {
+		compressed = PackedSourcePCK::compress_file_data(p_data.ptr(), p_data.size(), Compression::MODE_ZSTD);
+		// Already compressed formats (textures, audio) often don't shrink, keep those as is.
+		sd.compressed = compressed.size() > 0 && compressed.size() < p_data.size();
+	}
+
+	if (sd.compressed) {
+		sd.stored_size = compressed.size();
+		pd->f->store_buffer(compressed.ptr(), compressed.size());
+	} else {
+		pd->f->store_buffer(p_data.ptr(), p_data.size());
+	}
+	int pad = _get_pad(PCK_PADDING, sd.stored_size);
 	for (int i = 0; i < pad; i++) {
 		pd->f->store_8(0);
 	}
@@ -821,6 +836,7 @@ Error EditorExportPlatform::save_pack(const Ref<EditorExportPreset> &p_preset, c
 	pd.ep = &ep;
 	pd.f = ftmp;
 	pd.so_files = p_so_files;
+	pd.compress = GLOBAL_GET("editor/compress_pack_files_on_export");
 
 	Error err = export_project_files(p_preset, _save_pack_file, &pd, _add_shared_object);
 
@@ -833,8 +849,8 @@ Error EditorExportPlatform::save_pack(const Ref<EditorExportPreset> &p_preset, c
 
 	FileAccess *f = FileAccess::open(p_path, FileAccess::WRITE);
 	ERR_FAIL_COND_V(!f, ERR_CANT_CREATE)
-	f->store_32(0x43504447); //GDPK
-	f->store_32(1); //pack version
+	f->store_32(PACK_HEADER_MAGIC); //GDPK
+	f->store_32(PACK_FORMAT_VERSION); //pack version
 	f->store_32(VERSION_MAJOR);
 	f->store_32(VERSION_MINOR);
 	f->store_32(0); //hmph
@@ -845,35 +861,34 @@ Error EditorExportPlatform::save_pack(const Ref<EditorExportPreset> &p_preset, c
 
 	f->store_32(pd.file_ofs.size()); //amount of files
 
-	size_t header_size = f->get_position();
-
-	//precalculate header size
-
+	uint32_t strings_size = 0;
 	for (int i = 0; i < pd.file_ofs.size(); i++) {
-		header_size += 4; // size of path string (32 bits is enough)
-		uint32_t string_len = pd.file_ofs[i].path_utf8.length();
-		header_size += string_len + _get_pad(4, string_len); ///size of path string
-		header_size += 8; // offset to file _with_ header size included
-		header_size += 8; // size of file
-		header_size += 16; // md5
+		strings_size += pd.file_ofs[i].path_utf8.length();
 	}
+	f->store_32(strings_size);
 
+	//index records are fixed size, followed by all the paths
+
+	size_t header_size = f->get_position() + pd.file_ofs.size() * PACK_INDEX_ENTRY_SIZE + strings_size;
 	size_t header_padding = _get_pad(PCK_PADDING, header_size);
 
+	uint32_t path_ofs = 0;
 	for (int i = 0; i < pd.file_ofs.size(); i++) {
 
-		uint32_t string_len = pd.file_ofs[i].path_utf8.length();
-		uint32_t pad = _get_pad(4, string_len);
-		;
-		f->store_32(string_len + pad);
-		f->store_buffer((const uint8_t *)pd.file_ofs[i].path_utf8.get_data(), string_len);
-		for (uint32_t j = 0; j < pad; j++) {
-			f->store_8(0);
-		}
+		const SavedData &sd = pd.file_ofs[i];
+		f->store_64(sd.ofs + header_padding + header_size);
+		f->store_64(sd.size); // pay attention here, this is where file is
+		f->store_64(sd.stored_size);
+		f->store_buffer(sd.md5.ptr(), 16); //also save md5 for file
+		f->store_32(path_ofs);
+		f->store_32(sd.path_utf8.length());
+		f->store_32(sd.compressed ? PACK_FILE_COMPRESSED : 0);
+		f->store_32(Compression::MODE_ZSTD);
+		path_ofs += sd.path_utf8.length();
+	}
 
-		f->store_64(pd.file_ofs[i].ofs + header_padding + header_size);
-		f->store_64(pd.file_ofs[i].size); // pay attention here, this is where file is
-		f->store_buffer(pd.file_ofs[i].md5.ptr(), 16); //also save md5 for file
+	for (int i = 0; i < pd.file_ofs.size(); i++) {
+		f->store_buffer((const uint8_t *)pd.file_ofs[i].path_utf8.get_data(), pd.file_ofs[i].path_utf8.length());
 	}
 
 	for (uint32_t j = 0; j < header_padding; j++) {
@@ -901,7 +916,7 @@ Error EditorExportPlatform::save_pack(const Ref<EditorExportPreset> &p_preset, c
 
 	memdelete(ftmp);
 
-	f->store_32(0x43504447); //GDPK
+	f->store_32(PACK_HEADER_MAGIC); //GDPK
 	memdelete(f);
 
 	return OK;
@@ -1236,6 +1251,8 @@ EditorExport::EditorExport() {
 	save_timer->connect("timeout", this, "_save");
 	block_save = false;
 
+	GLOBAL_DEF("editor/compress_pack_files_on_export", false);
+
 	singleton = this;
 }
 
@@ -144,6 +144,8 @@ private:
 
 		uint64_t ofs;
 		uint64_t size;
+		uint64_t stored_size;
+		bool compressed;
 		Vector<uint8_t> md5;
 		CharString path_utf8;
 
@@ -156,6 +158,7 @@ private:
 
 		FileAccess *f;
 		Vector<SavedData> file_ofs;
+		bool compress;
 		EditorProgress *ep;
 		Vector<SharedObject> *so_files;
 	};
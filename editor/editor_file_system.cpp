@@ -37,6 +37,7 @@
 #include "core/os/os.h"
 #include "core/project_settings.h"
 #include "core/variant_parser.h"
+#include "core/version.h"
 #include "editor_node.h"
 #include "editor_resource_preview.h"
 #include "editor_settings.h"
@@ -1462,12 +1463,11 @@ void EditorFileSystem::update_file(const String &p_file) {
 	_queue_update_script_classes();
 }
 
-void EditorFileSystem::_reimport_file(const String &p_file) {
+// Runs the importer and writes the .import/.md5 files. This may be called from import threads
+// (when the importer allows it), so it must not touch the filesystem tree, see _reimport_file_done().
+void EditorFileSystem::_reimport_file(ImportFile &r_file) {
 
-	EditorFileSystemDirectory *fs = NULL;
-	int cpos = -1;
-	bool found = _find_file(p_file, &fs, cpos);
-	ERR_FAIL_COND(!found);
+	const String &p_file = r_file.path;
 
 	//try to obtain existing params
 
@@ -1493,7 +1493,7 @@ void EditorFileSystem::_reimport_file(const String &p_file) {
 		}
 
 	} else {
-		late_added_files.insert(p_file); //imported files do not call update_file(), but just in case..
+		r_file.added = true;
 	}
 
 	Ref<ResourceImporter> importer;
@@ -1534,13 +1534,42 @@ void EditorFileSystem::_reimport_file(const String &p_file) {
 		}
 	}
 
+	//options are stored in provided order, to avoid file changing. Order is also important because first match is accepted first.
+
+	Vector<String> option_lines;
+	for (List<ResourceImporter::ImportOption>::Element *E = opts.front(); E; E = E->next()) {
+
+		String base = E->get().option.name;
+		String value;
+		VariantWriter::write_to_string(params[base], value);
+		option_lines.push_back(base + "=" + value);
+	}
+
+	String source_md5 = FileAccess::get_md5(p_file);
+
 	//finally, perform import!!
 	String base_path = ResourceFormatImporter::get_singleton()->get_import_base_path(p_file);
 
 	List<String> import_variants;
 	List<String> gen_files;
 
-	Error err = importer->import(p_file, base_path, params, &import_variants, &gen_files);
+	String cache_key;
+	if (import_cache_path != String() && importer->can_cache_import()) {
+		cache_key = _get_import_cache_key(p_file, source_md5, importer, option_lines);
+	}
+
+	Error err;
+	bool from_cache = false;
+	if (cache_key != String() && _load_from_import_cache(cache_key, &import_variants, &gen_files)) {
+		err = OK;
+		from_cache = true;
+		atomic_increment(&import_cache_hits);
+	} else {
+		err = importer->import(p_file, base_path, params, &import_variants, &gen_files);
+		if (cache_key != String()) {
+			atomic_increment(&import_cache_misses);
+		}
+	}
 
 	if (err != OK) {
 		ERR_PRINTS("Error importing: " + p_file);
@@ -1615,51 +1644,245 @@ void EditorFileSystem::_reimport_file(const String &p_file) {
 	f->store_line("[params]");
 	f->store_line("");
 
-	//store options in provided order, to avoid file changing. Order is also important because first match is accepted first.
-
-	for (List<ResourceImporter::ImportOption>::Element *E = opts.front(); E; E = E->next()) {
-
-		String base = E->get().option.name;
-		String value;
-		VariantWriter::write_to_string(params[base], value);
-		f->store_line(base + "=" + value);
+	for (int i = 0; i < option_lines.size(); i++) {
+		f->store_line(option_lines[i]);
 	}
 
 	f->close();
 	memdelete(f);
 
+	if (err == OK && cache_key != String() && !from_cache) {
+		_store_in_import_cache(cache_key, dest_paths, import_variants, gen_files);
+	}
+
 	// Store the md5's of the various files. These are stored separately so that the .import files can be version controlled.
 	FileAccess *md5s = FileAccess::open(base_path + ".md5", FileAccess::WRITE);
 	ERR_FAIL_COND(!md5s);
-	md5s->store_line("source_md5=\"" + FileAccess::get_md5(p_file) + "\"");
+	md5s->store_line("source_md5=\"" + source_md5 + "\"");
 	if (dest_paths.size()) {
 		md5s->store_line("dest_md5=\"" + FileAccess::get_multiple_md5(dest_paths) + "\"\n");
 	}
 	md5s->close();
 	memdelete(md5s);
 
+	r_file.type = importer->get_resource_type();
+	r_file.imported = true;
+}
+
+String EditorFileSystem::_get_import_cache_key(const String &p_file, const String &p_source_md5, const Ref<ResourceImporter> &p_importer, const Vector<String> &p_options) const {
+
+	String key = p_file + "\n" + p_source_md5 + "\n" VERSION_FULL_CONFIG "\n";
+	key += p_importer->get_importer_name() + "\n" + itos(p_importer->get_format_version()) + "\n" + p_importer->get_import_settings_string() + "\n";
+	for (int i = 0; i < p_options.size(); i++) {
+		key += p_options[i] + "\n";
+	}
+
+	return key.md5_text();
+}
+
+String EditorFileSystem::_get_import_cache_dir(const String &p_key) const {
+
+	return import_cache_path.plus_file(p_key.substr(0, 2)).plus_file(p_key);
+}
+
+bool EditorFileSystem::_load_from_import_cache(const String &p_key, List<String> *r_import_variants, List<String> *r_gen_files) {
+
+	String dir = _get_import_cache_dir(p_key);
+
+	Ref<ConfigFile> manifest;
+	manifest.instance();
+	if (manifest->load(dir.plus_file("manifest.cfg")) != OK) {
+		return false;
+	}
+
+	Array files = manifest->get_value("cache", "files", Array());
+	Array md5s = manifest->get_value("cache", "md5s", Array());
+	if (md5s.size() != files.size()) {
+		return false;
+	}
+
+	// check every file before touching the destinations, a damaged entry is just a miss
+	for (int i = 0; i < files.size(); i++) {
+		if (FileAccess::get_md5(dir.plus_file(itos(i))) != String(md5s[i])) {
+			return false;
+		}
+	}
+
+	DirAccessRef da = DirAccess::create(DirAccess::ACCESS_FILESYSTEM);
+
+	for (int i = 0; i < files.size(); i++) {
+
+		String dest = files[i];
+		da->make_dir_recursive(ProjectSettings::get_singleton()->globalize_path(dest.get_base_dir()));
+		if (da->copy(dir.plus_file(itos(i)), dest) != OK) {
+			return false;
+		}
+	}
+
+	Array variants = manifest->get_value("cache", "variants", Array());
+	for (int i = 0; i < variants.size(); i++) {
+		r_import_variants->push_back(variants[i]);
+	}
+
+	Array gen_files = manifest->get_value("cache", "gen_files", Array());
+	for (int i = 0; i < gen_files.size(); i++) {
+		r_gen_files->push_back(gen_files[i]);
+	}
+
+	return true;
+}
+
+void EditorFileSystem::_store_in_import_cache(const String &p_key, const Vector<String> &p_dest_paths, const List<String> &p_import_variants, const List<String> &p_gen_files) {
+
+	String dir = _get_import_cache_dir(p_key);
+	if (DirAccess::exists(dir)) {
+		return; //stored meanwhile by another editor
+	}
+
+	// the entry is assembled in a private directory and renamed into place, so other editors
+	// sharing the cache, or a crash halfway through, never see it incomplete
+	String tmp_dir = dir + ".tmp-" + itos(OS::get_singleton()->get_process_id()) + "-" + itos(OS::get_singleton()->get_ticks_usec());
+
+	DirAccessRef da = DirAccess::create(DirAccess::ACCESS_FILESYSTEM);
+	if (da->make_dir_recursive(tmp_dir) != OK) {
+		ERR_PRINTS("Can't create import cache directory: " + tmp_dir);
+		return;
+	}
+
+	Array files;
+	Array md5s;
+	for (int i = 0; i < p_dest_paths.size(); i++) {
+
+		String cached = tmp_dir.plus_file(itos(i));
+		if (da->copy(p_dest_paths[i], cached) != OK) {
+			_remove_import_cache_dir(tmp_dir);
+			return;
+		}
+		files.push_back(p_dest_paths[i]);
+		md5s.push_back(FileAccess::get_md5(cached));
+	}
+
+	Array variants;
+	for (const List<String>::Element *E = p_import_variants.front(); E; E = E->next()) {
+		variants.push_back(E->get());
+	}
+
+	Array gen_files;
+	for (const List<String>::Element *E = p_gen_files.front(); E; E = E->next()) {
+		gen_files.push_back(E->get());
+	}
+
+	//the manifest goes last, entries without one are ignored
+	Ref<ConfigFile> manifest;
+	manifest.instance();
+	manifest->set_value("cache", "files", files);
+	manifest->set_value("cache", "md5s", md5s);
+	manifest->set_value("cache", "variants", variants);
+	manifest->set_value("cache", "gen_files", gen_files);
+	if (manifest->save(tmp_dir.plus_file("manifest.cfg")) != OK || da->rename(tmp_dir, dir) != OK) {
+		//most likely another editor stored the same entry first
+		_remove_import_cache_dir(tmp_dir);
+	}
+}
+
+void EditorFileSystem::_remove_import_cache_dir(const String &p_dir) {
+
+	DirAccessRef da = DirAccess::open(p_dir);
+	if (!da) {
+		return;
+	}
+	da->erase_contents_recursive();
+	da->change_dir("..");
+	da->remove(p_dir);
+}
+
+void EditorFileSystem::_reimport_file_done(const ImportFile &p_file) {
+
+	if (!p_file.imported)
+		return;
+
+	const String &p_path = p_file.path;
+
+	EditorFileSystemDirectory *fs = NULL;
+	int cpos = -1;
+	bool found = _find_file(p_path, &fs, cpos);
+	ERR_FAIL_COND(!found);
+
+	if (p_file.added) {
+		late_added_files.insert(p_path); //imported files do not call update_file(), but just in case..
+	}
+
 	//update modified times, to avoid reimport
-	fs->files[cpos]->modified_time = FileAccess::get_modified_time(p_file);
-	fs->files[cpos]->import_modified_time = FileAccess::get_modified_time(p_file + ".import");
-	fs->files[cpos]->deps = _get_dependencies(p_file);
-	fs->files[cpos]->type = importer->get_resource_type();
-	fs->files[cpos]->import_valid = ResourceLoader::is_import_valid(p_file);
+	fs->files[cpos]->modified_time = FileAccess::get_modified_time(p_path);
+	fs->files[cpos]->import_modified_time = FileAccess::get_modified_time(p_path + ".import");
+	fs->files[cpos]->deps = _get_dependencies(p_path);
+	fs->files[cpos]->type = p_file.type;
+	fs->files[cpos]->import_valid = ResourceLoader::is_import_valid(p_path);
 
 	//if file is currently up, maybe the source it was loaded from changed, so import math must be updated for it
 	//to reload properly
-	if (ResourceCache::has(p_file)) {
+	if (ResourceCache::has(p_path)) {
 
-		Resource *r = ResourceCache::get(p_file);
+		Resource *r = ResourceCache::get(p_path);
 
 		if (r->get_import_path() != String()) {
 
-			String dst_path = ResourceFormatImporter::get_singleton()->get_internal_resource_path(p_file);
+			String dst_path = ResourceFormatImporter::get_singleton()->get_internal_resource_path(p_path);
 			r->set_import_path(dst_path);
 			r->set_import_last_modified_time(0);
 		}
 	}
 
-	EditorResourcePreview::get_singleton()->check_for_invalidation(p_file);
+	EditorResourcePreview::get_singleton()->check_for_invalidation(p_path);
+}
+
+void EditorFileSystem::_reimport_thread(void *p_userdata) {
+
+	ImportThreadData *data = (ImportThreadData *)p_userdata;
+
+	while (true) {
+		uint32_t index = atomic_increment(&data->index) - 1;
+		if (index >= data->count)
+			break;
+		data->efs->_reimport_file(data->files[index]);
+		atomic_increment(&data->done);
+	}
+}
+
+void EditorFileSystem::_reimport_files_threaded(ImportFile *p_files, int p_count, EditorProgress &p_progress, int p_progress_from) {
+
+	ImportThreadData data;
+	data.efs = this;
+	data.files = p_files;
+	data.count = p_count;
+	data.index = 0;
+	data.done = 0;
+
+	Vector<Thread *> threads;
+	int thread_count = MIN(OS::get_singleton()->get_processor_count(), p_count);
+	for (int i = 0; i < thread_count; i++) {
+		Thread *thread = Thread::create(_reimport_thread, &data);
+		if (thread) {
+			threads.push_back(thread);
+		}
+	}
+
+	if (threads.empty()) {
+		//no threads available, import from here
+		_reimport_thread(&data);
+	}
+
+	//this thread only reports progress, as stepping it also runs the main loop
+	while (data.done < data.count) {
+		uint32_t done = data.done;
+		p_progress.step(p_files[MIN(done, data.count - 1)].path.get_file(), p_progress_from + done, false);
+		OS::get_singleton()->delay_usec(10000);
+	}
+
+	for (int i = 0; i < threads.size(); i++) {
+		Thread::wait_to_finish(threads[i]);
+		memdelete(threads[i]);
+	}
 }
 
 void EditorFileSystem::reimport_files(const Vector<String> &p_files) {
@@ -1677,24 +1900,60 @@ void EditorFileSystem::reimport_files(const Vector<String> &p_files) {
 		memdelete(da);
 	}
 
+	import_cache_path = EditorSettings::get_singleton()->get("filesystem/import/import_cache_path");
+	import_cache_hits = 0;
+	import_cache_misses = 0;
+
 	importing = true;
 	EditorProgress pr("reimport", TTR("(Re)Importing Assets"), p_files.size());
 
 	Vector<ImportFile> files;
 
 	for (int i = 0; i < p_files.size(); i++) {
+		EditorFileSystemDirectory *fs = NULL;
+		int cpos = -1;
+		if (!_find_file(p_files[i], &fs, cpos)) {
+			ERR_PRINTS("Can't reimport file not in the filesystem: " + p_files[i]);
+			continue;
+		}
+
 		ImportFile ifile;
 		ifile.path = p_files[i];
 		ifile.order = ResourceFormatImporter::get_singleton()->get_import_order(p_files[i]);
+		ifile.threaded = use_threads && ResourceFormatImporter::get_singleton()->can_import_threaded(p_files[i]);
+		ifile.added = false;
+		ifile.imported = false;
 		files.push_back(ifile);
 	}
 
 	files.sort();
 
 	for (int i = 0; i < files.size(); i++) {
-		pr.step(files[i].path.get_file(), i);
 
-		_reimport_file(files[i].path);
+		if (!files[i].threaded) {
+			pr.step(files[i].path.get_file(), i);
+			_reimport_file(files.write[i]);
+			_reimport_file_done(files[i]);
+			continue;
+		}
+
+		//files with the same import order don't depend on each other, import them all at once
+		int to = i + 1;
+		while (to < files.size() && files[to].threaded && files[to].order == files[i].order) {
+			to++;
+		}
+
+		_reimport_files_threaded(&files.write[i], to - i, pr, i);
+
+		for (int j = i; j < to; j++) {
+			_reimport_file_done(files[j]);
+		}
+
+		i = to - 1;
+	}
+
+	if (import_cache_path != String()) {
+		print_line("Import cache: " + itos(import_cache_hits) + " hits, " + itos(import_cache_misses) + " misses.");
 	}
 
 	_save_filesystem_cache();
@@ -1756,6 +2015,8 @@ EditorFileSystem::EditorFileSystem() {
 	scanning = false;
 	importing = false;
 	use_threads = true;
+	import_cache_hits = 0;
+	import_cache_misses = 0;
 	thread_sources = NULL;
 	new_filesystem = NULL;
 
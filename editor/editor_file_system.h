@@ -38,6 +38,8 @@
 #include "scene/main/node.h"
 class FileAccess;
 
+class ResourceImporter;
+struct EditorProgress;
 struct EditorProgressBG;
 class EditorFileSystemDirectory : public Object {
 
@@ -208,8 +210,6 @@ class EditorFileSystem : public Node {
 
 	void _update_extensions();
 
-	void _reimport_file(const String &p_file);
-
 	bool _test_for_reimport(const String &p_path, bool p_only_imported_files);
 
 	bool reimport_on_missing_imported_files;
@@ -219,11 +219,39 @@ class EditorFileSystem : public Node {
 	struct ImportFile {
 		String path;
 		int order;
+		bool threaded;
+		bool added; // had no .import file yet
+		bool imported; // set by _reimport_file, along with type
+		String type;
 		bool operator<(const ImportFile &p_if) const {
-			return order < p_if.order;
+			// within the same order, run the serial importers before the threaded ones
+			return order == p_if.order ? (!threaded && p_if.threaded) : order < p_if.order;
 		}
 	};
 
+	struct ImportThreadData {
+		EditorFileSystem *efs;
+		ImportFile *files;
+		uint32_t count;
+		volatile uint32_t index;
+		volatile uint32_t done;
+	};
+
+	String import_cache_path; // shared import cache directory, disabled when empty
+	volatile uint32_t import_cache_hits;
+	volatile uint32_t import_cache_misses;
+
+	String _get_import_cache_key(const String &p_file, const String &p_source_md5, const Ref<ResourceImporter> &p_importer, const Vector<String> &p_options) const;
+	String _get_import_cache_dir(const String &p_key) const;
+	bool _load_from_import_cache(const String &p_key, List<String> *r_import_variants, List<String> *r_gen_files);
+	void _store_in_import_cache(const String &p_key, const Vector<String> &p_dest_paths, const List<String> &p_import_variants, const List<String> &p_gen_files);
+	void _remove_import_cache_dir(const String &p_dir);
+
+	void _reimport_file(ImportFile &r_file);
+	void _reimport_file_done(const ImportFile &p_file);
+	void _reimport_files_threaded(ImportFile *p_files, int p_count, EditorProgress &p_progress, int p_progress_from);
+	static void _reimport_thread(void *p_userdata);
+
 	void _scan_script_classes(EditorFileSystemDirectory *p_dir);
 	volatile bool update_script_classes_queued;
 	void _queue_update_script_classes();
@@ -65,6 +65,12 @@ bool ResourceImporterLayeredTexture::get_option_visibility(const String &p_optio
 	return true;
 }
 
+String ResourceImporterLayeredTexture::get_import_settings_string() const {
+
+	// import() reads the same VRAM compression settings as regular textures, nothing else.
+	return ResourceImporterTexture::get_singleton()->get_import_settings_string();
+}
+
 int ResourceImporterLayeredTexture::get_preset_count() const {
 	return 3;
 }
@@ -358,6 +358,21 @@ void ResourceImporterTexture::_save_stex(const Ref<Image> &p_image, const String
 	memdelete(f);
 }
 
+String ResourceImporterTexture::get_import_settings_string() const {
+
+	String s;
+
+	static const char *compression_formats[] = { "bptc", "s3tc", "etc", "etc2", "pvrtc", NULL };
+	for (int i = 0; compression_formats[i]; i++) {
+		String setting = String("rendering/vram_compression/import_") + compression_formats[i];
+		if (ProjectSettings::get_singleton()->get(setting)) {
+			s += compression_formats[i];
+		}
+	}
+
+	return s;
+}
+
 Error ResourceImporterTexture::import(const String &p_source_file, const String &p_save_path, const Map<StringName, Variant> &p_options, List<String> *r_platform_variants, List<String> *r_gen_files) {
 
 	int compress_mode = p_options["compress/mode"];
@@ -499,7 +514,11 @@ Error ResourceImporterTexture::import(const String &p_source_file, const String
 		}
 
 		if (!ok_on_pc) {
-			EditorNode::add_io_error("Warning, no suitable PC VRAM compression enabled in Project Settings. This texture will not display correctly on PC.");
+			if (Thread::get_caller_id() == Thread::get_main_id()) {
+				EditorNode::add_io_error("Warning, no suitable PC VRAM compression enabled in Project Settings. This texture will not display correctly on PC.");
+			} else {
+				WARN_PRINTS("No suitable PC VRAM compression enabled in Project Settings, " + p_source_file + " will not display correctly on PC.");
+			}
 		}
 	} else {
 		//import normally
@@ -62,6 +62,9 @@ public:
 	virtual void get_recognized_extensions(List<String> *p_extensions) const;
 	virtual String get_save_extension() const;
 	virtual String get_resource_type() const;
+	virtual bool can_import_threaded() const { return true; }
+	virtual bool can_cache_import() const { return true; }
+	virtual String get_import_settings_string() const;
 
 	enum Preset {
 		PRESET_DETECT,
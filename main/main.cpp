@@ -770,6 +770,25 @@ Error Main::setup(const char *execpath, int argc, char *argv[], bool p_second_ph
 		OS::get_singleton()->add_logger(memnew(RotatedFileLogger(base_path, max_files)));
 	}
 
+	GLOBAL_DEF("logging/async_logging/enable", false);
+	GLOBAL_DEF("logging/async_logging/queue_size", 2048);
+	GLOBAL_DEF("logging/async_logging/flush_interval_msec", 200);
+	ProjectSettings::get_singleton()->set_custom_property_info("logging/async_logging/queue_size", PropertyInfo(Variant::INT, "logging/async_logging/queue_size", PROPERTY_HINT_RANGE, "16,65536,1,or_greater"));
+	ProjectSettings::get_singleton()->set_custom_property_info("logging/async_logging/flush_interval_msec", PropertyInfo(Variant::INT, "logging/async_logging/flush_interval_msec", PROPERTY_HINT_RANGE, "0,5000,1"));
+	if (GLOBAL_GET("logging/async_logging/enable")) {
+		OS::get_singleton()->set_async_logging(GLOBAL_GET("logging/async_logging/queue_size"), GLOBAL_GET("logging/async_logging/flush_interval_msec"));
+	}
+
+	{
+		static const char *category_names[Logger::CATEGORY_MAX] = { "engine", "script", "shader" };
+		for (int i = 0; i < Logger::CATEGORY_MAX; i++) {
+			String setting = String("logging/levels/") + category_names[i];
+			int level = GLOBAL_DEF(setting, Logger::LEVEL_INFO);
+			ProjectSettings::get_singleton()->set_custom_property_info(setting, PropertyInfo(Variant::INT, setting, PROPERTY_HINT_ENUM, "None,Error,Warning,Info"));
+			Logger::set_category_level(Logger::Category(i), Logger::Level(CLAMP(level, Logger::LEVEL_NONE, Logger::LEVEL_INFO)));
+		}
+	}
+
 #ifdef TOOLS_ENABLED
 	if (editor) {
 		Engine::get_singleton()->set_editor_hint(true);
@@ -1941,6 +1960,7 @@ void Main::cleanup() {
 		memdelete(audio_server);
 	}
 
+	OS::get_singleton()->stop_async_logging();
 	OS::get_singleton()->finalize();
 	finalize_physics();
 
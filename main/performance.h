@@ -78,6 +78,7 @@ public:
 		PHYSICS_3D_ISLAND_COUNT,
 		//physics
 		AUDIO_OUTPUT_LATENCY,
+		AUDIO_MIX_TIME,
 		MONITOR_MAX
 	};
 
@@ -92,6 +93,8 @@ public:
 
 	MonitorType get_monitor_type(Monitor p_monitor) const;
 
+	float get_audio_bus_dsp_time(int p_bus) const;
+
 	void set_process_time(float p_pt);
 	void set_physics_process_time(float p_pt);
 
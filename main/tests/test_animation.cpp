@@ -0,0 +1,122 @@
+/*************************************************************************/
+/*  test_animation.cpp                                                   */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2018 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2018 Godot Engine contributors (cf. AUTHORS.md)    */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#include "test_animation.h"
+
+#include "core/os/os.h"
+#include "scene/resources/animation.h"
+
+namespace TestAnimation {
+
+#define BONE_COUNT 60
+#define KEY_COUNT 300
+#define SAMPLE_COUNT 1000
+
+static Ref<Animation> _make_animation() {
+
+	Ref<Animation> anim;
+	anim.instance();
+	anim->set_length((KEY_COUNT - 1) / 30.0);
+
+	for (int i = 0; i < BONE_COUNT; i++) {
+
+		int track = anim->add_track(Animation::TYPE_TRANSFORM);
+		for (int j = 0; j < KEY_COUNT; j++) {
+
+			float t = j / 30.0;
+			Vector3 loc(Math::sin(t + i), Math::cos(t * 0.5) * 2.0, i * 0.1);
+			Quat rot(Vector3(0, 1, 0).rotated(Vector3(1, 0, 0), i * 0.1), t);
+			Vector3 scale(1, 1 + Math::sin(t) * 0.1, 1);
+			anim->transform_track_insert_key(track, t, loc, rot, scale);
+		}
+	}
+
+	return anim;
+}
+
+static uint64_t _sample(const Ref<Animation> &p_anim, bool p_use_cursor) {
+
+	int cursors[BONE_COUNT] = {};
+	Vector3 loc;
+	Quat rot;
+	Vector3 scale;
+
+	uint64_t begin = OS::get_singleton()->get_ticks_usec();
+
+	for (int i = 0; i < SAMPLE_COUNT; i++) {
+
+		float time = p_anim->get_length() * i / SAMPLE_COUNT;
+		for (int j = 0; j < BONE_COUNT; j++)
+			p_anim->transform_track_interpolate(j, time, &loc, &rot, &scale, p_use_cursor ? &cursors[j] : NULL);
+	}
+
+	return OS::get_singleton()->get_ticks_usec() - begin;
+}
+
+MainLoop *test() {
+
+	OS::get_singleton()->print("\n\nAnimation: %d tracks, %d keys each\n", BONE_COUNT, KEY_COUNT);
+
+	uint64_t mem_before = Memory::get_mem_usage();
+	Ref<Animation> anim = _make_animation();
+	uint64_t mem_plain = Memory::get_mem_usage() - mem_before;
+
+	Ref<Animation> compressed = _make_animation();
+	mem_before = Memory::get_mem_usage();
+	for (int i = 0; i < compressed->get_track_count(); i++)
+		compressed->transform_track_set_compressed(i, true);
+	uint64_t mem_compressed = mem_plain + Memory::get_mem_usage() - mem_before;
+
+	OS::get_singleton()->print("memory: %d bytes, compressed: %d bytes\n", int(mem_plain), int(mem_compressed));
+
+	float max_loc_error = 0;
+	float max_rot_error = 0;
+	for (int i = 0; i < BONE_COUNT; i++) {
+		for (int j = 0; j < KEY_COUNT; j++) {
+
+			Vector3 loc_a, loc_b, scale;
+			Quat rot_a, rot_b;
+			anim->transform_track_get_key(i, j, &loc_a, &rot_a, &scale);
+			compressed->transform_track_get_key(i, j, &loc_b, &rot_b, &scale);
+			max_loc_error = MAX(max_loc_error, loc_a.distance_to(loc_b));
+			max_rot_error = MAX(max_rot_error, 1.0 - Math::abs(rot_a.dot(rot_b)));
+		}
+	}
+
+	OS::get_singleton()->print("compression error: location %f, rotation %f\n", max_loc_error, max_rot_error);
+
+	OS::get_singleton()->print("sampling, binary search: %d usec\n", int(_sample(anim, false)));
+	OS::get_singleton()->print("sampling, cursor: %d usec\n", int(_sample(anim, true)));
+	OS::get_singleton()->print("sampling compressed, binary search: %d usec\n", int(_sample(compressed, false)));
+	OS::get_singleton()->print("sampling compressed, cursor: %d usec\n", int(_sample(compressed, true)));
+
+	return NULL;
+}
+} // namespace TestAnimation
@@ -0,0 +1,197 @@
+/*************************************************************************/
+/*  test_audio_mix.cpp                                                   */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2018 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2018 Godot Engine contributors (cf. AUTHORS.md)    */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#include "test_audio_mix.h"
+
+#include "core/math/math_funcs.h"
+#include "core/os/os.h"
+#include "servers/audio/audio_mix.h"
+#include "servers/audio/effects/audio_effect_amplify.h"
+#include "servers/audio_server.h"
+
+namespace TestAudioMix {
+
+#define FRAMES 1023 // odd, so the scalar tail of the kernels runs too
+#define ITERATIONS 20000
+#define BUSES 12
+#define BUS_SAMPLE 0.01
+
+static bool _check(const AudioFrame *p_a, const AudioFrame *p_b, int p_frames, const char *p_what) {
+
+	for (int i = 0; i < p_frames; i++) {
+		if (Math::abs(p_a[i].l - p_b[i].l) > CMP_EPSILON || Math::abs(p_a[i].r - p_b[i].r) > CMP_EPSILON) {
+			OS::get_singleton()->print("FAIL: %s differs at frame %d\n", p_what, i);
+			return false;
+		}
+	}
+	return true;
+}
+
+static bool _test_kernels() {
+
+	Vector<AudioFrame> src, dst, ref;
+	src.resize(FRAMES);
+	dst.resize(FRAMES);
+	ref.resize(FRAMES);
+
+	for (int i = 0; i < FRAMES; i++) {
+		src.write[i] = AudioFrame(Math::sin(i * 0.1), Math::cos(i * 0.07) * 0.5);
+		dst.write[i] = AudioFrame(i * 0.001, -i * 0.001);
+	}
+
+	bool ok = true;
+
+	ref = dst;
+	for (int i = 0; i < FRAMES; i++) {
+		ref.write[i] += src[i];
+	}
+	AudioMix::add(dst.ptrw(), src.ptr(), FRAMES);
+	ok = _check(dst.ptr(), ref.ptr(), FRAMES, "add") && ok;
+
+	dst = src;
+	ref = src;
+	float vol = 0.25;
+	float vol_inc = (0.75 - 0.25) / float(FRAMES);
+	for (int i = 0; i < FRAMES; i++) {
+		ref.write[i] *= vol;
+		vol += vol_inc;
+	}
+	AudioMix::ramp(dst.ptrw(), FRAMES, 0.25, 0.75);
+	ok = _check(dst.ptr(), ref.ptr(), FRAMES, "ramp") && ok;
+
+	dst = src;
+	ref = src;
+	AudioFrame ref_peak = AudioFrame(0, 0);
+	for (int i = 0; i < FRAMES; i++) {
+		ref.write[i] *= 0.5;
+		ref_peak.l = MAX(ref_peak.l, ABS(ref[i].l));
+		ref_peak.r = MAX(ref_peak.r, ABS(ref[i].r));
+	}
+	AudioFrame peak = AudioMix::scale_and_peak(dst.ptrw(), FRAMES, 0.5);
+	ok = _check(dst.ptr(), ref.ptr(), FRAMES, "scale_and_peak") && ok;
+	ok = _check(&peak, &ref_peak, 1, "scale_and_peak peak") && ok;
+
+	AudioMix::clear(dst.ptrw(), FRAMES);
+	for (int i = 0; i < FRAMES; i++) {
+		ref.write[i] = AudioFrame(0, 0);
+	}
+	ok = _check(dst.ptr(), ref.ptr(), FRAMES, "clear") && ok;
+
+	uint64_t begin = OS::get_singleton()->get_ticks_usec();
+	for (int j = 0; j < ITERATIONS; j++) {
+		AudioFrame *d = dst.ptrw();
+		const AudioFrame *s = src.ptr();
+		for (int i = 0; i < FRAMES; i++) {
+			d[i] += s[i];
+		}
+	}
+	OS::get_singleton()->print("scalar add: %d usec\n", int(OS::get_singleton()->get_ticks_usec() - begin));
+
+	begin = OS::get_singleton()->get_ticks_usec();
+	for (int j = 0; j < ITERATIONS; j++) {
+		AudioMix::add(dst.ptrw(), src.ptr(), FRAMES);
+	}
+	OS::get_singleton()->print("AudioMix::add: %d usec\n", int(OS::get_singleton()->get_ticks_usec() - begin));
+
+	return ok;
+}
+
+static void _mix_buses(void *p_userdata) {
+
+	AudioServer *as = AudioServer::get_singleton();
+
+	for (int i = 1; i < as->get_bus_count(); i++) {
+		AudioFrame *buf = as->thread_get_channel_mix_buffer(i, 0);
+		for (int j = 0; j < as->thread_get_mix_buffer_size(); j++) {
+			buf[j] += AudioFrame(BUS_SAMPLE, BUS_SAMPLE);
+		}
+	}
+}
+
+// Every bus gets the same signal and goes through an effect, half of them
+// through an intermediate bus, so the graph has buses that can be mixed in
+// parallel and buses that must wait. Run it with --audio-driver Dummy.
+static bool _test_buses() {
+
+	AudioServer *as = AudioServer::get_singleton();
+
+	as->lock();
+	as->set_bus_count(BUSES + 2);
+	as->set_bus_name(1, "Group");
+	for (int i = 2; i < as->get_bus_count(); i++) {
+		as->set_bus_name(i, "Bus" + itos(i));
+		as->set_bus_send(i, i % 2 ? "Group" : "Master");
+
+		Ref<AudioEffectAmplify> amplify;
+		amplify.instance();
+		amplify->set_volume_db(0);
+		as->add_bus_effect(i, amplify);
+	}
+	as->add_callback(_mix_buses, NULL);
+	as->unlock();
+
+	OS::get_singleton()->delay_usec(500000);
+
+	as->lock();
+	as->remove_callback(_mix_buses, NULL);
+	float peak = Math::db2linear(as->get_bus_peak_volume_left_db(0, 0));
+	for (int i = 0; i < as->get_bus_count(); i++) {
+		OS::get_singleton()->print("bus %d: %f usec\n", i, as->get_bus_dsp_time(i) * 1000000.0);
+	}
+	as->set_bus_count(1);
+	as->unlock();
+
+	// each bus carries BUS_SAMPLE, Group carries its own plus the odd buses
+	float expected = BUS_SAMPLE * (BUSES + 1);
+	OS::get_singleton()->print("master peak %f, expected %f\n", peak, expected);
+
+	if (Math::abs(peak - expected) > 0.001) {
+		OS::get_singleton()->print("FAIL: master peak\n");
+		return false;
+	}
+
+	return true;
+}
+
+MainLoop *test() {
+
+	OS::get_singleton()->print("\n\nAudio mix kernels, %d frames x %d\n", FRAMES, ITERATIONS);
+
+	bool ok = _test_kernels();
+
+	OS::get_singleton()->print("\nAudio buses, %d buses\n", BUSES + 2);
+
+	ok = _test_buses() && ok;
+
+	OS::get_singleton()->print(ok ? "\nOK\n" : "\nFAILED\n");
+
+	return NULL;
+}
+} // namespace TestAudioMix
@@ -0,0 +1,86 @@
+/*************************************************************************/
+/*  test_class_db.cpp                                                    */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2018 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2018 Godot Engine contributors (cf. AUTHORS.md)    */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#include "test_class_db.h"
+
+#include "core/os/os.h"
+#include "scene/gui/button.h"
+
+namespace TestClassDB {
+
+#define ITERATIONS 200000
+
+MainLoop *test() {
+
+	Button *button = memnew(Button);
+
+	// each property is declared on a different level of the hierarchy
+	StringName properties[] = { "text", "disabled", "rect_min_size", "modulate", "pause_mode" };
+	Variant values[] = { "OK", true, Vector2(10, 10), Color(1, 0, 0), Node::PAUSE_MODE_PROCESS };
+	const int property_count = sizeof(properties) / sizeof(properties[0]);
+
+	OS::get_singleton()->print("\n\nClassDB lookups on Button, %d iterations\n", ITERATIONS);
+
+	uint64_t begin = OS::get_singleton()->get_ticks_usec();
+	for (int i = 0; i < ITERATIONS; i++) {
+		button->set(properties[i % property_count], values[i % property_count]);
+	}
+	uint64_t set_usec = OS::get_singleton()->get_ticks_usec() - begin;
+
+	begin = OS::get_singleton()->get_ticks_usec();
+	for (int i = 0; i < ITERATIONS; i++) {
+		button->get(properties[i % property_count]);
+	}
+	uint64_t get_usec = OS::get_singleton()->get_ticks_usec() - begin;
+
+	StringName method = "get_text";
+	begin = OS::get_singleton()->get_ticks_usec();
+	for (int i = 0; i < ITERATIONS; i++) {
+		button->call(method);
+	}
+	uint64_t call_usec = OS::get_singleton()->get_ticks_usec() - begin;
+
+	OS::get_singleton()->print("set: %d usec, get: %d usec, call: %d usec\n", int(set_usec), int(get_usec), int(call_usec));
+
+	bool ok = true;
+	for (int i = 0; i < property_count; i++) {
+		if (button->get(properties[i]) != values[i]) {
+			OS::get_singleton()->print("property %s does not match\n", String(properties[i]).utf8().get_data());
+			ok = false;
+		}
+	}
+
+	OS::get_singleton()->print(ok ? "OK\n" : "FAILED\n");
+
+	memdelete(button);
+
+	return NULL;
+}
+} // namespace TestClassDB
@@ -0,0 +1,115 @@
+/*************************************************************************/
+/*  test_expression.cpp                                                  */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2018 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2018 Godot Engine contributors (cf. AUTHORS.md)    */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#include "test_expression.h"
+
+#include "core/math/expression.h"
+#include "core/os/os.h"
+
+namespace TestExpression {
+
+#define ITERATIONS 100000
+
+MainLoop *test() {
+
+	const char *formulas[] = {
+		"x * 2.0 + y",
+		"clamp(x * (1.0 + 0.5 * 2.0) - y / 4.0, -10.0, sqrt(16.0) * 100.0)",
+		"Vector2(x, y).length() * deg2rad(180.0)",
+		"lerp(x, y, 0.25) + max(x, y) * pow(2.0, 3.0)",
+	};
+	const int formula_count = sizeof(formulas) / sizeof(formulas[0]);
+
+	Vector<String> input_names;
+	input_names.push_back("x");
+	input_names.push_back("y");
+
+	Array inputs_list;
+	inputs_list.resize(ITERATIONS);
+	for (int i = 0; i < ITERATIONS; i++) {
+		Array inputs;
+		inputs.push_back(real_t(i % 100));
+		inputs.push_back(real_t(i % 7) * 0.5);
+		inputs_list[i] = inputs;
+	}
+
+	bool ok = true;
+
+	for (int i = 0; i < formula_count; i++) {
+
+		Ref<Expression> expression;
+		expression.instance();
+		if (expression->parse(formulas[i], input_names) != OK) {
+			OS::get_singleton()->print("failed to parse: %s\n", formulas[i]);
+			ok = false;
+			continue;
+		}
+
+		OS::get_singleton()->print("\n%s, %d iterations\n", formulas[i], ITERATIONS);
+
+		uint64_t begin = OS::get_singleton()->get_ticks_usec();
+		for (int j = 0; j < ITERATIONS; j++) {
+			expression->execute_tree(inputs_list[j]);
+		}
+		uint64_t tree_usec = OS::get_singleton()->get_ticks_usec() - begin;
+
+		begin = OS::get_singleton()->get_ticks_usec();
+		for (int j = 0; j < ITERATIONS; j++) {
+			expression->execute(inputs_list[j]);
+		}
+		uint64_t bytecode_usec = OS::get_singleton()->get_ticks_usec() - begin;
+
+		begin = OS::get_singleton()->get_ticks_usec();
+		Array outputs = expression->execute_batch(inputs_list);
+		uint64_t batch_usec = OS::get_singleton()->get_ticks_usec() - begin;
+
+		OS::get_singleton()->print("tree: %d usec, bytecode: %d usec, batch: %d usec\n", int(tree_usec), int(bytecode_usec), int(batch_usec));
+
+		if (outputs.size() != ITERATIONS) {
+			OS::get_singleton()->print("batch returned %d results\n", outputs.size());
+			ok = false;
+			continue;
+		}
+
+		for (int j = 0; j < ITERATIONS; j += 997) {
+			Variant expected = expression->execute_tree(inputs_list[j]);
+			if (expression->execute(inputs_list[j]) != expected || outputs[j] != expected) {
+				OS::get_singleton()->print("result mismatch for inputs %s\n", String(Variant(inputs_list[j])).utf8().get_data());
+				ok = false;
+				break;
+			}
+		}
+	}
+
+	OS::get_singleton()->print(ok ? "OK\n" : "FAILED\n");
+
+	return NULL;
+}
+} // namespace TestExpression
@@ -0,0 +1,608 @@
+/*************************************************************************/
+/*  test_http.cpp                                                        */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2018 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2018 Godot Engine contributors (cf. AUTHORS.md)    */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+
+#include "test_http.h"
+
+#include "core/io/http_session.h"
+#include "core/io/tcp_server.h"
+#include "core/os/dir_access.h"
+#include "core/os/os.h"
+#include "core/os/thread.h"
+
+namespace TestHTTP {
+
+#define PORT 17647
+#define FILES 400
+#define BENCH_FILES 2000
+#define TIMEOUT_MSEC 10000
+
+#define CHECK(m_cond, m_what)                                       \
+	if (!(m_cond)) {                                                \
+		OS::get_singleton()->print("FAIL: %s\n", m_what);           \
+		ok = false;                                                 \
+	}
+
+static int _file_size(int p_file) {
+
+	// small files like a patcher gets, with a few spanning several reads
+	return p_file % 50 == 7 ? 200000 : 100 + (p_file * 131) % 4000;
+}
+
+static uint8_t _file_byte(int p_file, int p_offset) {
+
+	return (p_file * 13 + p_offset * 7) & 0xFF;
+}
+
+static bool _check_body(int p_file, const uint8_t *p_data, int p_size) {
+
+	if (p_size != _file_size(p_file))
+		return false;
+	for (int i = 0; i < p_size; i++) {
+		if (p_data[i] != _file_byte(p_file, i))
+			return false;
+	}
+	return true;
+}
+
+/* A minimal HTTP/1.1 server, answering pipelined requests in order:
+ *  /file/N     Content-Length body, connection kept alive (the HTTP/1.1 default); HEAD gets the headers only
+ *  /chunked/N  same body with chunked transfer encoding, plus an extension and a trailer
+ *  /close/N    same body, then the server closes the connection
+ *  /empty      204 No Content, no Content-Length
+ */
+
+struct ServerConnection {
+
+	Ref<StreamPeerTCP> peer;
+	Vector<uint8_t> in;
+};
+
+struct Server {
+
+	Ref<TCP_Server> listener;
+	volatile bool quit;
+	volatile int accepted;
+};
+
+static void _append(Vector<uint8_t> &r_out, const String &p_text) {
+
+	CharString cs = p_text.utf8();
+	int at = r_out.size();
+	r_out.resize(at + cs.length());
+	copymem(r_out.ptrw() + at, cs.get_data(), cs.length());
+}
+
+static void _append_body(Vector<uint8_t> &r_out, int p_file, int p_from, int p_size) {
+
+	int at = r_out.size();
+	r_out.resize(at + p_size);
+	uint8_t *w = r_out.ptrw() + at;
+	for (int i = 0; i < p_size; i++) {
+		w[i] = _file_byte(p_file, p_from + i);
+	}
+}
+
+// Returns false if the connection must be closed after the response.
+static bool _respond(bool p_head, const String &p_path, Vector<uint8_t> &r_out) {
+
+	int file = p_path.get_slice("/", 2).to_int();
+	int size = _file_size(file);
+
+	if (p_path.begins_with("/file/")) {
+
+		_append(r_out, "HTTP/1.1 200 OK\r\nContent-Type: application/octet-stream\r\nContent-Length: " + itos(size) + "\r\n\r\n");
+		if (!p_head) {
+			_append_body(r_out, file, 0, size);
+		}
+
+	} else if (p_path.begins_with("/chunked/")) {
+
+		_append(r_out, "HTTP/1.1 200 OK\r\nTransfer-Encoding: chunked\r\n\r\n");
+		for (int from = 0; from < size; from += 1000) {
+			int chunk = MIN(1000, size - from);
+			_append(r_out, String::num_int64(chunk, 16) + (from == 0 ? ";name=value\r\n" : "\r\n"));
+			_append_body(r_out, file, from, chunk);
+			_append(r_out, "\r\n");
+		}
+		_append(r_out, "0\r\nX-Trailer: done\r\n\r\n");
+
+	} else if (p_path.begins_with("/close/")) {
+
+		_append(r_out, "HTTP/1.1 200 OK\r\nConnection: close\r\nContent-Length: " + itos(size) + "\r\n\r\n");
+		_append_body(r_out, file, 0, size);
+		return false;
+
+	} else if (p_path == "/empty") {
+
+		_append(r_out, "HTTP/1.1 204 No Content\r\n\r\n");
+
+	} else {
+
+		_append(r_out, "HTTP/1.1 404 Not Found\r\nContent-Length: 0\r\n\r\n");
+	}
+
+	return true;
+}
+
+static void _server_thread(void *p_userdata) {
+
+	Server *server = (Server *)p_userdata;
+	Vector<ServerConnection> connections;
+	Vector<uint8_t> out;
+	uint8_t buffer[16384];
+
+	while (!server->quit) {
+
+		bool activity = false;
+
+		while (server->listener->is_connection_available()) {
+			ServerConnection c;
+			c.peer = server->listener->take_connection();
+			connections.push_back(c);
+			server->accepted++;
+			activity = true;
+		}
+
+		for (int i = connections.size() - 1; i >= 0; i--) {
+
+			ServerConnection &c = connections.write[i];
+
+			int read = 0;
+			if (c.peer->get_status() != StreamPeerTCP::STATUS_CONNECTED || c.peer->get_partial_data(buffer, sizeof(buffer), read) != OK) {
+				connections.remove(i);
+				continue;
+			}
+			if (read == 0)
+				continue;
+
+			activity = true;
+			int at = c.in.size();
+			c.in.resize(at + read);
+			copymem(c.in.ptrw() + at, buffer, read);
+
+			// answer every complete request, so pipelined ones get their responses in one go
+			bool keep = true;
+			int consumed = 0;
+			out.clear();
+			while (keep) {
+
+				int end = -1;
+				for (int j = consumed + 3; j < c.in.size(); j++) {
+					if (c.in[j - 3] == '\r' && c.in[j - 2] == '\n' && c.in[j - 1] == '\r' && c.in[j] == '\n') {
+						end = j + 1;
+						break;
+					}
+				}
+				if (end == -1)
+					break;
+
+				String request;
+				request.parse_utf8((const char *)c.in.ptr() + consumed, end - consumed);
+				keep = _respond(request.get_slice(" ", 0) == "HEAD", request.get_slice(" ", 1), out);
+				consumed = end;
+			}
+
+			if (consumed > 0) {
+				int left = c.in.size() - consumed;
+				if (left > 0) {
+					movemem(c.in.ptrw(), c.in.ptr() + consumed, left);
+				}
+				c.in.resize(left);
+			}
+
+			if (out.size()) {
+				c.peer->put_data(out.ptr(), out.size());
+			}
+			if (!keep) {
+				c.peer->disconnect_from_host();
+				connections.remove(i);
+			}
+		}
+
+		if (!activity) {
+			OS::get_singleton()->delay_usec(50);
+		}
+	}
+}
+
+static String _url(const String &p_path) {
+
+	return "http://127.0.0.1:" + itos(PORT) + p_path;
+}
+
+/* HTTPClient on its own: direct body reads, keep-alive and pipelining */
+
+static bool _read_response(Ref<HTTPClient> p_client, int &r_code, Vector<uint8_t> &r_body) {
+
+	uint64_t deadline = OS::get_singleton()->get_ticks_msec() + TIMEOUT_MSEC;
+
+	while (p_client->get_status() == HTTPClient::STATUS_REQUESTING && !p_client->has_response()) {
+		p_client->poll();
+		if (OS::get_singleton()->get_ticks_msec() > deadline)
+			return false;
+	}
+
+	r_code = p_client->get_response_code();
+	List<String> headers;
+	p_client->get_response_headers(&headers);
+
+	r_body.clear();
+	uint8_t buffer[1000];
+	while (p_client->get_status() == HTTPClient::STATUS_BODY) {
+		int received = 0;
+		if (p_client->read_response_body(buffer, sizeof(buffer), received) != OK)
+			return false;
+		int at = r_body.size();
+		r_body.resize(at + received);
+		copymem(r_body.ptrw() + at, buffer, received);
+		if (OS::get_singleton()->get_ticks_msec() > deadline)
+			return false;
+	}
+
+	return true;
+}
+
+static bool _test_client() {
+
+	bool ok = true;
+
+	Ref<HTTPClient> client;
+	client.instance();
+	client->set_pipelining_enabled(true);
+	client->connect_to_host("127.0.0.1", PORT);
+
+	uint64_t deadline = OS::get_singleton()->get_ticks_msec() + TIMEOUT_MSEC;
+	while (client->get_status() == HTTPClient::STATUS_CONNECTING && OS::get_singleton()->get_ticks_msec() < deadline) {
+		client->poll();
+	}
+	if (client->get_status() != HTTPClient::STATUS_CONNECTED) {
+		OS::get_singleton()->print("FAIL: connecting HTTPClient\n");
+		return false;
+	}
+
+	// all sent before any response is read
+	// the HEAD response is last, its headers would still be there while waiting for a later one
+	const char *paths[] = { "/file/1", "/chunked/7", "/empty", "/chunked/2", "/file/57", "/file/9" };
+	const int files[] = { 1, 7, -1, 2, 57, -1 };
+	const HTTPClient::Method methods[] = { HTTPClient::METHOD_GET, HTTPClient::METHOD_GET, HTTPClient::METHOD_GET, HTTPClient::METHOD_GET, HTTPClient::METHOD_GET, HTTPClient::METHOD_HEAD };
+	const int count = sizeof(files) / sizeof(files[0]);
+
+	for (int i = 0; i < count; i++) {
+		CHECK(client->request(methods[i], paths[i], Vector<String>()) == OK, "pipelined request");
+	}
+
+	for (int i = 0; i < count; i++) {
+		int code = 0;
+		Vector<uint8_t> body;
+		if (!_read_response(client, code, body)) {
+			OS::get_singleton()->print("FAIL: response to %s\n", paths[i]);
+			return false;
+		}
+		if (methods[i] == HTTPClient::METHOD_HEAD) {
+			// Content-Length describes the body a GET would get, none follows
+			CHECK(code == HTTPClient::RESPONSE_OK && body.size() == 0, "HEAD response");
+		} else if (files[i] == -1) {
+			CHECK(code == HTTPClient::RESPONSE_NO_CONTENT && body.size() == 0, "bodyless response");
+		} else {
+			CHECK(code == HTTPClient::RESPONSE_OK && _check_body(files[i], body.ptr(), body.size()), paths[i]);
+		}
+		CHECK(client->is_response_keep_alive(), "HTTP/1.1 keeps the connection alive");
+	}
+	CHECK(client->get_status() == HTTPClient::STATUS_CONNECTED, "connected after the last response");
+
+	// the old way, one chunk at a time, still works on the same connection
+	client->request(HTTPClient::METHOD_GET, "/chunked/3", Vector<String>());
+	while (client->get_status() == HTTPClient::STATUS_REQUESTING) {
+		client->poll();
+	}
+	Vector<uint8_t> body;
+	while (client->get_status() == HTTPClient::STATUS_BODY) {
+		PoolByteArray chunk = client->read_response_body_chunk();
+		PoolByteArray::Read r = chunk.read();
+		int at = body.size();
+		body.resize(at + chunk.size());
+		copymem(body.ptrw() + at, r.ptr(), chunk.size());
+	}
+	CHECK(_check_body(3, body.ptr(), body.size()), "read_response_body_chunk");
+
+	client->close();
+	return ok;
+}
+
+/* HTTPSession */
+
+class SessionListener : public Object {
+
+	GDCLASS(SessionListener, Object);
+
+public:
+	Map<int, int> files;
+	int completed;
+	int failed;
+
+	void _request_completed(int p_request, int p_result, int p_code, const PoolStringArray &p_headers, const PoolByteArray &p_body) {
+
+		completed++;
+		if (!files.has(p_request))
+			return;
+
+		int file = files[p_request];
+		if (p_result != HTTPSession::RESULT_SUCCESS || p_code != (file >= 0 ? HTTPClient::RESPONSE_OK : HTTPClient::RESPONSE_NO_CONTENT)) {
+			failed++;
+		} else if (file >= 0) {
+			PoolByteArray::Read r = p_body.read();
+			if (!_check_body(file, r.ptr(), p_body.size())) {
+				failed++;
+			}
+		}
+	}
+
+	static void _bind_methods() {
+
+		ClassDB::bind_method(D_METHOD("_request_completed"), &SessionListener::_request_completed);
+	}
+
+	SessionListener() {
+		completed = 0;
+		failed = 0;
+	}
+};
+
+struct FuncTarget {
+
+	Vector<Vector<uint8_t> > bodies;
+	int completed;
+	int failed;
+};
+
+static Error _body_func(void *p_userdata, int p_request, const uint8_t *p_data, int p_bytes) {
+
+	FuncTarget *target = (FuncTarget *)p_userdata;
+	Vector<uint8_t> &body = target->bodies.write[p_request % target->bodies.size()];
+	int at = body.size();
+	body.resize(at + p_bytes);
+	copymem(body.ptrw() + at, p_data, p_bytes);
+	return OK;
+}
+
+static void _done_func(void *p_userdata, int p_request, HTTPSession::Result p_result, int p_response_code) {
+
+	FuncTarget *target = (FuncTarget *)p_userdata;
+	target->completed++;
+	if (p_result != HTTPSession::RESULT_SUCCESS || p_response_code != HTTPClient::RESPONSE_OK) {
+		target->failed++;
+	}
+}
+
+static bool _wait(Ref<HTTPSession> p_session) {
+
+	uint64_t deadline = OS::get_singleton()->get_ticks_msec() + TIMEOUT_MSEC * 3;
+	while (p_session->get_pending_request_count() > 0) {
+		p_session->poll(10);
+		if (OS::get_singleton()->get_ticks_msec() > deadline) {
+			OS::get_singleton()->print("FAIL: %d requests still pending\n", p_session->get_pending_request_count());
+			return false;
+		}
+	}
+	p_session->poll(); // report the last ones
+	return true;
+}
+
+static bool _test_session(Server *p_server) {
+
+	bool ok = true;
+
+	SessionListener *listener = memnew(SessionListener);
+	Ref<HTTPSession> session;
+	session.instance();
+	session->connect("request_completed", listener, "_request_completed");
+
+	// a mix of everything, with a pipeline deep enough that requests sit behind the closing ones
+	session->set_pipeline_depth(4);
+	for (int i = 0; i < FILES; i++) {
+		String path;
+		switch (i % 7) {
+			case 0: path = "/chunked/"; break;
+			case 3: path = "/close/"; break;
+			default: path = "/file/";
+		}
+		listener->files[session->request(_url(path + itos(i)))] = i;
+		if (i % 50 == 0) {
+			listener->files[session->request(_url("/empty"))] = -1;
+		}
+	}
+	ok = _wait(session) && ok;
+	CHECK(listener->completed == listener->files.size() && listener->failed == 0, "requests through the session");
+	CHECK(session->get_connection_count() <= session->get_max_connections_per_host(), "connections per host");
+
+	// keep-alive: the same files again, without anything closing, reuse the open connections
+	listener->files.clear();
+	listener->completed = 0;
+	int accepted = p_server->accepted;
+	for (int i = 0; i < FILES; i++) {
+		listener->files[session->request(_url("/file/" + itos(i)))] = i;
+	}
+	ok = _wait(session) && ok;
+	CHECK(listener->completed == FILES && listener->failed == 0, "keep-alive requests");
+	CHECK(p_server->accepted - accepted <= session->get_max_connections_per_host(), "connections reused");
+
+	// straight to files
+	String dir = OS::get_singleton()->get_user_data_dir();
+	for (int i = 0; i < 20; i++) {
+		session->request_to_file(_url((i % 2 ? "/chunked/" : "/file/") + itos(i)), dir.plus_file("test_http_" + itos(i)));
+	}
+	ok = _wait(session) && ok;
+
+	DirAccess *da = DirAccess::create(DirAccess::ACCESS_FILESYSTEM);
+	for (int i = 0; i < 20; i++) {
+		String path = dir.plus_file("test_http_" + itos(i));
+		Vector<uint8_t> data = FileAccess::get_file_as_array(path);
+		CHECK(_check_body(i, data.ptr(), data.size()), "request_to_file");
+		da->remove(path);
+	}
+	memdelete(da);
+
+	// straight to a function
+	FuncTarget target;
+	target.bodies.resize(64);
+	target.completed = 0;
+	target.failed = 0;
+	Map<int, int> func_files;
+	for (int i = 0; i < target.bodies.size(); i++) {
+		int id = session->request_to_func(_url("/chunked/" + itos(i)), _body_func, _done_func, &target);
+		func_files[id % target.bodies.size()] = i;
+	}
+	ok = _wait(session) && ok;
+	CHECK(target.completed == target.bodies.size() && target.failed == 0, "request_to_func");
+	for (Map<int, int>::Element *E = func_files.front(); E; E = E->next()) {
+		const Vector<uint8_t> &body = target.bodies[E->key()];
+		CHECK(_check_body(E->get(), body.ptr(), body.size()), "request_to_func body");
+	}
+
+	// cancelling, queued or in flight
+	listener->files.clear();
+	listener->completed = 0;
+	int first = session->request(_url("/file/7"));
+	int second = session->request(_url("/file/8"));
+	session->poll();
+	session->cancel_request(first);
+	session->cancel_request(second);
+	ok = _wait(session) && ok;
+	CHECK(listener->completed == 2 && session->get_pending_request_count() == 0, "cancel_request");
+
+	session->close();
+	CHECK(session->get_connection_count() == 0, "close");
+
+	session->disconnect("request_completed", listener, "_request_completed");
+	memdelete(listener);
+	return ok;
+}
+
+/* Throughput of many small files, the way a patcher would fetch them */
+
+static void _benchmark_report(const char *p_what, uint64_t p_usec, int p_connections) {
+
+	OS::get_singleton()->print("\t%s: %.0f requests/s, %d connections\n", p_what, BENCH_FILES / USEC_TO_SEC(MAX(p_usec, 1)), p_connections);
+}
+
+static int _bench_file(int p_request) {
+
+	// skip the large ones, this measures per-request costs
+	int file = p_request % 1000;
+	return file % 50 == 7 ? file + 1 : file;
+}
+
+static void _benchmark(Server *p_server) {
+
+	OS::get_singleton()->print("%d small files from a local server:\n", BENCH_FILES);
+
+	// a new connection and a PoolByteArray per chunk for every request
+	int accepted = p_server->accepted;
+	uint64_t begin = OS::get_singleton()->get_ticks_usec();
+	for (int i = 0; i < BENCH_FILES; i++) {
+
+		Ref<HTTPClient> client;
+		client.instance();
+		client->connect_to_host("127.0.0.1", PORT);
+		while (client->get_status() == HTTPClient::STATUS_CONNECTING) {
+			client->poll();
+		}
+		client->request(HTTPClient::METHOD_GET, "/file/" + itos(_bench_file(i)), Vector<String>());
+		while (client->get_status() == HTTPClient::STATUS_REQUESTING) {
+			client->poll();
+		}
+		PoolByteArray body;
+		while (client->get_status() == HTTPClient::STATUS_BODY) {
+			body.append_array(client->read_response_body_chunk());
+		}
+		client->close();
+	}
+	_benchmark_report("HTTPClient, reconnecting", OS::get_singleton()->get_ticks_usec() - begin, p_server->accepted - accepted);
+
+	struct Config {
+		const char *name;
+		int connections;
+		int depth;
+	};
+	const Config configs[] = {
+		{ "HTTPSession, 1 connection", 1, 1 },
+		{ "HTTPSession, 4 connections", 4, 1 },
+		{ "HTTPSession, 4 connections, pipelining 8", 4, 8 },
+	};
+
+	for (int c = 0; c < 3; c++) {
+
+		Ref<HTTPSession> session;
+		session.instance();
+		session->set_max_connections_per_host(configs[c].connections);
+		session->set_pipeline_depth(configs[c].depth);
+
+		accepted = p_server->accepted;
+		begin = OS::get_singleton()->get_ticks_usec();
+		for (int i = 0; i < BENCH_FILES; i++) {
+			session->request(_url("/file/" + itos(_bench_file(i))));
+		}
+		while (session->get_pending_request_count() > 0) {
+			session->poll(10);
+		}
+		session->poll();
+		_benchmark_report(configs[c].name, OS::get_singleton()->get_ticks_usec() - begin, p_server->accepted - accepted);
+	}
+}
+
+MainLoop *test() {
+
+	Server server;
+	server.quit = false;
+	server.accepted = 0;
+	server.listener.instance();
+	if (server.listener->listen(PORT, IP_Address("127.0.0.1")) != OK) {
+		OS::get_singleton()->print("Can't listen on port %d, skipping HTTP tests\n", PORT);
+		return NULL;
+	}
+	Thread *thread = Thread::create(_server_thread, &server);
+
+	bool ok = _test_client();
+	ok = _test_session(&server) && ok;
+	if (ok) {
+		_benchmark(&server);
+	}
+
+	server.quit = true;
+	Thread::wait_to_finish(thread);
+	memdelete(thread);
+	server.listener->stop();
+
+	OS::get_singleton()->print(ok ? "HTTP tests passed\n" : "HTTP tests FAILED\n");
+
+	return NULL;
+}
+} // namespace TestHTTP
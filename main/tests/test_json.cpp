@@ -0,0 +1,279 @@
+/*************************************************************************/
+/*  test_json.cpp                                                        */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2018 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2018 Godot Engine contributors (cf. AUTHORS.md)    */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#include "test_json.h"
+
+#include "core/io/json.h"
+#include "core/os/dir_access.h"
+#include "core/os/file_access.h"
+#include "core/os/os.h"
+
+namespace TestJSON {
+
+#define CHECK(m_cond, m_what)                                       \
+	if (!(m_cond)) {                                                \
+		OS::get_singleton()->print("FAIL: %s\n", m_what);           \
+		ok = false;                                                 \
+	}
+
+class CountingHandler : public JSONHandler {
+public:
+	int objects;
+	int arrays;
+	int keys;
+	int values;
+	int depth;
+	int max_depth;
+
+	virtual Error begin_object() {
+		objects++;
+		max_depth = MAX(max_depth, ++depth);
+		return OK;
+	}
+	virtual Error key(const String &p_key) {
+		keys++;
+		return OK;
+	}
+	virtual Error end_object() {
+		depth--;
+		return OK;
+	}
+	virtual Error begin_array() {
+		arrays++;
+		max_depth = MAX(max_depth, ++depth);
+		return OK;
+	}
+	virtual Error end_array() {
+		depth--;
+		return OK;
+	}
+	virtual Error value(const Variant &p_value) {
+		values++;
+		return OK;
+	}
+
+	CountingHandler() {
+		objects = arrays = keys = values = depth = max_depth = 0;
+	}
+};
+
+static Variant _make_document(int p_entries) {
+
+	Array entries;
+	for (int i = 0; i < p_entries; i++) {
+		Dictionary d;
+		d["id"] = i;
+		d["name"] = "entity_" + itos(i) + " \"quoted\"\n\t" + String::utf8("\xc3\xa9\xe4\xb8\xad");
+		d["position"] = Vector3(i, i * 0.5, -i).operator String();
+		d["enabled"] = (i % 2) == 0;
+		d["parent"] = Variant();
+		Array values;
+		for (int j = 0; j < 8; j++) {
+			values.push_back(i * 0.25 + j);
+		}
+		d["values"] = values;
+		entries.push_back(d);
+	}
+
+	Dictionary doc;
+	doc["version"] = 3;
+	doc["entries"] = entries;
+	return doc;
+}
+
+static bool _test_parse() {
+
+	bool ok = true;
+
+	String text = String::utf8("{\"a\": [1, -2.5, 3e2, 12345678901234567890, true, false, null],\n"
+							   " \"b\": \"esc \\\"\\\\\\/\\b\\f\\n\\r\\t \\u00e9\\u4E2D raw \xc3\xa9\",\n"
+							   " \"c\": {}, \"d\": []}");
+
+	Variant v;
+	String err_str;
+	int err_line;
+	Error err = JSON::parse(text, v, err_str, err_line);
+	CHECK(err == OK, "parse valid document");
+	CHECK(v.get_type() == Variant::DICTIONARY, "document is a dictionary");
+
+	Dictionary d = v;
+	Array a = d["a"];
+	CHECK(a.size() == 7, "array size");
+	CHECK(a[0].get_type() == Variant::REAL && double(a[0]) == 1.0, "integer number");
+	CHECK(double(a[1]) == -2.5, "negative fraction");
+	CHECK(double(a[2]) == 300.0, "exponent");
+	CHECK(Math::abs(double(a[3]) / 12345678901234567890.0 - 1.0) < 1e-12, "long integer");
+	CHECK(a[4].get_type() == Variant::BOOL && bool(a[4]), "true");
+	CHECK(a[5].get_type() == Variant::BOOL && !bool(a[5]), "false");
+	CHECK(a[6].get_type() == Variant::NIL, "null");
+	CHECK(String(d["b"]) == String::utf8("esc \"\\/\b\f\n\r\t \xc3\xa9\xe4\xb8\xad raw \xc3\xa9"), "string escapes");
+	CHECK(Dictionary(d["c"]).empty() && Array(d["d"]).empty(), "empty containers");
+
+	CharString utf8 = text.utf8();
+	Variant v2;
+	err = JSON::parse_utf8((const uint8_t *)utf8.get_data(), utf8.length(), v2, err_str, err_line);
+	CHECK(err == OK && JSON::print(v2) == JSON::print(v), "parse_utf8 matches parse");
+
+	String nul = "a";
+	nul += CharType(0);
+	nul += String::utf8("\xc3\xa9");
+	nul += CharType(0);
+	err = JSON::parse("[\"a\\u0000\\u00e9\\u0000\"]", v2, err_str, err_line);
+	CHECK(err == OK && String(Array(v2)[0]) == nul, "escaped NUL");
+
+	Array control;
+	control.push_back(nul + String::chr(0x1f) + "end");
+	String printed = JSON::print(control);
+	err = JSON::parse(printed, v2, err_str, err_line);
+	CHECK(printed == String::utf8("[\"a\\u0000\xc3\xa9\\u0000\\u001fend\"]"), "print escapes control characters");
+	CHECK(err == OK && String(Array(v2)[0]) == String(control[0]), "control characters round trip");
+
+	err = JSON::parse("[1 2]", v, err_str, err_line);
+	CHECK(err == ERR_PARSE_ERROR && err_str == "Expected ','", "missing comma");
+
+	err = JSON::parse("{\"a\":\n\n\"unterminated}", v, err_str, err_line);
+	CHECK(err == ERR_PARSE_ERROR && err_str == "Unterminated String" && err_line == 2, "unterminated string");
+
+	err = JSON::parse("[nope]", v, err_str, err_line);
+	CHECK(err == ERR_PARSE_ERROR && err_str == "Expected 'true','false' or 'null', got 'nope'.", "bad identifier");
+
+	CountingHandler handler;
+	err = JSON::parse_utf8((const uint8_t *)utf8.get_data(), utf8.length(), &handler, err_str, err_line);
+	CHECK(err == OK && handler.objects == 2 && handler.arrays == 2 && handler.keys == 4 && handler.values == 8 && handler.max_depth == 2 && handler.depth == 0, "events");
+
+	return ok;
+}
+
+static bool _test_print() {
+
+	bool ok = true;
+
+	Variant doc = _make_document(50);
+
+	String printed = JSON::print(doc, "\t");
+	PoolVector<uint8_t> utf8 = JSON::print_utf8(doc, "\t");
+	String from_utf8;
+	from_utf8.parse_utf8((const char *)utf8.read().ptr(), utf8.size());
+	CHECK(printed == from_utf8, "print_utf8 matches print");
+
+	CHECK(JSON::print(Array()) == "[]" && JSON::print(Dictionary(), "  ") == "{\n\n}", "empty containers");
+
+	Variant back;
+	String err_str;
+	int err_line;
+	Error err = JSON::parse(printed, back, err_str, err_line);
+	CHECK(err == OK && JSON::print(back, "\t") == printed, "round trip");
+
+	return ok;
+}
+
+static bool _test_file() {
+
+	bool ok = true;
+
+	// large enough to span several read chunks, so strings and escapes get split between them
+	Variant doc = _make_document(5000);
+	String path = OS::get_singleton()->get_user_data_dir().plus_file("test_json.json");
+
+	FileAccess *f = FileAccess::open(path, FileAccess::WRITE);
+	if (!f) {
+		OS::get_singleton()->print("Can't write %ls, skipping file tests\n", path.c_str());
+		return true;
+	}
+	Error err = JSON::print_to_file(doc, f, " ");
+	memdelete(f);
+	CHECK(err == OK, "print_to_file");
+
+	f = FileAccess::open(path, FileAccess::READ);
+	ERR_FAIL_COND_V(!f, false);
+	Variant back;
+	String err_str;
+	int err_line;
+	err = JSON::parse_file(f, back, err_str, err_line);
+	memdelete(f);
+	CHECK(err == OK && JSON::print(back) == JSON::print(doc), "parse_file round trip");
+
+	DirAccess *da = DirAccess::create(DirAccess::ACCESS_FILESYSTEM);
+	da->remove(path);
+	memdelete(da);
+
+	return ok;
+}
+
+static void _benchmark() {
+
+	Variant doc = _make_document(40000);
+	String err_str;
+	int err_line;
+	Variant back;
+
+	uint64_t begin = OS::get_singleton()->get_ticks_usec();
+	PoolVector<uint8_t> utf8 = JSON::print_utf8(doc);
+	uint64_t print_time = OS::get_singleton()->get_ticks_usec() - begin;
+	float mb = utf8.size() / (1024.0 * 1024.0);
+
+	begin = OS::get_singleton()->get_ticks_usec();
+	String text = JSON::print(doc);
+	uint64_t print_string_time = OS::get_singleton()->get_ticks_usec() - begin;
+
+	begin = OS::get_singleton()->get_ticks_usec();
+	JSON::parse_utf8(utf8.read().ptr(), utf8.size(), back, err_str, err_line);
+	uint64_t parse_time = OS::get_singleton()->get_ticks_usec() - begin;
+
+	begin = OS::get_singleton()->get_ticks_usec();
+	JSON::parse(text, back, err_str, err_line);
+	uint64_t parse_string_time = OS::get_singleton()->get_ticks_usec() - begin;
+
+	begin = OS::get_singleton()->get_ticks_usec();
+	CountingHandler handler;
+	JSON::parse_utf8(utf8.read().ptr(), utf8.size(), &handler, err_str, err_line);
+	uint64_t events_time = OS::get_singleton()->get_ticks_usec() - begin;
+
+	OS::get_singleton()->print("Document of %.1f MB\n", mb);
+	OS::get_singleton()->print("\tprint_utf8: %.1f MB/s\n", mb / USEC_TO_SEC(MAX(print_time, 1)));
+	OS::get_singleton()->print("\tprint: %.1f MB/s\n", mb / USEC_TO_SEC(MAX(print_string_time, 1)));
+	OS::get_singleton()->print("\tparse_utf8: %.1f MB/s\n", mb / USEC_TO_SEC(MAX(parse_time, 1)));
+	OS::get_singleton()->print("\tparse: %.1f MB/s\n", mb / USEC_TO_SEC(MAX(parse_string_time, 1)));
+	OS::get_singleton()->print("\tparse_utf8 (events only): %.1f MB/s\n", mb / USEC_TO_SEC(MAX(events_time, 1)));
+}
+
+MainLoop *test() {
+
+	bool ok = _test_parse();
+	ok = _test_print() && ok;
+	ok = _test_file() && ok;
+
+	OS::get_singleton()->print(ok ? "JSON tests passed\n" : "JSON tests FAILED\n");
+
+	_benchmark();
+
+	return NULL;
+}
+} // namespace TestJSON
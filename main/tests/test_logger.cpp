@@ -0,0 +1,158 @@
+/*************************************************************************/
+/*  test_logger.cpp                                                      */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2018 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2018 Godot Engine contributors (cf. AUTHORS.md)    */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#include "test_logger.h"
+
+#include "core/io/logger.h"
+#include "core/os/dir_access.h"
+#include "core/os/os.h"
+
+namespace TestLogger {
+
+#define MESSAGES 20000
+#define THREADS 4
+
+static void _log_sequence(Logger *p_logger, int p_count) {
+
+	String long_line;
+	for (int i = 0; i < 100; i++) {
+		long_line += "long ";
+	}
+	CharString long_utf8 = long_line.utf8();
+
+	for (int i = 0; i < p_count; i++) {
+		if (i % 500 == 0) {
+			p_logger->log_error("_log_sequence", __FILE__, i, "i % 500 == 0", i % 1000 == 0 ? "Rationale." : "", Logger::ERR_WARNING);
+		} else if (i % 100 == 0) {
+			p_logger->logf("%d %s\n", i, long_utf8.get_data());
+		} else if (i % 10 == 0) {
+			p_logger->logf_error("error line %d\n", i);
+		} else {
+			p_logger->logf("line %d, some value %f\n", i, i * 0.5);
+		}
+	}
+}
+
+struct ThreadData {
+	Logger *logger;
+	int index;
+};
+
+static void _thread_func(void *p_userdata) {
+
+	ThreadData *td = (ThreadData *)p_userdata;
+	for (int i = 0; i < MESSAGES / THREADS; i++) {
+		td->logger->logf("thread %d message %d\n", td->index, i);
+	}
+}
+
+MainLoop *test() {
+
+	String dir = OS::get_singleton()->get_user_data_dir();
+	String sync_path = dir.plus_file("test_logger_sync.txt");
+	String async_path = dir.plus_file("test_logger_async.txt");
+	String threads_path = dir.plus_file("test_logger_threads.txt");
+	bool ok = true;
+
+	// the same messages must end up in the file, in the same order, whether written directly or from the background thread
+
+	Logger *sync_logger = memnew(RotatedFileLogger(sync_path, 1));
+	uint64_t begin = OS::get_singleton()->get_ticks_usec();
+	_log_sequence(sync_logger, MESSAGES);
+	uint64_t sync_time = OS::get_singleton()->get_ticks_usec() - begin;
+	memdelete(sync_logger);
+
+	Vector<Logger *> targets;
+	targets.push_back(memnew(RotatedFileLogger(async_path, 1)));
+	Logger *async_logger = memnew(AsyncLogger(targets, MESSAGES, 50));
+	begin = OS::get_singleton()->get_ticks_usec();
+	_log_sequence(async_logger, MESSAGES);
+	uint64_t async_time = OS::get_singleton()->get_ticks_usec() - begin;
+	memdelete(async_logger);
+
+	Vector<uint8_t> sync_data = FileAccess::get_file_as_array(sync_path);
+	Vector<uint8_t> async_data = FileAccess::get_file_as_array(async_path);
+	if (sync_data.size() == 0 || sync_data.size() != async_data.size() || memcmp(sync_data.ptr(), async_data.ptr(), sync_data.size()) != 0) {
+		OS::get_singleton()->print("FAIL: asynchronous log differs (%d bytes, expected %d)\n", async_data.size(), sync_data.size());
+		ok = false;
+	}
+
+	OS::get_singleton()->print("%d messages, time spent by the logging thread:\n", MESSAGES);
+	OS::get_singleton()->print("\tsynchronous: %.2f ms\n", sync_time / 1000.0);
+	OS::get_singleton()->print("\tasynchronous: %.2f ms\n", async_time / 1000.0);
+
+	// several producers at once; with a queue this large nothing may be dropped
+
+	targets.clear();
+	targets.push_back(memnew(RotatedFileLogger(threads_path, 1)));
+	AsyncLogger *threads_logger = memnew(AsyncLogger(targets, MESSAGES, 50));
+
+	ThreadData data[THREADS];
+	Thread *threads[THREADS];
+	for (int i = 0; i < THREADS; i++) {
+		data[i].logger = threads_logger;
+		data[i].index = i;
+		threads[i] = Thread::create(_thread_func, &data[i]);
+	}
+	for (int i = 0; i < THREADS; i++) {
+		if (threads[i]) {
+			Thread::wait_to_finish(threads[i]);
+			memdelete(threads[i]);
+		}
+	}
+
+	// what is logged after the writer thread stopped is written right away
+	threads_logger->stop();
+	threads_logger->logf("after stop\n");
+	memdelete(threads_logger);
+
+	Vector<uint8_t> threads_data = FileAccess::get_file_as_array(threads_path);
+	int lines = 0;
+	for (int i = 0; i < threads_data.size(); i++) {
+		if (threads_data[i] == '\n') {
+			lines++;
+		}
+	}
+	if (lines != (MESSAGES / THREADS) * THREADS + 1) {
+		OS::get_singleton()->print("FAIL: %d lines logged from %d threads, expected %d\n", lines, THREADS, (MESSAGES / THREADS) * THREADS + 1);
+		ok = false;
+	}
+
+	DirAccess *da = DirAccess::create(DirAccess::ACCESS_FILESYSTEM);
+	da->remove(sync_path);
+	da->remove(async_path);
+	da->remove(threads_path);
+	memdelete(da);
+
+	OS::get_singleton()->print(ok ? "Logger tests passed\n" : "Logger tests FAILED\n");
+
+	return NULL;
+}
+} // namespace TestLogger
@@ -33,18 +33,29 @@
 
 #ifdef DEBUG_ENABLED
 
+#include "test_animation.h"
+#include "test_audio_mix.h"
+#include "test_class_db.h"
+#include "test_expression.h"
 #include "test_gdscript.h"
 #include "test_gui.h"
+#include "test_http.h"
 #include "test_image.h"
 #include "test_io.h"
+#include "test_json.h"
+#include "test_logger.h"
+#include "test_marshalls.h"
 #include "test_math.h"
+#include "test_network.h"
 #include "test_oa_hash_map.h"
 #include "test_ordered_hash_map.h"
 #include "test_physics.h"
 #include "test_physics_2d.h"
 #include "test_render.h"
+#include "test_rich_text_label.h"
 #include "test_shader_lang.h"
 #include "test_string.h"
+#include "test_tile_map.h"
 
 const char **tests_get_names() {
 
@@ -64,6 +75,17 @@ const char **tests_get_names() {
 		"gd_bytecode",
 		"image",
 		"ordered_hash_map",
+		"animation",
+		"class_db",
+		"expression",
+		"tile_map",
+		"rich_text_label",
+		"audio_mix",
+		"json",
+		"logger",
+		"network",
+		"http",
+		"marshalls",
 		NULL
 	};
 
@@ -149,6 +171,61 @@ MainLoop *test_main(String p_test, const List<String> &p_args) {
 		return TestOrderedHashMap::test();
 	}
 
+	if (p_test == "animation") {
+
+		return TestAnimation::test();
+	}
+
+	if (p_test == "class_db") {
+
+		return TestClassDB::test();
+	}
+
+	if (p_test == "expression") {
+
+		return TestExpression::test();
+	}
+
+	if (p_test == "tile_map") {
+
+		return TestTileMap::test();
+	}
+
+	if (p_test == "rich_text_label") {
+
+		return TestRichTextLabel::test();
+	}
+
+	if (p_test == "audio_mix") {
+
+		return TestAudioMix::test();
+	}
+
+	if (p_test == "json") {
+
+		return TestJSON::test();
+	}
+
+	if (p_test == "logger") {
+
+		return TestLogger::test();
+	}
+
+	if (p_test == "network") {
+
+		return TestNetwork::test();
+	}
+
+	if (p_test == "http") {
+
+		return TestHTTP::test();
+	}
+
+	if (p_test == "marshalls") {
+
+		return TestMarshalls::test();
+	}
+
 	return NULL;
 }
 
@@ -0,0 +1,293 @@
+/*************************************************************************/
+/*  test_marshalls.cpp                                                   */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2018 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2018 Godot Engine contributors (cf. AUTHORS.md)    */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#include "test_marshalls.h"
+
+#include "core/io/marshalls.h"
+#include "core/os/os.h"
+#include "core/print_string.h"
+
+namespace TestMarshalls {
+
+#define CHECK(m_cond, m_what)                                       \
+	if (!(m_cond)) {                                                \
+		OS::get_singleton()->print("FAIL: %s\n", m_what);           \
+		ok = false;                                                 \
+	}
+
+static Vector<uint8_t> _encode_two_pass(const Variant &p_value) {
+
+	int len;
+	Vector<uint8_t> buf;
+	Error err = encode_variant(p_value, NULL, len);
+	ERR_FAIL_COND_V(err != OK, buf);
+	buf.resize(len);
+	err = encode_variant(p_value, buf.ptrw(), len);
+	ERR_FAIL_COND_V(err != OK || len != buf.size(), Vector<uint8_t>());
+	return buf;
+}
+
+static Vector<uint8_t> _encode_single_pass(const Variant &p_value) {
+
+	int len;
+	Vector<uint8_t> buf;
+	Error err = encode_variant(p_value, buf, len);
+	ERR_FAIL_COND_V(err != OK, Vector<uint8_t>());
+	buf.resize(len);
+	return buf;
+}
+
+static bool _bytes_equal(const Vector<uint8_t> &p_bytes, const uint8_t *p_expected, int p_len) {
+
+	return p_bytes.size() == p_len && memcmp(p_bytes.ptr(), p_expected, p_len) == 0;
+}
+
+// Byte layouts as written by the encoder before the single pass rewrite, they must not change.
+static bool _test_format() {
+
+	bool ok = true;
+
+	struct Golden {
+		Variant value;
+		const char *name;
+		uint8_t bytes[48];
+		int len;
+	};
+
+	PoolVector<uint8_t> pba;
+	pba.push_back(1);
+	pba.push_back(2);
+	pba.push_back(3);
+	PoolVector<String> psa;
+	psa.push_back("a");
+	PoolVector<Vector2> pv2a;
+	pv2a.push_back(Vector2(1, 2));
+	PoolVector<int> pia;
+	pia.push_back(-1);
+	pia.push_back(0x01020304);
+	Array arr;
+	arr.push_back(1);
+	arr.push_back("a");
+
+	Golden golden[] = {
+		{ Variant(), "nil", { 0, 0, 0, 0 }, 4 },
+		{ true, "bool", { 1, 0, 0, 0, 1, 0, 0, 0 }, 8 },
+		{ 7, "int", { 2, 0, 0, 0, 7, 0, 0, 0 }, 8 },
+		{ int64_t(1) << 40, "int64", { 2, 0, 1, 0, 0, 0, 0, 0, 0, 1, 0, 0 }, 12 },
+		{ 0.5, "real", { 3, 0, 0, 0, 0, 0, 0, 0x3f }, 8 },
+		{ "abc", "string", { 4, 0, 0, 0, 3, 0, 0, 0, 'a', 'b', 'c', 0 }, 12 },
+		{ String::utf8("ab\xc3\xa9"), "utf8 string", { 4, 0, 0, 0, 4, 0, 0, 0, 'a', 'b', 0xc3, 0xa9 }, 12 },
+		{ Vector2(1, 2), "vector2", { 5, 0, 0, 0, 0, 0, 0x80, 0x3f, 0, 0, 0, 0x40 }, 12 },
+		{ NodePath("/a:b"), "node path", { 15, 0, 0, 0, 1, 0, 0, 0x80, 1, 0, 0, 0, 1, 0, 0, 0, 1, 0, 0, 0, 'a', 0, 0, 0, 1, 0, 0, 0, 'b', 0, 0, 0 }, 32 },
+		{ arr, "array", { 19, 0, 0, 0, 2, 0, 0, 0, 2, 0, 0, 0, 1, 0, 0, 0, 4, 0, 0, 0, 1, 0, 0, 0, 'a', 0, 0, 0 }, 28 },
+		{ pba, "byte array", { 20, 0, 0, 0, 3, 0, 0, 0, 1, 2, 3, 0 }, 12 },
+		{ pia, "int array", { 21, 0, 0, 0, 2, 0, 0, 0, 0xff, 0xff, 0xff, 0xff, 4, 3, 2, 1 }, 16 },
+		{ psa, "string array", { 23, 0, 0, 0, 1, 0, 0, 0, 2, 0, 0, 0, 'a', 0, 0, 0 }, 16 },
+		{ pv2a, "vector2 array", { 24, 0, 0, 0, 1, 0, 0, 0, 0, 0, 0x80, 0x3f, 0, 0, 0, 0x40 }, 16 },
+	};
+
+	for (unsigned int i = 0; i < sizeof(golden) / sizeof(golden[0]); i++) {
+
+		const Golden &g = golden[i];
+		String what = String(g.name) + " format";
+		CHECK(_bytes_equal(_encode_two_pass(g.value), g.bytes, g.len), what.utf8().get_data());
+		CHECK(_bytes_equal(_encode_single_pass(g.value), g.bytes, g.len), what.utf8().get_data());
+
+		Variant back;
+		int used = 0;
+		Error err = decode_variant(back, g.bytes, g.len, &used);
+		what = String(g.name) + " decode";
+		CHECK(err == OK && used == g.len && back.get_type() == g.value.get_type(), what.utf8().get_data());
+		CHECK(_bytes_equal(_encode_single_pass(back), g.bytes, g.len), what.utf8().get_data());
+	}
+
+	return ok;
+}
+
+static Variant _make_value(int p_entries) {
+
+	Array entries;
+	for (int i = 0; i < p_entries; i++) {
+		Dictionary d;
+		d["id"] = i;
+		d["big"] = int64_t(i) << 33;
+		d["name"] = "entity_" + itos(i) + String::utf8(" \xc3\xa9\xe4\xb8\xad");
+		d["weight"] = i * 0.1;
+		d["transform"] = Transform(Basis(Vector3(0, 1, 0), i * 0.01), Vector3(i, -i, 0.5));
+		d["color"] = Color(0.1, 0.2, 0.3, i % 2);
+		d["path"] = NodePath("Root/Child" + itos(i) + ":position:x");
+		d["rect"] = Rect2(0, 1, 2, i);
+		d["none"] = Variant();
+		entries.push_back(d);
+	}
+
+	PoolVector<uint8_t> bytes;
+	PoolVector<int> ints;
+	PoolVector<real_t> reals;
+	PoolVector<String> strings;
+	PoolVector<Vector2> v2s;
+	PoolVector<Vector3> v3s;
+	PoolVector<Color> colors;
+	for (int i = 0; i < p_entries * 4; i++) {
+		bytes.push_back(i * 7);
+		ints.push_back(i * 1000003);
+		reals.push_back(i * 0.001);
+		v2s.push_back(Vector2(i, -i * 0.5));
+		v3s.push_back(Vector3(i, i * 2, i * 3));
+		colors.push_back(Color(i, 0.25, 0.5, 1));
+		if (i % 4 == 0)
+			strings.push_back("s" + itos(i));
+	}
+
+	Dictionary value;
+	value["entries"] = entries;
+	value["bytes"] = bytes;
+	value["ints"] = ints;
+	value["reals"] = reals;
+	value["strings"] = strings;
+	value["v2s"] = v2s;
+	value["v3s"] = v3s;
+	value["colors"] = colors;
+	return value;
+}
+
+static bool _test_round_trip() {
+
+	bool ok = true;
+
+	Variant value = _make_value(200);
+	Vector<uint8_t> two_pass = _encode_two_pass(value);
+	Vector<uint8_t> single_pass = _encode_single_pass(value);
+	CHECK(two_pass.size() > 0 && _bytes_equal(single_pass, two_pass.ptr(), two_pass.size()), "single pass matches two pass");
+
+	Variant back;
+	int used = 0;
+	Error err = decode_variant(back, single_pass.ptr(), single_pass.size(), &used);
+	CHECK(err == OK && used == single_pass.size(), "decode");
+	CHECK(_bytes_equal(_encode_single_pass(back), single_pass.ptr(), single_pass.size()), "re-encode matches");
+
+	Dictionary d = back;
+	PoolVector<Vector3> v3s = d["v3s"];
+	PoolVector<Color> colors = d["colors"];
+	PoolVector<String> strings = d["strings"];
+	Dictionary entry = Array(d["entries"])[7];
+	CHECK(v3s.size() == 800 && v3s[9] == Vector3(9, 18, 27), "vector3 array");
+	CHECK(colors.size() == 800 && colors[5] == Color(5, 0.25, 0.5, 1), "color array");
+	CHECK(strings.size() == 200 && strings[3] == "s12", "string array");
+	CHECK(String(entry["name"]) == String::utf8("entity_7 \xc3\xa9\xe4\xb8\xad") && int64_t(entry["big"]) == int64_t(7) << 33, "nested entry");
+
+	// appending at an offset keeps what is already in the buffer
+	Vector<uint8_t> buf;
+	buf.push_back(0xAB);
+	buf.push_back(0xCD);
+	int len;
+	err = encode_variant(value, buf, len, 2);
+	CHECK(err == OK && len == two_pass.size() && buf.size() >= len + 2, "encode at offset");
+	CHECK(buf[0] == 0xAB && buf[1] == 0xCD && memcmp(buf.ptr() + 2, two_pass.ptr(), len) == 0, "offset contents");
+
+	return ok;
+}
+
+static bool _test_truncated() {
+
+	bool ok = true;
+
+	// every prefix fails on some check, keep those from flooding the output
+	bool print_errors = _print_error_enabled;
+	_print_error_enabled = false;
+
+	Vector<uint8_t> data = _encode_single_pass(_make_value(3));
+	bool all_failed = true;
+	for (int i = 0; i < data.size(); i++) {
+		Variant v;
+		if (decode_variant(v, data.ptr(), i) == OK)
+			all_failed = false;
+	}
+	CHECK(all_failed, "truncated input is rejected");
+
+	// a huge element count must fail on the size check, not try to allocate
+	uint8_t bogus[] = { 19, 0, 0, 0, 0xff, 0xff, 0xff, 0x7f, 0, 0, 0, 0 };
+	Variant v;
+	CHECK(decode_variant(v, bogus, sizeof(bogus)) != OK, "bogus array count");
+	bogus[0] = 23;
+	CHECK(decode_variant(v, bogus, sizeof(bogus)) != OK, "bogus string array count");
+
+	_print_error_enabled = print_errors;
+
+	return ok;
+}
+
+static void _benchmark() {
+
+	Variant value = _make_value(20000);
+	const int rounds = 10;
+
+	uint64_t begin = OS::get_singleton()->get_ticks_usec();
+	int size = 0;
+	for (int i = 0; i < rounds; i++) {
+		size = _encode_two_pass(value).size();
+	}
+	uint64_t two_pass_time = OS::get_singleton()->get_ticks_usec() - begin;
+
+	Vector<uint8_t> buf;
+	begin = OS::get_singleton()->get_ticks_usec();
+	for (int i = 0; i < rounds; i++) {
+		int len;
+		encode_variant(value, buf, len);
+	}
+	uint64_t single_pass_time = OS::get_singleton()->get_ticks_usec() - begin;
+
+	begin = OS::get_singleton()->get_ticks_usec();
+	for (int i = 0; i < rounds; i++) {
+		Variant back;
+		decode_variant(back, buf.ptr(), size);
+	}
+	uint64_t decode_time = OS::get_singleton()->get_ticks_usec() - begin;
+
+	float mb = size * float(rounds) / (1024.0 * 1024.0);
+	OS::get_singleton()->print("Value of %.1f MB, %i rounds\n", size / (1024.0 * 1024.0), rounds);
+	OS::get_singleton()->print("\tencode (measure, then write): %.1f MB/s\n", mb / USEC_TO_SEC(MAX(two_pass_time, 1)));
+	OS::get_singleton()->print("\tencode (single pass, reused buffer): %.1f MB/s\n", mb / USEC_TO_SEC(MAX(single_pass_time, 1)));
+	OS::get_singleton()->print("\tdecode: %.1f MB/s\n", mb / USEC_TO_SEC(MAX(decode_time, 1)));
+}
+
+MainLoop *test() {
+
+	bool ok = _test_format();
+	ok = _test_round_trip() && ok;
+	ok = _test_truncated() && ok;
+
+	OS::get_singleton()->print(ok ? "Marshalls tests passed\n" : "Marshalls tests FAILED\n");
+
+	_benchmark();
+
+	return NULL;
+}
+} // namespace TestMarshalls
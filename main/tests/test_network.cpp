@@ -0,0 +1,296 @@
+/*************************************************************************/
+/*  test_network.cpp                                                     */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2018 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2018 Godot Engine contributors (cf. AUTHORS.md)    */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#include "test_network.h"
+
+#include "core/io/network_poll_group.h"
+#include "core/io/packet_peer_udp.h"
+#include "core/io/tcp_server.h"
+#include "core/os/os.h"
+
+namespace TestNetwork {
+
+#define CLIENTS 400
+#define SENDING_EVERY 25
+#define PORT 17645
+#define POLL_ITERATIONS 200
+#define UDP_PORT 17646
+#define UDP_BURST 64
+#define UDP_PACKETS 64000
+
+static uint8_t _packet_byte(int p_packet, int p_offset) {
+
+	return (p_packet * 31 + p_offset * 7) & 0xFF;
+}
+
+static int _packet_size(int p_packet) {
+
+	// every packet of the burst at this position is large, so the path for packets that don't fit a slot runs too
+	return p_packet % UDP_BURST == 17 ? 9000 : 1 + (p_packet * 37) % 1400;
+}
+
+static bool _receive_burst(Ref<PacketPeerUDP> p_receiver, int p_first, int p_count, bool p_check) {
+
+	int received = 0;
+	uint64_t deadline = OS::get_singleton()->get_ticks_msec() + 1000;
+	while (received < p_count && OS::get_singleton()->get_ticks_msec() < deadline) {
+
+		if (p_receiver->get_available_packet_count() <= 0) {
+			continue;
+		}
+
+		const uint8_t *buffer;
+		int size;
+		if (p_receiver->get_packet(&buffer, size) != OK) {
+			return false;
+		}
+
+		if (p_check) {
+			int packet = p_first + received;
+			if (size != _packet_size(packet)) {
+				OS::get_singleton()->print("FAIL: packet %d has %d bytes, expected %d\n", packet, size, _packet_size(packet));
+				return false;
+			}
+			for (int i = 0; i < size; i++) {
+				if (buffer[i] != _packet_byte(packet, i)) {
+					OS::get_singleton()->print("FAIL: packet %d differs at byte %d\n", packet, i);
+					return false;
+				}
+			}
+		}
+		received++;
+	}
+
+	if (received != p_count) {
+		OS::get_singleton()->print("FAIL: received %d packets of %d\n", received, p_count);
+		return false;
+	}
+	return true;
+}
+
+static bool _test_udp() {
+
+	Ref<PacketPeerUDP> receiver;
+	receiver.instance();
+	if (receiver->listen(UDP_PORT, IP_Address("127.0.0.1"), 1 << 20) != OK) {
+		OS::get_singleton()->print("Can't listen on port %d, skipping UDP tests\n", UDP_PORT);
+		return true;
+	}
+
+	Ref<PacketPeerUDP> sender;
+	sender.instance();
+	sender->set_dest_address(IP_Address("127.0.0.1"), UDP_PORT);
+
+	Vector<uint8_t> data;
+	data.resize(UDP_BURST * 9000);
+	const uint8_t *buffers[UDP_BURST];
+	int sizes[UDP_BURST];
+
+	// packets come out complete and in order, one at a time or in batches
+	for (int i = 0; i < UDP_BURST * 4; i++) {
+		Vector<uint8_t> packet;
+		packet.resize(_packet_size(i));
+		for (int j = 0; j < packet.size(); j++) {
+			packet.write[j] = _packet_byte(i, j);
+		}
+		sender->put_packet(packet.ptr(), packet.size());
+		if ((i + 1) % UDP_BURST == 0 && !_receive_burst(receiver, i + 1 - UDP_BURST, UDP_BURST, true)) {
+			return false;
+		}
+	}
+
+	for (int i = 0; i < UDP_BURST * 4; i += UDP_BURST) {
+		uint8_t *w = data.ptrw();
+		for (int j = 0; j < UDP_BURST; j++) {
+			buffers[j] = w;
+			sizes[j] = _packet_size(i + j);
+			for (int k = 0; k < sizes[j]; k++) {
+				w[k] = _packet_byte(i + j, k);
+			}
+			w += sizes[j];
+		}
+		int sent;
+		if (sender->put_packets(buffers, sizes, UDP_BURST, sent) != OK || sent != UDP_BURST || !_receive_burst(receiver, i, UDP_BURST, true)) {
+			OS::get_singleton()->print("FAIL: batched packets\n");
+			return false;
+		}
+	}
+
+	// throughput of small packets on loopback, sent in bursts like a server tick would
+	for (int i = 0; i < UDP_BURST; i++) {
+		buffers[i] = data.ptr() + i * 100;
+		sizes[i] = 100;
+	}
+
+	uint64_t begin = OS::get_singleton()->get_ticks_usec();
+	for (int i = 0; i < UDP_PACKETS; i += UDP_BURST) {
+		for (int j = 0; j < UDP_BURST; j++) {
+			sender->put_packet(buffers[j], sizes[j]);
+		}
+		if (!_receive_burst(receiver, 0, UDP_BURST, false)) {
+			return false;
+		}
+	}
+	uint64_t single_time = OS::get_singleton()->get_ticks_usec() - begin;
+
+	begin = OS::get_singleton()->get_ticks_usec();
+	for (int i = 0; i < UDP_PACKETS; i += UDP_BURST) {
+		int sent;
+		sender->put_packets(buffers, sizes, UDP_BURST, sent);
+		if (!_receive_burst(receiver, 0, UDP_BURST, false)) {
+			return false;
+		}
+	}
+	uint64_t batch_time = OS::get_singleton()->get_ticks_usec() - begin;
+
+	OS::get_singleton()->print("%d UDP packets of 100 bytes over loopback, in bursts of %d:\n", UDP_PACKETS, UDP_BURST);
+	OS::get_singleton()->print("\tput_packet: %.0f packets/s, %.2f usec per packet\n", UDP_PACKETS / USEC_TO_SEC(MAX(single_time, 1)), single_time / (float)UDP_PACKETS);
+	OS::get_singleton()->print("\tput_packets: %.0f packets/s, %.2f usec per packet\n", UDP_PACKETS / USEC_TO_SEC(MAX(batch_time, 1)), batch_time / (float)UDP_PACKETS);
+
+	receiver->close();
+	sender->close();
+	return true;
+}
+
+static bool _test_tcp() {
+
+	bool ok = true;
+
+	Ref<TCP_Server> server;
+	server.instance();
+	if (server->listen(PORT, IP_Address("127.0.0.1")) != OK) {
+		OS::get_singleton()->print("Can't listen on port %d, skipping TCP tests\n", PORT);
+		return true;
+	}
+
+	Ref<NetworkPollGroup> group;
+	group.instance();
+	group->add(server.ptr());
+
+	Vector<Ref<StreamPeerTCP> > clients;
+	for (int i = 0; i < CLIENTS; i++) {
+		Ref<StreamPeerTCP> client;
+		client.instance();
+		client->connect_to_host(IP_Address("127.0.0.1"), PORT);
+		clients.push_back(client);
+	}
+
+	// accept everything, waking up only when the server socket has pending connections
+	Vector<Ref<StreamPeerTCP> > peers;
+	uint64_t deadline = OS::get_singleton()->get_ticks_msec() + 5000;
+	while (peers.size() < CLIENTS && OS::get_singleton()->get_ticks_msec() < deadline) {
+		Array ready = group->poll(100);
+		if (ready.size() == 1 && ready[0] == Variant(server)) {
+			while (server->is_connection_available()) {
+				Ref<StreamPeerTCP> peer = server->take_connection();
+				group->add(peer.ptr());
+				peers.push_back(peer);
+			}
+		}
+	}
+	if (peers.size() != CLIENTS) {
+		OS::get_singleton()->print("FAIL: accepted %d connections out of %d\n", peers.size(), CLIENTS);
+		return false;
+	}
+	for (int i = 0; i < CLIENTS; i++) {
+		clients.write[i]->get_status();
+	}
+
+	int expected = 0;
+	for (int i = 0; i < CLIENTS; i += SENDING_EVERY) {
+		clients.write[i]->put_8(i);
+		expected++;
+	}
+
+	// only the peers that were sent something should be reported
+	Set<Object *> reported;
+	deadline = OS::get_singleton()->get_ticks_msec() + 2000;
+	while (reported.size() < expected && OS::get_singleton()->get_ticks_msec() < deadline) {
+		Array ready = group->poll(100);
+		for (int i = 0; i < ready.size(); i++) {
+			reported.insert(ready[i]);
+		}
+	}
+	int wrong = 0;
+	for (Set<Object *>::Element *E = reported.front(); E; E = E->next()) {
+		StreamPeerTCP *peer = Object::cast_to<StreamPeerTCP>(E->get());
+		if (!peer || peer->get_available_bytes() != 1) {
+			wrong++;
+		}
+	}
+	if (reported.size() != expected || wrong) {
+		OS::get_singleton()->print("FAIL: %d peers reported ready (%d wrongly), expected %d\n", reported.size(), wrong, expected);
+		ok = false;
+	}
+
+	uint64_t begin = OS::get_singleton()->get_ticks_usec();
+	int found = 0;
+	for (int i = 0; i < POLL_ITERATIONS; i++) {
+		for (int j = 0; j < peers.size(); j++) {
+			if (peers[j]->get_available_bytes() > 0) {
+				found++;
+			}
+		}
+	}
+	uint64_t each_time = OS::get_singleton()->get_ticks_usec() - begin;
+
+	begin = OS::get_singleton()->get_ticks_usec();
+	for (int i = 0; i < POLL_ITERATIONS; i++) {
+		found += group->poll(0).size();
+	}
+	uint64_t group_time = OS::get_singleton()->get_ticks_usec() - begin;
+
+	OS::get_singleton()->print("Finding %d ready peers out of %d (%d):\n", expected, CLIENTS, found);
+	OS::get_singleton()->print("\tchecking each peer: %.1f usec\n", each_time / (float)POLL_ITERATIONS);
+	OS::get_singleton()->print("\tpoll group: %.1f usec\n", group_time / (float)POLL_ITERATIONS);
+
+	// freed peers leave the group by themselves
+	peers.clear();
+	if (group->get_peer_count() != 1) {
+		OS::get_singleton()->print("FAIL: %d peers left in the group, expected only the server\n", group->get_peer_count());
+		ok = false;
+	}
+
+	clients.clear();
+	server->stop();
+
+	return ok;
+}
+
+MainLoop *test() {
+
+	bool ok = _test_tcp();
+	ok = _test_udp() && ok;
+
+	OS::get_singleton()->print(ok ? "Network tests passed\n" : "Network tests FAILED\n");
+
+	return NULL;
+}
+} // namespace TestNetwork
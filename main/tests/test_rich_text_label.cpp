@@ -0,0 +1,176 @@
+/*************************************************************************/
+/*  test_rich_text_label.cpp                                             */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2018 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2018 Godot Engine contributors (cf. AUTHORS.md)    */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#include "test_rich_text_label.h"
+
+#include "core/os/os.h"
+#include "scene/gui/rich_text_label.h"
+#include "scene/gui/scroll_bar.h"
+
+namespace TestRichTextLabel {
+
+#define LINES 20000
+#define APPENDS 1000
+#define HIT_TESTS 10000
+
+static String _make_line(int p_index) {
+
+	return "Line " + itos(p_index) + ": the quick brown fox\tjumps over the lazy dog, again and again and again until it wraps.";
+}
+
+static bool _test_append_matches_set() {
+
+	// text appended in pieces must lay out exactly like the same text added at once
+	RichTextLabel *pieces = memnew(RichTextLabel);
+	RichTextLabel *whole = memnew(RichTextLabel);
+	pieces->set_size(Size2(120, 400));
+	whole->set_size(Size2(120, 400));
+
+	String text;
+	for (int i = 0; i < 50; i++) {
+		String piece = "AV" + itos(i) + " To\tWa ";
+		pieces->add_text(piece);
+		pieces->scroll_to_line(0); // lay out after every piece
+		text += piece;
+	}
+	whole->add_text(text);
+	whole->scroll_to_line(0);
+
+	bool ok = pieces->get_content_height() == whole->get_content_height() && pieces->get_total_character_count() == whole->get_total_character_count();
+	if (!ok) {
+		OS::get_singleton()->print("appended text lays out differently: height %d vs %d\n", pieces->get_content_height(), whole->get_content_height());
+	}
+
+	memdelete(pieces);
+	memdelete(whole);
+	return ok;
+}
+
+static bool _test_remove_line() {
+
+	RichTextLabel *removed = memnew(RichTextLabel);
+	RichTextLabel *reference = memnew(RichTextLabel);
+	removed->set_size(Size2(300, 400));
+	reference->set_size(Size2(300, 400));
+
+	for (int i = 0; i < 20; i++) {
+		removed->add_text(_make_line(i) + "\n");
+		if (i != 10) {
+			reference->add_text(_make_line(i) + "\n");
+		}
+	}
+	removed->scroll_to_line(0);
+	removed->remove_line(10);
+	removed->scroll_to_line(0);
+	reference->scroll_to_line(0);
+
+	bool ok = removed->get_content_height() == reference->get_content_height() && removed->get_line_count() == reference->get_line_count();
+	if (!ok) {
+		OS::get_singleton()->print("remove_line leaves stale layout: height %d vs %d\n", removed->get_content_height(), reference->get_content_height());
+	}
+
+	memdelete(removed);
+	memdelete(reference);
+	return ok;
+}
+
+MainLoop *test() {
+
+	bool ok = true;
+
+	ok = _test_append_matches_set() && ok;
+	ok = _test_remove_line() && ok;
+
+	RichTextLabel *label = memnew(RichTextLabel);
+	label->set_size(Size2(800, 600));
+
+	OS::get_singleton()->print("\n\nRichTextLabel with %d lines\n", LINES);
+
+	int chars = 0;
+	uint64_t begin = OS::get_singleton()->get_ticks_usec();
+	for (int i = 0; i < LINES; i++) {
+		String line = _make_line(i) + "\n";
+		chars += line.length() - 1;
+		label->add_text(line);
+	}
+	OS::get_singleton()->print("add_text: %d usec\n", int(OS::get_singleton()->get_ticks_usec() - begin));
+
+	begin = OS::get_singleton()->get_ticks_usec();
+	label->scroll_to_line(LINES - 1);
+	OS::get_singleton()->print("first layout: %d usec\n", int(OS::get_singleton()->get_ticks_usec() - begin));
+
+	if (label->get_total_character_count() != chars) {
+		OS::get_singleton()->print("character count %d, expected %d\n", label->get_total_character_count(), chars);
+		ok = false;
+	}
+
+	// appending to a long log must only lay out the new lines
+	begin = OS::get_singleton()->get_ticks_usec();
+	for (int i = 0; i < APPENDS; i++) {
+		label->add_text(_make_line(LINES + i) + "\n");
+		label->scroll_to_line(label->get_line_count() - 1);
+	}
+	OS::get_singleton()->print("%d appends with layout: %d usec\n", APPENDS, int(OS::get_singleton()->get_ticks_usec() - begin));
+
+	begin = OS::get_singleton()->get_ticks_usec();
+	for (int i = 0; i < APPENDS; i++) {
+		label->append_bbcode("[color=#ff8080]" + _make_line(i) + "[/color] [u]" + itos(i) + "[/u]\n");
+		label->scroll_to_line(label->get_line_count() - 1);
+	}
+	OS::get_singleton()->print("%d append_bbcode with layout: %d usec\n", APPENDS, int(OS::get_singleton()->get_ticks_usec() - begin));
+
+	// hit-testing all over the log, as done when hovering while scrolling
+	VScrollBar *vscroll = label->get_v_scroll();
+	int content_height = label->get_content_height();
+
+	begin = OS::get_singleton()->get_ticks_usec();
+	for (int i = 0; i < HIT_TESTS; i++) {
+		vscroll->set_value((int64_t(i) * 7919 % HIT_TESTS) * content_height / HIT_TESTS);
+		label->get_cursor_shape(Point2((i * 31) % 800, (i * 17) % 600));
+	}
+	OS::get_singleton()->print("%d scrolled hit-tests: %d usec\n", HIT_TESTS, int(OS::get_singleton()->get_ticks_usec() - begin));
+
+	begin = OS::get_singleton()->get_ticks_usec();
+	label->set_size(Size2(800, 300));
+	label->scroll_to_line(0);
+	OS::get_singleton()->print("height-only resize: %d usec\n", int(OS::get_singleton()->get_ticks_usec() - begin));
+
+	if (label->get_content_height() != content_height) {
+		OS::get_singleton()->print("content height changed after a height-only resize\n");
+		ok = false;
+	}
+
+	OS::get_singleton()->print(ok ? "OK\n" : "FAILED\n");
+
+	memdelete(label);
+
+	return NULL;
+}
+} // namespace TestRichTextLabel
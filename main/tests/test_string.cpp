@@ -33,6 +33,8 @@
 //#include "core/math/math_funcs.h"
 #include "core/io/ip_address.h"
 #include "core/os/os.h"
+#include "core/os/thread.h"
+#include "core/string_db.h"
 #include <stdio.h>
 
 #include "test_string.h"
@@ -854,6 +856,157 @@ bool test_29() {
 	return state;
 };
 
+struct StringNameThreadData {
+
+	int offset;
+	Vector<StringName> names;
+};
+
+static const int STRING_NAME_TEST_COUNT = 20000;
+
+static void _intern_string_names(void *p_userdata) {
+
+	StringNameThreadData *td = (StringNameThreadData *)p_userdata;
+
+	td->names.resize(STRING_NAME_TEST_COUNT);
+	for (int i = 0; i < STRING_NAME_TEST_COUNT; i++) {
+		// every thread interns the same names, starting at a different one
+		int idx = (i + td->offset) % STRING_NAME_TEST_COUNT;
+		td->names.write[idx] = StringName("test_string_name_" + itos(idx));
+	}
+}
+
+bool test_30() {
+
+	OS::get_singleton()->print("\n\nTest 30: StringName interning from several threads\n");
+
+	bool state = true;
+
+	for (int thread_count = 1; thread_count <= 8; thread_count *= 2) {
+
+		StringNameThreadData data[8];
+		Thread *threads[8];
+
+		uint64_t from = OS::get_singleton()->get_ticks_usec();
+		for (int i = 0; i < thread_count; i++) {
+			data[i].offset = i * STRING_NAME_TEST_COUNT / thread_count;
+			threads[i] = Thread::create(_intern_string_names, &data[i]);
+		}
+		for (int i = 0; i < thread_count; i++) {
+			Thread::wait_to_finish(threads[i]);
+			memdelete(threads[i]);
+		}
+		uint64_t elapsed = OS::get_singleton()->get_ticks_usec() - from;
+
+		for (int i = 1; i < thread_count; i++) {
+			for (int j = 0; j < STRING_NAME_TEST_COUNT; j++) {
+				if (data[i].names[j] != data[0].names[j]) {
+					state = false;
+				}
+			}
+		}
+
+		OS::get_singleton()->print("\t%i threads: %i names each in %i usec\n", thread_count, STRING_NAME_TEST_COUNT, int(elapsed));
+	}
+
+	return state;
+}
+
+bool test_31() {
+
+	OS::get_singleton()->print("\n\nTest 31: Long strings mixing ASCII and other characters\n");
+
+	bool state = true;
+
+	// long enough to go through the vectorized loops, with non ASCII characters in between
+	String s;
+	for (int i = 0; i < 10; i++) {
+		s += String::utf8("Some ASCII text before a \xc3\xa9 and after, then \xe4\xb8\xad and more text.");
+	}
+
+	CharString cs = s.utf8();
+	String back;
+	back.parse_utf8(cs.get_data(), cs.length());
+	bool success = back == s && String::utf8(cs.get_data()) == s;
+	OS::get_singleton()->print("\tUTF-8 round trip: %s\n", success ? "OK" : "FAIL");
+	state = state && success;
+
+	String upper = s.to_upper();
+	success = upper.begins_with(String::utf8("SOME ASCII TEXT BEFORE A \xc3\x89")) && upper.find("THEN") > 0 && upper.to_lower() == s.to_lower();
+	OS::get_singleton()->print("\tCase conversion: %s\n", success ? "OK" : "FAIL");
+	state = state && success;
+
+	success = s.find("more text.", 40) == s.find("more text") && s.find("more text", s.length() - 11) == s.length() - 11 && s.find("missing") == -1;
+	OS::get_singleton()->print("\tFind: %s\n", success ? "OK" : "FAIL");
+	state = state && success;
+
+	uint32_t hashv = 5381;
+	for (int i = 0; i < s.length(); i++) {
+		hashv = ((hashv << 5) + hashv) + s[i];
+	}
+	success = s.hash() == hashv;
+	OS::get_singleton()->print("\tHash: %s\n", success ? "OK" : "FAIL");
+	state = state && success;
+
+	return state;
+}
+
+bool test_32() {
+
+	OS::get_singleton()->print("\n\nTest 32: String primitives benchmark\n");
+
+	String text;
+	for (int i = 0; i < 20000; i++) {
+		text += "res://scenes/level_" + itos(i) + "/props/crate.tscn\n";
+	}
+	CharString utf8 = text.utf8();
+
+	const int iterations = 20;
+	int checksum = 0;
+
+	uint64_t from = OS::get_singleton()->get_ticks_usec();
+	for (int i = 0; i < iterations; i++) {
+		String parsed;
+		parsed.parse_utf8(utf8.get_data(), utf8.length());
+		checksum += parsed.length();
+	}
+	OS::get_singleton()->print("\tparse_utf8: %i usec\n", int(OS::get_singleton()->get_ticks_usec() - from));
+
+	from = OS::get_singleton()->get_ticks_usec();
+	for (int i = 0; i < iterations; i++) {
+		checksum += text.utf8().length();
+	}
+	OS::get_singleton()->print("\tutf8: %i usec\n", int(OS::get_singleton()->get_ticks_usec() - from));
+
+	from = OS::get_singleton()->get_ticks_usec();
+	for (int i = 0; i < iterations; i++) {
+		checksum += text.find("level_19999");
+	}
+	OS::get_singleton()->print("\tfind: %i usec\n", int(OS::get_singleton()->get_ticks_usec() - from));
+
+	from = OS::get_singleton()->get_ticks_usec();
+	for (int i = 0; i < iterations; i++) {
+		checksum += text.split("\n").size();
+	}
+	OS::get_singleton()->print("\tsplit: %i usec\n", int(OS::get_singleton()->get_ticks_usec() - from));
+
+	from = OS::get_singleton()->get_ticks_usec();
+	for (int i = 0; i < iterations; i++) {
+		checksum += text.to_upper().length();
+	}
+	OS::get_singleton()->print("\tto_upper: %i usec\n", int(OS::get_singleton()->get_ticks_usec() - from));
+
+	from = OS::get_singleton()->get_ticks_usec();
+	for (int i = 0; i < iterations; i++) {
+		checksum += text.hash() & 1;
+	}
+	OS::get_singleton()->print("\thash: %i usec\n", int(OS::get_singleton()->get_ticks_usec() - from));
+
+	OS::get_singleton()->print("\t(checksum %i)\n", checksum);
+
+	return true;
+}
+
 typedef bool (*TestFunc)(void);
 
 TestFunc test_funcs[] = {
@@ -887,6 +1040,9 @@ TestFunc test_funcs[] = {
 	test_27,
 	test_28,
 	test_29,
+	test_30,
+	test_31,
+	test_32,
 	0
 
 };
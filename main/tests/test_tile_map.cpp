@@ -0,0 +1,138 @@
+/*************************************************************************/
+/*  test_tile_map.cpp                                                    */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2018 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2018 Godot Engine contributors (cf. AUTHORS.md)    */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#include "test_tile_map.h"
+
+#include "core/math/math_funcs.h"
+#include "core/os/os.h"
+#include "scene/2d/tile_map.h"
+
+namespace TestTileMap {
+
+#define MAP_SIZE 1024
+#define EDITS 200000
+
+MainLoop *test() {
+
+	TileMap *tile_map = memnew(TileMap);
+	bool ok = true;
+
+	OS::get_singleton()->print("\n\nTileMap fill %dx%d\n", MAP_SIZE, MAP_SIZE);
+
+	uint64_t begin = OS::get_singleton()->get_ticks_usec();
+	for (int y = 0; y < MAP_SIZE; y++) {
+		for (int x = 0; x < MAP_SIZE; x++) {
+			tile_map->set_cell(x - MAP_SIZE / 2, y - MAP_SIZE / 2, (x ^ y) & 7);
+		}
+	}
+	OS::get_singleton()->print("set_cell: %d usec\n", int(OS::get_singleton()->get_ticks_usec() - begin));
+
+	tile_map->clear();
+
+	begin = OS::get_singleton()->get_ticks_usec();
+	tile_map->set_cells_rect(Rect2(-MAP_SIZE / 2, -MAP_SIZE / 2, MAP_SIZE, MAP_SIZE), 1);
+	OS::get_singleton()->print("set_cells_rect: %d usec\n", int(OS::get_singleton()->get_ticks_usec() - begin));
+
+	tile_map->clear();
+
+	PoolVector<int> tiles;
+	tiles.resize(MAP_SIZE * MAP_SIZE);
+	{
+		PoolVector<int>::Write w = tiles.write();
+		for (int i = 0; i < MAP_SIZE * MAP_SIZE; i++) {
+			w[i] = ((i % MAP_SIZE) ^ (i / MAP_SIZE)) & 7;
+		}
+	}
+
+	begin = OS::get_singleton()->get_ticks_usec();
+	tile_map->set_cells_array(Rect2(-MAP_SIZE / 2, -MAP_SIZE / 2, MAP_SIZE, MAP_SIZE), tiles);
+	OS::get_singleton()->print("set_cells_array: %d usec\n", int(OS::get_singleton()->get_ticks_usec() - begin));
+
+	for (int i = 0; i < MAP_SIZE * MAP_SIZE; i += 4093) {
+		int x = i % MAP_SIZE, y = i / MAP_SIZE;
+		if (tile_map->get_cell(x - MAP_SIZE / 2, y - MAP_SIZE / 2) != ((x ^ y) & 7)) {
+			OS::get_singleton()->print("cell %d,%d does not match\n", x, y);
+			ok = false;
+			break;
+		}
+	}
+
+	Math::seed(1);
+
+	begin = OS::get_singleton()->get_ticks_usec();
+	for (int i = 0; i < EDITS; i++) {
+		int x = Math::rand() % MAP_SIZE - MAP_SIZE / 2;
+		int y = Math::rand() % MAP_SIZE - MAP_SIZE / 2;
+		tile_map->set_cell(x, y, (i & 1) ? TileMap::INVALID_CELL : 3);
+	}
+	OS::get_singleton()->print("%d random edits: %d usec\n", EDITS, int(OS::get_singleton()->get_ticks_usec() - begin));
+
+	begin = OS::get_singleton()->get_ticks_usec();
+	Variant tile_data = tile_map->get("tile_data");
+	OS::get_singleton()->print("tile_data save: %d usec\n", int(OS::get_singleton()->get_ticks_usec() - begin));
+
+	TileMap *copy = memnew(TileMap);
+	begin = OS::get_singleton()->get_ticks_usec();
+	copy->set("tile_data", tile_data);
+	OS::get_singleton()->print("tile_data load: %d usec\n", int(OS::get_singleton()->get_ticks_usec() - begin));
+
+	Array used = tile_map->get_used_cells();
+	Array copy_used = copy->get_used_cells();
+	if (used.size() != copy_used.size() || copy->get_used_rect() != tile_map->get_used_rect()) {
+		OS::get_singleton()->print("tile_data round trip lost cells\n");
+		ok = false;
+	} else {
+		for (int i = 0; i < used.size(); i++) {
+			Vector2 p = used[i];
+			if (copy_used[i] != used[i] || copy->get_cellv(p) != tile_map->get_cellv(p)) {
+				OS::get_singleton()->print("tile_data round trip mismatch at %d,%d\n", int(p.x), int(p.y));
+				ok = false;
+				break;
+			}
+			if (i > 0) {
+				// cells are reported sorted by row, then column
+				Vector2 prev = used[i - 1];
+				if (prev.y > p.y || (prev.y == p.y && prev.x >= p.x)) {
+					OS::get_singleton()->print("used cells are not sorted\n");
+					ok = false;
+					break;
+				}
+			}
+		}
+	}
+
+	OS::get_singleton()->print(ok ? "OK\n" : "FAILED\n");
+
+	memdelete(copy);
+	memdelete(tile_map);
+
+	return NULL;
+}
+} // namespace TestTileMap
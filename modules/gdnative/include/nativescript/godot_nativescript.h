@@ -243,6 +243,37 @@ void GDAPI *godot_nativescript_get_instance_binding_data(int p_idx, godot_object
 
 void GDAPI godot_nativescript_profiling_add_data(const char *p_signature, uint64_t p_time);
 
+/*
+ *
+ *
+ * NativeScript 1.2
+ *
+ *
+ */
+
+// typed methods, called with native values instead of variants
+
+typedef struct {
+	// instance pointer, method data, user data, args, return value
+	// args and return value are laid out like in godot_method_bind_ptrcall
+	GDCALLINGCONV void (*method)(godot_object *, void *, void *, const void **, void *);
+	void *method_data;
+	GDCALLINGCONV void (*free_func)(void *);
+} godot_instance_ptrcall_method;
+
+typedef struct {
+	// GODOT_VARIANT_TYPE_NIL passes (or returns) a godot_variant as is
+	godot_variant_type return_type;
+	int num_args;
+	const godot_variant_type *arg_types;
+} godot_method_signature;
+
+void GDAPI godot_nativescript_register_ptrcall_method(void *p_gdnative_handle, const char *p_name, const char *p_function_name, godot_method_attributes p_attr, const godot_method_signature *p_signature, godot_instance_ptrcall_method p_method);
+
+// resolve a typed method once and call it directly afterwards, handles stay valid until the library is reloaded
+const void GDAPI *godot_nativescript_get_method_handle(const godot_object *p_instance, const char *p_function_name);
+godot_bool GDAPI godot_nativescript_method_ptrcall(godot_object *p_instance, const void *p_method_handle, const void **p_args, void *r_ret);
+
 #ifdef __cplusplus
 }
 #endif
@@ -48,6 +48,20 @@ extern "C" void _native_script_hook() {
 
 #define NSL NativeScriptLanguage::get_singleton()
 
+static void _method_registered(const String &p_lib_path) {
+
+	// registered after the library was initialized, the tables of existing instances need it too,
+	// including those of derived classes
+	const Map<StringName, NativeScriptDesc> &classes = NSL->library_classes[p_lib_path];
+	for (const Map<StringName, NativeScriptDesc>::Element *C = classes.front(); C; C = C->next()) {
+		if (!C->get().method_table.empty()) {
+			NSL->_build_method_tables(p_lib_path);
+			break;
+		}
+	}
+	NSL->library_classes_version++;
+}
+
 // Script API
 
 void GDAPI godot_nativescript_register_class(void *p_gdnative_handle, const char *p_name, const char *p_base, godot_instance_create_func p_create_func, godot_instance_destroy_func p_destroy_func) {
@@ -73,6 +87,7 @@ void GDAPI godot_nativescript_register_class(void *p_gdnative_handle, const char
 	}
 
 	classes->insert(p_name, desc);
+	NSL->library_classes_version++;
 }
 
 void GDAPI godot_nativescript_register_tool_class(void *p_gdnative_handle, const char *p_name, const char *p_base, godot_instance_create_func p_create_func, godot_instance_destroy_func p_destroy_func) {
@@ -97,6 +112,7 @@ void GDAPI godot_nativescript_register_tool_class(void *p_gdnative_handle, const
 	}
 
 	classes->insert(p_name, desc);
+	NSL->library_classes_version++;
 }
 
 void GDAPI godot_nativescript_register_method(void *p_gdnative_handle, const char *p_name, const char *p_function_name, godot_method_attributes p_attr, godot_instance_method p_method) {
@@ -116,6 +132,7 @@ void GDAPI godot_nativescript_register_method(void *p_gdnative_handle, const cha
 	method.info = MethodInfo(p_function_name);
 
 	E->get().methods.insert(p_function_name, method);
+	_method_registered(*s);
 }
 
 void GDAPI godot_nativescript_register_property(void *p_gdnative_handle, const char *p_name, const char *p_path, godot_property_attributes *p_attr, godot_property_set_func p_set_func, godot_property_get_func p_get_func) {
@@ -369,6 +386,80 @@ void GDAPI godot_nativescript_profiling_add_data(const char *p_signature, uint64
 	NativeScriptLanguage::get_singleton()->profiling_add_data(StringName(p_signature), p_time);
 }
 
+void GDAPI godot_nativescript_register_ptrcall_method(void *p_gdnative_handle, const char *p_name, const char *p_function_name, godot_method_attributes p_attr, const godot_method_signature *p_signature, godot_instance_ptrcall_method p_method) {
+
+	String *s = (String *)p_gdnative_handle;
+
+	Map<StringName, NativeScriptDesc>::Element *E = NSL->library_classes[*s].find(p_name);
+
+	if (!E) {
+		ERR_EXPLAIN("Attempted to register method on non-existent class!");
+		ERR_FAIL();
+	}
+
+	ERR_FAIL_COND(!p_signature);
+	ERR_FAIL_COND(!p_method.method);
+
+	NativeScriptDesc::Method method;
+	method.method.method_data = p_method.method_data;
+	method.method.free_func = p_method.free_func;
+	method.ptrcall = p_method.method;
+	method.rpc_mode = p_attr.rpc_type;
+	method.return_type = (Variant::Type)p_signature->return_type;
+	method.info = MethodInfo(p_function_name);
+	method.info.return_val.type = method.return_type;
+
+	method.argument_types.resize(p_signature->num_args);
+	for (int i = 0; i < p_signature->num_args; i++) {
+		Variant::Type type = (Variant::Type)p_signature->arg_types[i];
+		method.argument_types.write[i] = type;
+		method.info.arguments.push_back(PropertyInfo(type, "arg" + itos(i)));
+	}
+
+	E->get().methods.insert(p_function_name, method);
+	_method_registered(*s);
+}
+
+const void GDAPI *godot_nativescript_get_method_handle(const godot_object *p_instance, const char *p_function_name) {
+
+	const Object *instance = (const Object *)p_instance;
+	if (!instance || !instance->get_script_instance() || instance->get_script_instance()->get_language() != NativeScriptLanguage::get_singleton())
+		return NULL;
+
+	Ref<NativeScript> script = instance->get_script_instance()->get_script();
+	NativeScriptDesc *script_data = script.is_valid() ? script->get_script_desc() : NULL;
+	if (!script_data)
+		return NULL;
+
+	NativeScriptDesc::Method *method = script_data->find_method(p_function_name);
+	if (!method || !method->ptrcall)
+		return NULL; // only methods registered with a signature can be called this way
+
+	return method;
+}
+
+godot_bool GDAPI godot_nativescript_method_ptrcall(godot_object *p_instance, const void *p_method_handle, const void **p_args, void *r_ret) {
+
+	Object *instance = (Object *)p_instance;
+	const NativeScriptDesc::Method *method = (const NativeScriptDesc::Method *)p_method_handle;
+
+	ERR_FAIL_COND_V(!instance || !method, false);
+
+	ScriptInstance *script_instance = instance->get_script_instance();
+	ERR_FAIL_COND_V(!script_instance || script_instance->get_language() != NativeScriptLanguage::get_singleton(), false);
+
+	// a handle of another class would get userdata of the wrong type
+	NativeScript *script = Object::cast_to<NativeScript>(script_instance->get_script().ptr());
+	NativeScriptDesc *script_data = script ? script->get_script_desc() : NULL;
+	if (!script_data || !script_data->has_method_handle(method)) {
+		ERR_EXPLAIN("Method handle does not belong to the class of the instance");
+		ERR_FAIL_V(false);
+	}
+
+	method->ptrcall(p_instance, method->method.method_data, ((NativeScriptInstance *)script_instance)->userdata, p_args, r_ret);
+	return true;
+}
+
 #ifdef __cplusplus
 }
 #endif
@@ -110,6 +110,7 @@ void NativeScript::_placeholder_erased(PlaceHolderScriptInstance *p_placeholder)
 
 void NativeScript::set_class_name(String p_class_name) {
 	class_name = p_class_name;
+	script_desc_version = 0;
 }
 
 String NativeScript::get_class_name() const {
@@ -123,6 +124,7 @@ void NativeScript::set_library(Ref<GDNativeLibrary> p_library) {
 	}
 	library = p_library;
 	lib_path = library->get_current_library_path();
+	script_desc_version = 0;
 
 #ifndef NO_THREADS
 	if (Thread::get_caller_id() != Thread::get_main_id()) {
@@ -268,13 +270,7 @@ Error NativeScript::reload(bool p_keep_state) {
 bool NativeScript::has_method(const StringName &p_method) const {
 	NativeScriptDesc *script_data = get_script_desc();
 
-	while (script_data) {
-		if (script_data->methods.has(p_method))
-			return true;
-
-		script_data = script_data->base_data;
-	}
-	return false;
+	return script_data && script_data->find_method(p_method);
 }
 
 MethodInfo NativeScript::get_method_info(const StringName &p_method) const {
@@ -535,6 +531,8 @@ NativeScript::NativeScript() {
 	library = Ref<GDNative>();
 	lib_path = "";
 	class_name = "";
+	script_desc = NULL;
+	script_desc_version = 0;
 #ifndef NO_THREADS
 	owners_lock = Mutex::create();
 #endif
@@ -550,6 +548,188 @@ NativeScript::~NativeScript() {
 
 #define GET_SCRIPT_DESC() script->get_script_desc()
 
+#define NATIVESCRIPT_PTRCALL_TYPES(m_macro)        \
+	m_macro(STRING, String);                       \
+	m_macro(VECTOR2, Vector2);                     \
+	m_macro(RECT2, Rect2);                         \
+	m_macro(VECTOR3, Vector3);                     \
+	m_macro(TRANSFORM2D, Transform2D);             \
+	m_macro(PLANE, Plane);                         \
+	m_macro(QUAT, Quat);                           \
+	m_macro(AABB, AABB);                           \
+	m_macro(BASIS, Basis);                         \
+	m_macro(TRANSFORM, Transform);                 \
+	m_macro(COLOR, Color);                         \
+	m_macro(NODE_PATH, NodePath);                  \
+	m_macro(_RID, RID);                            \
+	m_macro(DICTIONARY, Dictionary);               \
+	m_macro(ARRAY, Array);                         \
+	m_macro(POOL_BYTE_ARRAY, PoolByteArray);       \
+	m_macro(POOL_INT_ARRAY, PoolIntArray);         \
+	m_macro(POOL_REAL_ARRAY, PoolRealArray);       \
+	m_macro(POOL_STRING_ARRAY, PoolStringArray);   \
+	m_macro(POOL_VECTOR2_ARRAY, PoolVector2Array); \
+	m_macro(POOL_VECTOR3_ARRAY, PoolVector3Array); \
+	m_macro(POOL_COLOR_ARRAY, PoolColorArray);
+
+// a value laid out the way ptrcall passes it, built from a variant or turned back into one
+struct NativeScriptPtrcallValue {
+
+	union {
+		bool _bool;
+		int64_t _int;
+		double _real;
+		Object *_object;
+		const Variant *_variant;
+		uint8_t _mem[sizeof(Transform)];
+	};
+	Variant::Type type;
+	bool is_return;
+
+	void set_argument(Variant::Type p_type, const Variant *p_value) {
+
+		type = p_type;
+		is_return = false;
+
+#define PTRCALL_SET(m_enum, m_type)                                            \
+	case Variant::m_enum:                                                      \
+		memnew_placement(_mem, m_type(VariantCaster<m_type>::cast(*p_value))); \
+		break
+
+		switch (type) {
+			case Variant::NIL: _variant = p_value; break;
+			case Variant::BOOL: _bool = *p_value; break;
+			case Variant::INT: _int = *p_value; break;
+			case Variant::REAL: _real = *p_value; break;
+			case Variant::OBJECT: _object = *p_value; break;
+				NATIVESCRIPT_PTRCALL_TYPES(PTRCALL_SET)
+			default: break;
+		}
+#undef PTRCALL_SET
+	}
+
+	void init_return(Variant::Type p_type) {
+
+		type = p_type;
+		is_return = true;
+
+#define PTRCALL_INIT(m_enum, m_type)    \
+	case Variant::m_enum:               \
+		memnew_placement(_mem, m_type); \
+		break
+
+		switch (type) {
+			case Variant::NIL: memnew_placement(_mem, Variant); break;
+			case Variant::BOOL: _bool = false; break;
+			case Variant::INT: _int = 0; break;
+			case Variant::REAL: _real = 0; break;
+			case Variant::OBJECT: _object = NULL; break;
+				NATIVESCRIPT_PTRCALL_TYPES(PTRCALL_INIT)
+			default: break;
+		}
+#undef PTRCALL_INIT
+	}
+
+	void *ptr() {
+
+		switch (type) {
+			case Variant::NIL: return is_return ? (void *)_mem : (void *)_variant;
+			case Variant::BOOL: return &_bool;
+			case Variant::INT: return &_int;
+			case Variant::REAL: return &_real;
+			case Variant::OBJECT: return is_return ? (void *)&_object : (void *)_object;
+			default: return _mem;
+		}
+	}
+
+	Variant get() const {
+
+#define PTRCALL_GET(m_enum, m_type) \
+	case Variant::m_enum:           \
+		return Variant(*(const m_type *)_mem)
+
+		switch (type) {
+			case Variant::NIL: return is_return ? *(const Variant *)_mem : *_variant;
+			case Variant::BOOL: return _bool;
+			case Variant::INT: return _int;
+			case Variant::REAL: return _real;
+			case Variant::OBJECT: return Variant(_object);
+				NATIVESCRIPT_PTRCALL_TYPES(PTRCALL_GET)
+			default: return Variant();
+		}
+#undef PTRCALL_GET
+	}
+
+	void destroy() {
+
+#define PTRCALL_DESTROY(m_enum, m_type) \
+	case Variant::m_enum:               \
+		((m_type *)_mem)->~m_type();    \
+		break
+
+		switch (type) {
+			case Variant::NIL: {
+				if (is_return)
+					((Variant *)_mem)->~Variant();
+			} break;
+				NATIVESCRIPT_PTRCALL_TYPES(PTRCALL_DESTROY)
+			default: break;
+		}
+#undef PTRCALL_DESTROY
+	}
+};
+
+godot_variant NativeScriptInstance::_call_method(const NativeScriptDesc::Method &p_method, const Variant **p_args, int p_argcount, Variant::CallError &r_error) const {
+
+	r_error.error = Variant::CallError::CALL_OK;
+
+	if (!p_method.ptrcall) {
+		return p_method.method.method((godot_object *)owner, p_method.method.method_data, userdata, p_argcount, (godot_variant **)p_args);
+	}
+
+	godot_variant result;
+	godot_variant_new_nil(&result);
+
+	int argc = p_method.argument_types.size();
+	if (p_argcount != argc) {
+		r_error.error = p_argcount < argc ? Variant::CallError::CALL_ERROR_TOO_FEW_ARGUMENTS : Variant::CallError::CALL_ERROR_TOO_MANY_ARGUMENTS;
+		r_error.argument = argc;
+		return result;
+	}
+
+	const Variant::Type *types = p_method.argument_types.ptr();
+	for (int i = 0; i < argc; i++) {
+		if (types[i] != Variant::NIL && p_args[i]->get_type() != types[i] && !Variant::can_convert_strict(p_args[i]->get_type(), types[i])) {
+			r_error.error = Variant::CallError::CALL_ERROR_INVALID_ARGUMENT;
+			r_error.argument = i;
+			r_error.expected = types[i];
+			return result;
+		}
+	}
+
+	NativeScriptPtrcallValue *values = (NativeScriptPtrcallValue *)alloca(sizeof(NativeScriptPtrcallValue) * argc);
+	const void **argptrs = (const void **)alloca(sizeof(void *) * argc);
+
+	for (int i = 0; i < argc; i++) {
+		values[i].set_argument(types[i], p_args[i]);
+		argptrs[i] = values[i].ptr();
+	}
+
+	NativeScriptPtrcallValue ret;
+	ret.init_return(p_method.return_type);
+
+	p_method.ptrcall((godot_object *)owner, p_method.method.method_data, userdata, argptrs, ret.ptr());
+
+	*(Variant *)&result = ret.get();
+
+	ret.destroy();
+	for (int i = 0; i < argc; i++) {
+		values[i].destroy();
+	}
+
+	return result;
+}
+
 void NativeScriptInstance::_ml_call_reversed(NativeScriptDesc *script_data, const StringName &p_method, const Variant **p_args, int p_argcount) {
 	if (script_data->base_data) {
 		_ml_call_reversed(script_data->base_data, p_method, p_args, p_argcount);
@@ -557,7 +737,8 @@ void NativeScriptInstance::_ml_call_reversed(NativeScriptDesc *script_data, cons
 
 	Map<StringName, NativeScriptDesc::Method>::Element *E = script_data->methods.find(p_method);
 	if (E) {
-		godot_variant res = E->get().method.method((godot_object *)owner, E->get().method.method_data, userdata, p_argcount, (godot_variant **)p_args);
+		Variant::CallError err;
+		godot_variant res = _call_method(E->get(), p_args, p_argcount, err);
 		godot_variant_destroy(&res);
 	}
 }
@@ -580,12 +761,8 @@ bool NativeScriptInstance::set(const StringName &p_name, const Variant &p_value)
 			Variant name = p_name;
 			const Variant *args[2] = { &name, &p_value };
 
-			godot_variant result;
-			result = E->get().method.method((godot_object *)owner,
-					E->get().method.method_data,
-					userdata,
-					2,
-					(godot_variant **)args);
+			Variant::CallError err;
+			godot_variant result = _call_method(E->get(), args, 2, err);
 			bool handled = *(Variant *)&result;
 			godot_variant_destroy(&result);
 			if (handled) {
@@ -617,12 +794,8 @@ bool NativeScriptInstance::get(const StringName &p_name, Variant &r_ret) const {
 			Variant name = p_name;
 			const Variant *args[1] = { &name };
 
-			godot_variant result;
-			result = E->get().method.method((godot_object *)owner,
-					E->get().method.method_data,
-					userdata,
-					1,
-					(godot_variant **)args);
+			Variant::CallError err;
+			godot_variant result = _call_method(E->get(), args, 1, err);
 			r_ret = *(Variant *)&result;
 			godot_variant_destroy(&result);
 			if (r_ret.get_type() != Variant::NIL) {
@@ -645,12 +818,8 @@ void NativeScriptInstance::get_property_list(List<PropertyInfo> *p_properties) c
 		Map<StringName, NativeScriptDesc::Method>::Element *E = script_data->methods.find("_get_property_list");
 		if (E) {
 
-			godot_variant result;
-			result = E->get().method.method((godot_object *)owner,
-					E->get().method.method_data,
-					userdata,
-					0,
-					NULL);
+			Variant::CallError err;
+			godot_variant result = _call_method(E->get(), NULL, 0, err);
 			Variant res = *(Variant *)&result;
 			godot_variant_destroy(&result);
 
@@ -724,32 +893,22 @@ Variant NativeScriptInstance::call(const StringName &p_method, const Variant **p
 
 	NativeScriptDesc *script_data = GET_SCRIPT_DESC();
 
-	while (script_data) {
-		Map<StringName, NativeScriptDesc::Method>::Element *E = script_data->methods.find(p_method);
-		if (E) {
-			godot_variant result;
+	NativeScriptDesc::Method *method = script_data ? script_data->find_method(p_method) : NULL;
+	if (method) {
 
 #ifdef DEBUG_ENABLED
-			current_method_call = p_method;
+		current_method_call = p_method;
 #endif
 
-			result = E->get().method.method((godot_object *)owner,
-					E->get().method.method_data,
-					userdata,
-					p_argcount,
-					(godot_variant **)p_args);
+		godot_variant result = _call_method(*method, p_args, p_argcount, r_error);
 
 #ifdef DEBUG_ENABLED
-			current_method_call = "";
+		current_method_call = "";
 #endif
 
-			Variant res = *(Variant *)&result;
-			godot_variant_destroy(&result);
-			r_error.error = Variant::CallError::CALL_OK;
-			return res;
-		}
-
-		script_data = script_data->base_data;
+		Variant res = *(Variant *)&result;
+		godot_variant_destroy(&result);
+		return res;
 	}
 
 	r_error.error = Variant::CallError::CALL_ERROR_INVALID_METHOD;
@@ -875,11 +1034,8 @@ void NativeScriptInstance::call_multilevel(const StringName &p_method, const Var
 	while (script_data) {
 		Map<StringName, NativeScriptDesc::Method>::Element *E = script_data->methods.find(p_method);
 		if (E) {
-			godot_variant res = E->get().method.method((godot_object *)owner,
-					E->get().method.method_data,
-					userdata,
-					p_argcount,
-					(godot_variant **)p_args);
+			Variant::CallError err;
+			godot_variant res = _call_method(E->get(), p_args, p_argcount, err);
 			godot_variant_destroy(&res);
 		}
 		script_data = script_data->base_data;
@@ -991,6 +1147,7 @@ void NativeScriptLanguage::_unload_stuff(bool p_reload) {
 		Ref<GDNative> gdn = E->get();
 
 		library_classes.erase(lib_path);
+		library_classes_version++;
 
 		if (gdn.is_valid() && gdn->get_library().is_valid()) {
 			Ref<GDNativeLibrary> lib = gdn->get_library();
@@ -1008,6 +1165,7 @@ void NativeScriptLanguage::_unload_stuff(bool p_reload) {
 
 NativeScriptLanguage::NativeScriptLanguage() {
 	NativeScriptLanguage::singleton = this;
+	library_classes_version = 1;
 #ifndef NO_THREADS
 	has_objects_to_register = false;
 	mutex = Mutex::create();
@@ -1484,11 +1642,38 @@ void NativeScriptLanguage::init_library(const Ref<GDNativeLibrary> &lib) {
 		} else {
 			((void (*)(godot_string *))proc_ptr)((godot_string *)&lib_path);
 		}
+
+		_build_method_tables(lib_path);
+		library_classes_version++;
 	} else {
 		// already initialized. Nice.
 	}
 }
 
+void NativeScriptLanguage::_build_method_tables(const String &p_lib_path) {
+
+	Map<String, Map<StringName, NativeScriptDesc> >::Element *L = library_classes.find(p_lib_path);
+	if (!L)
+		return;
+
+	for (Map<StringName, NativeScriptDesc>::Element *C = L->get().front(); C; C = C->next()) {
+
+		NativeScriptDesc &desc = C->get();
+		desc.method_table.clear();
+		desc.method_handles.clear();
+
+		// walk from the class to its bases, so overriding methods are found first
+		for (NativeScriptDesc *script_data = &desc; script_data; script_data = script_data->base_data) {
+			for (Map<StringName, NativeScriptDesc::Method>::Element *M = script_data->methods.front(); M; M = M->next()) {
+				if (!desc.method_table.has(M->key())) {
+					desc.method_table[M->key()] = &M->get();
+					desc.method_handles.insert(&M->get());
+				}
+			}
+		}
+	}
+}
+
 void NativeScriptLanguage::register_script(NativeScript *script) {
 #ifndef NO_THREADS
 	MutexLock lock(mutex);
@@ -1673,6 +1858,9 @@ void NativeReloadNode::_notification(int p_what) {
 					((void (*)(void *))proc_ptr)((void *)&L->key());
 				}
 
+				NSL->_build_method_tables(L->key());
+				NSL->library_classes_version++;
+
 				for (Map<String, Set<NativeScript *> >::Element *U = NSL->library_script_users.front(); U; U = U->next()) {
 					for (Set<NativeScript *>::Element *S = U->get().front(); S; S = S->next()) {
 						NativeScript *script = S->get();
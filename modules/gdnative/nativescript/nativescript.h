@@ -55,6 +55,18 @@ struct NativeScriptDesc {
 		MethodInfo info;
 		int rpc_mode;
 		String documentation;
+
+		// set for methods registered with a typed signature, method.method is NULL then
+		GDCALLINGCONV void (*ptrcall)(godot_object *, void *, void *, const void **, void *);
+		Variant::Type return_type;
+		Vector<Variant::Type> argument_types;
+
+		Method() {
+			zeromem(&method, sizeof(godot_instance_method));
+			rpc_mode = GODOT_METHOD_RPC_MODE_DISABLED;
+			ptrcall = NULL;
+			return_type = Variant::NIL;
+		}
 	};
 	struct Property {
 		godot_property_set_func setter;
@@ -73,6 +85,8 @@ struct NativeScriptDesc {
 	String documentation;
 
 	Map<StringName, Method> methods;
+	HashMap<StringName, Method *> method_table; // own and inherited methods, filled once the library is initialized
+	Set<const Method *> method_handles; // the same methods, to check handles given back by libraries
 	OrderedHashMap<StringName, Property> properties;
 	Map<StringName, Signal> signals_; // QtCreator doesn't like the name signals
 	StringName base;
@@ -96,6 +110,34 @@ struct NativeScriptDesc {
 		zeromem(&create_func, sizeof(godot_instance_create_func));
 		zeromem(&destroy_func, sizeof(godot_instance_destroy_func));
 	}
+
+	inline Method *find_method(const StringName &p_name) {
+		if (!method_table.empty()) {
+			Method **M = method_table.getptr(p_name);
+			return M ? *M : NULL;
+		}
+
+		for (NativeScriptDesc *script_data = this; script_data; script_data = script_data->base_data) {
+			Map<StringName, Method>::Element *E = script_data->methods.find(p_name);
+			if (E)
+				return &E->get();
+		}
+		return NULL;
+	}
+
+	inline bool has_method_handle(const void *p_handle) const {
+		if (!method_table.empty()) {
+			return method_handles.has((const Method *)p_handle);
+		}
+
+		for (const NativeScriptDesc *script_data = this; script_data; script_data = script_data->base_data) {
+			for (const Map<StringName, Method>::Element *E = script_data->methods.front(); E; E = E->next()) {
+				if (&E->get() == p_handle)
+					return true;
+			}
+		}
+		return false;
+	}
 };
 
 class NativeScript : public Script {
@@ -118,6 +160,9 @@ class NativeScript : public Script {
 
 	String class_name;
 
+	mutable NativeScriptDesc *script_desc;
+	mutable uint32_t script_desc_version;
+
 	String script_class_name;
 	String script_class_icon_path;
 
@@ -194,6 +239,7 @@ class NativeScriptInstance : public ScriptInstance {
 #endif
 
 	void _ml_call_reversed(NativeScriptDesc *script_data, const StringName &p_method, const Variant **p_args, int p_argcount);
+	godot_variant _call_method(const NativeScriptDesc::Method &p_method, const Variant **p_args, int p_argcount, Variant::CallError &r_error) const;
 
 public:
 	void *userdata;
@@ -277,6 +323,11 @@ public:
 
 	Map<String, Set<NativeScript *> > library_script_users;
 
+	// bumped whenever library_classes changes, so scripts can cache their description
+	uint32_t library_classes_version;
+
+	void _build_method_tables(const String &p_lib_path);
+
 	const StringName _init_call_type = "nativescript_init";
 	const StringName _init_call_name = "nativescript_init";
 
@@ -366,8 +417,12 @@ public:
 };
 
 inline NativeScriptDesc *NativeScript::get_script_desc() const {
-	Map<StringName, NativeScriptDesc>::Element *E = NativeScriptLanguage::singleton->library_classes[lib_path].find(class_name);
-	return E ? &E->get() : NULL;
+	if (script_desc_version != NativeScriptLanguage::singleton->library_classes_version) {
+		Map<StringName, NativeScriptDesc>::Element *E = NativeScriptLanguage::singleton->library_classes[lib_path].find(class_name);
+		script_desc = E ? &E->get() : NULL;
+		script_desc_version = NativeScriptLanguage::singleton->library_classes_version;
+	}
+	return script_desc;
 }
 
 class NativeReloadNode : public Node {
@@ -35,7 +35,10 @@
 #include "servers/visual_server.h"
 
 #include "core/io/marshalls.h"
+#include "core/math/quick_hull.h"
 #include "core/os/os.h"
+#include "scene/resources/box_shape.h"
+#include "scene/resources/convex_polygon_shape.h"
 #include "scene/resources/mesh_library.h"
 #include "scene/scene_string_names.h"
 
@@ -117,15 +120,17 @@ bool GridMap::_get(const StringName &p_name, Variant &r_ret) const {
 
 		Dictionary d;
 
+		Vector<IndexKey> keys;
+		_get_sorted_cell_keys(keys);
+
 		PoolVector<int> cells;
-		cells.resize(cell_map.size() * 3);
+		cells.resize(keys.size() * 3);
 		{
 			PoolVector<int>::Write w = cells.write();
-			int i = 0;
-			for (Map<IndexKey, Cell>::Element *E = cell_map.front(); E; E = E->next(), i++) {
+			for (int i = 0; i < keys.size(); i++) {
 
-				encode_uint64(E->key().key, (uint8_t *)&w[i * 3]);
-				encode_uint32(E->get().cell, (uint8_t *)&w[i * 3 + 2]);
+				encode_uint64(keys[i].key, (uint8_t *)&w[i * 3]);
+				encode_uint32(cell_map[keys[i]].cell, (uint8_t *)&w[i * 3 + 2]);
 			}
 		}
 
@@ -381,9 +386,10 @@ int GridMap::get_cell_item(int p_x, int p_y, int p_z) const {
 	key.y = p_y;
 	key.z = p_z;
 
-	if (!cell_map.has(key))
+	const Cell *c = cell_map.getptr(key);
+	if (!c)
 		return INVALID_CELL_ITEM;
-	return cell_map[key].item;
+	return c->item;
 }
 
 int GridMap::get_cell_item_orientation(int p_x, int p_y, int p_z) const {
@@ -397,9 +403,21 @@ int GridMap::get_cell_item_orientation(int p_x, int p_y, int p_z) const {
 	key.y = p_y;
 	key.z = p_z;
 
-	if (!cell_map.has(key))
+	const Cell *c = cell_map.getptr(key);
+	if (!c)
 		return -1;
-	return cell_map[key].rot;
+	return c->rot;
+}
+
+void GridMap::set_collision_merge_shapes(bool p_enable) {
+
+	collision_merge_shapes = p_enable;
+	_recreate_octant_data();
+}
+
+bool GridMap::get_collision_merge_shapes() const {
+
+	return collision_merge_shapes;
 }
 
 Vector3 GridMap::world_to_map(const Vector3 &p_world_pos) const {
@@ -440,165 +458,612 @@ bool GridMap::_octant_update(const OctantKey &p_key) {
 	if (!g.dirty)
 		return false;
 
-	//erase body shapes
-	PhysicsServer::get_singleton()->body_clear_shapes(g.static_body);
-
-	//erase body shapes debug
-	if (g.collision_debug.is_valid()) {
+	g.dirty = false;
 
-		VS::get_singleton()->mesh_clear(g.collision_debug);
+	if (g.cells.size() == 0) {
+		//octant no longer needed
+		_octant_clean_up(p_key);
+		return true;
 	}
 
-	//erase navigation
-	if (navigation) {
-		for (Map<IndexKey, Octant::NavMesh>::Element *E = g.navmesh_ids.front(); E; E = E->next()) {
-			navigation->navmesh_remove(E->get().id);
+	g.build_version = ++last_build_version;
+
+	OctantBuildJob job;
+	_octant_make_build_job(p_key, job);
+
+	if (g.built && is_inside_tree() && OS::get_singleton()->can_use_threads()) {
+
+		if (!build_thread) {
+			build_mutex = Mutex::create();
+			build_semaphore = Semaphore::create();
+			build_thread_exit = false;
+			build_thread_busy = false;
+			build_thread = Thread::create(_build_thread_func, this);
 		}
-		g.navmesh_ids.clear();
+
+		build_mutex->lock();
+		bool queued = false;
+		for (List<OctantBuildJob>::Element *E = build_jobs.front(); E; E = E->next()) {
+			if (E->get().key == p_key) {
+				//still waiting, just replace it
+				E->get() = job;
+				queued = true;
+				break;
+			}
+		}
+		if (!queued) {
+			build_jobs.push_back(job);
+		}
+		build_mutex->unlock();
+
+		if (!queued) {
+			build_semaphore->post();
+		}
+		set_process_internal(true);
+
+	} else {
+
+		OctantBuild build;
+		_octant_build(job, build);
+		_octant_apply_build(build);
 	}
 
-	//erase multimeshes
+	return false;
+}
 
-	for (int i = 0; i < g.multimesh_instances.size(); i++) {
+void GridMap::_octant_make_build_job(const OctantKey &p_key, OctantBuildJob &r_job) const {
 
-		VS::get_singleton()->free(g.multimesh_instances[i].instance);
-		VS::get_singleton()->free(g.multimesh_instances[i].multimesh);
+	const Octant &g = *octant_map[p_key];
+
+	r_job.key = p_key;
+	r_job.version = g.build_version;
+	r_job.cell_size = cell_size;
+	r_job.offset = _get_offset();
+	r_job.cell_scale = cell_scale;
+	r_job.build_multimeshes = baked_meshes.size() == 0;
+	r_job.merge_shapes = collision_merge_shapes;
+	r_job.debug_collision = g.collision_debug.is_valid();
+
+	if (!mesh_library.is_valid())
+		return;
+
+	for (Set<IndexKey>::Element *E = g.cells.front(); E; E = E->next()) {
+
+		const Cell *c = cell_map.getptr(E->get());
+		ERR_CONTINUE(!c);
+
+		if (!mesh_library->has_item(c->item))
+			continue;
+
+		r_job.cells.push_back(Pair<IndexKey, Cell>(E->get(), *c));
+
+		if (!r_job.items.has(c->item)) {
+			OctantBuildJob::ItemData item;
+			item.mesh = mesh_library->get_item_mesh(c->item);
+			item.shapes = mesh_library->get_item_shapes(c->item);
+			item.navmesh = mesh_library->get_item_navmesh(c->item);
+
+			item.concave_faces.resize(item.shapes.size());
+			if (r_job.debug_collision) {
+				item.debug_lines.resize(item.shapes.size());
+			}
+
+			for (int i = 0; i < item.shapes.size(); i++) {
+
+				Ref<Shape> shape = item.shapes[i].shape;
+				if (shape.is_null())
+					continue;
+
+				Ref<ConcavePolygonShape> concave = shape;
+				if (concave.is_valid()) {
+					item.concave_faces.write[i] = concave->get_faces();
+				}
+				if (r_job.debug_collision) {
+					shape->add_vertices_to_array(item.debug_lines.write[i], Transform());
+				}
+			}
+			r_job.items[c->item] = item;
+		}
 	}
-	g.multimesh_instances.clear();
+}
 
-	if (g.cells.size() == 0) {
-		//octant no longer needed
-		_octant_clean_up(p_key);
+// Faces shared by two neighbouring cells are inside the merged collision and can be dropped.
+
+struct GridMapFaceKey {
+
+	int32_t v[9];
+
+	bool operator==(const GridMapFaceKey &p_key) const {
+
+		for (int i = 0; i < 9; i++) {
+			if (v[i] != p_key.v[i])
+				return false;
+		}
 		return true;
 	}
 
-	PoolVector<Vector3> col_debug;
+	GridMapFaceKey() {}
+	GridMapFaceKey(const Vector3 *p_face) {
 
-	/*
-	 * foreach item in this octant,
-	 * set item's multimesh's instance count to number of cells which have this item
-	 * and set said multimesh bounding box to one containing all cells which have this item
-	 */
+		int32_t snapped[3][3];
+		for (int i = 0; i < 3; i++) {
+			for (int j = 0; j < 3; j++) {
+				snapped[i][j] = int32_t(Math::round(p_face[i][j] * 100.0));
+			}
+		}
 
-	Map<int, List<Pair<Transform, IndexKey> > > multimesh_items;
+		// vertex order does not matter, sort them
+		int order[3] = { 0, 1, 2 };
+		for (int i = 0; i < 2; i++) {
+			for (int j = 0; j < 2 - i; j++) {
+				const int32_t *a = snapped[order[j]];
+				const int32_t *b = snapped[order[j + 1]];
+				if (a[0] > b[0] || (a[0] == b[0] && (a[1] > b[1] || (a[1] == b[1] && a[2] > b[2])))) {
+					SWAP(order[j], order[j + 1]);
+				}
+			}
+		}
 
-	for (Set<IndexKey>::Element *E = g.cells.front(); E; E = E->next()) {
+		for (int i = 0; i < 3; i++) {
+			for (int j = 0; j < 3; j++) {
+				v[i * 3 + j] = snapped[order[i]][j];
+			}
+		}
+	}
+};
+
+struct GridMapFaceKeyHasher {
+
+	static _FORCE_INLINE_ uint32_t hash(const GridMapFaceKey &p_key) {
+
+		uint32_t h = hash_djb2_one_32(p_key.v[0]);
+		for (int i = 1; i < 9; i++) {
+			h = hash_djb2_one_32(p_key.v[i], h);
+		}
+		return h;
+	}
+};
 
-		ERR_CONTINUE(!cell_map.has(E->get()));
-		const Cell &c = cell_map[E->get()];
+static void _grid_map_add_convex_faces(const Vector<Vector3> &p_points, const Geometry::MeshData &p_mesh, Vector<Vector3> &r_faces) {
+
+	Vector3 center;
+	for (int i = 0; i < p_points.size(); i++) {
+		center += p_points[i];
+	}
+	if (p_points.size())
+		center /= p_points.size();
 
-		if (!mesh_library.is_valid() || !mesh_library->has_item(c.item))
+	for (int i = 0; i < p_mesh.faces.size(); i++) {
+
+		const Vector<int> &indices = p_mesh.faces[i].indices;
+		if (indices.size() < 3)
 			continue;
 
-		Vector3 cellpos = Vector3(E->get().x, E->get().y, E->get().z);
-		Vector3 ofs = _get_offset();
+		// quads are split along the diagonal touching the smallest vertex, so two neighbours split their shared face the same way
+		int first = 0;
+		if (indices.size() == 4) {
+			int smallest = 0;
+			for (int j = 1; j < 4; j++) {
+				const Vector3 &a = p_points[indices[j]];
+				const Vector3 &b = p_points[indices[smallest]];
+				if (a.x < b.x || (a.x == b.x && (a.y < b.y || (a.y == b.y && a.z < b.z))))
+					smallest = j;
+			}
+			first = smallest & 1;
+		}
 
-		Transform xform;
+		for (int j = 1; j < indices.size() - 1; j++) {
 
-		if (clip && ((clip_above && cellpos[clip_axis] > clip_floor) || (!clip_above && cellpos[clip_axis] < clip_floor))) {
+			Vector3 face[3] = {
+				p_points[indices[first]],
+				p_points[indices[(first + j) % indices.size()]],
+				p_points[indices[(first + j + 1) % indices.size()]]
+			};
 
-		} else {
+			// keep every face pointing outwards
+			Vector3 face_center = (face[0] + face[1] + face[2]) / 3.0;
+			if (Face3(face[0], face[1], face[2]).get_plane().normal.dot(face_center - center) < 0) {
+				SWAP(face[1], face[2]);
+			}
+
+			for (int k = 0; k < 3; k++) {
+				r_faces.push_back(face[k]);
+			}
+		}
+	}
+}
+
+static bool _grid_map_add_shape_faces(const Ref<Shape> &p_shape, const PoolVector<Vector3> &p_concave_faces, const Transform &p_xform, Vector<Vector3> &r_faces) {
+
+	Ref<ConcavePolygonShape> concave = p_shape;
+	if (concave.is_valid()) {
+
+		PoolVector<Vector3>::Read r = p_concave_faces.read();
+		for (int i = 0; i < p_concave_faces.size(); i++) {
+			r_faces.push_back(p_xform.xform(r[i]));
+		}
+		return true;
+	}
+
+	Vector<Vector3> points;
+	Geometry::MeshData mesh;
+
+	Ref<BoxShape> box = p_shape;
+	Ref<ConvexPolygonShape> convex = p_shape;
+
+	if (box.is_valid()) {
+
+		Vector3 extents = box->get_extents();
+		for (int i = 0; i < 8; i++) {
+			points.push_back(p_xform.xform(Vector3((i & 1) ? extents.x : -extents.x, (i & 2) ? extents.y : -extents.y, (i & 4) ? extents.z : -extents.z)));
 		}
 
+		static const int box_faces[6][4] = {
+			{ 0, 2, 6, 4 },
+			{ 1, 5, 7, 3 },
+			{ 0, 4, 5, 1 },
+			{ 2, 3, 7, 6 },
+			{ 0, 1, 3, 2 },
+			{ 4, 6, 7, 5 }
+		};
+
+		for (int i = 0; i < 6; i++) {
+			Geometry::MeshData::Face f;
+			for (int j = 0; j < 4; j++) {
+				f.indices.push_back(box_faces[i][j]);
+			}
+			mesh.faces.push_back(f);
+		}
+
+	} else if (convex.is_valid()) {
+
+		PoolVector<Vector3> convex_points = convex->get_points();
+		PoolVector<Vector3>::Read r = convex_points.read();
+		for (int i = 0; i < convex_points.size(); i++) {
+			points.push_back(p_xform.xform(r[i]));
+		}
+
+		if (QuickHull::build(points, mesh) != OK)
+			return false;
+
+		points = mesh.vertices;
+
+	} else {
+		// spheres, capsules and the like stay as shapes of their own
+		return false;
+	}
+
+	_grid_map_add_convex_faces(points, mesh, r_faces);
+	return true;
+}
+
+void GridMap::_octant_build(const OctantBuildJob &p_job, OctantBuild &r_build) {
+
+	r_build.key = p_job.key;
+	r_build.version = p_job.version;
+
+	Map<int, int> multimesh_index;
+	Vector<Vector3> faces;
+
+	for (int i = 0; i < p_job.cells.size(); i++) {
+
+		const IndexKey &key = p_job.cells[i].first;
+		const Cell &c = p_job.cells[i].second;
+
+		const Map<int, OctantBuildJob::ItemData>::Element *I = p_job.items.find(c.item);
+		if (!I)
+			continue;
+		const OctantBuildJob::ItemData &item = I->get();
+
+		Vector3 cellpos = Vector3(key.x, key.y, key.z);
+
+		Transform xform;
+
 		xform.basis.set_orthogonal_index(c.rot);
-		xform.set_origin(cellpos * cell_size + ofs);
-		xform.basis.scale(Vector3(cell_scale, cell_scale, cell_scale));
-		if (baked_meshes.size() == 0) {
-			if (mesh_library->get_item_mesh(c.item).is_valid()) {
-				if (!multimesh_items.has(c.item)) {
-					multimesh_items[c.item] = List<Pair<Transform, IndexKey> >();
-				}
+		xform.set_origin(cellpos * p_job.cell_size + p_job.offset);
+		xform.basis.scale(Vector3(p_job.cell_scale, p_job.cell_scale, p_job.cell_scale));
+
+		if (p_job.build_multimeshes && item.mesh.is_valid()) {
 
-				Pair<Transform, IndexKey> p;
-				p.first = xform;
-				p.second = E->get();
-				multimesh_items[c.item].push_back(p);
+			Map<int, int>::Element *E = multimesh_index.find(c.item);
+			if (!E) {
+				E = multimesh_index.insert(c.item, r_build.multimeshes.size());
+				OctantBuild::Multimesh mm;
+				mm.mesh = item.mesh;
+				r_build.multimeshes.push_back(mm);
 			}
+
+			OctantBuild::Multimesh &mm = r_build.multimeshes.write[E->get()];
+			int idx = mm.transforms.size() / 12;
+			mm.transforms.resize(mm.transforms.size() + 12);
+			{
+				PoolVector<float>::Write w = mm.transforms.write();
+				float *ptr = &w[idx * 12];
+				for (int j = 0; j < 3; j++) {
+					ptr[j * 4 + 0] = xform.basis.elements[j][0];
+					ptr[j * 4 + 1] = xform.basis.elements[j][1];
+					ptr[j * 4 + 2] = xform.basis.elements[j][2];
+					ptr[j * 4 + 3] = xform.origin[j];
+				}
+			}
+#ifdef TOOLS_ENABLED
+			Octant::MultimeshInstance::Item it;
+			it.index = idx;
+			it.transform = xform;
+			it.key = key;
+			mm.items.push_back(it);
+#endif
 		}
 
-		Vector<MeshLibrary::ShapeData> shapes = mesh_library->get_item_shapes(c.item);
-		// add the item's shape at given xform to octant's static_body
-		for (int i = 0; i < shapes.size(); i++) {
-			// add the item's shape
-			if (!shapes[i].shape.is_valid())
+		// add the item's shapes at given xform to octant's static_body
+		for (int j = 0; j < item.shapes.size(); j++) {
+
+			const MeshLibrary::ShapeData &shape = item.shapes[j];
+			if (!shape.shape.is_valid())
 				continue;
-			PhysicsServer::get_singleton()->body_add_shape(g.static_body, shapes[i].shape->get_rid(), xform * shapes[i].local_transform);
-			if (g.collision_debug.is_valid()) {
-				shapes.write[i].shape->add_vertices_to_array(col_debug, xform * shapes[i].local_transform);
+
+			Transform shape_xform = xform * shape.local_transform;
+
+			if (!p_job.merge_shapes || !_grid_map_add_shape_faces(shape.shape, item.concave_faces[j], shape_xform, faces)) {
+				OctantBuild::CellShape cs;
+				cs.shape = shape.shape;
+				cs.xform = shape_xform;
+				r_build.shapes.push_back(cs);
+			}
+
+			if (p_job.debug_collision) {
+				const PoolVector<Vector3> &lines = item.debug_lines[j];
+				int base = r_build.collision_debug.size();
+				r_build.collision_debug.resize(base + lines.size());
+				PoolVector<Vector3>::Read r = lines.read();
+				PoolVector<Vector3>::Write w = r_build.collision_debug.write();
+				for (int k = 0; k < lines.size(); k++) {
+					w[base + k] = shape_xform.xform(r[k]);
+				}
 			}
 		}
 
 		// add the item's navmesh at given xform to GridMap's Navigation ancestor
-		Ref<NavigationMesh> navmesh = mesh_library->get_item_navmesh(c.item);
-		if (navmesh.is_valid()) {
-			Octant::NavMesh nm;
+		if (item.navmesh.is_valid()) {
+			OctantBuild::NavMesh nm;
+			nm.key = key;
 			nm.xform = xform;
+			nm.navmesh = item.navmesh;
+			r_build.navmeshes.push_back(nm);
+		}
+	}
 
-			if (navigation) {
-				nm.id = navigation->navmesh_add(navmesh, xform, this);
-			} else {
-				nm.id = -1;
-			}
-			g.navmesh_ids[E->get()] = nm;
+	if (faces.size() == 0)
+		return;
+
+	// drop pairs of identical faces pointing in opposite directions
+	struct FaceCount {
+		int count;
+		Vector3 normal;
+		bool inner;
+	};
+
+	HashMap<GridMapFaceKey, FaceCount, GridMapFaceKeyHasher> face_counts;
+	int face_count = faces.size() / 3;
+
+	for (int i = 0; i < face_count; i++) {
+
+		const Vector3 *face = &faces[i * 3];
+		GridMapFaceKey fk(face);
+		Vector3 normal = Face3(face[0], face[1], face[2]).get_plane().normal;
+
+		FaceCount *fc = face_counts.getptr(fk);
+		if (!fc) {
+			FaceCount new_fc;
+			new_fc.count = 1;
+			new_fc.normal = normal;
+			new_fc.inner = false;
+			face_counts.set(fk, new_fc);
+		} else {
+			fc->count++;
+			fc->inner = fc->count == 2 && fc->normal.dot(normal) < -0.99;
 		}
 	}
 
-	//update multimeshes, only if not baked
-	if (baked_meshes.size() == 0) {
+	r_build.merged_faces.resize(faces.size());
+	int merged = 0;
+	{
+		PoolVector<Vector3>::Write w = r_build.merged_faces.write();
+		for (int i = 0; i < face_count; i++) {
 
-		for (Map<int, List<Pair<Transform, IndexKey> > >::Element *E = multimesh_items.front(); E; E = E->next()) {
-			Octant::MultimeshInstance mmi;
+			const Vector3 *face = &faces[i * 3];
+			if (face_counts[GridMapFaceKey(face)].inner)
+				continue;
+
+			w[merged * 3 + 0] = face[0];
+			w[merged * 3 + 1] = face[1];
+			w[merged * 3 + 2] = face[2];
+			merged++;
+		}
+	}
+	r_build.merged_faces.resize(merged * 3);
+}
 
-			RID mm = VS::get_singleton()->multimesh_create();
-			VS::get_singleton()->multimesh_allocate(mm, E->get().size(), VS::MULTIMESH_TRANSFORM_3D, VS::MULTIMESH_COLOR_NONE);
-			VS::get_singleton()->multimesh_set_mesh(mm, mesh_library->get_item_mesh(E->key())->get_rid());
+void GridMap::_octant_apply_build(const OctantBuild &p_build) {
 
-			int idx = 0;
-			for (List<Pair<Transform, IndexKey> >::Element *F = E->get().front(); F; F = F->next()) {
-				VS::get_singleton()->multimesh_instance_set_transform(mm, idx, F->get().first);
-#ifdef TOOLS_ENABLED
+	Map<OctantKey, Octant *>::Element *O = octant_map.find(p_build.key);
+	if (!O || O->get()->build_version != p_build.version)
+		return; //octant was removed or changed again since
 
-				Octant::MultimeshInstance::Item it;
-				it.index = idx;
-				it.transform = F->get().first;
-				it.key = F->get().second;
-				mmi.items.push_back(it);
-#endif
+	Octant &g = *O->get();
 
-				idx++;
-			}
+	//replace body shapes
+	PhysicsServer::get_singleton()->body_clear_shapes(g.static_body);
+	g.merged_shape = Ref<ConcavePolygonShape>();
 
-			RID instance = VS::get_singleton()->instance_create();
-			VS::get_singleton()->instance_set_base(instance, mm);
+	if (p_build.merged_faces.size()) {
+		g.merged_shape.instance();
+		g.merged_shape->set_faces(p_build.merged_faces);
+		PhysicsServer::get_singleton()->body_add_shape(g.static_body, g.merged_shape->get_rid());
+	}
 
-			if (is_inside_tree()) {
-				VS::get_singleton()->instance_set_scenario(instance, get_world()->get_scenario());
-				VS::get_singleton()->instance_set_transform(instance, get_global_transform());
+	for (int i = 0; i < p_build.shapes.size(); i++) {
+		PhysicsServer::get_singleton()->body_add_shape(g.static_body, p_build.shapes[i].shape->get_rid(), p_build.shapes[i].xform);
+	}
+
+	//replace body shapes debug
+	if (g.collision_debug.is_valid()) {
+
+		VS::get_singleton()->mesh_clear(g.collision_debug);
+
+		if (p_build.collision_debug.size()) {
+
+			Array arr;
+			arr.resize(VS::ARRAY_MAX);
+			arr[VS::ARRAY_VERTEX] = p_build.collision_debug;
+
+			VS::get_singleton()->mesh_add_surface_from_arrays(g.collision_debug, VS::PRIMITIVE_LINES, arr);
+			SceneTree *st = SceneTree::get_singleton();
+			if (st) {
+				VS::get_singleton()->mesh_surface_set_material(g.collision_debug, 0, st->get_debug_collision_material()->get_rid());
 			}
+		}
+	}
 
-			mmi.multimesh = mm;
-			mmi.instance = instance;
+	//replace navigation
+	if (navigation) {
+		for (Map<IndexKey, Octant::NavMesh>::Element *E = g.navmesh_ids.front(); E; E = E->next()) {
+			if (E->get().id >= 0)
+				navigation->navmesh_remove(E->get().id);
+		}
+	}
+	g.navmesh_ids.clear();
+
+	for (int i = 0; i < p_build.navmeshes.size(); i++) {
 
-			g.multimesh_instances.push_back(mmi);
+		Octant::NavMesh nm;
+		nm.xform = p_build.navmeshes[i].xform;
+
+		if (navigation) {
+			nm.id = navigation->navmesh_add(p_build.navmeshes[i].navmesh, nm.xform, this);
+		} else {
+			nm.id = -1;
 		}
+		g.navmesh_ids[p_build.navmeshes[i].key] = nm;
 	}
 
-	if (col_debug.size()) {
+	//create the new multimeshes first, so the octant never shows up empty
+	Vector<Octant::MultimeshInstance> old_multimesh_instances = g.multimesh_instances;
+	g.multimesh_instances.clear();
 
-		Array arr;
-		arr.resize(VS::ARRAY_MAX);
-		arr[VS::ARRAY_VERTEX] = col_debug;
+	for (int i = 0; i < p_build.multimeshes.size(); i++) {
 
-		VS::get_singleton()->mesh_add_surface_from_arrays(g.collision_debug, VS::PRIMITIVE_LINES, arr);
-		SceneTree *st = SceneTree::get_singleton();
-		if (st) {
-			VS::get_singleton()->mesh_surface_set_material(g.collision_debug, 0, st->get_debug_collision_material()->get_rid());
+		const OctantBuild::Multimesh &mm_build = p_build.multimeshes[i];
+		Octant::MultimeshInstance mmi;
+
+		RID mm = VS::get_singleton()->multimesh_create();
+		VS::get_singleton()->multimesh_allocate(mm, mm_build.transforms.size() / 12, VS::MULTIMESH_TRANSFORM_3D, VS::MULTIMESH_COLOR_NONE);
+		VS::get_singleton()->multimesh_set_mesh(mm, mm_build.mesh->get_rid());
+		VS::get_singleton()->multimesh_set_as_bulk_array(mm, mm_build.transforms);
+#ifdef TOOLS_ENABLED
+		mmi.items = mm_build.items;
+#endif
+
+		RID instance = VS::get_singleton()->instance_create();
+		VS::get_singleton()->instance_set_base(instance, mm);
+
+		if (is_inside_tree()) {
+			VS::get_singleton()->instance_set_scenario(instance, get_world()->get_scenario());
+			VS::get_singleton()->instance_set_transform(instance, get_global_transform());
+			VS::get_singleton()->instance_set_visible(instance, is_visible());
 		}
+
+		mmi.multimesh = mm;
+		mmi.instance = instance;
+
+		g.multimesh_instances.push_back(mmi);
 	}
 
-	g.dirty = false;
+	for (int i = 0; i < old_multimesh_instances.size(); i++) {
 
-	return false;
+		VS::get_singleton()->free(old_multimesh_instances[i].instance);
+		VS::get_singleton()->free(old_multimesh_instances[i].multimesh);
+	}
+
+	g.built = true;
+}
+
+void GridMap::_build_thread_func(void *p_userdata) {
+
+	GridMap *grid_map = (GridMap *)p_userdata;
+	grid_map->_build_thread();
+}
+
+void GridMap::_build_thread() {
+
+	while (true) {
+
+		build_semaphore->wait();
+
+		if (build_thread_exit)
+			break;
+
+		build_mutex->lock();
+		if (build_jobs.empty()) {
+			build_mutex->unlock();
+			continue;
+		}
+
+		// The result holds on to the job, so the last references to its meshes and shapes are dropped
+		// when the result is applied on the main thread, never here.
+		OctantBuild *build = memnew(OctantBuild);
+		build->job = build_jobs.front()->get();
+		build_jobs.pop_front();
+		build_thread_busy = true;
+		build_mutex->unlock();
+
+		_octant_build(build->job, *build);
+
+		build_mutex->lock();
+		build_results.push_back(build);
+		build_thread_busy = false;
+		build_mutex->unlock();
+	}
+}
+
+void GridMap::_stop_build_thread() {
+
+	if (!build_thread)
+		return;
+
+	build_thread_exit = true;
+	build_semaphore->post();
+	Thread::wait_to_finish(build_thread);
+	memdelete(build_thread);
+	build_thread = NULL;
+	memdelete(build_semaphore);
+	build_semaphore = NULL;
+	memdelete(build_mutex);
+	build_mutex = NULL;
+
+	build_jobs.clear();
+	while (build_results.size()) {
+		memdelete(build_results.front()->get());
+		build_results.pop_front();
+	}
+}
+
+void GridMap::_process_build_results() {
+
+	build_mutex->lock();
+	List<OctantBuild *> results = build_results;
+	build_results.clear();
+	bool done = build_jobs.empty() && !build_thread_busy;
+	build_mutex->unlock();
+
+	for (List<OctantBuild *>::Element *E = results.front(); E; E = E->next()) {
+		_octant_apply_build(*E->get());
+		memdelete(E->get());
+	}
+
+	if (done) {
+		set_process_internal(false);
+	}
 }
 
 void GridMap::_reset_physic_bodies_collision_filters() {
@@ -628,8 +1093,9 @@ void GridMap::_octant_enter_world(const OctantKey &p_key) {
 	if (navigation && mesh_library.is_valid()) {
 		for (Map<IndexKey, Octant::NavMesh>::Element *F = g.navmesh_ids.front(); F; F = F->next()) {
 
-			if (cell_map.has(F->key()) && F->get().id < 0) {
-				Ref<NavigationMesh> nm = mesh_library->get_item_navmesh(cell_map[F->key()].item);
+			const Cell *c = cell_map.getptr(F->key());
+			if (c && F->get().id < 0) {
+				Ref<NavigationMesh> nm = mesh_library->get_item_navmesh(c->item);
 				if (nm.is_valid()) {
 					F->get().id = navigation->navmesh_add(nm, F->get().xform, this);
 				}
@@ -722,6 +1188,15 @@ void GridMap::_notification(int p_what) {
 				VS::get_singleton()->instance_set_transform(baked_meshes[i].instance, get_global_transform());
 			}
 
+			if (build_thread) {
+				set_process_internal(true);
+			}
+
+		} break;
+		case NOTIFICATION_INTERNAL_PROCESS: {
+
+			_process_build_results();
+
 		} break;
 		case NOTIFICATION_TRANSFORM_CHANGED: {
 
@@ -789,11 +1264,13 @@ void GridMap::_queue_octants_dirty() {
 void GridMap::_recreate_octant_data() {
 
 	recreating_octants = true;
-	Map<IndexKey, Cell> cell_copy = cell_map;
+	HashMap<IndexKey, Cell, IndexKeyHasher> cell_copy = cell_map;
 	_clear_internal();
-	for (Map<IndexKey, Cell>::Element *E = cell_copy.front(); E; E = E->next()) {
+	const IndexKey *k = NULL;
+	while ((k = cell_copy.next(k))) {
 
-		set_cell_item(E->key().x, E->key().y, E->key().z, E->get().item, E->get().rot);
+		const Cell &c = cell_copy[*k];
+		set_cell_item(k->x, k->y, k->z, c.item, c.rot);
 	}
 	recreating_octants = false;
 }
@@ -810,6 +1287,13 @@ void GridMap::_clear_internal() {
 
 	octant_map.clear();
 	cell_map.clear();
+
+	if (build_mutex) {
+		//results for the removed octants are dropped when they come back
+		build_mutex->lock();
+		build_jobs.clear();
+		build_mutex->unlock();
+	}
 }
 
 void GridMap::clear() {
@@ -837,8 +1321,9 @@ void GridMap::_update_octants_callback() {
 	}
 
 	while (to_delete.front()) {
+		memdelete(octant_map[to_delete.front()->get()]);
 		octant_map.erase(to_delete.front()->get());
-		to_delete.pop_back();
+		to_delete.pop_front();
 	}
 
 	_update_visibility();
@@ -856,6 +1341,9 @@ void GridMap::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("set_collision_mask_bit", "bit", "value"), &GridMap::set_collision_mask_bit);
 	ClassDB::bind_method(D_METHOD("get_collision_mask_bit", "bit"), &GridMap::get_collision_mask_bit);
 
+	ClassDB::bind_method(D_METHOD("set_collision_merge_shapes", "enable"), &GridMap::set_collision_merge_shapes);
+	ClassDB::bind_method(D_METHOD("get_collision_merge_shapes"), &GridMap::get_collision_merge_shapes);
+
 	ClassDB::bind_method(D_METHOD("set_collision_layer_bit", "bit", "value"), &GridMap::set_collision_layer_bit);
 	ClassDB::bind_method(D_METHOD("get_collision_layer_bit", "bit"), &GridMap::get_collision_layer_bit);
 
@@ -921,6 +1409,7 @@ void GridMap::_bind_methods() {
 	ADD_GROUP("Collision", "collision_");
 	ADD_PROPERTY(PropertyInfo(Variant::INT, "collision_layer", PROPERTY_HINT_LAYERS_3D_PHYSICS), "set_collision_layer", "get_collision_layer");
 	ADD_PROPERTY(PropertyInfo(Variant::INT, "collision_mask", PROPERTY_HINT_LAYERS_3D_PHYSICS), "set_collision_mask", "get_collision_mask");
+	ADD_PROPERTY(PropertyInfo(Variant::BOOL, "collision_merge_shapes"), "set_collision_merge_shapes", "get_collision_merge_shapes");
 
 	BIND_CONSTANT(INVALID_CELL_ITEM);
 }
@@ -958,14 +1447,27 @@ float GridMap::get_cell_scale() const {
 	return cell_scale;
 }
 
+void GridMap::_get_sorted_cell_keys(Vector<IndexKey> &r_keys) const {
+
+	r_keys.resize(cell_map.size());
+	int i = 0;
+	const IndexKey *k = NULL;
+	while ((k = cell_map.next(k))) {
+		r_keys.write[i++] = *k;
+	}
+	r_keys.sort();
+}
+
 Array GridMap::get_used_cells() const {
 
+	Vector<IndexKey> keys;
+	_get_sorted_cell_keys(keys);
+
 	Array a;
-	a.resize(cell_map.size());
-	int i = 0;
-	for (Map<IndexKey, Cell>::Element *E = cell_map.front(); E; E = E->next()) {
-		Vector3 p(E->key().x, E->key().y, E->key().z);
-		a[i++] = p;
+	a.resize(keys.size());
+	for (int i = 0; i < keys.size(); i++) {
+		Vector3 p(keys[i].x, keys[i].y, keys[i].z);
+		a[i] = p;
 	}
 
 	return a;
@@ -979,22 +1481,26 @@ Array GridMap::get_meshes() {
 	Vector3 ofs = _get_offset();
 	Array meshes;
 
-	for (Map<IndexKey, Cell>::Element *E = cell_map.front(); E; E = E->next()) {
+	Vector<IndexKey> keys;
+	_get_sorted_cell_keys(keys);
+
+	for (int i = 0; i < keys.size(); i++) {
 
-		int id = E->get().item;
+		const Cell &c = cell_map[keys[i]];
+		int id = c.item;
 		if (!mesh_library->has_item(id))
 			continue;
 		Ref<Mesh> mesh = mesh_library->get_item_mesh(id);
 		if (mesh.is_null())
 			continue;
 
-		IndexKey ik = E->key();
+		IndexKey ik = keys[i];
 
 		Vector3 cellpos = Vector3(ik.x, ik.y, ik.z);
 
 		Transform xform;
 
-		xform.basis.set_orthogonal_index(E->get().rot);
+		xform.basis.set_orthogonal_index(c.rot);
 
 		xform.set_origin(cellpos * cell_size + ofs);
 		xform.basis.scale(Vector3(cell_scale, cell_scale, cell_scale));
@@ -1031,11 +1537,15 @@ void GridMap::make_baked_meshes(bool p_gen_lightmap_uv, float p_lightmap_uv_texe
 	//generate
 	Map<OctantKey, Map<Ref<Material>, Ref<SurfaceTool> > > surface_map;
 
-	for (Map<IndexKey, Cell>::Element *E = cell_map.front(); E; E = E->next()) {
+	Vector<IndexKey> keys;
+	_get_sorted_cell_keys(keys);
+
+	for (int k = 0; k < keys.size(); k++) {
 
-		IndexKey key = E->key();
+		IndexKey key = keys[k];
+		const Cell &c = cell_map[key];
 
-		int item = E->get().item;
+		int item = c.item;
 		if (!mesh_library->has_item(item))
 			continue;
 
@@ -1048,7 +1558,7 @@ void GridMap::make_baked_meshes(bool p_gen_lightmap_uv, float p_lightmap_uv_texe
 
 		Transform xform;
 
-		xform.basis.set_orthogonal_index(E->get().rot);
+		xform.basis.set_orthogonal_index(c.rot);
 		xform.set_origin(cellpos * cell_size + ofs);
 		xform.basis.scale(Vector3(cell_scale, cell_scale, cell_scale));
 
@@ -1153,6 +1663,15 @@ GridMap::GridMap() {
 	navigation = NULL;
 	set_notify_transform(true);
 	recreating_octants = false;
+
+	collision_merge_shapes = false;
+
+	build_thread = NULL;
+	build_mutex = NULL;
+	build_semaphore = NULL;
+	build_thread_exit = false;
+	build_thread_busy = false;
+	last_build_version = 0;
 }
 
 GridMap::~GridMap() {
@@ -1161,4 +1680,5 @@ GridMap::~GridMap() {
 		mesh_library->unregister_owner(this);
 
 	clear();
+	_stop_build_thread();
 }
@@ -31,8 +31,14 @@
 #ifndef GRID_MAP_H
 #define GRID_MAP_H
 
+#include "core/hash_map.h"
+#include "core/pair.h"
+#include "core/os/mutex.h"
+#include "core/os/semaphore.h"
+#include "core/os/thread.h"
 #include "scene/3d/navigation.h"
 #include "scene/3d/spatial.h"
+#include "scene/resources/concave_polygon_shape.h"
 #include "scene/resources/mesh_library.h"
 #include "scene/resources/multimesh.h"
 
@@ -62,9 +68,18 @@ class GridMap : public Spatial {
 			return key < p_key.key;
 		}
 
+		_FORCE_INLINE_ bool operator==(const IndexKey &p_key) const {
+
+			return key == p_key.key;
+		}
+
 		IndexKey() { key = 0; }
 	};
 
+	struct IndexKeyHasher {
+		static _FORCE_INLINE_ uint32_t hash(const IndexKey &p_key) { return hash_one_uint64(p_key.key); }
+	};
+
 	/**
 	 * @brief A Cell is a single cell in the cube map space; it is defined by its coordinates and the populating Item, identified by int id.
 	 */
@@ -113,8 +128,17 @@ class GridMap : public Spatial {
 		RID collision_debug_instance;
 
 		bool dirty;
+		bool built;
+		uint32_t build_version;
 		RID static_body;
+		Ref<ConcavePolygonShape> merged_shape;
 		Map<IndexKey, NavMesh> navmesh_ids;
+
+		Octant() {
+			dirty = false;
+			built = false;
+			build_version = 0;
+		}
 	};
 
 	union OctantKey {
@@ -133,12 +157,80 @@ class GridMap : public Spatial {
 			return key < p_key.key;
 		}
 
+		_FORCE_INLINE_ bool operator==(const OctantKey &p_key) const {
+
+			return key == p_key.key;
+		}
+
 		//OctantKey(const IndexKey& p_k, int p_item) { indexkey=p_k.key; item=p_item; }
 		OctantKey() { key = 0; }
 	};
 
+	/**
+	 * @brief Everything needed to build an Octant, copied on the main thread so it can be built on a worker.
+	 */
+	struct OctantBuildJob {
+
+		struct ItemData {
+			Ref<Mesh> mesh;
+			Vector<MeshLibrary::ShapeData> shapes;
+			Vector<PoolVector<Vector3> > concave_faces; // per shape, fetched from the physics server beforehand
+			Vector<PoolVector<Vector3> > debug_lines; // per shape, only when debugging collisions
+			Ref<NavigationMesh> navmesh;
+		};
+
+		OctantKey key;
+		uint32_t version;
+		Vector<Pair<IndexKey, Cell> > cells;
+		Map<int, ItemData> items;
+
+		Vector3 cell_size;
+		Vector3 offset;
+		float cell_scale;
+		bool build_multimeshes;
+		bool merge_shapes;
+		bool debug_collision;
+	};
+
+	/**
+	 * @brief The result of building an Octant, swapped in on the main thread.
+	 */
+	struct OctantBuild {
+
+		struct Multimesh {
+			Ref<Mesh> mesh;
+			PoolVector<float> transforms; // as expected by multimesh_set_as_bulk_array
+#ifdef TOOLS_ENABLED
+			Vector<Octant::MultimeshInstance::Item> items;
+#endif
+		};
+
+		struct CellShape {
+			Ref<Shape> shape;
+			Transform xform;
+		};
+
+		struct NavMesh {
+			IndexKey key;
+			Transform xform;
+			Ref<NavigationMesh> navmesh;
+		};
+
+		OctantKey key;
+		uint32_t version;
+		Vector<Multimesh> multimeshes;
+		Vector<CellShape> shapes;
+		PoolVector<Vector3> merged_faces;
+		PoolVector<Vector3> collision_debug;
+		Vector<NavMesh> navmeshes;
+
+		// Built on a worker, the job is kept here so its resources are only released on the main thread.
+		OctantBuildJob job;
+	};
+
 	uint32_t collision_layer;
 	uint32_t collision_mask;
+	bool collision_merge_shapes;
 
 	Transform last_transform;
 
@@ -160,7 +252,24 @@ class GridMap : public Spatial {
 	Ref<MeshLibrary> mesh_library;
 
 	Map<OctantKey, Octant *> octant_map;
-	Map<IndexKey, Cell> cell_map;
+	HashMap<IndexKey, Cell, IndexKeyHasher> cell_map;
+
+	// Octants that were already built are rebuilt on a worker thread, the old data stays visible until the new one is ready.
+	Thread *build_thread;
+	Mutex *build_mutex;
+	Semaphore *build_semaphore;
+	bool build_thread_exit;
+	bool build_thread_busy;
+	uint32_t last_build_version;
+	List<OctantBuildJob> build_jobs;
+	List<OctantBuild *> build_results;
+
+	static void _build_thread_func(void *p_userdata);
+	void _build_thread();
+	void _stop_build_thread();
+	void _process_build_results();
+
+	void _get_sorted_cell_keys(Vector<IndexKey> &r_keys) const;
 
 	void _recreate_octant_data();
 
@@ -181,6 +290,9 @@ class GridMap : public Spatial {
 	void _octant_enter_world(const OctantKey &p_key);
 	void _octant_exit_world(const OctantKey &p_key);
 	bool _octant_update(const OctantKey &p_key);
+	void _octant_make_build_job(const OctantKey &p_key, OctantBuildJob &r_job) const;
+	static void _octant_build(const OctantBuildJob &p_job, OctantBuild &r_build);
+	void _octant_apply_build(const OctantBuild &p_build);
 	void _octant_clean_up(const OctantKey &p_key);
 	void _octant_transform(const OctantKey &p_key);
 	bool awaiting_update;
@@ -227,6 +339,9 @@ public:
 	void set_collision_mask_bit(int p_bit, bool p_value);
 	bool get_collision_mask_bit(int p_bit) const;
 
+	void set_collision_merge_shapes(bool p_enable);
+	bool get_collision_merge_shapes() const;
+
 #ifndef DISABLE_DEPRECATED
 	void set_theme(const Ref<MeshLibrary> &p_theme);
 	Ref<MeshLibrary> get_theme() const;
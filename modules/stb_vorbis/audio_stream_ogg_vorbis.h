@@ -67,6 +67,8 @@ public:
 	virtual bool is_playing() const;
 
 	virtual int get_loop_count() const; //times it looped
+	virtual bool is_looping() const;
+	virtual float get_loop_begin() const;
 
 	virtual float get_playback_position() const;
 	virtual void seek(float p_time);
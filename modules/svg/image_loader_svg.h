@@ -57,7 +57,6 @@ class ImageLoaderSVG : public ImageFormatLoader {
 		List<uint32_t> old_colors;
 		List<uint32_t> new_colors;
 	} replace_colors;
-	static SVGRasterizer rasterizer;
 	static void _convert_colors(NSVGimage *p_svg_image);
 	static Error _create_image(Ref<Image> p_image, const PoolVector<uint8_t> *p_data, float p_scale, bool upsample, bool convert_colors = false);
 
@@ -199,6 +199,45 @@ PoolByteArray HTTPClient::read_response_body_chunk() {
 	return chunk;
 }
 
+Error HTTPClient::read_response_body(uint8_t *p_buffer, int p_max_bytes, int &r_received) {
+
+	r_received = 0;
+	ERR_FAIL_COND_V(status != STATUS_BODY, ERR_UNCONFIGURED);
+	ERR_FAIL_COND_V(p_max_bytes < 0 || (p_max_bytes > 0 && !p_buffer), ERR_INVALID_PARAMETER);
+
+	r_received = MIN(p_max_bytes, polled_response.size() - response_read_offset);
+	if (r_received > 0) {
+		PoolByteArray::Read read = polled_response.read();
+		memcpy(p_buffer, read.ptr() + response_read_offset, r_received);
+	}
+	response_read_offset += r_received;
+
+	if (response_read_offset == polled_response.size()) {
+		status = STATUS_CONNECTED;
+		polled_response.resize(0);
+		godot_xhr_reset(xhr_id);
+	}
+
+	return OK;
+}
+
+bool HTTPClient::is_response_keep_alive() const {
+
+	// Connections are managed by the browser
+	return false;
+}
+
+void HTTPClient::set_pipelining_enabled(bool p_enable) {
+
+	ERR_EXPLAIN("HTTPClient pipelining is not supported for the HTML5 platform");
+	ERR_FAIL_COND(p_enable);
+}
+
+bool HTTPClient::is_pipelining_enabled() const {
+
+	return false;
+}
+
 void HTTPClient::set_blocking_mode(bool p_enable) {
 
 	ERR_EXPLAIN("HTTPClient blocking mode is not supported for the HTML5 platform");
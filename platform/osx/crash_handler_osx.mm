@@ -76,6 +76,9 @@ static void handle_crash(int sig) {
 	String _execpath = OS::get_singleton()->get_executable_path();
 	String msg = GLOBAL_GET("debug/settings/crash_handler/message");
 
+	// Write out what is still queued in the log before the backtrace
+	OS::get_singleton()->flush_log();
+
 	// Dump the backtrace to stderr with a message to the user
 	fprintf(stderr, "%s: Program crashed with signal %d\n", __FUNCTION__, sig);
 
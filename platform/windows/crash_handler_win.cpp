@@ -122,6 +122,9 @@ DWORD CrashHandlerException(EXCEPTION_POINTERS *ep) {
 		return EXCEPTION_CONTINUE_SEARCH;
 	}
 
+	// Write out what is still queued in the log before the backtrace
+	OS::get_singleton()->flush_log();
+
 	fprintf(stderr, "%s: Program crashed\n", __FUNCTION__);
 
 	if (OS::get_singleton()->get_main_loop())
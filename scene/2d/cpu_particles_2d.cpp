@@ -30,9 +30,14 @@
 
 #include "cpu_particles_2d.h"
 
+#include "core/os/threaded_array_processor.h"
 //#include "scene/resources/particles_material.h"
 #include "servers/visual_server.h"
 
+// particles are simulated in chunks of this size, on several threads once there are enough of them
+#define CPU_PARTICLES_CHUNK_SIZE 512
+#define CPU_PARTICLES_PARALLEL_MIN_AMOUNT 8192
+
 void CPUParticles2D::set_emitting(bool p_emitting) {
 
 	emitting = p_emitting;
@@ -511,337 +516,451 @@ static float rand_from_seed_m1_p1(uint32_t &seed) {
 	return rand_from_seed(seed) * 2.0 - 1.0;
 }
 
-void CPUParticles2D::_particles_process(float p_delta) {
+bool CPUParticles2D::_particle_restarts(int p_index, int p_count, float p_prev_time, float &r_local_delta) const {
 
-	p_delta *= speed_scale;
+	float restart_time = (float(p_index) / float(p_count)) * lifetime;
 
-	int pcount = particles.size();
-	PoolVector<Particle>::Write w = particles.write();
+	if (randomness_ratio > 0.0) {
+		uint32_t seed = cycle;
+		if (restart_time >= time) {
+			seed -= uint32_t(1);
+		}
+		seed *= uint32_t(p_count);
+		seed += uint32_t(p_index);
+		float random = float(idhash(seed) % uint32_t(65536)) / 65536.0;
+		restart_time += randomness_ratio * random * 1.0 / float(p_count);
+	}
 
-	Particle *parray = w.ptr();
+	restart_time *= (1.0 - explosiveness_ratio);
+	bool restart = false;
 
-	float prev_time = time;
-	time += p_delta;
-	if (time > lifetime) {
-		time = Math::fmod(time, lifetime);
-		cycle++;
-		if (one_shot && cycle > 0) {
-			emitting = false;
+	if (time > p_prev_time) {
+		// restart_time >= p_prev_time is used so particles emit in the first frame they are processed
+
+		if (restart_time >= p_prev_time && restart_time < time) {
+			restart = true;
+			if (fractional_delta) {
+				r_local_delta = (time - restart_time) * lifetime;
+			}
 		}
-	}
 
-	Transform2D emission_xform;
-	Transform2D velocity_xform;
-	if (!local_coords) {
-		emission_xform = get_global_transform();
-		velocity_xform = emission_xform;
-		emission_xform[2] = Vector2();
+	} else if (r_local_delta > 0.0) {
+		if (restart_time >= p_prev_time) {
+			restart = true;
+			if (fractional_delta) {
+				r_local_delta = (1.0 - restart_time + time) * lifetime;
+			}
+
+		} else if (restart_time < time) {
+			restart = true;
+			if (fractional_delta) {
+				r_local_delta = (time - restart_time) * lifetime;
+			}
+		}
 	}
 
-	for (int i = 0; i < pcount; i++) {
+	return restart;
+}
 
-		Particle &p = parray[i];
+void CPUParticles2D::_particle_emit(Particle &p, const Transform2D &p_emission_xform, const Transform2D &p_velocity_xform) {
 
-		if (!emitting && !p.active)
-			continue;
+	/*float tex_linear_velocity = 0;
+	if (curve_parameters[PARAM_INITIAL_LINEAR_VELOCITY].is_valid()) {
+		tex_linear_velocity = curve_parameters[PARAM_INITIAL_LINEAR_VELOCITY]->interpolate(0);
+	}*/
 
-		float restart_time = (float(i) / float(pcount)) * lifetime;
-		float local_delta = p_delta;
+	float tex_angle = 0.0;
+	if (curve_parameters[PARAM_ANGLE].is_valid()) {
+		tex_angle = curve_parameters[PARAM_ANGLE]->interpolate(0);
+	}
 
-		if (randomness_ratio > 0.0) {
-			uint32_t seed = cycle;
-			if (restart_time >= time) {
-				seed -= uint32_t(1);
-			}
-			seed *= uint32_t(pcount);
-			seed += uint32_t(i);
-			float random = float(idhash(seed) % uint32_t(65536)) / 65536.0;
-			restart_time += randomness_ratio * random * 1.0 / float(pcount);
-		}
+	float tex_anim_offset = 0.0;
+	if (curve_parameters[PARAM_ANGLE].is_valid()) {
+		tex_anim_offset = curve_parameters[PARAM_ANGLE]->interpolate(0);
+	}
 
-		restart_time *= (1.0 - explosiveness_ratio);
-		bool restart = false;
+	p.seed = Math::rand();
 
-		if (time > prev_time) {
-			// restart_time >= prev_time is used so particles emit in the first frame they are processed
+	p.angle_rand = Math::randf();
+	p.scale_rand = Math::randf();
+	p.hue_rot_rand = Math::randf();
+	p.anim_offset_rand = Math::randf();
 
-			if (restart_time >= prev_time && restart_time < time) {
-				restart = true;
-				if (fractional_delta) {
-					local_delta = (time - restart_time) * lifetime;
-				}
-			}
+	float angle1_rad = (Math::randf() * 2.0 - 1.0) * Math_PI * spread / 180.0;
+	Vector2 rot = Vector2(Math::cos(angle1_rad), Math::sin(angle1_rad));
+	p.velocity = rot * parameters[PARAM_INITIAL_LINEAR_VELOCITY] * Math::lerp(1.0f, float(Math::randf()), randomness[PARAM_INITIAL_LINEAR_VELOCITY]);
 
-		} else if (local_delta > 0.0) {
-			if (restart_time >= prev_time) {
-				restart = true;
-				if (fractional_delta) {
-					local_delta = (1.0 - restart_time + time) * lifetime;
-				}
-
-			} else if (restart_time < time) {
-				restart = true;
-				if (fractional_delta) {
-					local_delta = (time - restart_time) * lifetime;
-				}
-			}
-		}
+	float base_angle = (parameters[PARAM_ANGLE] + tex_angle) * Math::lerp(1.0f, p.angle_rand, randomness[PARAM_ANGLE]);
+	p.custom[0] = Math::deg2rad(base_angle); //angle
+	p.custom[1] = 0.0; //phase
+	p.custom[2] = (parameters[PARAM_ANIM_OFFSET] + tex_anim_offset) * Math::lerp(1.0f, p.anim_offset_rand, randomness[PARAM_ANIM_OFFSET]); //animation offset (0-1)
+	p.transform = Transform2D();
+	p.time = 0;
+	p.base_color = Color(1, 1, 1, 1);
 
-		if (restart) {
+	switch (emission_shape) {
+		case EMISSION_SHAPE_POINT: {
+			//do none
+		} break;
+		case EMISSION_SHAPE_CIRCLE: {
+			p.transform[2] = Vector2(Math::randf() * 2.0 - 1.0, Math::randf() * 2.0 - 1.0).normalized() * emission_sphere_radius;
+		} break;
+		case EMISSION_SHAPE_RECTANGLE: {
+			p.transform[2] = Vector2(Math::randf() * 2.0 - 1.0, Math::randf() * 2.0 - 1.0) * emission_rect_extents;
+		} break;
+		case EMISSION_SHAPE_POINTS:
+		case EMISSION_SHAPE_DIRECTED_POINTS: {
 
-			if (!emitting) {
-				p.active = false;
-				continue;
-			}
-			p.active = true;
+			int pc = emission_points.size();
+			if (pc == 0)
+				break;
 
-			/*float tex_linear_velocity = 0;
-			if (curve_parameters[PARAM_INITIAL_LINEAR_VELOCITY].is_valid()) {
-				tex_linear_velocity = curve_parameters[PARAM_INITIAL_LINEAR_VELOCITY]->interpolate(0);
-			}*/
+			int random_idx = Math::rand() % pc;
 
-			float tex_angle = 0.0;
-			if (curve_parameters[PARAM_ANGLE].is_valid()) {
-				tex_angle = curve_parameters[PARAM_ANGLE]->interpolate(0);
-			}
+			p.transform[2] = emission_points.get(random_idx);
 
-			float tex_anim_offset = 0.0;
-			if (curve_parameters[PARAM_ANGLE].is_valid()) {
-				tex_anim_offset = curve_parameters[PARAM_ANGLE]->interpolate(0);
+			if (emission_shape == EMISSION_SHAPE_DIRECTED_POINTS && emission_normals.size() == pc) {
+				p.velocity = emission_normals.get(random_idx);
 			}
 
-			p.seed = Math::rand();
-
-			p.angle_rand = Math::randf();
-			p.scale_rand = Math::randf();
-			p.hue_rot_rand = Math::randf();
-			p.anim_offset_rand = Math::randf();
-
-			float angle1_rad = (Math::randf() * 2.0 - 1.0) * Math_PI * spread / 180.0;
-			Vector2 rot = Vector2(Math::cos(angle1_rad), Math::sin(angle1_rad));
-			p.velocity = rot * parameters[PARAM_INITIAL_LINEAR_VELOCITY] * Math::lerp(1.0f, float(Math::randf()), randomness[PARAM_INITIAL_LINEAR_VELOCITY]);
-
-			float base_angle = (parameters[PARAM_ANGLE] + tex_angle) * Math::lerp(1.0f, p.angle_rand, randomness[PARAM_ANGLE]);
-			p.custom[0] = Math::deg2rad(base_angle); //angle
-			p.custom[1] = 0.0; //phase
-			p.custom[2] = (parameters[PARAM_ANIM_OFFSET] + tex_anim_offset) * Math::lerp(1.0f, p.anim_offset_rand, randomness[PARAM_ANIM_OFFSET]); //animation offset (0-1)
-			p.transform = Transform2D();
-			p.time = 0;
-			p.base_color = Color(1, 1, 1, 1);
-
-			switch (emission_shape) {
-				case EMISSION_SHAPE_POINT: {
-					//do none
-				} break;
-				case EMISSION_SHAPE_CIRCLE: {
-					p.transform[2] = Vector2(Math::randf() * 2.0 - 1.0, Math::randf() * 2.0 - 1.0).normalized() * emission_sphere_radius;
-				} break;
-				case EMISSION_SHAPE_RECTANGLE: {
-					p.transform[2] = Vector2(Math::randf() * 2.0 - 1.0, Math::randf() * 2.0 - 1.0) * emission_rect_extents;
-				} break;
-				case EMISSION_SHAPE_POINTS:
-				case EMISSION_SHAPE_DIRECTED_POINTS: {
-
-					int pc = emission_points.size();
-					if (pc == 0)
-						break;
-
-					int random_idx = Math::rand() % pc;
-
-					p.transform[2] = emission_points.get(random_idx);
-
-					if (emission_shape == EMISSION_SHAPE_DIRECTED_POINTS && emission_normals.size() == pc) {
-						p.velocity = emission_normals.get(random_idx);
-					}
-
-					if (emission_colors.size() == pc) {
-						p.base_color = emission_colors.get(random_idx);
-					}
-				} break;
+			if (emission_colors.size() == pc) {
+				p.base_color = emission_colors.get(random_idx);
 			}
+		} break;
+	}
 
-			if (!local_coords) {
-				p.velocity = velocity_xform.xform(p.velocity);
-				p.transform = emission_xform * p.transform;
-			}
+	if (!local_coords) {
+		p.velocity = p_velocity_xform.xform(p.velocity);
+		p.transform = p_emission_xform * p.transform;
+	}
+}
 
-		} else if (!p.active) {
-			continue;
-		} else {
+void CPUParticles2D::_particle_update(Particle &p, int p_index, const ProcessData &p_data) {
 
-			uint32_t alt_seed = p.seed;
+	float local_delta = p_data.delta;
+	bool restart = _particle_restarts(p_index, p_data.count, p_data.prev_time, local_delta);
 
-			p.time += local_delta;
-			p.custom[1] = p.time / lifetime;
+	if (!p.active)
+		return; // inactive, or stopped by the emission pass
 
-			float tex_linear_velocity = 0.0;
-			if (curve_parameters[PARAM_INITIAL_LINEAR_VELOCITY].is_valid()) {
-				tex_linear_velocity = curve_parameters[PARAM_INITIAL_LINEAR_VELOCITY]->interpolate(p.custom[1]);
-			}
-			/*
-			float tex_orbit_velocity = 0.0;
+	const Transform2D &emission_xform = p_data.emission_xform;
+
+	if (!restart) {
+
+		uint32_t alt_seed = p.seed;
+
+		p.time += local_delta;
+		p.custom[1] = p.time / lifetime;
+
+		float tex_linear_velocity = 0.0;
+		if (curve_parameters[PARAM_INITIAL_LINEAR_VELOCITY].is_valid()) {
+			tex_linear_velocity = curve_parameters[PARAM_INITIAL_LINEAR_VELOCITY]->interpolate(p.custom[1]);
+		}
+		/*
+		float tex_orbit_velocity = 0.0;
 
-			if (flags[FLAG_DISABLE_Z]) {
+		if (flags[FLAG_DISABLE_Z]) {
 
-				if (curve_parameters[PARAM_INITIAL_ORBIT_VELOCITY].is_valid()) {
-					tex_orbit_velocity = curve_parameters[PARAM_INITIAL_ORBIT_VELOCITY]->interpolate(p.custom[1]);
-				}
+			if (curve_parameters[PARAM_INITIAL_ORBIT_VELOCITY].is_valid()) {
+				tex_orbit_velocity = curve_parameters[PARAM_INITIAL_ORBIT_VELOCITY]->interpolate(p.custom[1]);
 			}
+		}
 */
-			float tex_angular_velocity = 0.0;
-			if (curve_parameters[PARAM_ANGULAR_VELOCITY].is_valid()) {
-				tex_angular_velocity = curve_parameters[PARAM_ANGULAR_VELOCITY]->interpolate(p.custom[1]);
-			}
+		float tex_angular_velocity = 0.0;
+		if (curve_parameters[PARAM_ANGULAR_VELOCITY].is_valid()) {
+			tex_angular_velocity = curve_parameters[PARAM_ANGULAR_VELOCITY]->interpolate(p.custom[1]);
+		}
 
-			float tex_linear_accel = 0.0;
-			if (curve_parameters[PARAM_LINEAR_ACCEL].is_valid()) {
-				tex_linear_accel = curve_parameters[PARAM_LINEAR_ACCEL]->interpolate(p.custom[1]);
-			}
+		float tex_linear_accel = 0.0;
+		if (curve_parameters[PARAM_LINEAR_ACCEL].is_valid()) {
+			tex_linear_accel = curve_parameters[PARAM_LINEAR_ACCEL]->interpolate(p.custom[1]);
+		}
 
-			float tex_tangential_accel = 0.0;
-			if (curve_parameters[PARAM_TANGENTIAL_ACCEL].is_valid()) {
-				tex_tangential_accel = curve_parameters[PARAM_TANGENTIAL_ACCEL]->interpolate(p.custom[1]);
-			}
+		float tex_tangential_accel = 0.0;
+		if (curve_parameters[PARAM_TANGENTIAL_ACCEL].is_valid()) {
+			tex_tangential_accel = curve_parameters[PARAM_TANGENTIAL_ACCEL]->interpolate(p.custom[1]);
+		}
 
-			float tex_radial_accel = 0.0;
-			if (curve_parameters[PARAM_RADIAL_ACCEL].is_valid()) {
-				tex_radial_accel = curve_parameters[PARAM_RADIAL_ACCEL]->interpolate(p.custom[1]);
-			}
+		float tex_radial_accel = 0.0;
+		if (curve_parameters[PARAM_RADIAL_ACCEL].is_valid()) {
+			tex_radial_accel = curve_parameters[PARAM_RADIAL_ACCEL]->interpolate(p.custom[1]);
+		}
 
-			float tex_damping = 0.0;
-			if (curve_parameters[PARAM_DAMPING].is_valid()) {
-				tex_damping = curve_parameters[PARAM_DAMPING]->interpolate(p.custom[1]);
-			}
+		float tex_damping = 0.0;
+		if (curve_parameters[PARAM_DAMPING].is_valid()) {
+			tex_damping = curve_parameters[PARAM_DAMPING]->interpolate(p.custom[1]);
+		}
 
-			float tex_angle = 0.0;
-			if (curve_parameters[PARAM_ANGLE].is_valid()) {
-				tex_angle = curve_parameters[PARAM_ANGLE]->interpolate(p.custom[1]);
-			}
-			float tex_anim_speed = 0.0;
-			if (curve_parameters[PARAM_ANIM_SPEED].is_valid()) {
-				tex_anim_speed = curve_parameters[PARAM_ANIM_SPEED]->interpolate(p.custom[1]);
-			}
+		float tex_angle = 0.0;
+		if (curve_parameters[PARAM_ANGLE].is_valid()) {
+			tex_angle = curve_parameters[PARAM_ANGLE]->interpolate(p.custom[1]);
+		}
+		float tex_anim_speed = 0.0;
+		if (curve_parameters[PARAM_ANIM_SPEED].is_valid()) {
+			tex_anim_speed = curve_parameters[PARAM_ANIM_SPEED]->interpolate(p.custom[1]);
+		}
 
-			float tex_anim_offset = 0.0;
-			if (curve_parameters[PARAM_ANIM_OFFSET].is_valid()) {
-				tex_anim_offset = curve_parameters[PARAM_ANIM_OFFSET]->interpolate(p.custom[1]);
-			}
+		float tex_anim_offset = 0.0;
+		if (curve_parameters[PARAM_ANIM_OFFSET].is_valid()) {
+			tex_anim_offset = curve_parameters[PARAM_ANIM_OFFSET]->interpolate(p.custom[1]);
+		}
 
-			Vector2 force = gravity;
-			Vector2 pos = p.transform[2];
-
-			//apply linear acceleration
-			force += p.velocity.length() > 0.0 ? p.velocity.normalized() * (parameters[PARAM_LINEAR_ACCEL] + tex_linear_accel) * Math::lerp(1.0f, rand_from_seed(alt_seed), randomness[PARAM_LINEAR_ACCEL]) : Vector2();
-			//apply radial acceleration
-			Vector2 org = emission_xform[2];
-			Vector2 diff = pos - org;
-			force += diff.length() > 0.0 ? diff.normalized() * (parameters[PARAM_RADIAL_ACCEL] + tex_radial_accel) * Math::lerp(1.0f, rand_from_seed(alt_seed), randomness[PARAM_RADIAL_ACCEL]) : Vector2();
-			//apply tangential acceleration;
-			Vector2 yx = Vector2(diff.y, diff.x);
-			force += yx.length() > 0.0 ? (yx * Vector2(-1.0, 1.0)) * ((parameters[PARAM_TANGENTIAL_ACCEL] + tex_tangential_accel) * Math::lerp(1.0f, rand_from_seed(alt_seed), randomness[PARAM_TANGENTIAL_ACCEL])) : Vector2();
-			//apply attractor forces
-			p.velocity += force * local_delta;
-			//orbit velocity
+		Vector2 force = gravity;
+		Vector2 pos = p.transform[2];
+
+		//apply linear acceleration
+		force += p.velocity.length() > 0.0 ? p.velocity.normalized() * (parameters[PARAM_LINEAR_ACCEL] + tex_linear_accel) * Math::lerp(1.0f, rand_from_seed(alt_seed), randomness[PARAM_LINEAR_ACCEL]) : Vector2();
+		//apply radial acceleration
+		Vector2 org = emission_xform[2];
+		Vector2 diff = pos - org;
+		force += diff.length() > 0.0 ? diff.normalized() * (parameters[PARAM_RADIAL_ACCEL] + tex_radial_accel) * Math::lerp(1.0f, rand_from_seed(alt_seed), randomness[PARAM_RADIAL_ACCEL]) : Vector2();
+		//apply tangential acceleration;
+		Vector2 yx = Vector2(diff.y, diff.x);
+		force += yx.length() > 0.0 ? (yx * Vector2(-1.0, 1.0)) * ((parameters[PARAM_TANGENTIAL_ACCEL] + tex_tangential_accel) * Math::lerp(1.0f, rand_from_seed(alt_seed), randomness[PARAM_TANGENTIAL_ACCEL])) : Vector2();
+		//apply attractor forces
+		p.velocity += force * local_delta;
+		//orbit velocity
 #if 0
-			if (flags[FLAG_DISABLE_Z]) {
-
-				float orbit_amount = (orbit_velocity + tex_orbit_velocity) * mix(1.0, rand_from_seed(alt_seed), orbit_velocity_random);
-				if (orbit_amount != 0.0) {
-					float ang = orbit_amount * DELTA * pi * 2.0;
-					mat2 rot = mat2(vec2(cos(ang), -sin(ang)), vec2(sin(ang), cos(ang)));
-					TRANSFORM[3].xy -= diff.xy;
-					TRANSFORM[3].xy += rot * diff.xy;
-				}
+		if (flags[FLAG_DISABLE_Z]) {
+
+			float orbit_amount = (orbit_velocity + tex_orbit_velocity) * mix(1.0, rand_from_seed(alt_seed), orbit_velocity_random);
+			if (orbit_amount != 0.0) {
+				float ang = orbit_amount * DELTA * pi * 2.0;
+				mat2 rot = mat2(vec2(cos(ang), -sin(ang)), vec2(sin(ang), cos(ang)));
+				TRANSFORM[3].xy -= diff.xy;
+				TRANSFORM[3].xy += rot * diff.xy;
 			}
+		}
 #endif
-			if (curve_parameters[PARAM_INITIAL_LINEAR_VELOCITY].is_valid()) {
-				p.velocity = p.velocity.normalized() * tex_linear_velocity;
-			}
-
-			if (parameters[PARAM_DAMPING] + tex_damping > 0.0) {
+		if (curve_parameters[PARAM_INITIAL_LINEAR_VELOCITY].is_valid()) {
+			p.velocity = p.velocity.normalized() * tex_linear_velocity;
+		}
 
-				float v = p.velocity.length();
-				float damp = (parameters[PARAM_DAMPING] + tex_damping) * Math::lerp(1.0f, rand_from_seed(alt_seed), randomness[PARAM_DAMPING]);
-				v -= damp * local_delta;
-				if (v < 0.0) {
-					p.velocity = Vector2();
-				} else {
-					p.velocity = p.velocity.normalized() * v;
-				}
-			}
-			float base_angle = (parameters[PARAM_ANGLE] + tex_angle) * Math::lerp(1.0f, p.angle_rand, randomness[PARAM_ANGLE]);
-			base_angle += p.custom[1] * lifetime * (parameters[PARAM_ANGULAR_VELOCITY] + tex_angular_velocity) * Math::lerp(1.0f, rand_from_seed(alt_seed) * 2.0f - 1.0f, randomness[PARAM_ANGULAR_VELOCITY]);
-			p.custom[0] = Math::deg2rad(base_angle); //angle
-			p.custom[2] = (parameters[PARAM_ANIM_OFFSET] + tex_anim_offset) * Math::lerp(1.0f, p.anim_offset_rand, randomness[PARAM_ANIM_OFFSET]) + p.custom[1] * (parameters[PARAM_ANIM_SPEED] + tex_anim_speed) * Math::lerp(1.0f, rand_from_seed(alt_seed), randomness[PARAM_ANIM_SPEED]); //angle
-			if (flags[FLAG_ANIM_LOOP]) {
-				p.custom[2] = Math::fmod(p.custom[2], 1.0f); //loop
+		if (parameters[PARAM_DAMPING] + tex_damping > 0.0) {
 
+			float v = p.velocity.length();
+			float damp = (parameters[PARAM_DAMPING] + tex_damping) * Math::lerp(1.0f, rand_from_seed(alt_seed), randomness[PARAM_DAMPING]);
+			v -= damp * local_delta;
+			if (v < 0.0) {
+				p.velocity = Vector2();
 			} else {
-				p.custom[2] = CLAMP(p.custom[2], 0.0f, 1.0); //0 to 1 only
+				p.velocity = p.velocity.normalized() * v;
 			}
 		}
-		//apply color
-		//apply hue rotation
+		float base_angle = (parameters[PARAM_ANGLE] + tex_angle) * Math::lerp(1.0f, p.angle_rand, randomness[PARAM_ANGLE]);
+		base_angle += p.custom[1] * lifetime * (parameters[PARAM_ANGULAR_VELOCITY] + tex_angular_velocity) * Math::lerp(1.0f, rand_from_seed(alt_seed) * 2.0f - 1.0f, randomness[PARAM_ANGULAR_VELOCITY]);
+		p.custom[0] = Math::deg2rad(base_angle); //angle
+		p.custom[2] = (parameters[PARAM_ANIM_OFFSET] + tex_anim_offset) * Math::lerp(1.0f, p.anim_offset_rand, randomness[PARAM_ANIM_OFFSET]) + p.custom[1] * (parameters[PARAM_ANIM_SPEED] + tex_anim_speed) * Math::lerp(1.0f, rand_from_seed(alt_seed), randomness[PARAM_ANIM_SPEED]); //angle
+		if (flags[FLAG_ANIM_LOOP]) {
+			p.custom[2] = Math::fmod(p.custom[2], 1.0f); //loop
 
-		float tex_scale = 1.0;
-		if (curve_parameters[PARAM_SCALE].is_valid()) {
-			tex_scale = curve_parameters[PARAM_SCALE]->interpolate(p.custom[1]);
+		} else {
+			p.custom[2] = CLAMP(p.custom[2], 0.0f, 1.0); //0 to 1 only
 		}
+	}
+	//apply color
+	//apply hue rotation
+
+	float tex_scale = 1.0;
+	if (curve_parameters[PARAM_SCALE].is_valid()) {
+		tex_scale = curve_parameters[PARAM_SCALE]->interpolate(p.custom[1]);
+	}
+
+	float tex_hue_variation = 0.0;
+	if (curve_parameters[PARAM_HUE_VARIATION].is_valid()) {
+		tex_hue_variation = curve_parameters[PARAM_HUE_VARIATION]->interpolate(p.custom[1]);
+	}
+
+	float hue_rot_angle = (parameters[PARAM_HUE_VARIATION] + tex_hue_variation) * Math_PI * 2.0 * Math::lerp(1.0f, p.hue_rot_rand * 2.0f - 1.0f, randomness[PARAM_HUE_VARIATION]);
+	float hue_rot_c = Math::cos(hue_rot_angle);
+	float hue_rot_s = Math::sin(hue_rot_angle);
+
+	Basis hue_rot_mat;
+	{
+		Basis mat1(0.299, 0.587, 0.114, 0.299, 0.587, 0.114, 0.299, 0.587, 0.114);
+		Basis mat2(0.701, -0.587, -0.114, -0.299, 0.413, -0.114, -0.300, -0.588, 0.886);
+		Basis mat3(0.168, 0.330, -0.497, -0.328, 0.035, 0.292, 1.250, -1.050, -0.203);
+
+		for (int j = 0; j < 3; j++) {
+			hue_rot_mat[j] = mat1[j] + mat2[j] * hue_rot_c + mat3[j] * hue_rot_s;
+		}
+	}
 
-		float tex_hue_variation = 0.0;
-		if (curve_parameters[PARAM_HUE_VARIATION].is_valid()) {
-			tex_hue_variation = curve_parameters[PARAM_HUE_VARIATION]->interpolate(p.custom[1]);
+	if (color_ramp.is_valid()) {
+		p.color = color_ramp->get_color_at_offset(p.custom[1]) * color;
+	} else {
+		p.color = color;
+	}
+
+	Vector3 color_rgb = hue_rot_mat.xform_inv(Vector3(p.color.r, p.color.g, p.color.b));
+	p.color.r = color_rgb.x;
+	p.color.g = color_rgb.y;
+	p.color.b = color_rgb.z;
+
+	p.color *= p.base_color;
+
+	if (flags[FLAG_ALIGN_Y_TO_VELOCITY]) {
+		if (p.velocity.length() > 0.0) {
+
+			p.transform.elements[0] = p.velocity.normalized();
+			p.transform.elements[0] = p.transform.elements[1].tangent();
 		}
 
-		float hue_rot_angle = (parameters[PARAM_HUE_VARIATION] + tex_hue_variation) * Math_PI * 2.0 * Math::lerp(1.0f, p.hue_rot_rand * 2.0f - 1.0f, randomness[PARAM_HUE_VARIATION]);
-		float hue_rot_c = Math::cos(hue_rot_angle);
-		float hue_rot_s = Math::sin(hue_rot_angle);
+	} else {
+		p.transform.elements[0] = Vector2(Math::cos(p.custom[0]), -Math::sin(p.custom[0]));
+		p.transform.elements[1] = Vector2(Math::sin(p.custom[0]), Math::cos(p.custom[0]));
+	}
 
-		Basis hue_rot_mat;
-		{
-			Basis mat1(0.299, 0.587, 0.114, 0.299, 0.587, 0.114, 0.299, 0.587, 0.114);
-			Basis mat2(0.701, -0.587, -0.114, -0.299, 0.413, -0.114, -0.300, -0.588, 0.886);
-			Basis mat3(0.168, 0.330, -0.497, -0.328, 0.035, 0.292, 1.250, -1.050, -0.203);
+	//scale by scale
+	float base_scale = Math::lerp(parameters[PARAM_SCALE] * tex_scale, 1.0f, p.scale_rand * randomness[PARAM_SCALE]);
+	if (base_scale == 0.0) base_scale = 0.000001;
 
-			for (int j = 0; j < 3; j++) {
-				hue_rot_mat[j] = mat1[j] + mat2[j] * hue_rot_c + mat3[j] * hue_rot_s;
-			}
+	p.transform.elements[0] *= base_scale;
+	p.transform.elements[1] *= base_scale;
+
+	p.transform[2] += p.velocity * local_delta;
+}
+
+void CPUParticles2D::_particles_process_chunk(uint32_t p_chunk, ProcessData *p_data) {
+
+	int from = p_chunk * CPU_PARTICLES_CHUNK_SIZE;
+	int to = MIN(from + CPU_PARTICLES_CHUNK_SIZE, p_data->count);
+
+	for (int i = from; i < to; i++) {
+
+		Particle &p = p_data->particles[i];
+		_particle_update(p, i, *p_data);
+
+		if (p_data->buffer) {
+			_write_particle_data(p, p_data->un_transform, &p_data->buffer[i * 13]);
 		}
+	}
+}
 
-		if (color_ramp.is_valid()) {
-			p.color = color_ramp->get_color_at_offset(p.custom[1]) * color;
-		} else {
-			p.color = color;
+void CPUParticles2D::_particles_process(float p_delta, bool p_update_buffer) {
+
+	p_delta *= speed_scale;
+
+	int pcount = particles.size();
+	PoolVector<Particle>::Write w = particles.write();
+
+	Particle *parray = w.ptr();
+
+	float prev_time = time;
+	time += p_delta;
+	if (time > lifetime) {
+		time = Math::fmod(time, lifetime);
+		cycle++;
+		if (one_shot && cycle > 0) {
+			emitting = false;
 		}
+	}
 
-		Vector3 color_rgb = hue_rot_mat.xform_inv(Vector3(p.color.r, p.color.g, p.color.b));
-		p.color.r = color_rgb.x;
-		p.color.g = color_rgb.y;
-		p.color.b = color_rgb.z;
+	Transform2D emission_xform;
+	Transform2D velocity_xform;
+	if (!local_coords) {
+		emission_xform = get_global_transform();
+		velocity_xform = emission_xform;
+		emission_xform[2] = Vector2();
+	}
 
-		p.color *= p.base_color;
+	ProcessData data;
+	data.particles = parray;
+	data.count = pcount;
+	data.delta = p_delta;
+	data.prev_time = prev_time;
+	data.emission_xform = emission_xform;
+	data.buffer = NULL;
 
-		if (flags[FLAG_ALIGN_Y_TO_VELOCITY]) {
-			if (p.velocity.length() > 0.0) {
+	// emitting draws from the global random generator, so it stays on this thread and in order
+	for (int i = 0; i < pcount; i++) {
 
-				p.transform.elements[0] = p.velocity.normalized();
-				p.transform.elements[0] = p.transform.elements[1].tangent();
-			}
+		Particle &p = parray[i];
 
-		} else {
-			p.transform.elements[0] = Vector2(Math::cos(p.custom[0]), -Math::sin(p.custom[0]));
-			p.transform.elements[1] = Vector2(Math::sin(p.custom[0]), Math::cos(p.custom[0]));
+		if (!emitting && !p.active)
+			continue;
+
+		float local_delta = p_delta;
+		if (!_particle_restarts(i, pcount, prev_time, local_delta))
+			continue;
+
+		if (!emitting) {
+			p.active = false;
+			continue;
 		}
+		p.active = true;
+
+		_particle_emit(p, emission_xform, velocity_xform);
+	}
+
+	if (color_ramp.is_valid()) {
+		color_ramp->get_color_at_offset(0.0); // sorts the ramp before it is read from several threads
+	}
+
+	// with index draw order, instances are written straight into the multimesh data
+	PoolVector<float>::Write buffer_write;
+	if (p_update_buffer) {
+#ifndef NO_THREADS
+		update_mutex->lock();
+#endif
+		buffer_write = particle_data.write();
+		data.buffer = buffer_write.ptr();
+		if (!local_coords) {
+			data.un_transform = get_global_transform().affine_inverse();
+		}
+	}
+
+	int chunk_count = (pcount + CPU_PARTICLES_CHUNK_SIZE - 1) / CPU_PARTICLES_CHUNK_SIZE;
+	if (pcount >= CPU_PARTICLES_PARALLEL_MIN_AMOUNT) {
+		thread_process_array(chunk_count, this, &CPUParticles2D::_particles_process_chunk, &data);
+	} else {
+		for (int i = 0; i < chunk_count; i++) {
+			_particles_process_chunk(i, &data);
+		}
+	}
+
+	if (p_update_buffer) {
+		buffer_write = PoolVector<float>::Write();
+#ifndef NO_THREADS
+		update_mutex->unlock();
+#endif
+	}
+}
+
+void CPUParticles2D::_write_particle_data(const Particle &p, const Transform2D &p_un_transform, float *ptr) const {
+
+	Transform2D t = p.transform;
+
+	if (!local_coords) {
+		t = p_un_transform * t;
+	}
 
-		//scale by scale
-		float base_scale = Math::lerp(parameters[PARAM_SCALE] * tex_scale, 1.0f, p.scale_rand * randomness[PARAM_SCALE]);
-		if (base_scale == 0.0) base_scale = 0.000001;
+	if (p.active) {
 
-		p.transform.elements[0] *= base_scale;
-		p.transform.elements[1] *= base_scale;
+		ptr[0] = t.elements[0][0];
+		ptr[1] = t.elements[1][0];
+		ptr[2] = 0;
+		ptr[3] = t.elements[2][0];
+		ptr[4] = t.elements[0][1];
+		ptr[5] = t.elements[1][1];
+		ptr[6] = 0;
+		ptr[7] = t.elements[2][1];
 
-		p.transform[2] += p.velocity * local_delta;
+	} else {
+		zeromem(ptr, sizeof(float) * 8);
 	}
+
+	Color c = p.color;
+	uint8_t *data8 = (uint8_t *)&ptr[8];
+	data8[0] = CLAMP(c.r * 255.0, 0, 255);
+	data8[1] = CLAMP(c.g * 255.0, 0, 255);
+	data8[2] = CLAMP(c.b * 255.0, 0, 255);
+	data8[3] = CLAMP(c.a * 255.0, 0, 255);
+
+	ptr[9] = p.custom[0];
+	ptr[10] = p.custom[1];
+	ptr[11] = p.custom[2];
+	ptr[12] = p.custom[3];
 }
 
 void CPUParticles2D::_update_particle_data_buffer() {
@@ -882,40 +1001,7 @@ void CPUParticles2D::_update_particle_data_buffer() {
 		for (int i = 0; i < pc; i++) {
 
 			int idx = order ? order[i] : i;
-
-			Transform2D t = r[idx].transform;
-
-			if (!local_coords) {
-				t = un_transform * t;
-			}
-
-			if (r[idx].active) {
-
-				ptr[0] = t.elements[0][0];
-				ptr[1] = t.elements[1][0];
-				ptr[2] = 0;
-				ptr[3] = t.elements[2][0];
-				ptr[4] = t.elements[0][1];
-				ptr[5] = t.elements[1][1];
-				ptr[6] = 0;
-				ptr[7] = t.elements[2][1];
-
-			} else {
-				zeromem(ptr, sizeof(float) * 8);
-			}
-
-			Color c = r[idx].color;
-			uint8_t *data8 = (uint8_t *)&ptr[8];
-			data8[0] = CLAMP(c.r * 255.0, 0, 255);
-			data8[1] = CLAMP(c.g * 255.0, 0, 255);
-			data8[2] = CLAMP(c.b * 255.0, 0, 255);
-			data8[3] = CLAMP(c.a * 255.0, 0, 255);
-
-			ptr[9] = r[idx].custom[0];
-			ptr[10] = r[idx].custom[1];
-			ptr[11] = r[idx].custom[2];
-			ptr[12] = r[idx].custom[3];
-
+			_write_particle_data(r[idx], un_transform, ptr);
 			ptr += 13;
 		}
 	}
@@ -1029,11 +1115,15 @@ void CPUParticles2D::_notification(int p_what) {
 			float todo = pre_process_time;
 
 			while (todo >= 0) {
-				_particles_process(frame_time);
+				_particles_process(frame_time, false);
 				todo -= frame_time;
 			}
 		}
 
+		// with index draw order the last simulation step writes the multimesh data itself
+		bool direct_buffer = draw_order == DRAW_ORDER_INDEX;
+		bool buffer_updated = false;
+
 		if (fixed_fps > 0) {
 			float frame_time = 1.0 / fixed_fps;
 			float decr = frame_time;
@@ -1047,17 +1137,21 @@ void CPUParticles2D::_notification(int p_what) {
 			float todo = frame_remainder + ldelta;
 
 			while (todo >= frame_time) {
-				_particles_process(frame_time);
 				todo -= decr;
+				buffer_updated = direct_buffer && todo < frame_time;
+				_particles_process(frame_time, buffer_updated);
 			}
 
 			frame_remainder = todo;
 
 		} else {
-			_particles_process(delta);
+			_particles_process(delta, direct_buffer);
+			buffer_updated = direct_buffer;
 		}
 
-		_update_particle_data_buffer();
+		if (!buffer_updated) {
+			_update_particle_data_buffer();
+		}
 	}
 }
 
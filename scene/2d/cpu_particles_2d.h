@@ -99,6 +99,16 @@ private:
 		uint32_t seed;
 	};
 
+	struct ProcessData {
+		Particle *particles;
+		int count;
+		float delta;
+		float prev_time;
+		Transform2D emission_xform;
+		Transform2D un_transform;
+		float *buffer;
+	};
+
 	float time;
 	float inactive_time;
 	float frame_remainder;
@@ -171,7 +181,12 @@ private:
 	bool anim_loop;
 	Vector2 gravity;
 
-	void _particles_process(float p_delta);
+	bool _particle_restarts(int p_index, int p_count, float p_prev_time, float &r_local_delta) const;
+	void _particle_emit(Particle &p, const Transform2D &p_emission_xform, const Transform2D &p_velocity_xform);
+	void _particle_update(Particle &p, int p_index, const ProcessData &p_data);
+	void _particles_process_chunk(uint32_t p_chunk, ProcessData *p_data);
+	void _particles_process(float p_delta, bool p_update_buffer);
+	void _write_particle_data(const Particle &p, const Transform2D &p_un_transform, float *ptr) const;
 	void _update_particle_data_buffer();
 
 	Mutex *update_mutex;
@@ -282,17 +282,33 @@ void TileMap::update_dirty_quadrants() {
 
 		Quadrant &q = *dirty_quadrant_list.first()->self();
 
-		for (List<RID>::Element *E = q.canvas_items.front(); E; E = E->next()) {
+		uint32_t dirty = q.dirty;
+		// debug shapes and navigation polygons are drawn on the quadrant canvas items
+		if (debug_shapes && (dirty & (DIRTY_VISUAL | DIRTY_PHYSICS)))
+			dirty |= DIRTY_VISUAL | DIRTY_PHYSICS;
+		if (debug_navigation && (dirty & (DIRTY_VISUAL | DIRTY_NAVIGATION)))
+			dirty |= DIRTY_VISUAL | DIRTY_NAVIGATION;
+
+		bool rebuild_visual = dirty & DIRTY_VISUAL;
+		bool rebuild_physics = dirty & DIRTY_PHYSICS;
+		bool rebuild_navigation = navigation && (dirty & DIRTY_NAVIGATION);
+		bool rebuild_occluders = dirty & DIRTY_OCCLUDERS;
+
+		if (rebuild_visual) {
+			for (List<RID>::Element *E = q.canvas_items.front(); E; E = E->next()) {
 
-			vs->free(E->get());
-		}
+				vs->free(E->get());
+			}
 
-		q.canvas_items.clear();
+			q.canvas_items.clear();
+		}
 
-		ps->body_clear_shapes(q.body);
+		if (rebuild_physics) {
+			ps->body_clear_shapes(q.body);
+		}
 		int shape_idx = 0;
 
-		if (navigation) {
+		if (rebuild_navigation) {
 			for (Map<PosKey, Quadrant::NavPoly>::Element *E = q.navpoly_ids.front(); E; E = E->next()) {
 
 				navigation->navpoly_remove(E->get().id);
@@ -300,294 +316,317 @@ void TileMap::update_dirty_quadrants() {
 			q.navpoly_ids.clear();
 		}
 
-		for (Map<PosKey, Quadrant::Occluder>::Element *E = q.occluder_instances.front(); E; E = E->next()) {
-			VS::get_singleton()->free(E->get().id);
+		if (rebuild_occluders) {
+			for (Map<PosKey, Quadrant::Occluder>::Element *E = q.occluder_instances.front(); E; E = E->next()) {
+				VS::get_singleton()->free(E->get().id);
+			}
+			q.occluder_instances.clear();
 		}
-		q.occluder_instances.clear();
+
 		Ref<ShaderMaterial> prev_material;
 		int prev_z_index;
 		RID prev_canvas_item;
 		RID prev_debug_canvas_item;
 
-		for (int i = 0; i < q.cells.size(); i++) {
+		int from_x, to_x, from_y, to_y;
+		_get_quadrant_cell_range(q.key.x, from_x, to_x);
+		_get_quadrant_cell_range(q.key.y, from_y, to_y);
 
-			Map<PosKey, Cell>::Element *E = tile_map.find(q.cells[i]);
-			Cell &c = E->get();
-			//moment of truth
-			if (!tile_set->has_tile(c.id))
-				continue;
-			Ref<Texture> tex = tile_set->tile_get_texture(c.id);
-			Vector2 tile_ofs = tile_set->tile_get_texture_offset(c.id);
+		for (int cell_y = from_y; cell_y <= to_y; cell_y++) {
+			for (int cell_x = from_x; cell_x <= to_x; cell_x++) {
 
-			Vector2 wofs = _map_to_world(E->key().x, E->key().y);
-			Vector2 offset = wofs - q.pos + tofs;
+				const Cell *cell = _find_cell(cell_x, cell_y);
+				if (!cell)
+					continue;
 
-			if (!tex.is_valid())
-				continue;
+				const Cell &c = *cell;
+				PosKey pk(cell_x, cell_y);
+				//moment of truth
+				if (!tile_set->has_tile(c.id))
+					continue;
+				Ref<Texture> tex = tile_set->tile_get_texture(c.id);
+				Vector2 tile_ofs = tile_set->tile_get_texture_offset(c.id);
 
-			Ref<ShaderMaterial> mat = tile_set->tile_get_material(c.id);
-			int z_index = tile_set->tile_get_z_index(c.id);
+				Vector2 wofs = _map_to_world(pk.x, pk.y);
+				Vector2 offset = wofs - q.pos + tofs;
 
-			RID canvas_item;
-			RID debug_canvas_item;
+				if (!tex.is_valid())
+					continue;
 
-			if (prev_canvas_item == RID() || prev_material != mat || prev_z_index != z_index) {
+				RID canvas_item;
+				RID debug_canvas_item;
 
-				canvas_item = vs->canvas_item_create();
-				if (mat.is_valid())
-					vs->canvas_item_set_material(canvas_item, mat->get_rid());
-				vs->canvas_item_set_parent(canvas_item, get_canvas_item());
-				_update_item_material_state(canvas_item);
-				Transform2D xform;
-				xform.set_origin(q.pos);
-				vs->canvas_item_set_transform(canvas_item, xform);
-				vs->canvas_item_set_light_mask(canvas_item, get_light_mask());
-				vs->canvas_item_set_z_index(canvas_item, z_index);
+				Rect2 r = tile_set->tile_get_region(c.id);
+				if (tile_set->tile_get_tile_mode(c.id) == TileSet::AUTO_TILE || tile_set->tile_get_tile_mode(c.id) == TileSet::ATLAS_TILE) {
+					int spacing = tile_set->autotile_get_spacing(c.id);
+					r.size = tile_set->autotile_get_size(c.id);
+					r.position += (r.size + Vector2(spacing, spacing)) * Vector2(c.autotile_coord_x, c.autotile_coord_y);
+				}
+				Size2 s = tex->get_size();
 
-				q.canvas_items.push_back(canvas_item);
+				if (r == Rect2())
+					s = tex->get_size();
+				else {
+					s = r.size;
+				}
 
-				if (debug_shapes) {
+				Vector2 center_ofs;
 
-					debug_canvas_item = vs->canvas_item_create();
-					vs->canvas_item_set_parent(debug_canvas_item, canvas_item);
-					vs->canvas_item_set_z_as_relative_to_parent(debug_canvas_item, false);
-					vs->canvas_item_set_z_index(debug_canvas_item, VS::CANVAS_ITEM_Z_MAX - 1);
-					q.canvas_items.push_back(debug_canvas_item);
-					prev_debug_canvas_item = debug_canvas_item;
-				}
+				if (rebuild_visual) {
 
-				prev_canvas_item = canvas_item;
-				prev_material = mat;
-				prev_z_index = z_index;
+					Ref<ShaderMaterial> mat = tile_set->tile_get_material(c.id);
+					int z_index = tile_set->tile_get_z_index(c.id);
 
-			} else {
-				canvas_item = prev_canvas_item;
-				if (debug_shapes) {
-					debug_canvas_item = prev_debug_canvas_item;
-				}
-			}
+					if (prev_canvas_item == RID() || prev_material != mat || prev_z_index != z_index) {
 
-			Rect2 r = tile_set->tile_get_region(c.id);
-			if (tile_set->tile_get_tile_mode(c.id) == TileSet::AUTO_TILE || tile_set->tile_get_tile_mode(c.id) == TileSet::ATLAS_TILE) {
-				int spacing = tile_set->autotile_get_spacing(c.id);
-				r.size = tile_set->autotile_get_size(c.id);
-				r.position += (r.size + Vector2(spacing, spacing)) * Vector2(c.autotile_coord_x, c.autotile_coord_y);
-			}
-			Size2 s = tex->get_size();
+						canvas_item = vs->canvas_item_create();
+						if (mat.is_valid())
+							vs->canvas_item_set_material(canvas_item, mat->get_rid());
+						vs->canvas_item_set_parent(canvas_item, get_canvas_item());
+						_update_item_material_state(canvas_item);
+						Transform2D xform;
+						xform.set_origin(q.pos);
+						vs->canvas_item_set_transform(canvas_item, xform);
+						vs->canvas_item_set_light_mask(canvas_item, get_light_mask());
+						vs->canvas_item_set_z_index(canvas_item, z_index);
 
-			if (r == Rect2())
-				s = tex->get_size();
-			else {
-				s = r.size;
-			}
+						q.canvas_items.push_back(canvas_item);
 
-			Rect2 rect;
-			rect.position = offset.floor();
-			rect.size = s;
-			rect.size.x += fp_adjust;
-			rect.size.y += fp_adjust;
-
-			if (rect.size.y > rect.size.x) {
-				if ((c.flip_h && (c.flip_v || c.transpose)) || (c.flip_v && !c.transpose))
-					tile_ofs.y += rect.size.y - rect.size.x;
-			} else if (rect.size.y < rect.size.x) {
-				if ((c.flip_v && (c.flip_h || c.transpose)) || (c.flip_h && !c.transpose))
-					tile_ofs.x += rect.size.x - rect.size.y;
-			}
+						if (debug_shapes) {
 
-			/*	rect.size.x+=fp_adjust;
-			rect.size.y+=fp_adjust;*/
+							debug_canvas_item = vs->canvas_item_create();
+							vs->canvas_item_set_parent(debug_canvas_item, canvas_item);
+							vs->canvas_item_set_z_as_relative_to_parent(debug_canvas_item, false);
+							vs->canvas_item_set_z_index(debug_canvas_item, VS::CANVAS_ITEM_Z_MAX - 1);
+							q.canvas_items.push_back(debug_canvas_item);
+							prev_debug_canvas_item = debug_canvas_item;
+						}
 
-			if (c.transpose)
-				SWAP(tile_ofs.x, tile_ofs.y);
+						prev_canvas_item = canvas_item;
+						prev_material = mat;
+						prev_z_index = z_index;
 
-			if (c.flip_h) {
-				rect.size.x = -rect.size.x;
-				tile_ofs.x = -tile_ofs.x;
-			}
-			if (c.flip_v) {
-				rect.size.y = -rect.size.y;
-				tile_ofs.y = -tile_ofs.y;
-			}
+					} else {
+						canvas_item = prev_canvas_item;
+						if (debug_shapes) {
+							debug_canvas_item = prev_debug_canvas_item;
+						}
+					}
 
-			Vector2 center_ofs;
+					Rect2 rect;
+					rect.position = offset.floor();
+					rect.size = s;
+					rect.size.x += fp_adjust;
+					rect.size.y += fp_adjust;
+
+					if (rect.size.y > rect.size.x) {
+						if ((c.flip_h && (c.flip_v || c.transpose)) || (c.flip_v && !c.transpose))
+							tile_ofs.y += rect.size.y - rect.size.x;
+					} else if (rect.size.y < rect.size.x) {
+						if ((c.flip_v && (c.flip_h || c.transpose)) || (c.flip_h && !c.transpose))
+							tile_ofs.x += rect.size.x - rect.size.y;
+					}
 
-			if (tile_origin == TILE_ORIGIN_TOP_LEFT) {
-				rect.position += tile_ofs;
+					/*	rect.size.x+=fp_adjust;
+					rect.size.y+=fp_adjust;*/
 
-			} else if (tile_origin == TILE_ORIGIN_BOTTOM_LEFT) {
+					if (c.transpose)
+						SWAP(tile_ofs.x, tile_ofs.y);
 
-				rect.position += tile_ofs;
+					if (c.flip_h) {
+						rect.size.x = -rect.size.x;
+						tile_ofs.x = -tile_ofs.x;
+					}
+					if (c.flip_v) {
+						rect.size.y = -rect.size.y;
+						tile_ofs.y = -tile_ofs.y;
+					}
 
-				if (c.transpose) {
-					if (c.flip_h)
-						rect.position.x -= cell_size.x;
-					else
-						rect.position.x += cell_size.x;
-				} else {
-					if (c.flip_v)
-						rect.position.y -= cell_size.y;
-					else
-						rect.position.y += cell_size.y;
-				}
+					if (tile_origin == TILE_ORIGIN_TOP_LEFT) {
+						rect.position += tile_ofs;
 
-			} else if (tile_origin == TILE_ORIGIN_CENTER) {
+					} else if (tile_origin == TILE_ORIGIN_BOTTOM_LEFT) {
 
-				rect.position += tile_ofs;
+						rect.position += tile_ofs;
 
-				if (c.flip_h)
-					rect.position.x -= cell_size.x / 2;
-				else
-					rect.position.x += cell_size.x / 2;
+						if (c.transpose) {
+							if (c.flip_h)
+								rect.position.x -= cell_size.x;
+							else
+								rect.position.x += cell_size.x;
+						} else {
+							if (c.flip_v)
+								rect.position.y -= cell_size.y;
+							else
+								rect.position.y += cell_size.y;
+						}
 
-				if (c.flip_v)
-					rect.position.y -= cell_size.y / 2;
-				else
-					rect.position.y += cell_size.y / 2;
-			}
+					} else if (tile_origin == TILE_ORIGIN_CENTER) {
 
-			Ref<Texture> normal_map = tile_set->tile_get_normal_map(c.id);
-			Color modulate = tile_set->tile_get_modulate(c.id);
-			Color self_modulate = get_self_modulate();
-			modulate = Color(modulate.r * self_modulate.r, modulate.g * self_modulate.g,
-					modulate.b * self_modulate.b, modulate.a * self_modulate.a);
-			if (r == Rect2()) {
-				tex->draw_rect(canvas_item, rect, false, modulate, c.transpose, normal_map);
-			} else {
-				tex->draw_rect_region(canvas_item, rect, r, modulate, c.transpose, normal_map, clip_uv);
-			}
+						rect.position += tile_ofs;
 
-			Vector<TileSet::ShapeData> shapes = tile_set->tile_get_shapes(c.id);
+						if (c.flip_h)
+							rect.position.x -= cell_size.x / 2;
+						else
+							rect.position.x += cell_size.x / 2;
 
-			for (int i = 0; i < shapes.size(); i++) {
-				Ref<Shape2D> shape = shapes[i].shape;
-				if (shape.is_valid()) {
-					if (tile_set->tile_get_tile_mode(c.id) == TileSet::SINGLE_TILE || (shapes[i].autotile_coord.x == c.autotile_coord_x && shapes[i].autotile_coord.y == c.autotile_coord_y)) {
-						Transform2D xform;
-						xform.set_origin(offset.floor());
+						if (c.flip_v)
+							rect.position.y -= cell_size.y / 2;
+						else
+							rect.position.y += cell_size.y / 2;
+					}
 
-						Vector2 shape_ofs = shapes[i].shape_transform.get_origin();
+					Ref<Texture> normal_map = tile_set->tile_get_normal_map(c.id);
+					Color modulate = tile_set->tile_get_modulate(c.id);
+					Color self_modulate = get_self_modulate();
+					modulate = Color(modulate.r * self_modulate.r, modulate.g * self_modulate.g,
+							modulate.b * self_modulate.b, modulate.a * self_modulate.a);
+					if (r == Rect2()) {
+						tex->draw_rect(canvas_item, rect, false, modulate, c.transpose, normal_map);
+					} else {
+						tex->draw_rect_region(canvas_item, rect, r, modulate, c.transpose, normal_map, clip_uv);
+					}
+				}
+
+				if (rebuild_physics) {
+
+					Vector<TileSet::ShapeData> shapes = tile_set->tile_get_shapes(c.id);
+
+					for (int i = 0; i < shapes.size(); i++) {
+						Ref<Shape2D> shape = shapes[i].shape;
+						if (shape.is_valid()) {
+							if (tile_set->tile_get_tile_mode(c.id) == TileSet::SINGLE_TILE || (shapes[i].autotile_coord.x == c.autotile_coord_x && shapes[i].autotile_coord.y == c.autotile_coord_y)) {
+								Transform2D xform;
+								xform.set_origin(offset.floor());
+
+								Vector2 shape_ofs = shapes[i].shape_transform.get_origin();
 
-						_fix_cell_transform(xform, c, shape_ofs + center_ofs, s);
+								_fix_cell_transform(xform, c, shape_ofs + center_ofs, s);
 
-						xform *= shapes[i].shape_transform.untranslated();
+								xform *= shapes[i].shape_transform.untranslated();
 
-						if (debug_canvas_item.is_valid()) {
-							vs->canvas_item_add_set_transform(debug_canvas_item, xform);
-							shape->draw(debug_canvas_item, debug_collision_color);
+								if (debug_canvas_item.is_valid()) {
+									vs->canvas_item_add_set_transform(debug_canvas_item, xform);
+									shape->draw(debug_canvas_item, debug_collision_color);
+								}
+								ps->body_add_shape(q.body, shape->get_rid(), xform);
+								ps->body_set_shape_metadata(q.body, shape_idx, Vector2(pk.x, pk.y));
+								ps->body_set_shape_as_one_way_collision(q.body, shape_idx, shapes[i].one_way_collision);
+								shape_idx++;
+							}
 						}
-						ps->body_add_shape(q.body, shape->get_rid(), xform);
-						ps->body_set_shape_metadata(q.body, shape_idx, Vector2(E->key().x, E->key().y));
-						ps->body_set_shape_as_one_way_collision(q.body, shape_idx, shapes[i].one_way_collision);
-						shape_idx++;
 					}
-				}
-			}
-
-			if (debug_canvas_item.is_valid()) {
-				vs->canvas_item_add_set_transform(debug_canvas_item, Transform2D());
-			}
 
-			if (navigation) {
-				Ref<NavigationPolygon> navpoly;
-				Vector2 npoly_ofs;
-				if (tile_set->tile_get_tile_mode(c.id) == TileSet::AUTO_TILE || tile_set->tile_get_tile_mode(c.id) == TileSet::ATLAS_TILE) {
-					navpoly = tile_set->autotile_get_navigation_polygon(c.id, Vector2(c.autotile_coord_x, c.autotile_coord_y));
-					npoly_ofs = Vector2();
-				} else {
-					navpoly = tile_set->tile_get_navigation_polygon(c.id);
-					npoly_ofs = tile_set->tile_get_navigation_polygon_offset(c.id);
+					if (debug_canvas_item.is_valid()) {
+						vs->canvas_item_add_set_transform(debug_canvas_item, Transform2D());
+					}
 				}
 
-				if (navpoly.is_valid()) {
-					Transform2D xform;
-					xform.set_origin(offset.floor() + q.pos);
-					_fix_cell_transform(xform, c, npoly_ofs + center_ofs, s);
-
-					int pid = navigation->navpoly_add(navpoly, nav_rel * xform);
-
-					Quadrant::NavPoly np;
-					np.id = pid;
-					np.xform = xform;
-					q.navpoly_ids[E->key()] = np;
-
-					if (debug_navigation) {
-						RID debug_navigation_item = vs->canvas_item_create();
-						vs->canvas_item_set_parent(debug_navigation_item, canvas_item);
-						vs->canvas_item_set_z_as_relative_to_parent(debug_navigation_item, false);
-						vs->canvas_item_set_z_index(debug_navigation_item, VS::CANVAS_ITEM_Z_MAX - 2); // Display one below collision debug
-
-						if (debug_navigation_item.is_valid()) {
-							PoolVector<Vector2> navigation_polygon_vertices = navpoly->get_vertices();
-							int vsize = navigation_polygon_vertices.size();
-
-							if (vsize > 2) {
-								Vector<Color> colors;
-								Vector<Vector2> vertices;
-								vertices.resize(vsize);
-								colors.resize(vsize);
-								{
-									PoolVector<Vector2>::Read vr = navigation_polygon_vertices.read();
-									for (int i = 0; i < vsize; i++) {
-										vertices.write[i] = vr[i];
-										colors.write[i] = debug_navigation_color;
+				if (rebuild_navigation) {
+					Ref<NavigationPolygon> navpoly;
+					Vector2 npoly_ofs;
+					if (tile_set->tile_get_tile_mode(c.id) == TileSet::AUTO_TILE || tile_set->tile_get_tile_mode(c.id) == TileSet::ATLAS_TILE) {
+						navpoly = tile_set->autotile_get_navigation_polygon(c.id, Vector2(c.autotile_coord_x, c.autotile_coord_y));
+						npoly_ofs = Vector2();
+					} else {
+						navpoly = tile_set->tile_get_navigation_polygon(c.id);
+						npoly_ofs = tile_set->tile_get_navigation_polygon_offset(c.id);
+					}
+
+					if (navpoly.is_valid()) {
+						Transform2D xform;
+						xform.set_origin(offset.floor() + q.pos);
+						_fix_cell_transform(xform, c, npoly_ofs + center_ofs, s);
+
+						int pid = navigation->navpoly_add(navpoly, nav_rel * xform);
+
+						Quadrant::NavPoly np;
+						np.id = pid;
+						np.xform = xform;
+						q.navpoly_ids[pk] = np;
+
+						if (debug_navigation) {
+							RID debug_navigation_item = vs->canvas_item_create();
+							vs->canvas_item_set_parent(debug_navigation_item, canvas_item);
+							vs->canvas_item_set_z_as_relative_to_parent(debug_navigation_item, false);
+							vs->canvas_item_set_z_index(debug_navigation_item, VS::CANVAS_ITEM_Z_MAX - 2); // Display one below collision debug
+
+							if (debug_navigation_item.is_valid()) {
+								PoolVector<Vector2> navigation_polygon_vertices = navpoly->get_vertices();
+								int vsize = navigation_polygon_vertices.size();
+
+								if (vsize > 2) {
+									Vector<Color> colors;
+									Vector<Vector2> vertices;
+									vertices.resize(vsize);
+									colors.resize(vsize);
+									{
+										PoolVector<Vector2>::Read vr = navigation_polygon_vertices.read();
+										for (int i = 0; i < vsize; i++) {
+											vertices.write[i] = vr[i];
+											colors.write[i] = debug_navigation_color;
+										}
 									}
-								}
 
-								Vector<int> indices;
+									Vector<int> indices;
 
-								for (int i = 0; i < navpoly->get_polygon_count(); i++) {
-									Vector<int> polygon = navpoly->get_polygon(i);
+									for (int i = 0; i < navpoly->get_polygon_count(); i++) {
+										Vector<int> polygon = navpoly->get_polygon(i);
 
-									for (int j = 2; j < polygon.size(); j++) {
+										for (int j = 2; j < polygon.size(); j++) {
 
-										int kofs[3] = { 0, j - 1, j };
-										for (int k = 0; k < 3; k++) {
+											int kofs[3] = { 0, j - 1, j };
+											for (int k = 0; k < 3; k++) {
 
-											int idx = polygon[kofs[k]];
-											ERR_FAIL_INDEX(idx, vsize);
-											indices.push_back(idx);
+												int idx = polygon[kofs[k]];
+												ERR_FAIL_INDEX(idx, vsize);
+												indices.push_back(idx);
+											}
 										}
 									}
-								}
-								Transform2D navxform;
-								navxform.set_origin(offset.floor());
-								_fix_cell_transform(navxform, c, npoly_ofs + center_ofs, s);
+									Transform2D navxform;
+									navxform.set_origin(offset.floor());
+									_fix_cell_transform(navxform, c, npoly_ofs + center_ofs, s);
 
-								vs->canvas_item_set_transform(debug_navigation_item, navxform);
-								vs->canvas_item_add_triangle_array(debug_navigation_item, indices, vertices, colors);
+									vs->canvas_item_set_transform(debug_navigation_item, navxform);
+									vs->canvas_item_add_triangle_array(debug_navigation_item, indices, vertices, colors);
+								}
 							}
 						}
 					}
 				}
-			}
 
-			Ref<OccluderPolygon2D> occluder;
-			if (tile_set->tile_get_tile_mode(c.id) == TileSet::AUTO_TILE || tile_set->tile_get_tile_mode(c.id) == TileSet::ATLAS_TILE) {
-				occluder = tile_set->autotile_get_light_occluder(c.id, Vector2(c.autotile_coord_x, c.autotile_coord_y));
-			} else {
-				occluder = tile_set->tile_get_light_occluder(c.id);
-			}
-			if (occluder.is_valid()) {
-				Vector2 occluder_ofs = tile_set->tile_get_occluder_offset(c.id);
-				Transform2D xform;
-				xform.set_origin(offset.floor() + q.pos);
-				_fix_cell_transform(xform, c, occluder_ofs + center_ofs, s);
-
-				RID orid = VS::get_singleton()->canvas_light_occluder_create();
-				VS::get_singleton()->canvas_light_occluder_set_transform(orid, get_global_transform() * xform);
-				VS::get_singleton()->canvas_light_occluder_set_polygon(orid, occluder->get_rid());
-				VS::get_singleton()->canvas_light_occluder_attach_to_canvas(orid, get_canvas());
-				VS::get_singleton()->canvas_light_occluder_set_light_mask(orid, occluder_light_mask);
-				Quadrant::Occluder oc;
-				oc.xform = xform;
-				oc.id = orid;
-				q.occluder_instances[E->key()] = oc;
+				if (rebuild_occluders) {
+					Ref<OccluderPolygon2D> occluder;
+					if (tile_set->tile_get_tile_mode(c.id) == TileSet::AUTO_TILE || tile_set->tile_get_tile_mode(c.id) == TileSet::ATLAS_TILE) {
+						occluder = tile_set->autotile_get_light_occluder(c.id, Vector2(c.autotile_coord_x, c.autotile_coord_y));
+					} else {
+						occluder = tile_set->tile_get_light_occluder(c.id);
+					}
+					if (occluder.is_valid()) {
+						Vector2 occluder_ofs = tile_set->tile_get_occluder_offset(c.id);
+						Transform2D xform;
+						xform.set_origin(offset.floor() + q.pos);
+						_fix_cell_transform(xform, c, occluder_ofs + center_ofs, s);
+
+						RID orid = VS::get_singleton()->canvas_light_occluder_create();
+						VS::get_singleton()->canvas_light_occluder_set_transform(orid, get_global_transform() * xform);
+						VS::get_singleton()->canvas_light_occluder_set_polygon(orid, occluder->get_rid());
+						VS::get_singleton()->canvas_light_occluder_attach_to_canvas(orid, get_canvas());
+						VS::get_singleton()->canvas_light_occluder_set_light_mask(orid, occluder_light_mask);
+						Quadrant::Occluder oc;
+						oc.xform = xform;
+						oc.id = orid;
+						q.occluder_instances[pk] = oc;
+					}
+				}
 			}
 		}
 
+		q.dirty = 0;
 		dirty_quadrant_list.remove(dirty_quadrant_list.first());
-		quadrant_order_dirty = true;
+		if (rebuild_visual)
+			quadrant_order_dirty = true;
 	}
 
 	pending_update = false;
@@ -644,6 +683,7 @@ Map<TileMap::PosKey, TileMap::Quadrant>::Element *TileMap::_create_quadrant(cons
 	Transform2D xform;
 	//xform.set_origin(Point2(p_qk.x,p_qk.y)*cell_size*quadrant_size);
 	Quadrant q;
+	q.key = p_qk;
 	q.pos = _map_to_world(p_qk.x * _get_quadrant_size(), p_qk.y * _get_quadrant_size());
 	q.pos += get_cell_draw_offset();
 	if (tile_origin == TILE_ORIGIN_CENTER)
@@ -704,9 +744,13 @@ void TileMap::_erase_quadrant(Map<PosKey, Quadrant>::Element *Q) {
 	rect_cache_dirty = true;
 }
 
-void TileMap::_make_quadrant_dirty(Map<PosKey, Quadrant>::Element *Q, bool update) {
+void TileMap::_make_quadrant_dirty(Map<PosKey, Quadrant>::Element *Q, uint32_t p_layers, bool update) {
+
+	if (!p_layers)
+		return;
 
 	Quadrant &q = Q->get();
+	q.dirty |= p_layers;
 	if (!q.dirty_list.in_list())
 		dirty_quadrant_list.add(&q.dirty_list);
 
@@ -721,6 +765,25 @@ void TileMap::_make_quadrant_dirty(Map<PosKey, Quadrant>::Element *Q, bool updat
 	}
 }
 
+void TileMap::_get_quadrant_cell_range(int p_quadrant, int &r_from, int &r_to) const {
+
+	// cells are assigned to quadrants with a truncating division, so quadrant 0 spans both signs
+	int size = _get_quadrant_size();
+	if (p_quadrant > 0) {
+		r_from = p_quadrant * size;
+		r_to = r_from + size - 1;
+	} else if (p_quadrant < 0) {
+		r_to = p_quadrant * size;
+		r_from = r_to - size + 1;
+	} else {
+		r_from = -size + 1;
+		r_to = size - 1;
+	}
+
+	r_from = MAX(r_from, -32768);
+	r_to = MIN(r_to, 32767);
+}
+
 void TileMap::set_cellv(const Vector2 &p_pos, int p_tile, bool p_flip_x, bool p_flip_y, bool p_transpose) {
 
 	set_cell(p_pos.x, p_pos.y, p_tile, p_flip_x, p_flip_y, p_transpose);
@@ -731,57 +794,192 @@ void TileMap::_set_celld(const Vector2 &p_pos, const Dictionary &p_data) {
 	set_cell(p_pos.x, p_pos.y, p_data["id"], p_data["flip_h"], p_data["flip_y"], p_data["transpose"], p_data["auto_coord"]);
 }
 
-void TileMap::set_cell(int p_x, int p_y, int p_tile, bool p_flip_x, bool p_flip_y, bool p_transpose, Vector2 p_autotile_coord) {
+const TileMap::Cell *TileMap::_find_cell(int p_x, int p_y) const {
+
+	PosKey pk(p_x, p_y);
+	Chunk *const *C = chunks.getptr(PosKey(pk.x >> CHUNK_SHIFT, pk.y >> CHUNK_SHIFT));
+	if (!C)
+		return NULL;
+
+	const Cell *cell = &(*C)->cells[((pk.y & CHUNK_MASK) << CHUNK_SHIFT) | (pk.x & CHUNK_MASK)];
+	if (cell->id == INVALID_CELL)
+		return NULL;
+
+	return cell;
+}
+
+TileMap::Cell TileMap::_make_cell(int p_tile, bool p_flip_x, bool p_flip_y, bool p_transpose, const Vector2 &p_autotile_coord) {
+
+	Cell c;
+	c.id = p_tile;
+	c.flip_h = p_flip_x;
+	c.flip_v = p_flip_y;
+	c.transpose = p_transpose;
+	c.autotile_coord_x = (uint16_t)p_autotile_coord.x;
+	c.autotile_coord_y = (uint16_t)p_autotile_coord.y;
+	return c;
+}
+
+uint32_t TileMap::_get_cell_layers(const Cell &p_cell) const {
+
+	if (!tile_set.is_valid() || !tile_set->has_tile(p_cell.id))
+		return 0;
+
+	uint32_t layers = DIRTY_VISUAL;
+
+	if (tile_set->tile_get_shape_count(p_cell.id) > 0)
+		layers |= DIRTY_PHYSICS;
+
+	bool autotile = tile_set->tile_get_tile_mode(p_cell.id) == TileSet::AUTO_TILE || tile_set->tile_get_tile_mode(p_cell.id) == TileSet::ATLAS_TILE;
+	Vector2 coord(p_cell.autotile_coord_x, p_cell.autotile_coord_y);
+
+	if (navigation) {
+		Ref<NavigationPolygon> navpoly = autotile ? tile_set->autotile_get_navigation_polygon(p_cell.id, coord) : tile_set->tile_get_navigation_polygon(p_cell.id);
+		if (navpoly.is_valid())
+			layers |= DIRTY_NAVIGATION;
+	}
+
+	Ref<OccluderPolygon2D> occluder = autotile ? tile_set->autotile_get_light_occluder(p_cell.id, coord) : tile_set->tile_get_light_occluder(p_cell.id);
+	if (occluder.is_valid())
+		layers |= DIRTY_OCCLUDERS;
+
+	return layers;
+}
+
+void TileMap::_set_cell(int p_x, int p_y, const Cell &p_cell, CellWriteCache &r_cache) {
 
 	PosKey pk(p_x, p_y);
+	PosKey ck(pk.x >> CHUNK_SHIFT, pk.y >> CHUNK_SHIFT);
+
+	if (!r_cache.chunk || !(r_cache.chunk_key == ck)) {
+		Chunk **C = chunks.getptr(ck);
+		r_cache.chunk = C ? *C : NULL;
+		r_cache.chunk_key = ck;
+	}
 
-	Map<PosKey, Cell>::Element *E = tile_map.find(pk);
-	if (!E && p_tile == INVALID_CELL)
+	Chunk *chunk = r_cache.chunk;
+	int cell_index = ((pk.y & CHUNK_MASK) << CHUNK_SHIFT) | (pk.x & CHUNK_MASK);
+	Cell *cell = chunk ? &chunk->cells[cell_index] : NULL;
+	bool used = cell && cell->id != INVALID_CELL;
+
+	if (!used && p_cell.id == INVALID_CELL)
 		return; //nothing to do
 
-	PosKey qk(p_x / _get_quadrant_size(), p_y / _get_quadrant_size());
-	if (p_tile == INVALID_CELL) {
+	if (used && cell->id == p_cell.id && cell->flip_h == p_cell.flip_h && cell->flip_v == p_cell.flip_v && cell->transpose == p_cell.transpose && cell->autotile_coord_x == p_cell.autotile_coord_x && cell->autotile_coord_y == p_cell.autotile_coord_y)
+		return; //nothing changed
+
+	PosKey qk(pk.x / _get_quadrant_size(), pk.y / _get_quadrant_size());
+	if (!r_cache.quadrant || !(r_cache.quadrant_key == qk)) {
+		r_cache.quadrant = quadrant_map.find(qk);
+		r_cache.quadrant_key = qk;
+	}
+
+	Map<PosKey, Quadrant>::Element *Q = r_cache.quadrant;
+
+	if (p_cell.id == INVALID_CELL) {
 		//erase existing
-		tile_map.erase(pk);
-		Map<PosKey, Quadrant>::Element *Q = quadrant_map.find(qk);
 		ERR_FAIL_COND(!Q);
 		Quadrant &q = Q->get();
-		q.cells.erase(pk);
-		if (q.cells.size() == 0)
+
+		uint32_t layers = q.dirty != DIRTY_ALL ? _get_cell_layers(*cell) : 0;
+
+		*cell = Cell();
+		cell->id = INVALID_CELL;
+		cell_count--;
+		chunk->used--;
+		if (chunk->used == 0) {
+			memdelete(chunk);
+			chunks.erase(ck);
+			r_cache.chunk = NULL;
+		}
+
+		q.cell_count--;
+		if (q.cell_count == 0) {
 			_erase_quadrant(Q);
-		else
-			_make_quadrant_dirty(Q);
+			r_cache.quadrant = NULL;
+		} else {
+			_make_quadrant_dirty(Q, layers);
+		}
 
+		used_size_cache_dirty = true;
 		return;
 	}
 
-	Map<PosKey, Quadrant>::Element *Q = quadrant_map.find(qk);
+	uint32_t layers = 0;
+
+	if (!used) {
+		if (!chunk) {
+			chunk = memnew(Chunk);
+			chunks.set(ck, chunk);
+			r_cache.chunk = chunk;
+			cell = &chunk->cells[cell_index];
+		}
+		chunk->used++;
+		cell_count++;
 
-	if (!E) {
-		E = tile_map.insert(pk, Cell());
 		if (!Q) {
 			Q = _create_quadrant(qk);
+			r_cache.quadrant = Q;
 		}
-		Quadrant &q = Q->get();
-		q.cells.insert(pk);
+		Q->get().cell_count++;
+
+		used_size_cache_dirty = true;
 	} else {
 		ERR_FAIL_COND(!Q); // quadrant should exist...
 
-		if (E->get().id == p_tile && E->get().flip_h == p_flip_x && E->get().flip_v == p_flip_y && E->get().transpose == p_transpose && E->get().autotile_coord_x == (uint16_t)p_autotile_coord.x && E->get().autotile_coord_y == (uint16_t)p_autotile_coord.y)
-			return; //nothing changed
+		if (Q->get().dirty != DIRTY_ALL)
+			layers = _get_cell_layers(*cell);
 	}
 
-	Cell &c = E->get();
+	*cell = p_cell;
 
-	c.id = p_tile;
-	c.flip_h = p_flip_x;
-	c.flip_v = p_flip_y;
-	c.transpose = p_transpose;
-	c.autotile_coord_x = (uint16_t)p_autotile_coord.x;
-	c.autotile_coord_y = (uint16_t)p_autotile_coord.y;
+	if (Q->get().dirty != DIRTY_ALL)
+		layers |= _get_cell_layers(*cell);
 
-	_make_quadrant_dirty(Q);
-	used_size_cache_dirty = true;
+	_make_quadrant_dirty(Q, layers);
+}
+
+void TileMap::set_cell(int p_x, int p_y, int p_tile, bool p_flip_x, bool p_flip_y, bool p_transpose, Vector2 p_autotile_coord) {
+
+	CellWriteCache cache;
+	_set_cell(p_x, p_y, _make_cell(p_tile, p_flip_x, p_flip_y, p_transpose, p_autotile_coord), cache);
+}
+
+void TileMap::set_cells_rect(const Rect2 &p_rect, int p_tile, bool p_flip_x, bool p_flip_y, bool p_transpose, Vector2 p_autotile_coord) {
+
+	int from_x = p_rect.position.x;
+	int from_y = p_rect.position.y;
+	int width = p_rect.size.x;
+	int height = p_rect.size.y;
+	ERR_FAIL_COND(width < 0 || height < 0);
+
+	Cell c = _make_cell(p_tile, p_flip_x, p_flip_y, p_transpose, p_autotile_coord);
+
+	CellWriteCache cache;
+	for (int y = from_y; y < from_y + height; y++) {
+		for (int x = from_x; x < from_x + width; x++) {
+			_set_cell(x, y, c, cache);
+		}
+	}
+}
+
+void TileMap::set_cells_array(const Rect2 &p_rect, const PoolVector<int> &p_tiles) {
+
+	int from_x = p_rect.position.x;
+	int from_y = p_rect.position.y;
+	int width = p_rect.size.x;
+	int height = p_rect.size.y;
+	ERR_FAIL_COND(width < 0 || height < 0);
+	ERR_FAIL_COND(p_tiles.size() != width * height);
+
+	PoolVector<int>::Read r = p_tiles.read();
+
+	CellWriteCache cache;
+	for (int y = 0; y < height; y++) {
+		for (int x = 0; x < width; x++) {
+			_set_cell(from_x + x, from_y + y, _make_cell(r[y * width + x], false, false, false, Vector2()), cache);
+		}
+	}
 }
 
 int TileMap::get_cellv(const Vector2 &p_pos) const {
@@ -832,10 +1030,9 @@ void TileMap::update_bitmask_region(const Vector2 &p_start, const Vector2 &p_end
 
 void TileMap::update_cell_bitmask(int p_x, int p_y) {
 
-	PosKey p(p_x, p_y);
-	Map<PosKey, Cell>::Element *E = tile_map.find(p);
-	if (E != NULL) {
-		int id = get_cell(p_x, p_y);
+	Cell *cell = _find_cell(p_x, p_y);
+	if (cell != NULL) {
+		int id = cell->id;
 		if (tile_set->tile_get_tile_mode(id) == TileSet::AUTO_TILE || tile_set->tile_get_tile_mode(id) == TileSet::ATLAS_TILE) {
 			uint16_t mask = 0;
 			if (tile_set->autotile_get_bitmask_mode(id) == TileSet::BITMASK_2X2) {
@@ -894,15 +1091,19 @@ void TileMap::update_cell_bitmask(int p_x, int p_y) {
 				}
 			}
 			Vector2 coord = tile_set->autotile_get_subtile_for_bitmask(id, mask, this, Vector2(p_x, p_y));
-			E->get().autotile_coord_x = (int)coord.x;
-			E->get().autotile_coord_y = (int)coord.y;
+			if (cell->autotile_coord_x == (int)coord.x && cell->autotile_coord_y == (int)coord.y)
+				return; //nothing changed
 
-			PosKey qk(p_x / _get_quadrant_size(), p_y / _get_quadrant_size());
+			cell->autotile_coord_x = (int)coord.x;
+			cell->autotile_coord_y = (int)coord.y;
+
+			PosKey pk(p_x, p_y);
+			PosKey qk(pk.x / _get_quadrant_size(), pk.y / _get_quadrant_size());
 			Map<PosKey, Quadrant>::Element *Q = quadrant_map.find(qk);
 			_make_quadrant_dirty(Q);
 		} else {
-			E->get().autotile_coord_x = 0;
-			E->get().autotile_coord_y = 0;
+			cell->autotile_coord_x = 0;
+			cell->autotile_coord_y = 0;
 		}
 	}
 }
@@ -917,74 +1118,66 @@ void TileMap::update_dirty_bitmask() {
 
 void TileMap::fix_invalid_tiles() {
 
-	for (Map<PosKey, Cell>::Element *E = tile_map.front(); E; E = E->next()) {
+	Vector<PosKey> cells;
+	_get_sorted_cells(cells);
+
+	for (int i = 0; i < cells.size(); i++) {
 
-		if (!tile_set->has_tile(get_cell(E->key().x, E->key().y))) {
-			set_cell(E->key().x, E->key().y, INVALID_CELL);
+		if (!tile_set->has_tile(get_cell(cells[i].x, cells[i].y))) {
+			set_cell(cells[i].x, cells[i].y, INVALID_CELL);
 		}
 	}
 }
 
 int TileMap::get_cell(int p_x, int p_y) const {
 
-	PosKey pk(p_x, p_y);
+	const Cell *cell = _find_cell(p_x, p_y);
 
-	const Map<PosKey, Cell>::Element *E = tile_map.find(pk);
-
-	if (!E)
+	if (!cell)
 		return INVALID_CELL;
 
-	return E->get().id;
+	return cell->id;
 }
 bool TileMap::is_cell_x_flipped(int p_x, int p_y) const {
 
-	PosKey pk(p_x, p_y);
-
-	const Map<PosKey, Cell>::Element *E = tile_map.find(pk);
+	const Cell *cell = _find_cell(p_x, p_y);
 
-	if (!E)
+	if (!cell)
 		return false;
 
-	return E->get().flip_h;
+	return cell->flip_h;
 }
 bool TileMap::is_cell_y_flipped(int p_x, int p_y) const {
 
-	PosKey pk(p_x, p_y);
+	const Cell *cell = _find_cell(p_x, p_y);
 
-	const Map<PosKey, Cell>::Element *E = tile_map.find(pk);
-
-	if (!E)
+	if (!cell)
 		return false;
 
-	return E->get().flip_v;
+	return cell->flip_v;
 }
 bool TileMap::is_cell_transposed(int p_x, int p_y) const {
 
-	PosKey pk(p_x, p_y);
-
-	const Map<PosKey, Cell>::Element *E = tile_map.find(pk);
+	const Cell *cell = _find_cell(p_x, p_y);
 
-	if (!E)
+	if (!cell)
 		return false;
 
-	return E->get().transpose;
+	return cell->transpose;
 }
 
 void TileMap::set_cell_autotile_coord(int p_x, int p_y, const Vector2 &p_coord) {
 
-	PosKey pk(p_x, p_y);
-
-	const Map<PosKey, Cell>::Element *E = tile_map.find(pk);
+	Cell *cell = _find_cell(p_x, p_y);
 
-	if (!E)
+	if (!cell)
 		return;
 
-	Cell c = E->get();
-	c.autotile_coord_x = p_coord.x;
-	c.autotile_coord_y = p_coord.y;
-	tile_map[pk] = c;
+	cell->autotile_coord_x = p_coord.x;
+	cell->autotile_coord_y = p_coord.y;
 
-	PosKey qk(p_x / _get_quadrant_size(), p_y / _get_quadrant_size());
+	PosKey pk(p_x, p_y);
+	PosKey qk(pk.x / _get_quadrant_size(), pk.y / _get_quadrant_size());
 	Map<PosKey, Quadrant>::Element *Q = quadrant_map.find(qk);
 
 	if (!Q)
@@ -995,32 +1188,91 @@ void TileMap::set_cell_autotile_coord(int p_x, int p_y, const Vector2 &p_coord)
 
 Vector2 TileMap::get_cell_autotile_coord(int p_x, int p_y) const {
 
-	PosKey pk(p_x, p_y);
-
-	const Map<PosKey, Cell>::Element *E = tile_map.find(pk);
+	const Cell *cell = _find_cell(p_x, p_y);
 
-	if (!E)
+	if (!cell)
 		return Vector2();
 
-	return Vector2(E->get().autotile_coord_x, E->get().autotile_coord_y);
+	return Vector2(cell->autotile_coord_x, cell->autotile_coord_y);
+}
+
+void TileMap::_get_sorted_cells(Vector<PosKey> &r_cells) const {
+
+	Vector<PosKey> chunk_keys;
+	const PosKey *K = NULL;
+	while ((K = chunks.next(K))) {
+		chunk_keys.push_back(*K);
+	}
+	chunk_keys.sort();
+
+	r_cells.resize(cell_count);
+	int idx = 0;
+
+	// walk each row of chunks line by line, so cells come out sorted by (y, x)
+	for (int i = 0; i < chunk_keys.size();) {
+
+		int row_end = i + 1;
+		while (row_end < chunk_keys.size() && chunk_keys[row_end].y == chunk_keys[i].y)
+			row_end++;
+
+		for (int y = 0; y < CHUNK_SIZE; y++) {
+			for (int j = i; j < row_end; j++) {
+
+				const PosKey &ck = chunk_keys[j];
+				const Cell *row = &chunks.get(ck)->cells[y << CHUNK_SHIFT];
+				for (int x = 0; x < CHUNK_SIZE; x++) {
+					if (row[x].id != INVALID_CELL) {
+						r_cells.write[idx++] = PosKey(ck.x * CHUNK_SIZE + x, ck.y * CHUNK_SIZE + y);
+					}
+				}
+			}
+		}
+
+		i = row_end;
+	}
+}
+
+void TileMap::_clear_chunks() {
+
+	const PosKey *K = NULL;
+	while ((K = chunks.next(K))) {
+		memdelete(chunks[*K]);
+	}
+	chunks.clear();
+	cell_count = 0;
 }
 
 void TileMap::_recreate_quadrants() {
 
 	_clear_quadrants();
 
-	for (Map<PosKey, Cell>::Element *E = tile_map.front(); E; E = E->next()) {
+	Map<PosKey, Quadrant>::Element *Q = NULL;
 
-		PosKey qk(E->key().x / _get_quadrant_size(), E->key().y / _get_quadrant_size());
+	const PosKey *K = NULL;
+	while ((K = chunks.next(K))) {
 
-		Map<PosKey, Quadrant>::Element *Q = quadrant_map.find(qk);
-		if (!Q) {
-			Q = _create_quadrant(qk);
-			dirty_quadrant_list.add(&Q->get().dirty_list);
+		const Chunk *chunk = chunks[*K];
+		for (int i = 0; i < CHUNK_SIZE * CHUNK_SIZE; i++) {
+
+			if (chunk->cells[i].id == INVALID_CELL)
+				continue;
+
+			PosKey pk(K->x * CHUNK_SIZE + (i & CHUNK_MASK), K->y * CHUNK_SIZE + (i >> CHUNK_SHIFT));
+			PosKey qk(pk.x / _get_quadrant_size(), pk.y / _get_quadrant_size());
+
+			if (!Q || !(Q->key() == qk)) {
+				Q = quadrant_map.find(qk);
+				if (!Q) {
+					Q = _create_quadrant(qk);
+				}
+			}
+
+			Q->get().cell_count++;
 		}
+	}
 
-		Q->get().cells.insert(E->key());
-		_make_quadrant_dirty(Q, false);
+	for (Q = quadrant_map.front(); Q; Q = Q->next()) {
+		_make_quadrant_dirty(Q, DIRTY_ALL, false);
 	}
 	update_dirty_quadrants();
 }
@@ -1064,7 +1316,7 @@ void TileMap::_update_item_material_state(const RID &p_canvas_item) {
 void TileMap::clear() {
 
 	_clear_quadrants();
-	tile_map.clear();
+	_clear_chunks();
 	used_size_cache_dirty = true;
 }
 
@@ -1076,6 +1328,7 @@ void TileMap::_set_tile_data(const PoolVector<int> &p_data) {
 	int offset = (format == FORMAT_2) ? 3 : 2;
 
 	clear();
+	CellWriteCache cache;
 	for (int i = 0; i < c; i += offset) {
 
 		const uint8_t *ptr = (const uint8_t *)&r[i];
@@ -1113,33 +1366,37 @@ void TileMap::_set_tile_data(const PoolVector<int> &p_data) {
 		if (x<-20 || y <-20 || x>4000 || y>4000)
 			continue;
 		*/
-		set_cell(x, y, v, flip_h, flip_v, transpose, Vector2(coord_x, coord_y));
+		_set_cell(x, y, _make_cell(v, flip_h, flip_v, transpose, Vector2(coord_x, coord_y)), cache);
 	}
 }
 
 PoolVector<int> TileMap::_get_tile_data() const {
 
+	Vector<PosKey> cells;
+	_get_sorted_cells(cells);
+
 	PoolVector<int> data;
-	data.resize(tile_map.size() * 3);
+	data.resize(cells.size() * 3);
 	PoolVector<int>::Write w = data.write();
 
 	format = FORMAT_2;
 
 	int idx = 0;
-	for (const Map<PosKey, Cell>::Element *E = tile_map.front(); E; E = E->next()) {
+	for (int i = 0; i < cells.size(); i++) {
+		const Cell &c = *_find_cell(cells[i].x, cells[i].y);
 		uint8_t *ptr = (uint8_t *)&w[idx];
-		encode_uint16(E->key().x, &ptr[0]);
-		encode_uint16(E->key().y, &ptr[2]);
-		uint32_t val = E->get().id;
-		if (E->get().flip_h)
+		encode_uint16(cells[i].x, &ptr[0]);
+		encode_uint16(cells[i].y, &ptr[2]);
+		uint32_t val = c.id;
+		if (c.flip_h)
 			val |= (1 << 29);
-		if (E->get().flip_v)
+		if (c.flip_v)
 			val |= (1 << 30);
-		if (E->get().transpose)
+		if (c.transpose)
 			val |= (1 << 31);
 		encode_uint32(val, &ptr[4]);
-		encode_uint16(E->get().autotile_coord_x, &ptr[8]);
-		encode_uint16(E->get().autotile_coord_y, &ptr[10]);
+		encode_uint16(c.autotile_coord_x, &ptr[8]);
+		encode_uint16(c.autotile_coord_y, &ptr[10]);
 		idx += 3;
 	}
 
@@ -1465,13 +1722,15 @@ bool TileMap::is_y_sort_mode_enabled() const {
 
 Array TileMap::get_used_cells() const {
 
+	Vector<PosKey> cells;
+	_get_sorted_cells(cells);
+
 	Array a;
-	a.resize(tile_map.size());
-	int i = 0;
-	for (Map<PosKey, Cell>::Element *E = tile_map.front(); E; E = E->next()) {
+	a.resize(cells.size());
+	for (int i = 0; i < cells.size(); i++) {
 
-		Vector2 p(E->key().x, E->key().y);
-		a[i++] = p;
+		Vector2 p(cells[i].x, cells[i].y);
+		a[i] = p;
 	}
 
 	return a;
@@ -1479,11 +1738,14 @@ Array TileMap::get_used_cells() const {
 
 Array TileMap::get_used_cells_by_id(int p_id) const {
 
+	Vector<PosKey> cells;
+	_get_sorted_cells(cells);
+
 	Array a;
-	for (Map<PosKey, Cell>::Element *E = tile_map.front(); E; E = E->next()) {
+	for (int i = 0; i < cells.size(); i++) {
 
-		if (E->value().id == p_id) {
-			Vector2 p(E->key().x, E->key().y);
+		if (_find_cell(cells[i].x, cells[i].y)->id == p_id) {
+			Vector2 p(cells[i].x, cells[i].y);
 			a.push_back(p);
 		}
 	}
@@ -1494,11 +1756,26 @@ Array TileMap::get_used_cells_by_id(int p_id) const {
 Rect2 TileMap::get_used_rect() { // Not const because of cache
 
 	if (used_size_cache_dirty) {
-		if (tile_map.size() > 0) {
-			used_size_cache = Rect2(tile_map.front()->key().x, tile_map.front()->key().y, 0, 0);
+		if (cell_count > 0) {
+			bool first = true;
+
+			const PosKey *K = NULL;
+			while ((K = chunks.next(K))) {
+
+				const Chunk *chunk = chunks[*K];
+				for (int i = 0; i < CHUNK_SIZE * CHUNK_SIZE; i++) {
 
-			for (Map<PosKey, Cell>::Element *E = tile_map.front(); E; E = E->next()) {
-				used_size_cache.expand_to(Vector2(E->key().x, E->key().y));
+					if (chunk->cells[i].id == INVALID_CELL)
+						continue;
+
+					Vector2 p(K->x * CHUNK_SIZE + (i & CHUNK_MASK), K->y * CHUNK_SIZE + (i >> CHUNK_SHIFT));
+					if (first) {
+						used_size_cache = Rect2(p, Vector2());
+						first = false;
+					} else {
+						used_size_cache.expand_to(p);
+					}
+				}
 			}
 
 			used_size_cache.size += Vector2(1, 1);
@@ -1612,6 +1889,8 @@ void TileMap::_bind_methods() {
 
 	ClassDB::bind_method(D_METHOD("set_cell", "x", "y", "tile", "flip_x", "flip_y", "transpose", "autotile_coord"), &TileMap::set_cell, DEFVAL(false), DEFVAL(false), DEFVAL(false), DEFVAL(Vector2()));
 	ClassDB::bind_method(D_METHOD("set_cellv", "position", "tile", "flip_x", "flip_y", "transpose"), &TileMap::set_cellv, DEFVAL(false), DEFVAL(false), DEFVAL(false));
+	ClassDB::bind_method(D_METHOD("set_cells_rect", "rect", "tile", "flip_x", "flip_y", "transpose", "autotile_coord"), &TileMap::set_cells_rect, DEFVAL(false), DEFVAL(false), DEFVAL(false), DEFVAL(Vector2()));
+	ClassDB::bind_method(D_METHOD("set_cells_array", "rect", "tiles"), &TileMap::set_cells_array);
 	ClassDB::bind_method(D_METHOD("_set_celld", "position", "data"), &TileMap::_set_celld);
 	ClassDB::bind_method(D_METHOD("get_cell", "x", "y"), &TileMap::get_cell);
 	ClassDB::bind_method(D_METHOD("get_cellv", "position"), &TileMap::get_cellv);
@@ -1690,6 +1969,7 @@ TileMap::TileMap() {
 	used_size_cache_dirty = true;
 	pending_update = false;
 	quadrant_order_dirty = false;
+	cell_count = 0;
 	quadrant_size = 16;
 	cell_size = Size2(64, 64);
 	collision_layer = 1;
@@ -31,8 +31,8 @@
 #ifndef TILE_MAP_H
 #define TILE_MAP_H
 
+#include "core/hash_map.h"
 #include "core/self_list.h"
-#include "core/vset.h"
 #include "scene/2d/navigation2d.h"
 #include "scene/2d/node_2d.h"
 #include "scene/resources/tile_set.h"
@@ -113,16 +113,52 @@ private:
 		Cell() { _u64t = 0; }
 	};
 
-	Map<PosKey, Cell> tile_map;
+	struct PosKeyHasher {
+		static _FORCE_INLINE_ uint32_t hash(const PosKey &p_key) { return hash_djb2_one_32(p_key.key); }
+	};
+
+	// Cells are stored densely in fixed size chunks, an empty cell has INVALID_CELL as id.
+	enum {
+		CHUNK_SHIFT = 4,
+		CHUNK_SIZE = 1 << CHUNK_SHIFT,
+		CHUNK_MASK = CHUNK_SIZE - 1
+	};
+
+	struct Chunk {
+
+		Cell cells[CHUNK_SIZE * CHUNK_SIZE];
+		int used;
+
+		Chunk() {
+			used = 0;
+			for (int i = 0; i < CHUNK_SIZE * CHUNK_SIZE; i++) {
+				cells[i].id = INVALID_CELL;
+			}
+		}
+	};
+
+	HashMap<PosKey, Chunk *, PosKeyHasher> chunks;
+	int cell_count;
 	List<PosKey> dirty_bitmask;
 
+	// What has to be regenerated for a quadrant, so edits only rebuild the layers they touch.
+	enum {
+		DIRTY_VISUAL = 1,
+		DIRTY_PHYSICS = 2,
+		DIRTY_NAVIGATION = 4,
+		DIRTY_OCCLUDERS = 8,
+		DIRTY_ALL = DIRTY_VISUAL | DIRTY_PHYSICS | DIRTY_NAVIGATION | DIRTY_OCCLUDERS
+	};
+
 	struct Quadrant {
 
+		PosKey key;
 		Vector2 pos;
 		List<RID> canvas_items;
 		RID body;
 
 		SelfList<Quadrant> dirty_list;
+		uint32_t dirty;
 
 		struct NavPoly {
 			int id;
@@ -137,33 +173,54 @@ private:
 		Map<PosKey, NavPoly> navpoly_ids;
 		Map<PosKey, Occluder> occluder_instances;
 
-		VSet<PosKey> cells;
+		int cell_count;
 
 		void operator=(const Quadrant &q) {
+			key = q.key;
 			pos = q.pos;
 			canvas_items = q.canvas_items;
 			body = q.body;
-			cells = q.cells;
+			dirty = q.dirty;
+			cell_count = q.cell_count;
 			navpoly_ids = q.navpoly_ids;
 			occluder_instances = q.occluder_instances;
 		}
 		Quadrant(const Quadrant &q) :
 				dirty_list(this) {
+			key = q.key;
 			pos = q.pos;
 			canvas_items = q.canvas_items;
 			body = q.body;
-			cells = q.cells;
+			dirty = q.dirty;
+			cell_count = q.cell_count;
 			occluder_instances = q.occluder_instances;
 			navpoly_ids = q.navpoly_ids;
 		}
 		Quadrant() :
-				dirty_list(this) {}
+				dirty_list(this) {
+			dirty = 0;
+			cell_count = 0;
+		}
 	};
 
 	Map<PosKey, Quadrant> quadrant_map;
 
 	SelfList<Quadrant>::List dirty_quadrant_list;
 
+	// Bulk edits hit the same chunk and quadrant many times in a row.
+	struct CellWriteCache {
+
+		PosKey chunk_key;
+		Chunk *chunk;
+		PosKey quadrant_key;
+		Map<PosKey, Quadrant>::Element *quadrant;
+
+		CellWriteCache() {
+			chunk = NULL;
+			quadrant = NULL;
+		}
+	};
+
 	bool pending_update;
 
 	Rect2 rect_cache;
@@ -188,7 +245,8 @@ private:
 
 	Map<PosKey, Quadrant>::Element *_create_quadrant(const PosKey &p_qk);
 	void _erase_quadrant(Map<PosKey, Quadrant>::Element *Q);
-	void _make_quadrant_dirty(Map<PosKey, Quadrant>::Element *Q, bool update = true);
+	void _make_quadrant_dirty(Map<PosKey, Quadrant>::Element *Q, uint32_t p_layers = DIRTY_ALL, bool update = true);
+	void _get_quadrant_cell_range(int p_quadrant, int &r_from, int &r_to) const;
 	void _recreate_quadrants();
 	void _clear_quadrants();
 	void _update_quadrant_space(const RID &p_space);
@@ -200,6 +258,14 @@ private:
 
 	_FORCE_INLINE_ int _get_quadrant_size() const;
 
+	_FORCE_INLINE_ const Cell *_find_cell(int p_x, int p_y) const;
+	_FORCE_INLINE_ Cell *_find_cell(int p_x, int p_y) { return const_cast<Cell *>(static_cast<const TileMap *>(this)->_find_cell(p_x, p_y)); }
+	static Cell _make_cell(int p_tile, bool p_flip_x, bool p_flip_y, bool p_transpose, const Vector2 &p_autotile_coord);
+	uint32_t _get_cell_layers(const Cell &p_cell) const;
+	void _set_cell(int p_x, int p_y, const Cell &p_cell, CellWriteCache &r_cache);
+	void _get_sorted_cells(Vector<PosKey> &r_cells) const;
+	void _clear_chunks();
+
 	void _set_tile_data(const PoolVector<int> &p_data);
 	PoolVector<int> _get_tile_data() const;
 
@@ -235,6 +301,8 @@ public:
 	int get_quadrant_size() const;
 
 	void set_cell(int p_x, int p_y, int p_tile, bool p_flip_x = false, bool p_flip_y = false, bool p_transpose = false, Vector2 p_autotile_coord = Vector2());
+	void set_cells_rect(const Rect2 &p_rect, int p_tile, bool p_flip_x = false, bool p_flip_y = false, bool p_transpose = false, Vector2 p_autotile_coord = Vector2());
+	void set_cells_array(const Rect2 &p_rect, const PoolVector<int> &p_tiles);
 	int get_cell(int p_x, int p_y) const;
 	bool is_cell_x_flipped(int p_x, int p_y) const;
 	bool is_cell_y_flipped(int p_x, int p_y) const;
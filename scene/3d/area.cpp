@@ -29,6 +29,7 @@
 /*************************************************************************/
 
 #include "area.h"
+#include "scene/3d/audio_voice_manager_3d.h"
 #include "scene/scene_string_names.h"
 #include "servers/audio_server.h"
 #include "servers/physics_server.h"
@@ -285,6 +286,14 @@ void Area::_notification(int p_what) {
 	if (p_what == NOTIFICATION_EXIT_TREE) {
 		_clear_monitoring();
 	}
+
+	if (p_what == NOTIFICATION_ENTER_WORLD) {
+		_update_audio_registration(true);
+	}
+
+	if (p_what == NOTIFICATION_EXIT_WORLD) {
+		_update_audio_registration(false);
+	}
 }
 
 void Area::set_monitoring(bool p_enable) {
@@ -541,9 +550,28 @@ bool Area::get_collision_layer_bit(int p_bit) const {
 	return get_collision_layer() & (1 << p_bit);
 }
 
+void Area::_update_audio_registration(bool p_in_world) {
+
+	// audio players only query the physics space for areas while at least one of them can affect sound
+	bool registered = p_in_world && (audio_bus_override || use_reverb_bus);
+	if (registered == audio_registered)
+		return;
+
+	Ref<World> world = get_world();
+	ERR_FAIL_COND(world.is_null());
+
+	if (registered) {
+		world->_get_audio_voice_manager()->add_audio_area();
+	} else {
+		world->_get_audio_voice_manager()->remove_audio_area();
+	}
+	audio_registered = registered;
+}
+
 void Area::set_audio_bus_override(bool p_override) {
 
 	audio_bus_override = p_override;
+	_update_audio_registration(is_inside_world());
 }
 
 bool Area::is_overriding_audio_bus() const {
@@ -568,6 +596,7 @@ StringName Area::get_audio_bus() const {
 void Area::set_use_reverb_bus(bool p_enable) {
 
 	use_reverb_bus = p_enable;
+	_update_audio_registration(is_inside_world());
 }
 bool Area::is_using_reverb_bus() const {
 
@@ -764,6 +793,7 @@ Area::Area() :
 	reverb_bus = "Master";
 	reverb_amount = 0.0;
 	reverb_uniformity = 0.0;
+	audio_registered = false;
 }
 
 Area::~Area() {
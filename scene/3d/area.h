@@ -135,6 +135,9 @@ private:
 	float reverb_amount;
 	float reverb_uniformity;
 
+	bool audio_registered;
+	void _update_audio_registration(bool p_in_world);
+
 	void _validate_property(PropertyInfo &property) const;
 
 protected:
@@ -31,8 +31,19 @@
 #include "audio_stream_player_3d.h"
 #include "core/engine.h"
 #include "scene/3d/area.h"
+#include "scene/3d/audio_voice_manager_3d.h"
 #include "scene/3d/camera.h"
 #include "scene/main/viewport.h"
+
+void AudioStreamPlayer3D::_get_loop_range(float p_length, float &r_begin, float &r_end) const {
+
+	r_begin = CLAMP(stream_playback->get_loop_begin(), 0, p_length);
+	r_end = stream_playback->get_loop_end();
+	if (r_end <= r_begin || r_end > p_length) {
+		r_end = p_length;
+	}
+}
+
 void AudioStreamPlayer3D::_mix_audio() {
 
 	if (!stream_playback.is_valid() || !active ||
@@ -45,6 +56,66 @@ void AudioStreamPlayer3D::_mix_audio() {
 		stream_playback->start(setseek);
 		setseek = -1.0; //reset seek
 		started = true;
+		voice_was_virtual = false;
+	}
+
+	if (voice_virtual) {
+		//virtual voices only keep track of time, nothing is decoded or mixed
+		if (!voice_was_virtual) {
+			virtual_position = stream_playback->get_playback_position();
+			voice_was_virtual = true;
+		}
+
+		if (!stream_paused && (output_count > 0 || out_of_range_mode == OUT_OF_RANGE_MIX)) {
+			virtual_position += mix_buffer.size() * pitch_scale / AudioServer::get_singleton()->get_mix_rate();
+
+			float length = stream->get_length();
+			if (length > 0) {
+				if (stream_playback->is_looping()) {
+					float loop_begin;
+					float loop_end;
+					_get_loop_range(length, loop_begin, loop_end);
+
+					//a ping-pong loop plays its range forward then backward, position keeps counting along that path
+					float loop_length = loop_end - loop_begin;
+					if (stream_playback->is_loop_ping_pong()) {
+						loop_length *= 2.0;
+					}
+
+					if (loop_length > 0 && virtual_position >= loop_begin + loop_length) {
+						virtual_position = loop_begin + Math::fmod(virtual_position - loop_begin, loop_length);
+					}
+				} else if (virtual_position >= length) {
+					active = false;
+				}
+			}
+		}
+
+		prev_output_count = 0;
+		output_ready = false;
+		stream_paused_fade_in = false;
+		stream_paused_fade_out = false;
+		return;
+	}
+
+	if (voice_was_virtual) {
+		//audible again, resume from where the voice would be and ramp in
+		voice_was_virtual = false;
+		float length = stream->get_length();
+		if (length > 0) {
+			float position = virtual_position;
+			if (stream_playback->is_looping() && stream_playback->is_loop_ping_pong()) {
+				//on the way back, resume at the mirrored position
+				float loop_begin;
+				float loop_end;
+				_get_loop_range(length, loop_begin, loop_end);
+				if (position > loop_end) {
+					position = MAX(loop_begin, loop_end - (position - loop_end));
+				}
+			}
+			stream_playback->seek(position);
+		}
+		stream_paused_fade_in = true;
 	}
 
 	//get data
@@ -225,329 +296,331 @@ float AudioStreamPlayer3D::_get_attenuation_db(float p_distance) const {
 	return att;
 }
 
-void _update_sound() {
-}
-
-void AudioStreamPlayer3D::_notification(int p_what) {
+void AudioStreamPlayer3D::_update_outputs(const AudioVoiceManager3D::Listener *p_listeners, int p_listener_count, Area *area, PhysicsDirectSpaceState *space_state) {
 
-	if (p_what == NOTIFICATION_ENTER_TREE) {
+	Vector3 linear_velocity;
 
-		velocity_tracker->reset(get_global_transform().origin);
-		AudioServer::get_singleton()->add_callback(_mix_audios, this);
-		if (autoplay && !Engine::get_singleton()->is_editor_hint()) {
-			play();
-		}
+	//compute linear velocity for doppler
+	if (doppler_tracking != DOPPLER_TRACKING_DISABLED) {
+		linear_velocity = velocity_tracker->get_tracked_linear_velocity();
 	}
 
-	if (p_what == NOTIFICATION_EXIT_TREE) {
+	int new_output_count = 0;
+	float audibility = 0;
 
-		AudioServer::get_singleton()->remove_callback(_mix_audios, this);
-	}
+	Vector3 global_pos = get_global_transform().origin;
 
-	if (p_what == NOTIFICATION_PAUSED) {
-		if (!can_process()) {
-			// Node can't process so we start fading out to silence
-			set_stream_paused(true);
-		}
-	}
+	int bus_index = AudioServer::get_singleton()->thread_find_bus_index(bus);
 
-	if (p_what == NOTIFICATION_UNPAUSED) {
-		set_stream_paused(false);
-	}
+	for (int l = 0; l < p_listener_count; l++) {
 
-	if (p_what == NOTIFICATION_TRANSFORM_CHANGED) {
+		const AudioVoiceManager3D::Listener &listener = p_listeners[l];
 
-		if (doppler_tracking != DOPPLER_TRACKING_DISABLED) {
-			velocity_tracker->update_position(get_global_transform().origin);
-		}
-	}
+		Vector3 local_pos = listener.to_local.xform(global_pos);
 
-	if (p_what == NOTIFICATION_INTERNAL_PHYSICS_PROCESS) {
+		float dist = local_pos.length();
 
-		//update anything related to position first, if possible of course
+		Vector3 area_sound_pos;
+		Vector3 cam_area_pos;
 
-		if (!output_ready) {
+		if (area && area->is_using_reverb_bus() && area->get_reverb_uniformity() > 0) {
+			area_sound_pos = space_state->get_closest_point_to_object_volume(area->get_rid(), listener.transform.origin);
+			cam_area_pos = listener.transform.affine_inverse().xform(area_sound_pos);
+		}
+
+		if (max_distance > 0) {
 
-			Vector3 linear_velocity;
+			float total_max = max_distance;
 
-			//compute linear velocity for doppler
-			if (doppler_tracking != DOPPLER_TRACKING_DISABLED) {
-				linear_velocity = velocity_tracker->get_tracked_linear_velocity();
+			if (area && area->is_using_reverb_bus() && area->get_reverb_uniformity() > 0) {
+				total_max = MAX(total_max, cam_area_pos.length());
 			}
+			if (total_max > max_distance) {
+				continue; //can't hear this sound in this camera
+			}
+		}
 
-			Ref<World> world = get_world();
-			ERR_FAIL_COND(world.is_null());
+		float multiplier = Math::db2linear(_get_attenuation_db(dist));
+		if (max_distance > 0) {
+			multiplier *= MAX(0, 1.0 - (dist / max_distance));
+		}
+		audibility = MAX(audibility, multiplier);
 
-			int new_output_count = 0;
+		Output output;
+		output.bus_index = bus_index;
+		output.reverb_bus_index = -1; //no reverb by default
+		output.viewport = listener.viewport;
 
-			Vector3 global_pos = get_global_transform().origin;
+		float db_att = (1.0 - MIN(1.0, multiplier)) * attenuation_filter_db;
 
-			int bus_index = AudioServer::get_singleton()->thread_find_bus_index(bus);
+		if (emission_angle_enabled) {
+			Vector3 camtopos = global_pos - listener.transform.origin;
+			float c = camtopos.normalized().dot(get_global_transform().basis.get_axis(2).normalized()); //it's z negative
+			float angle = Math::rad2deg(Math::acos(c));
+			if (angle > emission_angle)
+				db_att -= -emission_angle_filter_attenuation_db;
+		}
 
-			//check if any area is diverting sound into a bus
+		output.filter_gain = Math::db2linear(db_att);
 
-			PhysicsDirectSpaceState *space_state = PhysicsServer::get_singleton()->space_get_direct_state(world->get_space());
+		Vector3 flat_pos = local_pos;
+		flat_pos.y = 0;
+		flat_pos.normalize();
 
-			PhysicsDirectSpaceState::ShapeResult sr[MAX_INTERSECT_AREAS];
+		unsigned int cc = AudioServer::get_singleton()->get_channel_count();
+		if (cc == 1) {
+			// Stereo pair
+			float c = flat_pos.x * 0.5 + 0.5;
 
-			int areas = space_state->intersect_point(global_pos, sr, MAX_INTERSECT_AREAS, Set<RID>(), area_mask);
-			Area *area = NULL;
+			output.vol[0].l = 1.0 - c;
+			output.vol[0].r = c;
+		} else {
+			Vector3 camtopos = global_pos - listener.transform.origin;
+			float c = camtopos.normalized().dot(get_global_transform().basis.get_axis(2).normalized()); //it's z negative
+			float angle = Math::rad2deg(Math::acos(c));
+			float av = angle * (flat_pos.x < 0 ? -1 : 1) / 180.0;
+
+			if (cc >= 1) {
+				// Stereo pair
+				float fl = Math::abs(1.0 - Math::abs(-0.8 - av));
+				float fr = Math::abs(1.0 - Math::abs(0.8 - av));
+
+				output.vol[0].l = fl;
+				output.vol[0].r = fr;
+			}
 
-			for (int i = 0; i < areas; i++) {
-				if (!sr[i].collider)
-					continue;
+			if (cc >= 2) {
+				// Center pair
+				float center = 1.0 - Math::sin(Math::acos(c));
 
-				Area *tarea = Object::cast_to<Area>(sr[i].collider);
-				if (!tarea)
-					continue;
+				output.vol[1].l = center;
+				output.vol[1].r = center;
+			}
 
-				if (!tarea->is_overriding_audio_bus() && !tarea->is_using_reverb_bus())
-					continue;
+			if (cc >= 3) {
+				// Side pair
+				float sl = Math::abs(1.0 - Math::abs(-0.4 - av));
+				float sr = Math::abs(1.0 - Math::abs(0.4 - av));
 
-				area = tarea;
-				break;
+				output.vol[2].l = sl;
+				output.vol[2].r = sr;
 			}
 
-			List<Camera *> cameras;
-			world->get_camera_list(&cameras);
+			if (cc >= 4) {
+				// Rear pair
+				float rl = Math::abs(1.0 - Math::abs(-0.2 - av));
+				float rr = Math::abs(1.0 - Math::abs(0.2 - av));
 
-			for (List<Camera *>::Element *E = cameras.front(); E; E = E->next()) {
+				output.vol[3].l = rl;
+				output.vol[3].r = rr;
+			}
+		}
 
-				Camera *camera = E->get();
-				Viewport *vp = camera->get_viewport();
-				if (!vp->is_audio_listener())
-					continue;
+		for (int k = 0; k < cc; k++) {
+			output.vol[k] *= multiplier;
+		}
 
-				Vector3 local_pos = camera->get_global_transform().orthonormalized().affine_inverse().xform(global_pos);
+		bool filled_reverb = false;
+		int vol_index_max = AudioServer::get_singleton()->get_speaker_mode() + 1;
 
-				float dist = local_pos.length();
+		if (area) {
 
-				Vector3 area_sound_pos;
-				Vector3 cam_area_pos;
+			if (area->is_overriding_audio_bus()) {
+				//override audio bus
+				StringName bus_name = area->get_audio_bus();
+				output.bus_index = AudioServer::get_singleton()->thread_find_bus_index(bus_name);
+			}
 
-				if (area && area->is_using_reverb_bus() && area->get_reverb_uniformity() > 0) {
-					area_sound_pos = space_state->get_closest_point_to_object_volume(area->get_rid(), camera->get_global_transform().origin);
-					cam_area_pos = camera->get_global_transform().affine_inverse().xform(area_sound_pos);
-				}
+			if (area->is_using_reverb_bus()) {
 
-				if (max_distance > 0) {
+				filled_reverb = true;
+				StringName bus_name = area->get_reverb_bus();
+				output.reverb_bus_index = AudioServer::get_singleton()->thread_find_bus_index(bus_name);
 
-					float total_max = max_distance;
+				float uniformity = area->get_reverb_uniformity();
+				float area_send = area->get_reverb_amount();
 
-					if (area && area->is_using_reverb_bus() && area->get_reverb_uniformity() > 0) {
-						total_max = MAX(total_max, cam_area_pos.length());
-					}
-					if (total_max > max_distance) {
-						continue; //can't hear this sound in this camera
-					}
-				}
+				if (uniformity > 0.0) {
 
-				float multiplier = Math::db2linear(_get_attenuation_db(dist));
-				if (max_distance > 0) {
-					multiplier *= MAX(0, 1.0 - (dist / max_distance));
-				}
+					float distance = cam_area_pos.length();
+					float attenuation = Math::db2linear(_get_attenuation_db(distance));
+					audibility = MAX(audibility, attenuation * uniformity * area_send);
 
-				Output output;
-				output.bus_index = bus_index;
-				output.reverb_bus_index = -1; //no reverb by default
-				output.viewport = vp;
+					//float dist_att_db = -20 * Math::log(dist + 0.00001); //logarithmic attenuation, like in real life
 
-				float db_att = (1.0 - MIN(1.0, multiplier)) * attenuation_filter_db;
+					float center_val[3] = { 0.5, 0.25, 0.16666 };
+					AudioFrame center_frame(center_val[vol_index_max - 1], center_val[vol_index_max - 1]);
 
-				if (emission_angle_enabled) {
-					Vector3 camtopos = global_pos - camera->get_global_transform().origin;
-					float c = camtopos.normalized().dot(get_global_transform().basis.get_axis(2).normalized()); //it's z negative
-					float angle = Math::rad2deg(Math::acos(c));
-					if (angle > emission_angle)
-						db_att -= -emission_angle_filter_attenuation_db;
-				}
+					if (attenuation < 1.0) {
+						//pan the uniform sound
+						Vector3 rev_pos = cam_area_pos;
+						rev_pos.y = 0;
+						rev_pos.normalize();
 
-				output.filter_gain = Math::db2linear(db_att);
+						if (cc >= 1) {
+							// Stereo pair
+							float c = rev_pos.x * 0.5 + 0.5;
+							output.reverb_vol[0].l = 1.0 - c;
+							output.reverb_vol[0].r = c;
+						}
 
-				Vector3 flat_pos = local_pos;
-				flat_pos.y = 0;
-				flat_pos.normalize();
+						if (cc >= 3) {
+							// Center pair + Side pair
+							float xl = Vector3(-1, 0, -1).normalized().dot(rev_pos) * 0.5 + 0.5;
+							float xr = Vector3(1, 0, -1).normalized().dot(rev_pos) * 0.5 + 0.5;
 
-				unsigned int cc = AudioServer::get_singleton()->get_channel_count();
-				if (cc == 1) {
-					// Stereo pair
-					float c = flat_pos.x * 0.5 + 0.5;
+							output.reverb_vol[1].l = xl;
+							output.reverb_vol[1].r = xr;
+							output.reverb_vol[2].l = 1.0 - xr;
+							output.reverb_vol[2].r = 1.0 - xl;
+						}
 
-					output.vol[0].l = 1.0 - c;
-					output.vol[0].r = c;
-				} else {
-					Vector3 camtopos = global_pos - camera->get_global_transform().origin;
-					float c = camtopos.normalized().dot(get_global_transform().basis.get_axis(2).normalized()); //it's z negative
-					float angle = Math::rad2deg(Math::acos(c));
-					float av = angle * (flat_pos.x < 0 ? -1 : 1) / 180.0;
-
-					if (cc >= 1) {
-						// Stereo pair
-						float fl = Math::abs(1.0 - Math::abs(-0.8 - av));
-						float fr = Math::abs(1.0 - Math::abs(0.8 - av));
-
-						output.vol[0].l = fl;
-						output.vol[0].r = fr;
-					}
+						if (cc >= 4) {
+							// Rear pair
+							// FIXME: Not sure what math should be done here
+							float c = rev_pos.x * 0.5 + 0.5;
+							output.reverb_vol[3].l = 1.0 - c;
+							output.reverb_vol[3].r = c;
+						}
 
-					if (cc >= 2) {
-						// Center pair
-						float center = 1.0 - Math::sin(Math::acos(c));
+						for (int i = 0; i < vol_index_max; i++) {
 
-						output.vol[1].l = center;
-						output.vol[1].r = center;
+							output.reverb_vol[i] = output.reverb_vol[i].linear_interpolate(center_frame, attenuation);
+						}
+					} else {
+						for (int i = 0; i < vol_index_max; i++) {
+
+							output.reverb_vol[i] = center_frame;
+						}
 					}
 
-					if (cc >= 3) {
-						// Side pair
-						float sl = Math::abs(1.0 - Math::abs(-0.4 - av));
-						float sr = Math::abs(1.0 - Math::abs(0.4 - av));
+					for (int i = 0; i < vol_index_max; i++) {
 
-						output.vol[2].l = sl;
-						output.vol[2].r = sr;
+						output.reverb_vol[i] = output.vol[i].linear_interpolate(output.reverb_vol[i] * attenuation, uniformity);
+						output.reverb_vol[i] *= area_send;
 					}
 
-					if (cc >= 4) {
-						// Rear pair
-						float rl = Math::abs(1.0 - Math::abs(-0.2 - av));
-						float rr = Math::abs(1.0 - Math::abs(0.2 - av));
+				} else {
+
+					for (int i = 0; i < vol_index_max; i++) {
 
-						output.vol[3].l = rl;
-						output.vol[3].r = rr;
+						output.reverb_vol[i] = output.vol[i] * area_send;
 					}
 				}
+			}
+		}
 
-				for (int k = 0; k < cc; k++) {
-					output.vol[k] *= multiplier;
-				}
-
-				bool filled_reverb = false;
-				int vol_index_max = AudioServer::get_singleton()->get_speaker_mode() + 1;
-
-				if (area) {
+		if (doppler_tracking != DOPPLER_TRACKING_DISABLED) {
 
-					if (area->is_overriding_audio_bus()) {
-						//override audio bus
-						StringName bus_name = area->get_audio_bus();
-						output.bus_index = AudioServer::get_singleton()->thread_find_bus_index(bus_name);
-					}
+						Vector3 local_velocity = listener.to_local.basis.xform(linear_velocity - listener.velocity);
 
-					if (area->is_using_reverb_bus()) {
+			if (local_velocity == Vector3()) {
+				output.pitch_scale = 1.0;
+			} else {
+				float approaching = local_pos.normalized().dot(local_velocity.normalized());
+				float velocity = local_velocity.length();
+				float speed_of_sound = 343.0;
 
-						filled_reverb = true;
-						StringName bus_name = area->get_reverb_bus();
-						output.reverb_bus_index = AudioServer::get_singleton()->thread_find_bus_index(bus_name);
+				output.pitch_scale = speed_of_sound / (speed_of_sound + velocity * approaching);
+				output.pitch_scale = CLAMP(output.pitch_scale, (1 / 8.0), 8.0); //avoid crazy stuff
+			}
 
-						float uniformity = area->get_reverb_uniformity();
-						float area_send = area->get_reverb_amount();
+		} else {
+			output.pitch_scale = 1.0;
+		}
 
-						if (uniformity > 0.0) {
+		if (!filled_reverb) {
 
-							float distance = cam_area_pos.length();
-							float attenuation = Math::db2linear(_get_attenuation_db(distance));
+			for (int i = 0; i < vol_index_max; i++) {
 
-							//float dist_att_db = -20 * Math::log(dist + 0.00001); //logarithmic attenuation, like in real life
+				output.reverb_vol[i] = AudioFrame(0, 0);
+			}
+		}
 
-							float center_val[3] = { 0.5, 0.25, 0.16666 };
-							AudioFrame center_frame(center_val[vol_index_max - 1], center_val[vol_index_max - 1]);
+		outputs[new_output_count] = output;
+		new_output_count++;
+		if (new_output_count == MAX_OUTPUTS)
+			break;
+	}
 
-							if (attenuation < 1.0) {
-								//pan the uniform sound
-								Vector3 rev_pos = cam_area_pos;
-								rev_pos.y = 0;
-								rev_pos.normalize();
+	output_count = new_output_count;
+	voice_audibility = audibility;
+	output_ready = true;
+}
 
-								if (cc >= 1) {
-									// Stereo pair
-									float c = rev_pos.x * 0.5 + 0.5;
-									output.reverb_vol[0].l = 1.0 - c;
-									output.reverb_vol[0].r = c;
-								}
+void AudioStreamPlayer3D::_query_audio_area(PhysicsDirectSpaceState *space_state, const Vector3 &p_pos) {
 
-								if (cc >= 3) {
-									// Center pair + Side pair
-									float xl = Vector3(-1, 0, -1).normalized().dot(rev_pos) * 0.5 + 0.5;
-									float xr = Vector3(1, 0, -1).normalized().dot(rev_pos) * 0.5 + 0.5;
+	//check if any area is diverting sound into a bus
 
-									output.reverb_vol[1].l = xl;
-									output.reverb_vol[1].r = xr;
-									output.reverb_vol[2].l = 1.0 - xr;
-									output.reverb_vol[2].r = 1.0 - xl;
-								}
+	PhysicsDirectSpaceState::ShapeResult sr[MAX_INTERSECT_AREAS];
 
-								if (cc >= 4) {
-									// Rear pair
-									// FIXME: Not sure what math should be done here
-									float c = rev_pos.x * 0.5 + 0.5;
-									output.reverb_vol[3].l = 1.0 - c;
-									output.reverb_vol[3].r = c;
-								}
+	int areas = space_state->intersect_point(p_pos, sr, MAX_INTERSECT_AREAS, Set<RID>(), area_mask, false, true);
+	area_id = 0;
 
-								for (int i = 0; i < vol_index_max; i++) {
+	for (int i = 0; i < areas; i++) {
+		if (!sr[i].collider)
+			continue;
 
-									output.reverb_vol[i] = output.reverb_vol[i].linear_interpolate(center_frame, attenuation);
-								}
-							} else {
-								for (int i = 0; i < vol_index_max; i++) {
+		Area *tarea = Object::cast_to<Area>(sr[i].collider);
+		if (!tarea)
+			continue;
 
-									output.reverb_vol[i] = center_frame;
-								}
-							}
+		if (!tarea->is_overriding_audio_bus() && !tarea->is_using_reverb_bus())
+			continue;
 
-							for (int i = 0; i < vol_index_max; i++) {
+		area_id = tarea->get_instance_id();
+		break;
+	}
 
-								output.reverb_vol[i] = output.vol[i].linear_interpolate(output.reverb_vol[i] * attenuation, uniformity);
-								output.reverb_vol[i] *= area_send;
-							}
+	area_query_pos = p_pos;
+	area_queried = true;
+}
 
-						} else {
+void AudioStreamPlayer3D::_notification(int p_what) {
 
-							for (int i = 0; i < vol_index_max; i++) {
+	if (p_what == NOTIFICATION_ENTER_TREE) {
 
-								output.reverb_vol[i] = output.vol[i] * area_send;
-							}
-						}
-					}
-				}
+		velocity_tracker->reset(get_global_transform().origin);
+		if (autoplay && !Engine::get_singleton()->is_editor_hint()) {
+			play();
+		}
+	}
 
-				if (doppler_tracking != DOPPLER_TRACKING_DISABLED) {
+	if (p_what == NOTIFICATION_ENTER_WORLD) {
 
-					Vector3 camera_velocity = camera->get_doppler_tracked_velocity();
+		get_world()->_get_audio_voice_manager()->add_voice(this);
+	}
 
-					Vector3 local_velocity = camera->get_global_transform().orthonormalized().basis.xform_inv(linear_velocity - camera_velocity);
+	if (p_what == NOTIFICATION_EXIT_WORLD) {
 
-					if (local_velocity == Vector3()) {
-						output.pitch_scale = 1.0;
-					} else {
-						float approaching = local_pos.normalized().dot(local_velocity.normalized());
-						float velocity = local_velocity.length();
-						float speed_of_sound = 343.0;
+		get_world()->_get_audio_voice_manager()->remove_voice(this);
+	}
 
-						output.pitch_scale = speed_of_sound / (speed_of_sound + velocity * approaching);
-						output.pitch_scale = CLAMP(output.pitch_scale, (1 / 8.0), 8.0); //avoid crazy stuff
-					}
+	if (p_what == NOTIFICATION_PAUSED) {
+		if (!can_process()) {
+			// Node can't process so we start fading out to silence
+			set_stream_paused(true);
+		}
+	}
 
-				} else {
-					output.pitch_scale = 1.0;
-				}
+	if (p_what == NOTIFICATION_UNPAUSED) {
+		set_stream_paused(false);
+	}
 
-				if (!filled_reverb) {
+	if (p_what == NOTIFICATION_TRANSFORM_CHANGED) {
 
-					for (int i = 0; i < vol_index_max; i++) {
+		if (doppler_tracking != DOPPLER_TRACKING_DISABLED) {
+			velocity_tracker->update_position(get_global_transform().origin);
+		}
+	}
 
-						output.reverb_vol[i] = AudioFrame(0, 0);
-					}
-				}
+	if (p_what == NOTIFICATION_INTERNAL_PHYSICS_PROCESS) {
 
-				outputs[new_output_count] = output;
-				new_output_count++;
-				if (new_output_count == MAX_OUTPUTS)
-					break;
-			}
+		//update anything related to position first, if possible of course
 
-			output_count = new_output_count;
-			output_ready = true;
-		}
+		AudioVoiceManager3D *manager = get_world()->_get_audio_voice_manager();
+		manager->update();
+		manager->update_voice(this); //in case play() was called after the manager updated this frame
 
 		//start playing if requested
 		if (setplay >= 0.0) {
@@ -693,6 +766,15 @@ StringName AudioStreamPlayer3D::get_bus() const {
 	return "Master";
 }
 
+void AudioStreamPlayer3D::set_voice_priority(int p_priority) {
+
+	voice_priority = p_priority;
+}
+int AudioStreamPlayer3D::get_voice_priority() const {
+
+	return voice_priority;
+}
+
 void AudioStreamPlayer3D::set_autoplay(bool p_enable) {
 
 	autoplay = p_enable;
@@ -921,6 +1003,9 @@ void AudioStreamPlayer3D::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("set_doppler_tracking", "mode"), &AudioStreamPlayer3D::set_doppler_tracking);
 	ClassDB::bind_method(D_METHOD("get_doppler_tracking"), &AudioStreamPlayer3D::get_doppler_tracking);
 
+	ClassDB::bind_method(D_METHOD("set_voice_priority", "priority"), &AudioStreamPlayer3D::set_voice_priority);
+	ClassDB::bind_method(D_METHOD("get_voice_priority"), &AudioStreamPlayer3D::get_voice_priority);
+
 	ClassDB::bind_method(D_METHOD("set_stream_paused", "pause"), &AudioStreamPlayer3D::set_stream_paused);
 	ClassDB::bind_method(D_METHOD("get_stream_paused"), &AudioStreamPlayer3D::get_stream_paused);
 
@@ -938,6 +1023,7 @@ void AudioStreamPlayer3D::_bind_methods() {
 	ADD_PROPERTY(PropertyInfo(Variant::REAL, "max_distance", PROPERTY_HINT_EXP_RANGE, "0,4096,1,or_greater"), "set_max_distance", "get_max_distance");
 	ADD_PROPERTY(PropertyInfo(Variant::INT, "out_of_range_mode", PROPERTY_HINT_ENUM, "Mix,Pause"), "set_out_of_range_mode", "get_out_of_range_mode");
 	ADD_PROPERTY(PropertyInfo(Variant::STRING, "bus", PROPERTY_HINT_ENUM, ""), "set_bus", "get_bus");
+	ADD_PROPERTY(PropertyInfo(Variant::INT, "voice_priority", PROPERTY_HINT_RANGE, "-128,128,1"), "set_voice_priority", "get_voice_priority");
 	ADD_PROPERTY(PropertyInfo(Variant::INT, "area_mask", PROPERTY_HINT_LAYERS_2D_PHYSICS), "set_area_mask", "get_area_mask");
 	ADD_GROUP("Emission Angle", "emission_angle");
 	ADD_PROPERTY(PropertyInfo(Variant::BOOL, "emission_angle_enabled"), "set_emission_angle_enabled", "is_emission_angle_enabled");
@@ -989,6 +1075,14 @@ AudioStreamPlayer3D::AudioStreamPlayer3D() {
 	stream_paused = false;
 	stream_paused_fade_in = false;
 	stream_paused_fade_out = false;
+	voice_priority = 0;
+	voice_virtual = false;
+	voice_was_virtual = false;
+	virtual_position = 0;
+	voice_audibility = 0;
+	voice_index = -1;
+	area_queried = false;
+	area_id = 0;
 
 	velocity_tracker.instance();
 	AudioServer::get_singleton()->connect("bus_layout_changed", this, "_bus_layout_changed");
@@ -31,16 +31,20 @@
 #ifndef AUDIO_STREAM_PLAYER_3D_H
 #define AUDIO_STREAM_PLAYER_3D_H
 
+#include "scene/3d/audio_voice_manager_3d.h"
 #include "scene/3d/spatial.h"
 #include "scene/3d/spatial_velocity_tracker.h"
 #include "servers/audio/audio_filter_sw.h"
 #include "servers/audio/audio_stream.h"
 #include "servers/audio_server.h"
 
+class Area;
 class Camera;
 class AudioStreamPlayer3D : public Spatial {
 
 	GDCLASS(AudioStreamPlayer3D, Spatial)
+	friend class AudioVoiceManager3D;
+
 public:
 	enum AttenuationModel {
 		ATTENUATION_INVERSE_DISTANCE,
@@ -113,8 +117,22 @@ private:
 	bool stream_paused_fade_out;
 	StringName bus;
 
+	int voice_priority;
+	volatile bool voice_virtual;
+	bool voice_was_virtual; //only used by the audio thread
+	float virtual_position;
+	float voice_audibility;
+	int voice_index;
+
+	Vector3 area_query_pos;
+	bool area_queried;
+	ObjectID area_id;
+
 	void _mix_audio();
-	static void _mix_audios(void *self) { reinterpret_cast<AudioStreamPlayer3D *>(self)->_mix_audio(); }
+	void _get_loop_range(float p_length, float &r_begin, float &r_end) const;
+	bool _is_voice_playing() const { return active || setplay >= 0; }
+	void _query_audio_area(PhysicsDirectSpaceState *space_state, const Vector3 &p_pos);
+	void _update_outputs(const AudioVoiceManager3D::Listener *p_listeners, int p_listener_count, Area *area, PhysicsDirectSpaceState *space_state);
 
 	void _set_playing(bool p_enable);
 	bool _is_active() const;
@@ -169,6 +187,9 @@ public:
 	void set_bus(const StringName &p_bus);
 	StringName get_bus() const;
 
+	void set_voice_priority(int p_priority);
+	int get_voice_priority() const;
+
 	void set_autoplay(bool p_enable);
 	bool is_autoplay_enabled();
 
@@ -0,0 +1,210 @@
+/*************************************************************************/
+/*  audio_voice_manager_3d.cpp                                           */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2018 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2018 Godot Engine contributors (cf. AUTHORS.md)    */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#include "audio_voice_manager_3d.h"
+
+#include "core/engine.h"
+#include "core/sort.h"
+#include "scene/3d/area.h"
+#include "scene/3d/audio_stream_player_3d.h"
+#include "scene/3d/camera.h"
+#include "scene/main/viewport.h"
+#include "scene/resources/world.h"
+
+int AudioVoiceManager3D::max_voices = 64;
+float AudioVoiceManager3D::inaudible_db = -80;
+
+void AudioVoiceManager3D::_mix_voices(void *p_self) {
+
+	AudioVoiceManager3D *self = (AudioVoiceManager3D *)p_self;
+
+	for (int i = 0; i < self->voices.size(); i++) {
+		self->voices[i]->_mix_audio();
+	}
+}
+
+void AudioVoiceManager3D::add_voice(AudioStreamPlayer3D *p_voice) {
+
+	ERR_FAIL_COND(p_voice->voice_index != -1);
+
+	AudioServer::get_singleton()->lock();
+	p_voice->voice_index = voices.size();
+	voices.push_back(p_voice);
+	AudioServer::get_singleton()->unlock();
+
+	if (!callback_added) {
+		AudioServer::get_singleton()->add_callback(_mix_voices, this);
+		callback_added = true;
+	}
+}
+
+void AudioVoiceManager3D::remove_voice(AudioStreamPlayer3D *p_voice) {
+
+	int index = p_voice->voice_index;
+	ERR_FAIL_INDEX(index, voices.size());
+	ERR_FAIL_COND(voices[index] != p_voice);
+
+	AudioServer::get_singleton()->lock();
+	int last = voices.size() - 1;
+	if (index != last) {
+		voices.write[index] = voices[last];
+		voices[index]->voice_index = index;
+	}
+	voices.resize(last);
+	p_voice->voice_index = -1;
+	AudioServer::get_singleton()->unlock();
+}
+
+void AudioVoiceManager3D::add_audio_area() {
+
+	audio_area_count++;
+}
+
+void AudioVoiceManager3D::remove_audio_area() {
+
+	ERR_FAIL_COND(audio_area_count == 0);
+	audio_area_count--;
+}
+
+void AudioVoiceManager3D::update() {
+
+	uint64_t frame = Engine::get_singleton()->get_physics_frames();
+	if (frame == last_physics_frame)
+		return;
+	last_physics_frame = frame;
+
+	// listeners are the same for every voice
+
+	listeners.clear();
+
+	List<Camera *> cameras;
+	world->get_camera_list(&cameras);
+
+	for (List<Camera *>::Element *E = cameras.front(); E; E = E->next()) {
+
+		Camera *camera = E->get();
+		Viewport *vp = camera->get_viewport();
+		if (!vp->is_audio_listener())
+			continue;
+
+		Listener listener;
+		listener.viewport = vp;
+		listener.transform = camera->get_global_transform();
+		listener.to_local = listener.transform.orthonormalized().affine_inverse();
+		listener.velocity = camera->get_doppler_tracked_velocity();
+		listeners.push_back(listener);
+	}
+
+	// without areas overriding buses or using reverb there is nothing to query
+	space_state = audio_area_count > 0 ? world->get_direct_space_state() : NULL;
+
+	sort_buffer.resize(voices.size());
+	int playing = 0;
+
+	for (int i = 0; i < voices.size(); i++) {
+
+		AudioStreamPlayer3D *voice = voices[i];
+
+		if (!voice->_is_voice_playing()) {
+			voice->voice_virtual = false;
+			continue;
+		}
+
+		update_voice(voice);
+
+		VoiceSort &vs = sort_buffer.write[playing++];
+		vs.voice = voice;
+		vs.priority = voice->voice_priority;
+		vs.audibility = voice->voice_audibility;
+	}
+
+	if (max_voices > 0 && playing > max_voices) {
+		SortArray<VoiceSort> sorter;
+		sorter.sort(sort_buffer.ptrw(), playing);
+	}
+
+	float inaudible = Math::db2linear(inaudible_db);
+	real_voice_count = 0;
+
+	for (int i = 0; i < playing; i++) {
+
+		const VoiceSort &vs = sort_buffer[i];
+		bool real = vs.audibility > inaudible && (max_voices <= 0 || real_voice_count < max_voices);
+		if (real) {
+			real_voice_count++;
+		}
+		vs.voice->voice_virtual = !real;
+	}
+}
+
+void AudioVoiceManager3D::update_voice(AudioStreamPlayer3D *p_voice) {
+
+	if (p_voice->output_ready)
+		return;
+
+	Area *area = NULL;
+	if (space_state) {
+		Vector3 pos = p_voice->get_global_transform().origin;
+		// areas can move too, so positions are also queried again every few frames, staggered between voices
+		if (!p_voice->area_queried || pos != p_voice->area_query_pos || (last_physics_frame + p_voice->voice_index) % AREA_REFRESH_FRAMES == 0) {
+			p_voice->_query_audio_area(space_state, pos);
+		}
+		area = Object::cast_to<Area>(ObjectDB::get_instance(p_voice->area_id));
+	}
+
+	p_voice->_update_outputs(listeners.ptr(), listeners.size(), area, space_state);
+}
+
+int AudioVoiceManager3D::get_voice_count() const {
+
+	return voices.size();
+}
+
+int AudioVoiceManager3D::get_real_voice_count() const {
+
+	return real_voice_count;
+}
+
+AudioVoiceManager3D::AudioVoiceManager3D(World *p_world) {
+
+	world = p_world;
+	audio_area_count = 0;
+	real_voice_count = 0;
+	last_physics_frame = 0;
+	space_state = NULL;
+	callback_added = false;
+}
+
+AudioVoiceManager3D::~AudioVoiceManager3D() {
+
+	if (callback_added) {
+		AudioServer::get_singleton()->remove_callback(_mix_voices, this);
+	}
+}
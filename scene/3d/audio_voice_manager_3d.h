@@ -0,0 +1,104 @@
+/*************************************************************************/
+/*  audio_voice_manager_3d.h                                             */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2018 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2018 Godot Engine contributors (cf. AUTHORS.md)    */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef AUDIO_VOICE_MANAGER_3D_H
+#define AUDIO_VOICE_MANAGER_3D_H
+
+#include "core/math/transform.h"
+#include "core/vector.h"
+
+class AudioStreamPlayer3D;
+class PhysicsDirectSpaceState;
+class Viewport;
+class World;
+
+// Owned by each World. Spatializes every AudioStreamPlayer3D of the world
+// in a single pass per physics frame, mixes them from one audio callback,
+// and turns the least important voices virtual: they keep their playback
+// position but are neither decoded nor mixed.
+class AudioVoiceManager3D {
+public:
+	struct Listener {
+
+		Viewport *viewport;
+		Transform transform;
+		Transform to_local; // orthonormalized inverse
+		Vector3 velocity;
+	};
+
+private:
+	struct VoiceSort {
+
+		AudioStreamPlayer3D *voice;
+		int priority;
+		float audibility;
+
+		bool operator<(const VoiceSort &p_b) const {
+			return priority == p_b.priority ? audibility > p_b.audibility : priority > p_b.priority;
+		}
+	};
+
+	enum {
+		AREA_REFRESH_FRAMES = 8
+	};
+
+	World *world;
+	Vector<AudioStreamPlayer3D *> voices;
+	Vector<Listener> listeners;
+	Vector<VoiceSort> sort_buffer;
+	int audio_area_count;
+	int real_voice_count;
+	uint64_t last_physics_frame;
+	PhysicsDirectSpaceState *space_state;
+	bool callback_added;
+
+	static void _mix_voices(void *p_self);
+
+public:
+	static int max_voices;
+	static float inaudible_db;
+
+	void add_voice(AudioStreamPlayer3D *p_voice);
+	void remove_voice(AudioStreamPlayer3D *p_voice);
+
+	void add_audio_area();
+	void remove_audio_area();
+
+	void update();
+	void update_voice(AudioStreamPlayer3D *p_voice);
+
+	int get_voice_count() const;
+	int get_real_voice_count() const;
+
+	AudioVoiceManager3D(World *p_world);
+	~AudioVoiceManager3D();
+};
+
+#endif // AUDIO_VOICE_MANAGER_3D_H
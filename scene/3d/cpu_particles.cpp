@@ -30,11 +30,16 @@
 
 #include "cpu_particles.h"
 
+#include "core/os/threaded_array_processor.h"
 #include "scene/3d/camera.h"
 #include "scene/3d/particles.h"
 #include "scene/resources/particles_material.h"
 #include "servers/visual_server.h"
 
+// particles are simulated in chunks of this size, on several threads once there are enough of them
+#define CPU_PARTICLES_CHUNK_SIZE 512
+#define CPU_PARTICLES_PARALLEL_MIN_AMOUNT 8192
+
 AABB CPUParticles::get_aabb() const {
 
 	return AABB();
@@ -475,422 +480,538 @@ static float rand_from_seed_m1_p1(uint32_t &seed) {
 	return rand_from_seed(seed) * 2.0 - 1.0;
 }
 
-void CPUParticles::_particles_process(float p_delta) {
+bool CPUParticles::_particle_restarts(int p_index, int p_count, float p_prev_time, float &r_local_delta) const {
 
-	p_delta *= speed_scale;
+	float restart_time = (float(p_index) / float(p_count)) * lifetime;
 
-	int pcount = particles.size();
-	PoolVector<Particle>::Write w = particles.write();
+	if (randomness_ratio > 0.0) {
+		uint32_t seed = cycle;
+		if (restart_time >= time) {
+			seed -= uint32_t(1);
+		}
+		seed *= uint32_t(p_count);
+		seed += uint32_t(p_index);
+		float random = float(idhash(seed) % uint32_t(65536)) / 65536.0;
+		restart_time += randomness_ratio * random * 1.0 / float(p_count);
+	}
 
-	Particle *parray = w.ptr();
+	restart_time *= (1.0 - explosiveness_ratio);
+	bool restart = false;
 
-	float prev_time = time;
-	time += p_delta;
-	if (time > lifetime) {
-		time = Math::fmod(time, lifetime);
-		cycle++;
-		if (one_shot && cycle > 0) {
-			emitting = false;
+	if (time > p_prev_time) {
+		// restart_time >= p_prev_time is used so particles emit in the first frame they are processed
+
+		if (restart_time >= p_prev_time && restart_time < time) {
+			restart = true;
+			if (fractional_delta) {
+				r_local_delta = (time - restart_time) * lifetime;
+			}
+		}
+
+	} else if (r_local_delta > 0.0) {
+		if (restart_time >= p_prev_time) {
+			restart = true;
+			if (fractional_delta) {
+				r_local_delta = (1.0 - restart_time + time) * lifetime;
+			}
+
+		} else if (restart_time < time) {
+			restart = true;
+			if (fractional_delta) {
+				r_local_delta = (time - restart_time) * lifetime;
+			}
 		}
 	}
 
-	Transform emission_xform;
-	Basis velocity_xform;
-	if (!local_coords) {
-		emission_xform = get_global_transform();
-		velocity_xform = emission_xform.basis.inverse().transposed();
+	return restart;
+}
+
+void CPUParticles::_particle_emit(Particle &p, const Transform &p_emission_xform, const Basis &p_velocity_xform) {
+
+	/*float tex_linear_velocity = 0;
+	if (curve_parameters[PARAM_INITIAL_LINEAR_VELOCITY].is_valid()) {
+		tex_linear_velocity = curve_parameters[PARAM_INITIAL_LINEAR_VELOCITY]->interpolate(0);
+	}*/
+
+	float tex_angle = 0.0;
+	if (curve_parameters[PARAM_ANGLE].is_valid()) {
+		tex_angle = curve_parameters[PARAM_ANGLE]->interpolate(0);
 	}
 
-	for (int i = 0; i < pcount; i++) {
+	float tex_anim_offset = 0.0;
+	if (curve_parameters[PARAM_ANGLE].is_valid()) {
+		tex_anim_offset = curve_parameters[PARAM_ANGLE]->interpolate(0);
+	}
 
-		Particle &p = parray[i];
+	p.seed = Math::rand();
 
-		if (!emitting && !p.active)
-			continue;
+	p.angle_rand = Math::randf();
+	p.scale_rand = Math::randf();
+	p.hue_rot_rand = Math::randf();
+	p.anim_offset_rand = Math::randf();
 
-		float restart_time = (float(i) / float(pcount)) * lifetime;
-		float local_delta = p_delta;
+	float angle1_rad;
+	float angle2_rad;
 
-		if (randomness_ratio > 0.0) {
-			uint32_t seed = cycle;
-			if (restart_time >= time) {
-				seed -= uint32_t(1);
-			}
-			seed *= uint32_t(pcount);
-			seed += uint32_t(i);
-			float random = float(idhash(seed) % uint32_t(65536)) / 65536.0;
-			restart_time += randomness_ratio * random * 1.0 / float(pcount);
-		}
+	if (flags[FLAG_DISABLE_Z]) {
 
-		restart_time *= (1.0 - explosiveness_ratio);
-		bool restart = false;
+		angle1_rad = (Math::randf() * 2.0 - 1.0) * Math_PI * spread / 180.0;
+		Vector3 rot = Vector3(Math::cos(angle1_rad), Math::sin(angle1_rad), 0.0);
+		p.velocity = rot * parameters[PARAM_INITIAL_LINEAR_VELOCITY] * Math::lerp(1.0f, float(Math::randf()), randomness[PARAM_INITIAL_LINEAR_VELOCITY]);
 
-		if (time > prev_time) {
-			// restart_time >= prev_time is used so particles emit in the first frame they are processed
+	} else {
+		//initiate velocity spread in 3D
+		angle1_rad = (Math::randf() * 2.0 - 1.0) * Math_PI * spread / 180.0;
+		angle2_rad = (Math::randf() * 2.0 - 1.0) * (1.0 - flatness) * Math_PI * spread / 180.0;
+
+		Vector3 direction_xz = Vector3(Math::sin(angle1_rad), 0, Math::cos(angle1_rad));
+		Vector3 direction_yz = Vector3(0, Math::sin(angle2_rad), Math::cos(angle2_rad));
+		direction_yz.z = direction_yz.z / Math::sqrt(direction_yz.z); //better uniform distribution
+		Vector3 direction = Vector3(direction_xz.x * direction_yz.z, direction_yz.y, direction_xz.z * direction_yz.z);
+		direction.normalize();
+		p.velocity = direction * parameters[PARAM_INITIAL_LINEAR_VELOCITY] * Math::lerp(1.0f, float(Math::randf()), randomness[PARAM_INITIAL_LINEAR_VELOCITY]);
+	}
 
-			if (restart_time >= prev_time && restart_time < time) {
-				restart = true;
-				if (fractional_delta) {
-					local_delta = (time - restart_time) * lifetime;
+	float base_angle = (parameters[PARAM_ANGLE] + tex_angle) * Math::lerp(1.0f, p.angle_rand, randomness[PARAM_ANGLE]);
+	p.custom[0] = Math::deg2rad(base_angle); //angle
+	p.custom[1] = 0.0; //phase
+	p.custom[2] = (parameters[PARAM_ANIM_OFFSET] + tex_anim_offset) * Math::lerp(1.0f, p.anim_offset_rand, randomness[PARAM_ANIM_OFFSET]); //animation offset (0-1)
+	p.transform = Transform();
+	p.time = 0;
+	p.base_color = Color(1, 1, 1, 1);
+
+	switch (emission_shape) {
+		case EMISSION_SHAPE_POINT: {
+			//do none
+		} break;
+		case EMISSION_SHAPE_SPHERE: {
+			p.transform.origin = Vector3(Math::randf() * 2.0 - 1.0, Math::randf() * 2.0 - 1.0, Math::randf() * 2.0 - 1.0).normalized() * emission_sphere_radius;
+		} break;
+		case EMISSION_SHAPE_BOX: {
+			p.transform.origin = Vector3(Math::randf() * 2.0 - 1.0, Math::randf() * 2.0 - 1.0, Math::randf() * 2.0 - 1.0) * emission_box_extents;
+		} break;
+		case EMISSION_SHAPE_POINTS:
+		case EMISSION_SHAPE_DIRECTED_POINTS: {
+
+			int pc = emission_points.size();
+			if (pc == 0)
+				break;
+
+			int random_idx = Math::rand() % pc;
+
+			p.transform.origin = emission_points.get(random_idx);
+
+			if (emission_shape == EMISSION_SHAPE_DIRECTED_POINTS && emission_normals.size() == pc) {
+				if (flags[FLAG_DISABLE_Z]) {
+					/*
+					mat2 rotm;
+					";
+							rotm[0] = texelFetch(emission_texture_normal, emission_tex_ofs, 0).xy;
+					rotm[1] = rotm[0].yx * vec2(1.0, -1.0);
+					VELOCITY.xy = rotm * VELOCITY.xy;
+					*/
+				} else {
+					Vector3 normal = emission_normals.get(random_idx);
+					Vector3 v0 = Math::abs(normal.z) < 0.999 ? Vector3(0.0, 0.0, 1.0) : Vector3(0, 1.0, 0.0);
+					Vector3 tangent = v0.cross(normal).normalized();
+					Vector3 bitangent = tangent.cross(normal).normalized();
+					Basis m3;
+					m3.set_axis(0, tangent);
+					m3.set_axis(1, bitangent);
+					m3.set_axis(2, normal);
+					p.velocity = m3.xform(p.velocity);
 				}
 			}
 
-		} else if (local_delta > 0.0) {
-			if (restart_time >= prev_time) {
-				restart = true;
-				if (fractional_delta) {
-					local_delta = (1.0 - restart_time + time) * lifetime;
-				}
-
-			} else if (restart_time < time) {
-				restart = true;
-				if (fractional_delta) {
-					local_delta = (time - restart_time) * lifetime;
-				}
+			if (emission_colors.size() == pc) {
+				p.base_color = emission_colors.get(random_idx);
 			}
-		}
+		} break;
+	}
 
-		if (restart) {
+	if (!local_coords) {
+		p.velocity = p_velocity_xform.xform(p.velocity);
+		p.transform = p_emission_xform * p.transform;
+	}
 
-			if (!emitting) {
-				p.active = false;
-				continue;
-			}
-			p.active = true;
+	if (flags[FLAG_DISABLE_Z]) {
+		p.velocity.z = 0.0;
+		p.velocity.z = 0.0;
+	}
+}
 
-			/*float tex_linear_velocity = 0;
-			if (curve_parameters[PARAM_INITIAL_LINEAR_VELOCITY].is_valid()) {
-				tex_linear_velocity = curve_parameters[PARAM_INITIAL_LINEAR_VELOCITY]->interpolate(0);
-			}*/
+void CPUParticles::_particle_update(Particle &p, int p_index, const ProcessData &p_data) {
 
-			float tex_angle = 0.0;
-			if (curve_parameters[PARAM_ANGLE].is_valid()) {
-				tex_angle = curve_parameters[PARAM_ANGLE]->interpolate(0);
-			}
+	float local_delta = p_data.delta;
+	bool restart = _particle_restarts(p_index, p_data.count, p_data.prev_time, local_delta);
 
-			float tex_anim_offset = 0.0;
-			if (curve_parameters[PARAM_ANGLE].is_valid()) {
-				tex_anim_offset = curve_parameters[PARAM_ANGLE]->interpolate(0);
-			}
+	if (!p.active)
+		return; // inactive, or stopped by the emission pass
 
-			p.seed = Math::rand();
+	const Transform &emission_xform = p_data.emission_xform;
 
-			p.angle_rand = Math::randf();
-			p.scale_rand = Math::randf();
-			p.hue_rot_rand = Math::randf();
-			p.anim_offset_rand = Math::randf();
+	if (!restart) {
 
-			float angle1_rad;
-			float angle2_rad;
+		uint32_t alt_seed = p.seed;
 
-			if (flags[FLAG_DISABLE_Z]) {
+		p.time += local_delta;
+		p.custom[1] = p.time / lifetime;
 
-				angle1_rad = (Math::randf() * 2.0 - 1.0) * Math_PI * spread / 180.0;
-				Vector3 rot = Vector3(Math::cos(angle1_rad), Math::sin(angle1_rad), 0.0);
-				p.velocity = rot * parameters[PARAM_INITIAL_LINEAR_VELOCITY] * Math::lerp(1.0f, float(Math::randf()), randomness[PARAM_INITIAL_LINEAR_VELOCITY]);
+		float tex_linear_velocity = 0.0;
+		if (curve_parameters[PARAM_INITIAL_LINEAR_VELOCITY].is_valid()) {
+			tex_linear_velocity = curve_parameters[PARAM_INITIAL_LINEAR_VELOCITY]->interpolate(p.custom[1]);
+		}
+		/*
+		float tex_orbit_velocity = 0.0;
 
-			} else {
-				//initiate velocity spread in 3D
-				angle1_rad = (Math::randf() * 2.0 - 1.0) * Math_PI * spread / 180.0;
-				angle2_rad = (Math::randf() * 2.0 - 1.0) * (1.0 - flatness) * Math_PI * spread / 180.0;
-
-				Vector3 direction_xz = Vector3(Math::sin(angle1_rad), 0, Math::cos(angle1_rad));
-				Vector3 direction_yz = Vector3(0, Math::sin(angle2_rad), Math::cos(angle2_rad));
-				direction_yz.z = direction_yz.z / Math::sqrt(direction_yz.z); //better uniform distribution
-				Vector3 direction = Vector3(direction_xz.x * direction_yz.z, direction_yz.y, direction_xz.z * direction_yz.z);
-				direction.normalize();
-				p.velocity = direction * parameters[PARAM_INITIAL_LINEAR_VELOCITY] * Math::lerp(1.0f, float(Math::randf()), randomness[PARAM_INITIAL_LINEAR_VELOCITY]);
+		if (flags[FLAG_DISABLE_Z]) {
+
+			if (curve_parameters[PARAM_INITIAL_ORBIT_VELOCITY].is_valid()) {
+				tex_orbit_velocity = curve_parameters[PARAM_INITIAL_ORBIT_VELOCITY]->interpolate(p.custom[1]);
 			}
+		}
+*/
+		float tex_angular_velocity = 0.0;
+		if (curve_parameters[PARAM_ANGULAR_VELOCITY].is_valid()) {
+			tex_angular_velocity = curve_parameters[PARAM_ANGULAR_VELOCITY]->interpolate(p.custom[1]);
+		}
 
-			float base_angle = (parameters[PARAM_ANGLE] + tex_angle) * Math::lerp(1.0f, p.angle_rand, randomness[PARAM_ANGLE]);
-			p.custom[0] = Math::deg2rad(base_angle); //angle
-			p.custom[1] = 0.0; //phase
-			p.custom[2] = (parameters[PARAM_ANIM_OFFSET] + tex_anim_offset) * Math::lerp(1.0f, p.anim_offset_rand, randomness[PARAM_ANIM_OFFSET]); //animation offset (0-1)
-			p.transform = Transform();
-			p.time = 0;
-			p.base_color = Color(1, 1, 1, 1);
-
-			switch (emission_shape) {
-				case EMISSION_SHAPE_POINT: {
-					//do none
-				} break;
-				case EMISSION_SHAPE_SPHERE: {
-					p.transform.origin = Vector3(Math::randf() * 2.0 - 1.0, Math::randf() * 2.0 - 1.0, Math::randf() * 2.0 - 1.0).normalized() * emission_sphere_radius;
-				} break;
-				case EMISSION_SHAPE_BOX: {
-					p.transform.origin = Vector3(Math::randf() * 2.0 - 1.0, Math::randf() * 2.0 - 1.0, Math::randf() * 2.0 - 1.0) * emission_box_extents;
-				} break;
-				case EMISSION_SHAPE_POINTS:
-				case EMISSION_SHAPE_DIRECTED_POINTS: {
-
-					int pc = emission_points.size();
-					if (pc == 0)
-						break;
-
-					int random_idx = Math::rand() % pc;
-
-					p.transform.origin = emission_points.get(random_idx);
-
-					if (emission_shape == EMISSION_SHAPE_DIRECTED_POINTS && emission_normals.size() == pc) {
-						if (flags[FLAG_DISABLE_Z]) {
-							/*
-							mat2 rotm;
-							";
-									rotm[0] = texelFetch(emission_texture_normal, emission_tex_ofs, 0).xy;
-							rotm[1] = rotm[0].yx * vec2(1.0, -1.0);
-							VELOCITY.xy = rotm * VELOCITY.xy;
-							*/
-						} else {
-							Vector3 normal = emission_normals.get(random_idx);
-							Vector3 v0 = Math::abs(normal.z) < 0.999 ? Vector3(0.0, 0.0, 1.0) : Vector3(0, 1.0, 0.0);
-							Vector3 tangent = v0.cross(normal).normalized();
-							Vector3 bitangent = tangent.cross(normal).normalized();
-							Basis m3;
-							m3.set_axis(0, tangent);
-							m3.set_axis(1, bitangent);
-							m3.set_axis(2, normal);
-							p.velocity = m3.xform(p.velocity);
-						}
-					}
+		float tex_linear_accel = 0.0;
+		if (curve_parameters[PARAM_LINEAR_ACCEL].is_valid()) {
+			tex_linear_accel = curve_parameters[PARAM_LINEAR_ACCEL]->interpolate(p.custom[1]);
+		}
 
-					if (emission_colors.size() == pc) {
-						p.base_color = emission_colors.get(random_idx);
-					}
-				} break;
-			}
+		float tex_tangential_accel = 0.0;
+		if (curve_parameters[PARAM_TANGENTIAL_ACCEL].is_valid()) {
+			tex_tangential_accel = curve_parameters[PARAM_TANGENTIAL_ACCEL]->interpolate(p.custom[1]);
+		}
 
-			if (!local_coords) {
-				p.velocity = velocity_xform.xform(p.velocity);
-				p.transform = emission_xform * p.transform;
-			}
+		float tex_radial_accel = 0.0;
+		if (curve_parameters[PARAM_RADIAL_ACCEL].is_valid()) {
+			tex_radial_accel = curve_parameters[PARAM_RADIAL_ACCEL]->interpolate(p.custom[1]);
+		}
 
-			if (flags[FLAG_DISABLE_Z]) {
-				p.velocity.z = 0.0;
-				p.velocity.z = 0.0;
-			}
+		float tex_damping = 0.0;
+		if (curve_parameters[PARAM_DAMPING].is_valid()) {
+			tex_damping = curve_parameters[PARAM_DAMPING]->interpolate(p.custom[1]);
+		}
 
-		} else if (!p.active) {
-			continue;
-		} else {
+		float tex_angle = 0.0;
+		if (curve_parameters[PARAM_ANGLE].is_valid()) {
+			tex_angle = curve_parameters[PARAM_ANGLE]->interpolate(p.custom[1]);
+		}
+		float tex_anim_speed = 0.0;
+		if (curve_parameters[PARAM_ANIM_SPEED].is_valid()) {
+			tex_anim_speed = curve_parameters[PARAM_ANIM_SPEED]->interpolate(p.custom[1]);
+		}
 
-			uint32_t alt_seed = p.seed;
+		float tex_anim_offset = 0.0;
+		if (curve_parameters[PARAM_ANIM_OFFSET].is_valid()) {
+			tex_anim_offset = curve_parameters[PARAM_ANIM_OFFSET]->interpolate(p.custom[1]);
+		}
 
-			p.time += local_delta;
-			p.custom[1] = p.time / lifetime;
+		Vector3 force = gravity;
+		Vector3 pos = p.transform.origin;
+		if (flags[FLAG_DISABLE_Z]) {
+			pos.z = 0.0;
+		}
+		//apply linear acceleration
+		force += p.velocity.length() > 0.0 ? p.velocity.normalized() * (parameters[PARAM_LINEAR_ACCEL] + tex_linear_accel) * Math::lerp(1.0f, rand_from_seed(alt_seed), randomness[PARAM_LINEAR_ACCEL]) : Vector3();
+		//apply radial acceleration
+		Vector3 org = emission_xform.origin;
+		Vector3 diff = pos - org;
+		force += diff.length() > 0.0 ? diff.normalized() * (parameters[PARAM_RADIAL_ACCEL] + tex_radial_accel) * Math::lerp(1.0f, rand_from_seed(alt_seed), randomness[PARAM_RADIAL_ACCEL]) : Vector3();
+		//apply tangential acceleration;
+		if (flags[FLAG_DISABLE_Z]) {
 
-			float tex_linear_velocity = 0.0;
-			if (curve_parameters[PARAM_INITIAL_LINEAR_VELOCITY].is_valid()) {
-				tex_linear_velocity = curve_parameters[PARAM_INITIAL_LINEAR_VELOCITY]->interpolate(p.custom[1]);
-			}
-			/*
-			float tex_orbit_velocity = 0.0;
+			Vector3 yx = Vector3(diff.y, 0, diff.x);
+			force += yx.length() > 0.0 ? (yx * Vector3(-1.0, 0, 1.0)) * ((parameters[PARAM_TANGENTIAL_ACCEL] + tex_tangential_accel) * Math::lerp(1.0f, rand_from_seed(alt_seed), randomness[PARAM_TANGENTIAL_ACCEL])) : Vector3();
 
-			if (flags[FLAG_DISABLE_Z]) {
+		} else {
+			Vector3 crossDiff = diff.normalized().cross(gravity.normalized());
+			force += crossDiff.length() > 0.0 ? crossDiff.normalized() * ((parameters[PARAM_TANGENTIAL_ACCEL] + tex_tangential_accel) * Math::lerp(1.0f, rand_from_seed(alt_seed), randomness[PARAM_TANGENTIAL_ACCEL])) : Vector3();
+		}
+		//apply attractor forces
+		p.velocity += force * local_delta;
+		//orbit velocity
+#if 0
+		if (flags[FLAG_DISABLE_Z]) {
 
-				if (curve_parameters[PARAM_INITIAL_ORBIT_VELOCITY].is_valid()) {
-					tex_orbit_velocity = curve_parameters[PARAM_INITIAL_ORBIT_VELOCITY]->interpolate(p.custom[1]);
-				}
-			}
-*/
-			float tex_angular_velocity = 0.0;
-			if (curve_parameters[PARAM_ANGULAR_VELOCITY].is_valid()) {
-				tex_angular_velocity = curve_parameters[PARAM_ANGULAR_VELOCITY]->interpolate(p.custom[1]);
+			float orbit_amount = (orbit_velocity + tex_orbit_velocity) * mix(1.0, rand_from_seed(alt_seed), orbit_velocity_random);
+			if (orbit_amount != 0.0) {
+				float ang = orbit_amount * DELTA * pi * 2.0;
+				mat2 rot = mat2(vec2(cos(ang), -sin(ang)), vec2(sin(ang), cos(ang)));
+				TRANSFORM[3].xy -= diff.xy;
+				TRANSFORM[3].xy += rot * diff.xy;
 			}
+		}
+#endif
+		if (curve_parameters[PARAM_INITIAL_LINEAR_VELOCITY].is_valid()) {
+			p.velocity = p.velocity.normalized() * tex_linear_velocity;
+		}
+		if (parameters[PARAM_DAMPING] + tex_damping > 0.0) {
 
-			float tex_linear_accel = 0.0;
-			if (curve_parameters[PARAM_LINEAR_ACCEL].is_valid()) {
-				tex_linear_accel = curve_parameters[PARAM_LINEAR_ACCEL]->interpolate(p.custom[1]);
+			float v = p.velocity.length();
+			float damp = (parameters[PARAM_DAMPING] + tex_damping) * Math::lerp(1.0f, rand_from_seed(alt_seed), randomness[PARAM_DAMPING]);
+			v -= damp * local_delta;
+			if (v < 0.0) {
+				p.velocity = Vector3();
+			} else {
+				p.velocity = p.velocity.normalized() * v;
 			}
+		}
+		float base_angle = (parameters[PARAM_ANGLE] + tex_angle) * Math::lerp(1.0f, p.angle_rand, randomness[PARAM_ANGLE]);
+		base_angle += p.custom[1] * lifetime * (parameters[PARAM_ANGULAR_VELOCITY] + tex_angular_velocity) * Math::lerp(1.0f, rand_from_seed(alt_seed) * 2.0f - 1.0f, randomness[PARAM_ANGULAR_VELOCITY]);
+		p.custom[0] = Math::deg2rad(base_angle); //angle
+		p.custom[2] = (parameters[PARAM_ANIM_OFFSET] + tex_anim_offset) * Math::lerp(1.0f, p.anim_offset_rand, randomness[PARAM_ANIM_OFFSET]) + p.custom[1] * (parameters[PARAM_ANIM_SPEED] + tex_anim_speed) * Math::lerp(1.0f, rand_from_seed(alt_seed), randomness[PARAM_ANIM_SPEED]); //angle
+		if (flags[FLAG_ANIM_LOOP]) {
+			p.custom[2] = Math::fmod(p.custom[2], 1.0f); //loop
 
-			float tex_tangential_accel = 0.0;
-			if (curve_parameters[PARAM_TANGENTIAL_ACCEL].is_valid()) {
-				tex_tangential_accel = curve_parameters[PARAM_TANGENTIAL_ACCEL]->interpolate(p.custom[1]);
-			}
+		} else {
+			p.custom[2] = CLAMP(p.custom[2], 0.0f, 1.0); //0 to 1 only
+		}
+	}
+	//apply color
+	//apply hue rotation
 
-			float tex_radial_accel = 0.0;
-			if (curve_parameters[PARAM_RADIAL_ACCEL].is_valid()) {
-				tex_radial_accel = curve_parameters[PARAM_RADIAL_ACCEL]->interpolate(p.custom[1]);
-			}
+	float tex_scale = 1.0;
+	if (curve_parameters[PARAM_SCALE].is_valid()) {
+		tex_scale = curve_parameters[PARAM_SCALE]->interpolate(p.custom[1]);
+	}
 
-			float tex_damping = 0.0;
-			if (curve_parameters[PARAM_DAMPING].is_valid()) {
-				tex_damping = curve_parameters[PARAM_DAMPING]->interpolate(p.custom[1]);
-			}
+	float tex_hue_variation = 0.0;
+	if (curve_parameters[PARAM_HUE_VARIATION].is_valid()) {
+		tex_hue_variation = curve_parameters[PARAM_HUE_VARIATION]->interpolate(p.custom[1]);
+	}
 
-			float tex_angle = 0.0;
-			if (curve_parameters[PARAM_ANGLE].is_valid()) {
-				tex_angle = curve_parameters[PARAM_ANGLE]->interpolate(p.custom[1]);
-			}
-			float tex_anim_speed = 0.0;
-			if (curve_parameters[PARAM_ANIM_SPEED].is_valid()) {
-				tex_anim_speed = curve_parameters[PARAM_ANIM_SPEED]->interpolate(p.custom[1]);
-			}
+	float hue_rot_angle = (parameters[PARAM_HUE_VARIATION] + tex_hue_variation) * Math_PI * 2.0 * Math::lerp(1.0f, p.hue_rot_rand * 2.0f - 1.0f, randomness[PARAM_HUE_VARIATION]);
+	float hue_rot_c = Math::cos(hue_rot_angle);
+	float hue_rot_s = Math::sin(hue_rot_angle);
 
-			float tex_anim_offset = 0.0;
-			if (curve_parameters[PARAM_ANIM_OFFSET].is_valid()) {
-				tex_anim_offset = curve_parameters[PARAM_ANIM_OFFSET]->interpolate(p.custom[1]);
-			}
+	Basis hue_rot_mat;
+	{
+		Basis mat1(0.299, 0.587, 0.114, 0.299, 0.587, 0.114, 0.299, 0.587, 0.114);
+		Basis mat2(0.701, -0.587, -0.114, -0.299, 0.413, -0.114, -0.300, -0.588, 0.886);
+		Basis mat3(0.168, 0.330, -0.497, -0.328, 0.035, 0.292, 1.250, -1.050, -0.203);
 
-			Vector3 force = gravity;
-			Vector3 pos = p.transform.origin;
-			if (flags[FLAG_DISABLE_Z]) {
-				pos.z = 0.0;
-			}
-			//apply linear acceleration
-			force += p.velocity.length() > 0.0 ? p.velocity.normalized() * (parameters[PARAM_LINEAR_ACCEL] + tex_linear_accel) * Math::lerp(1.0f, rand_from_seed(alt_seed), randomness[PARAM_LINEAR_ACCEL]) : Vector3();
-			//apply radial acceleration
-			Vector3 org = emission_xform.origin;
-			Vector3 diff = pos - org;
-			force += diff.length() > 0.0 ? diff.normalized() * (parameters[PARAM_RADIAL_ACCEL] + tex_radial_accel) * Math::lerp(1.0f, rand_from_seed(alt_seed), randomness[PARAM_RADIAL_ACCEL]) : Vector3();
-			//apply tangential acceleration;
-			if (flags[FLAG_DISABLE_Z]) {
-
-				Vector3 yx = Vector3(diff.y, 0, diff.x);
-				force += yx.length() > 0.0 ? (yx * Vector3(-1.0, 0, 1.0)) * ((parameters[PARAM_TANGENTIAL_ACCEL] + tex_tangential_accel) * Math::lerp(1.0f, rand_from_seed(alt_seed), randomness[PARAM_TANGENTIAL_ACCEL])) : Vector3();
+		for (int j = 0; j < 3; j++) {
+			hue_rot_mat[j] = mat1[j] + mat2[j] * hue_rot_c + mat3[j] * hue_rot_s;
+		}
+	}
+
+	if (color_ramp.is_valid()) {
+		p.color = color_ramp->get_color_at_offset(p.custom[1]) * color;
+	} else {
+		p.color = color;
+	}
+
+	Vector3 color_rgb = hue_rot_mat.xform_inv(Vector3(p.color.r, p.color.g, p.color.b));
+	p.color.r = color_rgb.x;
+	p.color.g = color_rgb.y;
+	p.color.b = color_rgb.z;
+
+	p.color *= p.base_color;
+
+	if (flags[FLAG_DISABLE_Z]) {
 
+		if (flags[FLAG_ALIGN_Y_TO_VELOCITY]) {
+			if (p.velocity.length() > 0.0) {
+				p.transform.basis.set_axis(1, p.velocity.normalized());
 			} else {
-				Vector3 crossDiff = diff.normalized().cross(gravity.normalized());
-				force += crossDiff.length() > 0.0 ? crossDiff.normalized() * ((parameters[PARAM_TANGENTIAL_ACCEL] + tex_tangential_accel) * Math::lerp(1.0f, rand_from_seed(alt_seed), randomness[PARAM_TANGENTIAL_ACCEL])) : Vector3();
-			}
-			//apply attractor forces
-			p.velocity += force * local_delta;
-			//orbit velocity
-#if 0
-			if (flags[FLAG_DISABLE_Z]) {
-
-				float orbit_amount = (orbit_velocity + tex_orbit_velocity) * mix(1.0, rand_from_seed(alt_seed), orbit_velocity_random);
-				if (orbit_amount != 0.0) {
-					float ang = orbit_amount * DELTA * pi * 2.0;
-					mat2 rot = mat2(vec2(cos(ang), -sin(ang)), vec2(sin(ang), cos(ang)));
-					TRANSFORM[3].xy -= diff.xy;
-					TRANSFORM[3].xy += rot * diff.xy;
-				}
+				p.transform.basis.set_axis(1, p.transform.basis.get_axis(1));
 			}
-#endif
-			if (curve_parameters[PARAM_INITIAL_LINEAR_VELOCITY].is_valid()) {
-				p.velocity = p.velocity.normalized() * tex_linear_velocity;
-			}
-			if (parameters[PARAM_DAMPING] + tex_damping > 0.0) {
+			p.transform.basis.set_axis(0, p.transform.basis.get_axis(1).cross(p.transform.basis.get_axis(2)).normalized());
+			p.transform.basis.set_axis(2, Vector3(0, 0, 1));
 
-				float v = p.velocity.length();
-				float damp = (parameters[PARAM_DAMPING] + tex_damping) * Math::lerp(1.0f, rand_from_seed(alt_seed), randomness[PARAM_DAMPING]);
-				v -= damp * local_delta;
-				if (v < 0.0) {
-					p.velocity = Vector3();
-				} else {
-					p.velocity = p.velocity.normalized() * v;
-				}
-			}
-			float base_angle = (parameters[PARAM_ANGLE] + tex_angle) * Math::lerp(1.0f, p.angle_rand, randomness[PARAM_ANGLE]);
-			base_angle += p.custom[1] * lifetime * (parameters[PARAM_ANGULAR_VELOCITY] + tex_angular_velocity) * Math::lerp(1.0f, rand_from_seed(alt_seed) * 2.0f - 1.0f, randomness[PARAM_ANGULAR_VELOCITY]);
-			p.custom[0] = Math::deg2rad(base_angle); //angle
-			p.custom[2] = (parameters[PARAM_ANIM_OFFSET] + tex_anim_offset) * Math::lerp(1.0f, p.anim_offset_rand, randomness[PARAM_ANIM_OFFSET]) + p.custom[1] * (parameters[PARAM_ANIM_SPEED] + tex_anim_speed) * Math::lerp(1.0f, rand_from_seed(alt_seed), randomness[PARAM_ANIM_SPEED]); //angle
-			if (flags[FLAG_ANIM_LOOP]) {
-				p.custom[2] = Math::fmod(p.custom[2], 1.0f); //loop
+		} else {
+			p.transform.basis.set_axis(0, Vector3(Math::cos(p.custom[0]), -Math::sin(p.custom[0]), 0.0));
+			p.transform.basis.set_axis(1, Vector3(Math::sin(p.custom[0]), Math::cos(p.custom[0]), 0.0));
+			p.transform.basis.set_axis(2, Vector3(0, 0, 1));
+		}
 
+	} else {
+		//orient particle Y towards velocity
+		if (flags[FLAG_ALIGN_Y_TO_VELOCITY]) {
+			if (p.velocity.length() > 0.0) {
+				p.transform.basis.set_axis(1, p.velocity.normalized());
 			} else {
-				p.custom[2] = CLAMP(p.custom[2], 0.0f, 1.0); //0 to 1 only
+				p.transform.basis.set_axis(1, p.transform.basis.get_axis(1).normalized());
 			}
+			if (p.transform.basis.get_axis(1) == p.transform.basis.get_axis(0)) {
+				p.transform.basis.set_axis(0, p.transform.basis.get_axis(1).cross(p.transform.basis.get_axis(2)).normalized());
+				p.transform.basis.set_axis(2, p.transform.basis.get_axis(0).cross(p.transform.basis.get_axis(1)).normalized());
+			} else {
+				p.transform.basis.set_axis(2, p.transform.basis.get_axis(0).cross(p.transform.basis.get_axis(1)).normalized());
+				p.transform.basis.set_axis(0, p.transform.basis.get_axis(1).cross(p.transform.basis.get_axis(2)).normalized());
+			}
+		} else {
+			p.transform.basis.orthonormalize();
 		}
-		//apply color
-		//apply hue rotation
 
-		float tex_scale = 1.0;
-		if (curve_parameters[PARAM_SCALE].is_valid()) {
-			tex_scale = curve_parameters[PARAM_SCALE]->interpolate(p.custom[1]);
+		//turn particle by rotation in Y
+		if (flags[FLAG_ROTATE_Y]) {
+			Basis rot_y(Vector3(0, 1, 0), p.custom[0]);
+			p.transform.basis = p.transform.basis * rot_y;
 		}
+	}
 
-		float tex_hue_variation = 0.0;
-		if (curve_parameters[PARAM_HUE_VARIATION].is_valid()) {
-			tex_hue_variation = curve_parameters[PARAM_HUE_VARIATION]->interpolate(p.custom[1]);
-		}
+	//scale by scale
+	float base_scale = Math::lerp(parameters[PARAM_SCALE] * tex_scale, 1.0f, p.scale_rand * randomness[PARAM_SCALE]);
+	if (base_scale == 0.0) base_scale = 0.000001;
 
-		float hue_rot_angle = (parameters[PARAM_HUE_VARIATION] + tex_hue_variation) * Math_PI * 2.0 * Math::lerp(1.0f, p.hue_rot_rand * 2.0f - 1.0f, randomness[PARAM_HUE_VARIATION]);
-		float hue_rot_c = Math::cos(hue_rot_angle);
-		float hue_rot_s = Math::sin(hue_rot_angle);
+	p.transform.basis.scale(Vector3(1, 1, 1) * base_scale);
 
-		Basis hue_rot_mat;
-		{
-			Basis mat1(0.299, 0.587, 0.114, 0.299, 0.587, 0.114, 0.299, 0.587, 0.114);
-			Basis mat2(0.701, -0.587, -0.114, -0.299, 0.413, -0.114, -0.300, -0.588, 0.886);
-			Basis mat3(0.168, 0.330, -0.497, -0.328, 0.035, 0.292, 1.250, -1.050, -0.203);
+	if (flags[FLAG_DISABLE_Z]) {
+		p.velocity.z = 0.0;
+		p.transform.origin.z = 0.0;
+	}
 
-			for (int j = 0; j < 3; j++) {
-				hue_rot_mat[j] = mat1[j] + mat2[j] * hue_rot_c + mat3[j] * hue_rot_s;
-			}
+	p.transform.origin += p.velocity * local_delta;
+}
+
+void CPUParticles::_particles_process_chunk(uint32_t p_chunk, ProcessData *p_data) {
+
+	int from = p_chunk * CPU_PARTICLES_CHUNK_SIZE;
+	int to = MIN(from + CPU_PARTICLES_CHUNK_SIZE, p_data->count);
+
+	for (int i = from; i < to; i++) {
+
+		Particle &p = p_data->particles[i];
+		_particle_update(p, i, *p_data);
+
+		if (p_data->buffer) {
+			_write_particle_data(p, p_data->un_transform, &p_data->buffer[i * 17]);
 		}
+	}
+}
 
-		if (color_ramp.is_valid()) {
-			p.color = color_ramp->get_color_at_offset(p.custom[1]) * color;
-		} else {
-			p.color = color;
+void CPUParticles::_particles_process(float p_delta, bool p_update_buffer) {
+
+	p_delta *= speed_scale;
+
+	int pcount = particles.size();
+	PoolVector<Particle>::Write w = particles.write();
+
+	Particle *parray = w.ptr();
+
+	float prev_time = time;
+	time += p_delta;
+	if (time > lifetime) {
+		time = Math::fmod(time, lifetime);
+		cycle++;
+		if (one_shot && cycle > 0) {
+			emitting = false;
 		}
+	}
 
-		Vector3 color_rgb = hue_rot_mat.xform_inv(Vector3(p.color.r, p.color.g, p.color.b));
-		p.color.r = color_rgb.x;
-		p.color.g = color_rgb.y;
-		p.color.b = color_rgb.z;
+	Transform emission_xform;
+	Basis velocity_xform;
+	if (!local_coords) {
+		emission_xform = get_global_transform();
+		velocity_xform = emission_xform.basis.inverse().transposed();
+	}
 
-		p.color *= p.base_color;
+	ProcessData data;
+	data.particles = parray;
+	data.count = pcount;
+	data.delta = p_delta;
+	data.prev_time = prev_time;
+	data.emission_xform = emission_xform;
+	data.buffer = NULL;
 
-		if (flags[FLAG_DISABLE_Z]) {
+	// emitting draws from the global random generator, so it stays on this thread and in order
+	for (int i = 0; i < pcount; i++) {
 
-			if (flags[FLAG_ALIGN_Y_TO_VELOCITY]) {
-				if (p.velocity.length() > 0.0) {
-					p.transform.basis.set_axis(1, p.velocity.normalized());
-				} else {
-					p.transform.basis.set_axis(1, p.transform.basis.get_axis(1));
-				}
-				p.transform.basis.set_axis(0, p.transform.basis.get_axis(1).cross(p.transform.basis.get_axis(2)).normalized());
-				p.transform.basis.set_axis(2, Vector3(0, 0, 1));
+		Particle &p = parray[i];
 
-			} else {
-				p.transform.basis.set_axis(0, Vector3(Math::cos(p.custom[0]), -Math::sin(p.custom[0]), 0.0));
-				p.transform.basis.set_axis(1, Vector3(Math::sin(p.custom[0]), Math::cos(p.custom[0]), 0.0));
-				p.transform.basis.set_axis(2, Vector3(0, 0, 1));
-			}
+		if (!emitting && !p.active)
+			continue;
 
-		} else {
-			//orient particle Y towards velocity
-			if (flags[FLAG_ALIGN_Y_TO_VELOCITY]) {
-				if (p.velocity.length() > 0.0) {
-					p.transform.basis.set_axis(1, p.velocity.normalized());
-				} else {
-					p.transform.basis.set_axis(1, p.transform.basis.get_axis(1).normalized());
-				}
-				if (p.transform.basis.get_axis(1) == p.transform.basis.get_axis(0)) {
-					p.transform.basis.set_axis(0, p.transform.basis.get_axis(1).cross(p.transform.basis.get_axis(2)).normalized());
-					p.transform.basis.set_axis(2, p.transform.basis.get_axis(0).cross(p.transform.basis.get_axis(1)).normalized());
-				} else {
-					p.transform.basis.set_axis(2, p.transform.basis.get_axis(0).cross(p.transform.basis.get_axis(1)).normalized());
-					p.transform.basis.set_axis(0, p.transform.basis.get_axis(1).cross(p.transform.basis.get_axis(2)).normalized());
-				}
-			} else {
-				p.transform.basis.orthonormalize();
-			}
+		float local_delta = p_delta;
+		if (!_particle_restarts(i, pcount, prev_time, local_delta))
+			continue;
 
-			//turn particle by rotation in Y
-			if (flags[FLAG_ROTATE_Y]) {
-				Basis rot_y(Vector3(0, 1, 0), p.custom[0]);
-				p.transform.basis = p.transform.basis * rot_y;
-			}
+		if (!emitting) {
+			p.active = false;
+			continue;
 		}
+		p.active = true;
 
-		//scale by scale
-		float base_scale = Math::lerp(parameters[PARAM_SCALE] * tex_scale, 1.0f, p.scale_rand * randomness[PARAM_SCALE]);
-		if (base_scale == 0.0) base_scale = 0.000001;
+		_particle_emit(p, emission_xform, velocity_xform);
+	}
 
-		p.transform.basis.scale(Vector3(1, 1, 1) * base_scale);
+	if (color_ramp.is_valid()) {
+		color_ramp->get_color_at_offset(0.0); // sorts the ramp before it is read from several threads
+	}
 
-		if (flags[FLAG_DISABLE_Z]) {
-			p.velocity.z = 0.0;
-			p.transform.origin.z = 0.0;
+	// with index draw order, instances are written straight into the multimesh data
+	PoolVector<float>::Write buffer_write;
+	if (p_update_buffer) {
+#ifndef NO_THREADS
+		update_mutex->lock();
+#endif
+		buffer_write = particle_data.write();
+		data.buffer = buffer_write.ptr();
+		if (!local_coords) {
+			data.un_transform = get_global_transform().affine_inverse();
 		}
+	}
 
-		p.transform.origin += p.velocity * local_delta;
+	int chunk_count = (pcount + CPU_PARTICLES_CHUNK_SIZE - 1) / CPU_PARTICLES_CHUNK_SIZE;
+	if (pcount >= CPU_PARTICLES_PARALLEL_MIN_AMOUNT) {
+		thread_process_array(chunk_count, this, &CPUParticles::_particles_process_chunk, &data);
+	} else {
+		for (int i = 0; i < chunk_count; i++) {
+			_particles_process_chunk(i, &data);
+		}
+	}
+
+	if (p_update_buffer) {
+		buffer_write = PoolVector<float>::Write();
+#ifndef NO_THREADS
+		update_mutex->unlock();
+#endif
 	}
 }
 
+void CPUParticles::_write_particle_data(const Particle &p, const Transform &p_un_transform, float *ptr) const {
+
+	Transform t = p.transform;
+
+	if (!local_coords) {
+		t = p_un_transform * t;
+	}
+
+	if (p.active) {
+		ptr[0] = t.basis.elements[0][0];
+		ptr[1] = t.basis.elements[0][1];
+		ptr[2] = t.basis.elements[0][2];
+		ptr[3] = t.origin.x;
+		ptr[4] = t.basis.elements[1][0];
+		ptr[5] = t.basis.elements[1][1];
+		ptr[6] = t.basis.elements[1][2];
+		ptr[7] = t.origin.y;
+		ptr[8] = t.basis.elements[2][0];
+		ptr[9] = t.basis.elements[2][1];
+		ptr[10] = t.basis.elements[2][2];
+		ptr[11] = t.origin.z;
+	} else {
+		zeromem(ptr, sizeof(float) * 12);
+	}
+
+	Color c = p.color;
+	uint8_t *data8 = (uint8_t *)&ptr[12];
+	data8[0] = CLAMP(c.r * 255.0, 0, 255);
+	data8[1] = CLAMP(c.g * 255.0, 0, 255);
+	data8[2] = CLAMP(c.b * 255.0, 0, 255);
+	data8[3] = CLAMP(c.a * 255.0, 0, 255);
+
+	ptr[13] = p.custom[0];
+	ptr[14] = p.custom[1];
+	ptr[15] = p.custom[2];
+	ptr[16] = p.custom[3];
+}
+
 void CPUParticles::_update_particle_data_buffer() {
 #ifndef NO_THREADS
 	update_mutex->lock();
@@ -943,42 +1064,7 @@ void CPUParticles::_update_particle_data_buffer() {
 		for (int i = 0; i < pc; i++) {
 
 			int idx = order ? order[i] : i;
-
-			Transform t = r[idx].transform;
-
-			if (!local_coords) {
-				t = un_transform * t;
-			}
-
-			if (r[idx].active) {
-				ptr[0] = t.basis.elements[0][0];
-				ptr[1] = t.basis.elements[0][1];
-				ptr[2] = t.basis.elements[0][2];
-				ptr[3] = t.origin.x;
-				ptr[4] = t.basis.elements[1][0];
-				ptr[5] = t.basis.elements[1][1];
-				ptr[6] = t.basis.elements[1][2];
-				ptr[7] = t.origin.y;
-				ptr[8] = t.basis.elements[2][0];
-				ptr[9] = t.basis.elements[2][1];
-				ptr[10] = t.basis.elements[2][2];
-				ptr[11] = t.origin.z;
-			} else {
-				zeromem(ptr, sizeof(float) * 12);
-			}
-
-			Color c = r[idx].color;
-			uint8_t *data8 = (uint8_t *)&ptr[12];
-			data8[0] = CLAMP(c.r * 255.0, 0, 255);
-			data8[1] = CLAMP(c.g * 255.0, 0, 255);
-			data8[2] = CLAMP(c.b * 255.0, 0, 255);
-			data8[3] = CLAMP(c.a * 255.0, 0, 255);
-
-			ptr[13] = r[idx].custom[0];
-			ptr[14] = r[idx].custom[1];
-			ptr[15] = r[idx].custom[2];
-			ptr[16] = r[idx].custom[3];
-
+			_write_particle_data(r[idx], un_transform, ptr);
 			ptr += 17;
 		}
 	}
@@ -1076,11 +1162,15 @@ void CPUParticles::_notification(int p_what) {
 			float todo = pre_process_time;
 
 			while (todo >= 0) {
-				_particles_process(frame_time);
+				_particles_process(frame_time, false);
 				todo -= frame_time;
 			}
 		}
 
+		// with index draw order the last simulation step writes the multimesh data itself
+		bool direct_buffer = draw_order == DRAW_ORDER_INDEX;
+		bool buffer_updated = false;
+
 		if (fixed_fps > 0) {
 			float frame_time = 1.0 / fixed_fps;
 			float decr = frame_time;
@@ -1094,17 +1184,21 @@ void CPUParticles::_notification(int p_what) {
 			float todo = frame_remainder + ldelta;
 
 			while (todo >= frame_time) {
-				_particles_process(frame_time);
 				todo -= decr;
+				buffer_updated = direct_buffer && todo < frame_time;
+				_particles_process(frame_time, buffer_updated);
 			}
 
 			frame_remainder = todo;
 
 		} else {
-			_particles_process(delta);
+			_particles_process(delta, direct_buffer);
+			buffer_updated = direct_buffer;
 		}
 
-		_update_particle_data_buffer();
+		if (!buffer_updated) {
+			_update_particle_data_buffer();
+		}
 	}
 }
 
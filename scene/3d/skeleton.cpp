@@ -32,10 +32,16 @@
 
 #include "core/message_queue.h"
 
+#include "core/os/threaded_array_processor.h"
 #include "core/project_settings.h"
 #include "scene/3d/physics_body.h"
 #include "scene/resources/surface_tool.h"
 
+// below this amount of bones in a batch, spawning threads costs more than it saves
+#define SKELETON_PARALLEL_UPDATE_MIN_BONES 4096
+
+SelfList<Skeleton>::List Skeleton::update_list;
+
 bool Skeleton::_set(const StringName &p_path, const Variant &p_value) {
 
 	String path = p_path;
@@ -207,6 +213,9 @@ void Skeleton::_notification(int p_what) {
 		} break;
 		case NOTIFICATION_EXIT_WORLD: {
 
+			if (update_item.in_list())
+				update_list.remove(&update_item); // updated again when entering
+
 		} break;
 		case NOTIFICATION_TRANSFORM_CHANGED: {
 
@@ -214,134 +223,202 @@ void Skeleton::_notification(int p_what) {
 				break; //will be eventually updated
 
 			//if moved, just update transforms
-			VisualServer *vs = VisualServer::get_singleton();
-			const Bone *bonesptr = bones.ptr();
-			int len = bones.size();
-			Transform global_transform = get_global_transform();
-			Transform global_transform_inverse = global_transform.affine_inverse();
+			_update_begin();
+			_update_bulk_array();
+			_update_end(false);
+		} break;
+		case NOTIFICATION_UPDATE_SKELETON: {
+
+			if (!dirty)
+				break; // already updated along with other skeletons
 
-			for (int i = 0; i < len; i++) {
+			if (!update_item.in_list()) {
+				_update_skeleton();
+				break;
+			}
 
-				const Bone &b = bonesptr[i];
-				vs->skeleton_bone_set_transform(skeleton, i, global_transform * (b.transform_final * global_transform_inverse));
+			// every dirty skeleton has this notification queued, the first one to
+			// receive it updates all of them so poses can be evaluated in parallel
+			Vector<Skeleton *> batch;
+			for (SelfList<Skeleton> *E = update_list.first(); E; E = E->next()) {
+				batch.push_back(E->self());
 			}
+
+			_update_skeletons(batch.ptrw(), batch.size());
 		} break;
-		case NOTIFICATION_UPDATE_SKELETON: {
+	}
+}
+
+void Skeleton::_update_begin() {
+
+	if (update_item.in_list())
+		update_list.remove(&update_item);
 
-			VisualServer *vs = VisualServer::get_singleton();
-			Bone *bonesptr = bones.ptrw();
-			int len = bones.size();
+	VisualServer::get_singleton()->skeleton_allocate(skeleton, bones.size()); // if same size, nothin really happens
 
-			vs->skeleton_allocate(skeleton, len); // if same size, nothin really happens
+	_update_process_order();
 
-			_update_process_order();
+	update_global_transform = is_inside_tree() ? get_global_transform() : Transform();
 
-			const int *order = process_order.ptr();
+	bone_bulk_array.resize(bones.size() * 12);
+	bone_bulk_write = bone_bulk_array.write();
+}
 
-			// pose changed, rebuild cache of inverses
-			if (rest_global_inverse_dirty) {
+void Skeleton::_update_pose() {
 
-				// calculate global rests and invert them
-				for (int i = 0; i < len; i++) {
-					Bone &b = bonesptr[order[i]];
-					if (b.parent >= 0)
-						b.rest_global_inverse = bonesptr[b.parent].rest_global_inverse * b.rest;
-					else
-						b.rest_global_inverse = b.rest;
-				}
-				for (int i = 0; i < len; i++) {
-					Bone &b = bonesptr[order[i]];
-					b.rest_global_inverse.affine_invert();
-				}
+	// only touches this skeleton's own data, so it can run on any thread
 
-				rest_global_inverse_dirty = false;
-			}
+	const Bone *bonesptr = bones.ptr();
+	const int *order = process_order.ptr();
+	int len = bones.size();
+
+	const Transform *rests = bone_rests.ptr();
+	const Transform *poses = bone_poses.ptr();
+	const Transform *custom_poses = bone_custom_poses.ptr();
+	Transform *rests_global_inverse = bone_rests_global_inverse.ptrw();
+	Transform *poses_global = bone_poses_global.ptrw();
+	Transform *transforms_final = bone_transforms_final.ptrw();
+
+	// pose changed, rebuild cache of inverses
+	if (rest_global_inverse_dirty) {
+
+		// calculate global rests and invert them
+		for (int i = 0; i < len; i++) {
+			int idx = order[i];
+			int parent = bonesptr[idx].parent;
+			if (parent >= 0)
+				rests_global_inverse[idx] = rests_global_inverse[parent] * rests[idx];
+			else
+				rests_global_inverse[idx] = rests[idx];
+		}
+		for (int i = 0; i < len; i++) {
+			rests_global_inverse[order[i]].affine_invert();
+		}
+
+		rest_global_inverse_dirty = false;
+	}
+
+	for (int i = 0; i < len; i++) {
 
-			Transform global_transform = get_global_transform();
-			Transform global_transform_inverse = global_transform.affine_inverse();
+		int idx = order[i];
+		const Bone &b = bonesptr[idx];
 
-			for (int i = 0; i < len; i++) {
+		Transform pose;
+		if (b.enabled) {
 
-				Bone &b = bonesptr[order[i]];
+			pose = b.custom_pose_enable ? custom_poses[idx] * poses[idx] : poses[idx];
+			if (!b.disable_rest)
+				pose = rests[idx] * pose;
+		} else if (!b.disable_rest) {
 
-				if (b.disable_rest) {
-					if (b.enabled) {
+			pose = rests[idx];
+		}
 
-						Transform pose = b.pose;
-						if (b.custom_pose_enable) {
+		if (b.parent >= 0)
+			poses_global[idx] = poses_global[b.parent] * pose;
+		else
+			poses_global[idx] = pose;
 
-							pose = b.custom_pose * pose;
-						}
+		transforms_final[idx] = poses_global[idx] * rests_global_inverse[idx];
+	}
 
-						if (b.parent >= 0) {
+	_update_bulk_array();
+}
 
-							b.pose_global = bonesptr[b.parent].pose_global * pose;
-						} else {
+void Skeleton::_update_bulk_array() {
 
-							b.pose_global = pose;
-						}
-					} else {
+	const Transform *transforms_final = bone_transforms_final.ptr();
+	float *w = bone_bulk_write.ptr();
+	int len = bones.size();
+
+	Transform global_transform = update_global_transform;
+	Transform global_transform_inverse = global_transform.affine_inverse();
 
-						if (b.parent >= 0) {
+	for (int i = 0; i < len; i++) {
 
-							b.pose_global = bonesptr[b.parent].pose_global;
-						} else {
+		Transform t = global_transform * (transforms_final[i] * global_transform_inverse);
+
+		w[0] = t.basis[0].x;
+		w[1] = t.basis[0].y;
+		w[2] = t.basis[0].z;
+		w[3] = t.origin.x;
+		w[4] = t.basis[1].x;
+		w[5] = t.basis[1].y;
+		w[6] = t.basis[1].z;
+		w[7] = t.origin.y;
+		w[8] = t.basis[2].x;
+		w[9] = t.basis[2].y;
+		w[10] = t.basis[2].z;
+		w[11] = t.origin.z;
+		w += 12;
+	}
+}
 
-							b.pose_global = Transform();
-						}
-					}
+void Skeleton::_update_end(bool p_pose_changed) {
 
-				} else {
-					if (b.enabled) {
+	bone_bulk_write = PoolVector<float>::Write();
+	VisualServer::get_singleton()->skeleton_set_as_bulk_array(skeleton, bone_bulk_array);
 
-						Transform pose = b.pose;
-						if (b.custom_pose_enable) {
+	if (!p_pose_changed)
+		return;
 
-							pose = b.custom_pose * pose;
-						}
+	const Bone *bonesptr = bones.ptr();
+	const Transform *poses_global = bone_poses_global.ptr();
+	int len = bones.size();
 
-						if (b.parent >= 0) {
+	for (int i = 0; i < len; i++) {
 
-							b.pose_global = bonesptr[b.parent].pose_global * (b.rest * pose);
-						} else {
+		for (const List<uint32_t>::Element *E = bonesptr[i].nodes_bound.front(); E; E = E->next()) {
 
-							b.pose_global = b.rest * pose;
-						}
-					} else {
+			Object *obj = ObjectDB::get_instance(E->get());
+			ERR_CONTINUE(!obj);
+			Spatial *sp = Object::cast_to<Spatial>(obj);
+			ERR_CONTINUE(!sp);
+			sp->set_transform(poses_global[i]);
+		}
+	}
 
-						if (b.parent >= 0) {
+	dirty = false;
+}
 
-							b.pose_global = bonesptr[b.parent].pose_global * b.rest;
-						} else {
+void Skeleton::_update_pose_batched(uint32_t p_index, Skeleton **p_batch) {
 
-							b.pose_global = b.rest;
-						}
-					}
-				}
+	p_batch[p_index]->_update_pose();
+}
 
-				b.transform_final = b.pose_global * b.rest_global_inverse;
-				vs->skeleton_bone_set_transform(skeleton, i, global_transform * (b.transform_final * global_transform_inverse));
+void Skeleton::_update_skeletons(Skeleton **p_skeletons, int p_count) {
 
-				for (List<uint32_t>::Element *E = b.nodes_bound.front(); E; E = E->next()) {
+	// gathering and uploading touch the scene and servers, so they stay on the main thread
+	int bone_count = 0;
+	for (int i = 0; i < p_count; i++) {
+		p_skeletons[i]->_update_begin();
+		bone_count += p_skeletons[i]->bones.size();
+	}
 
-					Object *obj = ObjectDB::get_instance(E->get());
-					ERR_CONTINUE(!obj);
-					Spatial *sp = Object::cast_to<Spatial>(obj);
-					ERR_CONTINUE(!sp);
-					sp->set_transform(b.pose_global);
-				}
-			}
+	if (p_count > 1 && bone_count >= SKELETON_PARALLEL_UPDATE_MIN_BONES) {
+		thread_process_array(p_count, p_skeletons[0], &Skeleton::_update_pose_batched, p_skeletons);
+	} else {
+		for (int i = 0; i < p_count; i++) {
+			p_skeletons[i]->_update_pose();
+		}
+	}
 
-			dirty = false;
-		} break;
+	for (int i = 0; i < p_count; i++) {
+		p_skeletons[i]->_update_end(true);
 	}
 }
 
+void Skeleton::_update_skeleton() {
+
+	Skeleton *skeleton = this;
+	_update_skeletons(&skeleton, 1);
+}
+
 Transform Skeleton::get_bone_transform(int p_bone) const {
 	ERR_FAIL_INDEX_V(p_bone, bones.size(), Transform());
 	if (dirty)
-		const_cast<Skeleton *>(this)->notification(NOTIFICATION_UPDATE_SKELETON);
-	return bones[p_bone].pose_global * bones[p_bone].rest_global_inverse;
+		const_cast<Skeleton *>(this)->_update_skeleton();
+	return bone_transforms_final[p_bone];
 }
 
 void Skeleton::set_bone_global_pose(int p_bone, const Transform &p_pose) {
@@ -349,10 +426,10 @@ void Skeleton::set_bone_global_pose(int p_bone, const Transform &p_pose) {
 	ERR_FAIL_INDEX(p_bone, bones.size());
 	if (bones[p_bone].parent == -1) {
 
-		set_bone_pose(p_bone, bones[p_bone].rest_global_inverse * p_pose); //fast
+		set_bone_pose(p_bone, bone_rests_global_inverse[p_bone] * p_pose); //fast
 	} else {
 
-		set_bone_pose(p_bone, bones[p_bone].rest.affine_inverse() * (get_bone_global_pose(bones[p_bone].parent).affine_inverse() * p_pose)); //slow
+		set_bone_pose(p_bone, bone_rests[p_bone].affine_inverse() * (get_bone_global_pose(bones[p_bone].parent).affine_inverse() * p_pose)); //slow
 	}
 }
 
@@ -360,8 +437,8 @@ Transform Skeleton::get_bone_global_pose(int p_bone) const {
 
 	ERR_FAIL_INDEX_V(p_bone, bones.size(), Transform());
 	if (dirty)
-		const_cast<Skeleton *>(this)->notification(NOTIFICATION_UPDATE_SKELETON);
-	return bones[p_bone].pose_global;
+		const_cast<Skeleton *>(this)->_update_skeleton();
+	return bone_poses_global[p_bone];
 }
 
 RID Skeleton::get_skeleton() const {
@@ -382,6 +459,12 @@ void Skeleton::add_bone(const String &p_name) {
 	Bone b;
 	b.name = p_name;
 	bones.push_back(b);
+	bone_rests.push_back(Transform());
+	bone_rests_global_inverse.push_back(Transform());
+	bone_poses.push_back(Transform());
+	bone_custom_poses.push_back(Transform());
+	bone_poses_global.push_back(Transform());
+	bone_transforms_final.push_back(Transform());
 	process_order_dirty = true;
 
 	rest_global_inverse_dirty = true;
@@ -442,12 +525,12 @@ void Skeleton::unparent_bone_and_rest(int p_bone) {
 
 	int parent = bones[p_bone].parent;
 	while (parent >= 0) {
-		bones.write[p_bone].rest = bones[parent].rest * bones[p_bone].rest;
+		bone_rests.write[p_bone] = bone_rests[parent] * bone_rests[p_bone];
 		parent = bones[parent].parent;
 	}
 
 	bones.write[p_bone].parent = -1;
-	bones.write[p_bone].rest_global_inverse = bones[p_bone].rest.affine_inverse(); //same thing
+	bone_rests_global_inverse.write[p_bone] = bone_rests[p_bone].affine_inverse(); //same thing
 	process_order_dirty = true;
 
 	_make_dirty();
@@ -487,7 +570,7 @@ void Skeleton::set_bone_rest(int p_bone, const Transform &p_rest) {
 
 	ERR_FAIL_INDEX(p_bone, bones.size());
 
-	bones.write[p_bone].rest = p_rest;
+	bone_rests.write[p_bone] = p_rest;
 	rest_global_inverse_dirty = true;
 	_make_dirty();
 }
@@ -495,7 +578,7 @@ Transform Skeleton::get_bone_rest(int p_bone) const {
 
 	ERR_FAIL_INDEX_V(p_bone, bones.size(), Transform());
 
-	return bones[p_bone].rest;
+	return bone_rests[p_bone];
 }
 
 void Skeleton::set_bone_enabled(int p_bone, bool p_enabled) {
@@ -550,6 +633,12 @@ void Skeleton::get_bound_child_nodes_to_bone(int p_bone, List<Node *> *p_bound)
 void Skeleton::clear_bones() {
 
 	bones.clear();
+	bone_rests.clear();
+	bone_rests_global_inverse.clear();
+	bone_poses.clear();
+	bone_custom_poses.clear();
+	bone_poses_global.clear();
+	bone_transforms_final.clear();
 	rest_global_inverse_dirty = true;
 	process_order_dirty = true;
 
@@ -563,13 +652,13 @@ void Skeleton::set_bone_pose(int p_bone, const Transform &p_pose) {
 	ERR_FAIL_INDEX(p_bone, bones.size());
 	ERR_FAIL_COND(!is_inside_tree());
 
-	bones.write[p_bone].pose = p_pose;
+	bone_poses.write[p_bone] = p_pose;
 	_make_dirty();
 }
 Transform Skeleton::get_bone_pose(int p_bone) const {
 
 	ERR_FAIL_INDEX_V(p_bone, bones.size(), Transform());
-	return bones[p_bone].pose;
+	return bone_poses[p_bone];
 }
 
 void Skeleton::set_bone_custom_pose(int p_bone, const Transform &p_custom_pose) {
@@ -578,7 +667,7 @@ void Skeleton::set_bone_custom_pose(int p_bone, const Transform &p_custom_pose)
 	//ERR_FAIL_COND( !is_inside_scene() );
 
 	bones.write[p_bone].custom_pose_enable = (p_custom_pose != Transform());
-	bones.write[p_bone].custom_pose = p_custom_pose;
+	bone_custom_poses.write[p_bone] = p_custom_pose;
 
 	_make_dirty();
 }
@@ -586,7 +675,7 @@ void Skeleton::set_bone_custom_pose(int p_bone, const Transform &p_custom_pose)
 Transform Skeleton::get_bone_custom_pose(int p_bone) const {
 
 	ERR_FAIL_INDEX_V(p_bone, bones.size(), Transform());
-	return bones[p_bone].custom_pose;
+	return bone_custom_poses[p_bone];
 }
 
 void Skeleton::_make_dirty() {
@@ -599,6 +688,8 @@ void Skeleton::_make_dirty() {
 		return;
 	}
 	MessageQueue::get_singleton()->push_notification(this, NOTIFICATION_UPDATE_SKELETON);
+	if (!update_item.in_list())
+		update_list.add_last(&update_item);
 	dirty = true;
 }
 
@@ -615,7 +706,7 @@ void Skeleton::localize_rests() {
 	for (int i = bones.size() - 1; i >= 0; i--) {
 		int idx = process_order[i];
 		if (bones[idx].parent >= 0) {
-			set_bone_rest(idx, bones[bones[idx].parent].rest.affine_inverse() * bones[idx].rest);
+			set_bone_rest(idx, bone_rests[bones[idx].parent].affine_inverse() * bone_rests[idx]);
 		}
 	}
 }
@@ -821,7 +912,8 @@ void Skeleton::_bind_methods() {
 	BIND_CONSTANT(NOTIFICATION_UPDATE_SKELETON);
 }
 
-Skeleton::Skeleton() {
+Skeleton::Skeleton() :
+		update_item(this) {
 
 	rest_global_inverse_dirty = true;
 	dirty = false;
@@ -32,6 +32,7 @@
 #define SKELETON_H
 
 #include "core/rid.h"
+#include "core/self_list.h"
 #include "scene/3d/spatial.h"
 
 /**
@@ -59,16 +60,7 @@ class Skeleton : public Spatial {
 		bool ignore_animation;
 
 		bool disable_rest;
-		Transform rest;
-		Transform rest_global_inverse;
-
-		Transform pose;
-		Transform pose_global;
-
 		bool custom_pose_enable;
-		Transform custom_pose;
-
-		Transform transform_final;
 
 #ifndef _3D_DISABLED
 		PhysicalBone *physical_bone;
@@ -96,11 +88,37 @@ class Skeleton : public Spatial {
 	Vector<int> process_order;
 	bool process_order_dirty;
 
+	// transforms are kept as structure of arrays indexed by bone, so pose
+	// evaluation walks tightly packed data instead of whole Bone structs
+	Vector<Transform> bone_rests;
+	Vector<Transform> bone_rests_global_inverse;
+	Vector<Transform> bone_poses;
+	Vector<Transform> bone_custom_poses;
+	Vector<Transform> bone_poses_global;
+	Vector<Transform> bone_transforms_final;
+
+	// skinning transforms as uploaded to the visual server, 12 floats per bone
+	PoolVector<float> bone_bulk_array;
+	PoolVector<float>::Write bone_bulk_write;
+	Transform update_global_transform;
+
+	// dirty skeletons inside the tree, updated together in a single batch
+	SelfList<Skeleton> update_item;
+	static SelfList<Skeleton>::List update_list;
+
 	RID skeleton;
 
 	void _make_dirty();
 	bool dirty;
 
+	void _update_begin();
+	void _update_pose();
+	void _update_bulk_array();
+	void _update_end(bool p_pose_changed);
+	void _update_pose_batched(uint32_t p_index, Skeleton **p_batch);
+	static void _update_skeletons(Skeleton **p_skeletons, int p_count);
+	void _update_skeleton();
+
 	// bind helpers
 	Array _get_bound_child_nodes_to_bone(int p_bone) const {
 
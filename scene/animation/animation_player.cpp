@@ -342,6 +342,13 @@ void AnimationPlayer::_animation_process_animation(AnimationData *p_anim, float
 	Animation *a = p_anim->animation.operator->();
 	bool can_call = is_inside_tree() && !Engine::get_singleton()->is_editor_hint();
 
+	if (p_anim->track_cursors.size() != a->get_track_count()) {
+		p_anim->track_cursors.resize(a->get_track_count());
+		for (int i = 0; i < p_anim->track_cursors.size(); i++)
+			p_anim->track_cursors.write[i] = 0;
+	}
+	int *track_cursors = p_anim->track_cursors.ptrw();
+
 	for (int i = 0; i < a->get_track_count(); i++) {
 
 		TrackNodeCache *nc = p_anim->node_cache[i];
@@ -366,7 +373,7 @@ void AnimationPlayer::_animation_process_animation(AnimationData *p_anim, float
 				Quat rot;
 				Vector3 scale;
 
-				Error err = a->transform_track_interpolate(i, p_time, &loc, &rot, &scale);
+				Error err = a->transform_track_interpolate(i, p_time, &loc, &rot, &scale, &track_cursors[i]);
 				//ERR_CONTINUE(err!=OK); //used for testing, should be removed
 
 				if (err != OK)
@@ -446,7 +453,7 @@ void AnimationPlayer::_animation_process_animation(AnimationData *p_anim, float
 
 				if (update_mode == Animation::UPDATE_CONTINUOUS || update_mode == Animation::UPDATE_CAPTURE || (p_delta == 0 && update_mode == Animation::UPDATE_DISCRETE)) { //delta == 0 means seek
 
-					Variant value = a->value_track_interpolate(i, p_time);
+					Variant value = a->value_track_interpolate(i, p_time, &track_cursors[i]);
 
 					if (value == Variant())
 						continue;
@@ -186,6 +186,7 @@ private:
 		String name;
 		StringName next;
 		Vector<TrackNodeCache *> node_cache;
+		Vector<int> track_cursors; // last key sampled per track, speeds up sequential playback
 		Ref<Animation> animation;
 	};
 
@@ -31,6 +31,7 @@
 #include "audio_player.h"
 
 #include "core/engine.h"
+#include "servers/audio/audio_mix.h"
 
 void AudioStreamPlayer::_mix_internal(bool p_fadeout) {
 
@@ -49,13 +50,7 @@ void AudioStreamPlayer::_mix_internal(bool p_fadeout) {
 
 	//multiply volume interpolating to avoid clicks if this changes
 	float target_volume = p_fadeout ? -80.0 : volume_db;
-	float vol = Math::db2linear(mix_volume_db);
-	float vol_inc = (Math::db2linear(target_volume) - vol) / float(buffer_size);
-
-	for (int i = 0; i < buffer_size; i++) {
-		buffer[i] *= vol;
-		vol += vol_inc;
-	}
+	AudioMix::ramp(buffer, buffer_size, Math::db2linear(mix_volume_db), Math::db2linear(target_volume));
 
 	//set volume for next mix
 	mix_volume_db = target_volume;
@@ -83,9 +78,7 @@ void AudioStreamPlayer::_mix_internal(bool p_fadeout) {
 	for (int c = 0; c < 4; c++) {
 		if (!targets[c])
 			break;
-		for (int i = 0; i < buffer_size; i++) {
-			targets[c][i] += buffer[i];
-		}
+		AudioMix::add(targets[c], buffer, buffer_size);
 	}
 }
 
@@ -314,6 +314,7 @@ int RichTextLabel::_process_line(ItemFrame *p_frame, const Vector2 &p_ofs, int &
 
 				const CharType *c = text->text.c_str();
 				const CharType *cf = c;
+				const int *advances = _get_text_advances(text, font);
 				int ascent = font->get_ascent();
 				int descent = font->get_descent();
 
@@ -350,10 +351,7 @@ int RichTextLabel::_process_line(ItemFrame *p_frame, const Vector2 &p_ofs, int &
 					}
 					while (c[end] != 0 && !(end && c[end - 1] == ' ' && c[end] != ' ')) {
 
-						int cw = font->get_char_size(c[end], c[end + 1]).width;
-						if (c[end] == '\t') {
-							cw = tab_size * font->get_char_size(' ').width;
-						}
+						int cw = advances[(c - cf) + end];
 
 						if (end > 0 && w + cw + begin > p_width) {
 							break; //don't allow lines longer than assigned width
@@ -393,11 +391,7 @@ int RichTextLabel::_process_line(ItemFrame *p_frame, const Vector2 &p_ofs, int &
 							if (p_mode == PROCESS_POINTER && r_click_char && p_click_pos.y >= p_ofs.y + y && p_click_pos.y <= p_ofs.y + y + lh) {
 								//int o = (wofs+w)-p_click_pos.x;
 
-								int cw = font->get_char_size(c[i], c[i + 1]).x;
-
-								if (c[i] == '\t') {
-									cw = tab_size * font->get_char_size(' ').width;
-								}
+								int cw = advances[(c - cf) + i];
 
 								if (p_click_pos.x - cw / 2 > p_ofs.x + align_ofs + pofs) {
 
@@ -427,7 +421,7 @@ int RichTextLabel::_process_line(ItemFrame *p_frame, const Vector2 &p_ofs, int &
 
 								if (visible) {
 									if (selected) {
-										cw = font->get_char_size(c[i], c[i + 1]).x;
+										cw = advances[(c - cf) + i];
 										draw_rect(Rect2(p_ofs.x + pofs, p_ofs.y + y, cw, lh), selection_bg);
 									}
 
@@ -453,7 +447,7 @@ int RichTextLabel::_process_line(ItemFrame *p_frame, const Vector2 &p_ofs, int &
 
 								p_char_count++;
 								if (c[i] == '\t') {
-									cw = tab_size * font->get_char_size(' ').width;
+									cw = advances[(c - cf) + i];
 								}
 
 								ofs += cw;
@@ -740,6 +734,14 @@ void RichTextLabel::_scroll_changed(double) {
 	update();
 }
 
+void RichTextLabel::_invalidate_advances() {
+
+	//spacing, font data or fallbacks may have changed without the height changing
+	advances_version++;
+	main->first_invalid_line = 0; //invalidate ALL
+	update();
+}
+
 void RichTextLabel::_update_scroll() {
 
 	int total_height = get_content_height();
@@ -772,7 +774,11 @@ void RichTextLabel::_notification(int p_what) {
 
 		case NOTIFICATION_RESIZED: {
 
-			main->first_invalid_line = 0; //invalidate ALL
+			if (_get_text_rect().get_size().width != layout_width) {
+				main->first_invalid_line = 0; //invalidate ALL
+			} else {
+				_update_scroll_range(); //lines wrap the same way, only the page changed
+			}
 			update();
 
 		} break;
@@ -791,6 +797,8 @@ void RichTextLabel::_notification(int p_what) {
 				parse_bbcode(bbcode);
 				//first_invalid_line=0; //invalidate ALL
 				//update();
+			} else {
+				_invalidate_advances();
 			}
 
 		} break;
@@ -814,20 +822,12 @@ void RichTextLabel::_notification(int p_what) {
 
 			int ofs = vscroll->get_value();
 
-			//todo, change to binary search
-
-			int from_line = 0;
-			int total_chars = 0;
-			while (from_line < main->lines.size()) {
-
-				if (main->lines[from_line].height_accum_cache + _get_text_rect().get_position().y >= ofs)
-					break;
-				total_chars += main->lines[from_line].char_count;
-				from_line++;
-			}
+			int from_line = _find_line_at_offset(main, ofs - text_rect.get_position().y);
 
 			if (from_line >= main->lines.size())
 				break; //nothing to draw
+
+			int total_chars = main->lines[from_line].char_accum_cache;
 			int y = (main->lines[from_line].height_accum_cache - main->lines[from_line].height_cache) - ofs;
 			Ref<Font> base_font = get_font("normal_font");
 			Color base_color = get_color("default_color");
@@ -861,15 +861,7 @@ void RichTextLabel::_find_click(ItemFrame *p_frame, const Point2i &p_click, Item
 	bool use_outline = get_constant("shadow_as_outline");
 	Point2 shadow_ofs(get_constant("shadow_offset_x"), get_constant("shadow_offset_y"));
 
-	//todo, change to binary search
-	int from_line = 0;
-
-	while (from_line < p_frame->lines.size()) {
-
-		if (p_frame->lines[from_line].height_accum_cache >= ofs)
-			break;
-		from_line++;
-	}
+	int from_line = _find_line_at_offset(p_frame, ofs);
 
 	if (from_line >= p_frame->lines.size())
 		return;
@@ -1253,10 +1245,6 @@ void RichTextLabel::_validate_line_caches(ItemFrame *p_frame) {
 		return;
 
 	//validate invalid lines
-	Size2 size = get_size();
-	if (fixed_width != -1) {
-		size.width = fixed_width;
-	}
 	Rect2 text_rect = _get_text_rect();
 	Color font_color_shadow = get_color("font_color_shadow");
 	bool use_outline = get_constant("shadow_as_outline");
@@ -1270,26 +1258,87 @@ void RichTextLabel::_validate_line_caches(ItemFrame *p_frame) {
 		_process_line(p_frame, text_rect.get_position(), y, text_rect.get_size().width - scroll_w, i, PROCESS_CACHE, base_font, Color(), font_color_shadow, use_outline, shadow_ofs);
 		p_frame->lines.write[i].height_cache = y;
 		p_frame->lines.write[i].height_accum_cache = y;
+		p_frame->lines.write[i].char_accum_cache = 0;
 
-		if (i > 0)
+		if (i > 0) {
 			p_frame->lines.write[i].height_accum_cache += p_frame->lines[i - 1].height_accum_cache;
+			p_frame->lines.write[i].char_accum_cache = p_frame->lines[i - 1].char_accum_cache + p_frame->lines[i - 1].char_count;
+		}
 	}
 
-	int total_height = 0;
-	if (p_frame->lines.size())
-		total_height = p_frame->lines[p_frame->lines.size() - 1].height_accum_cache + get_stylebox("normal")->get_minimum_size().height;
+	p_frame->first_invalid_line = p_frame->lines.size();
+
+	if (p_frame == main) {
+		layout_width = text_rect.get_size().width;
+	}
 
-	main->first_invalid_line = p_frame->lines.size();
+	_update_scroll_range();
+}
+
+void RichTextLabel::_update_scroll_range() {
+
+	int total_height = get_content_height();
+	int page = get_size().height;
 
 	updating_scroll = true;
 	vscroll->set_max(total_height);
-	vscroll->set_page(size.height);
+	vscroll->set_page(page);
 	if (scroll_follow && scroll_following)
-		vscroll->set_value(total_height - size.height);
+		vscroll->set_value(total_height - page);
 
 	updating_scroll = false;
 }
 
+int RichTextLabel::_find_line_at_offset(ItemFrame *p_frame, int p_ofs) const {
+
+	//first line reaching p_ofs, lines are sorted by their accumulated height
+	int low = 0;
+	int high = p_frame->lines.size();
+
+	while (low < high) {
+
+		int mid = (low + high) / 2;
+		if (p_frame->lines[mid].height_accum_cache < p_ofs)
+			low = mid + 1;
+		else
+			high = mid;
+	}
+
+	return low;
+}
+
+const int *RichTextLabel::_get_text_advances(ItemText *p_text, const Ref<Font> &p_font) {
+
+	int len = p_text->text.length();
+	int font_height = p_font->get_height();
+	int from = 0;
+
+	if (p_text->advances_font == p_font->get_instance_id() && p_text->advances_font_height == font_height && p_text->advances_tab_size == tab_size && p_text->advances_version == advances_version && p_text->advances.size() <= len) {
+
+		if (p_text->advances.size() == len)
+			return p_text->advances.ptr();
+
+		//text was appended, the last cached character may kern with the first new one
+		from = MAX(0, p_text->advances.size() - 1);
+	}
+
+	p_text->advances.resize(len);
+	p_text->advances_font = p_font->get_instance_id();
+	p_text->advances_font_height = font_height;
+	p_text->advances_tab_size = tab_size;
+	p_text->advances_version = advances_version;
+
+	const CharType *c = p_text->text.c_str();
+	int *w = p_text->advances.ptrw();
+	int tab_width = tab_size * p_font->get_char_size(' ').width;
+
+	for (int i = from; i < len; i++) {
+		w[i] = c[i] == '\t' ? tab_width : int(p_font->get_char_size(c[i], c[i + 1]).width);
+	}
+
+	return p_text->advances.ptr();
+}
+
 void RichTextLabel::_invalidate_current_line(ItemFrame *p_frame) {
 
 	if (p_frame->lines.size() - 1 <= p_frame->first_invalid_line) {
@@ -1444,7 +1493,11 @@ bool RichTextLabel::remove_line(const int p_line) {
 	if (p_line == 0 && current->subitems.size() > 0)
 		main->lines.write[0].from = main;
 
-	main->first_invalid_line = 0;
+	//lines before the removed one keep their layout
+	if (current_frame == main)
+		main->first_invalid_line = MIN(main->first_invalid_line, p_line);
+	else
+		main->first_invalid_line = 0;
 
 	return true;
 }
@@ -1457,6 +1510,11 @@ void RichTextLabel::push_font(const Ref<Font> &p_font) {
 
 	item->font = p_font;
 	_add_item(item, true);
+
+	if (!pushed_fonts.has(p_font)) {
+		pushed_fonts.insert(p_font);
+		item->font->connect("changed", this, "_invalidate_advances");
+	}
 }
 void RichTextLabel::push_color(const Color &p_color) {
 
@@ -1571,6 +1629,12 @@ void RichTextLabel::pop() {
 
 void RichTextLabel::clear() {
 
+	for (Set<Ref<Font> >::Element *E = pushed_fonts.front(); E; E = E->next()) {
+		Ref<Font> font = E->get();
+		font->disconnect("changed", this, "_invalidate_advances");
+	}
+	pushed_fonts.clear();
+
 	main->_clear_children();
 	current = main;
 	current_frame = main;
@@ -2132,6 +2196,7 @@ void RichTextLabel::_bind_methods() {
 
 	ClassDB::bind_method(D_METHOD("_gui_input"), &RichTextLabel::_gui_input);
 	ClassDB::bind_method(D_METHOD("_scroll_changed"), &RichTextLabel::_scroll_changed);
+	ClassDB::bind_method(D_METHOD("_invalidate_advances"), &RichTextLabel::_invalidate_advances);
 	ClassDB::bind_method(D_METHOD("get_text"), &RichTextLabel::get_text);
 	ClassDB::bind_method(D_METHOD("add_text", "text"), &RichTextLabel::add_text);
 	ClassDB::bind_method(D_METHOD("set_text", "text"), &RichTextLabel::set_text);
@@ -2283,6 +2348,7 @@ RichTextLabel::RichTextLabel() {
 	main->first_invalid_line = 0;
 	current_frame = main;
 	tab_size = 4;
+	advances_version = 0;
 	default_align = ALIGN_LEFT;
 	underline_meta = true;
 	override_selected_font_color = false;
@@ -2316,6 +2382,7 @@ RichTextLabel::RichTextLabel() {
 	visible_line_count = 0;
 
 	fixed_width = -1;
+	layout_width = -1;
 	set_clip_contents(true);
 }
 
@@ -86,12 +86,14 @@ private:
 		int height_cache;
 		int height_accum_cache;
 		int char_count;
+		int char_accum_cache; // characters in the lines before this one
 		int minimum_width;
 		int maximum_width;
 
 		Line() {
 			from = NULL;
 			char_count = 0;
+			char_accum_cache = 0;
 		}
 	};
 
@@ -138,7 +140,21 @@ private:
 	struct ItemText : public Item {
 
 		String text;
-		ItemText() { type = ITEM_TEXT; }
+
+		// Advance of every character (kerning and tabs included) for the font it was last laid out with.
+		Vector<int> advances;
+		ObjectID advances_font;
+		int advances_font_height;
+		int advances_tab_size;
+		uint32_t advances_version;
+
+		ItemText() {
+			type = ITEM_TEXT;
+			advances_font = 0;
+			advances_font_height = 0;
+			advances_tab_size = 0;
+			advances_version = 0;
+		}
 	};
 
 	struct ItemImage : public Item {
@@ -224,6 +240,8 @@ private:
 	int visible_line_count;
 
 	int tab_size;
+	uint32_t advances_version; // bumped when a font changes in a way its height doesn't tell
+	Set<Ref<Font> > pushed_fonts;
 	bool underline_meta;
 	bool override_selected_font_color;
 
@@ -232,8 +250,13 @@ private:
 	ItemMeta *meta_hovering;
 	Variant current_meta;
 
+	int layout_width;
+
 	void _invalidate_current_line(ItemFrame *p_frame);
 	void _validate_line_caches(ItemFrame *p_frame);
+	void _update_scroll_range();
+	int _find_line_at_offset(ItemFrame *p_frame, int p_ofs) const;
+	const int *_get_text_advances(ItemText *p_text, const Ref<Font> &p_font);
 
 	void _add_item(Item *p_item, bool p_enter = false, bool p_ensure_newline = false);
 	void _remove_item(Item *p_item, const int p_line, const int p_subitem_line);
@@ -281,6 +304,7 @@ private:
 
 	void _update_scroll();
 	void _scroll_changed(double);
+	void _invalidate_advances();
 
 	void _gui_input(Ref<InputEvent> p_event);
 	Item *_get_next_item(Item *p_item, bool p_free = false);
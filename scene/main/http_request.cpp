@@ -35,6 +35,16 @@ void HTTPRequest::_redirect_request(const String &p_new_url) {
 
 Error HTTPRequest::_request() {
 
+	// Reuse the connection the previous request left open, if it goes to the same place
+	reusing_connection = client->get_status() == HTTPClient::STATUS_CONNECTED && url == connected_host && port == connected_port && use_ssl == connected_ssl && (validate_ssl == connected_validate_ssl || !validate_ssl);
+	if (reusing_connection)
+		return OK;
+
+	connected_host = url;
+	connected_port = port;
+	connected_ssl = use_ssl;
+	connected_validate_ssl = validate_ssl;
+
 	return client->connect_to_host(url, port, use_ssl, validate_ssl);
 }
 
@@ -153,6 +163,11 @@ void HTTPRequest::_thread_func(void *p_userdata) {
 
 void HTTPRequest::cancel_request() {
 
+	_cancel_request(false);
+}
+
+void HTTPRequest::_cancel_request(bool p_keep_connection) {
+
 	if (!requesting)
 		return;
 
@@ -169,7 +184,9 @@ void HTTPRequest::cancel_request() {
 		memdelete(file);
 		file = NULL;
 	}
-	client->close();
+	if (!p_keep_connection) {
+		client->close();
+	}
 	body.resize(0);
 	got_response = false;
 	response_code = -1;
@@ -186,6 +203,7 @@ bool HTTPRequest::_handle_response(bool *ret_value) {
 	}
 
 	got_response = true;
+	reusing_connection = false;
 	response_code = client->get_response_code();
 	List<String> rheaders;
 	client->get_response_headers(&rheaders);
@@ -289,6 +307,7 @@ bool HTTPRequest::_update_connection() {
 				}
 				if (got_response && body_len < 0) {
 					// Chunked transfer is done
+					body.resize(downloaded);
 					call_deferred("_request_done", RESULT_SUCCESS, response_code, response_headers, body);
 					return true;
 				}
@@ -346,29 +365,42 @@ bool HTTPRequest::_update_connection() {
 						call_deferred("_request_done", RESULT_DOWNLOAD_FILE_CANT_OPEN, response_code, response_headers, PoolByteArray());
 						return true;
 					}
+					read_buffer.resize(65536);
+				} else if (body_len > 0) {
+					// Known size, the body is read into place with no further copies
+					body.resize(body_len);
 				}
 			}
 
 			client->poll();
 
-			PoolByteArray chunk = client->read_response_body_chunk();
-			downloaded += chunk.size();
+			// Take whatever has arrived, not just one chunk per update
+			int received = 0;
+			do {
+				if (file) {
+					client->read_response_body(read_buffer.ptrw(), read_buffer.size(), received);
+					if (received > 0) {
+						file->store_buffer(read_buffer.ptr(), received);
+						if (file->get_error() != OK) {
+							call_deferred("_request_done", RESULT_DOWNLOAD_FILE_WRITE_ERROR, response_code, response_headers, PoolByteArray());
+							return true;
+						}
+					}
+				} else {
+					if (downloaded == body.size()) {
+						// Unknown size, grow as needed
+						body.resize(MAX(body.size() * 2, 65536));
+					}
+					PoolByteArray::Write w = body.write();
+					client->read_response_body(w.ptr() + downloaded, body.size() - downloaded, received);
+				}
+				downloaded += received;
 
-			if (file) {
-				PoolByteArray::Read r = chunk.read();
-				file->store_buffer(r.ptr(), chunk.size());
-				if (file->get_error() != OK) {
-					call_deferred("_request_done", RESULT_DOWNLOAD_FILE_WRITE_ERROR, response_code, response_headers, PoolByteArray());
+				if (body_size_limit >= 0 && downloaded > body_size_limit) {
+					call_deferred("_request_done", RESULT_BODY_SIZE_LIMIT_EXCEEDED, response_code, response_headers, PoolByteArray());
 					return true;
 				}
-			} else {
-				body.append_array(chunk);
-			}
-
-			if (body_size_limit >= 0 && downloaded > body_size_limit) {
-				call_deferred("_request_done", RESULT_BODY_SIZE_LIMIT_EXCEEDED, response_code, response_headers, PoolByteArray());
-				return true;
-			}
+			} while (received > 0 && client->get_status() == HTTPClient::STATUS_BODY);
 
 			if (body_len >= 0) {
 
@@ -378,6 +410,7 @@ bool HTTPRequest::_update_connection() {
 				}
 			} else if (client->get_status() == HTTPClient::STATUS_DISCONNECTED) {
 				// We read till EOF, with no errors. Request is done.
+				body.resize(downloaded);
 				call_deferred("_request_done", RESULT_SUCCESS, response_code, response_headers, body);
 			}
 
@@ -385,6 +418,14 @@ bool HTTPRequest::_update_connection() {
 
 		} break; // Request resulted in body: break which must be read
 		case HTTPClient::STATUS_CONNECTION_ERROR: {
+			if (reusing_connection && !got_response) {
+				// The server closed the kept-alive connection in the meantime, try a new one
+				reusing_connection = false;
+				request_sent = false;
+				if (client->connect_to_host(url, port, use_ssl, validate_ssl) == OK) {
+					return false;
+				}
+			}
 			call_deferred("_request_done", RESULT_CONNECTION_ERROR, 0, PoolStringArray(), PoolByteArray());
 			return true;
 		} break;
@@ -399,7 +440,8 @@ bool HTTPRequest::_update_connection() {
 
 void HTTPRequest::_request_done(int p_status, int p_code, const PoolStringArray &headers, const PoolByteArray &p_data) {
 
-	cancel_request();
+	// The connection stays open for the next request if the server allows it
+	_cancel_request(p_status == RESULT_SUCCESS && client->get_status() == HTTPClient::STATUS_CONNECTED && client->is_response_keep_alive());
 	emit_signal("request_completed", p_status, p_code, headers, p_data);
 }
 
@@ -420,6 +462,8 @@ void HTTPRequest::_notification(int p_what) {
 	if (p_what == NOTIFICATION_EXIT_TREE) {
 		if (requesting) {
 			cancel_request();
+		} else {
+			client->close(); // A connection kept alive for the next request
 		}
 	}
 }
@@ -534,6 +578,10 @@ HTTPRequest::HTTPRequest() {
 	port = 80;
 	redirections = 0;
 	max_redirects = 8;
+	connected_port = -1;
+	connected_ssl = false;
+	connected_validate_ssl = false;
+	reusing_connection = false;
 	body_len = -1;
 	got_response = false;
 	validate_ssl = false;
@@ -72,6 +72,7 @@ private:
 	bool request_sent;
 	Ref<HTTPClient> client;
 	PoolByteArray body;
+	Vector<uint8_t> read_buffer;
 	volatile bool use_threads;
 
 	bool got_response;
@@ -88,6 +89,13 @@ private:
 
 	int redirections;
 
+	// Where the kept-alive connection of the last request goes
+	String connected_host;
+	int connected_port;
+	bool connected_ssl;
+	bool connected_validate_ssl;
+	bool reusing_connection;
+
 	HTTPClient::Status status;
 
 	bool _update_connection();
@@ -100,6 +108,7 @@ private:
 
 	Error _parse_url(const String &p_url);
 	Error _request();
+	void _cancel_request(bool p_keep_connection);
 
 	volatile bool thread_done;
 	volatile bool thread_request_quit;
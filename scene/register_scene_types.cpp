@@ -173,6 +173,7 @@
 #include "scene/3d/area.h"
 #include "scene/3d/arvr_nodes.h"
 #include "scene/3d/audio_stream_player_3d.h"
+#include "scene/3d/audio_voice_manager_3d.h"
 #include "scene/3d/baked_lightmap.h"
 #include "scene/3d/bone_attachment.h"
 #include "scene/3d/camera.h"
@@ -250,6 +251,7 @@ void register_scene_types() {
 
 	resource_loader_text = memnew(ResourceFormatLoaderText);
 	ResourceLoader::add_resource_format_loader(resource_loader_text, true);
+	GLOBAL_DEF("editor/cache_text_resources_as_binary", true);
 
 	resource_saver_shader = memnew(ResourceFormatSaverShader);
 	ResourceSaver::add_resource_format_saver(resource_saver_shader, true);
@@ -658,6 +660,10 @@ void register_scene_types() {
 	ClassDB::register_class<AudioStreamPlayer2D>();
 #ifndef _3D_DISABLED
 	ClassDB::register_class<AudioStreamPlayer3D>();
+	AudioVoiceManager3D::max_voices = GLOBAL_DEF("audio/max_3d_voices", 64);
+	ProjectSettings::get_singleton()->set_custom_property_info("audio/max_3d_voices", PropertyInfo(Variant::INT, "audio/max_3d_voices", PROPERTY_HINT_RANGE, "0,1024,1"));
+	AudioVoiceManager3D::inaudible_db = GLOBAL_DEF("audio/3d_voice_inaudible_db", -80.0);
+	ProjectSettings::get_singleton()->set_custom_property_info("audio/3d_voice_inaudible_db", PropertyInfo(Variant::REAL, "audio/3d_voice_inaudible_db", PROPERTY_HINT_RANGE, "-120,0,0.1"));
 #endif
 	ClassDB::register_virtual_class<VideoStream>();
 	ClassDB::register_class<AudioStreamSample>();
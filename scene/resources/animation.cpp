@@ -33,6 +33,7 @@
 #include "core/math/geometry.h"
 
 #define ANIM_MIN_LENGTH 0.001
+#define ANIM_COMPRESSION_PAGE_SIZE 32
 
 bool Animation::_set(const StringName &p_name, const Variant &p_value) {
 
@@ -85,6 +86,8 @@ bool Animation::_set(const StringName &p_name, const Variant &p_value) {
 			track_set_imported(track, p_value);
 		else if (what == "enabled")
 			track_set_enabled(track, p_value);
+		else if (what == "compressed")
+			transform_track_set_compressed(track, p_value);
 		else if (what == "keys" || what == "key_values") {
 
 			if (track_get_type(track) == TYPE_TRANSFORM) {
@@ -94,6 +97,9 @@ bool Animation::_set(const StringName &p_name, const Variant &p_value) {
 				int vcount = values.size();
 				ERR_FAIL_COND_V(vcount % 12, false); // shuld be multiple of 11
 
+				bool compressed = tt->compressed;
+				_transform_track_decompress(tt);
+
 				PoolVector<float>::Read r = values.read();
 
 				tt->transforms.resize(vcount / 12);
@@ -119,6 +125,9 @@ bool Animation::_set(const StringName &p_name, const Variant &p_value) {
 					tk.value.scale.z = ofs[11];
 				}
 
+				if (compressed)
+					_transform_track_compress(tt);
+
 			} else if (track_get_type(track) == TYPE_VALUE) {
 
 				ValueTrack *vt = static_cast<ValueTrack *>(tracks[track]);
@@ -368,6 +377,8 @@ bool Animation::_get(const StringName &p_name, Variant &r_ret) const {
 			r_ret = track_is_imported(track);
 		else if (what == "enabled")
 			r_ret = track_is_enabled(track);
+		else if (what == "compressed")
+			r_ret = track_get_type(track) == TYPE_TRANSFORM && transform_track_is_compressed(track);
 		else if (what == "keys") {
 
 			if (track_get_type(track) == TYPE_TRANSFORM) {
@@ -622,6 +633,8 @@ void Animation::_get_property_list(List<PropertyInfo> *p_list) const {
 		p_list->push_back(PropertyInfo(Variant::BOOL, "tracks/" + itos(i) + "/imported", PROPERTY_HINT_NONE, "", PROPERTY_USAGE_NOEDITOR | PROPERTY_USAGE_INTERNAL));
 		p_list->push_back(PropertyInfo(Variant::BOOL, "tracks/" + itos(i) + "/enabled", PROPERTY_HINT_NONE, "", PROPERTY_USAGE_NOEDITOR | PROPERTY_USAGE_INTERNAL));
 		p_list->push_back(PropertyInfo(Variant::ARRAY, "tracks/" + itos(i) + "/keys", PROPERTY_HINT_NONE, "", PROPERTY_USAGE_NOEDITOR | PROPERTY_USAGE_INTERNAL));
+		if (tracks[i]->type == TYPE_TRANSFORM && static_cast<TransformTrack *>(tracks[i])->compressed)
+			p_list->push_back(PropertyInfo(Variant::BOOL, "tracks/" + itos(i) + "/compressed", PROPERTY_HINT_NONE, "", PROPERTY_USAGE_NOEDITOR | PROPERTY_USAGE_INTERNAL));
 	}
 }
 
@@ -681,6 +694,7 @@ void Animation::remove_track(int p_track) {
 		case TYPE_TRANSFORM: {
 
 			TransformTrack *tt = static_cast<TransformTrack *>(t);
+			_transform_track_decompress(tt);
 			_clear(tt->transforms);
 
 		} break;
@@ -845,6 +859,21 @@ Error Animation::transform_track_get_key(int p_track, int p_key, Vector3 *r_loc,
 
 	TransformTrack *tt = static_cast<TransformTrack *>(t);
 	ERR_FAIL_COND_V(t->type != TYPE_TRANSFORM, ERR_INVALID_PARAMETER);
+
+	if (tt->compressed) {
+
+		ERR_FAIL_INDEX_V(p_key, tt->compressed_transforms.size(), ERR_INVALID_PARAMETER);
+		TransformKey tk = _transform_track_get_compressed_key(tt, p_key);
+		if (r_loc)
+			*r_loc = tk.loc;
+		if (r_rot)
+			*r_rot = tk.rot;
+		if (r_scale)
+			*r_scale = tk.scale;
+
+		return OK;
+	}
+
 	ERR_FAIL_INDEX_V(p_key, tt->transforms.size(), ERR_INVALID_PARAMETER);
 
 	if (r_loc)
@@ -864,6 +893,7 @@ int Animation::transform_track_insert_key(int p_track, float p_time, const Vecto
 	ERR_FAIL_COND_V(t->type != TYPE_TRANSFORM, -1);
 
 	TransformTrack *tt = static_cast<TransformTrack *>(t);
+	_transform_track_decompress(tt);
 
 	TKey<TransformKey> tkey;
 	tkey.time = p_time;
@@ -892,6 +922,7 @@ void Animation::track_remove_key(int p_track, int p_idx) {
 		case TYPE_TRANSFORM: {
 
 			TransformTrack *tt = static_cast<TransformTrack *>(t);
+			_transform_track_decompress(tt);
 			ERR_FAIL_INDEX(p_idx, tt->transforms.size());
 			tt->transforms.remove(p_idx);
 
@@ -945,6 +976,14 @@ int Animation::track_find_key(int p_track, float p_time, bool p_exact) const {
 		case TYPE_TRANSFORM: {
 
 			TransformTrack *tt = static_cast<TransformTrack *>(t);
+			if (tt->compressed) {
+				int k = _find(tt->compressed_transforms, p_time);
+				if (k < 0 || k >= tt->compressed_transforms.size())
+					return -1;
+				if (tt->compressed_transforms[k].time != p_time && p_exact)
+					return -1;
+				return k;
+			}
 			int k = _find(tt->transforms, p_time);
 			if (k < 0 || k >= tt->transforms.size())
 				return -1;
@@ -1130,6 +1169,8 @@ int Animation::track_get_key_count(int p_track) const {
 		case TYPE_TRANSFORM: {
 
 			TransformTrack *tt = static_cast<TransformTrack *>(t);
+			if (tt->compressed)
+				return tt->compressed_transforms.size();
 			return tt->transforms.size();
 		} break;
 		case TYPE_VALUE: {
@@ -1172,13 +1213,15 @@ Variant Animation::track_get_key_value(int p_track, int p_key_idx) const {
 
 		case TYPE_TRANSFORM: {
 
-			TransformTrack *tt = static_cast<TransformTrack *>(t);
-			ERR_FAIL_INDEX_V(p_key_idx, tt->transforms.size(), Variant());
+			Vector3 loc;
+			Quat rot;
+			Vector3 scale;
+			ERR_FAIL_COND_V(transform_track_get_key(p_track, p_key_idx, &loc, &rot, &scale) != OK, Variant());
 
 			Dictionary d;
-			d["location"] = tt->transforms[p_key_idx].value.loc;
-			d["rotation"] = tt->transforms[p_key_idx].value.rot;
-			d["scale"] = tt->transforms[p_key_idx].value.scale;
+			d["location"] = loc;
+			d["rotation"] = rot;
+			d["scale"] = scale;
 
 			return d;
 		} break;
@@ -1249,6 +1292,10 @@ float Animation::track_get_key_time(int p_track, int p_key_idx) const {
 		case TYPE_TRANSFORM: {
 
 			TransformTrack *tt = static_cast<TransformTrack *>(t);
+			if (tt->compressed) {
+				ERR_FAIL_INDEX_V(p_key_idx, tt->compressed_transforms.size(), -1);
+				return tt->compressed_transforms[p_key_idx].time;
+			}
 			ERR_FAIL_INDEX_V(p_key_idx, tt->transforms.size(), -1);
 			return tt->transforms[p_key_idx].time;
 		} break;
@@ -1302,6 +1349,10 @@ float Animation::track_get_key_transition(int p_track, int p_key_idx) const {
 		case TYPE_TRANSFORM: {
 
 			TransformTrack *tt = static_cast<TransformTrack *>(t);
+			if (tt->compressed) {
+				ERR_FAIL_INDEX_V(p_key_idx, tt->compressed_transforms.size(), -1);
+				return tt->compressed_transforms[p_key_idx].transition;
+			}
 			ERR_FAIL_INDEX_V(p_key_idx, tt->transforms.size(), -1);
 			return tt->transforms[p_key_idx].transition;
 		} break;
@@ -1346,6 +1397,7 @@ void Animation::track_set_key_value(int p_track, int p_key_idx, const Variant &p
 		case TYPE_TRANSFORM: {
 
 			TransformTrack *tt = static_cast<TransformTrack *>(t);
+			_transform_track_decompress(tt);
 			ERR_FAIL_INDEX(p_key_idx, tt->transforms.size());
 			Dictionary d = p_value;
 			if (d.has("location"))
@@ -1422,6 +1474,11 @@ void Animation::track_set_key_transition(int p_track, int p_key_idx, float p_tra
 		case TYPE_TRANSFORM: {
 
 			TransformTrack *tt = static_cast<TransformTrack *>(t);
+			if (tt->compressed) {
+				ERR_FAIL_INDEX(p_key_idx, tt->compressed_transforms.size());
+				tt->compressed_transforms.write[p_key_idx].transition = p_transition;
+				break;
+			}
 			ERR_FAIL_INDEX(p_key_idx, tt->transforms.size());
 			tt->transforms.write[p_key_idx].transition = p_transition;
 		} break;
@@ -1448,12 +1505,29 @@ void Animation::track_set_key_transition(int p_track, int p_key_idx, float p_tra
 }
 
 template <class K>
-int Animation::_find(const Vector<K> &p_keys, float p_time) const {
+int Animation::_find(const Vector<K> &p_keys, float p_time, int *p_cursor) const {
 
 	int len = p_keys.size();
 	if (len == 0)
 		return -2;
 
+	const K *keys = &p_keys[0];
+
+	if (p_cursor) {
+		// sequential playback almost always lands on the cached key or the next one
+		int cursor = *p_cursor;
+		if (cursor >= 0 && cursor < len && keys[cursor].time <= p_time) {
+
+			if (cursor + 1 == len || p_time < keys[cursor + 1].time)
+				return cursor;
+
+			if (cursor + 2 == len || p_time < keys[cursor + 2].time) {
+				*p_cursor = cursor + 1;
+				return cursor + 1;
+			}
+		}
+	}
+
 	int low = 0;
 	int high = len - 1;
 	int middle = 0;
@@ -1463,13 +1537,13 @@ int Animation::_find(const Vector<K> &p_keys, float p_time) const {
 		ERR_PRINT("low > high, this may be a bug");
 #endif
 
-	const K *keys = &p_keys[0];
-
 	while (low <= high) {
 
 		middle = (low + high) / 2;
 
 		if (p_time == keys[middle].time) { //match
+			if (p_cursor)
+				*p_cursor = middle;
 			return middle;
 		} else if (p_time < keys[middle].time)
 			high = middle - 1; //search low end of array
@@ -1480,6 +1554,9 @@ int Animation::_find(const Vector<K> &p_keys, float p_time) const {
 	if (keys[middle].time > p_time)
 		middle--;
 
+	if (p_cursor)
+		*p_cursor = middle;
+
 	return middle;
 }
 
@@ -1635,27 +1712,29 @@ float Animation::_cubic_interpolate(const float &p_pre_a, const float &p_a, cons
 	return _interpolate(p_a, p_b, p_c);
 }
 
-template <class T>
-T Animation::_interpolate(const Vector<TKey<T> > &p_keys, float p_time, InterpolationType p_interp, bool p_loop_wrap, bool *p_ok) const {
+template <class K>
+bool Animation::_find_interpolation_keys(const Vector<K> &p_keys, float p_time, bool p_loop_wrap, int *p_cursor, int &r_idx, int &r_next, int &r_len, float &r_c) const {
 
-	int len = _find(p_keys, length) + 1; // try to find last key (there may be more past the end)
+	int len = p_keys.size();
+	if (len > 0 && p_keys[len - 1].time > length)
+		len = _find(p_keys, length) + 1; // try to find last key (there may be more past the end)
 
 	if (len <= 0) {
 		// (-1 or -2 returned originally) (plus one above)
 		// meaning no keys, or only key time is larger than length
-		if (p_ok)
-			*p_ok = false;
-		return T();
+		return false;
 	} else if (len == 1) { // one key found (0+1), return it
 
-		if (p_ok)
-			*p_ok = true;
-		return p_keys[0].value;
+		r_idx = 0;
+		r_next = 0;
+		r_len = 1;
+		r_c = 0;
+		return true;
 	}
 
-	int idx = _find(p_keys, p_time);
+	int idx = _find(p_keys, p_time, p_cursor);
 
-	ERR_FAIL_COND_V(idx == -2, T());
+	ERR_FAIL_COND_V(idx == -2, false);
 
 	bool result = true;
 	int next = 0;
@@ -1735,6 +1814,23 @@ T Animation::_interpolate(const Vector<TKey<T> > &p_keys, float p_time, Interpol
 		}
 	}
 
+	r_idx = idx;
+	r_next = next;
+	r_len = len;
+	r_c = c;
+	return result;
+}
+
+template <class T>
+T Animation::_interpolate(const Vector<TKey<T> > &p_keys, float p_time, InterpolationType p_interp, bool p_loop_wrap, bool *p_ok, int *p_cursor) const {
+
+	int idx = 0;
+	int next = 0;
+	int len = 0;
+	float c = 0;
+
+	bool result = _find_interpolation_keys(p_keys, p_time, p_loop_wrap, p_cursor, idx, next, len, c);
+
 	if (p_ok)
 		*p_ok = result;
 	if (!result)
@@ -1779,7 +1875,48 @@ T Animation::_interpolate(const Vector<TKey<T> > &p_keys, float p_time, Interpol
 	// do a barrel roll
 }
 
-Error Animation::transform_track_interpolate(int p_track, float p_time, Vector3 *r_loc, Quat *r_rot, Vector3 *r_scale) const {
+Animation::TransformKey Animation::_transform_track_interpolate_compressed(const TransformTrack *tt, float p_time, bool *p_ok, int *p_cursor) const {
+
+	int idx = 0;
+	int next = 0;
+	int len = 0;
+	float c = 0;
+
+	bool result = _find_interpolation_keys(tt->compressed_transforms, p_time, tt->loop_wrap, p_cursor, idx, next, len, c);
+
+	if (p_ok)
+		*p_ok = result;
+	if (!result)
+		return TransformKey();
+
+	float tr = tt->compressed_transforms[idx].transition;
+
+	if (tr == 0 || idx == next || tt->interpolation == INTERPOLATION_NEAREST) {
+		// don't interpolate if not needed
+		return _transform_track_get_compressed_key(tt, idx);
+	}
+
+	if (tr != 1.0) {
+
+		c = Math::ease(c, tr);
+	}
+
+	if (tt->interpolation == INTERPOLATION_CUBIC) {
+
+		int pre = idx - 1;
+		if (pre < 0)
+			pre = 0;
+		int post = next + 1;
+		if (post >= len)
+			post = next;
+
+		return _cubic_interpolate(_transform_track_get_compressed_key(tt, pre), _transform_track_get_compressed_key(tt, idx), _transform_track_get_compressed_key(tt, next), _transform_track_get_compressed_key(tt, post), c);
+	}
+
+	return _interpolate(_transform_track_get_compressed_key(tt, idx), _transform_track_get_compressed_key(tt, next), c);
+}
+
+Error Animation::transform_track_interpolate(int p_track, float p_time, Vector3 *r_loc, Quat *r_rot, Vector3 *r_scale, int *p_cursor) const {
 
 	ERR_FAIL_INDEX_V(p_track, tracks.size(), ERR_INVALID_PARAMETER);
 	Track *t = tracks[p_track];
@@ -1789,7 +1926,11 @@ Error Animation::transform_track_interpolate(int p_track, float p_time, Vector3
 
 	bool ok = false;
 
-	TransformKey tk = _interpolate(tt->transforms, p_time, tt->interpolation, tt->loop_wrap, &ok);
+	TransformKey tk;
+	if (tt->compressed)
+		tk = _transform_track_interpolate_compressed(tt, p_time, &ok, p_cursor);
+	else
+		tk = _interpolate(tt->transforms, p_time, tt->interpolation, tt->loop_wrap, &ok, p_cursor);
 
 	if (!ok)
 		return ERR_UNAVAILABLE;
@@ -1806,7 +1947,7 @@ Error Animation::transform_track_interpolate(int p_track, float p_time, Vector3
 	return OK;
 }
 
-Variant Animation::value_track_interpolate(int p_track, float p_time) const {
+Variant Animation::value_track_interpolate(int p_track, float p_time, int *p_cursor) const {
 
 	ERR_FAIL_INDEX_V(p_track, tracks.size(), 0);
 	Track *t = tracks[p_track];
@@ -1815,7 +1956,7 @@ Variant Animation::value_track_interpolate(int p_track, float p_time) const {
 
 	bool ok = false;
 
-	Variant res = _interpolate(vt->values, p_time, vt->update_mode == UPDATE_CONTINUOUS ? vt->interpolation : INTERPOLATION_NEAREST, vt->loop_wrap, &ok);
+	Variant res = _interpolate(vt->values, p_time, vt->update_mode == UPDATE_CONTINUOUS ? vt->interpolation : INTERPOLATION_NEAREST, vt->loop_wrap, &ok, p_cursor);
 
 	if (ok) {
 
@@ -1976,8 +2117,13 @@ void Animation::track_get_key_indices_in_range(int p_track, float p_time, float
 				case TYPE_TRANSFORM: {
 
 					const TransformTrack *tt = static_cast<const TransformTrack *>(t);
-					_track_get_key_indices_in_range(tt->transforms, from_time, length, p_indices);
-					_track_get_key_indices_in_range(tt->transforms, 0, to_time, p_indices);
+					if (tt->compressed) {
+						_track_get_key_indices_in_range(tt->compressed_transforms, from_time, length, p_indices);
+						_track_get_key_indices_in_range(tt->compressed_transforms, 0, to_time, p_indices);
+					} else {
+						_track_get_key_indices_in_range(tt->transforms, from_time, length, p_indices);
+						_track_get_key_indices_in_range(tt->transforms, 0, to_time, p_indices);
+					}
 
 				} break;
 				case TYPE_VALUE: {
@@ -2036,7 +2182,10 @@ void Animation::track_get_key_indices_in_range(int p_track, float p_time, float
 		case TYPE_TRANSFORM: {
 
 			const TransformTrack *tt = static_cast<const TransformTrack *>(t);
-			_track_get_key_indices_in_range(tt->transforms, from_time, to_time, p_indices);
+			if (tt->compressed)
+				_track_get_key_indices_in_range(tt->compressed_transforms, from_time, to_time, p_indices);
+			else
+				_track_get_key_indices_in_range(tt->transforms, from_time, to_time, p_indices);
 
 		} break;
 		case TYPE_VALUE: {
@@ -2648,6 +2797,8 @@ void Animation::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("track_is_enabled", "idx"), &Animation::track_is_enabled);
 
 	ClassDB::bind_method(D_METHOD("transform_track_insert_key", "idx", "time", "location", "rotation", "scale"), &Animation::transform_track_insert_key);
+	ClassDB::bind_method(D_METHOD("transform_track_set_compressed", "idx", "compressed"), &Animation::transform_track_set_compressed);
+	ClassDB::bind_method(D_METHOD("transform_track_is_compressed", "idx"), &Animation::transform_track_is_compressed);
 	ClassDB::bind_method(D_METHOD("track_insert_key", "idx", "time", "key", "transition"), &Animation::track_insert_key, DEFVAL(1));
 	ClassDB::bind_method(D_METHOD("track_remove_key", "idx", "key_idx"), &Animation::track_remove_key);
 	ClassDB::bind_method(D_METHOD("track_remove_key_at_position", "idx", "position"), &Animation::track_remove_key_at_position);
@@ -2918,6 +3069,8 @@ void Animation::_transform_track_optimize(int p_idx, float p_allowed_linear_err,
 	ERR_FAIL_INDEX(p_idx, tracks.size());
 	ERR_FAIL_COND(tracks[p_idx]->type != TYPE_TRANSFORM);
 	TransformTrack *tt = static_cast<TransformTrack *>(tracks[p_idx]);
+	if (tt->compressed)
+		return; // already optimized and quantized, don't drift further
 	bool prev_erased = false;
 	TKey<TransformKey> first_erased;
 
@@ -2956,6 +3109,115 @@ void Animation::_transform_track_optimize(int p_idx, float p_allowed_linear_err,
 	}
 }
 
+void Animation::_transform_track_compress(TransformTrack *tt) {
+
+	ERR_FAIL_COND(tt->compressed);
+
+	int key_count = tt->transforms.size();
+	int page_count = (key_count + ANIM_COMPRESSION_PAGE_SIZE - 1) / ANIM_COMPRESSION_PAGE_SIZE;
+
+	tt->compressed_transforms.resize(key_count);
+	tt->compressed_pages.resize(page_count);
+
+	for (int i = 0; i < page_count; i++) {
+
+		int from = i * ANIM_COMPRESSION_PAGE_SIZE;
+		int to = MIN(from + ANIM_COMPRESSION_PAGE_SIZE, key_count);
+
+		AABB loc_bounds(tt->transforms[from].value.loc, Vector3());
+		AABB scale_bounds(tt->transforms[from].value.scale, Vector3());
+		for (int j = from + 1; j < to; j++) {
+			loc_bounds.expand_to(tt->transforms[j].value.loc);
+			scale_bounds.expand_to(tt->transforms[j].value.scale);
+		}
+
+		CompressedTransformPage &page = tt->compressed_pages.write[i];
+		page.loc_from = loc_bounds.position;
+		page.loc_range = loc_bounds.size;
+		page.scale_from = scale_bounds.position;
+		page.scale_range = scale_bounds.size;
+
+		for (int j = from; j < to; j++) {
+
+			const TKey<TransformKey> &tk = tt->transforms[j];
+			CompressedTransformKey &ck = tt->compressed_transforms.write[j];
+			ck.time = tk.time;
+			ck.transition = tk.transition;
+
+			Quat rot = tk.value.rot.normalized();
+			for (int k = 0; k < 3; k++) {
+				ck.loc[k] = page.loc_range[k] > CMP_EPSILON ? (uint16_t)Math::round(CLAMP((tk.value.loc[k] - page.loc_from[k]) / page.loc_range[k], 0.0, 1.0) * 65535.0) : 0;
+				ck.scale[k] = page.scale_range[k] > CMP_EPSILON ? (uint16_t)Math::round(CLAMP((tk.value.scale[k] - page.scale_from[k]) / page.scale_range[k], 0.0, 1.0) * 65535.0) : 0;
+			}
+			ck.rot[0] = (int16_t)Math::round(CLAMP(rot.x, -1.0, 1.0) * 32767.0);
+			ck.rot[1] = (int16_t)Math::round(CLAMP(rot.y, -1.0, 1.0) * 32767.0);
+			ck.rot[2] = (int16_t)Math::round(CLAMP(rot.z, -1.0, 1.0) * 32767.0);
+			ck.rot[3] = (int16_t)Math::round(CLAMP(rot.w, -1.0, 1.0) * 32767.0);
+		}
+	}
+
+	tt->transforms.clear();
+	tt->compressed = true;
+}
+
+void Animation::_transform_track_decompress(TransformTrack *tt) {
+
+	if (!tt->compressed)
+		return;
+
+	int key_count = tt->compressed_transforms.size();
+	tt->transforms.resize(key_count);
+
+	for (int i = 0; i < key_count; i++) {
+
+		TKey<TransformKey> &tk = tt->transforms.write[i];
+		tk.time = tt->compressed_transforms[i].time;
+		tk.transition = tt->compressed_transforms[i].transition;
+		tk.value = _transform_track_get_compressed_key(tt, i);
+	}
+
+	tt->compressed_transforms.clear();
+	tt->compressed_pages.clear();
+	tt->compressed = false;
+}
+
+Animation::TransformKey Animation::_transform_track_get_compressed_key(const TransformTrack *tt, int p_key) const {
+
+	const CompressedTransformKey &ck = tt->compressed_transforms[p_key];
+	const CompressedTransformPage &page = tt->compressed_pages[p_key / ANIM_COMPRESSION_PAGE_SIZE];
+
+	TransformKey tk;
+	tk.loc = page.loc_from + page.loc_range * Vector3(ck.loc[0], ck.loc[1], ck.loc[2]) * (1.0 / 65535.0);
+	tk.scale = page.scale_from + page.scale_range * Vector3(ck.scale[0], ck.scale[1], ck.scale[2]) * (1.0 / 65535.0);
+	tk.rot = Quat(ck.rot[0], ck.rot[1], ck.rot[2], ck.rot[3]).normalized();
+
+	return tk;
+}
+
+void Animation::transform_track_set_compressed(int p_track, bool p_compressed) {
+
+	ERR_FAIL_INDEX(p_track, tracks.size());
+	ERR_FAIL_COND(tracks[p_track]->type != TYPE_TRANSFORM);
+	TransformTrack *tt = static_cast<TransformTrack *>(tracks[p_track]);
+
+	if (tt->compressed == p_compressed)
+		return;
+
+	if (p_compressed)
+		_transform_track_compress(tt);
+	else
+		_transform_track_decompress(tt);
+
+	emit_changed();
+}
+
+bool Animation::transform_track_is_compressed(int p_track) const {
+
+	ERR_FAIL_INDEX_V(p_track, tracks.size(), false);
+	ERR_FAIL_COND_V(tracks[p_track]->type != TYPE_TRANSFORM, false);
+	return static_cast<const TransformTrack *>(tracks[p_track])->compressed;
+}
+
 void Animation::optimize(float p_allowed_linear_err, float p_allowed_angular_err, float p_max_optimizable_angle) {
 
 	for (int i = 0; i < tracks.size(); i++) {
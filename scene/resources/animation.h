@@ -93,7 +93,6 @@ private:
 	template <class T>
 	struct TKey : public Key {
 
-		float time;
 		T value;
 	};
 
@@ -104,13 +103,38 @@ private:
 		Vector3 scale;
 	};
 
+	// compressed transform key, components are quantized to 16 bits
+	// relative to the bounds of the page the key belongs to
+	struct CompressedTransformKey : public Key {
+
+		uint16_t loc[3];
+		int16_t rot[4];
+		uint16_t scale[3];
+	};
+
+	struct CompressedTransformPage {
+
+		Vector3 loc_from;
+		Vector3 loc_range;
+		Vector3 scale_from;
+		Vector3 scale_range;
+	};
+
 	/* TRANSFORM TRACK */
 
 	struct TransformTrack : public Track {
 
 		Vector<TKey<TransformKey> > transforms;
 
-		TransformTrack() { type = TYPE_TRANSFORM; }
+		// when compressed, keys are kept here and transforms is empty
+		bool compressed;
+		Vector<CompressedTransformKey> compressed_transforms;
+		Vector<CompressedTransformPage> compressed_pages;
+
+		TransformTrack() {
+			type = TYPE_TRANSFORM;
+			compressed = false;
+		}
 	};
 
 	/* PROPERTY VALUE TRACK */
@@ -203,7 +227,7 @@ private:
 	int _insert(float p_time, T &p_keys, const V &p_value);
 
 	template <class K>
-	inline int _find(const Vector<K> &p_keys, float p_time) const;
+	inline int _find(const Vector<K> &p_keys, float p_time, int *p_cursor = NULL) const;
 
 	_FORCE_INLINE_ Animation::TransformKey _interpolate(const Animation::TransformKey &p_a, const Animation::TransformKey &p_b, float p_c) const;
 
@@ -218,8 +242,16 @@ private:
 	_FORCE_INLINE_ Variant _cubic_interpolate(const Variant &p_pre_a, const Variant &p_a, const Variant &p_b, const Variant &p_post_b, float p_c) const;
 	_FORCE_INLINE_ float _cubic_interpolate(const float &p_pre_a, const float &p_a, const float &p_b, const float &p_post_b, float p_c) const;
 
+	template <class K>
+	_FORCE_INLINE_ bool _find_interpolation_keys(const Vector<K> &p_keys, float p_time, bool p_loop_wrap, int *p_cursor, int &r_idx, int &r_next, int &r_len, float &r_c) const;
+
 	template <class T>
-	_FORCE_INLINE_ T _interpolate(const Vector<TKey<T> > &p_keys, float p_time, InterpolationType p_interp, bool p_loop_wrap, bool *p_ok) const;
+	_FORCE_INLINE_ T _interpolate(const Vector<TKey<T> > &p_keys, float p_time, InterpolationType p_interp, bool p_loop_wrap, bool *p_ok, int *p_cursor) const;
+
+	void _transform_track_compress(TransformTrack *tt);
+	void _transform_track_decompress(TransformTrack *tt);
+	TransformKey _transform_track_get_compressed_key(const TransformTrack *tt, int p_key) const;
+	TransformKey _transform_track_interpolate_compressed(const TransformTrack *tt, float p_time, bool *p_ok, int *p_cursor) const;
 
 	template <class T>
 	_FORCE_INLINE_ void _track_get_key_indices_in_range(const Vector<T> &p_array, float from_time, float to_time, List<int> *p_indices) const;
@@ -343,9 +375,13 @@ public:
 	void track_set_interpolation_loop_wrap(int p_track, bool p_enable);
 	bool track_get_interpolation_loop_wrap(int p_track) const;
 
-	Error transform_track_interpolate(int p_track, float p_time, Vector3 *r_loc, Quat *r_rot, Vector3 *r_scale) const;
+	void transform_track_set_compressed(int p_track, bool p_compressed);
+	bool transform_track_is_compressed(int p_track) const;
+
+	// p_cursor is an optional per-playback key hint, keeping it between calls makes sequential sampling O(1)
+	Error transform_track_interpolate(int p_track, float p_time, Vector3 *r_loc, Quat *r_rot, Vector3 *r_scale, int *p_cursor = NULL) const;
 
-	Variant value_track_interpolate(int p_track, float p_time) const;
+	Variant value_track_interpolate(int p_track, float p_time, int *p_cursor = NULL) const;
 	void value_track_get_key_indices(int p_track, float p_time, float p_delta, List<int> *p_indices) const;
 	void value_track_set_update_mode(int p_track, UpdateMode p_mode);
 	UpdateMode value_track_get_update_mode(int p_track) const;
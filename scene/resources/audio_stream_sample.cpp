@@ -70,6 +70,26 @@ int AudioStreamPlaybackSample::get_loop_count() const {
 	return 0;
 }
 
+bool AudioStreamPlaybackSample::is_looping() const {
+
+	return base->loop_mode != AudioStreamSample::LOOP_DISABLED;
+}
+
+float AudioStreamPlaybackSample::get_loop_begin() const {
+
+	return float(base->loop_begin) / base->mix_rate;
+}
+
+float AudioStreamPlaybackSample::get_loop_end() const {
+
+	return float(base->loop_end) / base->mix_rate;
+}
+
+bool AudioStreamPlaybackSample::is_loop_ping_pong() const {
+
+	return base->loop_mode == AudioStreamSample::LOOP_PING_PONG;
+}
+
 float AudioStreamPlaybackSample::get_playback_position() const {
 
 	return float(offset >> MIX_FRAC_BITS) / base->mix_rate;
@@ -71,6 +71,10 @@ public:
 	virtual bool is_playing() const;
 
 	virtual int get_loop_count() const; //times it looped
+	virtual bool is_looping() const;
+	virtual float get_loop_begin() const;
+	virtual float get_loop_end() const;
+	virtual bool is_loop_ping_pong() const;
 
 	virtual float get_playback_position() const;
 	virtual void seek(float p_time);
@@ -30,8 +30,13 @@
 
 #ifdef FREETYPE_ENABLED
 #include "dynamic_font.h"
+#include "core/engine.h"
+#include "core/io/marshalls.h"
+#include "core/message_queue.h"
+#include "core/os/dir_access.h"
 #include "core/os/file_access.h"
 #include "core/os/os.h"
+#include "core/project_settings.h"
 
 #include FT_STROKER_H
 
@@ -65,6 +70,7 @@ void DynamicFontData::set_font_ptr(const uint8_t *p_font_mem, int p_font_mem_siz
 
 	font_mem = p_font_mem;
 	font_mem_size = p_font_mem_size;
+	font_mem_copy.clear();
 }
 
 void DynamicFontData::set_font_path(const String &p_path) {
@@ -81,12 +87,253 @@ void DynamicFontData::set_force_autohinter(bool p_force) {
 	force_autohinter = p_force;
 }
 
+int DynamicFontData::max_atlas_textures = 0;
+
+DynamicFontData::TexturePosition DynamicFontData::_find_texture_pos_for_glyph(Image::Format p_image_format, uint32_t p_flags, int p_width, int p_height, int p_min_texture_size) {
+	TexturePosition ret;
+	ret.index = -1;
+	ret.x = 0;
+	ret.y = 0;
+
+	int mw = p_width;
+	int mh = p_height;
+
+	for (int i = 0; i < textures.size(); i++) {
+
+		const CharTexture &ct = textures[i];
+
+		if (ct.format != p_image_format || ct.flags != p_flags)
+			continue;
+
+		if (mw > ct.texture_size || mh > ct.texture_size) //too big for this texture
+			continue;
+
+		ret.y = 0x7FFFFFFF;
+		ret.x = 0;
+
+		for (int j = 0; j < ct.texture_size - mw; j++) {
+
+			int max_y = 0;
+
+			for (int k = j; k < j + mw; k++) {
+
+				int y = ct.offsets[k];
+				if (y > max_y)
+					max_y = y;
+			}
+
+			if (max_y < ret.y) {
+				ret.y = max_y;
+				ret.x = j;
+			}
+		}
+
+		if (ret.y == 0x7FFFFFFF || ret.y + mh > ct.texture_size)
+			continue; //fail, could not fit it here
+
+		ret.index = i;
+		break;
+	}
+
+	if (ret.index == -1) {
+		//could not find texture to fit, create one or reuse the least recently drawn one
+		ret.x = 0;
+		ret.y = 0;
+
+		int texsize = MAX(p_min_texture_size, 256);
+		if (mw > texsize)
+			texsize = mw; //special case, adapt to it?
+		if (mh > texsize)
+			texsize = mh; //special case, adapt to it?
+
+		texsize = next_power_of_2(texsize);
+
+		texsize = MIN(texsize, 4096);
+
+		if (max_atlas_textures > 0 && textures.size() >= max_atlas_textures) {
+
+			// pages drawn this frame are still referenced by canvas items, never evict those
+			uint64_t frame = Engine::get_singleton()->get_frames_drawn();
+			for (int i = 0; i < textures.size(); i++) {
+				if (textures[i].last_used < frame && (ret.index == -1 || textures[i].last_used < textures[ret.index].last_used)) {
+					ret.index = i;
+				}
+			}
+
+			if (ret.index != -1) {
+				_evict_texture(ret.index);
+			}
+		}
+
+		if (ret.index == -1) {
+			textures.push_back(CharTexture());
+			ret.index = textures.size() - 1;
+			textures.write[ret.index].texture.instance();
+		}
+
+		int color_size = Image::get_format_pixel_size(p_image_format);
+
+		CharTexture &tex = textures.write[ret.index];
+		tex.texture_size = texsize;
+		tex.format = p_image_format;
+		tex.flags = p_flags;
+		tex.dirty = false;
+		tex.last_used = 0;
+		tex.imgdata.resize(texsize * texsize * color_size);
+
+		{
+			//zero texture
+			PoolVector<uint8_t>::Write w = tex.imgdata.write();
+			ERR_FAIL_COND_V(texsize * texsize * color_size > tex.imgdata.size(), ret);
+			zeromem(w.ptr(), texsize * texsize * color_size);
+		}
+		tex.offsets.resize(texsize);
+		for (int i = 0; i < texsize; i++) //zero offsets
+			tex.offsets.write[i] = 0;
+
+		// the same texture is kept when a page is reused, so its RID stays valid until controls redraw
+		Ref<Image> img = memnew(Image(texsize, texsize, 0, p_image_format, tex.imgdata));
+		tex.texture->create_from_image(img, Texture::FLAG_VIDEO_SURFACE | p_flags);
+	}
+
+	return ret;
+}
+
+void DynamicFontData::_evict_texture(int p_index) {
+
+	CharTexture &tex = textures.write[p_index];
+
+	for (int i = 0; i < tex.chars.size(); i++) {
+		tex.chars[i].first->char_map.erase(tex.chars[i].second);
+	}
+	tex.chars.clear();
+
+	// glyphs that used this page must be laid out and drawn again
+	if (!fonts_changed_queued) {
+		fonts_changed_queued = true;
+		MessageQueue::get_singleton()->push_call(this, "_emit_fonts_changed");
+	}
+}
+
+void DynamicFontData::_remove_chars(DynamicFontAtSize *p_font) {
+
+	for (int i = 0; i < textures.size(); i++) {
+
+		CharTexture &tex = textures.write[i];
+		int count = tex.chars.size();
+
+		for (int j = tex.chars.size() - 1; j >= 0; j--) {
+			if (tex.chars[j].first == p_font) {
+				tex.chars.remove(j);
+			}
+		}
+
+		if (tex.chars.size() != count && tex.chars.empty()) {
+			// nothing left in this page, start filling it from the top again
+			for (int j = 0; j < tex.offsets.size(); j++)
+				tex.offsets.write[j] = 0;
+		}
+	}
+}
+
+void DynamicFontData::_update_textures() {
+
+	if (atlas_mutex)
+		atlas_mutex->lock();
+
+	textures_update_queued = false;
+
+	for (int i = 0; i < textures.size(); i++) {
+
+		CharTexture &tex = textures.write[i];
+		if (!tex.dirty)
+			continue;
+
+		Ref<Image> img = memnew(Image(tex.texture_size, tex.texture_size, 0, tex.format, tex.imgdata));
+		tex.texture->set_data(img);
+		tex.dirty = false;
+	}
+
+	if (atlas_mutex)
+		atlas_mutex->unlock();
+}
+
+void DynamicFontData::_emit_fonts_changed() {
+
+	fonts_changed_queued = false;
+
+	Vector<Ref<DynamicFont> > changed;
+
+	if (DynamicFont::dynamic_font_mutex)
+		DynamicFont::dynamic_font_mutex->lock();
+
+	SelfList<DynamicFont> *E = DynamicFont::dynamic_fonts.first();
+	while (E) {
+
+		DynamicFont *df = E->self();
+		bool uses = df->data.ptr() == this;
+		for (int i = 0; !uses && i < df->fallbacks.size(); i++) {
+			uses = df->fallbacks[i].ptr() == this;
+		}
+
+		if (uses) {
+			changed.push_back(Ref<DynamicFont>(df));
+		}
+		E = E->next();
+	}
+
+	if (DynamicFont::dynamic_font_mutex)
+		DynamicFont::dynamic_font_mutex->unlock();
+
+	for (int i = 0; i < changed.size(); i++) {
+		changed.write[i]->emit_changed();
+	}
+}
+
+Vector<uint8_t> DynamicFontData::_get_font_mem_copy() const {
+
+	if (font_mem && font_mem_copy.empty()) {
+		font_mem_copy.resize(font_mem_size);
+		copymem(font_mem_copy.ptrw(), font_mem, font_mem_size);
+	}
+	return font_mem_copy;
+}
+
+void DynamicFontData::_add_prerendered_glyphs(uint32_t p_cache_id, float p_oversampling, const PoolVector<uint8_t> &p_glyphs) {
+
+	CacheID id;
+	id.key = p_cache_id;
+
+	if (!size_cache.has(id))
+		return; // the size was freed while its glyphs were rendered
+
+	DynamicFontAtSize *dfas = size_cache[id];
+	if (!dfas->valid || dfas->oversampling != p_oversampling)
+		return;
+
+	HashMap<CharType, DynamicFontAtSize::Glyph> glyphs;
+	PoolVector<uint8_t>::Read r = p_glyphs.read();
+	ERR_FAIL_COND(DynamicFontAtSize::_decode_glyphs(r.ptr(), p_glyphs.size(), glyphs) != OK);
+
+	const CharType *k = NULL;
+	while ((k = glyphs.next(k))) {
+		if (!dfas->char_map.has(*k)) {
+			dfas->prerendered.set(*k, glyphs[*k]);
+			dfas->glyph_cache_dirty = true;
+		}
+	}
+}
+
 void DynamicFontData::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("set_font_path", "path"), &DynamicFontData::set_font_path);
 	ClassDB::bind_method(D_METHOD("get_font_path"), &DynamicFontData::get_font_path);
 	ClassDB::bind_method(D_METHOD("set_hinting", "mode"), &DynamicFontData::set_hinting);
 	ClassDB::bind_method(D_METHOD("get_hinting"), &DynamicFontData::get_hinting);
 
+	ClassDB::bind_method(D_METHOD("_update_textures"), &DynamicFontData::_update_textures);
+	ClassDB::bind_method(D_METHOD("_emit_fonts_changed"), &DynamicFontData::_emit_fonts_changed);
+	ClassDB::bind_method(D_METHOD("_add_prerendered_glyphs"), &DynamicFontData::_add_prerendered_glyphs);
+
 	ADD_PROPERTY(PropertyInfo(Variant::INT, "hinting", PROPERTY_HINT_ENUM, "None,Light,Normal"), "set_hinting", "get_hinting");
 
 	BIND_ENUM_CONSTANT(HINTING_NONE);
@@ -102,75 +349,56 @@ DynamicFontData::DynamicFontData() {
 	hinting = DynamicFontData::HINTING_NORMAL;
 	font_mem = NULL;
 	font_mem_size = 0;
+	atlas_mutex = Mutex::create();
+	textures_update_queued = false;
+	fonts_changed_queued = false;
 }
 
 DynamicFontData::~DynamicFontData() {
+
+	if (atlas_mutex)
+		memdelete(atlas_mutex);
 }
 
 ////////////////////
 HashMap<String, Vector<uint8_t> > DynamicFontAtSize::_fontdata;
 
-Error DynamicFontAtSize::_load() {
+Error DynamicFontAtSize::_open_face(const RasterSettings &p_settings, FT_Library p_library, FT_StreamRec *r_stream, FT_Face *r_face, float *r_scale_color_font) {
 
-	int error = FT_Init_FreeType(&library);
+	int error;
 
-	ERR_EXPLAIN(TTR("Error initializing FreeType."));
-	ERR_FAIL_COND_V(error != 0, ERR_CANT_CREATE);
+	if (p_settings.font_mem == NULL && p_settings.font_path != String()) {
 
-	// FT_OPEN_STREAM is extremely slow only on Android.
-	if (OS::get_singleton()->get_name() == "Android" && font->font_mem == NULL && font->font_path != String()) {
-		// cache font only once for each font->font_path
-		if (_fontdata.has(font->font_path)) {
-
-			font->set_font_ptr(_fontdata[font->font_path].ptr(), _fontdata[font->font_path].size());
-
-		} else {
-
-			FileAccess *f = FileAccess::open(font->font_path, FileAccess::READ);
-			ERR_FAIL_COND_V(!f, ERR_CANT_OPEN);
-
-			size_t len = f->get_len();
-			_fontdata[font->font_path] = Vector<uint8_t>();
-			Vector<uint8_t> &fontdata = _fontdata[font->font_path];
-			fontdata.resize(len);
-			f->get_buffer(fontdata.ptrw(), len);
-			font->set_font_ptr(fontdata.ptr(), len);
-			f->close();
-		}
-	}
-
-	if (font->font_mem == NULL && font->font_path != String()) {
-
-		FileAccess *f = FileAccess::open(font->font_path, FileAccess::READ);
+		FileAccess *f = FileAccess::open(p_settings.font_path, FileAccess::READ);
 		ERR_FAIL_COND_V(!f, ERR_CANT_OPEN);
 
-		memset(&stream, 0, sizeof(FT_StreamRec));
-		stream.base = NULL;
-		stream.size = f->get_len();
-		stream.pos = 0;
-		stream.descriptor.pointer = f;
-		stream.read = _ft_stream_io;
-		stream.close = _ft_stream_close;
+		memset(r_stream, 0, sizeof(FT_StreamRec));
+		r_stream->base = NULL;
+		r_stream->size = f->get_len();
+		r_stream->pos = 0;
+		r_stream->descriptor.pointer = f;
+		r_stream->read = _ft_stream_io;
+		r_stream->close = _ft_stream_close;
 
 		FT_Open_Args fargs;
 		memset(&fargs, 0, sizeof(FT_Open_Args));
 		fargs.flags = FT_OPEN_STREAM;
-		fargs.stream = &stream;
-		error = FT_Open_Face(library, &fargs, 0, &face);
-	} else if (font->font_mem) {
+		fargs.stream = r_stream;
+		error = FT_Open_Face(p_library, &fargs, 0, r_face);
+	} else if (p_settings.font_mem) {
 
-		memset(&stream, 0, sizeof(FT_StreamRec));
-		stream.base = (unsigned char *)font->font_mem;
-		stream.size = font->font_mem_size;
-		stream.pos = 0;
+		memset(r_stream, 0, sizeof(FT_StreamRec));
+		r_stream->base = (unsigned char *)p_settings.font_mem;
+		r_stream->size = p_settings.font_mem_size;
+		r_stream->pos = 0;
 
 		FT_Open_Args fargs;
 		memset(&fargs, 0, sizeof(FT_Open_Args));
-		fargs.memory_base = (unsigned char *)font->font_mem;
-		fargs.memory_size = font->font_mem_size;
+		fargs.memory_base = (unsigned char *)p_settings.font_mem;
+		fargs.memory_size = p_settings.font_mem_size;
 		fargs.flags = FT_OPEN_MEMORY;
-		fargs.stream = &stream;
-		error = FT_Open_Face(library, &fargs, 0, &face);
+		fargs.stream = r_stream;
+		error = FT_Open_Face(p_library, &fargs, 0, r_face);
 
 	} else {
 		ERR_EXPLAIN("DynamicFont uninitialized");
@@ -181,12 +409,10 @@ Error DynamicFontAtSize::_load() {
 
 	if (error == FT_Err_Unknown_File_Format) {
 		ERR_EXPLAIN(TTR("Unknown font format."));
-		FT_Done_FreeType(library);
 
 	} else if (error) {
 
 		ERR_EXPLAIN(TTR("Error loading font."));
-		FT_Done_FreeType(library);
 	}
 
 	ERR_FAIL_COND_V(error, ERR_FILE_CANT_OPEN);
@@ -199,21 +425,62 @@ Error DynamicFontAtSize::_load() {
 		ERR_FAIL_COND_V( error, ERR_INVALID_PARAMETER );
 	}*/
 
+	FT_Face face = *r_face;
+	int size = p_settings.id.size;
+
 	if (FT_HAS_COLOR(face)) {
 		int best_match = 0;
-		int diff = ABS(id.size - face->available_sizes[0].width);
-		scale_color_font = float(id.size) / face->available_sizes[0].width;
+		int diff = ABS(size - face->available_sizes[0].width);
+		*r_scale_color_font = float(size) / face->available_sizes[0].width;
 		for (int i = 1; i < face->num_fixed_sizes; i++) {
-			int ndiff = ABS(id.size - face->available_sizes[i].width);
+			int ndiff = ABS(size - face->available_sizes[i].width);
 			if (ndiff < diff) {
 				best_match = i;
 				diff = ndiff;
-				scale_color_font = float(id.size) / face->available_sizes[i].width;
+				*r_scale_color_font = float(size) / face->available_sizes[i].width;
 			}
 		}
 		FT_Select_Size(face, best_match);
 	} else {
-		FT_Set_Pixel_Sizes(face, 0, id.size * oversampling);
+		FT_Set_Pixel_Sizes(face, 0, size * p_settings.oversampling);
+	}
+
+	return OK;
+}
+
+Error DynamicFontAtSize::_load() {
+
+	int error = FT_Init_FreeType(&library);
+
+	ERR_EXPLAIN(TTR("Error initializing FreeType."));
+	ERR_FAIL_COND_V(error != 0, ERR_CANT_CREATE);
+
+	// FT_OPEN_STREAM is extremely slow only on Android.
+	if (OS::get_singleton()->get_name() == "Android" && font->font_mem == NULL && font->font_path != String()) {
+		// cache font only once for each font->font_path
+		if (_fontdata.has(font->font_path)) {
+
+			font->set_font_ptr(_fontdata[font->font_path].ptr(), _fontdata[font->font_path].size());
+
+		} else {
+
+			FileAccess *f = FileAccess::open(font->font_path, FileAccess::READ);
+			ERR_FAIL_COND_V(!f, ERR_CANT_OPEN);
+
+			size_t len = f->get_len();
+			_fontdata[font->font_path] = Vector<uint8_t>();
+			Vector<uint8_t> &fontdata = _fontdata[font->font_path];
+			fontdata.resize(len);
+			f->get_buffer(fontdata.ptrw(), len);
+			font->set_font_ptr(fontdata.ptr(), len);
+			f->close();
+		}
+	}
+
+	Error err = _open_face(_get_raster_settings(), library, &stream, &face, &scale_color_font);
+	if (err != OK) {
+		FT_Done_FreeType(library);
+		return err;
 	}
 
 	ascent = (face->size->metrics.ascender / 64.0) / oversampling * scale_color_font;
@@ -226,10 +493,16 @@ Error DynamicFontAtSize::_load() {
 		texture_flags |= Texture::FLAG_FILTER;
 
 	valid = true;
+
+	if (use_glyph_cache) {
+		_load_glyph_cache();
+	}
+
 	return OK;
 }
 
 float DynamicFontAtSize::font_oversampling = 1.0;
+bool DynamicFontAtSize::use_glyph_cache = false;
 
 float DynamicFontAtSize::get_height() const {
 
@@ -312,12 +585,12 @@ Size2 DynamicFontAtSize::get_char_size(CharType p_char, CharType p_next, const V
 
 void DynamicFontAtSize::set_texture_flags(uint32_t p_flags) {
 
+	if (texture_flags == p_flags)
+		return;
+
+	// atlas pages are shared with other sizes, so glyphs move to pages with the new flags
 	texture_flags = p_flags;
-	for (int i = 0; i < textures.size(); i++) {
-		Ref<ImageTexture> &tex = textures.write[i].texture;
-		if (!tex.is_null())
-			tex->set_flags(p_flags);
-	}
+	_clear_chars();
 }
 
 float DynamicFontAtSize::draw_char(RID p_canvas_item, const Point2 &p_pos, CharType p_char, CharType p_next, const Color &p_modulate, const Vector<Ref<DynamicFontAtSize> > &p_fallbacks, bool p_advance_only) const {
@@ -336,7 +609,7 @@ float DynamicFontAtSize::draw_char(RID p_canvas_item, const Point2 &p_pos, CharT
 	float advance = 0.0;
 
 	if (ch->found) {
-		ERR_FAIL_COND_V(ch->texture_idx < -1 || ch->texture_idx >= font->textures.size(), 0);
+		ERR_FAIL_COND_V(ch->texture_idx < -1 || ch->texture_idx >= font->font->textures.size(), 0);
 
 		if (!p_advance_only && ch->texture_idx != -1) {
 			Point2 cpos = p_pos;
@@ -347,7 +620,9 @@ float DynamicFontAtSize::draw_char(RID p_canvas_item, const Point2 &p_pos, CharT
 			if (FT_HAS_COLOR(face)) {
 				modulate.r = modulate.g = modulate.b = 1.0;
 			}
-			RID texture = font->textures[ch->texture_idx].texture->get_rid();
+			DynamicFontData::CharTexture &tex = font->font->textures.write[ch->texture_idx];
+			tex.last_used = Engine::get_singleton()->get_frames_drawn();
+			RID texture = tex.texture->get_rid();
 			VisualServer::get_singleton()->canvas_item_add_texture_rect_region(p_canvas_item, Rect2(cpos, ch->rect.size * Vector2(font->scale_color_font, font->scale_color_font)), texture, ch->rect_uv, modulate, false, RID(), false);
 		}
 
@@ -389,93 +664,122 @@ DynamicFontAtSize::Character DynamicFontAtSize::Character::not_found() {
 	return ch;
 }
 
-DynamicFontAtSize::TexturePosition DynamicFontAtSize::_find_texture_pos_for_glyph(int p_color_size, Image::Format p_image_format, int p_width, int p_height) {
-	TexturePosition ret;
-	ret.index = -1;
-	ret.x = 0;
-	ret.y = 0;
-
-	int mw = p_width;
-	int mh = p_height;
-
-	for (int i = 0; i < textures.size(); i++) {
-
-		const CharTexture &ct = textures[i];
-
-		if (ct.texture->get_format() != p_image_format)
-			continue;
-
-		if (mw > ct.texture_size || mh > ct.texture_size) //too big for this texture
-			continue;
+void DynamicFontAtSize::_bitmap_to_glyph(const RasterSettings &p_settings, const FT_Bitmap &p_bitmap, int p_yofs, int p_xofs, float p_advance, Glyph &r_glyph) {
+
+	int w = p_bitmap.width;
+	int h = p_bitmap.rows;
+
+	int color_size = p_bitmap.pixel_mode == FT_PIXEL_MODE_BGRA ? 4 : 2;
+
+	r_glyph.width = w;
+	r_glyph.height = h;
+	r_glyph.format = color_size == 4 ? Image::FORMAT_RGBA8 : Image::FORMAT_LA8;
+	r_glyph.pixels.resize(w * h * color_size);
+
+	uint8_t *wr = r_glyph.pixels.ptrw();
+
+	for (int i = 0; i < h; i++) {
+		for (int j = 0; j < w; j++) {
+
+			int ofs = (i * w + j) * color_size;
+			switch (p_bitmap.pixel_mode) {
+				case FT_PIXEL_MODE_MONO: {
+					int byte = i * p_bitmap.pitch + (j >> 3);
+					int bit = 1 << (7 - (j % 8));
+					wr[ofs + 0] = 255; //grayscale as 1
+					wr[ofs + 1] = p_bitmap.buffer[byte] & bit ? 255 : 0;
+				} break;
+				case FT_PIXEL_MODE_GRAY:
+					wr[ofs + 0] = 255; //grayscale as 1
+					wr[ofs + 1] = p_bitmap.buffer[i * p_bitmap.pitch + j];
+					break;
+				case FT_PIXEL_MODE_BGRA: {
+					int ofs_color = i * p_bitmap.pitch + (j << 2);
+					wr[ofs + 2] = p_bitmap.buffer[ofs_color + 0];
+					wr[ofs + 1] = p_bitmap.buffer[ofs_color + 1];
+					wr[ofs + 0] = p_bitmap.buffer[ofs_color + 2];
+					wr[ofs + 3] = p_bitmap.buffer[ofs_color + 3];
+				} break;
+				// TODO: FT_PIXEL_MODE_LCD
+				default:
+					ERR_EXPLAIN("Font uses unsupported pixel format: " + itos(p_bitmap.pixel_mode));
+					ERR_FAIL();
+					break;
+			}
+		}
+	}
 
-		ret.y = 0x7FFFFFFF;
-		ret.x = 0;
+	r_glyph.h_align = p_xofs * p_settings.scale_color_font / p_settings.oversampling;
+	r_glyph.v_align = p_settings.ascent - (p_yofs * p_settings.scale_color_font / p_settings.oversampling); // + ascent - descent;
+	r_glyph.advance = p_advance * p_settings.scale_color_font / p_settings.oversampling;
+	r_glyph.found = true;
+}
 
-		for (int j = 0; j < ct.texture_size - mw; j++) {
+bool DynamicFontAtSize::_rasterize_glyph(const RasterSettings &p_settings, FT_Library p_library, FT_Face p_face, CharType p_char, Glyph &r_glyph) {
 
-			int max_y = 0;
+	r_glyph = Glyph();
 
-			for (int k = j; k < j + mw; k++) {
+	if (FT_Get_Char_Index(p_face, p_char) == 0)
+		return false;
 
-				int y = ct.offsets[k];
-				if (y > max_y)
-					max_y = y;
-			}
-
-			if (max_y < ret.y) {
-				ret.y = max_y;
-				ret.x = j;
-			}
-		}
-
-		if (ret.y == 0x7FFFFFFF || ret.y + mh > ct.texture_size)
-			continue; //fail, could not fit it here
+	int ft_hinting;
 
-		ret.index = i;
-		break;
+	switch (p_settings.hinting) {
+		case DynamicFontData::HINTING_NONE:
+			ft_hinting = FT_LOAD_NO_HINTING;
+			break;
+		case DynamicFontData::HINTING_LIGHT:
+			ft_hinting = FT_LOAD_TARGET_LIGHT;
+			break;
+		default:
+			ft_hinting = FT_LOAD_TARGET_NORMAL;
+			break;
 	}
 
-	if (ret.index == -1) {
-		//could not find texture to fit, create one
-		ret.x = 0;
-		ret.y = 0;
+	int error = FT_Load_Char(p_face, p_char, FT_HAS_COLOR(p_face) ? FT_LOAD_COLOR : FT_LOAD_DEFAULT | (p_settings.force_autohinter ? FT_LOAD_FORCE_AUTOHINT : 0) | ft_hinting);
+	if (error)
+		return false;
 
-		int texsize = MAX(id.size * oversampling * 8, 256);
-		if (mw > texsize)
-			texsize = mw; //special case, adapt to it?
-		if (mh > texsize)
-			texsize = mh; //special case, adapt to it?
+	if (p_settings.id.outline_size > 0) {
 
-		texsize = next_power_of_2(texsize);
+		if (FT_Load_Char(p_face, p_char, FT_LOAD_NO_BITMAP | (p_settings.force_autohinter ? FT_LOAD_FORCE_AUTOHINT : 0)) != 0)
+			return false;
 
-		texsize = MIN(texsize, 4096);
+		FT_Stroker stroker;
+		if (FT_Stroker_New(p_library, &stroker) != 0)
+			return false;
 
-		CharTexture tex;
-		tex.texture_size = texsize;
-		tex.imgdata.resize(texsize * texsize * p_color_size); //grayscale alpha
+		FT_Stroker_Set(stroker, (int)(p_settings.id.outline_size * p_settings.oversampling * 64.0), FT_STROKER_LINECAP_BUTT, FT_STROKER_LINEJOIN_ROUND, 0);
 
-		{
-			//zero texture
-			PoolVector<uint8_t>::Write w = tex.imgdata.write();
-			ERR_FAIL_COND_V(texsize * texsize * p_color_size > tex.imgdata.size(), ret);
-			for (int i = 0; i < texsize * texsize * p_color_size; i++) {
-				w[i] = 0;
+		FT_Glyph glyph;
+		if (FT_Get_Glyph(p_face->glyph, &glyph) == 0) {
+
+			if (FT_Glyph_Stroke(&glyph, stroker, 1) == 0 && FT_Glyph_To_Bitmap(&glyph, FT_RENDER_MODE_NORMAL, 0, 1) == 0) {
+				FT_BitmapGlyph glyph_bitmap = (FT_BitmapGlyph)glyph;
+				_bitmap_to_glyph(p_settings, glyph_bitmap->bitmap, glyph_bitmap->top, glyph_bitmap->left, glyph->advance.x / 65536.0, r_glyph);
 			}
+			FT_Done_Glyph(glyph);
 		}
-		tex.offsets.resize(texsize);
-		for (int i = 0; i < texsize; i++) //zero offsets
-			tex.offsets.write[i] = 0;
+		FT_Stroker_Done(stroker);
+
+	} else {
 
-		textures.push_back(tex);
-		ret.index = textures.size() - 1;
+		FT_GlyphSlot slot = p_face->glyph;
+		error = FT_Render_Glyph(slot, FT_RENDER_MODE_NORMAL);
+		if (!error)
+			_bitmap_to_glyph(p_settings, slot->bitmap, slot->bitmap_top, slot->bitmap_left, slot->advance.x / 64.0, r_glyph);
 	}
 
-	return ret;
+	return r_glyph.found;
 }
 
-DynamicFontAtSize::Character DynamicFontAtSize::_bitmap_to_character(FT_Bitmap bitmap, int yofs, int xofs, float advance) {
-	int w = bitmap.width;
-	int h = bitmap.rows;
+DynamicFontAtSize::Character DynamicFontAtSize::_glyph_to_character(CharType p_char, const Glyph &p_glyph) {
+
+	if (!p_glyph.found)
+		return Character::not_found();
+
+	int w = p_glyph.width;
+	int h = p_glyph.height;
 
 	int mw = w + rect_margin * 2;
 	int mh = h + rect_margin * 2;
@@ -483,62 +787,31 @@ DynamicFontAtSize::Character DynamicFontAtSize::_bitmap_to_character(FT_Bitmap b
 	ERR_FAIL_COND_V(mw > 4096, Character::not_found());
 	ERR_FAIL_COND_V(mh > 4096, Character::not_found());
 
-	int color_size = bitmap.pixel_mode == FT_PIXEL_MODE_BGRA ? 4 : 2;
-	Image::Format require_format = color_size == 4 ? Image::FORMAT_RGBA8 : Image::FORMAT_LA8;
+	int color_size = Image::get_format_pixel_size(p_glyph.format);
+	ERR_FAIL_COND_V(p_glyph.pixels.size() != w * h * color_size, Character::not_found());
+
+	if (font->atlas_mutex)
+		font->atlas_mutex->lock();
 
-	TexturePosition tex_pos = _find_texture_pos_for_glyph(color_size, require_format, mw, mh);
-	ERR_FAIL_COND_V(tex_pos.index < 0, Character::not_found());
+	DynamicFontData::TexturePosition tex_pos = font->_find_texture_pos_for_glyph(p_glyph.format, texture_flags, mw, mh, id.size * oversampling * 8);
+	if (tex_pos.index < 0) {
+		if (font->atlas_mutex)
+			font->atlas_mutex->unlock();
+		ERR_FAIL_V(Character::not_found());
+	}
 
 	//fit character in char texture
 
-	CharTexture &tex = textures.write[tex_pos.index];
+	DynamicFontData::CharTexture &tex = font->textures.write[tex_pos.index];
 
 	{
 		PoolVector<uint8_t>::Write wr = tex.imgdata.write();
+		const uint8_t *r = p_glyph.pixels.ptr();
 
 		for (int i = 0; i < h; i++) {
-			for (int j = 0; j < w; j++) {
-
-				int ofs = ((i + tex_pos.y + rect_margin) * tex.texture_size + j + tex_pos.x + rect_margin) * color_size;
-				ERR_FAIL_COND_V(ofs >= tex.imgdata.size(), Character::not_found());
-				switch (bitmap.pixel_mode) {
-					case FT_PIXEL_MODE_MONO: {
-						int byte = i * bitmap.pitch + (j >> 3);
-						int bit = 1 << (7 - (j % 8));
-						wr[ofs + 0] = 255; //grayscale as 1
-						wr[ofs + 1] = bitmap.buffer[byte] & bit ? 255 : 0;
-					} break;
-					case FT_PIXEL_MODE_GRAY:
-						wr[ofs + 0] = 255; //grayscale as 1
-						wr[ofs + 1] = bitmap.buffer[i * bitmap.pitch + j];
-						break;
-					case FT_PIXEL_MODE_BGRA: {
-						int ofs_color = i * bitmap.pitch + (j << 2);
-						wr[ofs + 2] = bitmap.buffer[ofs_color + 0];
-						wr[ofs + 1] = bitmap.buffer[ofs_color + 1];
-						wr[ofs + 0] = bitmap.buffer[ofs_color + 2];
-						wr[ofs + 3] = bitmap.buffer[ofs_color + 3];
-					} break;
-					// TODO: FT_PIXEL_MODE_LCD
-					default:
-						ERR_EXPLAIN("Font uses unsupported pixel format: " + itos(bitmap.pixel_mode));
-						ERR_FAIL_V(Character::not_found());
-						break;
-				}
-			}
-		}
-	}
 
-	//blit to image and texture
-	{
-
-		Ref<Image> img = memnew(Image(tex.texture_size, tex.texture_size, 0, require_format, tex.imgdata));
-
-		if (tex.texture.is_null()) {
-			tex.texture.instance();
-			tex.texture->create_from_image(img, Texture::FLAG_VIDEO_SURFACE | texture_flags);
-		} else {
-			tex.texture->set_data(img); //update
+			int ofs = ((i + tex_pos.y + rect_margin) * tex.texture_size + tex_pos.x + rect_margin) * color_size;
+			copymem(&wr[ofs], &r[i * w * color_size], w * color_size);
 		}
 	}
 
@@ -548,10 +821,23 @@ DynamicFontAtSize::Character DynamicFontAtSize::_bitmap_to_character(FT_Bitmap b
 		tex.offsets.write[k] = tex_pos.y + mh;
 	}
 
+	tex.chars.push_back(Pair<DynamicFontAtSize *, CharType>(this, p_char));
+	tex.last_used = Engine::get_singleton()->get_frames_drawn();
+
+	// the texture is uploaded once, after all the glyphs needed this frame are in
+	tex.dirty = true;
+	if (!font->textures_update_queued) {
+		font->textures_update_queued = true;
+		MessageQueue::get_singleton()->push_call(font.ptr(), "_update_textures");
+	}
+
+	if (font->atlas_mutex)
+		font->atlas_mutex->unlock();
+
 	Character chr;
-	chr.h_align = xofs * scale_color_font / oversampling;
-	chr.v_align = ascent - (yofs * scale_color_font / oversampling); // + ascent - descent;
-	chr.advance = advance * scale_color_font / oversampling;
+	chr.h_align = p_glyph.h_align;
+	chr.v_align = p_glyph.v_align;
+	chr.advance = p_glyph.advance;
 	chr.texture_idx = tex_pos.index;
 	chr.found = true;
 
@@ -562,35 +848,30 @@ DynamicFontAtSize::Character DynamicFontAtSize::_bitmap_to_character(FT_Bitmap b
 	return chr;
 }
 
-DynamicFontAtSize::Character DynamicFontAtSize::_make_outline_char(CharType p_char) {
-	Character ret = Character::not_found();
+DynamicFontAtSize::RasterSettings DynamicFontAtSize::_get_raster_settings() const {
 
-	if (FT_Load_Char(face, p_char, FT_LOAD_NO_BITMAP | (font->force_autohinter ? FT_LOAD_FORCE_AUTOHINT : 0)) != 0)
-		return ret;
-
-	FT_Stroker stroker;
-	if (FT_Stroker_New(library, &stroker) != 0)
-		return ret;
-
-	FT_Stroker_Set(stroker, (int)(id.outline_size * oversampling * 64.0), FT_STROKER_LINECAP_BUTT, FT_STROKER_LINEJOIN_ROUND, 0);
-	FT_Glyph glyph;
-	FT_BitmapGlyph glyph_bitmap;
-
-	if (FT_Get_Glyph(face->glyph, &glyph) != 0)
-		goto cleanup_stroker;
-	if (FT_Glyph_Stroke(&glyph, stroker, 1) != 0)
-		goto cleanup_glyph;
-	if (FT_Glyph_To_Bitmap(&glyph, FT_RENDER_MODE_NORMAL, 0, 1) != 0)
-		goto cleanup_glyph;
+	RasterSettings settings;
+	settings.font_path = font->font_path;
+	settings.font_mem = font->font_mem;
+	settings.font_mem_size = font->font_mem_size;
+	settings.id = id;
+	settings.hinting = font->hinting;
+	settings.force_autohinter = font->force_autohinter;
+	settings.oversampling = oversampling;
+	settings.ascent = ascent;
+	settings.scale_color_font = scale_color_font;
+	return settings;
+}
 
-	glyph_bitmap = (FT_BitmapGlyph)glyph;
-	ret = _bitmap_to_character(glyph_bitmap->bitmap, glyph_bitmap->top, glyph_bitmap->left, glyph->advance.x / 65536.0);
+DynamicFontAtSize::RasterSettings DynamicFontAtSize::_get_prerender_settings() const {
 
-cleanup_glyph:
-	FT_Done_Glyph(glyph);
-cleanup_stroker:
-	FT_Stroker_Done(stroker);
-	return ret;
+	// the job only holds the font data by id, so it gets its own reference to the font memory
+	RasterSettings settings = _get_raster_settings();
+	if (settings.font_mem) {
+		settings.font_mem_owner = font->_get_font_mem_copy();
+		settings.font_mem = settings.font_mem_owner.ptr();
+	}
+	return settings;
 }
 
 void DynamicFontAtSize::_update_char(CharType p_char) {
@@ -600,56 +881,391 @@ void DynamicFontAtSize::_update_char(CharType p_char) {
 
 	_THREAD_SAFE_METHOD_
 
-	Character character = Character::not_found();
+	Glyph glyph;
+
+	Glyph *ready = prerendered.getptr(p_char);
+	if (ready) {
+		glyph = *ready;
+		prerendered.erase(p_char);
+	} else {
+		_rasterize_glyph(_get_raster_settings(), library, face, p_char, glyph);
+		glyph_cache_dirty = true;
+	}
+
+	char_map[p_char] = _glyph_to_character(p_char, glyph);
+}
+
+void DynamicFontAtSize::_clear_chars() {
 
-	FT_GlyphSlot slot = face->glyph;
+	if (font.is_valid()) {
+		if (font->atlas_mutex)
+			font->atlas_mutex->lock();
+		font->_remove_chars(this);
+		if (font->atlas_mutex)
+			font->atlas_mutex->unlock();
+	}
+
+	char_map.clear();
+}
 
-	if (FT_Get_Char_Index(face, p_char) == 0) {
-		char_map[p_char] = character;
+void DynamicFontAtSize::update_oversampling() {
+	if (oversampling == font_oversampling || !valid)
 		return;
+
+	_save_glyph_cache();
+
+	FT_Done_FreeType(library);
+	_clear_chars();
+	prerendered.clear();
+	oversampling = font_oversampling;
+	valid = false;
+	_load();
+}
+
+void DynamicFontAtSize::_encode_glyph(CharType p_char, const Glyph &p_glyph, Vector<uint8_t> &r_buffer) {
+
+	int ofs = r_buffer.size();
+	int pixels_size = p_glyph.pixels.size();
+
+	r_buffer.resize(ofs + 5 + (p_glyph.found ? 17 + pixels_size : 0));
+	uint8_t *w = r_buffer.ptrw() + ofs;
+
+	encode_uint32(p_char, w);
+	w[4] = p_glyph.found ? 1 : 0;
+	if (!p_glyph.found)
+		return;
+	w += 5;
+
+	encode_float(p_glyph.h_align, &w[0]);
+	encode_float(p_glyph.v_align, &w[4]);
+	encode_float(p_glyph.advance, &w[8]);
+	encode_uint16(p_glyph.width, &w[12]);
+	encode_uint16(p_glyph.height, &w[14]);
+	w[16] = p_glyph.format == Image::FORMAT_RGBA8 ? 1 : 0;
+
+	if (pixels_size) {
+		copymem(&w[17], p_glyph.pixels.ptr(), pixels_size);
 	}
+}
 
-	int ft_hinting;
+Error DynamicFontAtSize::_decode_glyphs(const uint8_t *p_buffer, int p_size, HashMap<CharType, Glyph> &r_glyphs) {
 
-	switch (font->hinting) {
-		case DynamicFontData::HINTING_NONE:
-			ft_hinting = FT_LOAD_NO_HINTING;
-			break;
-		case DynamicFontData::HINTING_LIGHT:
-			ft_hinting = FT_LOAD_TARGET_LIGHT;
-			break;
-		default:
-			ft_hinting = FT_LOAD_TARGET_NORMAL;
+	int ofs = 0;
+
+	while (ofs < p_size) {
+
+		ERR_FAIL_COND_V(p_size - ofs < 5, ERR_FILE_CORRUPT);
+
+		CharType c = decode_uint32(&p_buffer[ofs]);
+		Glyph glyph;
+		glyph.found = p_buffer[ofs + 4] != 0;
+		ofs += 5;
+
+		if (glyph.found) {
+
+			ERR_FAIL_COND_V(p_size - ofs < 17, ERR_FILE_CORRUPT);
+
+			glyph.h_align = decode_float(&p_buffer[ofs]);
+			glyph.v_align = decode_float(&p_buffer[ofs + 4]);
+			glyph.advance = decode_float(&p_buffer[ofs + 8]);
+			glyph.width = decode_uint16(&p_buffer[ofs + 12]);
+			glyph.height = decode_uint16(&p_buffer[ofs + 14]);
+			glyph.format = p_buffer[ofs + 16] ? Image::FORMAT_RGBA8 : Image::FORMAT_LA8;
+			ofs += 17;
+
+			int pixels_size = glyph.width * glyph.height * Image::get_format_pixel_size(glyph.format);
+			ERR_FAIL_COND_V(p_size - ofs < pixels_size, ERR_FILE_CORRUPT);
+
+			glyph.pixels.resize(pixels_size);
+			if (pixels_size) {
+				copymem(glyph.pixels.ptrw(), &p_buffer[ofs], pixels_size);
+			}
+			ofs += pixels_size;
+		}
+
+		r_glyphs.set(c, glyph);
+	}
+
+	return OK;
+}
+
+#define GLYPH_CACHE_MAGIC "GDGC"
+#define GLYPH_CACHE_VERSION 1
+
+String DynamicFontAtSize::_get_glyph_cache_path() const {
+
+	String key;
+	if (font->font_path != String()) {
+		key = font->font_path + ":" + itos(FileAccess::get_modified_time(font->font_path));
+	} else {
+		key = "memory:" + itos(hash_djb2_buffer(font->font_mem, font->font_mem_size)) + ":" + itos(font->font_mem_size);
+	}
+
+	key += ":" + itos(id.key) + ":" + rtos(oversampling) + ":" + itos(font->hinting) + ":" + itos(font->force_autohinter);
+
+	return "user://glyph_cache/" + key.md5_text() + ".glyphs";
+}
+
+void DynamicFontAtSize::_load_glyph_cache() {
+
+	FileAccess *f = FileAccess::open(_get_glyph_cache_path(), FileAccess::READ);
+	if (!f)
+		return;
+
+	uint8_t header[8];
+	bool valid_header = f->get_buffer(header, 8) == 8 && header[0] == 'G' && header[1] == 'D' && header[2] == 'G' && header[3] == 'C' && decode_uint32(&header[4]) == GLYPH_CACHE_VERSION;
+
+	if (valid_header) {
+
+		Vector<uint8_t> data;
+		data.resize(f->get_len() - 8);
+		f->get_buffer(data.ptrw(), data.size());
+
+		if (_decode_glyphs(data.ptr(), data.size(), prerendered) != OK) {
+			prerendered.clear();
+		}
+	}
+
+	f->close();
+	memdelete(f);
+
+	glyph_cache_dirty = false;
+}
+
+void DynamicFontAtSize::_save_glyph_cache() {
+
+	if (!use_glyph_cache || !glyph_cache_dirty || !valid)
+		return;
+
+	Vector<uint8_t> data;
+
+	const CharType *k = NULL;
+	while ((k = char_map.next(k))) {
+
+		const Character &c = char_map[*k];
+		Glyph glyph;
+
+		if (c.found && c.texture_idx >= 0 && c.texture_idx < font->textures.size()) {
+
+			const DynamicFontData::CharTexture &tex = font->textures[c.texture_idx];
+			int color_size = Image::get_format_pixel_size(tex.format);
+
+			glyph.found = true;
+			glyph.h_align = c.h_align;
+			glyph.v_align = c.v_align;
+			glyph.advance = c.advance;
+			glyph.width = c.rect_uv.size.width;
+			glyph.height = c.rect_uv.size.height;
+			glyph.format = tex.format;
+			glyph.pixels.resize(glyph.width * glyph.height * color_size);
+
+			PoolVector<uint8_t>::Read r = tex.imgdata.read();
+			for (int i = 0; i < glyph.height; i++) {
+				int ofs = ((int(c.rect_uv.position.y) + i) * tex.texture_size + int(c.rect_uv.position.x)) * color_size;
+				copymem(&glyph.pixels.write[i * glyph.width * color_size], &r[ofs], glyph.width * color_size);
+			}
+		}
+
+		_encode_glyph(*k, glyph, data);
+	}
+
+	// glyphs loaded but not used yet are kept too
+	k = NULL;
+	while ((k = prerendered.next(k))) {
+		if (!char_map.has(*k)) {
+			_encode_glyph(*k, prerendered[*k], data);
+		}
+	}
+
+	DirAccess *da = DirAccess::create(DirAccess::ACCESS_USERDATA);
+	da->make_dir_recursive("user://glyph_cache");
+	memdelete(da);
+
+	FileAccess *f = FileAccess::open(_get_glyph_cache_path(), FileAccess::WRITE);
+	ERR_FAIL_COND(!f);
+
+	f->store_buffer((const uint8_t *)GLYPH_CACHE_MAGIC, 4);
+	f->store_32(GLYPH_CACHE_VERSION);
+	f->store_buffer(data.ptr(), data.size());
+	f->close();
+	memdelete(f);
+
+	glyph_cache_dirty = false;
+}
+
+Thread *DynamicFontAtSize::prerender_thread = NULL;
+Mutex *DynamicFontAtSize::prerender_mutex = NULL;
+Semaphore *DynamicFontAtSize::prerender_semaphore = NULL;
+bool DynamicFontAtSize::prerender_exit = false;
+List<DynamicFontAtSize::PrerenderJob> DynamicFontAtSize::prerender_jobs;
+
+void DynamicFontAtSize::_run_prerender_job(const PrerenderJob &p_job) {
+
+	int font_count = p_job.fonts.size();
+
+	// every font of the job gets its own FreeType instance, nothing is shared with the main thread
+	Vector<FT_Library> libraries;
+	Vector<FT_Face> faces;
+	Vector<FT_StreamRec> streams;
+	Vector<int> states; // 0 not opened yet, 1 open, -1 failed
+	Vector<Vector<uint8_t> > results;
+
+	libraries.resize(font_count);
+	faces.resize(font_count);
+	streams.resize(font_count);
+	states.resize(font_count);
+	results.resize(font_count);
+
+	for (int i = 0; i < font_count; i++) {
+		states.write[i] = 0;
+	}
+
+	for (int i = 0; i < p_job.chars.size(); i++) {
+
+		CharType c = p_job.chars[i];
+
+		for (int j = 0; j < font_count; j++) {
+
+			if (states[j] == 0) {
+
+				states.write[j] = -1;
+				if (FT_Init_FreeType(&libraries.write[j]) == 0) {
+
+					float scale_color_font = 1;
+					if (_open_face(p_job.fonts[j], libraries[j], &streams.write[j], &faces.write[j], &scale_color_font) == OK) {
+						states.write[j] = 1;
+					} else {
+						FT_Done_FreeType(libraries[j]);
+					}
+				}
+			}
+
+			if (states[j] != 1)
+				continue;
+
+			// characters missing from a font are recorded too, so it does not look for them again
+			Glyph glyph;
+			bool found = _rasterize_glyph(p_job.fonts[j], libraries[j], faces[j], c, glyph);
+			_encode_glyph(c, glyph, results.write[j]);
+
+			if (found)
+				break;
+		}
+	}
+
+	for (int i = 0; i < font_count; i++) {
+
+		if (states[i] == 1) {
+			FT_Done_FreeType(libraries[i]);
+		}
+
+		if (results[i].empty())
+			continue;
+
+		PoolVector<uint8_t> glyphs;
+		glyphs.resize(results[i].size());
+		{
+			PoolVector<uint8_t>::Write w = glyphs.write();
+			copymem(w.ptr(), results[i].ptr(), results[i].size());
+		}
+
+		MessageQueue::get_singleton()->push_call(p_job.font_datas[i], "_add_prerendered_glyphs", p_job.fonts[i].id.key, p_job.fonts[i].oversampling, glyphs);
+	}
+}
+
+void DynamicFontAtSize::_prerender_thread_func(void *p_userdata) {
+
+	while (true) {
+
+		prerender_semaphore->wait();
+
+		if (prerender_exit)
 			break;
+
+		prerender_mutex->lock();
+		if (prerender_jobs.empty()) {
+			prerender_mutex->unlock();
+			continue;
+		}
+
+		PrerenderJob job = prerender_jobs.front()->get();
+		prerender_jobs.pop_front();
+		prerender_mutex->unlock();
+
+		_run_prerender_job(job);
 	}
+}
+
+void DynamicFontAtSize::_queue_prerender_job(const PrerenderJob &p_job) {
 
-	int error = FT_Load_Char(face, p_char, FT_HAS_COLOR(face) ? FT_LOAD_COLOR : FT_LOAD_DEFAULT | (font->force_autohinter ? FT_LOAD_FORCE_AUTOHINT : 0) | ft_hinting);
-	if (error) {
-		char_map[p_char] = character;
+	if (!OS::get_singleton()->can_use_threads()) {
+		_run_prerender_job(p_job);
 		return;
 	}
 
-	if (id.outline_size > 0) {
-		character = _make_outline_char(p_char);
-	} else {
-		error = FT_Render_Glyph(face->glyph, FT_RENDER_MODE_NORMAL);
-		if (!error)
-			character = _bitmap_to_character(slot->bitmap, slot->bitmap_top, slot->bitmap_left, slot->advance.x / 64.0);
+	if (!prerender_thread) {
+		prerender_mutex = Mutex::create();
+		prerender_semaphore = Semaphore::create();
+		prerender_exit = false;
+		prerender_thread = Thread::create(_prerender_thread_func, NULL);
 	}
 
-	char_map[p_char] = character;
+	prerender_mutex->lock();
+	prerender_jobs.push_back(p_job);
+	prerender_mutex->unlock();
+
+	prerender_semaphore->post();
 }
 
-void DynamicFontAtSize::update_oversampling() {
-	if (oversampling == font_oversampling || !valid)
+void DynamicFontAtSize::_stop_prerender_thread() {
+
+	if (!prerender_thread)
 		return;
 
-	FT_Done_FreeType(library);
-	textures.clear();
-	char_map.clear();
-	oversampling = font_oversampling;
-	valid = false;
-	_load();
+	prerender_exit = true;
+	prerender_semaphore->post();
+	Thread::wait_to_finish(prerender_thread);
+	memdelete(prerender_thread);
+	prerender_thread = NULL;
+	memdelete(prerender_semaphore);
+	prerender_semaphore = NULL;
+	memdelete(prerender_mutex);
+	prerender_mutex = NULL;
+
+	prerender_jobs.clear();
+}
+
+void DynamicFontAtSize::prerender_characters(const String &p_chars, const Vector<Ref<DynamicFontAtSize> > &p_fallbacks) {
+
+	if (!valid)
+		return;
+
+	PrerenderJob job;
+	job.fonts.push_back(_get_prerender_settings());
+	job.font_datas.push_back(font->get_instance_id());
+
+	for (int i = 0; i < p_fallbacks.size(); i++) {
+		if (p_fallbacks[i].is_valid() && p_fallbacks[i]->valid) {
+			job.fonts.push_back(p_fallbacks[i]->_get_prerender_settings());
+			job.font_datas.push_back(p_fallbacks[i]->font->get_instance_id());
+		}
+	}
+
+	Set<CharType> queued;
+	for (int i = 0; i < p_chars.length(); i++) {
+
+		CharType c = p_chars[i];
+		if (char_map.has(c) || prerendered.has(c) || queued.has(c))
+			continue;
+
+		queued.insert(c);
+		job.chars.push_back(c);
+	}
+
+	if (job.chars.empty())
+		return;
+
+	_queue_prerender_job(job);
 }
 
 DynamicFontAtSize::DynamicFontAtSize() {
@@ -662,13 +1278,16 @@ DynamicFontAtSize::DynamicFontAtSize() {
 	texture_flags = 0;
 	oversampling = font_oversampling;
 	scale_color_font = 1;
+	glyph_cache_dirty = false;
 }
 
 DynamicFontAtSize::~DynamicFontAtSize() {
 
 	if (valid) {
+		_save_glyph_cache();
 		FT_Done_FreeType(library);
 	}
+	_clear_chars();
 	font->size_cache.erase(id);
 	font.unref();
 }
@@ -928,6 +1547,17 @@ void DynamicFont::remove_fallback(int p_idx) {
 	_change_notify();
 }
 
+void DynamicFont::prerender_characters(const String &p_chars) {
+
+	if (data_at_size.is_valid()) {
+		data_at_size->prerender_characters(p_chars, fallback_data_at_size);
+	}
+
+	if (outline_data_at_size.is_valid()) {
+		outline_data_at_size->prerender_characters(p_chars, fallback_outline_data_at_size);
+	}
+}
+
 bool DynamicFont::_set(const StringName &p_name, const Variant &p_value) {
 
 	String str = p_name;
@@ -1007,6 +1637,8 @@ void DynamicFont::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("remove_fallback", "idx"), &DynamicFont::remove_fallback);
 	ClassDB::bind_method(D_METHOD("get_fallback_count"), &DynamicFont::get_fallback_count);
 
+	ClassDB::bind_method(D_METHOD("prerender_characters", "chars"), &DynamicFont::prerender_characters);
+
 	ADD_GROUP("Settings", "");
 	ADD_PROPERTY(PropertyInfo(Variant::INT, "size"), "set_size", "get_size");
 	ADD_PROPERTY(PropertyInfo(Variant::INT, "outline_size"), "set_outline_size", "get_outline_size");
@@ -1059,9 +1691,14 @@ DynamicFont::~DynamicFont() {
 
 void DynamicFont::initialize_dynamic_fonts() {
 	dynamic_font_mutex = Mutex::create();
+
+	DynamicFontData::max_atlas_textures = MAX(0, (int)GLOBAL_DEF("gui/common/dynamic_font_max_atlas_textures", 0));
+	ProjectSettings::get_singleton()->set_custom_property_info("gui/common/dynamic_font_max_atlas_textures", PropertyInfo(Variant::INT, "gui/common/dynamic_font_max_atlas_textures", PROPERTY_HINT_RANGE, "0,256,1"));
+	DynamicFontAtSize::use_glyph_cache = GLOBAL_DEF("gui/common/dynamic_font_glyph_cache", false);
 }
 
 void DynamicFont::finish_dynamic_fonts() {
+	DynamicFontAtSize::_stop_prerender_thread();
 	memdelete(dynamic_font_mutex);
 	dynamic_font_mutex = NULL;
 }
@@ -34,6 +34,8 @@
 #ifdef FREETYPE_ENABLED
 #include "core/io/resource_loader.h"
 #include "core/os/mutex.h"
+#include "core/os/semaphore.h"
+#include "core/os/thread.h"
 #include "core/os/thread_safe.h"
 #include "core/pair.h"
 #include "scene/resources/font.h"
@@ -77,6 +79,7 @@ public:
 private:
 	const uint8_t *font_mem;
 	int font_mem_size;
+	mutable Vector<uint8_t> font_mem_copy; // shared with prerender jobs, which may outlive font_mem
 	bool force_autohinter;
 	Hinting hinting;
 
@@ -89,10 +92,46 @@ private:
 
 	Ref<DynamicFontAtSize> _get_dynamic_font_at_size(CacheID p_cache_id);
 
+	// Glyph atlas shared by every size of this font. When there are too many
+	// pages, the one drawn least recently is cleared and reused.
+	struct CharTexture {
+
+		PoolVector<uint8_t> imgdata;
+		int texture_size;
+		Image::Format format;
+		uint32_t flags;
+		Vector<int> offsets;
+		Ref<ImageTexture> texture;
+		bool dirty;
+		uint64_t last_used;
+		Vector<Pair<DynamicFontAtSize *, CharType> > chars;
+	};
+
+	struct TexturePosition {
+		int index;
+		int x;
+		int y;
+	};
+
+	Vector<CharTexture> textures;
+	Mutex *atlas_mutex;
+	bool textures_update_queued;
+	bool fonts_changed_queued;
+
+	TexturePosition _find_texture_pos_for_glyph(Image::Format p_image_format, uint32_t p_flags, int p_width, int p_height, int p_min_texture_size);
+	void _evict_texture(int p_index);
+	void _remove_chars(DynamicFontAtSize *p_font);
+	void _update_textures();
+	void _emit_fonts_changed();
+	void _add_prerendered_glyphs(uint32_t p_cache_id, float p_oversampling, const PoolVector<uint8_t> &p_glyphs);
+	Vector<uint8_t> _get_font_mem_copy() const;
+
 protected:
 	static void _bind_methods();
 
 public:
+	static int max_atlas_textures;
+
 	void set_font_ptr(const uint8_t *p_font_mem, int p_font_mem_size);
 	void set_font_path(const String &p_path);
 	String get_font_path() const;
@@ -125,16 +164,6 @@ class DynamicFontAtSize : public Reference {
 
 	bool valid;
 
-	struct CharTexture {
-
-		PoolVector<uint8_t> imgdata;
-		int texture_size;
-		Vector<int> offsets;
-		Ref<ImageTexture> texture;
-	};
-
-	Vector<CharTexture> textures;
-
 	struct Character {
 
 		bool found;
@@ -153,34 +182,100 @@ class DynamicFontAtSize : public Reference {
 		static Character not_found();
 	};
 
-	struct TexturePosition {
-		int index;
-		int x;
-		int y;
+	// A rasterized glyph, before it is placed in the atlas.
+	struct Glyph {
+
+		bool found;
+		int width;
+		int height;
+		Image::Format format;
+		Vector<uint8_t> pixels;
+		float h_align;
+		float v_align;
+		float advance;
+
+		Glyph() {
+			found = false;
+			width = 0;
+			height = 0;
+			format = Image::FORMAT_LA8;
+			h_align = 0;
+			v_align = 0;
+			advance = 0;
+		}
+	};
+
+	// Everything needed to rasterize glyphs of this size without touching it, so it can be done on another thread.
+	struct RasterSettings {
+
+		String font_path;
+		const uint8_t *font_mem;
+		int font_mem_size;
+		Vector<uint8_t> font_mem_owner; // when set, font_mem points into it
+		DynamicFontData::CacheID id;
+		DynamicFontData::Hinting hinting;
+		bool force_autohinter;
+		float oversampling;
+		float ascent;
+		float scale_color_font;
+	};
+
+	struct PrerenderJob {
+
+		Vector<ObjectID> font_datas; // the DynamicFontData of each size
+		Vector<RasterSettings> fonts; // the size and its fallbacks, tried in order
+		Vector<CharType> chars;
 	};
 
 	const Pair<const Character *, DynamicFontAtSize *> _find_char_with_font(CharType p_char, const Vector<Ref<DynamicFontAtSize> > &p_fallbacks) const;
-	Character _make_outline_char(CharType p_char);
 	float _get_kerning_advance(const DynamicFontAtSize *font, CharType p_char, CharType p_next) const;
-	TexturePosition _find_texture_pos_for_glyph(int p_color_size, Image::Format p_image_format, int p_width, int p_height);
-	Character _bitmap_to_character(FT_Bitmap bitmap, int yofs, int xofs, float advance);
+	Character _glyph_to_character(CharType p_char, const Glyph &p_glyph);
+
+	RasterSettings _get_raster_settings() const;
+	RasterSettings _get_prerender_settings() const;
+	static Error _open_face(const RasterSettings &p_settings, FT_Library p_library, FT_StreamRec *r_stream, FT_Face *r_face, float *r_scale_color_font);
+	static bool _rasterize_glyph(const RasterSettings &p_settings, FT_Library p_library, FT_Face p_face, CharType p_char, Glyph &r_glyph);
+	static void _bitmap_to_glyph(const RasterSettings &p_settings, const FT_Bitmap &p_bitmap, int p_yofs, int p_xofs, float p_advance, Glyph &r_glyph);
+
+	static void _encode_glyph(CharType p_char, const Glyph &p_glyph, Vector<uint8_t> &r_buffer);
+	static Error _decode_glyphs(const uint8_t *p_buffer, int p_size, HashMap<CharType, Glyph> &r_glyphs);
 
 	static unsigned long _ft_stream_io(FT_Stream stream, unsigned long offset, unsigned char *buffer, unsigned long count);
 	static void _ft_stream_close(FT_Stream stream);
 
 	HashMap<CharType, Character> char_map;
+	HashMap<CharType, Glyph> prerendered; // rasterized ahead of time, or loaded from the glyph cache
+	bool glyph_cache_dirty;
 
 	_FORCE_INLINE_ void _update_char(CharType p_char);
+	void _clear_chars();
 
 	friend class DynamicFontData;
+	friend class DynamicFont;
 	Ref<DynamicFontData> font;
 	DynamicFontData::CacheID id;
 
 	static HashMap<String, Vector<uint8_t> > _fontdata;
 	Error _load();
 
+	String _get_glyph_cache_path() const;
+	void _load_glyph_cache();
+	void _save_glyph_cache();
+
+	static Thread *prerender_thread;
+	static Mutex *prerender_mutex;
+	static Semaphore *prerender_semaphore;
+	static bool prerender_exit;
+	static List<PrerenderJob> prerender_jobs;
+
+	static void _prerender_thread_func(void *p_userdata);
+	static void _run_prerender_job(const PrerenderJob &p_job);
+	static void _queue_prerender_job(const PrerenderJob &p_job);
+	static void _stop_prerender_thread();
+
 public:
 	static float font_oversampling;
+	static bool use_glyph_cache;
 
 	float get_height() const;
 
@@ -193,6 +288,7 @@ public:
 
 	void set_texture_flags(uint32_t p_flags);
 	void update_oversampling();
+	void prerender_characters(const String &p_chars, const Vector<Ref<DynamicFontAtSize> > &p_fallbacks);
 
 	DynamicFontAtSize();
 	~DynamicFontAtSize();
@@ -232,6 +328,8 @@ private:
 
 	Color outline_color;
 
+	friend class DynamicFontData;
+
 protected:
 	void _reload_cache();
 
@@ -269,6 +367,8 @@ public:
 	Ref<DynamicFontData> get_fallback(int p_idx) const;
 	void remove_fallback(int p_idx);
 
+	void prerender_characters(const String &p_chars);
+
 	virtual float get_height() const;
 
 	virtual float get_ascent() const;
@@ -31,6 +31,8 @@
 #include "scene_format_text.h"
 #include "core/io/resource_format_binary.h"
 #include "core/os/dir_access.h"
+#include "core/os/os.h"
+#include "core/os/thread.h"
 #include "core/project_settings.h"
 #include "core/version.h"
 
@@ -1212,11 +1214,86 @@ String ResourceInteractiveLoaderText::recognize(FileAccess *p_f) {
 
 /////////////////////
 
+// Text resources in the project directory are converted once to the binary format and kept in
+// res://.import, stamped with the md5 of the source. Hashing the file is much cheaper than parsing it,
+// so loads go through the binary loader for as long as the stamp matches.
+Ref<ResourceInteractiveLoader> ResourceFormatLoaderText::_load_binary_cache(const String &p_path, const String &p_original_path, Error *r_error) {
+
+	if (ProjectSettings::get_singleton()->is_using_datapack() || !bool(GLOBAL_GET("editor/cache_text_resources_as_binary")))
+		return Ref<ResourceInteractiveLoader>();
+
+	String local_path = ProjectSettings::get_singleton()->localize_path(p_path);
+	if (!local_path.begins_with("res://") || local_path.begins_with("res://.import/"))
+		return Ref<ResourceInteractiveLoader>();
+
+	String source_md5 = FileAccess::get_md5(local_path);
+	if (source_md5 == String())
+		return Ref<ResourceInteractiveLoader>();
+
+	String base_path = "res://.import/" + local_path.get_file() + "-" + local_path.md5_text();
+	String cache_path = base_path + (local_path.get_extension().to_lower() == "tscn" ? ".scn" : ".res");
+	// the engine build is part of the stamp, a different binary format must never be read back
+	String stamp = "source_md5=\"" + source_md5 + "\"\nengine_version=\"" VERSION_FULL_BUILD "\"\n";
+
+	String current_stamp;
+	if (FileAccess::exists(base_path + ".md5") && FileAccess::exists(cache_path)) {
+		FileAccessRef f = FileAccess::open(base_path + ".md5", FileAccess::READ);
+		if (f) {
+			current_stamp = f->get_line() + "\n";
+			current_stamp += f->get_line() + "\n";
+		}
+	}
+
+	if (current_stamp != stamp) {
+
+		DirAccessRef da = DirAccess::create(DirAccess::ACCESS_RESOURCES);
+		if (!da->dir_exists("res://.import") && da->make_dir("res://.import") != OK)
+			return Ref<ResourceInteractiveLoader>();
+
+		// the old stamp goes first, so an interrupted conversion is never taken as valid
+		if (current_stamp != String())
+			da->remove(base_path + ".md5");
+
+		// several loaders may convert the same file at once (e.g. the main thread and the resource
+		// previewer), so each writes to its own file and renames it into place, readers never see
+		// a partially written one
+		String tmp_suffix = ".tmp-" + itos(OS::get_singleton()->get_process_id()) + "-" + itos(Thread::get_caller_id()) + "-" + itos(OS::get_singleton()->get_ticks_usec());
+
+		String tmp_cache_path = cache_path + tmp_suffix;
+		if (convert_file_to_binary(local_path, tmp_cache_path) != OK) {
+			da->remove(tmp_cache_path);
+			return Ref<ResourceInteractiveLoader>();
+		}
+		if (da->rename(tmp_cache_path, cache_path) != OK) {
+			da->remove(tmp_cache_path);
+			return Ref<ResourceInteractiveLoader>();
+		}
+
+		String tmp_stamp_path = base_path + ".md5" + tmp_suffix;
+		FileAccess *f = FileAccess::open(tmp_stamp_path, FileAccess::WRITE);
+		if (!f)
+			return Ref<ResourceInteractiveLoader>();
+		f->store_string(stamp);
+		memdelete(f);
+		if (da->rename(tmp_stamp_path, base_path + ".md5") != OK) {
+			da->remove(tmp_stamp_path);
+			return Ref<ResourceInteractiveLoader>();
+		}
+	}
+
+	ResourceFormatLoaderBinary binary_loader;
+	return binary_loader.load_interactive(cache_path, p_original_path != "" ? p_original_path : p_path, r_error);
+}
+
 Ref<ResourceInteractiveLoader> ResourceFormatLoaderText::load_interactive(const String &p_path, const String &p_original_path, Error *r_error) {
 
 	if (r_error)
 		*r_error = ERR_CANT_OPEN;
 
+	Ref<ResourceInteractiveLoader> cached = _load_binary_cache(p_path, p_original_path, r_error);
+	if (cached.is_valid())
+		return cached;
+
 	Error err;
 	FileAccess *f = FileAccess::open(p_path, FileAccess::READ, &err);
 
@@ -129,6 +129,8 @@ public:
 
 class ResourceFormatLoaderText : public ResourceFormatLoader {
 
+	Ref<ResourceInteractiveLoader> _load_binary_cache(const String &p_path, const String &p_original_path, Error *r_error);
+
 public:
 	static ResourceFormatLoaderText *singleton;
 	virtual Ref<ResourceInteractiveLoader> load_interactive(const String &p_path, const String &p_original_path = "", Error *r_error = NULL);
@@ -32,6 +32,7 @@
 
 #include "core/math/camera_matrix.h"
 #include "core/math/octree.h"
+#include "scene/3d/audio_voice_manager_3d.h"
 #include "scene/3d/camera.h"
 #include "scene/3d/visibility_notifier.h"
 #include "scene/scene_string_names.h"
@@ -336,8 +337,10 @@ World::World() {
 
 #ifdef _3D_DISABLED
 	indexer = NULL;
+	audio_voice_manager = NULL;
 #else
 	indexer = memnew(SpatialIndexer);
+	audio_voice_manager = memnew(AudioVoiceManager3D(this));
 #endif
 }
 
@@ -347,6 +350,7 @@ World::~World() {
 	VisualServer::get_singleton()->free(scenario);
 
 #ifndef _3D_DISABLED
+	memdelete(audio_voice_manager);
 	memdelete(indexer);
 #endif
 }
@@ -37,6 +37,7 @@
 #include "servers/visual_server.h"
 
 class SpatialIndexer;
+class AudioVoiceManager3D;
 class Camera;
 class VisibilityNotifier;
 
@@ -48,6 +49,7 @@ private:
 	RID space;
 	RID scenario;
 	SpatialIndexer *indexer;
+	AudioVoiceManager3D *audio_voice_manager;
 	Ref<Environment> environment;
 	Ref<Environment> fallback_environment;
 
@@ -67,6 +69,10 @@ protected:
 	friend class Viewport;
 	void _update(uint64_t p_frame);
 
+	friend class AudioStreamPlayer3D;
+	friend class Area;
+	AudioVoiceManager3D *_get_audio_voice_manager() const { return audio_voice_manager; }
+
 public:
 	RID get_space() const;
 	RID get_scenario() const;
@@ -0,0 +1,130 @@
+/*************************************************************************/
+/*  audio_mix.cpp                                                        */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2018 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2018 Godot Engine contributors (cf. AUTHORS.md)    */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#include "audio_mix.h"
+
+#include "core/os/copymem.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define AUDIO_MIX_SSE
+#include <emmintrin.h>
+#endif
+
+void AudioMix::clear(AudioFrame *p_buffer, int p_frames) {
+
+	zeromem(p_buffer, sizeof(AudioFrame) * p_frames);
+}
+
+void AudioMix::add(AudioFrame *p_dst, const AudioFrame *p_src, int p_frames) {
+
+	int i = 0;
+
+#ifdef AUDIO_MIX_SSE
+	float *dst = (float *)p_dst;
+	const float *src = (const float *)p_src;
+
+	for (; i + 2 <= p_frames; i += 2) {
+		__m128 d = _mm_loadu_ps(&dst[i * 2]);
+		__m128 s = _mm_loadu_ps(&src[i * 2]);
+		_mm_storeu_ps(&dst[i * 2], _mm_add_ps(d, s));
+	}
+#endif
+
+	for (; i < p_frames; i++) {
+		p_dst[i] += p_src[i];
+	}
+}
+
+void AudioMix::ramp(AudioFrame *p_buffer, int p_frames, float p_from, float p_to) {
+
+	if (p_frames <= 0)
+		return;
+
+	float inc = (p_to - p_from) / float(p_frames);
+	int i = 0;
+
+#ifdef AUDIO_MIX_SSE
+	float *buf = (float *)p_buffer;
+
+	__m128 vol = _mm_setr_ps(p_from, p_from, p_from + inc, p_from + inc);
+	__m128 vol_inc = _mm_set1_ps(inc * 2.0);
+
+	for (; i + 2 <= p_frames; i += 2) {
+		__m128 b = _mm_loadu_ps(&buf[i * 2]);
+		_mm_storeu_ps(&buf[i * 2], _mm_mul_ps(b, vol));
+		vol = _mm_add_ps(vol, vol_inc);
+	}
+#endif
+
+	for (; i < p_frames; i++) {
+		p_buffer[i] *= p_from + inc * i;
+	}
+}
+
+AudioFrame AudioMix::scale_and_peak(AudioFrame *p_buffer, int p_frames, float p_volume) {
+
+	AudioFrame peak = AudioFrame(0, 0);
+	int i = 0;
+
+#ifdef AUDIO_MIX_SSE
+	float *buf = (float *)p_buffer;
+
+	__m128 vol = _mm_set1_ps(p_volume);
+	__m128 abs_mask = _mm_castsi128_ps(_mm_set1_epi32(0x7FFFFFFF));
+	__m128 max = _mm_setzero_ps();
+
+	for (; i + 2 <= p_frames; i += 2) {
+		__m128 b = _mm_mul_ps(_mm_loadu_ps(&buf[i * 2]), vol);
+		_mm_storeu_ps(&buf[i * 2], b);
+		max = _mm_max_ps(max, _mm_and_ps(b, abs_mask));
+	}
+
+	float lanes[4];
+	_mm_storeu_ps(lanes, max);
+	peak.l = MAX(lanes[0], lanes[2]);
+	peak.r = MAX(lanes[1], lanes[3]);
+#endif
+
+	for (; i < p_frames; i++) {
+
+		p_buffer[i] *= p_volume;
+
+		float l = ABS(p_buffer[i].l);
+		if (l > peak.l) {
+			peak.l = l;
+		}
+		float r = ABS(p_buffer[i].r);
+		if (r > peak.r) {
+			peak.r = r;
+		}
+	}
+
+	return peak;
+}
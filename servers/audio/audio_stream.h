@@ -46,6 +46,10 @@ public:
 	virtual bool is_playing() const = 0;
 
 	virtual int get_loop_count() const = 0; //times it looped
+	virtual bool is_looping() const { return false; }
+	virtual float get_loop_begin() const { return 0; } //in seconds
+	virtual float get_loop_end() const { return 0; } //in seconds, 0 if loops reach the end of the stream
+	virtual bool is_loop_ping_pong() const { return false; }
 
 	virtual float get_playback_position() const = 0;
 	virtual void seek(float p_time) = 0;
@@ -196,6 +200,10 @@ public:
 	virtual bool is_playing() const;
 
 	virtual int get_loop_count() const; //times it looped
+	virtual bool is_looping() const;
+	virtual float get_loop_begin() const;
+	virtual float get_loop_end() const;
+	virtual bool is_loop_ping_pong() const;
 
 	virtual float get_playback_position() const;
 	virtual void seek(float p_time);
@@ -35,6 +35,7 @@
 #include "core/project_settings.h"
 #include "scene/resources/audio_stream_sample.h"
 #include "servers/audio/audio_driver_dummy.h"
+#include "servers/audio/audio_mix.h"
 #include "servers/audio/effects/audio_effect_compressor.h"
 #ifdef TOOLS_ENABLED
 
@@ -276,8 +277,18 @@ void AudioServer::_driver_process(int p_frames, int32_t *p_buffer) {
 #endif
 }
 
+void AudioServer::_add_bus_dependency(Bus *p_from, int p_to) {
+
+	if (p_from->dependent_count == p_from->dependents.size()) {
+		p_from->dependents.resize(MAX(4, p_from->dependent_count * 2));
+	}
+	p_from->dependents.write[p_from->dependent_count++] = p_to;
+}
+
 void AudioServer::_mix_step() {
 
+	uint64_t step_ticks = OS::get_singleton()->get_ticks_usec();
+
 	bool solo_mode = false;
 
 	for (int i = 0; i < buses.size(); i++) {
@@ -317,139 +328,288 @@ void AudioServer::_mix_step() {
 		}
 	}
 
+	mix_solo_mode = solo_mode;
+
 	//make callbacks for mixing the audio
 	for (Set<CallbackItem>::Element *E = callbacks.front(); E; E = E->next()) {
 
 		E->get().callback(E->get().userdata);
 	}
 
-	for (int i = buses.size() - 1; i >= 0; i--) {
-		//go bus by bus
+	// Build the mix graph. A bus waits for the buses sending to it, and buses
+	// reading each other through a sidechain keep the order of a serial mix.
+	int effect_buses = 0;
+
+	for (int i = 0; i < buses.size(); i++) {
 		Bus *bus = buses[i];
+		bus->sender_count = 0;
+		bus->dependent_count = 0;
+		bus->pending = 0;
+	}
 
-		for (int k = 0; k < bus->channels.size(); k++) {
+	for (int i = buses.size() - 1; i >= 0; i--) {
+		Bus *bus = buses[i];
 
-			if (bus->channels[k].active && !bus->channels[k].used) {
-				//buffer was not used, but it's still active, so it must be cleaned
-				AudioFrame *buf = bus->channels.write[k].buffer.ptrw();
+		bus->send_index_cache = -1;
 
-				for (uint32_t j = 0; j < buffer_size; j++) {
+		if (i > 0) {
+			//everything has a send save for master bus
+			Map<StringName, Bus *>::Element *E = bus_map.find(bus->send);
+			if (!E || E->get()->index_cache >= bus->index_cache) { //invalid, send to master
+				bus->send_index_cache = 0;
+			} else {
+				bus->send_index_cache = E->get()->index_cache;
+			}
 
-					buf[j] = AudioFrame(0, 0);
-				}
+			Bus *send = buses[bus->send_index_cache];
+			if (send->sender_count == send->senders.size()) {
+				send->senders.resize(MAX(4, send->sender_count * 2));
 			}
+			send->senders.write[send->sender_count++] = i;
+
+			_add_bus_dependency(bus, bus->send_index_cache);
+			send->pending++;
 		}
 
-		//process effects
-		if (!bus->bypass) {
-			for (int j = 0; j < bus->effects.size(); j++) {
+		if (bus->bypass)
+			continue;
 
-				if (!bus->effects[j].enabled)
-					continue;
+		bool has_effects = false;
 
-#ifdef DEBUG_ENABLED
-				uint64_t ticks = OS::get_singleton()->get_ticks_usec();
-#endif
+		for (int j = 0; j < bus->effects.size(); j++) {
 
-				for (int k = 0; k < bus->channels.size(); k++) {
+			if (!bus->effects[j].enabled)
+				continue;
 
-					if (!(bus->channels[k].active || bus->channels[k].effect_instances[j]->process_silence()))
-						continue;
-					bus->channels.write[k].effect_instances.write[j]->process(bus->channels[k].buffer.ptr(), temp_buffer.write[k].ptrw(), buffer_size);
-				}
+			has_effects = true;
 
-				//swap buffers, so internal buffer always has the right data
-				for (int k = 0; k < bus->channels.size(); k++) {
+			const AudioEffectCompressor *compressor = Object::cast_to<AudioEffectCompressor>(bus->effects[j].effect.ptr());
+			if (!compressor || compressor->get_sidechain() == StringName())
+				continue;
 
-					if (!(buses[i]->channels[k].active || bus->channels[k].effect_instances[j]->process_silence()))
-						continue;
-					SWAP(bus->channels.write[k].buffer, temp_buffer.write[k]);
-				}
+			Map<StringName, Bus *>::Element *E = bus_map.find(compressor->get_sidechain());
+			if (!E || E->get() == bus)
+				continue;
 
-#ifdef DEBUG_ENABLED
-				bus->effects.write[j].prof_time += OS::get_singleton()->get_ticks_usec() - ticks;
-#endif
+			int sidechain = E->get()->index_cache;
+			if (sidechain > i) {
+				_add_bus_dependency(E->get(), i);
+				bus->pending++;
+			} else {
+				_add_bus_dependency(bus, sidechain);
+				E->get()->pending++;
 			}
 		}
 
-		//process send
+		if (has_effects) {
+			effect_buses++;
+		}
+	}
 
-		Bus *send = NULL;
+	if (mix_threads.size() && effect_buses > 1) {
 
-		if (i > 0) {
-			//everything has a send save for master bus
-			if (!bus_map.has(bus->send)) {
-				send = buses[0];
-			} else {
-				send = bus_map[bus->send];
-				if (send->index_cache >= bus->index_cache) { //invalid, send to master
-					send = buses[0];
-				}
+		mix_queue.resize(buses.size());
+		mix_queue_read = 0;
+		mix_queue_write = 0;
+		mix_buses_done = 0;
+
+		for (int i = buses.size() - 1; i >= 0; i--) {
+			if (buses[i]->pending == 0) {
+				mix_queue.write[mix_queue_write++] = i;
 			}
 		}
 
-		for (int k = 0; k < bus->channels.size(); k++) {
+		for (int i = 0; i < mix_queue_write; i++) {
+			mix_ready_semaphore->post();
+		}
 
-			if (!bus->channels[k].active)
-				continue;
+		for (int i = 0; i < mix_threads.size(); i++) {
+			mix_start_semaphore->post();
+		}
 
-			AudioFrame *buf = bus->channels.write[k].buffer.ptrw();
+		_mix_buses(temp_buffer);
 
-			AudioFrame peak = AudioFrame(0, 0);
+		for (int i = 0; i < mix_threads.size(); i++) {
+			mix_done_semaphore->wait();
+		}
 
-			float volume = Math::db2linear(bus->volume_db);
+	} else {
 
-			if (solo_mode) {
-				if (!bus->soloed) {
-					volume = 0.0;
-				}
-			} else {
-				if (bus->mute) {
-					volume = 0.0;
-				}
+		// a serial mix, from the last bus to master, always satisfies the graph
+		for (int i = buses.size() - 1; i >= 0; i--) {
+			_mix_bus(i, temp_buffer);
+		}
+	}
+
+	mix_frames += buffer_size;
+	to_mix = buffer_size;
+
+	mix_time = USEC_TO_SEC(OS::get_singleton()->get_ticks_usec() - step_ticks);
+}
+
+void AudioServer::_mix_buses(Vector<Vector<AudioFrame> > &r_temp_buffer) {
+
+	while (true) {
+
+		// posted once for each bus put in the queue, and once for each
+		// participant when all buses are done
+		mix_ready_semaphore->wait();
+
+		mix_mutex->lock();
+		if (mix_queue_read == mix_queue_write) {
+			mix_mutex->unlock();
+			break;
+		}
+		int bus_index = mix_queue[mix_queue_read++];
+		mix_mutex->unlock();
+
+		_mix_bus(bus_index, r_temp_buffer);
+
+		int ready = 0;
+		bool finished = false;
+
+		mix_mutex->lock();
+
+		Bus *bus = buses[bus_index];
+		for (int i = 0; i < bus->dependent_count; i++) {
+			Bus *dependent = buses[bus->dependents[i]];
+			dependent->pending--;
+			if (dependent->pending == 0) {
+				mix_queue.write[mix_queue_write++] = bus->dependents[i];
+				ready++;
 			}
+		}
 
-			//apply volume and compute peak
-			for (uint32_t j = 0; j < buffer_size; j++) {
+		mix_buses_done++;
+		finished = mix_buses_done == buses.size();
 
-				buf[j] *= volume;
+		mix_mutex->unlock();
 
-				float l = ABS(buf[j].l);
-				if (l > peak.l) {
-					peak.l = l;
-				}
-				float r = ABS(buf[j].r);
-				if (r > peak.r) {
-					peak.r = r;
-				}
+		for (int i = 0; i < ready; i++) {
+			mix_ready_semaphore->post();
+		}
+
+		if (finished) {
+			for (int i = 0; i < mix_threads.size() + 1; i++) {
+				mix_ready_semaphore->post();
 			}
+		}
+	}
+}
 
-			bus->channels.write[k].peak_volume = AudioFrame(Math::linear2db(peak.l + 0.0000000001), Math::linear2db(peak.r + 0.0000000001));
+void AudioServer::_mix_thread_func(void *p_userdata) {
 
-			if (!bus->channels[k].used) {
-				//see if any audio is contained, because channel was not used
+	MixThread *mix_thread = (MixThread *)p_userdata;
+	AudioServer *as = singleton;
 
-				if (MAX(peak.r, peak.l) > Math::db2linear(channel_disable_threshold_db)) {
-					bus->channels.write[k].last_mix_with_audio = mix_frames;
-				} else if (mix_frames - bus->channels[k].last_mix_with_audio > channel_disable_frames) {
-					bus->channels.write[k].active = false;
-					continue; //went inactive, don't mix.
-				}
+	while (true) {
+
+		as->mix_start_semaphore->wait();
+
+		if (as->mix_threads_exit)
+			break;
+
+		as->_mix_buses(mix_thread->temp_buffer);
+
+		as->mix_done_semaphore->post();
+	}
+}
+
+void AudioServer::_mix_bus(int p_bus, Vector<Vector<AudioFrame> > &r_temp_buffer) {
+
+	uint64_t bus_ticks = OS::get_singleton()->get_ticks_usec();
+
+	Bus *bus = buses[p_bus];
+
+	//mix what the other buses send here, they are all done by now
+	for (int i = 0; i < bus->sender_count; i++) {
+
+		const Bus *sender = buses[bus->senders[i]];
+
+		for (int k = 0; k < sender->channels.size(); k++) {
+
+			if (!sender->channels[k].active)
+				continue; // inactive, or went inactive when it was processed
+
+			AudioFrame *target_buf = thread_get_channel_mix_buffer(p_bus, k);
+			AudioMix::add(target_buf, sender->channels[k].buffer.ptr(), buffer_size);
+		}
+	}
+
+	for (int k = 0; k < bus->channels.size(); k++) {
+
+		if (bus->channels[k].active && !bus->channels[k].used) {
+			//buffer was not used, but it's still active, so it must be cleaned
+			AudioMix::clear(bus->channels.write[k].buffer.ptrw(), buffer_size);
+		}
+	}
+
+	//process effects
+	if (!bus->bypass) {
+		for (int j = 0; j < bus->effects.size(); j++) {
+
+			if (!bus->effects[j].enabled)
+				continue;
+
+#ifdef DEBUG_ENABLED
+			uint64_t ticks = OS::get_singleton()->get_ticks_usec();
+#endif
+
+			for (int k = 0; k < bus->channels.size(); k++) {
+
+				if (!(bus->channels[k].active || bus->channels[k].effect_instances[j]->process_silence()))
+					continue;
+				bus->channels.write[k].effect_instances.write[j]->process(bus->channels[k].buffer.ptr(), r_temp_buffer.write[k].ptrw(), buffer_size);
 			}
 
-			if (send) {
-				//if not master bus, send
-				AudioFrame *target_buf = thread_get_channel_mix_buffer(send->index_cache, k);
+			//swap buffers, so internal buffer always has the right data
+			for (int k = 0; k < bus->channels.size(); k++) {
 
-				for (uint32_t j = 0; j < buffer_size; j++) {
-					target_buf[j] += buf[j];
-				}
+				if (!(bus->channels[k].active || bus->channels[k].effect_instances[j]->process_silence()))
+					continue;
+				SWAP(bus->channels.write[k].buffer, r_temp_buffer.write[k]);
 			}
+
+#ifdef DEBUG_ENABLED
+			bus->effects.write[j].prof_time += OS::get_singleton()->get_ticks_usec() - ticks;
+#endif
 		}
 	}
 
-	mix_frames += buffer_size;
-	to_mix = buffer_size;
+	float volume = Math::db2linear(bus->volume_db);
+
+	if (mix_solo_mode) {
+		if (!bus->soloed) {
+			volume = 0.0;
+		}
+	} else {
+		if (bus->mute) {
+			volume = 0.0;
+		}
+	}
+
+	for (int k = 0; k < bus->channels.size(); k++) {
+
+		if (!bus->channels[k].active)
+			continue;
+
+		//apply volume and compute peak
+		AudioFrame peak = AudioMix::scale_and_peak(bus->channels.write[k].buffer.ptrw(), buffer_size, volume);
+
+		bus->channels.write[k].peak_volume = AudioFrame(Math::linear2db(peak.l + 0.0000000001), Math::linear2db(peak.r + 0.0000000001));
+
+		if (!bus->channels[k].used) {
+			//see if any audio is contained, because channel was not used
+
+			if (MAX(peak.r, peak.l) > Math::db2linear(channel_disable_threshold_db)) {
+				bus->channels.write[k].last_mix_with_audio = mix_frames;
+			} else if (mix_frames - bus->channels[k].last_mix_with_audio > channel_disable_frames) {
+				bus->channels.write[k].active = false;
+			}
+		}
+	}
+
+	bus->dsp_time = USEC_TO_SEC(OS::get_singleton()->get_ticks_usec() - bus_ticks);
 }
 
 AudioFrame *AudioServer::thread_get_channel_mix_buffer(int p_bus, int p_buffer) {
@@ -906,6 +1066,18 @@ bool AudioServer::is_bus_channel_active(int p_bus, int p_channel) const {
 	return buses[p_bus]->channels[p_channel].active;
 }
 
+float AudioServer::get_bus_dsp_time(int p_bus) const {
+
+	ERR_FAIL_INDEX_V(p_bus, buses.size(), 0);
+
+	return buses[p_bus]->dsp_time;
+}
+
+float AudioServer::get_mix_step_time() const {
+
+	return mix_time;
+}
+
 void AudioServer::init_channels_and_buffers() {
 	channel_count = get_channel_count();
 	temp_buffer.resize(channel_count);
@@ -914,6 +1086,14 @@ void AudioServer::init_channels_and_buffers() {
 		temp_buffer.write[i].resize(buffer_size);
 	}
 
+	for (int i = 0; i < mix_threads.size(); i++) {
+		Vector<Vector<AudioFrame> > &thread_buffer = mix_threads[i]->temp_buffer;
+		thread_buffer.resize(channel_count);
+		for (int j = 0; j < thread_buffer.size(); j++) {
+			thread_buffer.write[j].resize(buffer_size);
+		}
+	}
+
 	for (int i = 0; i < buses.size(); i++) {
 		buses[i]->channels.resize(channel_count);
 		for (int j = 0; j < channel_count; j++) {
@@ -928,8 +1108,33 @@ void AudioServer::init() {
 	channel_disable_frames = float(GLOBAL_DEF_RST("audio/channel_disable_time", 2.0)) * get_mix_rate();
 	buffer_size = 1024; //hardcoded for now
 
+	// -1 uses one thread less than the available cores, the audio thread mixes too
+	int mix_thread_count = GLOBAL_DEF_RST("audio/mix_threads", -1);
+	ProjectSettings::get_singleton()->set_custom_property_info("audio/mix_threads", PropertyInfo(Variant::INT, "audio/mix_threads", PROPERTY_HINT_RANGE, "-1,16,1"));
+	if (mix_thread_count < 0) {
+		mix_thread_count = MIN(OS::get_singleton()->get_processor_count() - 1, 3);
+	}
+
+	if (mix_thread_count > 0 && OS::get_singleton()->can_use_threads()) {
+
+		mix_mutex = Mutex::create();
+		mix_start_semaphore = Semaphore::create();
+		mix_ready_semaphore = Semaphore::create();
+		mix_done_semaphore = Semaphore::create();
+		mix_threads_exit = false;
+
+		for (int i = 0; i < mix_thread_count; i++) {
+			MixThread *mix_thread = memnew(MixThread);
+			mix_threads.push_back(mix_thread);
+		}
+	}
+
 	init_channels_and_buffers();
 
+	for (int i = 0; i < mix_threads.size(); i++) {
+		mix_threads[i]->thread = Thread::create(_mix_thread_func, mix_threads[i]);
+	}
+
 	mix_count = 0;
 	set_bus_count(1);
 	set_bus_name(0, "Master");
@@ -1022,6 +1227,30 @@ void AudioServer::finish() {
 		AudioDriverManager::get_driver(i)->finish();
 	}
 
+	if (mix_threads.size()) {
+
+		mix_threads_exit = true;
+		for (int i = 0; i < mix_threads.size(); i++) {
+			mix_start_semaphore->post();
+		}
+
+		for (int i = 0; i < mix_threads.size(); i++) {
+			Thread::wait_to_finish(mix_threads[i]->thread);
+			memdelete(mix_threads[i]->thread);
+			memdelete(mix_threads[i]);
+		}
+		mix_threads.clear();
+
+		memdelete(mix_mutex);
+		mix_mutex = NULL;
+		memdelete(mix_start_semaphore);
+		mix_start_semaphore = NULL;
+		memdelete(mix_ready_semaphore);
+		mix_ready_semaphore = NULL;
+		memdelete(mix_done_semaphore);
+		mix_done_semaphore = NULL;
+	}
+
 	for (int i = 0; i < buses.size(); i++) {
 		memdelete(buses[i]);
 	}
@@ -1278,6 +1507,8 @@ void AudioServer::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("get_bus_peak_volume_left_db", "bus_idx", "channel"), &AudioServer::get_bus_peak_volume_left_db);
 	ClassDB::bind_method(D_METHOD("get_bus_peak_volume_right_db", "bus_idx", "channel"), &AudioServer::get_bus_peak_volume_right_db);
 
+	ClassDB::bind_method(D_METHOD("get_bus_dsp_time", "bus_idx"), &AudioServer::get_bus_dsp_time);
+
 	ClassDB::bind_method(D_METHOD("lock"), &AudioServer::lock);
 	ClassDB::bind_method(D_METHOD("unlock"), &AudioServer::unlock);
 
@@ -1312,6 +1543,16 @@ AudioServer::AudioServer() {
 	to_mix = 0;
 	output_latency = 0;
 	output_latency_ticks = 0;
+	mix_mutex = NULL;
+	mix_start_semaphore = NULL;
+	mix_ready_semaphore = NULL;
+	mix_done_semaphore = NULL;
+	mix_threads_exit = false;
+	mix_solo_mode = false;
+	mix_queue_read = 0;
+	mix_queue_write = 0;
+	mix_buses_done = 0;
+	mix_time = 0;
 #ifdef DEBUG_ENABLED
 	prof_time = 0;
 #endif
@@ -34,6 +34,8 @@
 #include "core/math/audio_frame.h"
 #include "core/object.h"
 #include "core/os/os.h"
+#include "core/os/semaphore.h"
+#include "core/os/thread.h"
 #include "core/variant.h"
 #include "servers/audio/audio_effect.h"
 
@@ -214,12 +216,56 @@ private:
 		float volume_db;
 		StringName send;
 		int index_cache;
+
+		// mix graph of the current step, rebuilt by _mix_step()
+		int send_index_cache;
+		Vector<int> senders; // buses mixed into this one
+		int sender_count;
+		Vector<int> dependents; // buses that can only be processed after this one
+		int dependent_count;
+		int pending; // buses this one still waits for
+
+		float dsp_time;
+
+		Bus() {
+			send_index_cache = -1;
+			sender_count = 0;
+			dependent_count = 0;
+			pending = 0;
+			dsp_time = 0;
+		}
 	};
 
 	Vector<Vector<AudioFrame> > temp_buffer; //temp_buffer for each level
 	Vector<Bus *> buses;
 	Map<StringName, Bus *> bus_map;
 
+	// Buses that don't feed each other are processed in parallel. The audio
+	// thread and the mix threads take buses from a queue as soon as every
+	// bus they depend on is done.
+	struct MixThread {
+		Thread *thread;
+		Vector<Vector<AudioFrame> > temp_buffer;
+	};
+
+	Vector<MixThread *> mix_threads;
+	Mutex *mix_mutex;
+	Semaphore *mix_start_semaphore;
+	Semaphore *mix_ready_semaphore;
+	Semaphore *mix_done_semaphore;
+	bool mix_threads_exit;
+	bool mix_solo_mode;
+	Vector<int> mix_queue;
+	int mix_queue_read;
+	int mix_queue_write;
+	int mix_buses_done;
+	float mix_time;
+
+	static void _mix_thread_func(void *p_userdata);
+	void _mix_buses(Vector<Vector<AudioFrame> > &r_temp_buffer);
+	void _mix_bus(int p_bus, Vector<Vector<AudioFrame> > &r_temp_buffer);
+	static void _add_bus_dependency(Bus *p_from, int p_to);
+
 	void _update_bus_effects(int p_bus);
 
 	static AudioServer *singleton;
@@ -328,6 +374,9 @@ public:
 
 	bool is_bus_channel_active(int p_bus, int p_channel) const;
 
+	float get_bus_dsp_time(int p_bus) const;
+	float get_mix_step_time() const;
+
 	virtual void init();
 	virtual void finish();
 	virtual void update();
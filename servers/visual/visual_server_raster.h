@@ -296,6 +296,7 @@ public:
 	BIND3(skeleton_bone_set_transform, RID, int, const Transform &)
 	BIND2RC(Transform, skeleton_bone_get_transform, RID, int)
 	BIND3(skeleton_bone_set_transform_2d, RID, int, const Transform2D &)
+	BIND2(skeleton_set_as_bulk_array, RID, const PoolVector<float> &)
 	BIND2RC(Transform2D, skeleton_bone_get_transform_2d, RID, int)
 	BIND2(skeleton_set_base_transform_2d, RID, const Transform2D &)
 